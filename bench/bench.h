@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OCTO_FLEX_BENCH_H
+#define OCTO_FLEX_BENCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "object.h"
+
+namespace octo_flex {
+
+class ObjectManager;
+class OctoFlexView;
+
+// Side of the square the synthetic scene covers, in meters, centered on the origin.
+const double kBenchSceneExtent = 200.0;
+
+// Size of the synthetic scenes and how long to measure; set from the command line.
+struct BenchConfig {
+    size_t objects = 2000;     // Meshes in the synthetic scene
+    size_t points = 1000000;   // Points, spread over a few point clouds
+    int threads = 4;           // Submitting threads in the contention benchmarks
+    int repetitions = 10;      // Timed runs per benchmark, after one warm-up run
+    int frames = 60;           // Frames per render and capture run
+    int width = 1280;
+    int height = 720;
+    uint32_t seed = 1;         // Same seed, same scene
+    std::string filter;        // Only benchmarks whose name contains this
+};
+
+struct BenchResult {
+    std::string name;
+    std::vector<double> samples_ms;  // One per repetition
+    double items = 0.0;              // Work done per repetition, for throughput
+    std::string item_unit;
+    std::map<std::string, double> metrics;  // Extra numbers, such as GPU time
+    std::string skipped;                    // Why it did not run, if it did not
+};
+
+class BenchRunner {
+   public:
+    explicit BenchRunner(const BenchConfig& config) : config_(config) {}
+
+    const BenchConfig& config() const { return config_; }
+    bool enabled(const std::string& name) const;
+
+    // Run setup then body once to warm up, then repetitions times timing only body. items is the
+    // work one body call does, in item_unit.
+    BenchResult& run(const std::string& name, double items, const std::string& item_unit,
+                     const std::function<void()>& setup, const std::function<void()>& body);
+    BenchResult& skip(const std::string& name, const std::string& reason);
+
+    // Environment recorded with the results, such as the GL renderer.
+    void setInfo(const std::string& key, const std::string& value) { info_[key] = value; }
+
+    void writeJson(std::ostream& out) const;
+
+   private:
+    BenchConfig config_;
+    std::deque<BenchResult> results_;  // Stable references for run()
+    std::map<std::string, std::string> info_;
+};
+
+// Synthetic scene: boxes, spheres and cylinders scattered over a square, and the configured points
+// in clouds of at most 250k. Objects are editable, as an application would build them.
+std::vector<Object::Ptr> makeMeshes(const BenchConfig& config, const std::string& prefix = "mesh");
+std::vector<Object::Ptr> makePointClouds(const BenchConfig& config);
+
+// A view that draws manager's scene offscreen at the configured size, looking down on the synthetic
+// scene, with its context current. Null, with error set, without OpenGL.
+std::unique_ptr<OctoFlexView> createBenchView(const BenchConfig& config, std::shared_ptr<ObjectManager> manager,
+                                              std::string* error);
+
+// Wait for the GPU, so frame times include the work the driver queued.
+void finishGpu();
+
+void runSceneBenchmarks(BenchRunner& runner);
+void runRenderBenchmarks(BenchRunner& runner);
+void runCaptureBenchmarks(BenchRunner& runner);
+
+}  // namespace octo_flex
+
+#endif  // OCTO_FLEX_BENCH_H
@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Capture benchmarks: reading frames back synchronously and through pixel-pack buffers, and the
+// whole recording pipeline from captureFrameAsync through RecordingThread to the VideoRecorder.
+
+#include <QDir>
+#include <QFile>
+
+#include "bench.h"
+#include "frame_pool.h"
+#include "object_manager.h"
+#include "octo_flex_view.h"
+#include "recording_thread.h"
+
+namespace octo_flex {
+
+namespace {
+
+const int kPoolFrames = 8;
+
+VideoRecorderOptions recorderOptions(const BenchConfig& config, const std::string& path) {
+    VideoRecorderOptions options;
+    options.outputPath = path;
+    options.width = config.width;
+    options.height = config.height;
+    options.fps = 30;
+    options.inputFormat = QImage::Format_RGBA8888;
+    options.encoder = "auto";
+    return options;
+}
+
+}  // namespace
+
+void runCaptureBenchmarks(BenchRunner& runner) {
+    const BenchConfig& config = runner.config();
+    const int frames = config.frames;
+    std::string error;
+
+    auto manager = std::make_shared<ObjectManager>();
+    manager->submitLayer(makeMeshes(config), "meshes");
+    std::unique_ptr<OctoFlexView> view = createBenchView(config, manager, &error);
+    if (!view) {
+        for (const char* name : {"capture/readback_sync", "capture/readback_async", "capture/record_pipeline"}) {
+            if (runner.enabled(name)) runner.skip(name, error);
+        }
+        return;
+    }
+    OctoFlexView& v = *view;
+
+    if (runner.enabled("capture/readback_sync")) {
+        runner.run("capture/readback_sync", frames, "frames", nullptr, [&v, frames]() {
+            for (int i = 0; i < frames; ++i) {
+                v.renderFrame();
+                v.captureFrame();
+            }
+        });
+    }
+
+    const FramePool::Ptr pool = FramePool::create(config.width, config.height, QImage::Format_RGBA8888, kPoolFrames);
+    if (runner.enabled("capture/readback_async")) {
+        runner.run("capture/readback_async", frames, "frames", nullptr, [&v, &pool, frames]() {
+            for (int i = 0; i < frames; ++i) {
+                v.renderFrame();
+                v.captureFrameAsync(pool);  // Frames go back to the pool when dropped here
+            }
+            v.finishFrameCaptures();
+        });
+    }
+
+    if (!runner.enabled("capture/record_pipeline")) return;
+    const std::string path = QDir::temp().filePath("octo_flex_bench.mp4").toStdString();
+    std::unique_ptr<RecordingThread> recorder = std::make_unique<RecordingThread>();
+    if (!recorder->startRecording(recorderOptions(config, path), &error)) {
+        runner.skip("capture/record_pipeline", "no video encoder: " + error);
+        return;
+    }
+    recorder->stopRecording();
+
+    // Offline pace: capture waits for pool buffers and queue room rather than dropping frames.
+    pool->setAcquireTimeout(1000);
+    bool ok = true;
+    uint64_t written = 0;
+    uint64_t stalls = 0;
+    std::string encoder;
+    BenchResult& result = runner.run(
+        "capture/record_pipeline", frames, "frames",
+        [&]() {
+            // One thread per recording, as the view container does.
+            recorder = std::make_unique<RecordingThread>();
+            recorder->setMaxQueueSize(kPoolFrames);
+            ok = recorder->startRecording(recorderOptions(config, path), &error) && ok;
+        },
+        [&]() {
+            auto queue = [&recorder](std::vector<QImage>&& captured) {
+                for (QImage& frame : captured) {
+                    if (!frame.isNull()) recorder->queueFrame(std::move(frame), 1000);
+                }
+            };
+            for (int i = 0; i < frames; ++i) {
+                v.renderFrame();
+                queue(v.captureFrameAsync(pool));
+            }
+            queue(v.finishFrameCaptures());
+            encoder = recorder->encoderName();
+            ok = recorder->stopRecording(&error) && ok;  // Timed: includes draining the encoder
+            written = recorder->framesWritten();
+            stalls = recorder->encoderStalls();
+        });
+    result.metrics["frames_written"] = static_cast<double>(written);
+    result.metrics["encoder_stalls"] = static_cast<double>(stalls);
+    if (!ok) result.metrics["failed"] = 1.0;
+    runner.setInfo("video_encoder", encoder);
+    QFile::remove(QString::fromStdString(path));
+}
+
+}  // namespace octo_flex
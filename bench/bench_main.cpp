@@ -0,0 +1,344 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// octo_flex_bench: micro- and macro-benchmarks of the scene, render and capture paths against
+// synthetic scenes, with the results written as JSON for tracking between releases.
+//
+//   octo_flex_bench [--objects N] [--points N] [--threads N] [--repetitions N] [--frames N]
+//                   [--size WxH] [--seed N] [--filter TEXT] [--output FILE]
+
+#include <QApplication>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QSurfaceFormat>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <random>
+
+#include "bench.h"
+#include "object_builder.h"
+#include "render_backend.h"
+#include "utils.h"
+
+namespace octo_flex {
+
+namespace {
+
+const size_t kPointsPerCloud = 250000;
+
+void writeString(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+            out << escaped;
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+void writeNumber(std::ostream& out, double value) {
+    if (std::isfinite(value)) {
+        out << value;
+    } else {
+        out << "null";
+    }
+}
+
+double percentile(std::vector<double> sorted, double fraction) {
+    if (sorted.empty()) return 0.0;
+    const double rank = fraction * static_cast<double>(sorted.size() - 1);
+    const size_t low = static_cast<size_t>(rank);
+    const size_t high = std::min(low + 1, sorted.size() - 1);
+    return sorted[low] + (sorted[high] - sorted[low]) * (rank - static_cast<double>(low));
+}
+
+}  // namespace
+
+bool BenchRunner::enabled(const std::string& name) const {
+    return config_.filter.empty() || name.find(config_.filter) != std::string::npos;
+}
+
+BenchResult& BenchRunner::run(const std::string& name, double items, const std::string& item_unit,
+                              const std::function<void()>& setup, const std::function<void()>& body) {
+    results_.emplace_back();
+    BenchResult& result = results_.back();
+    result.name = name;
+    result.items = items;
+    result.item_unit = item_unit;
+
+    for (int i = -1; i < config_.repetitions; ++i) {
+        if (setup) setup();
+        const auto start = std::chrono::steady_clock::now();
+        body();
+        const auto end = std::chrono::steady_clock::now();
+        if (i >= 0) result.samples_ms.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+
+    std::vector<double> sorted = result.samples_ms;
+    std::sort(sorted.begin(), sorted.end());
+    std::cerr << name << ": median " << percentile(sorted, 0.5) << " ms" << std::endl;
+    return result;
+}
+
+BenchResult& BenchRunner::skip(const std::string& name, const std::string& reason) {
+    results_.emplace_back();
+    BenchResult& result = results_.back();
+    result.name = name;
+    result.skipped = reason;
+    std::cerr << name << ": skipped, " << reason << std::endl;
+    return result;
+}
+
+void BenchRunner::writeJson(std::ostream& out) const {
+    out << "{\n  \"suite\": \"octo_flex_bench\",\n  \"version\": ";
+    writeString(out, OCTO_FLEX_BENCH_VERSION);
+    out << ",\n  \"timestamp\": ";
+    writeString(out, QDateTime::currentDateTimeUtc().toString(Qt::ISODate).toStdString());
+    out << ",\n  \"config\": {\"objects\": " << config_.objects << ", \"points\": " << config_.points
+        << ", \"threads\": " << config_.threads << ", \"repetitions\": " << config_.repetitions
+        << ", \"frames\": " << config_.frames << ", \"width\": " << config_.width << ", \"height\": " << config_.height
+        << ", \"seed\": " << config_.seed << "},\n  \"info\": {";
+    bool first = true;
+    for (const auto& entry : info_) {
+        out << (first ? "" : ", ");
+        writeString(out, entry.first);
+        out << ": ";
+        writeString(out, entry.second);
+        first = false;
+    }
+    out << "},\n  \"results\": [";
+
+    first = true;
+    for (const BenchResult& result : results_) {
+        out << (first ? "\n" : ",\n") << "    {\"name\": ";
+        writeString(out, result.name);
+        first = false;
+        if (!result.skipped.empty()) {
+            out << ", \"skipped\": ";
+            writeString(out, result.skipped);
+            out << "}";
+            continue;
+        }
+
+        std::vector<double> sorted = result.samples_ms;
+        std::sort(sorted.begin(), sorted.end());
+        const double sum = std::accumulate(sorted.begin(), sorted.end(), 0.0);
+        const double mean = sorted.empty() ? 0.0 : sum / static_cast<double>(sorted.size());
+        double variance = 0.0;
+        for (double sample : sorted) variance += (sample - mean) * (sample - mean);
+        if (sorted.size() > 1) variance /= static_cast<double>(sorted.size() - 1);
+        const double median = percentile(sorted, 0.5);
+
+        out << ", \"unit\": \"ms\", \"samples\": [";
+        for (size_t i = 0; i < result.samples_ms.size(); ++i) {
+            out << (i ? ", " : "");
+            writeNumber(out, result.samples_ms[i]);
+        }
+        out << "], \"min\": ";
+        writeNumber(out, sorted.empty() ? 0.0 : sorted.front());
+        out << ", \"median\": ";
+        writeNumber(out, median);
+        out << ", \"mean\": ";
+        writeNumber(out, mean);
+        out << ", \"p95\": ";
+        writeNumber(out, percentile(sorted, 0.95));
+        out << ", \"max\": ";
+        writeNumber(out, sorted.empty() ? 0.0 : sorted.back());
+        out << ", \"stddev\": ";
+        writeNumber(out, std::sqrt(variance));
+        if (result.items > 0.0) {
+            out << ", \"items\": ";
+            writeNumber(out, result.items);
+            out << ", \"item_unit\": ";
+            writeString(out, result.item_unit);
+            out << ", \"items_per_second\": ";
+            writeNumber(out, median > 0.0 ? result.items / (median * 1e-3) : 0.0);
+        }
+        for (const auto& metric : result.metrics) {
+            out << ", ";
+            writeString(out, metric.first);
+            out << ": ";
+            writeNumber(out, metric.second);
+        }
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+std::vector<Object::Ptr> makeMeshes(const BenchConfig& config, const std::string& prefix) {
+    std::mt19937 random(config.seed);
+    std::uniform_real_distribution<double> position(-kBenchSceneExtent / 2, kBenchSceneExtent / 2);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    std::vector<Object::Ptr> objects;
+    objects.reserve(config.objects);
+    for (size_t i = 0; i < config.objects; ++i) {
+        const std::string id = prefix + "_" + std::to_string(i);
+        const Vec3 color(unit(random), unit(random), unit(random));
+        const double size = 0.5 + 2.0 * unit(random);
+        Object::Ptr object;
+        switch (i % 3) {
+            case 0:
+                object = generateCubic(id, color, size, size, size, false);
+                break;
+            case 1:
+                object = generateSphere(id, color, size / 2, false);
+                break;
+            default:
+                object = generateCylinder(id, color, size / 2, size, i % 10 == 2);  // Some transparent
+                break;
+        }
+        object->setPose(Vec3(position(random), position(random), size / 2), rotateZ(unit(random) * 2 * M_PI));
+        objects.push_back(std::move(object));
+    }
+    return objects;
+}
+
+std::vector<Object::Ptr> makePointClouds(const BenchConfig& config) {
+    std::mt19937 random(config.seed + 1);
+    std::normal_distribution<float> spread(0.0f, static_cast<float>(kBenchSceneExtent / 8));
+    std::uniform_int_distribution<int> channel(0, 255);
+
+    std::vector<Object::Ptr> clouds;
+    for (size_t first = 0; first < config.points; first += kPointsPerCloud) {
+        const size_t count = std::min(kPointsPerCloud, config.points - first);
+        std::vector<PackedVertex> vertices(count);
+        for (PackedVertex& vertex : vertices) {
+            vertex.x = spread(random);
+            vertex.y = spread(random);
+            vertex.z = std::abs(spread(random)) / 8;
+            vertex.r = static_cast<uint8_t>(channel(random));
+            vertex.g = static_cast<uint8_t>(channel(random));
+            vertex.b = static_cast<uint8_t>(channel(random));
+            vertex.a = 255;
+        }
+        clouds.push_back(ObjectBuilder::begin("cloud_" + std::to_string(clouds.size()))
+                             .pointCloud(std::move(vertices), 2.0)
+                             .build());
+    }
+    return clouds;
+}
+
+}  // namespace octo_flex
+
+namespace {
+
+bool parseNumber(const char* text, unsigned long long* value) {
+    char* end = nullptr;
+    *value = std::strtoull(text, &end, 10);
+    return end != text && *end == '\0';
+}
+
+void printUsage() {
+    std::cerr << "Usage: octo_flex_bench [--objects N] [--points N] [--threads N] [--repetitions N] [--frames N]\n"
+                 "                       [--size WxH] [--seed N] [--filter TEXT] [--output FILE]\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    using namespace octo_flex;
+
+    BenchConfig config;
+    std::string output;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Error: " << arg << " needs a value" << std::endl;
+            printUsage();
+            return 1;
+        }
+        const char* value = argv[++i];
+        unsigned long long number = 0;
+        bool ok = true;
+        if (arg == "--objects") {
+            ok = parseNumber(value, &number);
+            config.objects = static_cast<size_t>(number);
+        } else if (arg == "--points") {
+            ok = parseNumber(value, &number);
+            config.points = static_cast<size_t>(number);
+        } else if (arg == "--threads") {
+            ok = parseNumber(value, &number) && number > 0;
+            config.threads = static_cast<int>(number);
+        } else if (arg == "--repetitions") {
+            ok = parseNumber(value, &number) && number > 0;
+            config.repetitions = static_cast<int>(number);
+        } else if (arg == "--frames") {
+            ok = parseNumber(value, &number) && number > 0;
+            config.frames = static_cast<int>(number);
+        } else if (arg == "--size") {
+            ok = std::sscanf(value, "%dx%d", &config.width, &config.height) == 2 && config.width > 0 &&
+                 config.height > 0;
+        } else if (arg == "--seed") {
+            ok = parseNumber(value, &number);
+            config.seed = static_cast<uint32_t>(number);
+        } else if (arg == "--filter") {
+            config.filter = value;
+        } else if (arg == "--output") {
+            output = value;
+        } else {
+            std::cerr << "Error: unknown option " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+        if (!ok) {
+            std::cerr << "Error: bad value " << value << " for " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    // Render offscreen without a display, as HeadlessRenderer does.
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM") && qEnvironmentVariableIsEmpty("DISPLAY") &&
+        qEnvironmentVariableIsEmpty("WAYLAND_DISPLAY")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QCoreApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
+    QSurfaceFormat::setDefaultFormat(RenderBackend::surfaceFormat(RenderBackend::defaultType()));
+    QApplication app(argc, argv);
+
+    BenchRunner runner(config);
+    runSceneBenchmarks(runner);
+    runRenderBenchmarks(runner);
+    runCaptureBenchmarks(runner);
+
+    if (output.empty()) {
+        runner.writeJson(std::cout);
+        return 0;
+    }
+    std::ofstream file(output);
+    runner.writeJson(file);
+    if (!file) {
+        std::cerr << "Error: cannot write " << output << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Render benchmarks: whole frames as paintGL draws them, and ID-buffer picking next to the CPU
+// octree query that rectangle selection adds for point clouds.
+
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <cmath>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "bench.h"
+#include "object_manager.h"
+#include "octo_flex_view.h"
+#include "point_cloud_shape.h"
+
+namespace octo_flex {
+
+namespace {
+
+const int kPicks = 50;  // Picks per run
+
+// Put the camera on a circle around the scene center, looking at it from above.
+void orbit(OctoFlexView& view, float angle) {
+    const float radius = static_cast<float>(kBenchSceneExtent * 0.6);
+    const float height = static_cast<float>(kBenchSceneExtent * 0.4);
+    view.getCamera()->setPosition(glm::vec3(radius * std::sin(angle), -radius * std::cos(angle), height));
+    view.getCamera()->lookAt(glm::vec3(0.0f));
+}
+
+void runFrames(BenchRunner& runner, const std::string& name, OctoFlexView& view, bool orbiting) {
+    if (!runner.enabled(name)) return;
+    const int frames = runner.config().frames;
+    BenchResult& result = runner.run(name, frames, "frames", nullptr, [&view, frames, orbiting]() {
+        for (int i = 0; i < frames; ++i) {
+            // Orbiting changes culling and point cloud LOD every frame, as an interactive user does.
+            if (orbiting) orbit(view, static_cast<float>(i) * 0.05f);
+            view.renderFrame();
+        }
+        finishGpu();
+    });
+    if (orbiting) orbit(view, 0.0f);
+
+    const FrameTimingStats stats = view.frameTimingStats();
+    result.metrics["cpu_p50_ms"] = stats.frame.cpu_p50_ms;
+    result.metrics["cpu_p99_ms"] = stats.frame.cpu_p99_ms;
+    if (stats.gpu_timing) {
+        result.metrics["gpu_p50_ms"] = stats.frame.gpu_p50_ms;
+        result.metrics["gpu_p99_ms"] = stats.frame.gpu_p99_ms;
+    }
+}
+
+void runPicks(BenchRunner& runner, const std::string& name, OctoFlexView& view, SelectionMode mode) {
+    if (!runner.enabled(name)) return;
+    const int width = view.width();
+    const int height = view.height();
+    runner.run(name, kPicks, "picks", nullptr, [&view, width, height, mode]() {
+        for (int i = 0; i < kPicks; ++i) {
+            if (mode == SelectionMode::POINT) {
+                // Clicks around the center, as handled by mousePressEvent.
+                view.pickRegion(QPoint(width / 2 - 2 + (i % 7) * 10, height / 2 - 2), 5, 5, mode);
+            } else {
+                view.pickRegion(QPoint(width / 4, height / 4), width / 2, height / 2, mode);
+            }
+        }
+    });
+}
+
+}  // namespace
+
+void finishGpu() {
+    if (QOpenGLContext* context = QOpenGLContext::currentContext()) context->functions()->glFinish();
+}
+
+std::unique_ptr<OctoFlexView> createBenchView(const BenchConfig& config, std::shared_ptr<ObjectManager> manager,
+                                              std::string* error) {
+    auto view = std::make_unique<OctoFlexView>();
+    view->setObjectManager(manager);
+    view->stopRefresh();  // Frames are painted by the benchmarks only
+    view->resize(config.width, config.height);
+    if (!view->renderFrame()) {
+        *error = "no OpenGL context";
+        return nullptr;
+    }
+
+    orbit(*view, 0.0f);
+    view->renderFrame();
+    return view;
+}
+
+void runRenderBenchmarks(BenchRunner& runner) {
+    const BenchConfig& config = runner.config();
+    std::string error;
+
+    auto meshes = std::make_shared<ObjectManager>();
+    meshes->submitLayer(makeMeshes(config), "meshes");
+    std::unique_ptr<OctoFlexView> view = createBenchView(config, meshes, &error);
+    if (!view) {
+        for (const char* name : {"render/frame_meshes", "render/frame_meshes_orbit", "render/frame_point_clouds",
+                                 "pick/id_buffer_point", "pick/id_buffer_rect", "pick/rect_point_clouds",
+                                 "pick/cpu_frustum_point_clouds"}) {
+            if (runner.enabled(name)) runner.skip(name, error);
+        }
+        return;
+    }
+    const GLubyte* renderer = QOpenGLContext::currentContext()->functions()->glGetString(GL_RENDERER);
+    if (renderer) runner.setInfo("gl_renderer", reinterpret_cast<const char*>(renderer));
+
+    runFrames(runner, "render/frame_meshes", *view, false);
+    runFrames(runner, "render/frame_meshes_orbit", *view, true);
+    runPicks(runner, "pick/id_buffer_point", *view, SelectionMode::POINT);
+    runPicks(runner, "pick/id_buffer_rect", *view, SelectionMode::RECT);
+    view.reset();
+
+    auto clouds = std::make_shared<ObjectManager>();
+    const std::vector<Object::Ptr> cloud_objects = makePointClouds(config);
+    clouds->submitLayer(cloud_objects, "clouds");
+    view = createBenchView(config, clouds, &error);
+    if (!view) return;
+    runFrames(runner, "render/frame_point_clouds", *view, true);
+    runPicks(runner, "pick/rect_point_clouds", *view, SelectionMode::RECT);
+
+    if (runner.enabled("pick/cpu_frustum_point_clouds")) {
+        // The CPU half of rectangle selection alone: every point in the central quarter of the view.
+        const Camera::Ptr camera = view->getCamera();
+        const float aspect = static_cast<float>(config.width) / static_cast<float>(config.height);
+        const glm::mat4 projection = glm::perspective(glm::radians(22.5f), aspect, 0.1f, 10000.0f);
+        const Frustum frustum(projection * camera->getViewMatrix());
+        size_t hits = 0;
+        BenchResult& result =
+            runner.run("pick/cpu_frustum_point_clouds", kPicks, "picks", nullptr, [&cloud_objects, &frustum, &hits]() {
+                for (int i = 0; i < kPicks; ++i) {
+                    std::vector<uint32_t> indices;
+                    for (const Object::Ptr& object : cloud_objects) {
+                        for (const auto& shape : object->shapes()) {
+                            if (shape->type() != Shape::PointCloud) continue;
+                            static_cast<const PointCloudShape&>(*shape).queryFrustum(frustum, indices);
+                        }
+                    }
+                    hits = indices.size();
+                }
+            });
+        result.metrics["points_hit"] = static_cast<double>(hits);
+    }
+}
+
+}  // namespace octo_flex
@@ -0,0 +1,175 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Scene benchmarks: submitting from several threads at once, the snapshots readers take, and the
+// primitive generators of utils.cpp.
+
+#include <thread>
+
+#include "bench.h"
+#include "object_manager.h"
+#include "utils.h"
+
+namespace octo_flex {
+
+namespace {
+
+const int kLayerRounds = 8;        // submitLayer calls per thread per run
+const int kSnapshotCalls = 10000;  // Cheap snapshot calls per run
+const int kCopyCalls = 20;         // Layer copies per run
+const int kPrimitives = 1000;      // Objects per generator per run
+const int kRotations = 1000000;
+
+// Run fn(thread, first, last) on threads stripes of [0, count) at once.
+void onThreads(int threads, size_t count, const std::function<void(int, size_t, size_t)>& fn) {
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        const size_t first = count * static_cast<size_t>(t) / static_cast<size_t>(threads);
+        const size_t last = count * static_cast<size_t>(t + 1) / static_cast<size_t>(threads);
+        workers.emplace_back(fn, t, first, last);
+    }
+    for (std::thread& worker : workers) worker.join();
+}
+
+void runPrimitive(BenchRunner& runner, const std::string& name, const std::function<Object::Ptr(int)>& generate) {
+    if (!runner.enabled(name)) return;
+    runner.run(name, kPrimitives, "objects", nullptr, [&generate]() {
+        for (int i = 0; i < kPrimitives; ++i) {
+            Object::Ptr object = generate(i);
+            object->setInEditable();  // Bounds and triangulation, as submitting does
+        }
+    });
+}
+
+}  // namespace
+
+void runSceneBenchmarks(BenchRunner& runner) {
+    const BenchConfig& config = runner.config();
+    const int threads = config.threads;
+    // Frozen by the warm-up run, so the timed runs measure the manager rather than the objects.
+    const std::vector<Object::Ptr> objects = makeMeshes(config);
+    ObjectManager::Ptr manager;
+
+    if (runner.enabled("scene/submit_contended")) {
+        runner.run(
+            "scene/submit_contended", static_cast<double>(objects.size()), "objects",
+            [&manager]() { manager = std::make_shared<ObjectManager>(); },
+            [&]() {
+                onThreads(threads, objects.size(), [&](int, size_t first, size_t last) {
+                    for (size_t i = first; i < last; ++i) manager->submit(objects[i], "bench");
+                });
+            });
+    }
+
+    if (runner.enabled("scene/submit_layer_contended")) {
+        runner.run(
+            "scene/submit_layer_contended", threads * kLayerRounds, "layers",
+            [&manager]() { manager = std::make_shared<ObjectManager>(); },
+            [&]() {
+                onThreads(threads, objects.size(), [&](int, size_t first, size_t last) {
+                    const std::vector<Object::Ptr> stripe(objects.begin() + first, objects.begin() + last);
+                    for (int round = 0; round < kLayerRounds; ++round) manager->submitLayer(stripe, "bench");
+                });
+            });
+    }
+
+    if (runner.enabled("scene/submit_delta_contended")) {
+        runner.run(
+            "scene/submit_delta_contended", static_cast<double>(objects.size()), "objects",
+            [&]() {
+                manager = std::make_shared<ObjectManager>();
+                manager->submitLayer(objects, "bench");
+            },
+            [&]() {
+                onThreads(threads, objects.size(), [&](int, size_t first, size_t last) {
+                    // Small deltas, as a tracker moving a few objects per update would send.
+                    for (size_t i = first; i < last; i += 16) {
+                        const size_t end = std::min(last, i + 16);
+                        manager->submitLayerDelta({objects.begin() + i, objects.begin() + end}, {}, "bench");
+                    }
+                });
+            });
+    }
+
+    // Readers: a scene spread over 16 layers.
+    manager = std::make_shared<ObjectManager>();
+    for (size_t i = 0; i < objects.size(); ++i) {
+        manager->submit(objects[i], "layer_" + std::to_string(i % 16));
+    }
+    Layer::Ptr layer = manager->findLayer("layer_0");
+
+    if (runner.enabled("scene/layers_copy")) {
+        runner.run("scene/layers_copy", kSnapshotCalls, "calls", nullptr, [&manager]() {
+            for (int i = 0; i < kSnapshotCalls; ++i) manager->layers();
+        });
+    }
+    if (runner.enabled("scene/layers_snapshot")) {
+        runner.run("scene/layers_snapshot", kSnapshotCalls, "calls", nullptr, [&manager]() {
+            for (int i = 0; i < kSnapshotCalls; ++i) manager->layersSnapshot();
+        });
+    }
+    if (runner.enabled("scene/layer_objects_copy")) {
+        runner.run("scene/layer_objects_copy", kCopyCalls, "calls", nullptr, [&layer]() {
+            for (int i = 0; i < kCopyCalls; ++i) layer->objects();
+        });
+    }
+    if (runner.enabled("scene/layer_snapshot")) {
+        runner.run("scene/layer_snapshot", kSnapshotCalls, "calls", nullptr, [&layer]() {
+            for (int i = 0; i < kSnapshotCalls; ++i) layer->snapshot();
+        });
+    }
+    if (runner.enabled("scene/layer_snapshot_under_writes")) {
+        // One thread republishes the layer while the others read it, as views do while a feed writes.
+        runner.run("scene/layer_snapshot_under_writes", kSnapshotCalls * std::max(threads - 1, 1), "calls", nullptr,
+                   [&]() {
+                       onThreads(threads, 0, [&](int thread, size_t, size_t) {
+                           if (thread == 0 && threads > 1) {
+                               for (int round = 0; round < kLayerRounds; ++round) {
+                                   manager->submitLayerDelta({objects[0]}, {}, "layer_0");
+                               }
+                               return;
+                           }
+                           for (int i = 0; i < kSnapshotCalls; ++i) layer->snapshot();
+                       });
+                   });
+    }
+
+    const Vec3 color(0.2, 0.6, 0.9);
+    runPrimitive(runner, "utils/generate_cubic",
+                 [&color](int i) { return generateCubic("c" + std::to_string(i), color, 1, 1, 1); });
+    runPrimitive(runner, "utils/generate_sphere",
+                 [&color](int i) { return generateSphere("s" + std::to_string(i), color, 1, true, false, 24); });
+    runPrimitive(runner, "utils/generate_cylinder",
+                 [&color](int i) { return generateCylinder("y" + std::to_string(i), color, 1, 2, true, false, 24); });
+    runPrimitive(runner, "utils/generate_cone",
+                 [&color](int i) { return generateCone("o" + std::to_string(i), color, 1, 2, true, false, 24); });
+    runPrimitive(runner, "utils/generate_capsule",
+                 [&color](int i) { return generateCapsule("p" + std::to_string(i), color, 1, 2, true, 24); });
+    runPrimitive(runner, "utils/generate_arrow",
+                 [&color](int i) { return generateArrow("a" + std::to_string(i), color, 2, 0.1, 0.3, 0.5); });
+
+    if (runner.enabled("utils/quaternion_rotate")) {
+        const Quaternion rotation = quaternionMultiply(rotateX(0.3), rotateZ(1.1));
+        runner.run("utils/quaternion_rotate", kRotations, "vectors", nullptr, [&rotation]() {
+            Vec3 v(1, 0, 0);
+            for (int i = 0; i < kRotations; ++i) v = quaternionRotateVector(rotation, v);
+            volatile double sink = v.x;
+            (void)sink;
+        });
+    }
+}
+
+}  // namespace octo_flex
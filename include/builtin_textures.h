@@ -17,6 +17,8 @@
 #ifndef BUILTIN_TEXTURES_H
 #define BUILTIN_TEXTURES_H
 
+#include <memory>
+
 #include "texture_image.h"
 #include "octo_flex_export.h"
 
@@ -71,14 +73,30 @@ OCTO_FLEX_VIEW_API TextureImage getGradientTexture(int width = 256, int height =
  *
  * @return TextureImage containing the logo (256x256 RGBA)
  *
+ * @note The logo is stored compressed and expanded once per process; each call copies it.
+ *       Quads built with the texture path "builtin:logo" instead share one copy and one
+ *       texture without copying.
+ *
  * @example
  * auto logo = getBuiltinLogo();
  * viewer.add(ObjectBuilder::begin("logo")
  *     .texturedQuad(logo, 3.0, 3.0, 1.0)
  *     .build(), "layer");
+ *
+ * // Same texture, no copy
+ * viewer.add(ObjectBuilder::begin("logo_2")
+ *     .texturedQuad(3.0, 3.0, "builtin:logo")
+ *     .build(), "layer");
  */
 OCTO_FLEX_VIEW_API TextureImage getBuiltinLogo();
 
+/**
+ * @brief Get the process-wide copy of the embedded logo
+ *
+ * @return Logo expanded on the first call and shared by all callers
+ */
+OCTO_FLEX_VIEW_API std::shared_ptr<const TextureImage> getSharedBuiltinLogo();
+
 }  // namespace octo_flex
 
 #endif  // BUILTIN_TEXTURES_H
@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef COLORMAP_H
+#define COLORMAP_H
+
+#include "def.h"
+#include "octo_flex_export.h"
+
+namespace octo_flex {
+
+/**
+ * @brief Color scale that scalar values are mapped through (see ObjectBuilder::scalars())
+ */
+enum class Colormap {
+    Viridis,    ///< Perceptually uniform, dark blue to yellow
+    Turbo,      ///< Rainbow without the dark ends of Jet, blue to red
+    Jet,        ///< Classic rainbow, dark blue to dark red
+    Grayscale,  ///< Black to white
+};
+
+/**
+ * @brief Color of a colormap at t
+ * @param colormap Color scale
+ * @param t Position in [0, 1]; values outside are clamped
+ * @return RGB color (each component in [0, 1])
+ */
+OCTO_FLEX_VIEW_API Vec3 colormapColor(Colormap colormap, double t);
+
+}  // namespace octo_flex
+
+#endif  // COLORMAP_H
@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DYNAMIC_TEXTURE_H
+#define DYNAMIC_TEXTURE_H
+
+#include <cstdint>
+#include <memory>
+
+#include "octo_flex_export.h"
+
+namespace octo_flex {
+
+/**
+ * @brief Texture whose contents a producer thread replaces in place, e.g. a live camera feed
+ *
+ * The producer thread and the textured quads that show it all hold the same handle: the producer
+ * submits frames with update(), updateNV12() or updateI420(), and the quads, attached through
+ * ObjectBuilder::texturedQuad(std::shared_ptr<DynamicTexture>, ...), draw the newest one. A frame
+ * is copied once on submit; the views upload it into the same texture with glTexSubImage2D through
+ * two alternating pixel unpack buffers, so neither a new texture nor a new object is created per
+ * frame. Frames submitted faster than the views paint replace each other; only the newest is
+ * uploaded.
+ *
+ * YUV frames are converted to RGB on the GPU (BT.601, limited range) where the context supports
+ * OpenGL 3.2 or OpenGL ES 3.0, and on the CPU while uploading otherwise.
+ *
+ * Rows are given top to bottom, as cameras deliver them.
+ *
+ * @example Camera feed:
+ * @code
+ * auto feed = DynamicTexture::create(1280, 720, DynamicTexture::Format::NV12);
+ * viewer.add(ObjectBuilder::begin("camera_0")
+ *     .texturedQuad(feed, 1.6, 0.9)
+ *     .build(), "cameras");
+ *
+ * // Camera thread
+ * feed->updateNV12(frame.y, frame.y_stride, frame.uv, frame.uv_stride);
+ * @endcode
+ */
+class OCTO_FLEX_VIEW_API DynamicTexture {
+   public:
+    /**
+     * @brief Pixel layout of the submitted frames
+     */
+    enum class Format {
+        RGBA8,  ///< 4 bytes per pixel
+        NV12,   ///< Full-resolution Y plane, then interleaved U/V at half resolution
+        I420,   ///< Full-resolution Y plane, then U and V planes at half resolution
+    };
+
+    /**
+     * @brief Create a texture of width x height pixels taking frames of the given format
+     * @return Handle to share between the producer and the quads; null if the size is invalid
+     */
+    static std::shared_ptr<DynamicTexture> create(int width, int height, Format format = Format::RGBA8);
+
+    ~DynamicTexture();
+    DynamicTexture(const DynamicTexture&) = delete;
+    DynamicTexture& operator=(const DynamicTexture&) = delete;
+
+    int width() const;
+    int height() const;
+    Format format() const;
+
+    /**
+     * @brief Submit an RGBA8 frame (thread-safe)
+     * @param rgba Top row first
+     * @param stride Bytes per row; 0 for width * 4
+     * @return false if the texture does not take RGBA8 frames
+     */
+    bool update(const unsigned char* rgba, int stride = 0);
+
+    /**
+     * @brief Submit an NV12 frame (thread-safe)
+     * @param y Luma plane, top row first
+     * @param y_stride Bytes per luma row
+     * @param uv Interleaved chroma plane, (width + 1) / 2 pairs per row
+     * @param uv_stride Bytes per chroma row
+     * @return false if the texture does not take NV12 frames
+     */
+    bool updateNV12(const unsigned char* y, int y_stride, const unsigned char* uv, int uv_stride);
+
+    /**
+     * @brief Submit an I420 frame (thread-safe)
+     * @return false if the texture does not take I420 frames
+     */
+    bool updateI420(const unsigned char* y, int y_stride, const unsigned char* u, int u_stride,
+                    const unsigned char* v, int v_stride);
+
+    /**
+     * @brief Frames submitted so far
+     */
+    uint64_t frameCount() const;
+
+   private:
+    friend class DynamicTextureUploader;
+    struct Impl;
+
+    DynamicTexture(int width, int height, Format format);
+
+    std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace octo_flex
+
+#endif  // DYNAMIC_TEXTURE_H
@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef FRAME_TIMING_STATS_H
+#define FRAME_TIMING_STATS_H
+
+#include <cstddef>
+
+namespace octo_flex {
+
+/**
+ * @brief Rolling CPU and GPU times of one section of a frame, in milliseconds.
+ */
+struct PassTiming {
+    double cpu_p50_ms = 0.0;
+    double cpu_p99_ms = 0.0;
+    double gpu_p50_ms = 0.0;  // Zero when GPU timing is unavailable
+    double gpu_p99_ms = 0.0;
+};
+
+/**
+ * @brief Per-pass timing of the rendered frames of a view, over a rolling window.
+ */
+struct FrameTimingStats {
+    size_t samples = 0;       // Frames in the window
+    bool gpu_timing = false;  // GPU times come from timer queries
+    PassTiming frame;         // Whole frame (GPU: sum of the passes)
+    PassTiming update;        // Queued updates and coordinate system
+    PassTiming opaque;        // Clear, grid, axes, culling and opaque shapes
+    PassTiming transparent;   // Transparent shapes
+    PassTiming object_text;   // Object info text overlay
+    PassTiming info_panel;    // Info panel overlay
+    PassTiming cleanup;       // Deferred object deletion
+};
+
+}  // namespace octo_flex
+
+#endif  // FRAME_TIMING_STATS_H
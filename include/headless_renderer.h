@@ -0,0 +1,230 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef HEADLESS_RENDERER_H
+#define HEADLESS_RENDERER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "octo_flex_export.h"
+#include "colormap.h"
+#include "def.h"
+#include "recording_options.h"
+
+namespace octo_flex {
+
+// Forward declarations
+class ObjectManager;
+class Object;
+
+/**
+ * @brief Offscreen renderer for batch export without a display
+ *
+ * Renders one view into a framebuffer object on an offscreen surface; nothing is shown and no
+ * event loop runs. Each renderFrame() call paints one frame, as fast as the GPU allows, and
+ * hands it to the recording started with startRecording(). Frames are never dropped: rendering
+ * waits for the encoder when it falls behind.
+ *
+ * @note Creates the QApplication if none exists. Without DISPLAY or WAYLAND_DISPLAY it selects
+ *       Qt's "offscreen" platform unless QT_QPA_PLATFORM is set; GPU servers without X can use
+ *       QT_QPA_PLATFORM=eglfs instead.
+ *
+ * @example Offline export:
+ * @code
+ * auto renderer = HeadlessRenderer::create(1920, 1080);
+ * RecordingOptions options;
+ * options.output_path = "replay.mp4";
+ * renderer.startRecording(options);
+ * for (const auto& step : log) {
+ *     renderer.setLayer(step.objects, "replay");
+ *     renderer.setCamera(step.eye, step.target);
+ *     renderer.renderFrame();
+ * }
+ * renderer.stopRecording();
+ * @endcode
+ */
+class OCTO_FLEX_VIEW_API HeadlessRenderer {
+   public:
+    /**
+     * @brief Create a renderer with a frame size of width x height pixels
+     *
+     * @param width Frame width
+     * @param height Frame height
+     * @param argc Qt argc (optional, uses dummy if not provided)
+     * @param argv Qt argv (optional, uses dummy if not provided)
+     * @return Renderer instance; the OpenGL context is created by the first renderFrame()
+     */
+    static HeadlessRenderer create(int width = 1920, int height = 1080, int* argc = nullptr,
+                                   char*** argv = nullptr);
+
+    /**
+     * @brief Add object to a layer (fluent API)
+     *
+     * @param object Object to add
+     * @param layer_id Layer identifier
+     * @return Reference to this renderer (for chaining)
+     */
+    HeadlessRenderer& add(std::shared_ptr<Object> object, const std::string& layer_id = "default");
+
+    /**
+     * @brief Replace all objects in a layer (fluent API)
+     *
+     * @param objects Vector of objects to set
+     * @param layer_id Layer identifier
+     * @return Reference to this renderer (for chaining)
+     */
+    HeadlessRenderer& setLayer(const std::vector<std::shared_ptr<Object>>& objects,
+                               const std::string& layer_id = "default");
+
+    /**
+     * @brief Apply a partial update to a layer (fluent API)
+     *
+     * @param upserts Objects to add or replace (matched by ID)
+     * @param removed_ids IDs of objects to remove
+     * @param layer_id Layer identifier
+     * @return Reference to this renderer (for chaining)
+     */
+    HeadlessRenderer& submitLayerDelta(const std::vector<std::shared_ptr<Object>>& upserts,
+                                       const std::vector<std::string>& removed_ids,
+                                       const std::string& layer_id = "default");
+
+    /**
+     * @brief Move a submitted object to a new pose (fluent API)
+     *
+     * @param id Object ID
+     * @param position New world position
+     * @param orientation New world orientation
+     * @return Reference to this renderer (for chaining)
+     */
+    HeadlessRenderer& updatePose(const std::string& id, const Vec3& position, const Quaternion& orientation);
+
+    /**
+     * @brief Replace the scalar values of a submitted object (fluent API)
+     *
+     * @param id Object ID
+     * @param values One value for the object, or one per vertex (see ObjectBuilder::scalars())
+     * @param count Number of values
+     * @return Reference to this renderer (for chaining)
+     */
+    HeadlessRenderer& updateScalars(const std::string& id, const float* values, size_t count);
+
+    /**
+     * @brief Change the colormap and value range of a submitted object's scalars (fluent API)
+     *
+     * @return Reference to this renderer (for chaining)
+     */
+    HeadlessRenderer& setScalarMapping(const std::string& id, Colormap colormap, double min, double max);
+
+    /**
+     * @brief Get object manager for advanced operations
+     * @return Shared pointer to object manager
+     */
+    std::shared_ptr<ObjectManager> objectManager() const;
+
+    /**
+     * @brief Save every layer of the scene to a binary snapshot file
+     * @return false if the file could not be written (see getLastError())
+     *
+     * @note Textures given as images and dynamic textures are not saved.
+     */
+    bool saveScene(const std::string& path);
+
+    /**
+     * @brief Load a snapshot written by saveScene, replacing the layers it holds
+     * @return false if the file is not a valid snapshot (see getLastError()); nothing changes then
+     */
+    bool loadScene(const std::string& path);
+
+    /**
+     * @brief Place the camera
+     *
+     * @param position Camera position in world coordinates
+     * @param target Point the camera looks at
+     * @param up Up direction (default: +Z)
+     */
+    void setCamera(const Vec3& position, const Vec3& target, const Vec3& up = Vec3(0, 0, 1));
+
+    /**
+     * @brief Change the frame size
+     *
+     * @note Not allowed while recording; the video keeps the size it started with.
+     */
+    bool resize(int width, int height);
+
+    int width() const;
+    int height() const;
+
+    /**
+     * @brief Render one frame and record it if a recording is running
+     * @return false if rendering or recording failed (see getLastError())
+     */
+    bool renderFrame();
+
+    /**
+     * @brief Render one frame and save it as an image (format from the file suffix, e.g. PNG)
+     *
+     * @param path Output image path
+     * @return false if rendering or saving failed (see getLastError())
+     *
+     * @note Also records the frame if a recording is running.
+     */
+    bool saveFrame(const std::string& path);
+
+    /**
+     * @brief Start recording the rendered frames
+     *
+     * @param options Output, codec and encoder options; capture_all_views is not supported and the
+     *        recording is always offline (see RecordingOptions::offline)
+     * @return false on failure (see getLastError())
+     *
+     * @note fps only sets the frame rate stored in the video: every renderFrame() adds one frame.
+     */
+    bool startRecording(const RecordingOptions& options);
+    bool stopRecording();
+    bool isRecording() const;
+    // Written, dropped and stalled frame counts of the current or last recording.
+    RecordingStats getRecordingStats() const;
+
+    /**
+     * @brief Description of the last failure
+     */
+    std::string getLastError() const;
+
+    /**
+     * @brief Destructor
+     */
+    ~HeadlessRenderer();
+
+    // Disable copy (use move semantics if needed)
+    HeadlessRenderer(const HeadlessRenderer&) = delete;
+    HeadlessRenderer& operator=(const HeadlessRenderer&) = delete;
+
+    // Enable move
+    HeadlessRenderer(HeadlessRenderer&&) noexcept;
+    HeadlessRenderer& operator=(HeadlessRenderer&&) noexcept;
+
+   private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+
+    HeadlessRenderer();
+};
+
+}  // namespace octo_flex
+
+#endif  // HEADLESS_RENDERER_H
@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEMORY_STATS_H
+#define MEMORY_STATS_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace octo_flex {
+
+/**
+ * @brief Memory held by the objects of one layer, for budgets and alarms.
+ */
+struct LayerMemoryStats {
+    std::string layer_id;
+    size_t objects = 0;
+    size_t shapes = 0;            // Instanced prototypes included
+    size_t vertices = 0;          // Stored vertices of all shapes
+    size_t cpu_bytes = 0;         // Points, colors, packed vertices, triangles, octrees and instances in memory
+    size_t gpu_buffer_bytes = 0;  // Vertex, index and instance buffers uploaded so far, and the layer's merged batch
+    size_t texture_bytes = 0;     // Textures drawn by the layer's quads, each counted once per layer
+    size_t pending_objects = 0;   // Replaced or removed objects waiting for the next frame to release them
+    size_t pending_bytes = 0;     // CPU and GPU bytes of those objects
+};
+
+/**
+ * @brief Memory of every layer of a scene, and the sum.
+ */
+struct SceneMemoryStats {
+    std::vector<LayerMemoryStats> layers;  // Sorted by layer id
+    LayerMemoryStats total;                // A texture drawn by several layers is counted in each
+};
+
+}  // namespace octo_flex
+
+#endif  // MEMORY_STATS_H
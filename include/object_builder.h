@@ -17,19 +17,24 @@
 #ifndef OCTO_FLEX_OBJECT_BUILDER_H
 #define OCTO_FLEX_OBJECT_BUILDER_H
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "colormap.h"
 #include "def.h"
+#include "dynamic_texture.h"
 #include "octo_flex_export.h"
 #include "texture_image.h"
+#include "trajectory.h"
 
 namespace octo_flex {
 
 // Forward declarations
 class Object;
 class Shape;
+enum class UnitMesh;
 
 /**
  * @brief Fluent builder for complex Object construction
@@ -188,6 +193,27 @@ class OCTO_FLEX_VIEW_API ObjectBuilder {
      */
     ObjectBuilder& capsule(const Vec3& color, double radius, double height, bool transparent = true);
 
+    /**
+     * @brief Set the levels of detail generated for the curved primitives added after this call
+     * @param segments Tessellation segments per level, finest first (default {10, 6, 4})
+     * @param switch_pixels Projected diameters in pixels between consecutive levels, decreasing
+     *        (default {48, 16}); one fewer than segments
+     * @return Reference to this builder (for chaining)
+     *
+     * Applies to sphere(), cylinder(), cone(), ellipsoid() and capsule(). The viewer draws the level
+     * matching the object's size on screen each frame. A single segment count generates one level and
+     * turns level of detail off. Must be called before the first of these primitives.
+     *
+     * @example
+     * @code
+     * auto marker = ObjectBuilder::begin("marker")
+     *     .withDetailLevels({24, 12, 6}, {96, 24})
+     *     .sphere(Vec3(1, 0, 0), 0.5)
+     *     .build();
+     * @endcode
+     */
+    ObjectBuilder& withDetailLevels(const std::vector<int>& segments, const std::vector<double>& switch_pixels);
+
     // ========================================================================
     // Basic Shapes (Points, Lines, Dash, Loop, Polygon)
     // ========================================================================
@@ -222,6 +248,37 @@ class OCTO_FLEX_VIEW_API ObjectBuilder {
     ObjectBuilder& points(const std::vector<Vec3>& points, const std::vector<Vec3>& colors, double point_size = 1.0,
                           bool transparent = true);
 
+    /**
+     * @brief Add packed point cloud (float32 position + RGBA8 color, 16 bytes per point)
+     * @param vertices Packed vertices, moved in without copying
+     * @param point_size Point size in pixels (default: 1.0)
+     * @return Reference to this builder (for chaining)
+     *
+     * @note Intended for large clouds: an octree is built on submit and each frame draws
+     *       the nodes that matter on screen within the view's point budget.
+     *
+     * @example
+     * @code
+     * std::vector<PackedVertex> cloud = loadScan();
+     * auto obj = ObjectBuilder::begin("scan")
+     *     .pointCloud(std::move(cloud), 2.0)
+     *     .build();
+     * @endcode
+     */
+    ObjectBuilder& pointCloud(std::vector<PackedVertex>&& vertices, double point_size = 1.0);
+
+    /**
+     * @brief Add packed point cloud from raw arrays
+     * @param xyz Positions, 3 floats per point
+     * @param count Number of points
+     * @param color Color for all points (used when rgba is null)
+     * @param rgba Optional per-point colors, 4 bytes per point
+     * @param point_size Point size in pixels (default: 1.0)
+     * @return Reference to this builder (for chaining)
+     */
+    ObjectBuilder& pointCloud(const float* xyz, size_t count, const Vec3& color, const uint8_t* rgba = nullptr,
+                              double point_size = 1.0);
+
     /**
      * @brief Add lines shape (renders pairs of vertices as line segments)
      * @param points Vertex positions (should be even number for paired lines)
@@ -345,6 +402,45 @@ class OCTO_FLEX_VIEW_API ObjectBuilder {
      */
     ObjectBuilder& polygon(const std::vector<Vec3>& points, const std::vector<Vec3>& colors, bool transparent = true);
 
+    /**
+     * @brief Add polygon shape with holes
+     * @param outer Vertex positions of the outer boundary
+     * @param holes Vertex positions of each hole boundary (same plane as the outer boundary)
+     * @param color Single color for the polygon
+     * @param transparent Whether shape is transparent (default: true)
+     * @return Reference to this builder (for chaining)
+     *
+     * @note The polygon is triangulated once when the object is added to a view
+     */
+    ObjectBuilder& polygon(const std::vector<Vec3>& outer, const std::vector<std::vector<Vec3>>& holes,
+                           const Vec3& color, bool transparent = true);
+
+    /**
+     * @brief Add line strip through the points of a trajectory, e.g. a vehicle trail
+     * @param trajectory Trajectory shared with the thread appending its points
+     * @param line_width Line width in pixels (default: 1.0)
+     * @return Reference to this builder (for chaining)
+     *
+     * @note The object is built once; points go through Trajectory::append() and trimFront(), and
+     *       the views upload only the new ones. Transparency comes from the trajectory.
+     *
+     * @example
+     * @code
+     * auto trail = Trajectory::create(50000);
+     * viewer.add(ObjectBuilder::begin("trail").trajectory(trail, 2.0).build());
+     * trail->append({Vec3(0, 0, 0), Vec3(1, 0, 0)}, Vec3(0, 1, 0));
+     * @endcode
+     */
+    ObjectBuilder& trajectory(std::shared_ptr<Trajectory> trajectory, double line_width = 1.0);
+
+    /**
+     * @brief Add the points of a trajectory as points
+     * @param trajectory Trajectory shared with the thread appending its points
+     * @param point_size Point size in pixels (default: 1.0)
+     * @return Reference to this builder (for chaining)
+     */
+    ObjectBuilder& trajectoryPoints(std::shared_ptr<Trajectory> trajectory, double point_size = 1.0);
+
     // ========================================================================
     // Texture Support
     // ========================================================================
@@ -355,10 +451,14 @@ class OCTO_FLEX_VIEW_API ObjectBuilder {
      * @param height World-space height
      * @param texture_path Path to texture image file (PNG, JPG, BMP, etc.)
      * @param transparency Alpha value (0.0 = invisible, 1.0 = opaque, default: 1.0)
+     * @param mipmaps Generate mip levels on upload, against aliasing when zoomed out (default: false)
      * @return Reference to this builder (for chaining)
      *
      * @note Texture loading is handled automatically using lazy loading mechanism.
      *       No need to worry about OpenGL context timing.
+     * @note KTX2 files (.ktx2) are uploaded in their own format with their own mip levels: RGBA8, or
+     *       BC1/BC3/BC7, ETC2 or ASTC 4x4/8x8 compressed, where the context supports it.
+     * @note Quads from the same file share one decoded texture; see setTextureMemoryBudget().
      *
      * @example Loading from file:
      * @code
@@ -369,7 +469,7 @@ class OCTO_FLEX_VIEW_API ObjectBuilder {
      * @endcode
      */
     ObjectBuilder& texturedQuad(double width, double height, const std::string& texture_path,
-                                double transparency = 1.0);
+                                double transparency = 1.0, bool mipmaps = false);
 
     /**
      * @brief Add textured quad from custom image data
@@ -380,7 +480,9 @@ class OCTO_FLEX_VIEW_API ObjectBuilder {
      * @return Reference to this builder (for chaining)
      *
      * @note This allows programmatic texture generation (gradients, patterns, etc.)
+     * @note Set TextureImage::generate_mipmaps, or pass precompressed blocks with their mip levels.
      * @note Texture loading is handled automatically using lazy loading mechanism.
+     * @note Quads with identical pixels share one texture, found by a hash of the pixels.
      *
      * @example Using custom image data:
      * @code
@@ -412,6 +514,48 @@ class OCTO_FLEX_VIEW_API ObjectBuilder {
      */
     ObjectBuilder& texturedQuad(const TextureImage& image, double width, double height, double transparency = 1.0);
 
+    /**
+     * @brief Add textured quad showing a dynamic texture, e.g. a live camera feed
+     * @param texture Texture shared with the thread producing its frames
+     * @param width World-space width
+     * @param height World-space height
+     * @param transparency Alpha value (0.0 = invisible, 1.0 = opaque, default: 1.0)
+     * @return Reference to this builder (for chaining)
+     *
+     * @note The object is built once; new frames go through DynamicTexture::update() and friends,
+     *       and the quad shows nothing until the first frame is uploaded.
+     */
+    ObjectBuilder& texturedQuad(std::shared_ptr<DynamicTexture> texture, double width, double height,
+                                double transparency = 1.0);
+
+    // ========================================================================
+    // Instancing
+    // ========================================================================
+
+    /**
+     * @brief Add many copies of a prototype object's geometry, drawn with one instanced call per prototype shape
+     * @param prototype Object whose shapes are shared by all instances (textured shapes are skipped)
+     * @param positions Per-instance positions (one instance per entry)
+     * @param orientations Per-instance orientations (default: identity; must match positions size)
+     * @param scales Per-instance scales (default: 1; must match positions size)
+     * @param colors Per-instance colors replacing the prototype colors (default: prototype colors)
+     * @return Reference to this builder (for chaining)
+     *
+     * @note Picking selects the whole object and reports the hit instance index through the view.
+     *
+     * @example
+     * @code
+     * auto cone = ObjectBuilder::begin("cone_proto").cone(Vec3(1, 0.5, 0), 0.1, 0.3, false).build();
+     * std::vector<Vec3> positions = {{0, 0, 0}, {1, 0, 0}, {2, 0, 0}};
+     * auto obj = ObjectBuilder::begin("cones")
+     *     .instances(cone, positions)
+     *     .build();
+     * @endcode
+     */
+    ObjectBuilder& instances(std::shared_ptr<Object> prototype, const std::vector<Vec3>& positions,
+                             const std::vector<Quaternion>& orientations = {}, const std::vector<Vec3>& scales = {},
+                             const std::vector<Vec3>& colors = {});
+
     // ========================================================================
     // Custom Shapes
     // ========================================================================
@@ -423,6 +567,42 @@ class OCTO_FLEX_VIEW_API ObjectBuilder {
      */
     ObjectBuilder& addShape(std::shared_ptr<Shape> shape);
 
+    // ========================================================================
+    // Scalar Attributes
+    // ========================================================================
+
+    /**
+     * @brief Color the object from float values mapped through a colormap
+     *
+     * A single value colors the whole object. Otherwise values holds one value per vertex of the
+     * object's points, lines, dashed lines, loops and polygons, in the order they were added; other
+     * shapes keep their colors. The colormap lookup runs on the GPU, so replacing the values with
+     * updateScalars() on the viewers uploads only the float array, and setScalarMapping() changes
+     * the colormap and range without uploading anything.
+     *
+     * @param values One value for the object, or one per vertex (checked by build())
+     * @param colormap Color scale (default: Viridis)
+     * @param min Value mapped to the start of the colormap (default: 0)
+     * @param max Value mapped to its end (default: 1)
+     * @return Reference to this builder (for chaining)
+     *
+     * @note Objects with scalars are drawn outside the layer batches; scene snapshots keep the
+     *       vertex colors instead.
+     *
+     * @example Occupancy heatmap:
+     * @code
+     * viewer.add(ObjectBuilder::begin("occupancy")
+     *     .points(cell_centers, Vec3(1, 1, 1), 4.0)
+     *     .scalars(occupancy, Colormap::Turbo)
+     *     .build(), "maps");
+     *
+     * // Every tick
+     * viewer.updateScalars("occupancy", occupancy.data(), occupancy.size());
+     * @endcode
+     */
+    ObjectBuilder& scalars(const std::vector<float>& values, Colormap colormap = Colormap::Viridis,
+                           double min = 0.0, double max = 1.0);
+
     // ========================================================================
     // Transformations
     // ========================================================================
@@ -582,12 +762,14 @@ class OCTO_FLEX_VIEW_API ObjectBuilder {
 
     // Store texture data for deferred loading
     struct PendingTexture {
-        std::string path;     // File path (if use_image == false)
-        TextureImage image;   // Image data (if use_image == true)
-        bool use_image;       // true = use image, false = use path
-        double width;         // World-space width
-        double height;        // World-space height
-        double transparency;  // Alpha value
+        std::string path;                         // File path (if use_image == false)
+        TextureImage image;                       // Image data (if use_image == true)
+        std::shared_ptr<DynamicTexture> dynamic;  // Live texture, if set
+        bool use_image;                           // true = use image, false = use path
+        double width;                             // World-space width
+        double height;                            // World-space height
+        double transparency;                      // Alpha value
+        bool mipmaps;                             // Generate the mip chain of a decoded file
     };
     std::vector<PendingTexture> pending_textures_;
 
@@ -604,15 +786,35 @@ class OCTO_FLEX_VIEW_API ObjectBuilder {
     Quaternion next_shape_orientation_;  // Default unit quaternion
     Vec3 next_shape_scale_{1, 1, 1};
 
+    // Levels of detail of the curved primitives
+    std::vector<int> lod_segments_{10, 6, 4};  // Segments per level, finest first
+    std::vector<float> lod_pixels_{48, 16};    // Switch sizes between levels
+    bool has_lod_shapes_ = false;              // Whether a leveled primitive was added
+
+    // Scalar attribute, attached by build() once all shapes are known
+    std::vector<float> scalar_values_;
+    Colormap scalar_colormap_ = Colormap::Viridis;
+    double scalar_min_ = 0.0;
+    double scalar_max_ = 1.0;
+
     // Private constructor (use begin() to create)
     explicit ObjectBuilder(const std::string& id);
 
     // Apply pending textures (called in build())
     void applyPendingTextures();
 
+    // Attach the scalar attribute if its count fits the shapes (called in build())
+    void applyScalars();
+
     // Phase 1: Apply and reset pending shape transforms
     void applyPendingShapeTransform(std::shared_ptr<Shape> shape);
     void resetPendingShapeTransform();
+
+    // Add a unit primitive scaled to size, one shared mesh per level of detail for curved ones
+    ObjectBuilder& addMesh(UnitMesh type, const Vec3& size, const Vec3& color, bool transparent);
+
+    // Add every level of detail of a primitive generated with the given segment count
+    ObjectBuilder& addPrimitive(const std::function<std::shared_ptr<Object>(int segments)>& generate);
 };
 
 }  // namespace octo_flex
@@ -22,8 +22,17 @@
 #include <string>
 
 #include "octo_flex_export.h"
+#include "colormap.h"
 #include "def.h"
+#include "frame_timing_stats.h"
+#include "memory_stats.h"
 #include "recording_options.h"
+#include "shared_scene.h"
+#include "submission_log.h"
+#include "render_backend_type.h"
+#include "scene_query.h"
+#include "texture_upload_stats.h"
+#include "update_queue_stats.h"
 
 class QWidget;
 
@@ -104,6 +113,223 @@ class OCTO_FLEX_VIEW_API EmbeddedViewer {
     EmbeddedViewer& setLayer(const std::vector<std::shared_ptr<Object>>& objects,
                               const std::string& layer_id = "default");
 
+    /**
+     * @brief Apply a partial update to a layer (fluent API)
+     *
+     * Inserts or replaces the upserted objects and removes the listed IDs in one atomic
+     * layer update. Objects not mentioned keep their GPU resources.
+     *
+     * @param upserts Objects to add or replace (matched by ID)
+     * @param removed_ids IDs of objects to remove
+     * @param layer_id Layer identifier
+     * @return Reference to this viewer (for chaining)
+     *
+     * @example
+     * @code
+     * embeddedViewer.submitLayerDelta({moved_obj, new_obj}, {"track_17"}, "perception");
+     * @endcode
+     */
+    EmbeddedViewer& submitLayerDelta(const std::vector<std::shared_ptr<Object>>& upserts,
+                                     const std::vector<std::string>& removed_ids,
+                                     const std::string& layer_id = "default");
+
+    /**
+     * @brief Build objects in parallel and add them in one layer update (fluent API)
+     *
+     * Calls build(i) for every i in [0, count) on a shared worker pool, finalizes the
+     * returned objects on the workers, then adds them all to the layer atomically.
+     * build runs concurrently and must be thread-safe; null results are skipped.
+     *
+     * @param count Number of objects to build
+     * @param build Builder invoked with the object index
+     * @param layer_id Layer identifier
+     * @return Reference to this viewer (for chaining)
+     *
+     * @example
+     * @code
+     * embeddedViewer.addBatch(tracks.size(), [&](size_t i) {
+     *     return ObjectBuilder::begin("track_" + std::to_string(i)).sphere(Vec3(1, 0, 0), 0.2).at(tracks[i]).build();
+     * }, "perception");
+     * @endcode
+     */
+    EmbeddedViewer& addBatch(size_t count, const std::function<std::shared_ptr<Object>(size_t)>& build,
+                             const std::string& layer_id = "default");
+
+    /**
+     * @brief Move a submitted object to a new pose (fluent API)
+     *
+     * The pose is applied as a model matrix at draw time; the object's geometry is not
+     * rebuilt or uploaded again. Cameras attached to the object follow the new pose.
+     * Safe to call from any thread. Unknown IDs are reported and ignored.
+     *
+     * @param id Object ID
+     * @param position New world position
+     * @param orientation New world orientation
+     * @return Reference to this viewer (for chaining)
+     *
+     * @example
+     * @code
+     * embeddedViewer.updatePose("vehicle_3", Vec3(x, y, 0), Quaternion(0, 0, std::sin(yaw / 2), std::cos(yaw / 2)));
+     * @endcode
+     */
+    EmbeddedViewer& updatePose(const std::string& id, const Vec3& position, const Quaternion& orientation);
+
+    /**
+     * @brief Replace the scalar values of a submitted object (fluent API)
+     *
+     * The object must have been built with ObjectBuilder::scalars(); count must match the
+     * values it was built with. Only the float array is uploaded at the next frame and the
+     * colors are mapped on the GPU, so the object is neither rebuilt nor resubmitted.
+     * Safe to call from any thread. Unknown IDs and mismatching counts are reported and ignored.
+     *
+     * @param id Object ID
+     * @param values One value for the object, or one per vertex
+     * @param count Number of values
+     * @return Reference to this viewer (for chaining)
+     *
+     * @example
+     * @code
+     * embeddedViewer.updateScalars("occupancy", occupancy.data(), occupancy.size());
+     * @endcode
+     */
+    EmbeddedViewer& updateScalars(const std::string& id, const float* values, size_t count);
+
+    /**
+     * @brief Change the colormap and value range of a submitted object's scalars (fluent API)
+     *
+     * Nothing is uploaded; the next frame maps the current values with the new range.
+     * Safe to call from any thread. Unknown IDs are reported and ignored.
+     *
+     * @param id Object ID
+     * @param colormap Color scale
+     * @param min Value mapped to the start of the colormap
+     * @param max Value mapped to its end
+     * @return Reference to this viewer (for chaining)
+     */
+    EmbeddedViewer& setScalarMapping(const std::string& id, Colormap colormap, double min, double max);
+
+    /**
+     * @brief Queue an object for the next frame without blocking
+     *
+     * The enqueue* calls never wait on the scene locks the renderer holds, so sensor threads
+     * can call them at high rate. The object is finalized on the calling thread; queued
+     * commands are applied in order by the render thread at the start of the next frame.
+     *
+     * @param object Object to add or replace (matched by ID)
+     * @param layer_id Layer identifier
+     * @return false if the queue is full and the command was dropped
+     *
+     * @example
+     * @code
+     * // On a sensor thread
+     * if (!embeddedViewer.enqueue(detection, "perception")) { ++missed; }
+     * @endcode
+     */
+    bool enqueue(std::shared_ptr<Object> object, const std::string& layer_id = "default");
+
+    /**
+     * @brief Queue removal of an object (see enqueue)
+     *
+     * @return false if the queue is full and the command was dropped
+     */
+    bool enqueueRemove(const std::string& id, const std::string& layer_id = "default");
+
+    /**
+     * @brief Queue replacement of all objects in a layer (see enqueue)
+     *
+     * @return false if the queue is full and the command was dropped
+     */
+    bool enqueueLayer(const std::vector<std::shared_ptr<Object>>& objects, const std::string& layer_id = "default");
+
+    /**
+     * @brief Queue a pose update (see enqueue and updatePose)
+     *
+     * @return false if the queue is full and the command was dropped
+     */
+    bool enqueuePose(const std::string& id, const Vec3& position, const Quaternion& orientation);
+
+    /**
+     * @brief Queue depth and counters of the enqueue* path
+     *
+     * @return Current depth, capacity, and pushed, dropped and applied command counts
+     */
+    UpdateQueueStats updateQueueStats() const;
+
+    /**
+     * @brief Queue depth, budget and latency of the background texture upload, and the texture cache
+     *
+     * @return Pending and uploaded counts, the per-frame byte budget, p50/p99 time to ready, and the
+     *         resident memory, hits and evictions of the shared texture cache
+     */
+    TextureUploadStats textureUploadStats() const;
+
+    /**
+     * @brief Limit the texture bytes uploaded per painted frame
+     * @param bytes Pixel bytes per frame (default 64 MB); 0 removes the limit
+     *
+     * @note Textured quads nearest to the camera upload first; a quad is drawn once its texture is ready.
+     */
+    void setTextureUploadBudget(size_t bytes);
+
+    /**
+     * @brief Limit the texture memory kept for textures no quad shows any more
+     * @param bytes Texture bytes (default 512 MB); 0 removes the limit
+     *
+     * @note Textures shared by the quads of a file or image stay resident after the last quad is removed,
+     *       for reuse, until the total exceeds the budget; the least recently drawn go first.
+     */
+    void setTextureMemoryBudget(size_t bytes);
+
+    /**
+     * @brief Save every layer of the scene to a binary snapshot file
+     * @param path Output file, replaced only once it is complete
+     * @param error Set to the reason of a failure (optional)
+     * @return false if the file could not be written
+     *
+     * @note Quads keep the files their textures were loaded from; textures given as images and dynamic
+     *       textures are not saved, so those quads come back untextured.
+     */
+    bool saveScene(const std::string& path, std::string* error = nullptr) const;
+
+    /**
+     * @brief Load a snapshot written by saveScene
+     * @param path Snapshot file
+     * @param error Set to the reason of a failure (optional)
+     * @return false if the file could not be read or is not a valid snapshot
+     *
+     * @note The file is memory-mapped and vertex data is uploaded to the GPU straight from it, without
+     *       being triangulated or indexed again. Its layers replace the layers of the same name; nothing
+     *       changes if the file is invalid.
+     */
+    bool loadScene(const std::string& path, std::string* error = nullptr);
+
+    /**
+     * @brief Start logging every scene update with its time, for replay with SubmissionReplay
+     * @param options Output file, keyframe interval and write batching
+     * @param error Set to the reason of a failure (optional)
+     * @return false if a log is already running or the file cannot be created
+     */
+    bool startSubmissionLog(const SubmissionLogOptions& options, std::string* error = nullptr);
+
+    /**
+     * @brief Write what is still queued and close the submission log
+     * @return false if writing the log failed
+     */
+    bool stopSubmissionLog();
+    SubmissionLogStats submissionLogStats() const;
+
+    /**
+     * @brief Open a shared scene channel that other processes submit through with SharedSceneSender
+     * @param name Shared memory key the senders attach to
+     * @param options Arena and ring sizes
+     * @param error Set to the reason of a failure (optional)
+     * @return false if the name is taken or the shared memory cannot be created
+     */
+    bool openSharedScene(const std::string& name, const SharedSceneOptions& options = SharedSceneOptions(),
+                         std::string* error = nullptr);
+    void closeSharedScene(const std::string& name);
+    SharedSceneStats sharedSceneStats(const std::string& name) const;
+
     /**
      * @brief Quick add: sphere (fluent API)
      *
@@ -152,6 +378,84 @@ class OCTO_FLEX_VIEW_API EmbeddedViewer {
      */
     QWidget* widget() const;
 
+    /**
+     * @brief Switch all views between on-demand and fixed-rate repainting
+     * @param enabled true to repaint continuously at the refresh rate, false to repaint only on changes
+     *
+     * @note Views repaint on demand by default: only when the scene, camera, selection or
+     *       info panel changed. Continuous refresh is useful for external frame grabbing.
+     */
+    void setContinuousRefresh(bool enabled);
+
+    /**
+     * @brief Per-pass CPU and GPU frame times of the current view
+     *
+     * @return Rolling p50/p99 times of the frame and of each paint pass, in milliseconds
+     *
+     * @note GPU times lag the CPU times by two frames and stay zero without timer query support.
+     */
+    FrameTimingStats frameTimingStats() const;
+
+    /**
+     * @brief Show per-pass frame times in the info panel of every view
+     * @param enabled true to list the rolling p50/p99 times, refreshed once per second
+     */
+    void setFrameTimingOverlay(bool enabled);
+
+    /**
+     * @brief Object, shape and vertex counts and memory of every layer
+     *
+     * @return Per-layer and total CPU bytes, GPU buffer bytes (the merged batches of the current view
+     *         included), texture bytes, and the objects replaced or removed but not yet released
+     *
+     * @note Sums the sizes the shapes keep, without locking the scene or calling OpenGL, so it can
+     *       be polled from a timer for budgets and alarms.
+     */
+    SceneMemoryStats memoryStats() const;
+
+    /**
+     * @brief Show per-layer memory in the info panel of every view
+     * @param enabled true to list each layer and the total, refreshed once per second
+     */
+    void setMemoryOverlay(bool enabled);
+
+    /**
+     * @brief IDs of the objects with any geometry inside an axis-aligned box
+     *
+     * @note Searches every layer, hidden ones included, through a bounding volume hierarchy per
+     *       layer that is refit or rebuilt on first use after the layer changes. Callable from any thread.
+     */
+    std::vector<std::string> queryBox(const BoundingBox& box) const;
+
+    /**
+     * @brief Nearest object under a ray
+     * @param origin Start of the ray
+     * @param direction Direction of the ray, need not be unit length
+     * @param hit Receives the object, its layer, the distance from origin and the point hit
+     * @param radius Points and lines this close to the ray count as hit; surfaces are hit exactly
+     * @return false if the ray hits nothing
+     *
+     * @note Searches every layer like queryBox(); typically well under a millisecond, so it suits hover.
+     */
+    bool raycast(const Vec3& origin, const Vec3& direction, RaycastHit* hit, double radius = 0.0) const;
+
+    /**
+     * @brief Pick on the CPU with the layers' bounding volume hierarchies (the default)
+     * @param enabled false to pick with a GPU pick pass, which only selects what is visible
+     *
+     * @note CPU rubber-band selection takes every object in the band, occluded ones included.
+     */
+    void setCpuPicking(bool enabled);
+
+    /**
+     * @brief Damp level of detail switches of objects built with detail levels
+     * @param fraction How far past a switch size (e.g. 0.1 = 10%) the projected size must move before the
+     *        drawn level changes; 0 (the default) switches exactly at the sizes
+     *
+     * @note See ObjectBuilder::withDetailLevels(). Avoids flicker for objects hovering at a switch size.
+     */
+    void setLodHysteresis(double fraction);
+
     /**
      * @brief Export selected object IDs from the current view
      * @return Vector of selected object IDs
@@ -169,6 +473,8 @@ class OCTO_FLEX_VIEW_API EmbeddedViewer {
     bool isRecording() const;
     bool isRecordingPaused() const;
     std::string getLastRecordingError() const;
+    // Written, dropped and stalled frame counts of the current or last recording.
+    RecordingStats getRecordingStats() const;
 
     /**
      * @brief Destructor
@@ -221,6 +527,8 @@ class OCTO_FLEX_VIEW_API OctoFlexViewer {
      *
      * @note This mode does NOT create a QMainWindow or manage the event loop.
      * @note User must have already created QApplication before calling this.
+     * @note Split views share GPU resources. Set Qt::AA_ShareOpenGLContexts before creating
+     *       QApplication so they stay shared when views move between windows.
      * @note The returned viewer hides internal ObjectManager - use add() methods instead.
      *
      * @example
@@ -254,6 +562,32 @@ class OCTO_FLEX_VIEW_API OctoFlexViewer {
     static OctoFlexViewer create(const std::string& title = "OctoFlexView", int width = 1024, int height = 768,
                                   int* argc = nullptr, char*** argv = nullptr);
 
+    /**
+     * @brief Select the OpenGL pipeline views are drawn with
+     *
+     * @param type RenderBackendType::FIXED_FUNCTION (default) or RenderBackendType::SHADER
+     *
+     * @note Call before create() or createEmbedded(). The initial choice comes from the
+     *       OCTO_FLEX_RENDER_BACKEND environment variable ("fixed" or "shader").
+     * @note When create() makes the QApplication it also requests the core-profile context the shader
+     *       backend needs. Embedded hosts set a matching default QSurfaceFormat themselves.
+     * @note A view whose context cannot run the shader backend falls back to fixed function.
+     */
+    static void setRenderBackend(RenderBackendType type);
+    static RenderBackendType renderBackend();
+
+    /**
+     * @brief Paint each view on a render thread of its own instead of the Qt GUI thread
+     *
+     * @param enabled true to give views created afterwards a render thread (default false)
+     *
+     * @note The initial choice comes from the OCTO_FLEX_RENDER_THREAD environment variable ("1" or "on").
+     * @note The GUI thread keeps handling input and publishes each frame's camera and viewport without
+     *       locks; picking, capture, resizing and composite recording wait for the frame in flight.
+     */
+    static void setThreadedRendering(bool enabled);
+    static bool threadedRendering();
+
     /**
      * @brief Run the viewer application (blocking event loop)
      *
@@ -305,6 +639,223 @@ class OCTO_FLEX_VIEW_API OctoFlexViewer {
     OctoFlexViewer& setLayer(const std::vector<std::shared_ptr<Object>>& objects,
                               const std::string& layer_id = "default");
 
+    /**
+     * @brief Apply a partial update to a layer (fluent API)
+     *
+     * Inserts or replaces the upserted objects and removes the listed IDs in one atomic
+     * layer update. Objects not mentioned keep their GPU resources.
+     *
+     * @param upserts Objects to add or replace (matched by ID)
+     * @param removed_ids IDs of objects to remove
+     * @param layer_id Layer identifier
+     * @return Reference to this viewer (for chaining)
+     *
+     * @example
+     * @code
+     * viewer.submitLayerDelta({moved_obj, new_obj}, {"track_17"}, "perception");
+     * @endcode
+     */
+    OctoFlexViewer& submitLayerDelta(const std::vector<std::shared_ptr<Object>>& upserts,
+                                     const std::vector<std::string>& removed_ids,
+                                     const std::string& layer_id = "default");
+
+    /**
+     * @brief Build objects in parallel and add them in one layer update (fluent API)
+     *
+     * Calls build(i) for every i in [0, count) on a shared worker pool, finalizes the
+     * returned objects on the workers, then adds them all to the layer atomically.
+     * build runs concurrently and must be thread-safe; null results are skipped.
+     *
+     * @param count Number of objects to build
+     * @param build Builder invoked with the object index
+     * @param layer_id Layer identifier
+     * @return Reference to this viewer (for chaining)
+     *
+     * @example
+     * @code
+     * viewer.addBatch(tracks.size(), [&](size_t i) {
+     *     return ObjectBuilder::begin("track_" + std::to_string(i)).sphere(Vec3(1, 0, 0), 0.2).at(tracks[i]).build();
+     * }, "perception");
+     * @endcode
+     */
+    OctoFlexViewer& addBatch(size_t count, const std::function<std::shared_ptr<Object>(size_t)>& build,
+                             const std::string& layer_id = "default");
+
+    /**
+     * @brief Move a submitted object to a new pose (fluent API)
+     *
+     * The pose is applied as a model matrix at draw time; the object's geometry is not
+     * rebuilt or uploaded again. Cameras attached to the object follow the new pose.
+     * Safe to call from any thread. Unknown IDs are reported and ignored.
+     *
+     * @param id Object ID
+     * @param position New world position
+     * @param orientation New world orientation
+     * @return Reference to this viewer (for chaining)
+     *
+     * @example
+     * @code
+     * viewer.updatePose("vehicle_3", Vec3(x, y, 0), Quaternion(0, 0, std::sin(yaw / 2), std::cos(yaw / 2)));
+     * @endcode
+     */
+    OctoFlexViewer& updatePose(const std::string& id, const Vec3& position, const Quaternion& orientation);
+
+    /**
+     * @brief Replace the scalar values of a submitted object (fluent API)
+     *
+     * The object must have been built with ObjectBuilder::scalars(); count must match the
+     * values it was built with. Only the float array is uploaded at the next frame and the
+     * colors are mapped on the GPU, so the object is neither rebuilt nor resubmitted.
+     * Safe to call from any thread. Unknown IDs and mismatching counts are reported and ignored.
+     *
+     * @param id Object ID
+     * @param values One value for the object, or one per vertex
+     * @param count Number of values
+     * @return Reference to this viewer (for chaining)
+     *
+     * @example
+     * @code
+     * viewer.updateScalars("occupancy", occupancy.data(), occupancy.size());
+     * @endcode
+     */
+    OctoFlexViewer& updateScalars(const std::string& id, const float* values, size_t count);
+
+    /**
+     * @brief Change the colormap and value range of a submitted object's scalars (fluent API)
+     *
+     * Nothing is uploaded; the next frame maps the current values with the new range.
+     * Safe to call from any thread. Unknown IDs are reported and ignored.
+     *
+     * @param id Object ID
+     * @param colormap Color scale
+     * @param min Value mapped to the start of the colormap
+     * @param max Value mapped to its end
+     * @return Reference to this viewer (for chaining)
+     */
+    OctoFlexViewer& setScalarMapping(const std::string& id, Colormap colormap, double min, double max);
+
+    /**
+     * @brief Queue an object for the next frame without blocking
+     *
+     * The enqueue* calls never wait on the scene locks the renderer holds, so sensor threads
+     * can call them at high rate. The object is finalized on the calling thread; queued
+     * commands are applied in order by the render thread at the start of the next frame.
+     *
+     * @param object Object to add or replace (matched by ID)
+     * @param layer_id Layer identifier
+     * @return false if the queue is full and the command was dropped
+     *
+     * @example
+     * @code
+     * // On a sensor thread
+     * if (!viewer.enqueue(detection, "perception")) { ++missed; }
+     * @endcode
+     */
+    bool enqueue(std::shared_ptr<Object> object, const std::string& layer_id = "default");
+
+    /**
+     * @brief Queue removal of an object (see enqueue)
+     *
+     * @return false if the queue is full and the command was dropped
+     */
+    bool enqueueRemove(const std::string& id, const std::string& layer_id = "default");
+
+    /**
+     * @brief Queue replacement of all objects in a layer (see enqueue)
+     *
+     * @return false if the queue is full and the command was dropped
+     */
+    bool enqueueLayer(const std::vector<std::shared_ptr<Object>>& objects, const std::string& layer_id = "default");
+
+    /**
+     * @brief Queue a pose update (see enqueue and updatePose)
+     *
+     * @return false if the queue is full and the command was dropped
+     */
+    bool enqueuePose(const std::string& id, const Vec3& position, const Quaternion& orientation);
+
+    /**
+     * @brief Queue depth and counters of the enqueue* path
+     *
+     * @return Current depth, capacity, and pushed, dropped and applied command counts
+     */
+    UpdateQueueStats updateQueueStats() const;
+
+    /**
+     * @brief Queue depth, budget and latency of the background texture upload, and the texture cache
+     *
+     * @return Pending and uploaded counts, the per-frame byte budget, p50/p99 time to ready, and the
+     *         resident memory, hits and evictions of the shared texture cache
+     */
+    TextureUploadStats textureUploadStats() const;
+
+    /**
+     * @brief Limit the texture bytes uploaded per painted frame
+     * @param bytes Pixel bytes per frame (default 64 MB); 0 removes the limit
+     *
+     * @note Textured quads nearest to the camera upload first; a quad is drawn once its texture is ready.
+     */
+    void setTextureUploadBudget(size_t bytes);
+
+    /**
+     * @brief Limit the texture memory kept for textures no quad shows any more
+     * @param bytes Texture bytes (default 512 MB); 0 removes the limit
+     *
+     * @note Textures shared by the quads of a file or image stay resident after the last quad is removed,
+     *       for reuse, until the total exceeds the budget; the least recently drawn go first.
+     */
+    void setTextureMemoryBudget(size_t bytes);
+
+    /**
+     * @brief Save every layer of the scene to a binary snapshot file
+     * @param path Output file, replaced only once it is complete
+     * @param error Set to the reason of a failure (optional)
+     * @return false if the file could not be written
+     *
+     * @note Quads keep the files their textures were loaded from; textures given as images and dynamic
+     *       textures are not saved, so those quads come back untextured.
+     */
+    bool saveScene(const std::string& path, std::string* error = nullptr) const;
+
+    /**
+     * @brief Load a snapshot written by saveScene
+     * @param path Snapshot file
+     * @param error Set to the reason of a failure (optional)
+     * @return false if the file could not be read or is not a valid snapshot
+     *
+     * @note The file is memory-mapped and vertex data is uploaded to the GPU straight from it, without
+     *       being triangulated or indexed again. Its layers replace the layers of the same name; nothing
+     *       changes if the file is invalid.
+     */
+    bool loadScene(const std::string& path, std::string* error = nullptr);
+
+    /**
+     * @brief Start logging every scene update with its time, for replay with SubmissionReplay
+     * @param options Output file, keyframe interval and write batching
+     * @param error Set to the reason of a failure (optional)
+     * @return false if a log is already running or the file cannot be created
+     */
+    bool startSubmissionLog(const SubmissionLogOptions& options, std::string* error = nullptr);
+
+    /**
+     * @brief Write what is still queued and close the submission log
+     * @return false if writing the log failed
+     */
+    bool stopSubmissionLog();
+    SubmissionLogStats submissionLogStats() const;
+
+    /**
+     * @brief Open a shared scene channel that other processes submit through with SharedSceneSender
+     * @param name Shared memory key the senders attach to
+     * @param options Arena and ring sizes
+     * @param error Set to the reason of a failure (optional)
+     * @return false if the name is taken or the shared memory cannot be created
+     */
+    bool openSharedScene(const std::string& name, const SharedSceneOptions& options = SharedSceneOptions(),
+                         std::string* error = nullptr);
+    void closeSharedScene(const std::string& name);
+    SharedSceneStats sharedSceneStats(const std::string& name) const;
+
     /**
      * @brief Quick add: sphere (fluent API)
      *
@@ -377,6 +928,84 @@ class OCTO_FLEX_VIEW_API OctoFlexViewer {
      */
     void resize(int width, int height);
 
+    /**
+     * @brief Switch all views between on-demand and fixed-rate repainting
+     * @param enabled true to repaint continuously at the refresh rate, false to repaint only on changes
+     *
+     * @note Views repaint on demand by default: only when the scene, camera, selection or
+     *       info panel changed. Continuous refresh is useful for external frame grabbing.
+     */
+    void setContinuousRefresh(bool enabled);
+
+    /**
+     * @brief Per-pass CPU and GPU frame times of the current view
+     *
+     * @return Rolling p50/p99 times of the frame and of each paint pass, in milliseconds
+     *
+     * @note GPU times lag the CPU times by two frames and stay zero without timer query support.
+     */
+    FrameTimingStats frameTimingStats() const;
+
+    /**
+     * @brief Show per-pass frame times in the info panel of every view
+     * @param enabled true to list the rolling p50/p99 times, refreshed once per second
+     */
+    void setFrameTimingOverlay(bool enabled);
+
+    /**
+     * @brief Object, shape and vertex counts and memory of every layer
+     *
+     * @return Per-layer and total CPU bytes, GPU buffer bytes (the merged batches of the current view
+     *         included), texture bytes, and the objects replaced or removed but not yet released
+     *
+     * @note Sums the sizes the shapes keep, without locking the scene or calling OpenGL, so it can
+     *       be polled from a timer for budgets and alarms.
+     */
+    SceneMemoryStats memoryStats() const;
+
+    /**
+     * @brief Show per-layer memory in the info panel of every view
+     * @param enabled true to list each layer and the total, refreshed once per second
+     */
+    void setMemoryOverlay(bool enabled);
+
+    /**
+     * @brief IDs of the objects with any geometry inside an axis-aligned box
+     *
+     * @note Searches every layer, hidden ones included, through a bounding volume hierarchy per
+     *       layer that is refit or rebuilt on first use after the layer changes. Callable from any thread.
+     */
+    std::vector<std::string> queryBox(const BoundingBox& box) const;
+
+    /**
+     * @brief Nearest object under a ray
+     * @param origin Start of the ray
+     * @param direction Direction of the ray, need not be unit length
+     * @param hit Receives the object, its layer, the distance from origin and the point hit
+     * @param radius Points and lines this close to the ray count as hit; surfaces are hit exactly
+     * @return false if the ray hits nothing
+     *
+     * @note Searches every layer like queryBox(); typically well under a millisecond, so it suits hover.
+     */
+    bool raycast(const Vec3& origin, const Vec3& direction, RaycastHit* hit, double radius = 0.0) const;
+
+    /**
+     * @brief Pick on the CPU with the layers' bounding volume hierarchies (the default)
+     * @param enabled false to pick with a GPU pick pass, which only selects what is visible
+     *
+     * @note CPU rubber-band selection takes every object in the band, occluded ones included.
+     */
+    void setCpuPicking(bool enabled);
+
+    /**
+     * @brief Damp level of detail switches of objects built with detail levels
+     * @param fraction How far past a switch size (e.g. 0.1 = 10%) the projected size must move before the
+     *        drawn level changes; 0 (the default) switches exactly at the sizes
+     *
+     * @note See ObjectBuilder::withDetailLevels(). Avoids flicker for objects hovering at a switch size.
+     */
+    void setLodHysteresis(double fraction);
+
     /**
      * @brief Export selected object IDs from the current view
      * @return Vector of selected object IDs
@@ -394,6 +1023,8 @@ class OCTO_FLEX_VIEW_API OctoFlexViewer {
     bool isRecording() const;
     bool isRecordingPaused() const;
     std::string getLastRecordingError() const;
+    // Written, dropped and stalled frame counts of the current or last recording.
+    RecordingStats getRecordingStats() const;
 
     /**
      * @brief Destructor
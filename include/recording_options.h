@@ -17,6 +17,7 @@
 #ifndef RECORDING_OPTIONS_H
 #define RECORDING_OPTIONS_H
 
+#include <cstdint>
 #include <string>
 
 namespace octo_flex {
@@ -32,6 +33,29 @@ struct RecordingOptions {
     int crf = 23;
     bool overwrite = true;
     bool enable_alpha = false;  // If true, preserves alpha channel for transparent objects
+    // Encoder: "auto" (hardware when available, else software), "software", "nvenc", "vaapi" or
+    // "v4l2m2m". Hardware choices fall back to software; hardware encoders exist for H.264 and H.265.
+    std::string encoder = "auto";
+    // If true, record every visible view at its place in the layout instead of the current view only.
+    bool capture_all_views = false;
+    // Output resolution; 0 uses the captured area in device pixels. Frames are scaled on the GPU.
+    int width = 0;
+    int height = 0;
+    // If true, a frame is recorded each time HeadlessRenderer::renderFrame() is called instead of on a
+    // timer, as fast as rendering and encoding allow; capture waits for the encoder rather than dropping
+    // frames. Set by HeadlessRenderer::startRecording().
+    bool offline = false;
+};
+
+/**
+ * @brief Frame counters of the current (or last) recording.
+ */
+struct RecordingStats {
+    uint64_t frames_written = 0;  // Frames handed to the encoder
+    uint64_t frames_dropped = 0;  // Captured frames discarded because the encoder fell behind
+    uint64_t encoder_stalls = 0;  // Frames whose write to the encoder took longer than one frame interval
+    int frame_capacity = 0;       // Preallocated frame buffers between capture and encoder
+    std::string encoder;          // Encoder in use, for example "libav:h264_nvenc" or "ffmpeg:libx264"
 };
 
 }  // namespace octo_flex
@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RENDER_BACKEND_TYPE_H
+#define RENDER_BACKEND_TYPE_H
+
+namespace octo_flex {
+
+/**
+ * @brief OpenGL pipeline the views draw with.
+ */
+enum class RenderBackendType {
+    FIXED_FUNCTION,  // Legacy matrix stack and client arrays; needs a compatibility context
+    SHADER           // GLSL programs with uniform matrices; runs on core-profile contexts
+};
+
+}  // namespace octo_flex
+
+#endif  // RENDER_BACKEND_TYPE_H
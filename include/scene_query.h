@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SCENE_QUERY_H
+#define SCENE_QUERY_H
+
+#include <string>
+
+#include "def.h"
+
+namespace octo_flex {
+
+/**
+ * @brief Nearest object found under a ray by raycast().
+ */
+struct RaycastHit {
+    std::string object_id;
+    std::string layer_id;
+    double distance = 0.0;  // Along the ray from its origin, in world units
+    Vec3 point;             // Where the ray meets the object
+    int instance = -1;      // Instance index for instanced shapes, -1 otherwise
+};
+
+}  // namespace octo_flex
+
+#endif  // SCENE_QUERY_H
@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SHARED_SCENE_H
+#define SHARED_SCENE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "def.h"
+#include "octo_flex_export.h"
+
+namespace octo_flex {
+
+class Object;
+
+/**
+ * @brief Sizes of a shared scene channel, chosen by the viewer that opens it
+ *
+ * A channel is a named shared memory segment through which another process submits to the viewer's
+ * object manager: a ring of update slots and an arena that holds their objects in the scene snapshot
+ * format. The arena bounds how much data can be in flight; a sender waits while it is full.
+ */
+struct SharedSceneOptions {
+    size_t arena_bytes = 256u << 20;  // Shared object data, at least the largest single update
+    uint32_t slot_count = 1024;       // Updates in flight
+};
+
+/**
+ * @brief Counters of an open shared scene channel.
+ */
+struct SharedSceneStats {
+    uint64_t updates_applied = 0;
+    uint64_t updates_rejected = 0;  // Damaged updates, skipped
+    uint64_t bytes_received = 0;
+    bool open = false;
+};
+
+/**
+ * @brief Producer side of a shared scene channel, used from another process
+ *
+ * Updates are encoded straight into the shared arena; the viewer decodes them in place on a
+ * background thread and submits them as if they were submitted locally, so views pick them up at
+ * their next frame. Point and vertex data cross the process boundary in one copy, with no
+ * serialization step on either side. Objects are frozen when sent, as with local submissions.
+ *
+ * One sender per channel, used from one thread at a time. The methods return false with
+ * getLastError() set when the viewer closed the channel, or when it stays full for timeout_ms
+ * (negative waits as long as it takes).
+ *
+ * @example
+ * @code
+ * // Viewer process
+ * viewer.openSharedScene("lidar_feed");
+ *
+ * // Producer process
+ * auto sender = SharedSceneSender::attach("lidar_feed");
+ * sender->submitLayer(clouds, "lidar");
+ * @endcode
+ */
+class OCTO_FLEX_VIEW_API SharedSceneSender {
+   public:
+    /**
+     * @brief Attach to a channel a viewer opened
+     * @return Null, with error set, if no viewer has a channel by that name
+     */
+    static std::shared_ptr<SharedSceneSender> attach(const std::string& name, std::string* error = nullptr);
+
+    ~SharedSceneSender();
+    SharedSceneSender(const SharedSceneSender&) = delete;
+    SharedSceneSender& operator=(const SharedSceneSender&) = delete;
+
+    /** @brief Add or replace an object of a layer, as ObjectManager::submit() */
+    bool submit(const std::shared_ptr<Object>& object, const std::string& layer_id = "default", int timeout_ms = 1000);
+
+    /** @brief Replace all objects of a layer, as ObjectManager::submitLayer() */
+    bool submitLayer(const std::vector<std::shared_ptr<Object>>& objects, const std::string& layer_id = "default",
+                     int timeout_ms = 1000);
+
+    /** @brief Upsert and remove objects of a layer in one update, as ObjectManager::submitLayerDelta() */
+    bool submitLayerDelta(const std::vector<std::shared_ptr<Object>>& upserts,
+                          const std::vector<std::string>& removed_ids, const std::string& layer_id = "default",
+                          int timeout_ms = 1000);
+
+    /** @brief Move an object, as ObjectManager::updatePose() */
+    bool updatePose(const std::string& obj_id, const Vec3& position, const Quaternion& orientation,
+                    int timeout_ms = 1000);
+
+    std::string getLastError() const;
+
+   private:
+    SharedSceneSender();
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace octo_flex
+
+#endif  // SHARED_SCENE_H
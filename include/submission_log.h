@@ -0,0 +1,160 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SUBMISSION_LOG_H
+#define SUBMISSION_LOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "octo_flex_export.h"
+
+namespace octo_flex {
+
+class ObjectManager;
+
+/**
+ * @brief Options of a submission log, which records every scene update with its time
+ *
+ * Submitted objects, layer replacements and deltas, removals and pose updates are appended to the
+ * log by a background I/O thread in batched writes; the submitting threads only queue references to
+ * the frozen objects. Objects are stored in the scene snapshot format. A full keyframe of the scene
+ * starts the log and is repeated every keyframe_interval seconds, so replays can seek.
+ */
+struct SubmissionLogOptions {
+    std::string output_path = "octo_flex_submissions.ofvlog";
+    double keyframe_interval = 10.0;  // Seconds between keyframes; 0 writes the first one only
+    size_t flush_bytes = 1 << 20;     // Writes are batched until this many bytes are encoded...
+    int flush_interval_ms = 200;      // ...or this much time passed since the last write
+    int max_queue = 4096;  // Updates waiting for the I/O thread; more are dropped and a keyframe follows
+    bool overwrite = true;
+};
+
+/**
+ * @brief Counters of the current (or last) submission log.
+ */
+struct SubmissionLogStats {
+    uint64_t entries_written = 0;    // Updates and frame marks written
+    uint64_t keyframes_written = 0;  // Of those, full keyframes
+    uint64_t entries_dropped = 0;    // Updates dropped because the queue was full
+    uint64_t bytes_written = 0;
+    bool active = false;
+};
+
+/**
+ * @brief Replays a submission log into an object manager
+ *
+ * Playback is driven by the caller, which makes it work the same in a window and in headless
+ * export: advance() moves by a given amount of log time, update() by the wall time since the last
+ * call scaled by the speed given to play(), stepFrame() to the end of the next frame the recording
+ * viewer drew, and seek() jumps anywhere by loading the keyframe before the target and applying the
+ * updates after it. Keyframes are only read for seeking. Updates are applied as they were
+ * submitted, so the target's views show them from their next frame.
+ *
+ * @example Headless export at 4x:
+ * @code
+ * HeadlessRenderer renderer(1280, 720);
+ * auto replay = SubmissionReplay::open("session.ofvlog", renderer.objectManager());
+ * renderer.startRecording(options);
+ * while (!replay->atEnd()) {
+ *     replay->advance(4.0 / options.fps);
+ *     renderer.renderFrame();
+ * }
+ * @endcode
+ */
+class OCTO_FLEX_VIEW_API SubmissionReplay {
+   public:
+    /**
+     * @brief Open a log for replay into target
+     * @return Null and error set if the file cannot be read or has no keyframe
+     *
+     * @note Nothing is applied until the first advance(), update(), stepFrame() or seek().
+     */
+    static std::shared_ptr<SubmissionReplay> open(const std::string& path, std::shared_ptr<ObjectManager> target,
+                                                  std::string* error = nullptr);
+
+    ~SubmissionReplay();
+    SubmissionReplay(const SubmissionReplay&) = delete;
+    SubmissionReplay& operator=(const SubmissionReplay&) = delete;
+
+    /**
+     * @brief Log time of the last entry, in seconds from the start of the recording
+     */
+    double duration() const;
+
+    /**
+     * @brief Log time replayed so far, in seconds
+     */
+    double position() const;
+
+    /**
+     * @brief Frames the recording viewer drew with updates in them
+     */
+    size_t frameCount() const;
+
+    bool atEnd() const;
+
+    /**
+     * @brief Apply the updates of the next seconds of log time
+     * @return Entries applied
+     */
+    size_t advance(double seconds);
+
+    /**
+     * @brief Apply the updates up to the end of the next recorded frame
+     * @return Entries applied
+     */
+    size_t stepFrame();
+
+    /**
+     * @brief Move to a log time, backwards or forwards
+     * @return false if the keyframe or an update could not be decoded
+     */
+    bool seek(double seconds);
+
+    /**
+     * @brief Real-time playback at speed times the recorded pace, advanced by update()
+     */
+    void play(double speed = 1.0);
+    void pause();
+    bool isPlaying() const;
+    double speed() const;
+
+    /**
+     * @brief Advance by the wall time since the last update() or play(), times the speed; call it
+     *        once per frame, for example from a QTimer
+     * @return Entries applied
+     */
+    size_t update();
+
+    /**
+     * @brief Description of the last decoding failure
+     */
+    std::string getLastError() const;
+
+   private:
+    struct Impl;
+
+    SubmissionReplay();
+
+    std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace octo_flex
+
+#endif  // SUBMISSION_LOG_H
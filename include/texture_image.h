@@ -17,6 +17,7 @@
 #ifndef OCTO_FLEX_TEXTURE_IMAGE_H
 #define OCTO_FLEX_TEXTURE_IMAGE_H
 
+#include <cstddef>
 #include <vector>
 
 #include "octo_flex_export.h"
@@ -122,21 +123,82 @@ namespace octo_flex {
  * @endcode
  */
 struct OCTO_FLEX_VIEW_API TextureImage {
+    /**
+     * @brief Texel layout of the pixel data
+     *
+     * RGBA8 is 4 bytes per pixel. The others are GPU block-compressed formats, uploaded as they are
+     * (e.g. transcoded offline into KTX2); each is available where the OpenGL context supports it
+     * (S3TC for BC1/BC3, BPTC for BC7, OpenGL ES 3 or OpenGL 4.3 for ETC2, KHR ASTC LDR for ASTC).
+     */
+    enum class Format {
+        RGBA8,       ///< 4 bytes per pixel
+        BC1,         ///< 4x4 blocks of 8 bytes, 1-bit alpha (DXT1)
+        BC3,         ///< 4x4 blocks of 16 bytes (DXT5)
+        BC7,         ///< 4x4 blocks of 16 bytes (BPTC)
+        ETC2_RGB8,   ///< 4x4 blocks of 8 bytes, opaque
+        ETC2_RGBA8,  ///< 4x4 blocks of 16 bytes (ETC2 + EAC alpha)
+        ASTC_4x4,    ///< 4x4 blocks of 16 bytes (LDR)
+        ASTC_8x8,    ///< 8x8 blocks of 16 bytes (LDR)
+    };
+
     int width = 0;                          ///< Image width in pixels
     int height = 0;                         ///< Image height in pixels
-    std::vector<unsigned char> pixels;      ///< RGBA pixel data (4 bytes per pixel)
+    std::vector<unsigned char> pixels;      ///< Level 0: RGBA pixel data (4 bytes per pixel), or compressed blocks
+    Format format = Format::RGBA8;          ///< Layout of pixels and mip_levels
+
+    /// Optional precomputed mip levels 1..n, each half the size of the one before (rounded down, at least 1).
+    std::vector<std::vector<unsigned char>> mip_levels;
+
+    /// RGBA8 without mip_levels only: build the full mip chain on upload, against aliasing when zoomed out.
+    bool generate_mipmaps = false;
+
+    /** @brief true for the block-compressed formats */
+    bool isCompressed() const { return format != Format::RGBA8; }
+
+    /**
+     * @brief Bytes of one mip level of the given format and size
+     */
+    static size_t levelSize(Format format, int width, int height) {
+        if (width <= 0 || height <= 0) return 0;
+        if (format == Format::RGBA8) return static_cast<size_t>(width) * height * 4;
+        const int block = format == Format::ASTC_8x8 ? 8 : 4;
+        const size_t blockBytes = (format == Format::BC1 || format == Format::ETC2_RGB8) ? 8 : 16;
+        return static_cast<size_t>((width + block - 1) / block) * ((height + block - 1) / block) * blockBytes;
+    }
+
+    /** @brief Bytes of pixels and mip_levels together */
+    size_t dataSize() const {
+        size_t bytes = pixels.size();
+        for (const auto& level : mip_levels) bytes += level.size();
+        return bytes;
+    }
+
+    /** @brief Texture memory once uploaded, including generated mip levels */
+    size_t gpuSize() const {
+        const bool generated = generate_mipmaps && format == Format::RGBA8 && mip_levels.empty();
+        return generated ? pixels.size() + pixels.size() / 3 : dataSize();
+    }
 
     /**
      * @brief Check if image data is valid
-     * @return true if width > 0, height > 0, and pixel data size matches dimensions
+     * @return true if width > 0, height > 0, and every level's size matches its dimensions
      *
      * A valid image must have:
      * - width > 0
      * - height > 0
-     * - pixels.size() == width * height * 4 (RGBA format)
+     * - pixels.size() == levelSize(format, width, height) (width * height * 4 for RGBA)
+     * - mip level i of size levelSize(format, max(1, width >> i), max(1, height >> i))
      */
     bool isValid() const {
-        return width > 0 && height > 0 && pixels.size() == static_cast<size_t>(width * height * 4);
+        if (width <= 0 || height <= 0 || pixels.size() != levelSize(format, width, height)) return false;
+        for (size_t i = 0; i < mip_levels.size(); ++i) {
+            const int shift = static_cast<int>(i + 1);
+            if (shift > 30) return false;
+            const int w = (width >> shift) > 0 ? width >> shift : 1;
+            const int h = (height >> shift) > 0 ? height >> shift : 1;
+            if (mip_levels[i].size() != levelSize(format, w, h)) return false;
+        }
+        return true;
     }
 };
 
@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TEXTURE_UPLOAD_STATS_H
+#define TEXTURE_UPLOAD_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace octo_flex {
+
+/**
+ * @brief Counters of the background texture upload path and the shared texture cache.
+ */
+struct TextureUploadStats {
+    size_t pending = 0;               // Textures waiting for upload
+    size_t pending_bytes = 0;         // Pixel bytes waiting for upload
+    size_t frame_budget_bytes = 0;    // Pixel bytes uploaded at most per painted frame
+    uint64_t uploaded = 0;            // Textures uploaded since startup
+    uint64_t uploaded_bytes = 0;      // Pixel bytes uploaded since startup
+    uint64_t batches = 0;             // Upload batches, each completed by one fence
+    bool persistent_staging = false;  // Pixels staged in a persistently mapped buffer
+    double latency_p50_ms = 0.0;      // Time from first draw request to ready, recent uploads
+    double latency_p99_ms = 0.0;
+
+    // Shared texture cache
+    size_t cached_textures = 0;       // Distinct images, in use or kept for reuse
+    size_t resident_bytes = 0;        // Texture memory of the cached images
+    size_t cpu_copy_bytes = 0;        // Pixels still held in memory, awaiting their upload
+    size_t memory_budget_bytes = 0;   // Texture memory above which unused textures are evicted
+    uint64_t cache_hits = 0;          // Requests served by an existing entry
+    uint64_t cache_misses = 0;        // Requests that decoded or copied a new image
+    uint64_t evicted = 0;             // Unused textures deleted to stay within the budget
+};
+
+}  // namespace octo_flex
+
+#endif  // TEXTURE_UPLOAD_STATS_H
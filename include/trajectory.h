@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "def.h"
+#include "octo_flex_export.h"
+
+namespace octo_flex {
+
+/**
+ * @brief Point history a producer thread extends in place, e.g. a vehicle trail
+ *
+ * The producer and the shapes that show it hold the same handle: the producer appends points with
+ * append(), and the shapes, attached through ObjectBuilder::trajectory() or
+ * ObjectBuilder::trajectoryPoints(), draw the points held so far as one line strip or as points.
+ * The handle keeps at most capacity() points in a ring; appending to a full ring drops the oldest
+ * points, and trimFront() drops them explicitly. The views keep one vertex buffer of that capacity
+ * and only upload the points appended since they last painted, so neither the history nor the
+ * object is copied or resubmitted per tick.
+ *
+ * Points are given in the frame of the object the shape belongs to; shape transforms of the
+ * builder do not apply to them.
+ *
+ * @example Vehicle trail:
+ * @code
+ * auto trail = Trajectory::create(50000);
+ * viewer.add(ObjectBuilder::begin("trail_0")
+ *     .trajectory(trail, 2.0)
+ *     .build(), "trails");
+ *
+ * // Tracking thread, every tick
+ * trail->append({position}, Vec3(0, 1, 0));
+ * @endcode
+ */
+class OCTO_FLEX_VIEW_API Trajectory {
+   public:
+    /**
+     * @brief Create a trajectory holding up to capacity points
+     * @param capacity Points kept before the oldest are dropped
+     * @param transparency Alpha value of every point (0.0 = invisible, 1.0 = opaque, default: 1.0)
+     * @return Handle to share between the producer and the shapes; null if the capacity is invalid
+     */
+    static std::shared_ptr<Trajectory> create(size_t capacity, double transparency = 1.0);
+
+    ~Trajectory();
+    Trajectory(const Trajectory&) = delete;
+    Trajectory& operator=(const Trajectory&) = delete;
+
+    size_t capacity() const;
+    double transparency() const;
+
+    /**
+     * @brief Append points with one color each (thread-safe)
+     * @return false if the counts differ
+     */
+    bool append(const std::vector<Vec3>& points, const std::vector<Vec3>& colors);
+
+    /**
+     * @brief Append points of one color (thread-safe)
+     */
+    void append(const std::vector<Vec3>& points, const Vec3& color);
+
+    /**
+     * @brief Drop up to count of the oldest points (thread-safe)
+     */
+    void trimFront(size_t count);
+
+    /**
+     * @brief Drop all points (thread-safe)
+     */
+    void clear();
+
+    /**
+     * @brief Points held now
+     */
+    size_t size() const;
+
+    /**
+     * @brief Points appended since creation, dropped ones included
+     */
+    uint64_t appendedCount() const;
+
+    /**
+     * @brief Bounds of the points held now
+     */
+    BoundingBox bounds() const;
+
+    /**
+     * @brief Copy the points held now, oldest first
+     */
+    void copyPoints(std::vector<Vec3>& points, std::vector<Vec3>* colors = nullptr) const;
+
+   private:
+    friend class TrajectoryUploader;
+    struct Impl;
+
+    Trajectory(size_t capacity, double transparency);
+
+    std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace octo_flex
+
+#endif  // TRAJECTORY_H
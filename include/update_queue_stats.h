@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef UPDATE_QUEUE_STATS_H
+#define UPDATE_QUEUE_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace octo_flex {
+
+/**
+ * @brief Counters of the queued update path, for monitoring producers.
+ */
+struct UpdateQueueStats {
+    size_t depth = 0;      // Commands waiting for the next frame
+    size_t capacity = 0;   // Depth at which new commands are dropped
+    uint64_t pushed = 0;   // Commands accepted since startup
+    uint64_t dropped = 0;  // Commands rejected because the queue was full
+    uint64_t applied = 0;  // Commands applied by the render thread
+};
+
+}  // namespace octo_flex
+
+#endif  // UPDATE_QUEUE_STATS_H
@@ -21,6 +21,8 @@
  */
 
 #include "builtin_textures.h"
+#include <QByteArray>
+#include <QDebug>
 #include <cmath>
 #include <iostream>
 
@@ -123,15 +125,26 @@ TextureImage getGradientTexture(int width, int height) {
 }
 
 // ============================================================================
-// Logo Texture (embedded C++ data)
+// Logo Texture (embedded compressed data)
 // ============================================================================
 
-TextureImage getBuiltinLogo() {
-    TextureImage image;
-    image.width = LOGO_WIDTH;
-    image.height = LOGO_HEIGHT;
-    image.pixels.assign(LOGO_DATA, LOGO_DATA + (LOGO_WIDTH * LOGO_HEIGHT * 4));
-    return image;
+std::shared_ptr<const TextureImage> getSharedBuiltinLogo() {
+    // Expanded on the first call, once per process (thread-safe static initialization).
+    static const std::shared_ptr<const TextureImage> logo = [] {
+        auto image = std::make_shared<TextureImage>();
+        const QByteArray pixels = qUncompress(LOGO_DATA_COMPRESSED, static_cast<int>(sizeof(LOGO_DATA_COMPRESSED)));
+        if (pixels.size() != LOGO_WIDTH * LOGO_HEIGHT * 4) {
+            qWarning() << "getBuiltinLogo: Embedded logo data is corrupt";
+            return std::shared_ptr<const TextureImage>(image);
+        }
+        image->width = LOGO_WIDTH;
+        image->height = LOGO_HEIGHT;
+        image->pixels.assign(pixels.constBegin(), pixels.constEnd());
+        return std::shared_ptr<const TextureImage>(image);
+    }();
+    return logo;
 }
 
+TextureImage getBuiltinLogo() { return *getSharedBuiltinLogo(); }
+
 }  // namespace octo_flex
@@ -0,0 +1,624 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "bvh.h"
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/type_ptr.hpp>
+#include "instanced_shape.h"
+#include "layer.h"
+#include "point_cloud_shape.h"
+#include "trajectory_shape.h"
+
+namespace octo_flex {
+
+namespace {
+
+const uint32_t kLeafSize = 4;
+
+glm::vec3 toGlm(const Vec3& v) {
+    return glm::vec3(static_cast<float>(v.x), static_cast<float>(v.y), static_cast<float>(v.z));
+}
+
+BoundingBox toBox(const glm::vec3& lo, const glm::vec3& hi) {
+    BoundingBox box;
+    box.expand(Vec3(lo.x, lo.y, lo.z));
+    box.expand(Vec3(hi.x, hi.y, hi.z));
+    return box;
+}
+
+// Ray in the frame of the geometry under test. t stays the parameter of the world ray, so hits found
+// in different frames compare directly; scale converts the world tolerance into local units.
+struct Ray {
+    glm::vec3 o;
+    glm::vec3 d;
+    float radius;
+    float spread;
+    float scale;
+
+    float tolerance(float t) const { return (radius + spread * t) * scale; }
+};
+
+// Entry t of the ray into the box, grown by the tolerance at its far corner; false if the ray misses
+// it or enters beyond max_t.
+bool rayBox(const Ray& ray, const BoundingBox& box, float max_t, float& entry) {
+    if (!box.valid) return false;
+    glm::vec3 lo = toGlm(box.min);
+    glm::vec3 hi = toGlm(box.max);
+    if (ray.radius > 0.0f || ray.spread > 0.0f) {
+        const glm::vec3 corner = glm::max(glm::abs(lo - ray.o), glm::abs(hi - ray.o));
+        const float grow = ray.tolerance(glm::length(corner) / glm::length(ray.d));
+        lo -= glm::vec3(grow);
+        hi += glm::vec3(grow);
+    }
+    float t0 = 0.0f;
+    float t1 = max_t;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (ray.d[axis] == 0.0f) {
+            if (ray.o[axis] < lo[axis] || ray.o[axis] > hi[axis]) return false;
+            continue;
+        }
+        const float inv = 1.0f / ray.d[axis];
+        float enter = (lo[axis] - ray.o[axis]) * inv;
+        float leave = (hi[axis] - ray.o[axis]) * inv;
+        if (enter > leave) std::swap(enter, leave);
+        t0 = std::max(t0, enter);
+        t1 = std::min(t1, leave);
+        if (t0 > t1) return false;
+    }
+    entry = t0;
+    return true;
+}
+
+bool rayPoint(const Ray& ray, const glm::vec3& p, float& t) {
+    t = glm::dot(p - ray.o, ray.d) / glm::dot(ray.d, ray.d);
+    if (t < 0.0f) return false;
+    const glm::vec3 offset = p - (ray.o + ray.d * t);
+    const float tolerance = ray.tolerance(t);
+    return glm::dot(offset, offset) <= tolerance * tolerance;
+}
+
+bool raySegment(const Ray& ray, const glm::vec3& a, const glm::vec3& b, float& t) {
+    // Closest points of the ray and the segment a + s (b - a), clamped to both.
+    const glm::vec3 v = b - a;
+    const glm::vec3 w = ray.o - a;
+    const float uu = glm::dot(ray.d, ray.d);
+    const float uv = glm::dot(ray.d, v);
+    const float vv = glm::dot(v, v);
+    const float denom = uu * vv - uv * uv;
+    float s = denom > 1e-12f * uu * vv ? (uu * glm::dot(v, w) - uv * glm::dot(ray.d, w)) / denom : 0.0f;
+    s = std::min(std::max(s, 0.0f), 1.0f);
+    t = std::max(glm::dot(a + v * s - ray.o, ray.d) / uu, 0.0f);
+    if (vv > 0.0f) s = std::min(std::max(glm::dot(ray.o + ray.d * t - a, v) / vv, 0.0f), 1.0f);
+    const glm::vec3 offset = a + v * s - (ray.o + ray.d * t);
+    const float tolerance = ray.tolerance(t);
+    return glm::dot(offset, offset) <= tolerance * tolerance;
+}
+
+// Moller-Trumbore; triangles are hit exactly, whatever the tolerance.
+bool rayTriangle(const Ray& ray, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, float& t) {
+    const glm::vec3 e1 = b - a;
+    const glm::vec3 e2 = c - a;
+    const glm::vec3 p = glm::cross(ray.d, e2);
+    const float det = glm::dot(e1, p);
+    if (std::abs(det) < 1e-12f) return false;
+    const float inv = 1.0f / det;
+    const glm::vec3 s = ray.o - a;
+    const float u = glm::dot(s, p) * inv;
+    if (u < 0.0f || u > 1.0f) return false;
+    const glm::vec3 q = glm::cross(s, e1);
+    const float v = glm::dot(ray.d, q) * inv;
+    if (v < 0.0f || u + v > 1.0f) return false;
+    t = glm::dot(e2, q) * inv;
+    return t >= 0.0f;
+}
+
+bool rayPrimitive(const Ray& ray, const glm::vec3* points, int count, float& t) {
+    switch (count) {
+        case 1:
+            return rayPoint(ray, points[0], t);
+        case 2:
+            return raySegment(ray, points[0], points[1], t);
+        default:
+            return rayTriangle(ray, points[0], points[1], points[2], t);
+    }
+}
+
+// Vertex positions of a shape in either storage.
+class Vertices {
+   public:
+    explicit Vertices(const Shape& shape) : points_(shape.points()), packed_(shape.packedVertices()) {}
+
+    size_t size() const { return packed_.empty() ? points_.size() : packed_.size(); }
+    glm::vec3 operator[](size_t i) const {
+        if (packed_.empty()) return toGlm(points_[i]);
+        return glm::vec3(packed_[i].x, packed_[i].y, packed_[i].z);
+    }
+
+   private:
+    const std::vector<Vec3>& points_;
+    const std::vector<PackedVertex>& packed_;
+};
+
+// Call visit with every primitive of a shape as drawn: points, line segments or triangles as one to
+// three vertices. Stops early when visit returns true.
+template <typename Visit>
+bool visitPrimitives(const Shape& shape, const Visit& visit) {
+    const Vertices vertices(shape);
+    const size_t n = vertices.size();
+    glm::vec3 p[3];
+    switch (shape.type()) {
+        case Shape::Lines:
+        case Shape::Dash:
+            for (size_t i = 0; i + 1 < n; i += 2) {
+                p[0] = vertices[i];
+                p[1] = vertices[i + 1];
+                if (visit(p, 2)) return true;
+            }
+            return false;
+        case Shape::Loop:
+            if (n < 2) return false;
+            for (size_t i = 0; i < n; ++i) {
+                p[0] = vertices[i];
+                p[1] = vertices[(i + 1) % n];
+                if (visit(p, 2)) return true;
+            }
+            return false;
+        case Shape::Polygon:
+        case Shape::TexturedQuad: {
+            const auto& triangles = shape.triangles();
+            if (!triangles.empty()) {
+                for (size_t i = 0; i + 2 < triangles.size(); i += 3) {
+                    for (int k = 0; k < 3; ++k) p[k] = vertices[triangles[i + k]];
+                    if (visit(p, 3)) return true;
+                }
+                return false;
+            }
+            for (size_t i = 1; i + 1 < n; ++i) {
+                p[0] = vertices[0];
+                p[1] = vertices[i];
+                p[2] = vertices[i + 1];
+                if (visit(p, 3)) return true;
+            }
+            return false;
+        }
+        default:
+            for (size_t i = 0; i < n; ++i) {
+                p[0] = vertices[i];
+                if (visit(p, 1)) return true;
+            }
+            return false;
+    }
+}
+
+// Call visit with the points a trajectory holds right now, as drawn: consecutive pairs of a strip, or
+// single points.
+template <typename Visit>
+bool visitTrajectory(const TrajectoryShape& shape, const Visit& visit) {
+    if (!shape.trajectory()) return false;
+    std::vector<Vec3> held;
+    shape.trajectory()->copyPoints(held);
+    std::vector<glm::vec3> points(held.size());
+    for (size_t i = 0; i < held.size(); ++i) {
+        points[i] = toGlm(held[i]);
+        if (shape.isTransformed()) {
+            const glm::vec4 p = shape.transform() * glm::vec4(points[i], 1.0f);
+            points[i] = glm::vec3(p.x, p.y, p.z);
+        }
+    }
+    if (!shape.isStrip()) {
+        for (size_t i = 0; i < points.size(); ++i) {
+            if (visit(&points[i], 1)) return true;
+        }
+        return false;
+    }
+    for (size_t i = 0; i + 1 < points.size(); ++i) {
+        if (visit(&points[i], 2)) return true;
+    }
+    return false;
+}
+
+// Rotation columns of a quaternion, normalized first as the instancing shader does.
+void rotationColumns(const Quaternion& quat, glm::vec3 columns[3]) {
+    Quaternion q = quat;
+    q.normalize();
+    const float x = static_cast<float>(q.x), y = static_cast<float>(q.y);
+    const float z = static_cast<float>(q.z), w = static_cast<float>(q.w);
+    columns[0] = glm::vec3(1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + w * z), 2.0f * (x * z - w * y));
+    columns[1] = glm::vec3(2.0f * (x * y - w * z), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + w * x));
+    columns[2] = glm::vec3(2.0f * (x * z + w * y), 2.0f * (y * z - w * x), 1.0f - 2.0f * (x * x + y * y));
+}
+
+BoundingBox prototypeBounds(const InstancedShape& shape) {
+    BoundingBox bounds;
+    for (const auto& proto : shape.prototype()) {
+        if (proto) bounds.expand(proto->bounds());
+    }
+    return bounds;
+}
+
+bool raycastShape(const Shape& shape, const Ray& ray, float& best, int& instance);
+
+// Instances are tested in their own frame: the ray goes through the inverse of position, rotation
+// and scale. Non-uniform scales stretch the tolerance, which is then only approximate.
+bool raycastInstances(const InstancedShape& shape, const Ray& ray, float& best, int& instance) {
+    const BoundingBox bounds = prototypeBounds(shape);
+    if (!bounds.valid) return false;
+    const auto& positions = shape.positions();
+    const auto& orientations = shape.orientations();
+    const auto& scales = shape.scales();
+    bool found = false;
+    for (size_t i = 0; i < shape.instanceCount(); ++i) {
+        glm::vec3 r[3];
+        rotationColumns(i < orientations.size() ? orientations[i] : Quaternion(), r);
+        const glm::vec3 s = i < scales.size() ? toGlm(scales[i]) : glm::vec3(1.0f);
+        if (s.x == 0.0f || s.y == 0.0f || s.z == 0.0f) continue;
+        const glm::vec3 offset = ray.o - toGlm(positions[i]);
+        Ray local = ray;
+        local.o = glm::vec3(glm::dot(r[0], offset), glm::dot(r[1], offset), glm::dot(r[2], offset)) / s;
+        local.d = glm::vec3(glm::dot(r[0], ray.d), glm::dot(r[1], ray.d), glm::dot(r[2], ray.d)) / s;
+        local.scale = ray.scale * 3.0f / (std::abs(s.x) + std::abs(s.y) + std::abs(s.z));
+        float entry;
+        if (!rayBox(local, bounds, best, entry)) continue;
+        int ignored;
+        bool hit = false;
+        for (const auto& proto : shape.prototype()) {
+            if (proto && raycastShape(*proto, local, best, ignored)) hit = true;
+        }
+        if (hit) {
+            instance = shape.isReference() ? -1 : static_cast<int>(i);
+            found = true;
+        }
+    }
+    return found;
+}
+
+bool raycastCloud(const PointCloudShape& shape, const Ray& ray, float& best) {
+    const auto& nodes = shape.nodes();
+    const auto& vertices = shape.packedVertices();
+    bool found = false;
+    std::vector<int32_t> stack(1, 0);
+    while (!stack.empty()) {
+        const PointCloudShape::Node& node = nodes[stack.back()];
+        stack.pop_back();
+        float entry;
+        if (!rayBox(ray, node.bounds, best, entry)) continue;
+        for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+            float t;
+            if (rayPoint(ray, glm::vec3(vertices[i].x, vertices[i].y, vertices[i].z), t) && t < best) {
+                best = t;
+                found = true;
+            }
+        }
+        for (int32_t child : node.children) {
+            if (child >= 0) stack.push_back(child);
+        }
+    }
+    return found;
+}
+
+// Nearest hit of one shape closer than best; lowers best to it.
+bool raycastShape(const Shape& shape, const Ray& ray, float& best, int& instance) {
+    if (shape.type() == Shape::Instanced) {
+        return raycastInstances(static_cast<const InstancedShape&>(shape), ray, best, instance);
+    }
+    if (shape.type() == Shape::PointCloud) {
+        const auto& cloud = static_cast<const PointCloudShape&>(shape);
+        if (cloud.hasOctree()) return raycastCloud(cloud, ray, best);
+    }
+    bool found = false;
+    const auto test = [&](const glm::vec3* points, int count) {
+        float t;
+        if (rayPrimitive(ray, points, count, t) && t < best) {
+            best = t;
+            found = true;
+        }
+        return false;
+    };
+    if (shape.type() == Shape::Trajectory) {
+        visitTrajectory(static_cast<const TrajectoryShape&>(shape), test);
+    } else {
+        visitPrimitives(shape, test);
+    }
+    return found;
+}
+
+bool shapeInRegion(const Shape& shape, const Frustum& region);
+
+bool instancesInRegion(const InstancedShape& shape, const Frustum& region) {
+    const BoundingBox bounds = prototypeBounds(shape);
+    if (!bounds.valid) return false;
+    const auto& positions = shape.positions();
+    const auto& orientations = shape.orientations();
+    const auto& scales = shape.scales();
+    for (size_t i = 0; i < shape.instanceCount(); ++i) {
+        glm::vec3 r[3];
+        rotationColumns(i < orientations.size() ? orientations[i] : Quaternion(), r);
+        const glm::vec3 s = i < scales.size() ? toGlm(scales[i]) : glm::vec3(1.0f);
+        const glm::mat4 model(glm::vec4(r[0] * s.x, 0.0f), glm::vec4(r[1] * s.y, 0.0f), glm::vec4(r[2] * s.z, 0.0f),
+                              glm::vec4(toGlm(positions[i]), 1.0f));
+        const Frustum local = region.transformed(model);
+        if (!local.intersects(bounds)) continue;
+        for (const auto& proto : shape.prototype()) {
+            if (proto && shapeInRegion(*proto, local)) return true;
+        }
+    }
+    return false;
+}
+
+bool cloudInRegion(const PointCloudShape& shape, const Frustum& region) {
+    const auto& nodes = shape.nodes();
+    const auto& vertices = shape.packedVertices();
+    std::vector<int32_t> stack(1, 0);
+    while (!stack.empty()) {
+        const PointCloudShape::Node& node = nodes[stack.back()];
+        stack.pop_back();
+        if (node.subtreeCount == 0 || !region.intersects(node.bounds)) continue;
+        if (region.contains(node.bounds)) return true;
+        for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+            if (region.contains(vertices[i].x, vertices[i].y, vertices[i].z)) return true;
+        }
+        for (int32_t child : node.children) {
+            if (child >= 0) stack.push_back(child);
+        }
+    }
+    return false;
+}
+
+bool shapeInRegion(const Shape& shape, const Frustum& region) {
+    if (shape.type() == Shape::Instanced) {
+        return instancesInRegion(static_cast<const InstancedShape&>(shape), region);
+    }
+    if (shape.type() == Shape::PointCloud) {
+        const auto& cloud = static_cast<const PointCloudShape&>(shape);
+        if (cloud.hasOctree()) return cloudInRegion(cloud, region);
+    }
+    const auto test = [&](const glm::vec3* points, int count) { return region.intersects(points, count); };
+    if (shape.type() == Shape::Trajectory) {
+        return visitTrajectory(static_cast<const TrajectoryShape&>(shape), test);
+    }
+    return visitPrimitives(shape, test);
+}
+
+// Ray and region tests of one object, in the frame its shapes are built in.
+bool raycastObject(const Object& obj, const PickRay& ray, float& best, int& instance) {
+    Ray local{ray.origin, ray.direction, ray.radius, ray.spread, 1.0f};
+    float model[16];
+    if (obj.modelMatrix(model)) {
+        // Rigid: the inverse rotates by the transpose.
+        const glm::vec3 r[3] = {glm::vec3(model[0], model[1], model[2]), glm::vec3(model[4], model[5], model[6]),
+                                glm::vec3(model[8], model[9], model[10])};
+        const glm::vec3 offset = ray.origin - glm::vec3(model[12], model[13], model[14]);
+        local.o = glm::vec3(glm::dot(r[0], offset), glm::dot(r[1], offset), glm::dot(r[2], offset));
+        local.d = glm::vec3(glm::dot(r[0], ray.direction), glm::dot(r[1], ray.direction),
+                            glm::dot(r[2], ray.direction));
+    }
+    bool found = false;
+    for (const auto& shape : obj.shapes()) {
+        // Coarser levels of detail approximate the finest one, which is tested alone.
+        if (!shape || shape->lodLevel() > 0) continue;
+        int shape_instance = -1;
+        if (raycastShape(*shape, local, best, shape_instance)) {
+            instance = shape_instance;  // Of the nearest hit so far
+            found = true;
+        }
+    }
+    return found;
+}
+
+bool objectInRegion(const Object& obj, const Frustum& region) {
+    const BoundingBox bounds = obj.bounds();
+    if (!region.intersects(bounds)) return false;
+    if (region.contains(bounds)) return true;
+    float model[16];
+    const Frustum local = obj.modelMatrix(model) ? region.transformed(glm::make_mat4(model)) : region;
+    for (const auto& shape : obj.shapes()) {
+        if (shape && shape->lodLevel() <= 0 && shapeInRegion(*shape, local)) return true;
+    }
+    return false;
+}
+
+// Shared by the tree and the posed list.
+void raycastItem(const Object::Ptr& obj, const PickRay& ray, PickHit& hit, bool& found) {
+    int instance = -1;
+    float best = hit.distance;
+    if (raycastObject(*obj, ray, best, instance)) {
+        hit.object = obj;
+        hit.distance = best;
+        hit.point = ray.origin + ray.direction * best;
+        hit.instance = instance;
+        found = true;
+    }
+}
+
+}  // namespace
+
+LayerBvh::Ptr LayerBvh::build(const LayerSnapshot& snapshot) {
+    auto bvh = std::make_shared<LayerBvh>();
+    bvh->version_ = snapshot.version;
+    std::vector<glm::vec3> centers;
+    for (const auto& [handle, obj] : snapshot.objects) {
+        // Trajectories keep changing their bounds, so they are tested on their own like posed objects.
+        const BoundingBox bounds = obj->bounds();
+        if (obj->hasLiveBounds()) {
+            bvh->posed_.push_back({handle, obj});
+        } else if (!bounds.valid) {
+            bvh->empty_++;
+        } else if (obj->isPosed()) {
+            bvh->posed_.push_back({handle, obj});
+        } else {
+            bvh->items_.push_back({handle, obj});
+            centers.push_back(toGlm(bounds.center()));
+        }
+    }
+    if (!bvh->items_.empty()) {
+        bvh->nodes_.reserve(2 * bvh->items_.size() / kLeafSize + 1);
+        bvh->buildNode(0, static_cast<uint32_t>(bvh->items_.size()), centers);
+        bvh->refitNodes();
+    }
+    return bvh;
+}
+
+LayerBvh::Ptr LayerBvh::refit(const LayerBvh& previous, const LayerSnapshot& snapshot) {
+    if (snapshot.objects.size() != previous.items_.size() + previous.posed_.size() + previous.empty_) {
+        return nullptr;
+    }
+    auto bvh = std::make_shared<LayerBvh>(previous);
+    bvh->version_ = snapshot.version;
+
+    // Same handles in the same roles, so the rest of the snapshot holds exactly the empty objects.
+    for (auto& item : bvh->items_) {
+        auto it = snapshot.objects.find(item.handle);
+        if (it == snapshot.objects.end() || it->second->isPosed() || it->second->hasLiveBounds() ||
+            !it->second->bounds().valid) {
+            return nullptr;
+        }
+        item.object = it->second;
+    }
+    for (auto& item : bvh->posed_) {
+        auto it = snapshot.objects.find(item.handle);
+        if (it == snapshot.objects.end()) return nullptr;
+        const Object& obj = *it->second;
+        if (!obj.hasLiveBounds() && (!obj.isPosed() || !obj.bounds().valid)) return nullptr;
+        item.object = it->second;
+    }
+    size_t empty = 0;
+    for (const auto& [handle, obj] : snapshot.objects) {
+        if (!obj->hasLiveBounds() && !obj->bounds().valid) empty++;
+    }
+    if (empty != previous.empty_) return nullptr;
+    bvh->refitNodes();
+    return bvh;
+}
+
+uint32_t LayerBvh::buildNode(uint32_t first, uint32_t count, std::vector<glm::vec3>& centers) {
+    const uint32_t index = static_cast<uint32_t>(nodes_.size());
+    nodes_.push_back({BoundingBox(), first, count, 0});
+    if (count <= kLeafSize) return index;
+
+    // Median split of the centers along the longest axis of their bounds.
+    glm::vec3 lo = centers[first];
+    glm::vec3 hi = centers[first];
+    for (uint32_t i = first + 1; i < first + count; ++i) {
+        lo = glm::min(lo, centers[i]);
+        hi = glm::max(hi, centers[i]);
+    }
+    const glm::vec3 extent = hi - lo;
+    const int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+
+    std::vector<uint32_t> order(count);
+    for (uint32_t i = 0; i < count; ++i) order[i] = first + i;
+    const uint32_t half = count / 2;
+    std::nth_element(order.begin(), order.begin() + half, order.end(),
+                     [&](uint32_t a, uint32_t b) { return centers[a][axis] < centers[b][axis]; });
+    std::vector<Item> items(count);
+    std::vector<glm::vec3> sorted(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        items[i] = std::move(items_[order[i]]);
+        sorted[i] = centers[order[i]];
+    }
+    std::move(items.begin(), items.end(), items_.begin() + first);
+    std::copy(sorted.begin(), sorted.end(), centers.begin() + first);
+
+    buildNode(first, half, centers);
+    const uint32_t right = buildNode(first + half, count - half, centers);
+    nodes_[index].right = right;
+    return index;
+}
+
+void LayerBvh::refitNodes() {
+    // Children follow their parents, so a reverse pass sees every child before its parent.
+    for (size_t i = nodes_.size(); i-- > 0;) {
+        Node& node = nodes_[i];
+        node.bounds = BoundingBox();
+        if (node.right == 0) {
+            for (uint32_t k = node.first; k < node.first + node.count; ++k) {
+                node.bounds.expand(items_[k].object->bounds());
+            }
+        } else {
+            node.bounds.expand(nodes_[i + 1].bounds);
+            node.bounds.expand(nodes_[node.right].bounds);
+        }
+    }
+}
+
+bool LayerBvh::raycast(const PickRay& ray, PickHit& hit) const {
+    const Ray world{ray.origin, ray.direction, ray.radius, ray.spread, 1.0f};
+    bool found = false;
+    float entry;
+    for (const auto& item : posed_) {
+        if (rayBox(world, item.object->bounds(), hit.distance, entry)) raycastItem(item.object, ray, hit, found);
+    }
+    if (nodes_.empty()) return found;
+
+    // Nearer child first, so the best hit so far prunes the farther one.
+    std::vector<std::pair<uint32_t, float>> stack;
+    if (rayBox(world, nodes_[0].bounds, hit.distance, entry)) stack.push_back({0, entry});
+    while (!stack.empty()) {
+        const auto [index, node_entry] = stack.back();
+        stack.pop_back();
+        if (node_entry >= hit.distance) continue;
+        const Node& node = nodes_[index];
+        if (node.right == 0) {
+            for (uint32_t k = node.first; k < node.first + node.count; ++k) {
+                const Object::Ptr& obj = items_[k].object;
+                if (rayBox(world, obj->bounds(), hit.distance, entry)) raycastItem(obj, ray, hit, found);
+            }
+            continue;
+        }
+        float left_entry = 0.0f, right_entry = 0.0f;
+        const bool left = rayBox(world, nodes_[index + 1].bounds, hit.distance, left_entry);
+        const bool right = rayBox(world, nodes_[node.right].bounds, hit.distance, right_entry);
+        if (left && right && left_entry < right_entry) {
+            stack.push_back({node.right, right_entry});
+            stack.push_back({index + 1, left_entry});
+        } else {
+            if (left) stack.push_back({index + 1, left_entry});
+            if (right) stack.push_back({node.right, right_entry});
+        }
+    }
+    return found;
+}
+
+void LayerBvh::query(const Frustum& region, std::vector<Object::Ptr>& objects) const {
+    for (const auto& item : posed_) {
+        if (objectInRegion(*item.object, region)) objects.push_back(item.object);
+    }
+    if (nodes_.empty()) return;
+
+    std::vector<uint32_t> stack(1, 0);
+    while (!stack.empty()) {
+        const uint32_t index = stack.back();
+        stack.pop_back();
+        const Node& node = nodes_[index];
+        if (!region.intersects(node.bounds)) continue;
+        if (region.contains(node.bounds)) {
+            // Everything below is inside; no overlap test needed.
+            for (uint32_t k = node.first; k < node.first + node.count; ++k) objects.push_back(items_[k].object);
+            continue;
+        }
+        if (node.right == 0) {
+            for (uint32_t k = node.first; k < node.first + node.count; ++k) {
+                if (objectInRegion(*items_[k].object, region)) objects.push_back(items_[k].object);
+            }
+            continue;
+        }
+        stack.push_back(node.right);
+        stack.push_back(index + 1);
+    }
+}
+
+}  // namespace octo_flex
@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BVH_H
+#define BVH_H
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include "def.h"
+#include "frustum.h"
+#include "object.h"
+
+namespace octo_flex {
+
+struct LayerSnapshot;
+
+// Ray with a pick tolerance: points and lines within radius + spread * t of the ray count as hit at t,
+// so a cone through a few pixels of the view picks what those pixels show. Triangles are hit exactly.
+struct PickRay {
+    glm::vec3 origin;
+    glm::vec3 direction;  // Unit length
+    float radius = 0.0f;
+    float spread = 0.0f;
+};
+
+// Nearest hit found so far; searches only accept hits closer than distance.
+struct PickHit {
+    Object::Ptr object;
+    float distance = std::numeric_limits<float>::infinity();
+    glm::vec3 point;  // On the ray, in world space
+    int instance = -1;  // Instance index for instanced shapes, -1 otherwise
+};
+
+// Bounding volume hierarchy over the objects of one layer snapshot, immutable once built.
+// Objects whose pose is updated at draw time are kept in a flat list and tested with their current
+// bounds, so pose updates never invalidate the tree.
+class LayerBvh {
+   public:
+    typedef std::shared_ptr<const LayerBvh> Ptr;
+
+    static Ptr build(const LayerSnapshot& snapshot);
+
+    // The tree of previous with its boxes refit to the objects of snapshot, or null if the set of
+    // objects in the tree changed and it has to be built again.
+    static Ptr refit(const LayerBvh& previous, const LayerSnapshot& snapshot);
+
+    // Version of the layer snapshot the tree was built from.
+    uint64_t version() const { return version_; }
+
+    // Nearest object under the ray; true and hit updated if one is closer than hit.distance.
+    bool raycast(const PickRay& ray, PickHit& hit) const;
+
+    // Objects with any geometry inside the region, e.g. a box or a rubber band's pick frustum.
+    void query(const Frustum& region, std::vector<Object::Ptr>& objects) const;
+
+   private:
+    struct Node {
+        BoundingBox bounds;
+        uint32_t first;  // Range of items_ below this node
+        uint32_t count;
+        uint32_t right;  // Right child; the left one follows the node. 0 for leaves
+    };
+
+    struct Item {
+        ObjectHandle handle;
+        Object::Ptr object;
+    };
+
+    uint32_t buildNode(uint32_t first, uint32_t count, std::vector<glm::vec3>& centers);
+    void refitNodes();
+
+    uint64_t version_ = 0;
+    std::vector<Node> nodes_;   // Pre-order, so children always follow their parent
+    std::vector<Item> items_;   // Objects in the tree
+    std::vector<Item> posed_;   // Objects posed at draw time or showing trajectories
+    size_t empty_ = 0;          // Objects without geometry, never hit
+};
+
+}  // namespace octo_flex
+
+#endif  // BVH_H
@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "composite_capture.h"
+#include <QtDebug>
+
+namespace octo_flex {
+
+CompositeCapture::CompositeCapture() {}
+
+CompositeCapture::~CompositeCapture() { destroy(); }
+
+bool CompositeCapture::create(QOpenGLContext* shareContext, const QSize& size, std::string* error) {
+    destroy();
+
+    surface_ = new QOffscreenSurface();
+    surface_->setFormat(shareContext->format());
+    surface_->create();
+    context_ = new QOpenGLContext();
+    context_->setFormat(shareContext->format());
+    context_->setShareContext(shareContext);
+    if (!surface_->isValid() || !context_->create() || !context_->makeCurrent(surface_)) {
+        if (error) *error = "Failed to create composite capture context";
+        destroy();
+        return false;
+    }
+    initializeOpenGLFunctions();
+
+    if (!readback_.initialize(context_)) {
+        if (error) *error = "Composite capture needs OpenGL 3.2 or OpenGL ES 3.0";
+        context_->doneCurrent();
+        destroy();
+        return false;
+    }
+
+    glGenTextures(1, &texture_);
+    glBindTexture(GL_TEXTURE_2D, texture_);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size.width(), size.height(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &fbo_);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture_, 0);
+    const bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (!complete) {
+        if (error) *error = "Failed to create composite capture framebuffer";
+        context_->doneCurrent();
+        destroy();
+        return false;
+    }
+
+    size_ = size;
+    clearForNextFrame();
+    context_->doneCurrent();
+    return true;
+}
+
+void CompositeCapture::destroy() {
+    if (context_ && surface_ && surface_->isValid() && context_->makeCurrent(surface_)) {
+        readback_.release();
+        for (GLsync fence : viewFences_) glDeleteSync(fence);
+        if (ready_) glDeleteSync(ready_);
+        if (fbo_ != 0) glDeleteFramebuffers(1, &fbo_);
+        if (texture_ != 0) glDeleteTextures(1, &texture_);
+        context_->doneCurrent();
+    }
+    viewFences_.clear();
+    ready_ = nullptr;
+    fbo_ = 0;
+    texture_ = 0;
+    size_ = QSize();
+
+    delete context_;
+    context_ = nullptr;
+    if (surface_) {
+        surface_->destroy();
+        delete surface_;
+        surface_ = nullptr;
+    }
+}
+
+void CompositeCapture::addViewFence(GLsync fence) {
+    if (fence) viewFences_.push_back(fence);
+}
+
+void CompositeCapture::capture(const FramePool::Ptr& pool, std::vector<QImage>& completed) {
+    if (!isValid() || !context_->makeCurrent(surface_)) return;
+
+    // The GPU waits for the views' draws; the CPU does not.
+    for (GLsync fence : viewFences_) {
+        glWaitSync(fence, 0, GL_TIMEOUT_IGNORED);
+        glDeleteSync(fence);
+    }
+    viewFences_.clear();
+
+    readback_.capture(fbo_, size_.width(), size_.height(), 0, pool, completed);
+    clearForNextFrame();
+    context_->doneCurrent();
+}
+
+void CompositeCapture::finish(std::vector<QImage>& completed) {
+    if (!isValid() || !context_->makeCurrent(surface_)) return;
+    readback_.finish(completed);
+    context_->doneCurrent();
+}
+
+void CompositeCapture::clearForNextFrame() {
+    // Areas no view covers (splitter handles, hidden views) stay black.
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (ready_) glDeleteSync(ready_);
+    ready_ = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();  // Make the fence visible to the views' contexts
+}
+
+void CompositeTarget::release() {
+    if (fbo_ != 0) glDeleteFramebuffers(1, &fbo_);
+    fbo_ = 0;
+    texture_ = 0;
+}
+
+void CompositeTarget::draw(CompositeCapture& composite, GLuint source, const QSize& sourceSize, const QRect& rect) {
+    if (!composite.isValid() || rect.isEmpty()) return;
+    if (!initialized_) {
+        initializeOpenGLFunctions();
+        initialized_ = true;
+    }
+
+    // Framebuffers are per context: wrap the shared texture in one of this view's own.
+    if (texture_ != composite.texture()) {
+        if (fbo_ == 0) glGenFramebuffers(1, &fbo_);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, composite.texture(), 0);
+        texture_ = composite.texture();
+    }
+
+    if (composite.readyFence()) {
+        glWaitSync(composite.readyFence(), 0, GL_TIMEOUT_IGNORED);
+    }
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, source);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbo_);
+    glBlitFramebuffer(0, 0, sourceSize.width(), sourceSize.height(), rect.left(), rect.top(),
+                      rect.left() + rect.width(), rect.top() + rect.height(), GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    composite.addViewFence(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    glFlush();  // Make the fence visible to the composite's context
+    glBindFramebuffer(GL_FRAMEBUFFER, source);
+}
+
+}  // namespace octo_flex
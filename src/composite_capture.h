@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef COMPOSITE_CAPTURE_H
+#define COMPOSITE_CAPTURE_H
+
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <QRect>
+#include <QSize>
+#include <vector>
+#include "frame_capture.h"
+
+namespace octo_flex {
+
+// Offscreen texture of fixed size that every view of a layout draws its frame into, read back
+// asynchronously as one video frame. Lives in its own context, sharing objects with the views;
+// fences order the views' draws and the readback across those contexts.
+class CompositeCapture : protected QOpenGLExtraFunctions {
+   public:
+    CompositeCapture();
+    ~CompositeCapture();
+
+    // Create the context (sharing with shareContext), the texture and the readback buffers.
+    bool create(QOpenGLContext* shareContext, const QSize& size, std::string* error);
+    void destroy();
+
+    bool isValid() const { return texture_ != 0; }
+    QSize size() const { return size_; }
+    GLuint texture() const { return texture_; }
+    QOpenGLContext* context() const { return context_; }
+
+    // Signaled once the texture is cleared for the next frame; views wait for it before drawing.
+    GLsync readyFence() const { return ready_; }
+    // Signaled once a view's draw into the texture finished; taken over by the capture.
+    void addViewFence(GLsync fence);
+
+    // Start reading back the drawn frame, then clear the texture for the next one. Finished frames
+    // (see FrameCapture) are appended to completed.
+    void capture(const FramePool::Ptr& pool, std::vector<QImage>& completed);
+    // Wait for the frames still being read back.
+    void finish(std::vector<QImage>& completed);
+
+   private:
+    void clearForNextFrame();
+
+    QOffscreenSurface* surface_ = nullptr;
+    QOpenGLContext* context_ = nullptr;
+    GLuint texture_ = 0;
+    GLuint fbo_ = 0;
+    QSize size_;
+    GLsync ready_ = nullptr;
+    std::vector<GLsync> viewFences_;
+    FrameCapture readback_;
+};
+
+// A view's side of a composite: copies the view's painted frame into its rectangle of the
+// composite texture, scaled on the GPU. Used with the view's context current.
+class CompositeTarget : protected QOpenGLExtraFunctions {
+   public:
+    CompositeTarget() {}
+    ~CompositeTarget() {}
+
+    // Delete the framebuffer (also needed before drawing into a new composite); the view's context must be current.
+    void release();
+
+    // Blit framebuffer source (sourceSize device pixels) into rect, in OpenGL (bottom-up)
+    // coordinates of the composite texture. Leaves source bound.
+    void draw(CompositeCapture& composite, GLuint source, const QSize& sourceSize, const QRect& rect);
+
+   private:
+    bool initialized_ = false;
+    GLuint fbo_ = 0;
+    GLuint texture_ = 0;  // Composite texture fbo_ is attached to
+};
+
+}  // namespace octo_flex
+
+#endif /* COMPOSITE_CAPTURE_H */
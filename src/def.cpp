@@ -16,13 +16,12 @@
 
 
 #include "def.h"
+#include <algorithm>
 
 namespace octo_flex {
 
 Vec3::Vec3() : x(0.0), y(0.0), z(0.0) {}
 Vec3::Vec3(double x, double y, double z) : x(x), y(y), z(z) {}
-Vec3::~Vec3() {}
-
 Vec3 Vec3::operator+(const Vec3& other) const { return Vec3(x + other.x, y + other.y, z + other.z); }
 
 Vec3 Vec3::operator-(const Vec3& other) const { return Vec3(x - other.x, y - other.y, z - other.z); }
@@ -64,4 +63,25 @@ void Quaternion::normalize() {
     w *= invMagnitude;
 }
 
+BoundingBox::BoundingBox() : valid(false) {}
+
+void BoundingBox::expand(const Vec3& point) {
+    if (!valid) {
+        min = point;
+        max = point;
+        valid = true;
+        return;
+    }
+    min = Vec3(std::min(min.x, point.x), std::min(min.y, point.y), std::min(min.z, point.z));
+    max = Vec3(std::max(max.x, point.x), std::max(max.y, point.y), std::max(max.z, point.z));
+}
+
+void BoundingBox::expand(const BoundingBox& other) {
+    if (!other.valid) return;
+    expand(other.min);
+    expand(other.max);
+}
+
+Vec3 BoundingBox::center() const { return (min + max) * 0.5; }
+
 }  // namespace octo_flex
@@ -19,6 +19,7 @@
 #define DEF_H
 
 #include <cmath>
+#include <cstdint>
 #include <string>
 
 namespace octo_flex {
@@ -29,7 +30,6 @@ typedef Id ObjectId;
 struct Vec3 {
     Vec3();
     Vec3(double x, double y, double z);
-    virtual ~Vec3();
 
     double x, y, z;
 
@@ -54,5 +54,21 @@ struct Quaternion {
     double w;
 };
 
+// Compact vertex for large point sets: float32 position and RGBA8 color (16 bytes).
+struct PackedVertex {
+    float x, y, z;
+    uint8_t r, g, b, a;
+};
+
+struct BoundingBox {
+    BoundingBox();
+    void expand(const Vec3& point);
+    void expand(const BoundingBox& other);
+    Vec3 center() const;
+    Vec3 min;
+    Vec3 max;
+    bool valid;
+};
+
 }  // namespace octo_flex
 #endif /* DEF_H */
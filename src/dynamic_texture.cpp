@@ -0,0 +1,382 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dynamic_texture.h"
+#include "dynamic_texture_uploader.h"
+
+#include <QDebug>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <algorithm>
+#include <cstring>
+
+namespace octo_flex {
+namespace {
+
+const char* kDesktopHeader = "#version 150\n";
+const char* kEsHeader = "#version 300 es\nprecision highp float;\n";
+
+// One triangle covering the target; no vertex buffer needed.
+const char* kConvertVertexShader = R"(
+out vec2 v_uv;
+void main() {
+    vec2 position = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2));
+    v_uv = position;
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+// BT.601 limited range. NV12 carries U and V in one two-channel plane, I420 in two planes.
+const char* kConvertFragmentShader = R"(
+in vec2 v_uv;
+uniform sampler2D u_y;
+uniform sampler2D u_u;
+uniform sampler2D u_v;
+uniform float u_interleaved;
+out vec4 o_color;
+void main() {
+    float y = 1.164383 * (texture(u_y, v_uv).r - 0.062745);
+    vec2 uv = u_interleaved > 0.5 ? texture(u_u, v_uv).rg : vec2(texture(u_u, v_uv).r, texture(u_v, v_uv).r);
+    uv -= 0.5;
+    o_color = vec4(y + 1.596027 * uv.y, y - 0.391762 * uv.x - 0.812968 * uv.y, y + 2.017232 * uv.x, 1.0);
+}
+)";
+
+unsigned char clampByte(int value) { return static_cast<unsigned char>(std::min(255, std::max(0, value))); }
+
+// Copy rows bottom up: OpenGL textures start with the bottom row.
+void copyPlaneFlipped(unsigned char* dst, const unsigned char* src, int stride, size_t rowBytes, int rows) {
+    for (int row = 0; row < rows; ++row) {
+        std::memcpy(dst + (rows - 1 - row) * rowBytes, src + static_cast<size_t>(row) * stride, rowBytes);
+    }
+}
+
+}  // namespace
+
+struct DynamicTexture::Impl {
+    Impl(int width, int height, Format format) : width(width), height(height), format(format) {
+        chromaWidth = (width + 1) / 2;
+        chromaHeight = (height + 1) / 2;
+        const size_t luma = static_cast<size_t>(width) * height;
+        const size_t chroma = static_cast<size_t>(chromaWidth) * chromaHeight;
+        frameBytes = format == Format::RGBA8 ? luma * 4 : luma + chroma * 2;
+    }
+
+    const int width;
+    const int height;
+    const Format format;
+    int chromaWidth;
+    int chromaHeight;
+    size_t frameBytes;  // Planes back to back, bottom row first
+
+    // Producer side: frames are written into back, then swapped into front for the uploader.
+    std::mutex producerMutex;
+    std::vector<unsigned char> back;
+    std::mutex mutex;
+    std::vector<unsigned char> front;  // Guarded by mutex
+    bool fresh = false;                // Guarded by mutex
+    std::atomic<uint64_t> frames{0};
+
+    // Painting views only.
+    std::vector<unsigned char> taken;
+    GLuint texture = 0;                 // RGBA, drawn by the quads
+    GLuint planes[3] = {0, 0, 0};       // Y, then UV (NV12) or U and V (I420), GPU conversion only
+    GLuint buffers[2] = {0, 0};         // Pixel unpack buffers, used in turn
+    int nextBuffer = 0;
+    bool uploaded = false;
+
+    // Hand the filled back buffer to the uploader; the previous unuploaded frame is dropped.
+    void publish() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            front.swap(back);
+            fresh = true;
+        }
+        frames++;
+        DynamicTextureUploader::instance()->changed();
+    }
+};
+
+std::shared_ptr<DynamicTexture> DynamicTexture::create(int width, int height, Format format) {
+    if (width <= 0 || height <= 0 || width > 16384 || height > 16384) {
+        qWarning() << "DynamicTexture::create: Invalid size" << width << "x" << height;
+        return nullptr;
+    }
+    return std::shared_ptr<DynamicTexture>(new DynamicTexture(width, height, format));
+}
+
+DynamicTexture::DynamicTexture(int width, int height, Format format) : impl_(new Impl(width, height, format)) {
+    DynamicTextureUploader::instance()->add(impl_.get());
+}
+
+DynamicTexture::~DynamicTexture() { DynamicTextureUploader::instance()->remove(impl_.get()); }
+
+int DynamicTexture::width() const { return impl_->width; }
+
+int DynamicTexture::height() const { return impl_->height; }
+
+DynamicTexture::Format DynamicTexture::format() const { return impl_->format; }
+
+uint64_t DynamicTexture::frameCount() const { return impl_->frames; }
+
+bool DynamicTexture::update(const unsigned char* rgba, int stride) {
+    if (impl_->format != Format::RGBA8 || !rgba) return false;
+    std::lock_guard<std::mutex> lock(impl_->producerMutex);
+    const size_t rowBytes = static_cast<size_t>(impl_->width) * 4;
+    impl_->back.resize(impl_->frameBytes);
+    copyPlaneFlipped(impl_->back.data(), rgba, stride > 0 ? stride : static_cast<int>(rowBytes), rowBytes,
+                     impl_->height);
+    impl_->publish();
+    return true;
+}
+
+bool DynamicTexture::updateNV12(const unsigned char* y, int y_stride, const unsigned char* uv, int uv_stride) {
+    if (impl_->format != Format::NV12 || !y || !uv) return false;
+    std::lock_guard<std::mutex> lock(impl_->producerMutex);
+    const size_t luma = static_cast<size_t>(impl_->width) * impl_->height;
+    impl_->back.resize(impl_->frameBytes);
+    copyPlaneFlipped(impl_->back.data(), y, y_stride, impl_->width, impl_->height);
+    copyPlaneFlipped(impl_->back.data() + luma, uv, uv_stride, static_cast<size_t>(impl_->chromaWidth) * 2,
+                     impl_->chromaHeight);
+    impl_->publish();
+    return true;
+}
+
+bool DynamicTexture::updateI420(const unsigned char* y, int y_stride, const unsigned char* u, int u_stride,
+                                const unsigned char* v, int v_stride) {
+    if (impl_->format != Format::I420 || !y || !u || !v) return false;
+    std::lock_guard<std::mutex> lock(impl_->producerMutex);
+    const size_t luma = static_cast<size_t>(impl_->width) * impl_->height;
+    const size_t chroma = static_cast<size_t>(impl_->chromaWidth) * impl_->chromaHeight;
+    impl_->back.resize(impl_->frameBytes);
+    copyPlaneFlipped(impl_->back.data(), y, y_stride, impl_->width, impl_->height);
+    copyPlaneFlipped(impl_->back.data() + luma, u, u_stride, impl_->chromaWidth, impl_->chromaHeight);
+    copyPlaneFlipped(impl_->back.data() + luma + chroma, v, v_stride, impl_->chromaWidth, impl_->chromaHeight);
+    impl_->publish();
+    return true;
+}
+
+void DynamicTextureUploader::release(DynamicTexture::Impl* texture, uint32_t group) {
+    GlDeletionQueue* queue = GlDeletionQueue::instance();
+    queue->deleteTextures(group, {texture->texture, texture->planes[0], texture->planes[1], texture->planes[2]});
+    queue->deleteBuffers(group, {texture->buffers[0], texture->buffers[1]});
+}
+
+GLuint DynamicTextureUploader::textureId(const DynamicTexture& texture) const {
+    return texture.impl_->uploaded ? texture.impl_->texture : 0;
+}
+
+void DynamicTextureUploader::uploadPending() {
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    if (!context) return;
+    QOpenGLExtraFunctions* gl = context->extraFunctions();
+
+    uploadEach([this, context, gl](DynamicTexture::Impl* texture) {
+        if (!conversionChosen_) {
+            chooseConversion(context);
+        }
+        {
+            std::lock_guard<std::mutex> frameLock(texture->mutex);
+            if (!texture->fresh) return;
+            texture->taken.swap(texture->front);
+            texture->fresh = false;
+        }
+        upload(gl, texture);
+    });
+}
+
+void DynamicTextureUploader::chooseConversion(QOpenGLContext* context) {
+    conversionChosen_ = true;
+    const QSurfaceFormat format = context->format();
+    const bool es = context->isOpenGLES();
+    if (format.version() < (es ? qMakePair(3, 0) : qMakePair(3, 2))) return;
+
+    const QByteArray header = es ? kEsHeader : kDesktopHeader;
+    std::unique_ptr<QOpenGLShaderProgram> program(new QOpenGLShaderProgram());
+    if (!program->addShaderFromSourceCode(QOpenGLShader::Vertex, header + kConvertVertexShader) ||
+        !program->addShaderFromSourceCode(QOpenGLShader::Fragment, header + kConvertFragmentShader) ||
+        !program->link()) {
+        qWarning() << "DynamicTextureUploader: Converting YUV on the CPU, shader failed:" << program->log();
+        return;
+    }
+    yuvProgram_ = std::move(program);
+}
+
+void DynamicTextureUploader::createResources(QOpenGLExtraFunctions* gl, DynamicTexture::Impl* texture) {
+    const bool yuv = texture->format != DynamicTexture::Format::RGBA8;
+    const bool gpu = yuv && yuvProgram_;
+
+    auto createTexture = [gl](GLuint* name, GLint internalFormat, GLenum format, int width, int height) {
+        gl->glGenTextures(1, name);
+        gl->glBindTexture(GL_TEXTURE_2D, *name);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        gl->glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, nullptr);
+    };
+    createTexture(&texture->texture, GL_RGBA, GL_RGBA, texture->width, texture->height);
+    if (gpu) {
+        const bool interleaved = texture->format == DynamicTexture::Format::NV12;
+        createTexture(&texture->planes[0], GL_R8, GL_RED, texture->width, texture->height);
+        createTexture(&texture->planes[1], interleaved ? GL_RG8 : GL_R8, interleaved ? GL_RG : GL_RED,
+                      texture->chromaWidth, texture->chromaHeight);
+        if (!interleaved) {
+            createTexture(&texture->planes[2], GL_R8, GL_RED, texture->chromaWidth, texture->chromaHeight);
+        }
+    }
+    gl->glBindTexture(GL_TEXTURE_2D, 0);
+
+    // YUV converted on the CPU is staged as RGBA.
+    const size_t staged = yuv && !gpu ? static_cast<size_t>(texture->width) * texture->height * 4 : texture->frameBytes;
+    gl->glGenBuffers(2, texture->buffers);
+    for (GLuint buffer : texture->buffers) {
+        gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+        gl->glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(staged), nullptr, GL_STREAM_DRAW);
+    }
+    gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+void DynamicTextureUploader::upload(QOpenGLExtraFunctions* gl, DynamicTexture::Impl* texture) {
+    if (texture->texture == 0) {
+        createResources(gl, texture);
+    }
+    const bool yuv = texture->format != DynamicTexture::Format::RGBA8;
+    const bool gpu = yuv && texture->planes[0] != 0;
+    const size_t luma = static_cast<size_t>(texture->width) * texture->height;
+    const size_t chroma = static_cast<size_t>(texture->chromaWidth) * texture->chromaHeight;
+    const size_t staged = yuv && !gpu ? luma * 4 : texture->frameBytes;
+
+    // Fill the buffer not read by the previous transfer; invalidating lets the driver hand out fresh
+    // memory instead of waiting for it.
+    const GLuint buffer = texture->buffers[texture->nextBuffer];
+    texture->nextBuffer ^= 1;
+    gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+    auto* mapped = static_cast<unsigned char*>(gl->glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0,
+                                                                    static_cast<GLsizeiptr>(staged),
+                                                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+    if (!mapped) {
+        gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return;
+    }
+    const unsigned char* frame = texture->taken.data();
+    if (!yuv || gpu) {
+        std::memcpy(mapped, frame, texture->frameBytes);
+    } else {
+        // BT.601 limited range in integer arithmetic, matching the shader.
+        const bool interleaved = texture->format == DynamicTexture::Format::NV12;
+        const unsigned char* u = frame + luma;
+        const unsigned char* v = frame + luma + chroma;
+        for (int row = 0; row < texture->height; ++row) {
+            const size_t chromaRow = static_cast<size_t>(row / 2) * texture->chromaWidth;
+            for (int col = 0; col < texture->width; ++col) {
+                const size_t c = chromaRow + col / 2;
+                const int cy = 298 * (frame[static_cast<size_t>(row) * texture->width + col] - 16) + 128;
+                const int cu = (interleaved ? u[c * 2] : u[c]) - 128;
+                const int cv = (interleaved ? u[c * 2 + 1] : v[c]) - 128;
+                unsigned char* out = mapped + (static_cast<size_t>(row) * texture->width + col) * 4;
+                out[0] = clampByte((cy + 409 * cv) >> 8);
+                out[1] = clampByte((cy - 100 * cu - 208 * cv) >> 8);
+                out[2] = clampByte((cy + 516 * cu) >> 8);
+                out[3] = 255;
+            }
+        }
+    }
+    gl->glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    GLint oldAlignment;
+    gl->glGetIntegerv(GL_UNPACK_ALIGNMENT, &oldAlignment);
+    gl->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    if (gpu) {
+        const bool interleaved = texture->format == DynamicTexture::Format::NV12;
+        gl->glBindTexture(GL_TEXTURE_2D, texture->planes[0]);
+        gl->glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, texture->width, texture->height, GL_RED, GL_UNSIGNED_BYTE,
+                            nullptr);
+        gl->glBindTexture(GL_TEXTURE_2D, texture->planes[1]);
+        gl->glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, texture->chromaWidth, texture->chromaHeight,
+                            interleaved ? GL_RG : GL_RED, GL_UNSIGNED_BYTE, reinterpret_cast<const void*>(luma));
+        if (!interleaved) {
+            gl->glBindTexture(GL_TEXTURE_2D, texture->planes[2]);
+            gl->glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, texture->chromaWidth, texture->chromaHeight, GL_RED,
+                                GL_UNSIGNED_BYTE, reinterpret_cast<const void*>(luma + chroma));
+        }
+    } else {
+        gl->glBindTexture(GL_TEXTURE_2D, texture->texture);
+        gl->glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, texture->width, texture->height, GL_RGBA, GL_UNSIGNED_BYTE,
+                            nullptr);
+    }
+    gl->glBindTexture(GL_TEXTURE_2D, 0);
+    gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    gl->glPixelStorei(GL_UNPACK_ALIGNMENT, oldAlignment);
+
+    if (gpu) {
+        convertOnGpu(gl, texture);
+    }
+    texture->uploaded = true;
+}
+
+void DynamicTextureUploader::convertOnGpu(QOpenGLExtraFunctions* gl, DynamicTexture::Impl* texture) {
+    // Runs before the view draws anything, but inside its paintGL: put back what the view set up.
+    GLint oldFramebuffer, oldProgram, oldVertexArray, oldViewport[4];
+    gl->glGetIntegerv(GL_FRAMEBUFFER_BINDING, &oldFramebuffer);
+    gl->glGetIntegerv(GL_CURRENT_PROGRAM, &oldProgram);
+    gl->glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &oldVertexArray);
+    gl->glGetIntegerv(GL_VIEWPORT, oldViewport);
+    const GLenum capabilities[] = {GL_DEPTH_TEST, GL_BLEND, GL_SCISSOR_TEST, GL_CULL_FACE};
+    GLboolean enabled[4];
+    for (int i = 0; i < 4; ++i) {
+        enabled[i] = gl->glIsEnabled(capabilities[i]);
+        gl->glDisable(capabilities[i]);
+    }
+
+    // Framebuffers and vertex arrays are not shared between contexts; these live for one pass.
+    GLuint framebuffer = 0;
+    GLuint vertexArray = 0;
+    gl->glGenFramebuffers(1, &framebuffer);
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    gl->glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture->texture, 0);
+    gl->glGenVertexArrays(1, &vertexArray);
+    gl->glBindVertexArray(vertexArray);
+    gl->glViewport(0, 0, texture->width, texture->height);
+
+    const bool interleaved = texture->format == DynamicTexture::Format::NV12;
+    yuvProgram_->bind();
+    yuvProgram_->setUniformValue("u_y", 0);
+    yuvProgram_->setUniformValue("u_u", 1);
+    yuvProgram_->setUniformValue("u_v", 2);
+    yuvProgram_->setUniformValue("u_interleaved", interleaved ? 1.0f : 0.0f);
+    for (int i = 0; i < 3; ++i) {
+        gl->glActiveTexture(GL_TEXTURE0 + i);
+        gl->glBindTexture(GL_TEXTURE_2D, texture->planes[i]);
+    }
+    gl->glDrawArrays(GL_TRIANGLES, 0, 3);
+    for (int i = 2; i >= 0; --i) {
+        gl->glActiveTexture(GL_TEXTURE0 + i);
+        gl->glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    gl->glUseProgram(static_cast<GLuint>(oldProgram));
+    gl->glBindVertexArray(static_cast<GLuint>(oldVertexArray));
+    gl->glDeleteVertexArrays(1, &vertexArray);
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(oldFramebuffer));
+    gl->glDeleteFramebuffers(1, &framebuffer);
+    gl->glViewport(oldViewport[0], oldViewport[1], oldViewport[2], oldViewport[3]);
+    for (int i = 0; i < 4; ++i) {
+        if (enabled[i]) gl->glEnable(capabilities[i]);
+    }
+}
+
+}  // namespace octo_flex
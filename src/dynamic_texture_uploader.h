@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DYNAMIC_TEXTURE_UPLOADER_H
+#define DYNAMIC_TEXTURE_UPLOADER_H
+
+
+#include <QOpenGLShaderProgram>
+#include <memory>
+
+#include "dynamic_texture.h"
+#include "upload_registry.h"
+
+class QOpenGLContext;
+class QOpenGLExtraFunctions;
+
+namespace octo_flex {
+
+// GL side of the dynamic textures, uploaded by the views as they paint. Each texture keeps an
+// RGBA texture for the quads, two pixel unpack buffers used in turn (so filling one never waits
+// for the transfer out of the other) and, for YUV frames converted on the GPU, one texture per
+// plane that a full-screen pass renders into the RGBA texture.
+class DynamicTextureUploader : public UploadRegistry<DynamicTextureUploader, DynamicTexture::Impl> {
+   public:
+    // Upload the newest frame of every dynamic texture that got one since; called by the views at
+    // the start of paintGL, with their context current.
+    void uploadPending();
+
+    // Texture showing the last uploaded frame; 0 before the first.
+    GLuint textureId(const DynamicTexture& texture) const;
+
+   private:
+    friend class DynamicTexture;
+    friend class UploadRegistry<DynamicTextureUploader, DynamicTexture::Impl>;
+
+    DynamicTextureUploader() {}
+
+    void release(DynamicTexture::Impl* texture, uint32_t group);
+    void chooseConversion(QOpenGLContext* context);
+    void createResources(QOpenGLExtraFunctions* gl, DynamicTexture::Impl* texture);
+    void upload(QOpenGLExtraFunctions* gl, DynamicTexture::Impl* texture);
+    void convertOnGpu(QOpenGLExtraFunctions* gl, DynamicTexture::Impl* texture);
+
+    // Chosen with the first context: convert YUV on the GPU where the context runs GLSL 1.50 or
+    // GLSL ES 3.00, else on the CPU.
+    bool conversionChosen_ = false;
+    std::unique_ptr<QOpenGLShaderProgram> yuvProgram_;
+};
+
+}  // namespace octo_flex
+
+#endif  // DYNAMIC_TEXTURE_UPLOADER_H
@@ -0,0 +1,192 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "fixed_function_backend.h"
+#include <cstddef>
+#include <glm/gtc/type_ptr.hpp>
+#include "shape.h"
+
+namespace octo_flex {
+namespace {
+
+GLenum glPrimitive(RenderBackend::Primitive primitive) {
+    switch (primitive) {
+        case RenderBackend::Points:
+            return GL_POINTS;
+        case RenderBackend::Lines:
+            return GL_LINES;
+        case RenderBackend::LineLoop:
+            return GL_LINE_LOOP;
+        case RenderBackend::LineStrip:
+            return GL_LINE_STRIP;
+        case RenderBackend::TriangleFan:
+            return GL_TRIANGLE_FAN;
+        default:
+            return GL_TRIANGLES;
+    }
+}
+
+}  // namespace
+
+bool FixedFunctionBackend::initialize(QOpenGLContext* context) {
+    if (!context) return false;
+    initializeOpenGLFunctions();
+
+    // Resolve multi-draw entry point (not part of QOpenGLFunctions).
+    multi_draw_arrays_ = reinterpret_cast<MultiDrawArraysFn>(context->getProcAddress("glMultiDrawArrays"));
+    return true;
+}
+
+void FixedFunctionBackend::beginPass(const glm::mat4& projection, const glm::mat4& view, const glm::vec2&) {
+    glMatrixMode(GL_PROJECTION);
+    glLoadMatrixf(glm::value_ptr(projection));
+    glMatrixMode(GL_MODELVIEW);
+    glLoadMatrixf(glm::value_ptr(view));
+
+    glHint(GL_PERSPECTIVE_CORRECTION_HINT, GL_NICEST);
+    glDisable(GL_TEXTURE_2D);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+}
+
+void FixedFunctionBackend::endPass() {
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glDisable(GL_TEXTURE_2D);
+}
+
+void FixedFunctionBackend::pushModel(const glm::mat4& model) {
+    glPushMatrix();
+    glMultMatrixf(glm::value_ptr(model));
+}
+
+void FixedFunctionBackend::popModel() { glPopMatrix(); }
+
+void FixedFunctionBackend::beginDraw(const VertexSource& source, Primitive primitive, const DrawStyle& style) {
+    // Pointers are offsets into the buffer, or addresses in client memory without one.
+    const char* base = source.buffer != 0 ? nullptr : static_cast<const char*>(source.data);
+    glBindBuffer(GL_ARRAY_BUFFER, source.buffer);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    if (source.layout == PackedColor) {
+        glVertexPointer(3, GL_FLOAT, sizeof(PackedVertex), base + offsetof(PackedVertex, x));
+    } else {
+        glVertexPointer(3, GL_FLOAT, sizeof(Shape::GpuVertex), base + offsetof(Shape::GpuVertex, x));
+    }
+    const bool scalars = style.scalarBuffer != 0 && style.colormap != 0;
+    if (style.vertexColors && !scalars) {
+        glEnableClientState(GL_COLOR_ARRAY);
+        if (source.layout == PackedColor) {
+            glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(PackedVertex), base + offsetof(PackedVertex, r));
+        } else {
+            glColorPointer(4, GL_FLOAT, sizeof(Shape::GpuVertex), base + offsetof(Shape::GpuVertex, r));
+        }
+    } else {
+        glDisableClientState(GL_COLOR_ARRAY);
+        glColor4f(style.color.r, style.color.g, style.color.b, style.color.a);
+    }
+
+    if (scalars) {
+        // Scalars as 1D texture coordinates into the colormap row, mapped to texels by the texture
+        // matrix; GL_MODULATE multiplies in the color set above.
+        const glm::vec2 map = style.scalarTexCoordMap();
+        glMatrixMode(GL_TEXTURE);
+        glLoadIdentity();
+        glTranslatef(map.y, 0.0f, 0.0f);
+        glScalef(map.x, 1.0f, 1.0f);
+        glMatrixMode(GL_MODELVIEW);
+        glEnable(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, style.colormap);
+        glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+        glBindBuffer(GL_ARRAY_BUFFER, style.scalarBuffer);
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glTexCoordPointer(1, GL_FLOAT, sizeof(float), reinterpret_cast<const void*>(style.scalarOffset));
+    }
+
+    if (primitive == Points) {
+        glPointSize(style.size);
+    } else if (primitive == Lines || primitive == LineLoop || primitive == LineStrip) {
+        glLineWidth(style.size);
+        if (style.dashed) {
+            glEnable(GL_LINE_STIPPLE);
+            glLineStipple(1, 0x00FF);  // Dashed pattern.
+        }
+    }
+}
+
+void FixedFunctionBackend::endDraw(Primitive primitive, const DrawStyle& style) {
+    // Restore state.
+    if ((primitive == Lines || primitive == LineLoop || primitive == LineStrip) && style.dashed) {
+        glDisable(GL_LINE_STIPPLE);
+    }
+    if (style.scalarBuffer != 0 && style.colormap != 0) {
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        glMatrixMode(GL_TEXTURE);
+        glLoadIdentity();
+        glMatrixMode(GL_MODELVIEW);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glDisable(GL_TEXTURE_2D);
+    }
+    glLineWidth(1.0f);
+    glPointSize(1.0f);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void FixedFunctionBackend::draw(const VertexSource& source, Primitive primitive, const GLint* firsts,
+                                const GLsizei* counts, GLsizei rangeCount, const DrawStyle& style) {
+    if (rangeCount <= 0) return;
+
+    beginDraw(source, primitive, style);
+    const GLenum mode = glPrimitive(primitive);
+    if (rangeCount == 1) {
+        glDrawArrays(mode, firsts[0], counts[0]);
+    } else if (multi_draw_arrays_) {
+        multi_draw_arrays_(mode, firsts, counts, rangeCount);
+    } else {
+        for (GLsizei i = 0; i < rangeCount; ++i) {
+            glDrawArrays(mode, firsts[i], counts[i]);
+        }
+    }
+    endDraw(primitive, style);
+}
+
+void FixedFunctionBackend::drawIndexed(const VertexSource& source, Primitive primitive, GLuint indexBuffer,
+                                       const uint32_t* indices, GLsizei count, const DrawStyle& style) {
+    if (count <= 0) return;
+
+    beginDraw(source, primitive, style);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    glDrawElements(glPrimitive(primitive), count, GL_UNSIGNED_INT, indexBuffer != 0 ? nullptr : indices);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    endDraw(primitive, style);
+}
+
+void FixedFunctionBackend::drawTexturedQuad(const Vec3* corners, const float* uvs, GLuint texture, float alpha) {
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glColor4f(1.0f, 1.0f, 1.0f, alpha);
+
+    glBegin(GL_QUADS);
+    for (int i = 0; i < 4; ++i) {
+        glTexCoord2f(uvs[i * 2], uvs[i * 2 + 1]);
+        glVertex3f(corners[i].x, corners[i].y, corners[i].z);
+    }
+    glEnd();
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_TEXTURE_2D);
+}
+
+}  // namespace octo_flex
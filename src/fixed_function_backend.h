@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef FIXED_FUNCTION_BACKEND_H
+#define FIXED_FUNCTION_BACKEND_H
+
+#include <QOpenGLFunctions>
+#include "render_backend.h"
+
+namespace octo_flex {
+
+// Legacy pipeline: matrix stack, client vertex arrays, glLineWidth and line stipple.
+// Needs a compatibility-profile context.
+class FixedFunctionBackend : public RenderBackend, protected QOpenGLFunctions {
+   public:
+    FixedFunctionBackend() {}
+
+    RenderBackendType type() const override { return RenderBackendType::FIXED_FUNCTION; }
+
+    bool initialize(QOpenGLContext* context) override;
+    void release() override {}
+
+    void beginPass(const glm::mat4& projection, const glm::mat4& view, const glm::vec2& viewport) override;
+    void endPass() override;
+
+    void pushModel(const glm::mat4& model) override;
+    void popModel() override;
+
+    void draw(const VertexSource& source, Primitive primitive, const GLint* firsts, const GLsizei* counts,
+              GLsizei rangeCount, const DrawStyle& style) override;
+    using RenderBackend::draw;
+
+    void drawIndexed(const VertexSource& source, Primitive primitive, GLuint indexBuffer, const uint32_t* indices,
+                     GLsizei count, const DrawStyle& style) override;
+
+    void drawTexturedQuad(const Vec3* corners, const float* uvs, GLuint texture, float alpha) override;
+
+   private:
+    // Set the vertex pointers and style state of a draw, and restore the defaults after it.
+    void beginDraw(const VertexSource& source, Primitive primitive, const DrawStyle& style);
+    void endDraw(Primitive primitive, const DrawStyle& style);
+
+    // glMultiDrawArrays, resolved at initialize (may be null).
+    typedef void(QOPENGLF_APIENTRYP MultiDrawArraysFn)(GLenum, const GLint*, const GLsizei*, GLsizei);
+    MultiDrawArraysFn multi_draw_arrays_ = nullptr;
+};
+
+}  // namespace octo_flex
+
+#endif /* FIXED_FUNCTION_BACKEND_H */
@@ -0,0 +1,192 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "frame_capture.h"
+#include <QOpenGLContext>
+#include <QtDebug>
+#include <cstring>
+
+namespace octo_flex {
+
+FrameCapture::FrameCapture() {}
+
+FrameCapture::~FrameCapture() {}
+
+bool FrameCapture::initialize(QOpenGLContext* context) {
+    release();
+    initializeOpenGLFunctions();
+
+    // Blits and mapped buffer ranges are core in OpenGL 3.0 and ES 3.0, fences in OpenGL 3.2 and ES 3.0.
+    if (context->isOpenGLES()) {
+        supported_ = context->format().majorVersion() >= 3;
+    } else {
+        supported_ = context->format().version() >= qMakePair(3, 2) || context->hasExtension("GL_ARB_sync");
+    }
+    return supported_;
+}
+
+void FrameCapture::release() {
+    for (Slot& slot : slots_) {
+        if (slot.fence) glDeleteSync(slot.fence);
+        if (slot.buffer != 0) glDeleteBuffers(1, &slot.buffer);
+        slot = Slot();
+    }
+    resolveFbo_.reset();
+    flipFbo_.reset();
+    next_ = 0;
+    width_ = 0;
+    height_ = 0;
+    samples_ = 0;
+    outWidth_ = 0;
+    outHeight_ = 0;
+}
+
+void FrameCapture::resize(int width, int height, int samples, int outWidth, int outHeight) {
+    const GLsizeiptr size = static_cast<GLsizeiptr>(outWidth) * outHeight * 4;
+    for (Slot& slot : slots_) {
+        if (slot.buffer == 0) glGenBuffers(1, &slot.buffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    QOpenGLFramebufferObjectFormat format;
+    format.setInternalTextureFormat(GL_RGBA8);
+    flipFbo_.reset(new QOpenGLFramebufferObject(outWidth, outHeight, format));
+    if (samples > 1) {
+        resolveFbo_.reset(new QOpenGLFramebufferObject(width, height, format));
+    } else {
+        resolveFbo_.reset();
+    }
+    width_ = width;
+    height_ = height;
+    samples_ = samples;
+    outWidth_ = outWidth;
+    outHeight_ = outHeight;
+}
+
+void FrameCapture::capture(GLuint fbo, int width, int height, int samples, const FramePool::Ptr& pool,
+                           std::vector<QImage>& completed) {
+    if (!supported_ || width <= 0 || height <= 0) return;
+
+    const bool pooled = pool && pool->format() == QImage::Format_RGBA8888;
+    const int outWidth = pooled ? pool->width() : width;
+    const int outHeight = pooled ? pool->height() : height;
+
+    // Buffers are sized for one frame size; frames still in flight are finished first.
+    if (width != width_ || height != height_ || samples != samples_ || outWidth != outWidth_ ||
+        outHeight != outHeight_) {
+        finish(completed);
+        resize(width, height, samples, outWidth, outHeight);
+        if (!flipFbo_->isValid()) {
+            qWarning() << "FrameCapture: Failed to create capture framebuffer.";
+            release();
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+            return;
+        }
+    }
+
+    // A slot is reused after kSlotCount captures; by then its copy has long finished.
+    Slot& slot = slots_[next_];
+    if (slot.pending) {
+        collect(slot, true, completed);
+    }
+
+    // Mirrored blit: OpenGL rows run bottom-up, QImage rows top-down. Multisampled sources cannot be
+    // mirrored or scaled in the resolving blit, so they are resolved first.
+    GLuint source = fbo;
+    if (resolveFbo_) {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, resolveFbo_->handle());
+        glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        source = resolveFbo_->handle();
+    }
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, source);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, flipFbo_->handle());
+    if (width - outWidth >= 0 && width - outWidth <= 1 && height - outHeight >= 0 && height - outHeight <= 1) {
+        // Within a pixel of the output (even-sized video of an odd-sized view): crop the top-left part.
+        glBlitFramebuffer(0, height - outHeight, outWidth, height, 0, outHeight, outWidth, 0, GL_COLOR_BUFFER_BIT,
+                          GL_NEAREST);
+    } else {
+        glBlitFramebuffer(0, 0, width, height, 0, outHeight, outWidth, 0, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    }
+
+    // Start the copy into the pixel-pack buffer; glReadPixels returns without waiting for it.
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, flipFbo_->handle());
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, outWidth, outHeight, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.pending = true;
+    slot.width = outWidth;
+    slot.height = outHeight;
+    slot.pool = pooled ? pool : nullptr;
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFlush();  // Submit the copy so the fence can signal before the next capture
+
+    // Hand out finished frames in capture order, stopping at the first one still in flight.
+    next_ = (next_ + 1) % kSlotCount;
+    for (int i = 0; i < kSlotCount; ++i) {
+        Slot& older = slots_[(next_ + i) % kSlotCount];
+        if (!older.pending) continue;
+        if (!collect(older, false, completed)) break;
+    }
+}
+
+void FrameCapture::finish(std::vector<QImage>& completed) {
+    if (!supported_) return;
+    for (int i = 0; i < kSlotCount; ++i) {
+        Slot& slot = slots_[(next_ + i) % kSlotCount];
+        if (slot.pending) {
+            collect(slot, true, completed);
+        }
+    }
+}
+
+bool FrameCapture::collect(Slot& slot, bool wait, std::vector<QImage>& completed) {
+    if (slot.fence) {
+        const GLuint64 timeout = wait ? GL_TIMEOUT_IGNORED : 0;
+        const GLenum status = glClientWaitSync(slot.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, timeout);
+        if (status == GL_TIMEOUT_EXPIRED) return false;
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+    }
+    slot.pending = false;
+    FramePool::Ptr pool = std::move(slot.pool);
+
+    // Without a free pool buffer the encoder is behind; the frame is dropped (the pool counts it).
+    QImage image = pool ? pool->acquire() : QImage(slot.width, slot.height, QImage::Format_RGBA8888);
+    if (pool && image.isNull()) return true;
+
+    const GLsizeiptr size = static_cast<GLsizeiptr>(slot.width) * slot.height * 4;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    const void* pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+    if (pixels) {
+        // Already top-down with tightly packed rows, which is the RGBA8888 QImage layout.
+        std::memcpy(image.bits(), pixels, static_cast<size_t>(size));
+        completed.push_back(std::move(image));
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    } else {
+        qWarning() << "FrameCapture: Failed to map pixel-pack buffer.";
+        completed.push_back(QImage());
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    return true;
+}
+
+}  // namespace octo_flex
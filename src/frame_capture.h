@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+#include <QImage>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLFramebufferObject>
+#include <memory>
+#include <vector>
+#include "frame_pool.h"
+
+namespace octo_flex {
+
+// Asynchronous framebuffer readback through a ring of pixel-pack buffers. Each capture flips the
+// frame on the GPU (a mirrored blit), starts the copy into the next buffer and returns the frames
+// whose copies have finished, oldest first; a frame is normally returned one or two captures later.
+// With a frame pool, frames are fitted to the pool size on the GPU and copied straight into pool
+// buffers; a frame finding the pool empty is dropped.
+class FrameCapture : protected QOpenGLExtraFunctions {
+   public:
+    FrameCapture();
+    ~FrameCapture();
+
+    // Check that the current context has framebuffer blits, pixel-pack buffers and fences.
+    bool initialize(QOpenGLContext* context);
+    // Delete all GL objects and drop pending frames; the context must be current.
+    void release();
+    bool isSupported() const { return supported_; }
+
+    // Start reading back framebuffer fbo (width x height device pixels) and append finished frames to completed.
+    // Frames are RGBA8888, of the source size or, with an RGBA8888 pool, of the pool size. Leaves fbo bound.
+    void capture(GLuint fbo, int width, int height, int samples, const FramePool::Ptr& pool,
+                 std::vector<QImage>& completed);
+    // Wait for all pending readbacks and append them to completed.
+    void finish(std::vector<QImage>& completed);
+
+   private:
+    struct Slot {
+        GLuint buffer = 0;
+        GLsync fence = nullptr;
+        bool pending = false;
+        int width = 0;
+        int height = 0;
+        FramePool::Ptr pool;  // Destination of the frame, if any
+    };
+
+    static const int kSlotCount = 3;
+
+    // Copy a pending slot out once its fence signaled (or always, when wait is set).
+    bool collect(Slot& slot, bool wait, std::vector<QImage>& completed);
+    // (Re)create the buffers and framebuffers for new source and output sizes.
+    void resize(int width, int height, int samples, int outWidth, int outHeight);
+
+    bool supported_ = false;
+    Slot slots_[kSlotCount];
+    int next_ = 0;  // Slot the next capture writes; the slots after it hold older captures
+    int width_ = 0;
+    int height_ = 0;
+    int samples_ = 0;
+    int outWidth_ = 0;
+    int outHeight_ = 0;
+    std::unique_ptr<QOpenGLFramebufferObject> resolveFbo_;  // Multisampled sources are resolved first
+    std::unique_ptr<QOpenGLFramebufferObject> flipFbo_;
+};
+
+}  // namespace octo_flex
+
+#endif /* FRAME_CAPTURE_H */
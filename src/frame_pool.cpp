@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "frame_pool.h"
+
+#include <chrono>
+
+namespace octo_flex {
+
+FramePool::Ptr FramePool::create(int width, int height, QImage::Format format, int capacity) {
+    return Ptr(new FramePool(width, height, format, capacity));
+}
+
+FramePool::FramePool(int width, int height, QImage::Format format, int capacity)
+    : width_(width), height_(height), format_(format) {
+    // Rows are 4-byte aligned, as QImage requires.
+    const int bytesPerPixel = QImage(1, 1, format).depth() / 8;
+    bytesPerLine_ = (width * bytesPerPixel + 3) & ~3;
+
+    const size_t size = static_cast<size_t>(bytesPerLine_) * height;
+    buffers_.reserve(capacity);
+    free_.reserve(capacity);
+    for (int i = 0; i < capacity; ++i) {
+        auto buffer = std::make_unique<Buffer>();
+        buffer->data.reset(new uchar[size]);
+        buffer->pool = this;
+        free_.push_back(buffer.get());
+        buffers_.push_back(std::move(buffer));
+    }
+}
+
+FramePool::~FramePool() {}
+
+QImage FramePool::acquire() {
+    Buffer* buffer = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        const int timeoutMs = acquireTimeoutMs_;
+        if (free_.empty() && timeoutMs > 0) {
+            freed_.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] { return !free_.empty(); });
+        }
+        if (!free_.empty()) {
+            buffer = free_.back();
+            free_.pop_back();
+        }
+    }
+    if (!buffer) {
+        dropped_++;
+        return QImage();
+    }
+    buffer->owner = shared_from_this();
+    return QImage(buffer->data.get(), width_, height_, bytesPerLine_, format_, &FramePool::releaseBuffer, buffer);
+}
+
+void FramePool::releaseBuffer(void* info) {
+    Buffer* buffer = static_cast<Buffer*>(info);
+    // The pool may be destroyed with the last buffer coming back; release it after the lock.
+    Ptr owner = std::move(buffer->owner);
+    FramePool* pool = buffer->pool;
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex_);
+        pool->free_.push_back(buffer);
+    }
+    pool->freed_.notify_one();
+}
+
+}  // namespace octo_flex
@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef FRAME_POOL_H
+#define FRAME_POOL_H
+
+#include <QImage>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace octo_flex {
+
+// Fixed set of preallocated frame buffers of one size and pixel format. acquire() wraps a free
+// buffer in a QImage that owns it: the image is filled once by the capture, moved to the encoder
+// thread and the buffer returns to the pool when the last copy of the image is destroyed.
+class FramePool : public std::enable_shared_from_this<FramePool> {
+   public:
+    using Ptr = std::shared_ptr<FramePool>;
+
+    static Ptr create(int width, int height, QImage::Format format, int capacity);
+    ~FramePool();
+
+    // A frame backed by a free buffer, or a null image (counted as a drop) when all are in use.
+    QImage acquire();
+
+    // Let acquire() wait up to ms for a buffer to come back instead of dropping the frame, so that
+    // offline export runs at the encoder's pace. 0 (the default) never waits.
+    void setAcquireTimeout(int ms) { acquireTimeoutMs_ = ms; }
+
+    // Record a frame dropped after it was acquired (for example because the encoder queue was full).
+    void countDrop() { dropped_++; }
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    QImage::Format format() const { return format_; }
+    int capacity() const { return static_cast<int>(buffers_.size()); }
+    uint64_t dropped() const { return dropped_; }
+
+   private:
+    struct Buffer {
+        std::unique_ptr<uchar[]> data;
+        FramePool* pool = nullptr;
+        Ptr owner;  // Keeps the pool alive while the buffer is out
+    };
+
+    FramePool(int width, int height, QImage::Format format, int capacity);
+
+    static void releaseBuffer(void* info);
+
+    int width_;
+    int height_;
+    QImage::Format format_;
+    int bytesPerLine_;
+    std::vector<std::unique_ptr<Buffer>> buffers_;
+    std::vector<Buffer*> free_;
+    std::mutex mutex_;
+    std::condition_variable freed_;  // Signaled when a buffer returns to free_
+    std::atomic<int> acquireTimeoutMs_{0};
+    std::atomic<uint64_t> dropped_{0};
+};
+
+}  // namespace octo_flex
+
+#endif /* FRAME_POOL_H */
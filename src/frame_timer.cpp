@@ -0,0 +1,176 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "frame_timer.h"
+#include <QOpenGLContext>
+#include <algorithm>
+
+#ifndef GL_TIME_ELAPSED
+#define GL_TIME_ELAPSED 0x88BF
+#endif
+
+namespace octo_flex {
+
+#ifdef OCTO_FLEX_TRACING
+static const char* const kPassTraceNames[FrameTimer::PassCount] = {
+    "paintGL update", "paintGL opaque", "paintGL transparent", "paintGL object text", "paintGL info panel",
+    "paintGL cleanup"};
+#endif
+
+void FrameTimer::Samples::add(float value) {
+    if (values.size() < kWindow) {
+        values.push_back(value);
+        return;
+    }
+    values[next] = value;
+    next = (next + 1) % kWindow;
+}
+
+void FrameTimer::Samples::percentiles(double& p50, double& p99) const {
+    p50 = 0.0;
+    p99 = 0.0;
+    if (values.empty()) return;
+    std::vector<float> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    p50 = sorted[(sorted.size() - 1) / 2];
+    p99 = sorted[(sorted.size() - 1) * 99 / 100];
+}
+
+FrameTimer::FrameTimer() {}
+
+FrameTimer::~FrameTimer() {}
+
+void FrameTimer::initialize(QOpenGLContext* context) {
+    release();
+    initializeOpenGLFunctions();
+
+    // Timer queries: core in desktop 3.3, an extension before that and on OpenGL ES.
+    if (context->isOpenGLES()) {
+        gpuTiming_ = context->format().majorVersion() >= 3 && context->hasExtension("GL_EXT_disjoint_timer_query");
+    } else {
+        gpuTiming_ = context->format().version() >= qMakePair(3, 3) ||
+                     context->hasExtension("GL_ARB_timer_query") || context->hasExtension("GL_EXT_timer_query");
+    }
+    if (gpuTiming_) {
+        glGenQueries(2 * PassCount, &queries_[0][0]);
+    }
+}
+
+void FrameTimer::release() {
+    if (gpuTiming_) {
+        glDeleteQueries(2 * PassCount, &queries_[0][0]);
+    }
+    gpuTiming_ = false;
+    std::fill(&queries_[0][0], &queries_[0][0] + 2 * PassCount, 0u);
+    std::fill(&issued_[0][0], &issued_[0][0] + 2 * PassCount, false);
+    inFrame_ = false;
+}
+
+void FrameTimer::beginFrame() {
+    frameSlot_ ^= 1;
+    inFrame_ = true;
+    frameClock_.start();
+#ifdef OCTO_FLEX_TRACING
+    frameTraceStart_ = traceNow();
+#endif
+
+    if (!gpuTiming_) return;
+
+    // Collect the frame that last used this slot; a frame still in flight is skipped, not waited for.
+    bool complete = true;
+    for (int pass = 0; pass < PassCount; ++pass) {
+        if (!issued_[frameSlot_][pass]) continue;
+        GLuint available = 0;
+        glGetQueryObjectuiv(queries_[frameSlot_][pass], GL_QUERY_RESULT_AVAILABLE, &available);
+        complete = complete && available != 0;
+    }
+    if (complete) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        bool any = false;
+        float total = 0.0f;
+        for (int pass = 0; pass < PassCount; ++pass) {
+            if (!issued_[frameSlot_][pass]) continue;
+            GLuint nanoseconds = 0;
+            glGetQueryObjectuiv(queries_[frameSlot_][pass], GL_QUERY_RESULT, &nanoseconds);
+            const float ms = static_cast<float>(nanoseconds) * 1e-6f;
+            gpu_[pass].add(ms);
+            total += ms;
+            any = true;
+        }
+        if (any) gpuFrame_.add(total);
+    }
+    std::fill(issued_[frameSlot_], issued_[frameSlot_] + PassCount, false);
+}
+
+void FrameTimer::endFrame() {
+    if (!inFrame_) return;
+    inFrame_ = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cpuFrame_.add(static_cast<float>(frameClock_.nsecsElapsed()) * 1e-6f);
+    }
+#ifdef OCTO_FLEX_TRACING
+    if (traceRecording.load(std::memory_order_relaxed)) traceRecord("paintGL", frameTraceStart_, traceNow());
+#endif
+}
+
+void FrameTimer::beginPass(Pass pass) {
+    if (!inFrame_) return;
+    passClock_.start();
+#ifdef OCTO_FLEX_TRACING
+    passTraceStart_ = traceNow();
+#endif
+    if (gpuTiming_) {
+        glBeginQuery(GL_TIME_ELAPSED, queries_[frameSlot_][pass]);
+        issued_[frameSlot_][pass] = true;
+    }
+}
+
+void FrameTimer::endPass(Pass pass) {
+    if (!inFrame_) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cpu_[pass].add(static_cast<float>(passClock_.nsecsElapsed()) * 1e-6f);
+    }
+#ifdef OCTO_FLEX_TRACING
+    if (traceRecording.load(std::memory_order_relaxed)) {
+        traceRecord(kPassTraceNames[pass], passTraceStart_, traceNow());
+    }
+#endif
+    if (gpuTiming_) {
+        glEndQuery(GL_TIME_ELAPSED);
+    }
+}
+
+FrameTimingStats FrameTimer::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FrameTimingStats stats;
+    stats.samples = cpuFrame_.values.size();
+    stats.gpu_timing = gpuTiming_;
+
+    PassTiming* passes[PassCount] = {&stats.update,      &stats.opaque,     &stats.transparent,
+                                     &stats.object_text, &stats.info_panel, &stats.cleanup};
+    for (int pass = 0; pass < PassCount; ++pass) {
+        cpu_[pass].percentiles(passes[pass]->cpu_p50_ms, passes[pass]->cpu_p99_ms);
+        gpu_[pass].percentiles(passes[pass]->gpu_p50_ms, passes[pass]->gpu_p99_ms);
+    }
+    cpuFrame_.percentiles(stats.frame.cpu_p50_ms, stats.frame.cpu_p99_ms);
+    gpuFrame_.percentiles(stats.frame.gpu_p50_ms, stats.frame.gpu_p99_ms);
+    return stats;
+}
+
+}  // namespace octo_flex
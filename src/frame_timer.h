@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef FRAME_TIMER_H
+#define FRAME_TIMER_H
+
+#include <QElapsedTimer>
+#include <QOpenGLExtraFunctions>
+#include <mutex>
+#include <vector>
+#include "frame_timing_stats.h"
+#include "trace.h"
+
+namespace octo_flex {
+
+// Times the sections of a view's frame on the CPU and, where timer queries exist, on the GPU.
+// Passes run one after another (GPU time queries cannot nest). Each frame writes one of two query
+// sets and first reads back the set written two frames ago, so reading results never stalls.
+// The frame and its passes are also recorded as trace zones while tracing is enabled.
+class FrameTimer : protected QOpenGLExtraFunctions {
+   public:
+    enum Pass { Update, Opaque, Transparent, ObjectText, InfoPanel, Cleanup, PassCount };
+
+    FrameTimer();
+    ~FrameTimer();
+
+    // Create the timer queries if the current context supports them.
+    void initialize(QOpenGLContext* context);
+    // Delete the queries; the context must be current.
+    void release();
+
+    void beginFrame();
+    void endFrame();
+    void beginPass(Pass pass);
+    void endPass(Pass pass);
+
+    // Thread-safe: read while a frame on a render thread adds to the samples.
+    FrameTimingStats stats() const;
+
+   private:
+    // Rolling window of one measurement.
+    struct Samples {
+        std::vector<float> values;
+        size_t next = 0;
+
+        void add(float value);
+        void percentiles(double& p50, double& p99) const;
+    };
+
+    static const size_t kWindow = 240;
+
+    bool gpuTiming_ = false;
+    GLuint queries_[2][PassCount] = {};
+    bool issued_[2][PassCount] = {};
+    int frameSlot_ = 0;
+    bool inFrame_ = false;
+
+    QElapsedTimer frameClock_;
+    QElapsedTimer passClock_;
+    mutable std::mutex mutex_;  // Guards the samples
+    Samples cpu_[PassCount];
+    Samples gpu_[PassCount];
+    Samples cpuFrame_;
+    Samples gpuFrame_;
+
+#ifdef OCTO_FLEX_TRACING
+    int64_t frameTraceStart_ = 0;
+    int64_t passTraceStart_ = 0;
+#endif
+};
+
+}  // namespace octo_flex
+
+#endif /* FRAME_TIMER_H */
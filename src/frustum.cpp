@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "frustum.h"
+#include <algorithm>
+
+namespace octo_flex {
+
+Frustum::Frustum(const glm::mat4& viewProjection) {
+    // Gribb/Hartmann plane extraction; glm matrices are column-major.
+    const glm::mat4& m = viewProjection;
+    glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    planes_[0] = row3 + row0;  // Left
+    planes_[1] = row3 - row0;  // Right
+    planes_[2] = row3 + row1;  // Bottom
+    planes_[3] = row3 - row1;  // Top
+    planes_[4] = row3 + row2;  // Near
+    planes_[5] = row3 - row2;  // Far
+}
+
+Frustum::Frustum(const BoundingBox& box) {
+    planes_[0] = glm::vec4(1.0f, 0.0f, 0.0f, static_cast<float>(-box.min.x));
+    planes_[1] = glm::vec4(-1.0f, 0.0f, 0.0f, static_cast<float>(box.max.x));
+    planes_[2] = glm::vec4(0.0f, 1.0f, 0.0f, static_cast<float>(-box.min.y));
+    planes_[3] = glm::vec4(0.0f, -1.0f, 0.0f, static_cast<float>(box.max.y));
+    planes_[4] = glm::vec4(0.0f, 0.0f, 1.0f, static_cast<float>(-box.min.z));
+    planes_[5] = glm::vec4(0.0f, 0.0f, -1.0f, static_cast<float>(box.max.z));
+}
+
+Frustum Frustum::transformed(const glm::mat4& model) const {
+    // plane . (model * p) == (plane * model) . p, so each plane carries over to the model frame as is.
+    Frustum result;
+    for (int i = 0; i < 6; ++i) {
+        result.planes_[i] = planes_[i] * model;
+    }
+    return result;
+}
+
+bool Frustum::intersects(const BoundingBox& box) const {
+    // Objects without points are never culled.
+    if (!box.valid) return true;
+
+    for (const auto& plane : planes_) {
+        // Corner of the box farthest along the plane normal.
+        double px = plane.x >= 0.0f ? box.max.x : box.min.x;
+        double py = plane.y >= 0.0f ? box.max.y : box.min.y;
+        double pz = plane.z >= 0.0f ? box.max.z : box.min.z;
+        if (plane.x * px + plane.y * py + plane.z * pz + plane.w < 0.0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::contains(const BoundingBox& box) const {
+    if (!box.valid) return false;
+
+    for (const auto& plane : planes_) {
+        // Corner of the box nearest along the plane normal.
+        double px = plane.x >= 0.0f ? box.min.x : box.max.x;
+        double py = plane.y >= 0.0f ? box.min.y : box.max.y;
+        double pz = plane.z >= 0.0f ? box.min.z : box.max.z;
+        if (plane.x * px + plane.y * py + plane.z * pz + plane.w < 0.0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::contains(float x, float y, float z) const {
+    for (const auto& plane : planes_) {
+        if (plane.x * x + plane.y * y + plane.z * z + plane.w < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::intersects(const glm::vec3* points, int count) const {
+    // Clip the polygon by each plane in turn (Sutherland-Hodgman); whatever is left lies inside.
+    // Each plane adds at most one vertex, so a triangle never exceeds nine.
+    glm::vec3 buffers[2][12];
+    glm::vec3* in = buffers[0];
+    glm::vec3* out = buffers[1];
+    int size = std::min(count, 3);
+    std::copy(points, points + size, in);
+    for (const auto& plane : planes_) {
+        int kept = 0;
+        for (int i = 0; i < size; ++i) {
+            const glm::vec3& a = in[i];
+            const glm::vec3& b = in[(i + 1) % size];
+            const float da = plane.x * a.x + plane.y * a.y + plane.z * a.z + plane.w;
+            const float db = plane.x * b.x + plane.y * b.y + plane.z * b.z + plane.w;
+            if (da >= 0.0f) out[kept++] = a;
+            if ((da >= 0.0f) != (db >= 0.0f) && size > 1) out[kept++] = a + (b - a) * (da / (da - db));
+        }
+        if (kept == 0) return false;
+        std::swap(in, out);
+        size = std::min(kept, 11);
+    }
+    return true;
+}
+
+}  // namespace octo_flex
@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <glm/glm.hpp>
+#include "def.h"
+
+namespace octo_flex {
+
+// View frustum as six clip planes extracted from a projection * view matrix.
+class Frustum {
+   public:
+    Frustum() {}
+    explicit Frustum(const glm::mat4& viewProjection);
+
+    // The six faces of a box, so box queries share the frustum tests.
+    explicit Frustum(const BoundingBox& box);
+
+    // The same region in the frame a model matrix maps to this one's, e.g. a posed object's built geometry.
+    Frustum transformed(const glm::mat4& model) const;
+
+    // Conservative test: false only if the box lies fully outside one plane.
+    bool intersects(const BoundingBox& box) const;
+
+    // True if the box lies fully inside all six planes.
+    bool contains(const BoundingBox& box) const;
+
+    // True if the point lies inside all six planes.
+    bool contains(float x, float y, float z) const;
+
+    // Exact test for a point, segment or triangle (count 1 to 3): true if any part of it lies inside.
+    bool intersects(const glm::vec3* points, int count) const;
+
+   private:
+    glm::vec4 planes_[6];  // (a, b, c, d) with inward-pointing normals
+};
+
+}  // namespace octo_flex
+
+#endif /* FRUSTUM_H */
@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gl_deletion_queue.h"
+#include <QOpenGLFunctions>
+
+namespace octo_flex {
+
+GlDeletionQueue* GlDeletionQueue::instance() {
+    // Never destroyed: share groups may still be destroyed (and report it) during static destruction.
+    static GlDeletionQueue* queue = new GlDeletionQueue();
+    return queue;
+}
+
+uint32_t GlDeletionQueue::currentGroup() {
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    if (!context) return 0;
+    QOpenGLContextGroup* group = context->shareGroup();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = ids_.find(group);
+    if (found != ids_.end()) return found->second;
+
+    const uint32_t id = nextId_++;
+    ids_.emplace(group, id);
+    live_.insert(id);
+    // Emitted on the thread destroying the group's last context.
+    QObject::connect(group, &QObject::destroyed, [this, group, id]() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ids_.erase(group);
+        live_.erase(id);
+        pending_.erase(id);
+    });
+    return id;
+}
+
+void GlDeletionQueue::deleteBuffers(uint32_t group, std::initializer_list<GLuint> names) {
+    release(group, names, false);
+}
+
+void GlDeletionQueue::deleteTextures(uint32_t group, std::initializer_list<GLuint> names) {
+    release(group, names, true);
+}
+
+void GlDeletionQueue::release(uint32_t group, std::initializer_list<GLuint> names, bool textures) {
+    if (group == 0) return;
+    if (group == currentGroup()) {
+        QOpenGLFunctions* gl = QOpenGLContext::currentContext()->functions();
+        for (GLuint name : names) {
+            if (name == 0) continue;
+            if (textures) {
+                gl->glDeleteTextures(1, &name);
+            } else {
+                gl->glDeleteBuffers(1, &name);
+            }
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (live_.count(group) == 0) return;
+    Pending& pending = pending_[group];
+    for (GLuint name : names) {
+        if (name != 0) (textures ? pending.textures : pending.buffers).push_back(name);
+    }
+}
+
+void GlDeletionQueue::collect() {
+    const uint32_t group = currentGroup();
+    if (group == 0) return;
+
+    Pending pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto found = pending_.find(group);
+        if (found == pending_.end()) return;
+        pending = std::move(found->second);
+        pending_.erase(found);
+    }
+    QOpenGLFunctions* gl = QOpenGLContext::currentContext()->functions();
+    if (!pending.buffers.empty()) {
+        gl->glDeleteBuffers(static_cast<GLsizei>(pending.buffers.size()), pending.buffers.data());
+    }
+    if (!pending.textures.empty()) {
+        gl->glDeleteTextures(static_cast<GLsizei>(pending.textures.size()), pending.textures.data());
+    }
+}
+
+}  // namespace octo_flex
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GL_DELETION_QUEUE_H
+#define GL_DELETION_QUEUE_H
+
+#include <QOpenGLContext>
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace octo_flex {
+
+// Deletes GL names in the share group that created them. Owners of GPU resources (shapes, layer
+// batches, uploaded handles) may be released on any thread, with another view's context current or
+// none at all, and a name means nothing (or something else) outside its share group. Owners record
+// currentGroup() when they create names and hand them in here when released: names of the current
+// context's group are deleted at once, the others by the next frame painted in their group
+// (collect()). Names of a group destroyed meanwhile went with its last context and are dropped.
+class GlDeletionQueue {
+   public:
+    static GlDeletionQueue* instance();
+
+    // Id of the current context's share group, 0 without a current context. Ids are never reused,
+    // so an id outliving its group cannot match a later one.
+    uint32_t currentGroup();
+
+    // Delete names created in group; zero names are skipped.
+    void deleteBuffers(uint32_t group, std::initializer_list<GLuint> names);
+    void deleteTextures(uint32_t group, std::initializer_list<GLuint> names);
+
+    // Delete the names queued for the current context's share group; called by the views at the
+    // start of a frame, with their context current.
+    void collect();
+
+   private:
+    struct Pending {
+        std::vector<GLuint> buffers;
+        std::vector<GLuint> textures;
+    };
+
+    GlDeletionQueue() {}
+
+    void release(uint32_t group, std::initializer_list<GLuint> names, bool textures);
+
+    std::mutex mutex_;
+    std::unordered_map<QOpenGLContextGroup*, uint32_t> ids_;  // Live share groups
+    std::unordered_set<uint32_t> live_;
+    std::unordered_map<uint32_t, Pending> pending_;
+    uint32_t nextId_ = 1;
+};
+
+}  // namespace octo_flex
+
+#endif  // GL_DELETION_QUEUE_H
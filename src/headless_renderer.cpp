@@ -0,0 +1,329 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "headless_renderer.h"
+
+#include <QApplication>
+#include <QCoreApplication>
+#include <QImage>
+#include <QSurfaceFormat>
+#include <glm/glm.hpp>
+#include <iostream>
+
+#include "object_manager.h"
+#include "octo_flex_view.h"
+#include "octo_flex_view_container.h"
+#include "render_backend.h"
+#include "scene_snapshot.h"
+
+namespace octo_flex {
+
+// ============================================================================
+// HeadlessRenderer::Impl - Private implementation
+// ============================================================================
+struct HeadlessRenderer::Impl {
+    std::unique_ptr<QApplication> app;           // Owned Qt application (if created)
+    OctoFlexViewContainer* container = nullptr;  // Hidden container holding the rendered view
+    ObjectManager::Ptr obj_manager;              // Object manager
+    std::string last_error;                      // Last failure
+
+    // Dummy argc/argv for Qt when user doesn't provide them
+    int dummy_argc = 1;
+    std::vector<char> dummy_argv_data{'a', 'p', 'p', '\0'};
+    char* dummy_argv_ptr;
+    char** dummy_argv;
+
+    Impl() {
+        dummy_argv_ptr = dummy_argv_data.data();
+        dummy_argv = &dummy_argv_ptr;
+    }
+
+    ~Impl() {
+        // The container and its GL resources go before the application.
+        delete container;
+        container = nullptr;
+    }
+
+    OctoFlexView* view() const { return container ? container->getCurrentView() : nullptr; }
+};
+
+// ============================================================================
+// HeadlessRenderer - Public interface implementation
+// ============================================================================
+
+HeadlessRenderer::HeadlessRenderer() : impl_(std::make_unique<Impl>()) {}
+
+HeadlessRenderer::~HeadlessRenderer() = default;
+
+HeadlessRenderer::HeadlessRenderer(HeadlessRenderer&&) noexcept = default;
+
+HeadlessRenderer& HeadlessRenderer::operator=(HeadlessRenderer&&) noexcept = default;
+
+HeadlessRenderer HeadlessRenderer::create(int width, int height, int* argc, char*** argv) {
+    HeadlessRenderer renderer;
+
+    // Step 1: Create or reuse QApplication
+    if (!qApp) {
+        // Without a display, render through Qt's offscreen platform unless the caller chose one.
+        if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM") && qEnvironmentVariableIsEmpty("DISPLAY") &&
+            qEnvironmentVariableIsEmpty("WAYLAND_DISPLAY")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+        QCoreApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
+        QSurfaceFormat::setDefaultFormat(RenderBackend::surfaceFormat(RenderBackend::defaultType()));
+
+        if (argc && argv) {
+            renderer.impl_->app = std::make_unique<QApplication>(*argc, *argv);
+        } else {
+            renderer.impl_->app =
+                std::make_unique<QApplication>(renderer.impl_->dummy_argc, renderer.impl_->dummy_argv);
+        }
+    }
+
+    // Step 2: Create object manager
+    renderer.impl_->obj_manager = std::make_shared<ObjectManager>();
+
+    // Step 3: Create the container, never shown, with its initial view
+    renderer.impl_->container = new OctoFlexViewContainer();
+    renderer.impl_->container->setObjectManager(renderer.impl_->obj_manager);
+    renderer.impl_->container->createInitialView();
+
+    // Step 4: Size the framebuffer
+    if (!renderer.resize(width, height)) {
+        std::cerr << "Error: " << renderer.impl_->last_error << std::endl;
+    }
+
+    return renderer;
+}
+
+HeadlessRenderer& HeadlessRenderer::add(std::shared_ptr<Object> object, const std::string& layer_id) {
+    if (!impl_->obj_manager) {
+        std::cerr << "Error: Object manager not initialized" << std::endl;
+        return *this;
+    }
+
+    impl_->obj_manager->submit(object, layer_id);
+    return *this;
+}
+
+HeadlessRenderer& HeadlessRenderer::setLayer(const std::vector<std::shared_ptr<Object>>& objects,
+                                             const std::string& layer_id) {
+    if (!impl_->obj_manager) {
+        std::cerr << "Error: Object manager not initialized" << std::endl;
+        return *this;
+    }
+
+    impl_->obj_manager->submitLayer(objects, layer_id);
+    return *this;
+}
+
+HeadlessRenderer& HeadlessRenderer::submitLayerDelta(const std::vector<std::shared_ptr<Object>>& upserts,
+                                                     const std::vector<std::string>& removed_ids,
+                                                     const std::string& layer_id) {
+    if (!impl_->obj_manager) {
+        std::cerr << "Error: Object manager not initialized" << std::endl;
+        return *this;
+    }
+
+    impl_->obj_manager->submitLayerDelta(upserts, removed_ids, layer_id);
+    return *this;
+}
+
+HeadlessRenderer& HeadlessRenderer::updatePose(const std::string& id, const Vec3& position,
+                                               const Quaternion& orientation) {
+    if (!impl_->obj_manager) {
+        std::cerr << "Error: Object manager not initialized" << std::endl;
+        return *this;
+    }
+
+    if (!impl_->obj_manager->updatePose(id, position, orientation)) {
+        std::cerr << "Warning: Object '" << id << "' not found for pose update" << std::endl;
+    }
+    return *this;
+}
+
+HeadlessRenderer& HeadlessRenderer::updateScalars(const std::string& id, const float* values, size_t count) {
+    if (!impl_->obj_manager) {
+        std::cerr << "Error: Object manager not initialized" << std::endl;
+        return *this;
+    }
+
+    if (!impl_->obj_manager->updateScalars(id, values, count)) {
+        std::cerr << "Warning: Object '" << id << "' not found or without matching scalars for scalar update"
+                  << std::endl;
+    }
+    return *this;
+}
+
+HeadlessRenderer& HeadlessRenderer::setScalarMapping(const std::string& id, Colormap colormap, double min, double max) {
+    if (!impl_->obj_manager) {
+        std::cerr << "Error: Object manager not initialized" << std::endl;
+        return *this;
+    }
+
+    if (!impl_->obj_manager->setScalarMapping(id, colormap, min, max)) {
+        std::cerr << "Warning: Object '" << id << "' not found or without scalars for scalar mapping" << std::endl;
+    }
+    return *this;
+}
+
+std::shared_ptr<ObjectManager> HeadlessRenderer::objectManager() const { return impl_->obj_manager; }
+
+bool HeadlessRenderer::saveScene(const std::string& path) {
+    if (!impl_->obj_manager) {
+        impl_->last_error = "Renderer not initialized";
+        return false;
+    }
+    return saveSceneSnapshot(*impl_->obj_manager, path, &impl_->last_error);
+}
+
+bool HeadlessRenderer::loadScene(const std::string& path) {
+    if (!impl_->obj_manager) {
+        impl_->last_error = "Renderer not initialized";
+        return false;
+    }
+    return loadSceneSnapshot(*impl_->obj_manager, path, &impl_->last_error);
+}
+
+void HeadlessRenderer::setCamera(const Vec3& position, const Vec3& target, const Vec3& up) {
+    OctoFlexView* view = impl_->view();
+    if (!view) {
+        return;
+    }
+
+    const glm::vec3 eye(position.x, position.y, position.z);
+    const glm::vec3 front = glm::vec3(target.x, target.y, target.z) - eye;
+    const glm::vec3 right = glm::cross(front, glm::vec3(up.x, up.y, up.z));
+    if (glm::length(front) < 1e-6f || glm::length(right) < 1e-6f) {
+        std::cerr << "Warning: Camera target coincides with its position or lies along the up direction"
+                  << std::endl;
+        return;
+    }
+
+    Camera::Ptr camera = view->getCamera();
+    camera->setPosition(eye);
+    camera->setVectors(front, glm::cross(right, front), right);
+}
+
+bool HeadlessRenderer::resize(int width, int height) {
+    OctoFlexView* view = impl_->view();
+    if (!view) {
+        impl_->last_error = "Renderer not initialized";
+        return false;
+    }
+    if (width <= 0 || height <= 0) {
+        impl_->last_error = "Frame size must be positive";
+        return false;
+    }
+    if (impl_->container->isRecording()) {
+        impl_->last_error = "Cannot resize while recording";
+        return false;
+    }
+
+    impl_->container->resize(width, height);
+    view->resize(width, height);
+    return true;
+}
+
+int HeadlessRenderer::width() const {
+    OctoFlexView* view = impl_->view();
+    return view ? view->width() : 0;
+}
+
+int HeadlessRenderer::height() const {
+    OctoFlexView* view = impl_->view();
+    return view ? view->height() : 0;
+}
+
+bool HeadlessRenderer::renderFrame() {
+    OctoFlexView* view = impl_->view();
+    if (!view) {
+        impl_->last_error = "Renderer not initialized";
+        return false;
+    }
+
+    // No event loop runs; deliver queued signals and deferred deletions here.
+    QCoreApplication::processEvents();
+
+    if (impl_->container->isRecording()) {
+        if (!impl_->container->recordOfflineFrame()) {
+            impl_->last_error = impl_->container->getLastRecordingError();
+            return false;
+        }
+        return true;
+    }
+
+    if (!view->renderFrame()) {
+        impl_->last_error = "Failed to create the OpenGL context";
+        return false;
+    }
+    return true;
+}
+
+bool HeadlessRenderer::saveFrame(const std::string& path) {
+    if (!renderFrame()) {
+        return false;
+    }
+
+    // Multisampled framebuffers are resolved by Qt's grab, which paints once more.
+    OctoFlexView* view = impl_->view();
+    view->makeCurrent();
+    QImage image = view->format().samples() > 0 ? view->grabFramebuffer() : view->captureFrame();
+    if (image.isNull() || !image.convertToFormat(QImage::Format_RGB888).save(QString::fromStdString(path))) {
+        impl_->last_error = "Failed to save frame to " + path;
+        return false;
+    }
+    return true;
+}
+
+bool HeadlessRenderer::startRecording(const RecordingOptions& options) {
+    if (!impl_->container) {
+        impl_->last_error = "Renderer not initialized";
+        return false;
+    }
+
+    RecordingOptions offline = options;
+    offline.offline = true;
+    if (!impl_->container->startRecording(offline)) {
+        impl_->last_error = impl_->container->getLastRecordingError();
+        return false;
+    }
+    return true;
+}
+
+bool HeadlessRenderer::stopRecording() {
+    if (!impl_->container) {
+        return false;
+    }
+    if (!impl_->container->stopRecording()) {
+        impl_->last_error = impl_->container->getLastRecordingError();
+        return false;
+    }
+    return true;
+}
+
+bool HeadlessRenderer::isRecording() const { return impl_->container && impl_->container->isRecording(); }
+
+RecordingStats HeadlessRenderer::getRecordingStats() const {
+    if (!impl_->container) {
+        return RecordingStats();
+    }
+    return impl_->container->getRecordingStats();
+}
+
+std::string HeadlessRenderer::getLastError() const { return impl_->last_error; }
+
+}  // namespace octo_flex
@@ -17,9 +17,11 @@
 
 #include "info_panel.h"
 #include <QFont>
+#include <QFontInfo>
 #include <QTimer>
 #include <algorithm>
 #include <iostream>
+#include "text_renderer.h"
 
 namespace octo_flex {
 
@@ -33,6 +35,9 @@ InfoPanel::~InfoPanel() { cleanup(); }
 
 void InfoPanel::initialize(QWidget* parent) {
     parentWidget_ = parent;
+    QFont font = parent ? parent->font() : QFont();
+    font.setPointSize(9);
+    fontPixelSize_ = static_cast<float>(QFontInfo(font).pixelSize());
 
     // Create the toggle button.
     toggleButton_ = new QPushButton(parent);
@@ -57,9 +62,14 @@ void InfoPanel::cleanup() {
     }
 }
 
-void InfoPanel::setInfoItem(const std::string& id, const std::string& info, InfoItemType type) {
+void InfoPanel::setInfoItem(const std::string& id, const std::string& info, InfoItemType type, bool repaint) {
+    std::unique_lock<std::mutex> lock(mutex_);
     // Check whether the ID already exists.
     auto it = infoItems_.find(id);
+    if (it != infoItems_.end() && it->second.info == info && it->second.type == type) {
+        // Unchanged, nothing to repaint.
+        return;
+    }
     if (it == infoItems_.end()) {
         // If the ID does not exist, add it to the order list.
         infoItemsOrder_.push_back(id);
@@ -72,6 +82,7 @@ void InfoPanel::setInfoItem(const std::string& id, const std::string& info, Info
 
     // Update or add the info item.
     infoItems_[id] = {info, type};
+    ++version_;
 
     // Log current info items.
     // std::cout << "InfoPanel::setInfoItem: item count: " << infoItemsOrder_.size() << std::endl;
@@ -82,20 +93,26 @@ void InfoPanel::setInfoItem(const std::string& id, const std::string& info, Info
         }
     }
 
+    lock.unlock();
+
     // Trigger repaint.
-    if (parentWidget_) {
+    if (parentWidget_ && repaint) {
         parentWidget_->update();
     }
 }
 
 void InfoPanel::removeInfoItem(const std::string& id) {
-    // Remove from the map.
-    infoItems_.erase(id);
-
-    // Remove from the order list.
-    auto it = std::find(infoItemsOrder_.begin(), infoItemsOrder_.end(), id);
-    if (it != infoItemsOrder_.end()) {
-        infoItemsOrder_.erase(it);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Remove from the map.
+        infoItems_.erase(id);
+
+        // Remove from the order list.
+        auto it = std::find(infoItemsOrder_.begin(), infoItemsOrder_.end(), id);
+        if (it != infoItemsOrder_.end()) {
+            infoItemsOrder_.erase(it);
+        }
+        ++version_;
     }
 
     // Trigger repaint.
@@ -105,8 +122,12 @@ void InfoPanel::removeInfoItem(const std::string& id) {
 }
 
 void InfoPanel::clearInfoItems() {
-    infoItems_.clear();
-    infoItemsOrder_.clear();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        infoItems_.clear();
+        infoItemsOrder_.clear();
+        ++version_;
+    }
 
     if (parentWidget_) {
         parentWidget_->update();
@@ -115,6 +136,7 @@ void InfoPanel::clearInfoItems() {
 
 void InfoPanel::toggle() {
     visible_ = !visible_;
+    ++version_;
 
     // Update button text and log debug info.
     if (toggleButton_) {
@@ -162,6 +184,8 @@ void InfoPanel::draw(QPainter& painter) {
         return;
     }
 
+    std::lock_guard<std::mutex> lock(mutex_);
+
     if (infoItemsOrder_.empty()) {
         // std::cout << "InfoPanel::draw: no info items to show" << std::endl;
         return;
@@ -204,8 +228,40 @@ void InfoPanel::draw(QPainter& painter) {
     }
 }
 
+void InfoPanel::layout(TextRenderer& renderer, TextBatch& batch) {
+    batch.clear();
+    if (!visible_) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (infoItemsOrder_.empty()) {
+        return;
+    }
+
+    // Same geometry as draw().
+    const int panelX = margin_;
+    const int panelY = margin_ + (toggleButton_ ? toggleButton_->height() : 0) + 5;
+    const int lineHeight = 20;
+    const int panelHeight = lineHeight * infoItemsOrder_.size() + 10;
+    batch.beginRun();
+    batch.addRect(renderer, panelX, panelY, width_, panelHeight, glm::vec4(1.0f, 1.0f, 1.0f, opacity_));
+
+    int textY = panelY + 15;
+    for (const auto& id : infoItemsOrder_) {
+        auto it = infoItems_.find(id);
+        if (it != infoItems_.end()) {
+            const QColor textColor = getColorForType(it->second.type);
+            const glm::vec4 color(textColor.redF(), textColor.greenF(), textColor.blueF(), 1.0f);
+            batch.addText(renderer, it->second.info, panelX + 10, textY, fontPixelSize_, color);
+            textY += lineHeight;
+        }
+    }
+}
+
 void InfoPanel::setWidth(int width) {
     width_ = width;
+    ++version_;
     if (parentWidget_) {
         parentWidget_->update();
     }
@@ -213,6 +269,7 @@ void InfoPanel::setWidth(int width) {
 
 void InfoPanel::setMargin(int margin) {
     margin_ = margin;
+    ++version_;
     updateButtonPosition();
     if (parentWidget_) {
         parentWidget_->update();
@@ -221,6 +278,7 @@ void InfoPanel::setMargin(int margin) {
 
 void InfoPanel::setOpacity(float opacity) {
     opacity_ = opacity;
+    ++version_;
     if (parentWidget_) {
         parentWidget_->update();
     }
@@ -23,12 +23,18 @@
 #include <QPainter>
 #include <QPushButton>
 #include <QWidget>
+#include <atomic>
+#include <cstdint>
 #include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
 namespace octo_flex {
 
+class TextBatch;
+class TextRenderer;
+
 // Info item type enum.
 enum class InfoItemType {
     NORMAL,   // Normal info - black.
@@ -36,6 +42,7 @@ enum class InfoItemType {
     ERROR     // Error info - red.
 };
 
+// Items may be changed on the GUI thread while a render thread draws the panel (threaded rendering).
 class InfoPanel {
    public:
     InfoPanel(QWidget* parent = nullptr);
@@ -48,7 +55,9 @@ class InfoPanel {
     void cleanup();
 
     // Info item management.
-    void setInfoItem(const std::string& id, const std::string& info, InfoItemType type = InfoItemType::NORMAL);
+    // Repaints the parent only when the item changed and repaint is set.
+    void setInfoItem(const std::string& id, const std::string& info, InfoItemType type = InfoItemType::NORMAL,
+                     bool repaint = true);
     void removeInfoItem(const std::string& id);
     void clearInfoItems();
 
@@ -58,6 +67,11 @@ class InfoPanel {
 
     // Draw the info panel.
     void draw(QPainter& painter);
+    // Lay the panel out into batch, drawn by renderer without a painter (empty while hidden).
+    void layout(TextRenderer& renderer, TextBatch& batch);
+
+    // Bumped whenever the drawn items or the visibility change.
+    uint64_t version() const { return version_; }
 
     // Set properties.
     void setWidth(int width);
@@ -83,17 +97,20 @@ class InfoPanel {
     // Get text color by type.
     QColor getColorForType(InfoItemType type) const;
 
-    // Info panel data.
+    // Info panel data, guarded by mutex_.
+    mutable std::mutex mutex_;
     std::map<std::string, InfoItem> infoItems_;
     std::vector<std::string> infoItemsOrder_;
+    std::atomic<uint64_t> version_{0};
 
     // Visibility state.
-    bool visible_ = false;
+    std::atomic<bool> visible_{false};
 
     // Style properties.
     int width_ = 300;
     int margin_ = 10;
     float opacity_ = 0.7f;
+    float fontPixelSize_ = 12.0f;  // Of the 9 point item font, resolved on the GUI thread
 
     // Control button.
     QPushButton* toggleButton_ = nullptr;
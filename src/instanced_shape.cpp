@@ -0,0 +1,299 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "instanced_shape.h"
+#include <QDebug>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <algorithm>
+#include <mutex>
+#include "gl_deletion_queue.h"
+#include "textured_quad.h"
+#include "utils.h"
+
+namespace octo_flex {
+
+namespace {
+
+// Frozen copy of a mesh shape of a reference, placed and tinted like the reference draws it.
+Shape::Ptr placedCopy(const InstancedShape& reference, const Shape::Ptr& shape) {
+    Shape::Ptr copy = shape->clone();
+    const Vec3& scale = reference.scales().front();
+    copy->scale(scale.x, scale.y, scale.z);
+    copy->rotate(reference.orientations().front());
+    copy->move(reference.positions().front());
+    std::vector<Vec3> colors;
+    for (size_t i = 0; i < copy->colors().size(); ++i) {
+        colors.push_back(reference.instanceColor(0, copy->colors()[i]));
+    }
+    if (colors.empty()) {
+        copy->setPointsWithColor(std::vector<Vec3>(copy->points()), reference.instanceColor(0, copy->color()));
+    } else {
+        copy->setPointsWithColor(std::vector<Vec3>(copy->points()), colors);
+    }
+    copy->setInEditable();
+    return copy;
+}
+
+}  // namespace
+
+InstancedShape::InstancedShape(const std::vector<Shape::Ptr>& prototype, const std::vector<Vec3>& positions,
+                               const std::vector<Quaternion>& orientations, const std::vector<Vec3>& scales,
+                               const std::vector<Vec3>& colors)
+    : Shape(Shape::Instanced, 1.0, 1.0), positions_(positions) {
+    auto frozen_prototype = std::make_shared<std::vector<Shape::Ptr>>();
+    for (const auto& shape : prototype) {
+        if (!shape || shape->points().empty()) continue;
+        // Instances are drawn with one prototype mesh: keep the finest level of detail.
+        if (shape->lodLevel() > 0) continue;
+        // References (builder primitives) become the plain shapes they stand for.
+        if (shape->type() == Shape::Instanced && static_cast<const InstancedShape&>(*shape).isReference()) {
+            const auto& reference = static_cast<const InstancedShape&>(*shape);
+            for (const auto& part : reference.prototype()) {
+                frozen_prototype->push_back(placedCopy(reference, part));
+            }
+            continue;
+        }
+        if (shape->type() == Shape::TexturedQuad || shape->type() == Shape::Instanced || shape->isPacked() ||
+            dynamic_cast<const octo_flex::TexturedQuad*>(shape.get())) {
+            qWarning() << "InstancedShape: unsupported prototype shape (textured, packed or instanced), skipping.";
+            continue;
+        }
+        Shape::Ptr frozen = shape->clone();
+        frozen->setInEditable();
+        frozen_prototype->push_back(frozen);
+    }
+    prototype_ = std::move(frozen_prototype);
+
+    // Optional attributes must match the instance count, otherwise defaults are used.
+    const size_t count = positions_.size();
+    if (orientations.size() == count) {
+        orientations_ = orientations;
+    } else {
+        if (!orientations.empty()) qWarning() << "InstancedShape: orientation count mismatch, using identity.";
+        orientations_.assign(count, Quaternion());
+    }
+    if (scales.size() == count) {
+        scales_ = scales;
+    } else {
+        if (!scales.empty()) qWarning() << "InstancedShape: scale count mismatch, using unit scale.";
+        scales_.assign(count, Vec3(1.0, 1.0, 1.0));
+    }
+    if (colors.size() == count) {
+        instance_colors_ = colors;
+    } else if (!colors.empty()) {
+        qWarning() << "InstancedShape: color count mismatch, using prototype colors.";
+    }
+
+    updateBoundsPoints();
+}
+
+InstancedShape::~InstancedShape() { releaseInstanceBuffer(); }
+
+InstancedShape::Ptr InstancedShape::reference(const Mesh& mesh, const Vec3& position, const Quaternion& orientation,
+                                              const Vec3& scale, const Vec3& color) {
+    auto shape = std::shared_ptr<InstancedShape>(new InstancedShape());
+    shape->prototype_ = mesh ? mesh : std::make_shared<const std::vector<Shape::Ptr>>();
+    shape->reference_ = true;
+    shape->positions_.assign(1, position);
+    shape->orientations_.assign(1, orientation);
+    shape->scales_.assign(1, scale);
+    shape->instance_colors_.assign(1, color);
+    shape->updateBoundsPoints();
+    return shape;
+}
+
+const std::vector<Shape::Ptr>& InstancedShape::prototype() const { return *prototype_; }
+size_t InstancedShape::instanceCount() const { return positions_.size(); }
+bool InstancedShape::hasInstanceColors() const { return !instance_colors_.empty(); }
+
+Vec3 InstancedShape::instanceColor(size_t instance, const Vec3& prototype_color) const {
+    if (instance >= instance_colors_.size()) return prototype_color;
+    const Vec3& color = instance_colors_[instance];
+    if (!reference_) return color;
+    return Vec3(color.x * prototype_color.x, color.y * prototype_color.y, color.z * prototype_color.z);
+}
+
+const std::vector<Vec3>& InstancedShape::positions() const { return positions_; }
+const std::vector<Quaternion>& InstancedShape::orientations() const { return orientations_; }
+const std::vector<Vec3>& InstancedShape::scales() const { return scales_; }
+const std::vector<Vec3>& InstancedShape::instanceColors() const { return instance_colors_; }
+
+void InstancedShape::updateBoundsPoints() {
+    // Bounds of the prototype in its local frame.
+    BoundingBox local;
+    for (const auto& shape : *prototype_) {
+        for (const auto& point : shape->points()) {
+            local.expand(point);
+        }
+    }
+
+    BoundingBox world;
+    if (local.valid) {
+        for (size_t i = 0; i < positions_.size(); ++i) {
+            for (int corner = 0; corner < 8; ++corner) {
+                Vec3 p((corner & 1) ? local.max.x : local.min.x, (corner & 2) ? local.max.y : local.min.y,
+                       (corner & 4) ? local.max.z : local.min.z);
+                p = Vec3(p.x * scales_[i].x, p.y * scales_[i].y, p.z * scales_[i].z);
+                world.expand(quaternionRotateVector(orientations_[i], p) + positions_[i]);
+            }
+        }
+    }
+
+    std::vector<Vec3> corners;
+    if (world.valid) {
+        for (int corner = 0; corner < 8; ++corner) {
+            corners.push_back(Vec3((corner & 1) ? world.max.x : world.min.x, (corner & 2) ? world.max.y : world.min.y,
+                                   (corner & 4) ? world.max.z : world.min.z));
+        }
+    }
+    Shape::setPointsWithColor(corners, Vec3(1.0, 1.0, 1.0));
+}
+
+Shape::Ptr InstancedShape::clone() {
+    // Prototype geometry is immutable and shared between clones.
+    auto new_shape = std::shared_ptr<InstancedShape>(new InstancedShape());
+    new_shape->prototype_ = prototype_;
+    new_shape->reference_ = reference_;
+    new_shape->positions_ = positions_;
+    new_shape->orientations_ = orientations_;
+    new_shape->scales_ = scales_;
+    new_shape->instance_colors_ = instance_colors_;
+    new_shape->updateBoundsPoints();
+    return new_shape;
+}
+
+void InstancedShape::move(const Vec3& vec) {
+    if (!isEditable()) return;
+    for (auto& position : positions_) {
+        position = position + vec;
+    }
+    updateBoundsPoints();
+}
+
+void InstancedShape::rotate(const Quaternion& quad) {
+    if (!isEditable()) return;
+    for (size_t i = 0; i < positions_.size(); ++i) {
+        positions_[i] = quaternionRotateVector(quad, positions_[i]);
+        orientations_[i] = quaternionMultiply(quad, orientations_[i]);
+    }
+    updateBoundsPoints();
+}
+
+void InstancedShape::scale(double sx, double sy, double sz) {
+    if (!isEditable()) return;
+    // Exact for axis-aligned instances; rotated instances keep their local scale axes.
+    for (size_t i = 0; i < positions_.size(); ++i) {
+        positions_[i] = Vec3(positions_[i].x * sx, positions_[i].y * sy, positions_[i].z * sz);
+        scales_[i] = Vec3(scales_[i].x * sx, scales_[i].y * sy, scales_[i].z * sz);
+    }
+    updateBoundsPoints();
+}
+
+unsigned int InstancedShape::instanceBuffer() const {
+    ensureInstanceBufferUploaded();
+    return instance_buffer_id_;
+}
+
+size_t InstancedShape::cpuBytes() const {
+    size_t bytes = Shape::cpuBytes() + orientations_.capacity() * sizeof(Quaternion);
+    bytes += (positions_.capacity() + scales_.capacity() + instance_colors_.capacity()) * sizeof(Vec3);
+    size_t prototype_bytes = 0;
+    for (const auto& shape : *prototype_) {
+        prototype_bytes += shape->cpuBytes();
+    }
+    return bytes + prototype_bytes / static_cast<size_t>(std::max(1L, prototype_.use_count()));
+}
+
+size_t InstancedShape::gpuBytes() const {
+    size_t prototype_bytes = 0;
+    for (const auto& shape : *prototype_) {
+        prototype_bytes += shape->gpuBytes();
+    }
+    return Shape::gpuBytes() + instance_bytes_.load(std::memory_order_relaxed) +
+           prototype_bytes / static_cast<size_t>(std::max(1L, prototype_.use_count()));
+}
+
+void InstancedShape::ensureInstanceBufferUploaded() const {
+    if (instance_buffer_id_.load(std::memory_order_acquire) != 0 || isEditable() || positions_.empty()) {
+        return;
+    }
+
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    if (!context) {
+        // No context yet, will upload later during rendering
+        return;
+    }
+
+    // As for Shape's buffers: uploaded by the first view to draw it, and flushed before it is published.
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (instance_buffer_id_.load(std::memory_order_relaxed) != 0) {
+        return;
+    }
+
+    std::vector<GpuInstance> instances(positions_.size());
+    for (size_t i = 0; i < positions_.size(); ++i) {
+        GpuInstance& instance = instances[i];
+        instance.position[0] = static_cast<float>(positions_[i].x);
+        instance.position[1] = static_cast<float>(positions_[i].y);
+        instance.position[2] = static_cast<float>(positions_[i].z);
+        instance.rotation[0] = static_cast<float>(orientations_[i].x);
+        instance.rotation[1] = static_cast<float>(orientations_[i].y);
+        instance.rotation[2] = static_cast<float>(orientations_[i].z);
+        instance.rotation[3] = static_cast<float>(orientations_[i].w);
+        instance.scale[0] = static_cast<float>(scales_[i].x);
+        instance.scale[1] = static_cast<float>(scales_[i].y);
+        instance.scale[2] = static_cast<float>(scales_[i].z);
+        const Vec3 color = instance_colors_.empty() ? Vec3(1.0, 1.0, 1.0) : instance_colors_[i];
+        instance.color[0] = static_cast<float>(color.x);
+        instance.color[1] = static_cast<float>(color.y);
+        instance.color[2] = static_cast<float>(color.z);
+        instance.color[3] = 1.0f;
+        instance.index = static_cast<float>(i);
+    }
+
+    QOpenGLFunctions* gl = context->functions();
+    GLuint buffer = 0;
+    gl->glGenBuffers(1, &buffer);
+    gl_group_ = GlDeletionQueue::instance()->currentGroup();
+    gl->glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    gl->glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(instances.size() * sizeof(GpuInstance)),
+                     instances.data(), GL_STATIC_DRAW);
+    gl->glBindBuffer(GL_ARRAY_BUFFER, 0);
+    gl->glFlush();
+    instance_bytes_.store(instances.size() * sizeof(GpuInstance), std::memory_order_relaxed);
+    instance_buffer_id_.store(buffer, std::memory_order_release);
+}
+
+void InstancedShape::releaseResources() {
+    Shape::releaseResources();
+    releaseInstanceBuffer();
+    // The prototype's buffers belong to its shapes, which clones and references share: they go
+    // with the last owner of the prototype.
+}
+
+void InstancedShape::releaseInstanceBuffer() {
+    if (instance_buffer_id_ == 0) {
+        return;
+    }
+
+    GlDeletionQueue::instance()->deleteBuffers(gl_group_, {instance_buffer_id_.load()});
+    instance_buffer_id_ = 0;
+    instance_bytes_.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace octo_flex
@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef INSTANCED_SHAPE_H
+#define INSTANCED_SHAPE_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "def.h"
+#include "shape.h"
+
+namespace octo_flex {
+
+// One prototype geometry drawn at many poses with a single instanced call per prototype shape.
+// The shape's own points are the corners of the bounds of all instances, so bounds,
+// culling and label placement work unchanged.
+//
+// A reference is a single placement of a shared mesh (see unitMesh()): its color tints the mesh
+// colors, layer batches merge it like plain shapes and picks report no instance.
+class InstancedShape : public Shape {
+   public:
+    typedef std::shared_ptr<InstancedShape> Ptr;
+    typedef std::shared_ptr<const std::vector<Shape::Ptr>> Mesh;  // Frozen shapes, shared read-only
+
+    // Per-instance attributes in the retained GPU buffer.
+    struct GpuInstance {
+        float position[3];
+        float rotation[4];  // Quaternion (x, y, z, w)
+        float scale[3];
+        float color[4];
+        float index;  // Instance index, used for picking
+    };
+
+   public:
+    // Prototype shapes are cloned and frozen, references replaced by their placed mesh shapes; textured
+    // and other instanced shapes are not supported.
+    InstancedShape(const std::vector<Shape::Ptr>& prototype, const std::vector<Vec3>& positions,
+                   const std::vector<Quaternion>& orientations, const std::vector<Vec3>& scales,
+                   const std::vector<Vec3>& colors);
+    ~InstancedShape() override;
+
+    // Place a shared mesh once, scaled, rotated and moved in that order and tinted by color.
+    static Ptr reference(const Mesh& mesh, const Vec3& position, const Quaternion& orientation, const Vec3& scale,
+                         const Vec3& color);
+
+    const std::vector<Shape::Ptr>& prototype() const;
+    const Mesh& mesh() const { return prototype_; }
+    size_t instanceCount() const;
+    bool hasInstanceColors() const;
+    bool isReference() const { return reference_; }
+
+    // Color of an instance drawn for a prototype shape: the instance color replaces the prototype
+    // colors, or tints them for references; the prototype color without instance colors.
+    Vec3 instanceColor(size_t instance, const Vec3& prototype_color) const;
+
+    const std::vector<Vec3>& positions() const;
+    const std::vector<Quaternion>& orientations() const;
+    const std::vector<Vec3>& scales() const;
+    const std::vector<Vec3>& instanceColors() const;
+
+    // Retained GPU instance buffer name (0 until a context is current).
+    unsigned int instanceBuffer() const;
+
+    // Instances and an equal share of the prototype geometry for each shape holding it.
+    size_t cpuBytes() const override;
+    size_t gpuBytes() const override;
+
+    Shape::Ptr clone() override;
+    void move(const Vec3& vec) override;
+    void rotate(const Quaternion& quad) override;
+    void scale(double sx, double sy, double sz) override;
+    using Shape::scale;
+    void releaseResources() override;
+
+   private:
+    InstancedShape() : Shape(Shape::Instanced, 1.0, 1.0) {}
+    void updateBoundsPoints();
+    void ensureInstanceBufferUploaded() const;  // const because it's lazy initialization
+    void releaseInstanceBuffer();
+
+    Mesh prototype_;  // Shared, immutable geometry
+    bool reference_ = false;
+    std::vector<Vec3> positions_;
+    std::vector<Quaternion> orientations_;
+    std::vector<Vec3> scales_;
+    std::vector<Vec3> instance_colors_;
+    mutable std::atomic<unsigned int> instance_buffer_id_{0};  // GL buffer name, set once the lazy upload is done
+    mutable uint32_t gl_group_ = 0;                            // Share group the buffer was created in
+    mutable std::atomic<size_t> instance_bytes_{0};  // Size of the instance buffer while uploaded
+};
+
+}  // namespace octo_flex
+
+#endif /* INSTANCED_SHAPE_H */
@@ -0,0 +1,194 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ktx2_loader.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace octo_flex {
+namespace {
+
+const unsigned char kIdentifier[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+const size_t kHeaderBytes = 80;     // Identifier, header and index
+const size_t kLevelIndexBytes = 24;  // byteOffset, byteLength, uncompressedByteLength
+
+uint32_t readU32(const unsigned char* data) {
+    return static_cast<uint32_t>(data[0]) | static_cast<uint32_t>(data[1]) << 8 |
+           static_cast<uint32_t>(data[2]) << 16 | static_cast<uint32_t>(data[3]) << 24;
+}
+
+uint64_t readU64(const unsigned char* data) {
+    return static_cast<uint64_t>(readU32(data)) | static_cast<uint64_t>(readU32(data + 4)) << 32;
+}
+
+// VkFormat values of the formats we upload; sRGB variants are sampled like their UNORM twins,
+// as the RGBA8 path does.
+bool formatFromVk(uint32_t vkFormat, TextureImage::Format* format) {
+    switch (vkFormat) {
+        case 37:  // VK_FORMAT_R8G8B8A8_UNORM
+        case 43:  // VK_FORMAT_R8G8B8A8_SRGB
+            *format = TextureImage::Format::RGBA8;
+            return true;
+        case 133:  // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+        case 134:
+            *format = TextureImage::Format::BC1;
+            return true;
+        case 137:  // VK_FORMAT_BC3_UNORM_BLOCK
+        case 138:
+            *format = TextureImage::Format::BC3;
+            return true;
+        case 145:  // VK_FORMAT_BC7_UNORM_BLOCK
+        case 146:
+            *format = TextureImage::Format::BC7;
+            return true;
+        case 147:  // VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+        case 148:
+            *format = TextureImage::Format::ETC2_RGB8;
+            return true;
+        case 151:  // VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK
+        case 152:
+            *format = TextureImage::Format::ETC2_RGBA8;
+            return true;
+        case 157:  // VK_FORMAT_ASTC_4x4_UNORM_BLOCK
+        case 158:
+            *format = TextureImage::Format::ASTC_4x4;
+            return true;
+        case 171:  // VK_FORMAT_ASTC_8x8_UNORM_BLOCK
+        case 172:
+            *format = TextureImage::Format::ASTC_8x8;
+            return true;
+        default:
+            return false;
+    }
+}
+
+// True unless the KTXorientation value says the rows run bottom up ("ru").
+bool rowsTopDown(const std::vector<unsigned char>& file, uint32_t kvdOffset, uint32_t kvdLength) {
+    const char kKey[] = "KTXorientation";
+    size_t pos = kvdOffset;
+    const size_t end = static_cast<size_t>(kvdOffset) + kvdLength;
+    while (pos + 4 <= end && end <= file.size()) {
+        const uint32_t length = readU32(file.data() + pos);
+        const size_t entry = pos + 4;
+        if (length > end - entry) break;
+        if (length > sizeof(kKey) && std::memcmp(file.data() + entry, kKey, sizeof(kKey)) == 0) {
+            const size_t value = entry + sizeof(kKey);
+            return !(value + 1 < entry + length && file[value + 1] == 'u');
+        }
+        pos = entry + ((length + 3) & ~3u);
+    }
+    return true;
+}
+
+void flipRows(std::vector<unsigned char>* pixels, int width, int height) {
+    const size_t stride = static_cast<size_t>(width) * 4;
+    for (int top = 0, bottom = height - 1; top < bottom; ++top, --bottom) {
+        std::swap_ranges(pixels->begin() + top * stride, pixels->begin() + (top + 1) * stride,
+                         pixels->begin() + bottom * stride);
+    }
+}
+
+}  // namespace
+
+bool isKtx2Path(const std::string& path) {
+    if (path.size() < 5) return false;
+    std::string extension = path.substr(path.size() - 5);
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension == ".ktx2";
+}
+
+bool loadKtx2(const std::string& path, TextureImage* image, std::string* error) {
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) {
+        *error = "cannot open " + path;
+        return false;
+    }
+    const std::vector<unsigned char> file((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    if (file.size() < kHeaderBytes || std::memcmp(file.data(), kIdentifier, sizeof(kIdentifier)) != 0) {
+        *error = path + " is not a KTX2 file";
+        return false;
+    }
+
+    const unsigned char* header = file.data() + sizeof(kIdentifier);
+    const uint32_t vkFormat = readU32(header);
+    const uint32_t width = readU32(header + 8);
+    const uint32_t height = readU32(header + 12);
+    const uint32_t depth = readU32(header + 16);
+    const uint32_t layers = readU32(header + 20);
+    const uint32_t faces = readU32(header + 24);
+    const uint32_t levelCount = readU32(header + 28);
+    const uint32_t supercompression = readU32(header + 32);
+    const uint32_t kvdOffset = readU32(header + 44);
+    const uint32_t kvdLength = readU32(header + 48);
+
+    TextureImage::Format format;
+    if (!formatFromVk(vkFormat, &format)) {
+        *error = path + ": unsupported VkFormat " + std::to_string(vkFormat);
+        return false;
+    }
+    if (supercompression != 0) {
+        *error = path + " is supercompressed; transcode it to a GPU format first";
+        return false;
+    }
+    if (width == 0 || height == 0 || width > 65536 || height > 65536 || depth > 1 || layers > 1 || faces != 1) {
+        *error = path + " is not a single 2D texture";
+        return false;
+    }
+
+    // No levels means the reader is to generate them.
+    const uint32_t levels = std::max(levelCount, 1u);
+    if (levels > 17 || kHeaderBytes + levels * kLevelIndexBytes > file.size()) {
+        *error = path + ": bad level index";
+        return false;
+    }
+
+    TextureImage result;
+    result.width = static_cast<int>(width);
+    result.height = static_cast<int>(height);
+    result.format = format;
+    result.generate_mipmaps = levelCount == 0;
+    const bool flip = format == TextureImage::Format::RGBA8 && rowsTopDown(file, kvdOffset, kvdLength);
+    for (uint32_t level = 0; level < levels; ++level) {
+        const unsigned char* entry = file.data() + kHeaderBytes + level * kLevelIndexBytes;
+        const uint64_t offset = readU64(entry);
+        const uint64_t length = readU64(entry + 8);
+        const int w = std::max(1, result.width >> level);
+        const int h = std::max(1, result.height >> level);
+        if (offset > file.size() || length > file.size() - offset ||
+            length != TextureImage::levelSize(format, w, h)) {
+            *error = path + ": bad data for level " + std::to_string(level);
+            return false;
+        }
+        std::vector<unsigned char> data(file.begin() + offset, file.begin() + offset + length);
+        if (flip) flipRows(&data, w, h);
+        if (level == 0) {
+            result.pixels = std::move(data);
+        } else {
+            result.mip_levels.push_back(std::move(data));
+        }
+    }
+
+    *image = std::move(result);
+    return true;
+}
+
+}  // namespace octo_flex
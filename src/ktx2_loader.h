@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef KTX2_LOADER_H
+#define KTX2_LOADER_H
+
+
+#include <string>
+
+#include "texture_image.h"
+
+namespace octo_flex {
+
+// Read a 2D KTX2 file into an image with all its mip levels, as RGBA8 or one of the compressed
+// TextureImage formats. Supercompressed files (Basis Universal, Zstandard) are not read; transcode
+// them to a GPU format first. Compressed blocks cannot be flipped, so they are expected with the
+// lower left at texture coordinate (0, 0), as written by `toktx --lower_left_maps_to_s0t0`; RGBA8
+// levels are flipped as needed. Returns false and sets error otherwise.
+bool loadKtx2(const std::string& path, TextureImage* image, std::string* error);
+
+// Whether the path names a KTX2 file, judging by its extension.
+bool isKtx2Path(const std::string& path);
+
+}  // namespace octo_flex
+
+#endif  // KTX2_LOADER_H
@@ -16,44 +16,135 @@
 
 
 #include "layer.h"
+#include <unordered_set>
+#include "bvh.h"
+#include "instanced_shape.h"
+#include "scalar_field.h"
+#include "textured_quad.h"
+#include "trace.h"
 
 namespace octo_flex {
+
+namespace {
+
+// Add an object to the counts: its shapes, instanced prototypes included, their bytes and those of
+// its scalar values, and the textures it draws that were not counted yet.
+void countObject(const Object& obj, LayerMemoryStats& stats, std::unordered_set<const void*>& textures) {
+    stats.objects++;
+    if (const auto& scalars = obj.scalars()) {
+        stats.cpu_bytes += scalars->count() * sizeof(float);
+        stats.gpu_buffer_bytes += scalars->gpuBytes();
+    }
+    for (const auto& shape : obj.shapes()) {
+        if (!shape) continue;
+        stats.shapes++;
+        stats.vertices += shape->vertexCount();
+        stats.cpu_bytes += shape->cpuBytes();
+        stats.gpu_buffer_bytes += shape->gpuBytes();
+        if (shape->type() == Shape::Instanced) {
+            for (const auto& proto : static_cast<const InstancedShape&>(*shape).prototype()) {
+                stats.shapes++;
+                stats.vertices += proto->vertexCount();
+            }
+        } else if (const auto* quad = dynamic_cast<const TexturedQuad*>(shape.get())) {
+            const void* key = quad->textureKey();
+            if (key && textures.insert(key).second) stats.texture_bytes += quad->textureBytes();
+        }
+    }
+}
+
+}  // namespace
+
+Layer::~Layer() {
+    if (!index_) return;
+    std::vector<ObjectHandle> handles;
+    handles.reserve(objects_.size());
+    for (const auto& [handle, obj] : objects_) {
+        handles.push_back(handle);
+    }
+    index_->remove(handles, this);
+}
+
 const std::string& Layer::id() const { return id_; }
 
-const ObjectList Layer::objects() {
-    ObjectList objects;
+const ObjectList Layer::objects() { return snapshot()->objects; }
+
+LayerSnapshotPtr Layer::snapshot() {
+    LayerSnapshotPtr snap = std::atomic_load(&snapshot_);
+    if (snap && snap->version == version_.load(std::memory_order_acquire)) {
+        return snap;
+    }
+
+    // Stale: publish a new snapshot (another reader may have done it already).
+    std::unique_lock<std::mutex> lock = traceLock(mtx_, "Layer lock wait");
+    snap = std::atomic_load(&snapshot_);
+    const uint64_t version = version_.load(std::memory_order_relaxed);
+    if (!snap || snap->version != version) {
+        auto fresh = std::make_shared<LayerSnapshot>();
+        fresh->version = version;
+        fresh->objects = objects_;
+        snap = fresh;
+        std::atomic_store(&snapshot_, snap);
+    }
+    return snap;
+}
 
-    std::unique_lock<std::mutex> lock(mtx_);
-    objects = objects_;
-    return objects;
+std::shared_ptr<const LayerBvh> Layer::bvh() {
+    LayerSnapshotPtr snap = snapshot();
+    LayerBvh::Ptr tree = std::atomic_load(&bvh_);
+    if (tree && tree->version() >= snap->version) {
+        return tree;
+    }
+
+    std::unique_lock<std::mutex> lock = traceLock(bvh_mtx_, "Layer BVH lock wait");
+    tree = std::atomic_load(&bvh_);
+    if (tree && tree->version() >= snap->version) {
+        return tree;
+    }
+    OCTO_FLEX_TRACE_ZONE("Layer::bvh");
+    LayerBvh::Ptr fresh = tree ? LayerBvh::refit(*tree, *snap) : nullptr;
+    if (!fresh) fresh = LayerBvh::build(*snap);
+    std::atomic_store(&bvh_, fresh);
+    return fresh;
 }
 
 void Layer::addObject(Object::Ptr obj) {
     if (obj == nullptr) return;
-    std::unique_lock<std::mutex> lock(mtx_);
+    std::unique_lock<std::mutex> lock = traceLock(mtx_, "Layer lock wait");
 
     // If an object with the same ID exists, move it to outdated list
-    auto it = objects_.find(obj->id());
-    if (it != objects_.end() && it->second != obj) {
+    auto it = objects_.find(obj->handle());
+    const bool added = it == objects_.end();
+    if (!added && it->second != obj) {
         outdated_objects_.push_back(it->second);
     }
 
-    objects_[obj->id()] = obj;
+    objects_[obj->handle()] = obj;
+    ++version_;
+    if (added && index_) index_->add({obj->handle()}, this);
 }
 
 void Layer::removeObject(std::string& object_id) {
-    std::unique_lock<std::mutex> lock(mtx_);
-    auto it = objects_.find(object_id);
+    const ObjectHandle handle = ObjectRegistry::instance().find(object_id);
+    if (handle == kNoObjectHandle) return;
+    std::unique_lock<std::mutex> lock = traceLock(mtx_, "Layer lock wait");
+    auto it = objects_.find(handle);
     if (it != objects_.end()) {
+        outdated_objects_.push_back(it->second);
         objects_.erase(it);
+        ++version_;
+        if (index_) index_->remove({handle}, this);
     }
 }
 
-Object::Ptr Layer::findObject(std::string id) {
+Object::Ptr Layer::findObject(std::string id) { return findObject(ObjectRegistry::instance().find(id)); }
+
+Object::Ptr Layer::findObject(ObjectHandle handle) {
     Object::Ptr obj = nullptr;
+    if (handle == kNoObjectHandle) return obj;
 
-    std::unique_lock<std::mutex> lock(mtx_);
-    auto it = objects_.find(id);
+    std::unique_lock<std::mutex> lock = traceLock(mtx_, "Layer lock wait");
+    auto it = objects_.find(handle);
     if (it != objects_.end()) {
         obj = it->second;
     }
@@ -61,22 +152,129 @@ Object::Ptr Layer::findObject(std::string id) {
 }
 
 void Layer::clear() {
-    std::unique_lock<std::mutex> lock(mtx_);
+    std::unique_lock<std::mutex> lock = traceLock(mtx_, "Layer lock wait");
+    std::vector<ObjectHandle> removed;
+    removed.reserve(objects_.size());
+    for (auto& [handle, obj] : objects_) {
+        outdated_objects_.push_back(obj);
+        removed.push_back(handle);
+    }
     objects_.clear();
+    ++version_;
+    if (index_) index_->remove(removed, this);
 }
 
 void Layer::setObjects(const std::vector<Object::Ptr>& objects) {
-    std::unique_lock<std::mutex> lock(mtx_);
-    objects_.clear();
+    std::unique_lock<std::mutex> lock = traceLock(mtx_, "Layer lock wait");
+    ObjectList previous;
+    previous.swap(objects_);
     for (auto& obj : objects) {
         if (obj != nullptr) {
-            objects_[obj->id()] = obj;
+            objects_[obj->handle()] = obj;
         }
     }
+
+    // Move replaced or dropped objects to outdated list
+    std::vector<ObjectHandle> removed;
+    for (auto& [handle, obj] : previous) {
+        auto it = objects_.find(handle);
+        if (it == objects_.end()) {
+            removed.push_back(handle);
+        }
+        if (it == objects_.end() || it->second != obj) {
+            outdated_objects_.push_back(obj);
+        }
+    }
+    ++version_;
+
+    if (index_) {
+        std::vector<ObjectHandle> added;
+        for (const auto& [handle, obj] : objects_) {
+            if (previous.find(handle) == previous.end()) added.push_back(handle);
+        }
+        index_->remove(removed, this);
+        index_->add(added, this);
+    }
 }
 
+void Layer::applyDelta(const std::vector<Object::Ptr>& upserts, const std::vector<std::string>& removed_ids) {
+    // IDs without a handle belong to no object, in this layer or any other.
+    std::vector<ObjectHandle> removed;
+    removed.reserve(removed_ids.size());
+    for (const auto& id : removed_ids) {
+        const ObjectHandle handle = ObjectRegistry::instance().find(id);
+        if (handle != kNoObjectHandle) removed.push_back(handle);
+    }
+
+    std::unique_lock<std::mutex> lock = traceLock(mtx_, "Layer lock wait");
+    bool changed = false;
+
+    // Move removed objects to outdated list
+    std::vector<ObjectHandle> left;
+    for (const ObjectHandle handle : removed) {
+        auto it = objects_.find(handle);
+        if (it != objects_.end()) {
+            outdated_objects_.push_back(it->second);
+            objects_.erase(it);
+            left.push_back(handle);
+            changed = true;
+        }
+    }
+
+    // Move replaced objects to outdated list
+    std::vector<ObjectHandle> added;
+    for (const auto& obj : upserts) {
+        if (obj == nullptr) continue;
+        auto it = objects_.find(obj->handle());
+        if (it == objects_.end()) {
+            objects_[obj->handle()] = obj;
+            added.push_back(obj->handle());
+            changed = true;
+        } else if (it->second != obj) {
+            outdated_objects_.push_back(it->second);
+            it->second = obj;
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        ++version_;
+    }
+    if (index_) {
+        index_->remove(left, this);
+        index_->add(added, this);
+    }
+}
+
+LayerMemoryStats Layer::memoryStats() {
+    LayerMemoryStats stats;
+    std::unordered_set<const void*> textures;
+    for (const auto& [handle, obj] : snapshot()->objects) {
+        countObject(*obj, stats, textures);
+    }
+    stats.layer_id = id_;
+
+    // Counted under the lock rather than copied, so only the view that collects outdated objects
+    // releases them. Their textures stay in the texture cache; only their buffers are pending.
+    LayerMemoryStats pending;
+    std::unordered_set<const void*> pending_textures;
+    {
+        std::unique_lock<std::mutex> lock = traceLock(mtx_, "Layer lock wait");
+        for (const auto& obj : outdated_objects_) {
+            countObject(*obj, pending, pending_textures);
+        }
+    }
+    stats.pending_objects = pending.objects;
+    stats.pending_bytes = pending.cpu_bytes + pending.gpu_buffer_bytes;
+    return stats;
+}
+
+uint64_t Layer::version() const { return version_.load(std::memory_order_acquire); }
+
+void Layer::touch() { ++version_; }
+
 std::vector<Object::Ptr> Layer::collectOutdatedObjects() {
-    std::unique_lock<std::mutex> lock(mtx_);
+    std::unique_lock<std::mutex> lock = traceLock(mtx_, "Layer lock wait");
     std::vector<Object::Ptr> result;
     result.swap(outdated_objects_);  // Move and clear in one operation
     return result;
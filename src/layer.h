@@ -18,22 +18,49 @@
 #ifndef LAYER_H
 #define LAYER_H
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
+#include "memory_stats.h"
 #include "object.h"
+#include "object_index.h"
 
 namespace octo_flex {
+
+class LayerBvh;
+
+// Immutable object set of a layer at one version, shared by readers without locking.
+struct LayerSnapshot {
+    uint64_t version = 0;
+    ObjectList objects;
+};
+typedef std::shared_ptr<const LayerSnapshot> LayerSnapshotPtr;
+
 class Layer {
    public:
     typedef std::shared_ptr<Layer> Ptr;
     const std::string& id() const;
 
-    Layer(std::string id) : id_(id) {}
+    // Layers of one manager share its index of which layer holds each object.
+    Layer(std::string id, ObjectIndex::Ptr index = nullptr) : id_(id), index_(std::move(index)) {}
+    ~Layer();
     const std::string& id() { return id_; }
 
     const ObjectList objects();
+
+    // Current snapshot; one atomic load when the layer is unchanged since it was last published.
+    // Writers only bump the version, the first reader after a change publishes the new snapshot.
+    LayerSnapshotPtr snapshot();
+
+    // Bounding volume hierarchy of the current snapshot for picking and region queries, published like
+    // snapshot(): refit in place when only objects' geometry changed, built again when the set changed.
+    std::shared_ptr<const LayerBvh> bvh();
+
+    // Objects are keyed by their handle, so they must be frozen before they are added.
     void addObject(Object::Ptr);
     void removeObject(std::string& object_id);
     void clear();
@@ -41,16 +68,35 @@ class Layer {
     // Replace all objects atomically (clear then add all)
     void setObjects(const std::vector<Object::Ptr>& objects);
 
+    // Upsert and remove objects atomically; untouched objects are kept as they are
+    void applyDelta(const std::vector<Object::Ptr>& upserts, const std::vector<std::string>& removed_ids);
+
     Object::Ptr findObject(std::string id);
+    Object::Ptr findObject(ObjectHandle handle);
+
+    // Content version, bumped on every change to the object set
+    uint64_t version() const;
+
+    // Bump the version for a change the object set does not show, e.g. an object that started moving by pose
+    void touch();
 
     // Outdated objects management (for deferred deletion)
     std::vector<Object::Ptr> collectOutdatedObjects();
 
+    // Counts and bytes of the current objects and of the outdated ones. Reads the sizes the shapes
+    // keep, without GL calls; the layer is locked only to copy the outdated list.
+    LayerMemoryStats memoryStats();
+
    private:
     ObjectList objects_;
     std::vector<Object::Ptr> outdated_objects_;  // Objects pending deletion
     std::string id_;
+    std::atomic<uint64_t> version_{0};
+    LayerSnapshotPtr snapshot_;  // Accessed with std::atomic_load / std::atomic_store
     std::mutex mtx_;
+    std::shared_ptr<const LayerBvh> bvh_;  // Accessed with std::atomic_load / std::atomic_store
+    std::mutex bvh_mtx_;                   // Serializes building, so writers never wait for it
+    ObjectIndex::Ptr index_;  // Told the handles gained and lost, under mtx_
 };
 typedef std::unordered_map<std::string, Layer::Ptr> LayerList;
 }  // namespace octo_flex
@@ -0,0 +1,397 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "layer_batch.h"
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <unordered_set>
+#include "gl_deletion_queue.h"
+#include "instanced_shape.h"
+#include "textured_quad.h"
+#include "utils.h"
+
+namespace octo_flex {
+namespace {
+typedef std::tuple<bool, LayerBatch::Primitive, double, bool> GroupKey;  // transparent, primitive, width, stipple
+
+Shape::GpuVertex makeVertex(const Shape& shape, size_t i) {
+    const Vec3& point = shape.points()[i];
+    const Vec3& color = shape.color(i);
+    return {static_cast<float>(point.x), static_cast<float>(point.y), static_cast<float>(point.z),
+            static_cast<float>(color.x), static_cast<float>(color.y), static_cast<float>(color.z),
+            static_cast<float>(shape.transparency())};
+}
+
+// Expand a shape into independent primitives so a whole group draws with one call.
+void appendShape(const Shape& shape, std::vector<Shape::GpuVertex>& out) {
+    const size_t n = shape.points().size();
+    switch (shape.type()) {
+        case Shape::Points:
+            for (size_t i = 0; i < n; ++i) out.push_back(makeVertex(shape, i));
+            break;
+        case Shape::Lines:
+        case Shape::Dash:
+            // Odd trailing vertex is ignored, as with GL_LINES.
+            for (size_t i = 0; i + 1 < n; i += 2) {
+                out.push_back(makeVertex(shape, i));
+                out.push_back(makeVertex(shape, i + 1));
+            }
+            break;
+        case Shape::Loop:
+            if (n < 2) break;
+            for (size_t i = 0; i < n; ++i) {
+                out.push_back(makeVertex(shape, i));
+                out.push_back(makeVertex(shape, (i + 1) % n));
+            }
+            break;
+        case Shape::Polygon:
+            // Triangulated when frozen (concave outlines and holes).
+            if (!shape.triangles().empty()) {
+                for (uint32_t i : shape.triangles()) out.push_back(makeVertex(shape, i));
+                break;
+            }
+            // Otherwise a triangle fan, matching GL_POLYGON for convex outlines.
+            for (size_t i = 1; i + 1 < n; ++i) {
+                out.push_back(makeVertex(shape, 0));
+                out.push_back(makeVertex(shape, i));
+                out.push_back(makeVertex(shape, i + 1));
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// Move vertices of a reference's mesh shape to where the reference places it, tinting their colors.
+void placeVertices(const InstancedShape& reference, Shape::GpuVertex* vertices, int count) {
+    const Vec3& position = reference.positions().front();
+    const Quaternion& orientation = reference.orientations().front();
+    const Vec3& scale = reference.scales().front();
+    for (int i = 0; i < count; ++i) {
+        Shape::GpuVertex& v = vertices[i];
+        const Vec3 local(v.x * scale.x, v.y * scale.y, v.z * scale.z);
+        const Vec3 p = quaternionRotateVector(orientation, local) + position;
+        const Vec3 color = reference.instanceColor(0, Vec3(v.r, v.g, v.b));
+        v.x = static_cast<float>(p.x);
+        v.y = static_cast<float>(p.y);
+        v.z = static_cast<float>(p.z);
+        v.r = static_cast<float>(color.x);
+        v.g = static_cast<float>(color.y);
+        v.b = static_cast<float>(color.z);
+    }
+}
+
+LayerBatch::Primitive primitiveFor(Shape::ShapeType type) {
+    switch (type) {
+        case Shape::Points:
+            return LayerBatch::Points;
+        case Shape::Polygon:
+            return LayerBatch::Triangles;
+        default:
+            return LayerBatch::Lines;
+    }
+}
+
+// Vertices of each render state, and the ranges of the objects they belong to.
+struct Bucket {
+    std::vector<Shape::GpuVertex> vertices;
+    std::vector<LayerBatch::ObjectRange> ranges;
+};
+
+// Vertices a group reserves for upserts beyond half its size, so small groups take some too.
+const int kMinHeadroom = 256;
+
+// Append the batchable shapes of an object to the buckets of their render states and note which
+// shapes it draws outside the batch.
+void expandObject(const Object& object, int objectIndex, std::map<GroupKey, Bucket>& buckets,
+                  LayerBatch::ObjectInfo& info) {
+    info.posed = object.isPosed();
+
+    // Append one shape's vertices to the bucket of its render state; references pass their mesh shapes.
+    auto append = [&](const Shape& shape, const InstancedShape* reference, int level) {
+        LayerBatch::Primitive primitive = primitiveFor(shape.type());
+        double width = (primitive == LayerBatch::Triangles) ? 1.0 : shape.width();
+        GroupKey key(shape.transparency() < 0.99, primitive, width, shape.type() == Shape::Dash);
+
+        Bucket& bucket = buckets[key];
+        const int first = static_cast<int>(bucket.vertices.size());
+        appendShape(shape, bucket.vertices);
+        const int count = static_cast<int>(bucket.vertices.size()) - first;
+        if (count == 0) return;
+        if (reference) placeVertices(*reference, bucket.vertices.data() + first, count);
+
+        // Shapes of one object are appended back to back, so extend its last range of the same level.
+        if (!bucket.ranges.empty() && bucket.ranges.back().object == objectIndex &&
+            bucket.ranges.back().level == level) {
+            bucket.ranges.back().count += count;
+        } else {
+            bucket.ranges.push_back({objectIndex, first, count, level});
+        }
+    };
+
+    // Scalar colors are looked up per draw, so such objects stay out of the batch like posed ones.
+    const bool unbatched = info.posed || object.scalars() != nullptr;
+    for (const auto& shape : object.shapes()) {
+        if (!shape || shape->vertexCount() == 0) continue;
+        if (unbatched || !LayerBatch::isBatchable(*shape)) {
+            // Instanced prototypes may mix opaque and transparent shapes.
+            if (shape->type() == Shape::Instanced) {
+                info.unbatchedOpaque = true;
+                info.unbatchedTransparent = true;
+            } else if (shape->transparency() < 0.99) {
+                info.unbatchedTransparent = true;
+            } else {
+                info.unbatchedOpaque = true;
+            }
+            continue;
+        }
+        if (shape->type() == Shape::Instanced) {
+            const auto& reference = static_cast<const InstancedShape&>(*shape);
+            for (const auto& part : reference.prototype()) {
+                append(*part, &reference, shape->lodLevel());
+            }
+        } else {
+            append(*shape, nullptr, shape->lodLevel());
+        }
+    }
+}
+
+int findGroup(const std::vector<LayerBatch::Group>& groups, const GroupKey& key) {
+    for (size_t g = 0; g < groups.size(); ++g) {
+        const LayerBatch::Group& group = groups[g];
+        if (GroupKey(group.transparent, group.primitive, group.width, group.stipple) == key) {
+            return static_cast<int>(g);
+        }
+    }
+    return -1;
+}
+}  // namespace
+
+LayerBatch::~LayerBatch() { releaseResources(); }
+
+bool LayerBatch::isBatchable(const Shape& shape) {
+    if (shape.type() == Shape::Instanced) {
+        // References merge like the shapes of their mesh; other instanced shapes keep their instanced draws.
+        const auto& instanced = static_cast<const InstancedShape&>(shape);
+        if (!instanced.isReference()) return false;
+        for (const auto& part : instanced.prototype()) {
+            if (!isBatchable(*part)) return false;
+        }
+        return true;
+    }
+    if (shape.type() == Shape::TexturedQuad || shape.type() == Shape::Instanced || shape.type() == Shape::PointCloud ||
+        shape.type() == Shape::Trajectory || shape.isPacked()) {
+        return false;
+    }
+    return dynamic_cast<const TexturedQuad*>(&shape) == nullptr;
+}
+
+void LayerBatch::build(const ObjectList& objects, uint64_t version) {
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    if (!context) {
+        // No context yet, will build later during rendering
+        return;
+    }
+
+    QOpenGLFunctions* gl = context->functions();
+    if (!update(gl, objects)) {
+        rebuild(gl, objects);
+    }
+    version_ = version;
+    built_ = true;
+}
+
+void LayerBatch::rebuild(QOpenGLFunctions* gl, const ObjectList& objects) {
+    std::map<GroupKey, Bucket> buckets;
+    objects_.clear();
+    objects_.reserve(objects.size());
+    object_infos_.clear();
+    object_infos_.reserve(objects.size());
+    indices_.clear();
+    for (const auto& [handle, object] : objects) {
+        if (!object) continue;
+        const int objectIndex = static_cast<int>(objects_.size());
+        indices_[handle] = objectIndex;
+        objects_.push_back(object);
+        expandObject(*object, objectIndex, buckets, object_infos_.emplace_back());
+    }
+
+    // Each group leaves headroom behind its vertices for objects upserted later.
+    groups_.clear();
+    std::vector<Shape::GpuVertex> vertices;
+    for (auto& [key, bucket] : buckets) {
+        if (bucket.vertices.empty()) continue;
+        Group group;
+        group.transparent = std::get<0>(key);
+        group.primitive = std::get<1>(key);
+        group.width = std::get<2>(key);
+        group.stipple = std::get<3>(key);
+        group.first = static_cast<int>(vertices.size());
+        group.count = static_cast<int>(bucket.vertices.size());
+        group.capacity = group.count + group.count / 2 + kMinHeadroom;
+        group.ranges = std::move(bucket.ranges);
+        for (auto& range : group.ranges) {
+            range.first += group.first;
+            group.leveled = group.leveled || range.level >= 0;
+        }
+        vertices.insert(vertices.end(), bucket.vertices.begin(), bucket.vertices.end());
+        vertices.resize(static_cast<size_t>(group.first + group.capacity));
+        groups_.push_back(std::move(group));
+    }
+
+    for (size_t g = 0; g < groups_.size(); ++g) {
+        if (!groups_[g].transparent) continue;
+        for (const auto& range : groups_[g].ranges) {
+            object_infos_[range.object].transparent.push_back(
+                {static_cast<int>(g), range.first, range.count, range.level});
+        }
+    }
+
+    if (vertex_buffer_id_ == 0) {
+        gl->glGenBuffers(1, &vertex_buffer_id_);
+        gl_group_ = GlDeletionQueue::instance()->currentGroup();
+    }
+    gl->glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_id_);
+    gl->glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertices.size() * sizeof(Shape::GpuVertex)),
+                     vertices.empty() ? nullptr : vertices.data(), GL_DYNAMIC_DRAW);
+    gl->glBindBuffer(GL_ARRAY_BUFFER, 0);
+    gpu_bytes_ = vertices.size() * sizeof(Shape::GpuVertex);
+}
+
+bool LayerBatch::update(QOpenGLFunctions* gl, const ObjectList& objects) {
+    if (!built_ || vertex_buffer_id_ == 0) return false;
+
+    // Removed objects would leave holes no later upsert fills; compact them away instead.
+    for (const auto& [handle, index] : indices_) {
+        auto found = objects.find(handle);
+        if (found == objects.end() || !found->second) return false;
+    }
+
+    // Upserted objects: replaced ones keep their index, new ones are appended.
+    struct Upsert {
+        int index;
+        bool replaced;
+        Object::Ptr object;
+        ObjectInfo info;
+    };
+    std::vector<Upsert> upserts;
+    std::map<GroupKey, Bucket> buckets;
+    int added = 0;
+    for (const auto& [handle, object] : objects) {
+        if (!object) continue;
+        auto found = indices_.find(handle);
+        if (found != indices_.end()) {
+            const int index = found->second;
+            if (objects_[index] == object && object_infos_[index].posed == object->isPosed()) continue;
+            upserts.push_back({index, true, object, {}});
+        } else {
+            upserts.push_back({static_cast<int>(objects_.size()) + added++, false, object, {}});
+        }
+        expandObject(*object, upserts.back().index, buckets, upserts.back().info);
+    }
+    if (upserts.empty()) return true;
+
+    // The vertices must fit the headroom of existing groups, and replaced ones stay behind as dead
+    // vertices; a group more than half dead is compacted by a rebuild.
+    std::vector<int> grown(groups_.size(), 0);
+    std::vector<int> dead(groups_.size(), 0);
+    std::vector<int> bucketGroups;
+    for (const auto& [key, bucket] : buckets) {
+        const int g = findGroup(groups_, key);
+        if (g < 0) return false;
+        bucketGroups.push_back(g);
+        grown[g] += static_cast<int>(bucket.vertices.size());
+    }
+    std::unordered_set<int> replaced;
+    for (const Upsert& upsert : upserts) {
+        if (upsert.replaced) replaced.insert(upsert.index);
+    }
+    auto isReplaced = [&replaced](const ObjectRange& range) { return replaced.count(range.object) > 0; };
+    for (size_t g = 0; g < groups_.size(); ++g) {
+        for (const auto& range : groups_[g].ranges) {
+            if (isReplaced(range)) dead[g] += range.count;
+        }
+    }
+    for (size_t g = 0; g < groups_.size(); ++g) {
+        const Group& group = groups_[g];
+        if (group.count + grown[g] > group.capacity) return false;
+        if (2 * (group.dead + dead[g]) > group.count + grown[g]) return false;
+    }
+
+    // Drop the ranges of replaced objects, then append the upserted vertices to their groups.
+    for (size_t g = 0; g < groups_.size(); ++g) {
+        if (dead[g] == 0) continue;
+        Group& group = groups_[g];
+        group.dead += dead[g];
+        group.ranges.erase(std::remove_if(group.ranges.begin(), group.ranges.end(), isReplaced), group.ranges.end());
+    }
+    for (Upsert& upsert : upserts) {
+        if (upsert.replaced) {
+            objects_[upsert.index] = std::move(upsert.object);
+            object_infos_[upsert.index] = std::move(upsert.info);
+        } else {
+            indices_[upsert.object->handle()] = upsert.index;
+            objects_.push_back(std::move(upsert.object));
+            object_infos_.push_back(std::move(upsert.info));
+        }
+    }
+
+    gl->glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer_id_);
+    size_t b = 0;
+    for (auto& [key, bucket] : buckets) {
+        const int g = bucketGroups[b++];
+        Group& group = groups_[g];
+        const int offset = group.first + group.count;
+        gl->glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(offset * sizeof(Shape::GpuVertex)),
+                            static_cast<GLsizeiptr>(bucket.vertices.size() * sizeof(Shape::GpuVertex)),
+                            bucket.vertices.data());
+        group.count += static_cast<int>(bucket.vertices.size());
+        for (ObjectRange range : bucket.ranges) {
+            range.first += offset;
+            group.leveled = group.leveled || range.level >= 0;
+            group.ranges.push_back(range);
+            if (group.transparent) {
+                object_infos_[range.object].transparent.push_back({g, range.first, range.count, range.level});
+            }
+        }
+    }
+    gl->glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return true;
+}
+
+void LayerBatch::releaseResources() {
+    if (vertex_buffer_id_ == 0) {
+        return;
+    }
+
+    GlDeletionQueue::instance()->deleteBuffers(gl_group_, {vertex_buffer_id_});
+    discardResources();
+}
+
+void LayerBatch::discardResources() {
+    vertex_buffer_id_ = 0;
+    gpu_bytes_ = 0;
+    objects_.clear();
+    groups_.clear();
+    object_infos_.clear();
+    indices_.clear();
+    built_ = false;
+}
+
+}  // namespace octo_flex
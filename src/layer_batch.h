@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef LAYER_BATCH_H
+#define LAYER_BATCH_H
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "layer.h"
+
+class QOpenGLFunctions;
+
+namespace octo_flex {
+
+// Merged vertex buffer for all batchable shapes of one layer, grouped by render state. Upserted
+// objects are written into the headroom each group keeps; removals, new render states and full
+// groups rebuild the buffer.
+class LayerBatch {
+   public:
+    typedef std::shared_ptr<LayerBatch> Ptr;
+
+    // Independent primitive types every batchable shape is expanded into.
+    enum Primitive { Points = 0, Lines, Triangles };
+
+    // Vertex range of one object inside a group.
+    struct ObjectRange {
+        int object;  // Index into objects()
+        int first;
+        int count;
+        int level;  // Shape::lodLevel() of its shapes, -1 for every level
+    };
+
+    // A contiguous vertex range sharing one render state.
+    struct Group {
+        Primitive primitive;
+        double width;
+        bool stipple;
+        bool transparent;
+        int first;
+        int count;
+        int capacity = 0;                 // Vertices reserved from first, headroom for upserts included
+        int dead = 0;                     // Vertices of replaced objects left in [first, first + count)
+        bool leveled = false;             // Whether any range belongs to one level of detail only
+        std::vector<ObjectRange> ranges;  // Ordered by first
+    };
+
+    // Transparent vertex range of one object, for per-object depth-sorted drawing.
+    struct TransparentRange {
+        int group;  // Index into groups()
+        int first;
+        int count;
+        int level;  // As in ObjectRange
+    };
+
+    // Per-object draw bookkeeping, indexed like objects().
+    struct ObjectInfo {
+        bool unbatchedOpaque = false;       // Has opaque shapes drawn outside the batch
+        bool unbatchedTransparent = false;  // Has transparent shapes drawn outside the batch
+        bool posed = false;                 // Moved by pose: all shapes drawn outside with its model matrix
+        std::vector<TransparentRange> transparent;
+
+        bool hasTransparent() const { return unbatchedTransparent || !transparent.empty(); }
+    };
+
+   public:
+    LayerBatch() {}
+    ~LayerBatch();
+
+    // Whether a shape is drawn through the batch (textured and instanced shapes are not, references are).
+    static bool isBatchable(const Shape& shape);
+
+    // Bring the batch up to the layer contents: upload only the objects added or replaced since the
+    // last build when they fit, else rebuild the groups and re-upload the whole vertex buffer.
+    void build(const ObjectList& objects, uint64_t version);
+
+    uint64_t version() const { return version_; }
+    bool isBuilt() const { return built_; }
+
+    // Objects of the layer at the built version, in batch order.
+    const std::vector<Object::Ptr>& objects() const { return objects_; }
+
+    const std::vector<Group>& groups() const { return groups_; }
+    const std::vector<ObjectInfo>& objectInfos() const { return object_infos_; }
+    unsigned int vertexBuffer() const { return vertex_buffer_id_; }
+    size_t gpuBytes() const { return gpu_bytes_; }  // Size of the vertex buffer, headroom included
+
+    // Release GPU buffer (called on the rendering thread).
+    void releaseResources();
+
+    // Forget the GPU buffer without deleting it, after the contexts that owned it were destroyed.
+    void discardResources();
+
+   private:
+    void rebuild(QOpenGLFunctions* gl, const ObjectList& objects);
+    // Append the upserted objects in place; false when the batch must be rebuilt instead.
+    bool update(QOpenGLFunctions* gl, const ObjectList& objects);
+
+    std::vector<Object::Ptr> objects_;
+    std::unordered_map<ObjectHandle, int> indices_;  // Index into objects_ by handle
+    std::vector<Group> groups_;
+    std::vector<ObjectInfo> object_infos_;
+    unsigned int vertex_buffer_id_ = 0;  // GL buffer name
+    uint32_t gl_group_ = 0;              // Share group the buffer was created in
+    size_t gpu_bytes_ = 0;
+    uint64_t version_ = 0;
+    bool built_ = false;
+};
+
+}  // namespace octo_flex
+
+#endif /* LAYER_BATCH_H */
@@ -0,0 +1,256 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "libav_encoder.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include "video_recorder.h"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/hwcontext.h>
+#include <libavutil/opt.h>
+#include <libswscale/swscale.h>
+}
+
+namespace octo_flex {
+namespace {
+
+std::string errorText(int code) {
+    char text[AV_ERROR_MAX_STRING_SIZE] = {0};
+    av_strerror(code, text, sizeof(text));
+    return text;
+}
+
+}  // namespace
+
+LibavEncoder::~LibavEncoder() { release(); }
+
+bool LibavEncoder::start(const VideoRecorderOptions& options, std::string* error) {
+    // A file this attempt created is removed again, so the next candidate can create it.
+    bool created = false;
+    auto fail = [&](const std::string& message) {
+        if (error) *error = message;
+        release();
+        if (created) QFile::remove(QString::fromStdString(options.outputPath));
+        return false;
+    };
+
+    codec_ = VideoEncoder::codecName(kind_, options.codec);
+    const AVCodec* codec = avcodec_find_encoder_by_name(codec_.c_str());
+    if (!codec) return fail("Encoder not available");
+
+    if (!options.overwrite && QFileInfo::exists(QString::fromStdString(options.outputPath))) {
+        return fail("Output file already exists");
+    }
+
+    int result = avformat_alloc_output_context2(&format_, nullptr, nullptr, options.outputPath.c_str());
+    if (result < 0 || !format_) return fail("Cannot create output: " + errorText(result));
+
+    context_ = avcodec_alloc_context3(codec);
+    context_->width = options.width;
+    context_->height = options.height;
+    context_->time_base = AVRational{1, options.fps};
+    context_->framerate = AVRational{options.fps, 1};
+    context_->gop_size = options.fps * 2;
+    if (format_->oformat->flags & AVFMT_GLOBALHEADER) {
+        context_->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+    }
+
+    // Rate control follows crf: constant quality where the encoder has it.
+    AVDictionary* codecOptions = nullptr;
+    AVPixelFormat softwareFormat = AV_PIX_FMT_YUV420P;
+    switch (kind_) {
+        case EncoderKind::NVENC:
+            av_dict_set(&codecOptions, "preset", VideoEncoder::nvencPreset(options.preset), 0);
+            av_dict_set(&codecOptions, "rc", "vbr", 0);
+            av_dict_set_int(&codecOptions, "cq", options.crf, 0);
+            context_->bit_rate = 0;
+            context_->pix_fmt = softwareFormat;
+            break;
+        case EncoderKind::VAAPI: {
+            // Frames are converted to NV12 and uploaded into a pool of VA surfaces.
+            softwareFormat = AV_PIX_FMT_NV12;
+            result = av_hwdevice_ctx_create(&device_, AV_HWDEVICE_TYPE_VAAPI, VideoEncoder::kVaapiDevice, nullptr, 0);
+            if (result < 0) return fail("Cannot open VA-API device: " + errorText(result));
+            AVBufferRef* frames = av_hwframe_ctx_alloc(device_);
+            auto* framesContext = reinterpret_cast<AVHWFramesContext*>(frames->data);
+            framesContext->format = AV_PIX_FMT_VAAPI;
+            framesContext->sw_format = softwareFormat;
+            framesContext->width = options.width;
+            framesContext->height = options.height;
+            framesContext->initial_pool_size = 8;
+            result = av_hwframe_ctx_init(frames);
+            if (result < 0) {
+                av_buffer_unref(&frames);
+                return fail("Cannot create VA-API surfaces: " + errorText(result));
+            }
+            context_->hw_frames_ctx = frames;
+            context_->pix_fmt = AV_PIX_FMT_VAAPI;
+            context_->global_quality = options.crf;
+            av_dict_set_int(&codecOptions, "qp", options.crf, 0);
+            break;
+        }
+        case EncoderKind::V4L2_M2M:
+            context_->bit_rate = VideoEncoder::constantBitrate(options);
+            context_->pix_fmt = softwareFormat;
+            break;
+        case EncoderKind::SOFTWARE:
+        default:
+            softwareFormat = options.enableAlpha ? AV_PIX_FMT_YUVA420P : AV_PIX_FMT_YUV420P;
+            av_dict_set(&codecOptions, "preset", options.preset.c_str(), 0);
+            av_dict_set_int(&codecOptions, "crf", options.crf, 0);
+            context_->pix_fmt = softwareFormat;
+            break;
+    }
+
+    result = avcodec_open2(context_, codec, &codecOptions);
+    av_dict_free(&codecOptions);
+    if (result < 0) return fail("Cannot open encoder: " + errorText(result));
+
+    stream_ = avformat_new_stream(format_, nullptr);
+    if (!stream_) return fail("Cannot create video stream");
+    stream_->time_base = context_->time_base;
+    avcodec_parameters_from_context(stream_->codecpar, context_);
+
+    if (!(format_->oformat->flags & AVFMT_NOFILE)) {
+        result = avio_open(&format_->pb, options.outputPath.c_str(), AVIO_FLAG_WRITE);
+        if (result < 0) return fail("Cannot open output file: " + errorText(result));
+        created = true;
+    }
+
+    // Fragmented MP4, like the ffmpeg command line recorder: a crash still leaves a playable file.
+    AVDictionary* muxOptions = nullptr;
+    av_dict_set(&muxOptions, "movflags", "frag_keyframe+empty_moov", 0);
+    result = avformat_write_header(format_, &muxOptions);
+    av_dict_free(&muxOptions);
+    if (result < 0) return fail("Cannot write header: " + errorText(result));
+    headerWritten_ = true;
+
+    const AVPixelFormat inputFormat =
+        options.inputFormat == QImage::Format_RGBA8888 ? AV_PIX_FMT_RGBA : AV_PIX_FMT_RGB24;
+    convert_ = sws_getContext(options.width, options.height, inputFormat, options.width, options.height,
+                              softwareFormat, SWS_BILINEAR, nullptr, nullptr, nullptr);
+    frame_ = av_frame_alloc();
+    packet_ = av_packet_alloc();
+    if (!convert_ || !frame_ || !packet_) return fail("Out of memory");
+    frame_->format = softwareFormat;
+    frame_->width = options.width;
+    frame_->height = options.height;
+    result = av_frame_get_buffer(frame_, 0);
+    if (result < 0) return fail("Cannot allocate frame: " + errorText(result));
+
+    nextPts_ = 0;
+    return true;
+}
+
+bool LibavEncoder::writeFrame(const QImage& frame, std::string* error) {
+    if (!context_ || !frame_) {
+        if (error) *error = "Encoder is not running";
+        return false;
+    }
+
+    // The encoder may still reference the previous frame's buffers.
+    int result = av_frame_make_writable(frame_);
+    if (result < 0) {
+        if (error) *error = "Cannot reuse frame: " + errorText(result);
+        return false;
+    }
+    const uint8_t* source[1] = {frame.constBits()};
+    const int sourceStride[1] = {static_cast<int>(frame.bytesPerLine())};
+    sws_scale(convert_, source, sourceStride, 0, frame.height(), frame_->data, frame_->linesize);
+    frame_->pts = nextPts_++;
+
+    if (!context_->hw_frames_ctx) {
+        return encode(frame_, error);
+    }
+
+    // VAAPI: copy the converted frame into a VA surface.
+    AVFrame* surface = av_frame_alloc();
+    result = surface ? av_hwframe_get_buffer(context_->hw_frames_ctx, surface, 0) : AVERROR(ENOMEM);
+    if (result >= 0) result = av_hwframe_transfer_data(surface, frame_, 0);
+    if (result < 0) {
+        av_frame_free(&surface);
+        if (error) *error = "Cannot upload frame: " + errorText(result);
+        return false;
+    }
+    surface->pts = frame_->pts;
+    const bool ok = encode(surface, error);
+    av_frame_free(&surface);
+    return ok;
+}
+
+bool LibavEncoder::encode(AVFrame* frame, std::string* error) {
+    int result = avcodec_send_frame(context_, frame);
+    if (result < 0) {
+        if (error) *error = "Cannot encode frame: " + errorText(result);
+        return false;
+    }
+    while (true) {
+        result = avcodec_receive_packet(context_, packet_);
+        if (result == AVERROR(EAGAIN) || result == AVERROR_EOF) return true;
+        if (result < 0) {
+            if (error) *error = "Cannot encode frame: " + errorText(result);
+            return false;
+        }
+        av_packet_rescale_ts(packet_, context_->time_base, stream_->time_base);
+        packet_->stream_index = stream_->index;
+        result = av_interleaved_write_frame(format_, packet_);
+        if (result < 0) {
+            if (error) *error = "Cannot write packet: " + errorText(result);
+            return false;
+        }
+    }
+}
+
+bool LibavEncoder::stop(std::string* error) {
+    if (!context_) {
+        return true;
+    }
+
+    // Drain the frames the encoder still holds, then finish the file.
+    bool ok = !headerWritten_ || encode(nullptr, error);
+    if (headerWritten_) {
+        const int result = av_write_trailer(format_);
+        if (result < 0 && ok) {
+            if (error) *error = "Cannot finish output file: " + errorText(result);
+            ok = false;
+        }
+    }
+    release();
+    return ok;
+}
+
+void LibavEncoder::release() {
+    if (format_ && format_->pb && !(format_->oformat->flags & AVFMT_NOFILE)) {
+        avio_closep(&format_->pb);
+    }
+    avformat_free_context(format_);
+    format_ = nullptr;
+    stream_ = nullptr;
+    avcodec_free_context(&context_);
+    av_buffer_unref(&device_);
+    sws_freeContext(convert_);
+    convert_ = nullptr;
+    av_frame_free(&frame_);
+    av_packet_free(&packet_);
+    headerWritten_ = false;
+}
+
+}  // namespace octo_flex
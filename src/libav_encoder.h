@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef LIBAV_ENCODER_H
+#define LIBAV_ENCODER_H
+
+#include <cstdint>
+#include <string>
+#include "video_encoder.h"
+
+struct AVBufferRef;
+struct AVCodecContext;
+struct AVFormatContext;
+struct AVFrame;
+struct AVPacket;
+struct AVStream;
+struct SwsContext;
+
+namespace octo_flex {
+
+// Encodes and muxes in-process with libavcodec/libavformat: frames go from the recorder's memory
+// through one color conversion straight into the encoder, without a pipe or ffmpeg process.
+// Hardware kinds open the matching libavcodec encoder (VAAPI uploads each frame to a VA surface).
+class LibavEncoder : public VideoEncoder {
+   public:
+    explicit LibavEncoder(EncoderKind kind) : kind_(kind) {}
+    ~LibavEncoder() override;
+
+    bool start(const VideoRecorderOptions& options, std::string* error) override;
+    bool writeFrame(const QImage& frame, std::string* error) override;
+    bool stop(std::string* error) override;
+    std::string name() const override { return "libav:" + codec_; }
+
+   private:
+    // Send a frame (null to flush) and write the packets it completes.
+    bool encode(AVFrame* frame, std::string* error);
+    void release();
+
+    EncoderKind kind_;
+    std::string codec_;
+    AVFormatContext* format_ = nullptr;
+    AVCodecContext* context_ = nullptr;
+    AVStream* stream_ = nullptr;
+    AVBufferRef* device_ = nullptr;  // VAAPI device
+    SwsContext* convert_ = nullptr;
+    AVFrame* frame_ = nullptr;  // Converted frame in the encoder's software format
+    AVPacket* packet_ = nullptr;
+    int64_t nextPts_ = 0;
+    bool headerWritten_ = false;
+};
+
+}  // namespace octo_flex
+
+#endif /* LIBAV_ENCODER_H */
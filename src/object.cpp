@@ -16,6 +16,7 @@
 
 
 #include "object.h"
+#include <algorithm>
 
 #include "def.h"
 #include "utils.h"
@@ -23,14 +24,46 @@
 namespace octo_flex {
 Object::Object(ObjectId id) : editable_(true), id_(id) { setInfo(id); }
 
+Object::~Object() { ObjectRegistry::instance().release(handle_); }
+
 bool Object::isEditable() const { return editable_; }
 void Object::setInEditable() {
+    if (!editable_) return;
     editable_ = false;
+    handle_ = ObjectRegistry::instance().acquire(id_);
+    bounds_ = BoundingBox();
     for (const auto& shape : shapes_) {
         if (shape) {
             shape->setInEditable();
+            if (shape->type() == Shape::Trajectory) {
+                live_bounds_ = true;  // Read from the trajectory on every call
+            } else {
+                bounds_.expand(shape->bounds());
+            }
+        }
+    }
+}
+
+BoundingBox Object::bounds() const {
+    BoundingBox local = bounds_;
+    if (live_bounds_) {
+        for (const auto& shape : shapes_) {
+            if (shape && shape->type() == Shape::Trajectory) local.expand(shape->bounds());
         }
     }
+    if (!isPosed() || !local.valid) return local;
+
+    // Rigid transform: the moved corners bound the moved geometry.
+    const float* m = pose()->model;
+    BoundingBox box;
+    for (int corner = 0; corner < 8; ++corner) {
+        const double x = (corner & 1) ? local.max.x : local.min.x;
+        const double y = (corner & 2) ? local.max.y : local.min.y;
+        const double z = (corner & 4) ? local.max.z : local.min.z;
+        box.expand(Vec3(m[0] * x + m[4] * y + m[8] * z + m[12], m[1] * x + m[5] * y + m[9] * z + m[13],
+                        m[2] * x + m[6] * y + m[10] * z + m[14]));
+    }
+    return box;
 }
 
 void Object::addShape(Shape::Ptr shape) {
@@ -44,10 +77,17 @@ void Object::resetTransform() {
     orientation_ = Quaternion();
 }
 
+void Object::setBuiltPose(const Vec3& position, const Quaternion& orientation) {
+    if (!editable_) return;
+    position_ = position;
+    orientation_ = orientation;
+}
+
 void Object::merge(const Object::Ptr obj) {
     if (!editable_ || !obj || !obj->isEditable()) return;
     shapes_.insert(shapes_.end(), obj->shapes_.begin(), obj->shapes_.end());
     obj->shapes_.clear();
+    if (lod_sizes_.empty()) lod_sizes_ = obj->lod_sizes_;
 }
 
 Object::Ptr Object::clone() {
@@ -58,15 +98,87 @@ Object::Ptr Object::clone() {
     }
     new_obj->position_ = position_;
     new_obj->orientation_ = orientation_;
+    if (isPosed()) {
+        // A clone is editable, so the pose is baked into its copied points.
+        auto current = pose();
+        new_obj->setPose(current->position, current->orientation);
+    }
     new_obj->info_ = info_;
     new_obj->detail_ = detail_;
     new_obj->text_color_ = text_color_;
+    new_obj->lod_sizes_ = lod_sizes_;
+    new_obj->scalars_ = scalars_;  // Shared, so updates by ID reach whichever copy is submitted
 
     return new_obj;
 }
 
-const Vec3& Object::position() const { return position_; }
-const Quaternion& Object::orientation() const { return orientation_; }
+void Object::setScalars(std::shared_ptr<ScalarField> scalars) {
+    if (!editable_) return;
+    scalars_ = std::move(scalars);
+}
+
+void Object::setLodSizes(const std::vector<float>& sizes) {
+    if (!editable_) return;
+    lod_sizes_ = sizes;
+}
+
+int Object::lodLevelFor(float pixels, int current, float hysteresis) const {
+    const int count = static_cast<int>(lod_sizes_.size());
+    int level = 0;
+    while (level < count && pixels < lod_sizes_[level]) {
+        ++level;
+    }
+    if (current < 0 || current > count || level == current || hysteresis <= 0.0f) return level;
+
+    // Leave the current level only once the size is clearly past the switch size bounding it.
+    if (level < current) {
+        return pixels >= lod_sizes_[current - 1] * (1.0f + hysteresis) ? level : current;
+    }
+    return pixels < lod_sizes_[current] * (1.0f - hysteresis) ? level : current;
+}
+
+Vec3 Object::position() const { return isPosed() ? pose()->position : position_; }
+Quaternion Object::orientation() const { return isPosed() ? pose()->orientation : orientation_; }
+
+std::shared_ptr<const Object::Pose> Object::pose() const { return std::atomic_load(&pose_); }
+
+void Object::setPose(const Vec3& position, const Quaternion& orientation) {
+    // Rotation from the built orientation to the new one.
+    Quaternion inverse(-orientation_.x, -orientation_.y, -orientation_.z, orientation_.w);
+    Quaternion delta = quaternionMultiply(orientation, inverse);
+    delta.normalize();
+
+    if (editable_) {
+        // rotate() also turns the position, move() then lands it on the target.
+        rotate(delta);
+        move(position - position_);
+        return;
+    }
+
+    auto pose = std::make_shared<Pose>();
+    pose->position = position;
+    pose->orientation = orientation;
+
+    const double x = delta.x, y = delta.y, z = delta.z, w = delta.w;
+    const Vec3 rotated = quaternionRotateVector(delta, position_);
+    const double m[16] = {1 - 2 * (y * y + z * z), 2 * (x * y + w * z), 2 * (x * z - w * y), 0,
+                          2 * (x * y - w * z), 1 - 2 * (x * x + z * z), 2 * (y * z + w * x), 0,
+                          2 * (x * z + w * y), 2 * (y * z - w * x), 1 - 2 * (x * x + y * y), 0,
+                          position.x - rotated.x, position.y - rotated.y, position.z - rotated.z, 1};
+    for (int i = 0; i < 16; ++i) {
+        pose->model[i] = static_cast<float>(m[i]);
+    }
+
+    std::atomic_store(&pose_, std::shared_ptr<const Pose>(std::move(pose)));
+    posed_.store(true, std::memory_order_release);
+}
+
+bool Object::modelMatrix(float matrix[16]) const {
+    if (!isPosed()) return false;
+    auto current = pose();
+    std::copy(current->model, current->model + 16, matrix);
+    return true;
+}
 
 Vec3 Object::textColor() const { return text_color_; }
 
@@ -18,13 +18,18 @@
 #ifndef OBJECT_H
 #define OBJECT_H
 
+#include <atomic>
+#include <memory>
 #include <vector>
 
 #include <unordered_map>
 #include "def.h"
+#include "object_registry.h"
 #include "shape.h"
 
 namespace octo_flex {
+class ScalarField;
+
 class Object {
    public:
     typedef std::shared_ptr<Object> Ptr;
@@ -32,7 +37,10 @@ class Object {
    public:
     Object(ObjectId id);
     const ObjectId& id() const { return id_; }
-    virtual ~Object(){};
+    virtual ~Object();
+
+    // Interned handle of id(), assigned when the object is frozen (kNoObjectHandle while editable).
+    ObjectHandle handle() const { return handle_; }
 
     const std::string& info() const;
     void setInfo(const std::string& info, const Vec3 color = Vec3(0.2, 0.2, 0.2));
@@ -45,30 +53,88 @@ class Object {
     void addShape(Shape::Ptr shape);
     const std::vector<Shape::Ptr>& shapes() const;
 
+    // Projected diameters in pixels switching between the levels of detail of its shapes (see
+    // Shape::lodLevel()), largest first: level i is drawn down to sizes[i], the last level below them all.
+    // Empty for objects without levels. Editable objects only.
+    void setLodSizes(const std::vector<float>& sizes);
+    const std::vector<float>& lodSizes() const { return lod_sizes_; }
+
+    // Level to draw at a projected diameter. With the level drawn last and a hysteresis fraction, the
+    // level only changes once the size is that fraction past the switch size, so it does not flicker.
+    int lodLevelFor(float pixels, int current = -1, float hysteresis = 0.0f) const;
+
+    // Float attribute mapped to the colors of the shapes at draw time (see ScalarField); null without one.
+    // Objects with one are drawn outside the layer batches. Editable objects only.
+    void setScalars(std::shared_ptr<ScalarField> scalars);
+    const std::shared_ptr<ScalarField>& scalars() const { return scalars_; }
+
     void move(const Vec3& vec);
     void rotate(const Quaternion& quad);
 
     bool isEditable() const;
     void setInEditable();
 
+    // World-space bounds of all shape points, computed when the object is frozen and moved with its pose.
+    // Trajectories are included with the points they hold at the time of the call.
+    BoundingBox bounds() const;
+
+    // Whether bounds() follows trajectory shapes, so it can change without the object changing.
+    bool hasLiveBounds() const { return live_bounds_; }
+
     void resetTransform();
 
-    const Vec3& position() const;
-    const Quaternion& orientation() const;
+    // Pose the shapes are built at; position() and orientation() differ from it once a frozen object is posed.
+    Vec3 builtPosition() const { return position_; }
+    Quaternion builtOrientation() const { return orientation_; }
+
+    // Record the pose the shapes are already built at without moving them, e.g. when restoring a saved
+    // object. Editable objects only.
+    void setBuiltPose(const Vec3& position, const Quaternion& orientation);
+
+    // Current pose; after setPose on a frozen object this is the pose applied at draw time.
+    Vec3 position() const;
+    Quaternion orientation() const;
+
+    // Move the object to a new pose. Editable objects move their points; frozen objects keep their
+    // geometry and get a model matrix instead, so this is cheap and may be called from any thread.
+    void setPose(const Vec3& position, const Quaternion& orientation);
+
+    // Whether a frozen object was moved by setPose and must be drawn with modelMatrix().
+    bool isPosed() const { return posed_.load(std::memory_order_acquire); }
+
+    // Column-major model matrix from the built geometry to the current pose; false if not posed.
+    bool modelMatrix(float matrix[16]) const;
 
    private:
+    // Pose of a frozen object and its matrix relative to the built geometry, replaced as a whole.
+    struct Pose {
+        Vec3 position;
+        Quaternion orientation;
+        float model[16];
+    };
+
+    std::shared_ptr<const Pose> pose() const;
+
     Vec3 position_;
     Quaternion orientation_;
+    BoundingBox bounds_;       // Of the shapes other than trajectories
+    bool live_bounds_ = false;  // Has trajectory shapes
+    std::shared_ptr<const Pose> pose_;  // Accessed with std::atomic_load / std::atomic_store
+    std::atomic<bool> posed_{false};
 
     bool editable_;
     ObjectId id_;
+    ObjectHandle handle_ = kNoObjectHandle;  // Holds a registry reference
     std::string info_;
     std::string detail_;
     Vec3 text_color_;
     std::vector<Shape::Ptr> shapes_;
+    std::vector<float> lod_sizes_;
+    std::shared_ptr<ScalarField> scalars_;
 };
 
-typedef std::unordered_map<std::string, Object::Ptr> ObjectList;
+// Objects of a layer by handle.
+typedef std::unordered_map<ObjectHandle, Object::Ptr> ObjectList;
 }  // namespace octo_flex
 
 #endif /* OBJECT_H */
@@ -17,13 +17,15 @@
 #include "object_builder.h"
 
 #include <cmath>
+#include <functional>
 #include <iostream>
 
-#include <QImage>
-#include <QString>
-
+#include "instanced_shape.h"
+#include "point_cloud_shape.h"
+#include "scalar_field.h"
 #include "shape.h"
 #include "textured_quad.h"
+#include "trajectory_shape.h"
 #include "utils.h"
 
 namespace octo_flex {
@@ -42,54 +44,24 @@ ObjectBuilder ObjectBuilder::begin(const std::string& id) { return ObjectBuilder
 // ============================================================================
 
 ObjectBuilder& ObjectBuilder::sphere(const Vec3& color, double radius, bool transparent) {
-    // Generate sphere shape and add to object
-    auto sphere_obj = generateSphere("temp", color, radius, transparent);
-    for (const auto& shape : sphere_obj->shapes()) {
-        applyPendingShapeTransform(shape);  // Phase 1 - applies WITHOUT resetting
-        object_->addShape(shape);
-    }
-    resetPendingShapeTransform();  // Reset after all shapes from this primitive
-    return *this;
+    return addMesh(UnitMesh::Sphere, Vec3(radius, radius, radius), color, transparent);
 }
 
 ObjectBuilder& ObjectBuilder::box(const Vec3& color, double width, double height, double depth, bool transparent) {
-    auto box_obj = generateCubic("temp", color, width, height, depth, transparent);
-    for (const auto& shape : box_obj->shapes()) {
-        applyPendingShapeTransform(shape);  // Phase 1 - applies WITHOUT resetting
-        object_->addShape(shape);
-    }
-    resetPendingShapeTransform();  // Reset after all shapes from this primitive
-    return *this;
+    return addMesh(UnitMesh::Box, Vec3(width, height, depth), color, transparent);
 }
 
 ObjectBuilder& ObjectBuilder::cylinder(const Vec3& color, double radius, double height, bool transparent) {
-    auto cylinder_obj = generateCylinder("temp", color, radius, height, transparent);
-    for (const auto& shape : cylinder_obj->shapes()) {
-        applyPendingShapeTransform(shape);  // Phase 1 - applies WITHOUT resetting
-        object_->addShape(shape);
-    }
-    resetPendingShapeTransform();  // Reset after all shapes from this primitive
-    return *this;
+    return addMesh(UnitMesh::Cylinder, Vec3(radius, radius, height), color, transparent);
 }
 
 ObjectBuilder& ObjectBuilder::cone(const Vec3& color, double radius, double height, bool transparent) {
-    auto cone_obj = generateCone("temp", color, radius, height, transparent);
-    for (const auto& shape : cone_obj->shapes()) {
-        applyPendingShapeTransform(shape);  // Phase 1 - applies WITHOUT resetting
-        object_->addShape(shape);
-    }
-    resetPendingShapeTransform();  // Reset after all shapes from this primitive
-    return *this;
+    return addMesh(UnitMesh::Cone, Vec3(radius, radius, height), color, transparent);
 }
 
 ObjectBuilder& ObjectBuilder::pyramid(const Vec3& color, double width, double height, double depth, bool transparent) {
-    auto pyramid_obj = generatePyramid("temp", color, width, height, depth, transparent);
-    for (const auto& shape : pyramid_obj->shapes()) {
-        applyPendingShapeTransform(shape);  // Phase 1 - applies WITHOUT resetting
-        object_->addShape(shape);
-    }
-    resetPendingShapeTransform();  // Reset after all shapes from this primitive
-    return *this;
+    // Base width along X and depth along Y, apex at height on Z.
+    return addMesh(UnitMesh::Pyramid, Vec3(width, depth, height), color, transparent);
 }
 
 ObjectBuilder& ObjectBuilder::arrow(const Vec3& color, double length, double shaft_radius, double head_width,
@@ -123,32 +95,72 @@ ObjectBuilder& ObjectBuilder::simpleArrow(const Vec3& color, double length, doub
 }
 
 ObjectBuilder& ObjectBuilder::quad(const Vec3& color, double width, double height, bool transparent) {
-    auto quad_obj = generateQuad("temp", color, width, height, transparent);
-    for (const auto& shape : quad_obj->shapes()) {
-        applyPendingShapeTransform(shape);  // Phase 1 - applies WITHOUT resetting
-        object_->addShape(shape);
-    }
-    resetPendingShapeTransform();  // Reset after all shapes from this primitive
-    return *this;
+    return addMesh(UnitMesh::Quad, Vec3(width, height, 1.0), color, transparent);
 }
 
 ObjectBuilder& ObjectBuilder::ellipsoid(const Vec3& color, double radius_x, double radius_y, double radius_z,
                                         bool transparent) {
-    auto ellipsoid_obj = generateEllipsoid("temp", color, radius_x, radius_y, radius_z, transparent);
-    for (const auto& shape : ellipsoid_obj->shapes()) {
+    return addMesh(UnitMesh::Sphere, Vec3(radius_x, radius_y, radius_z), color, transparent);
+}
+
+ObjectBuilder& ObjectBuilder::capsule(const Vec3& color, double radius, double height, bool transparent) {
+    return addPrimitive([&](int segments) {
+        return generateCapsule("temp", color, radius, height, transparent, segments);
+    });
+}
+
+ObjectBuilder& ObjectBuilder::withDetailLevels(const std::vector<int>& segments,
+                                               const std::vector<double>& switch_pixels) {
+    if (has_lod_shapes_) {
+        std::cerr << "Error: withDetailLevels() must be called before the primitives it applies to" << std::endl;
+        return *this;
+    }
+    bool valid = !segments.empty() && switch_pixels.size() + 1 == segments.size();
+    for (size_t i = 0; valid && i < segments.size(); ++i) {
+        valid = segments[i] >= 3;
+    }
+    for (size_t i = 0; valid && i < switch_pixels.size(); ++i) {
+        valid = switch_pixels[i] > 0 && (i == 0 || switch_pixels[i] < switch_pixels[i - 1]);
+    }
+    if (!valid) {
+        std::cerr << "Error: withDetailLevels() needs segment counts >= 3 and one decreasing switch size "
+                     "between each pair of levels"
+                  << std::endl;
+        return *this;
+    }
+    lod_segments_ = segments;
+    lod_pixels_.assign(switch_pixels.begin(), switch_pixels.end());
+    return *this;
+}
+
+ObjectBuilder& ObjectBuilder::addMesh(UnitMesh type, const Vec3& size, const Vec3& color, bool transparent) {
+    // Shapes reference one cached unit mesh per level instead of owning their geometry.
+    const bool curved = type == UnitMesh::Sphere || type == UnitMesh::Cylinder || type == UnitMesh::Cone;
+    const size_t levels = curved ? lod_segments_.size() : 1;
+    for (size_t level = 0; level < levels; ++level) {
+        auto mesh = unitMesh(type, curved ? lod_segments_[level] : 0, false, transparent);
+        auto shape = InstancedShape::reference(mesh, Vec3(0, 0, 0), Quaternion(), size, color);
+        if (levels > 1) shape->setLodLevel(static_cast<int>(level));
         applyPendingShapeTransform(shape);  // Phase 1 - applies WITHOUT resetting
         object_->addShape(shape);
     }
+    has_lod_shapes_ = has_lod_shapes_ || levels > 1;
     resetPendingShapeTransform();  // Reset after all shapes from this primitive
     return *this;
 }
 
-ObjectBuilder& ObjectBuilder::capsule(const Vec3& color, double radius, double height, bool transparent) {
-    auto capsule_obj = generateCapsule("temp", color, radius, height, transparent);
-    for (const auto& shape : capsule_obj->shapes()) {
-        applyPendingShapeTransform(shape);  // Phase 1 - applies WITHOUT resetting
-        object_->addShape(shape);
+ObjectBuilder& ObjectBuilder::addPrimitive(const std::function<std::shared_ptr<Object>(int segments)>& generate) {
+    // Every level is generated up front; the viewer draws one of them per frame by projected size.
+    const bool leveled = lod_segments_.size() > 1;
+    for (size_t level = 0; level < lod_segments_.size(); ++level) {
+        auto primitive = generate(lod_segments_[level]);
+        for (const auto& shape : primitive->shapes()) {
+            if (leveled) shape->setLodLevel(static_cast<int>(level));
+            applyPendingShapeTransform(shape);  // Phase 1 - applies WITHOUT resetting
+            object_->addShape(shape);
+        }
     }
+    has_lod_shapes_ = has_lod_shapes_ || leveled;
     resetPendingShapeTransform();  // Reset after all shapes from this primitive
     return *this;
 }
@@ -177,6 +189,26 @@ ObjectBuilder& ObjectBuilder::points(const std::vector<Vec3>& points, const std:
     return *this;
 }
 
+ObjectBuilder& ObjectBuilder::pointCloud(std::vector<PackedVertex>&& vertices, double point_size) {
+    auto shape = std::make_shared<PointCloudShape>(point_size);
+    shape->setPackedVertices(std::move(vertices));
+    applyPendingShapeTransform(shape);  // Phase 1
+    object_->addShape(shape);
+    resetPendingShapeTransform();  // Reset after single shape
+    return *this;
+}
+
+ObjectBuilder& ObjectBuilder::pointCloud(const float* xyz, size_t count, const Vec3& color, const uint8_t* rgba,
+                                         double point_size) {
+    auto shape = std::make_shared<PointCloudShape>(point_size);
+    shape->setPointsWithColor({}, color);  // Fallback color for points without rgba
+    shape->setPackedPoints(xyz, count, rgba);
+    applyPendingShapeTransform(shape);  // Phase 1
+    object_->addShape(shape);
+    resetPendingShapeTransform();  // Reset after single shape
+    return *this;
+}
+
 ObjectBuilder& ObjectBuilder::lines(const std::vector<Vec3>& points, const Vec3& color, double line_width,
                                     bool transparent) {
     auto shape = std::make_shared<Shape>(Shape::Lines, line_width, transparent ? 0.8 : 1.0);
@@ -256,61 +288,91 @@ ObjectBuilder& ObjectBuilder::polygon(const std::vector<Vec3>& points, const std
     return *this;
 }
 
+ObjectBuilder& ObjectBuilder::polygon(const std::vector<Vec3>& outer, const std::vector<std::vector<Vec3>>& holes,
+                                      const Vec3& color, bool transparent) {
+    // Rings are stored back to back; each hole is recorded by its first vertex index.
+    std::vector<Vec3> points = outer;
+    std::vector<size_t> hole_starts;
+    for (const auto& hole : holes) {
+        if (hole.size() < 3) continue;
+        hole_starts.push_back(points.size());
+        points.insert(points.end(), hole.begin(), hole.end());
+    }
+
+    auto shape = std::make_shared<Shape>(Shape::Polygon, 1.0, transparent ? 0.8 : 1.0);
+    shape->setPointsWithColor(points, color);
+    shape->setHoles(hole_starts);
+    applyPendingShapeTransform(shape);  // Phase 1
+    object_->addShape(shape);
+    resetPendingShapeTransform();  // Reset after single shape
+    return *this;
+}
+
+ObjectBuilder& ObjectBuilder::trajectory(std::shared_ptr<Trajectory> trajectory, double line_width) {
+    if (!trajectory) {
+        std::cerr << "Error: trajectory() requires a trajectory" << std::endl;
+        return *this;
+    }
+    auto shape = std::make_shared<TrajectoryShape>(std::move(trajectory), true, line_width);
+    applyPendingShapeTransform(shape);  // Phase 1
+    object_->addShape(shape);
+    resetPendingShapeTransform();  // Reset after single shape
+    return *this;
+}
+
+ObjectBuilder& ObjectBuilder::trajectoryPoints(std::shared_ptr<Trajectory> trajectory, double point_size) {
+    if (!trajectory) {
+        std::cerr << "Error: trajectoryPoints() requires a trajectory" << std::endl;
+        return *this;
+    }
+    auto shape = std::make_shared<TrajectoryShape>(std::move(trajectory), false, point_size);
+    applyPendingShapeTransform(shape);  // Phase 1
+    object_->addShape(shape);
+    resetPendingShapeTransform();  // Reset after single shape
+    return *this;
+}
+
 // ============================================================================
 // Texture Support
 // ============================================================================
 
 ObjectBuilder& ObjectBuilder::texturedQuad(double width, double height, const std::string& texture_path,
-                                           double transparency) {
+                                           double transparency, bool mipmaps) {
     // Store texture path for deferred loading (will be applied in build())
-    pending_textures_.push_back({texture_path, TextureImage(), false, width, height, transparency});
+    pending_textures_.push_back({texture_path, TextureImage(), nullptr, false, width, height, transparency, mipmaps});
     return *this;
 }
 
 ObjectBuilder& ObjectBuilder::texturedQuad(const TextureImage& image, double width, double height,
                                            double transparency) {
     // Store texture image for deferred loading (will be applied in build())
-    pending_textures_.push_back({"", image, true, width, height, transparency});
+    pending_textures_.push_back({"", image, nullptr, true, width, height, transparency, false});
+    return *this;
+}
+
+ObjectBuilder& ObjectBuilder::texturedQuad(std::shared_ptr<DynamicTexture> texture, double width, double height,
+                                           double transparency) {
+    // Attached in build(), like the other textured quads
+    pending_textures_.push_back({"", TextureImage(), std::move(texture), false, width, height, transparency, false});
     return *this;
 }
 
 void ObjectBuilder::applyPendingTextures() {
     for (const auto& tex : pending_textures_) {
-        TexturedQuad::Image image;
-
-        if (tex.use_image) {
-            // Use provided image data directly
-            image = tex.image;
-
-            if (!image.isValid()) {
-                std::cerr << "Error: Invalid texture image data provided" << std::endl;
-                continue;  // Skip this texture
-            }
-        } else {
-            // Load image from file using Qt
-            QImage source(QString::fromStdString(tex.path));
-
-            if (source.isNull()) {
-                std::cerr << "Error: Failed to load texture from file: " << tex.path << std::endl;
-                continue;  // Skip this texture
-            }
-
-            // Convert to RGBA format and mirror vertically (OpenGL texture coordinate convention)
-            QImage formatted = source.convertToFormat(QImage::Format_RGBA8888).mirrored();
-
-            // Create Image structure
-            image.width = formatted.width();
-            image.height = formatted.height();
-
-            // Copy pixel data
-            const size_t byte_count = static_cast<size_t>(image.width) * image.height * 4;
-            image.pixels.assign(formatted.bits(), formatted.bits() + byte_count);
-        }
-
-        // Create textured quad and load image
+        // Quads showing the same file or pixels share one cached texture; files decode once.
         auto textured_quad = std::make_shared<TexturedQuad>(tex.width, tex.height);
         textured_quad->setTransparency(tex.transparency);
-        textured_quad->loadTextureFromImage(image);
+        bool loaded;
+        if (tex.dynamic) {
+            loaded = textured_quad->setDynamicTexture(tex.dynamic);
+        } else if (tex.use_image) {
+            loaded = textured_quad->loadTextureFromImage(tex.image);
+        } else {
+            loaded = textured_quad->loadTextureFromFile(tex.path, tex.mipmaps);
+        }
+        if (!loaded) {
+            continue;  // Skip this texture; the quad reported why
+        }
 
         // Phase 1: Apply shape-level transforms (new system)
         applyPendingShapeTransform(textured_quad);
@@ -329,6 +391,25 @@ void ObjectBuilder::applyPendingTextures() {
     }
 }
 
+// ============================================================================
+// Instancing
+// ============================================================================
+
+ObjectBuilder& ObjectBuilder::instances(std::shared_ptr<Object> prototype, const std::vector<Vec3>& positions,
+                                        const std::vector<Quaternion>& orientations, const std::vector<Vec3>& scales,
+                                        const std::vector<Vec3>& colors) {
+    if (!prototype) {
+        std::cerr << "Error: instances() requires a prototype object" << std::endl;
+        return *this;
+    }
+
+    auto shape = std::make_shared<InstancedShape>(prototype->shapes(), positions, orientations, scales, colors);
+    applyPendingShapeTransform(shape);  // Phase 1
+    object_->addShape(shape);
+    resetPendingShapeTransform();  // Reset after single shape
+    return *this;
+}
+
 // ============================================================================
 // Custom Shapes
 // ============================================================================
@@ -340,6 +421,50 @@ ObjectBuilder& ObjectBuilder::addShape(std::shared_ptr<Shape> shape) {
     return *this;
 }
 
+// ============================================================================
+// Scalar Attributes
+// ============================================================================
+
+ObjectBuilder& ObjectBuilder::scalars(const std::vector<float>& values, Colormap colormap, double min, double max) {
+    if (values.empty()) {
+        std::cerr << "Error: scalars() requires at least one value" << std::endl;
+        return *this;
+    }
+    scalar_values_ = values;
+    scalar_colormap_ = colormap;
+    scalar_min_ = min;
+    scalar_max_ = max;
+    return *this;
+}
+
+void ObjectBuilder::applyScalars() {
+    if (scalar_values_.empty()) return;
+
+    // Values run through the vertices of the mapped shapes in order.
+    const auto& shapes = object_->shapes();
+    std::vector<int64_t> offsets;
+    if (scalar_values_.size() > 1) {
+        int64_t vertices = 0;
+        offsets.assign(shapes.size(), -1);
+        for (size_t i = 0; i < shapes.size(); ++i) {
+            if (!shapes[i] || !ScalarField::mapsVertices(*shapes[i])) continue;
+            offsets[i] = vertices;
+            vertices += static_cast<int64_t>(shapes[i]->vertexCount());
+        }
+        if (static_cast<int64_t>(scalar_values_.size()) != vertices) {
+            std::cerr << "Error: scalars() got " << scalar_values_.size() << " values for " << vertices
+                      << " vertices; the object keeps its colors" << std::endl;
+            return;
+        }
+    }
+
+    ScalarField::Mapping mapping;
+    mapping.colormap = scalar_colormap_;
+    mapping.min = static_cast<float>(scalar_min_);
+    mapping.max = static_cast<float>(scalar_max_);
+    object_->setScalars(std::make_shared<ScalarField>(std::move(scalar_values_), std::move(offsets), mapping));
+}
+
 // ============================================================================
 // Transformations
 // ============================================================================
@@ -496,6 +621,11 @@ void ObjectBuilder::resetPendingShapeTransform() {
 std::shared_ptr<Object> ObjectBuilder::build() {
     // Apply pending textures
     applyPendingTextures();
+    applyScalars();
+
+    if (has_lod_shapes_) {
+        object_->setLodSizes(lod_pixels_);
+    }
 
     // Apply info text if set
     if (!info_text_.empty()) {
@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "object_index.h"
+#include <algorithm>
+#include <utility>
+
+namespace octo_flex {
+
+Layer* ObjectIndex::find(ObjectHandle handle) const {
+    if (handle == kNoObjectHandle) return nullptr;
+    Shard& shard = shards_[shardOf(handle)];
+    std::shared_ptr<const ShardSnapshot> snap = std::atomic_load(&shard.snapshot);
+    if (!snap || snap->version != shard.version.load(std::memory_order_acquire)) {
+        // Stale: publish a new copy (another lookup may have done it already).
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        snap = std::atomic_load(&shard.snapshot);
+        const uint64_t version = shard.version.load(std::memory_order_relaxed);
+        if (!snap || snap->version != version) {
+            auto fresh = std::make_shared<ShardSnapshot>();
+            fresh->version = version;
+            fresh->entries = shard.entries;
+            snap = fresh;
+            std::atomic_store(&shard.snapshot, snap);
+        }
+    }
+    auto it = snap->entries.find(handle);
+    return it != snap->entries.end() ? it->second : nullptr;
+}
+
+template <typename Apply>
+void ObjectIndex::update(const std::vector<ObjectHandle>& handles, Apply apply) {
+    if (handles.empty()) return;
+    if (handles.size() == 1) {
+        Shard& shard = shards_[shardOf(handles.front())];
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        apply(shard.entries, handles.front());
+        shard.version.fetch_add(1, std::memory_order_release);
+        return;
+    }
+
+    std::vector<std::pair<size_t, ObjectHandle>> sorted;
+    sorted.reserve(handles.size());
+    for (const ObjectHandle handle : handles) {
+        sorted.emplace_back(shardOf(handle), handle);
+    }
+    std::sort(sorted.begin(), sorted.end());
+    for (size_t begin = 0; begin < sorted.size();) {
+        Shard& shard = shards_[sorted[begin].first];
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        size_t end = begin;
+        for (; end < sorted.size() && sorted[end].first == sorted[begin].first; ++end) {
+            apply(shard.entries, sorted[end].second);
+        }
+        shard.version.fetch_add(1, std::memory_order_release);
+        begin = end;
+    }
+}
+
+void ObjectIndex::add(const std::vector<ObjectHandle>& handles, Layer* layer) {
+    update(handles, [layer](Entries& entries, ObjectHandle handle) { entries.emplace(handle, layer); });
+}
+
+void ObjectIndex::remove(const std::vector<ObjectHandle>& handles, Layer* layer) {
+    update(handles, [layer](Entries& entries, ObjectHandle handle) {
+        auto range = entries.equal_range(handle);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == layer) {
+                entries.erase(it);
+                break;
+            }
+        }
+    });
+}
+
+}  // namespace octo_flex
@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_INDEX_H
+#define OBJECT_INDEX_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "object_registry.h"
+
+namespace octo_flex {
+class Layer;
+
+// Which layer holds each object handle, so finding an object does not visit every layer.
+// Layers report the handles they gain and lose while they hold their own lock. Handles are spread
+// over shards; like a layer, a shard publishes an immutable copy on the first lookup after a
+// change, so a lookup is one atomic load and a hash find while the shard is unchanged.
+class ObjectIndex {
+   public:
+    typedef std::shared_ptr<ObjectIndex> Ptr;
+
+    // A layer holding the handle, or null. If several layers hold it, one of them.
+    Layer* find(ObjectHandle handle) const;
+
+    void add(const std::vector<ObjectHandle>& handles, Layer* layer);
+    void remove(const std::vector<ObjectHandle>& handles, Layer* layer);
+
+   private:
+    static const size_t kShards = 64;
+
+    typedef std::unordered_multimap<ObjectHandle, Layer*> Entries;
+
+    struct ShardSnapshot {
+        uint64_t version = 0;
+        Entries entries;
+    };
+
+    struct Shard {
+        std::mutex mtx;
+        Entries entries;  // Guarded by mtx
+        std::atomic<uint64_t> version{0};
+        std::shared_ptr<const ShardSnapshot> snapshot;  // Accessed with std::atomic_load / std::atomic_store
+    };
+
+    // Handles in shard order, so each shard is locked once per update.
+    template <typename Apply>
+    void update(const std::vector<ObjectHandle>& handles, Apply apply);
+
+    static size_t shardOf(ObjectHandle handle) { return (handle >> 4) % kShards; }
+
+    mutable Shard shards_[kShards];
+};
+
+}  // namespace octo_flex
+
+#endif  // OBJECT_INDEX_H
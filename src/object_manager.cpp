@@ -16,19 +16,38 @@
 
 
 #include "object_manager.h"
+#include <algorithm>
 #include <memory>
 #include <mutex>
+#include <unordered_set>
+#include "scalar_field.h"
+#include "shared_scene_receiver.h"
+#include "submission_recorder.h"
+#include "trace.h"
 #include "utils.h"
 
 namespace octo_flex {
+ObjectManager::~ObjectManager() {
+    // Channels first: their threads submit to this manager.
+    {
+        std::lock_guard<std::mutex> lock(channels_mtx_);
+        channels_.clear();
+    }
+    std::string ignored;
+    stopSubmissionLog(&ignored);
+}
+
 void ObjectManager::submit(Object::Ptr obj, const std::string& layer_id) {
     if (obj == nullptr) return;
+    OCTO_FLEX_TRACE_ZONE("ObjectManager::submit");
     obj->setInEditable();
     Layer::Ptr layer = findOrAddLayer(layer_id);
     layer->addObject(obj);
+    if (auto log = recorder()) log->recordUpsert(layer_id, {obj});
 }
 
 void ObjectManager::submitLayer(const std::vector<Object::Ptr>& objects, const std::string& layer_id) {
+    OCTO_FLEX_TRACE_ZONE("ObjectManager::submitLayer");
     for (auto& obj : objects) {
         if (obj != nullptr) {
             obj->setInEditable();
@@ -36,27 +55,219 @@ void ObjectManager::submitLayer(const std::vector<Object::Ptr>& objects, const s
     }
     Layer::Ptr layer = findOrAddLayer(layer_id);
     layer->setObjects(objects);
+    if (auto log = recorder()) log->recordLayer(layer_id, objects);
 }
 
-const std::pair<std::string, Object::Ptr> ObjectManager::findObject(const std::string& obj_id) {
-    // Find object across all layers.
-    std::unique_lock<std::mutex> lock(mtx_);
-    for (auto& [layer_id, layer] : layers_) {
-        Object::Ptr obj = layer->findObject(obj_id);
+void ObjectManager::submitLayerDelta(const std::vector<Object::Ptr>& upserts,
+                                     const std::vector<std::string>& removed_ids, const std::string& layer_id) {
+    OCTO_FLEX_TRACE_ZONE("ObjectManager::submitLayerDelta");
+    for (auto& obj : upserts) {
+        if (obj != nullptr) {
+            obj->setInEditable();
+        }
+    }
+    Layer::Ptr layer = findOrAddLayer(layer_id);
+    layer->applyDelta(upserts, removed_ids);
+    if (auto log = recorder()) log->recordDelta(layer_id, upserts, removed_ids);
+}
+
+void ObjectManager::submitBatch(size_t count, const std::function<Object::Ptr(size_t)>& build,
+                                const std::string& layer_id) {
+    if (count == 0 || !build) return;
+    OCTO_FLEX_TRACE_ZONE("ObjectManager::submitBatch");
+    std::call_once(worker_pool_once_, [this] { worker_pool_ = std::make_unique<WorkerPool>(); });
+
+    // Each worker writes only its own slots, so no locking is needed until the layer update.
+    std::vector<Object::Ptr> objects(count);
+    worker_pool_->parallelFor(count, [&](size_t i) {
+        Object::Ptr obj = build(i);
         if (obj != nullptr) {
-            return std::make_pair(layer_id, obj);
+            obj->setInEditable();
+            objects[i] = std::move(obj);
         }
+    });
+
+    Layer::Ptr layer = findOrAddLayer(layer_id);
+    layer->applyDelta(objects, {});
+    if (auto log = recorder()) {
+        objects.erase(std::remove(objects.begin(), objects.end(), nullptr), objects.end());
+        log->recordUpsert(layer_id, std::move(objects));
+    }
+}
+
+bool ObjectManager::updatePose(const std::string& obj_id, const Vec3& position, const Quaternion& orientation) {
+    OCTO_FLEX_TRACE_ZONE("ObjectManager::updatePose");
+    const ObjectHandle handle = ObjectRegistry::instance().find(obj_id);
+    Layer* layer = index_->find(handle);
+    if (layer == nullptr) return false;
+    Object::Ptr obj = layer->findObject(handle);
+    if (obj == nullptr) return false;  // Removed meanwhile
+
+    const bool was_posed = obj->isPosed();
+    obj->setPose(position, orientation);
+    if (!was_posed) {
+        // Layer batches hold the built geometry; rebuild once so the object is drawn with its matrix.
+        layer->touch();
+    } else {
+        ++pose_generation_;
     }
-    return std::make_pair("", nullptr);
+    if (auto log = recorder()) log->recordPose(obj_id, position, orientation);
+    return true;
+}
+
+bool ObjectManager::updateScalars(const std::string& obj_id, const float* values, size_t count) {
+    OCTO_FLEX_TRACE_ZONE("ObjectManager::updateScalars");
+    Object::Ptr obj = findObject(obj_id).second;
+    if (obj == nullptr || obj->scalars() == nullptr) return false;
+    // Views repaint through the uploader; layer batches hold no scalar objects.
+    return obj->scalars()->update(values, count);
+}
+
+bool ObjectManager::setScalarMapping(const std::string& obj_id, Colormap colormap, double min, double max) {
+    Object::Ptr obj = findObject(obj_id).second;
+    if (obj == nullptr || obj->scalars() == nullptr) return false;
+    ScalarField::Mapping mapping;
+    mapping.colormap = colormap;
+    mapping.min = static_cast<float>(min);
+    mapping.max = static_cast<float>(max);
+    obj->scalars()->setMapping(mapping);
+    return true;
+}
+
+bool ObjectManager::enqueueSubmit(Object::Ptr obj, const std::string& layer_id) {
+    if (obj == nullptr) return false;
+    obj->setInEditable();
+    UpdateCommand command;
+    command.type = UpdateCommand::Submit;
+    command.layer_id = layer_id;
+    command.object = std::move(obj);
+    return update_queue_.push(std::move(command));
+}
+
+bool ObjectManager::enqueueRemove(const std::string& obj_id, const std::string& layer_id) {
+    UpdateCommand command;
+    command.type = UpdateCommand::Remove;
+    command.layer_id = layer_id;
+    command.object_id = obj_id;
+    return update_queue_.push(std::move(command));
+}
+
+bool ObjectManager::enqueueLayer(const std::vector<Object::Ptr>& objects, const std::string& layer_id) {
+    for (auto& obj : objects) {
+        if (obj != nullptr) {
+            obj->setInEditable();
+        }
+    }
+    UpdateCommand command;
+    command.type = UpdateCommand::ReplaceLayer;
+    command.layer_id = layer_id;
+    command.objects = objects;
+    return update_queue_.push(std::move(command));
+}
+
+bool ObjectManager::enqueuePose(const std::string& obj_id, const Vec3& position, const Quaternion& orientation) {
+    UpdateCommand command;
+    command.type = UpdateCommand::UpdatePose;
+    command.object_id = obj_id;
+    command.position = position;
+    command.orientation = orientation;
+    return update_queue_.push(std::move(command));
+}
+
+size_t ObjectManager::drainUpdates() {
+    OCTO_FLEX_TRACE_ZONE("ObjectManager::drainUpdates");
+    // Submits and removals fold into one delta per layer, so a drain bumps each layer's version once.
+    struct PendingDelta {
+        std::unordered_map<std::string, Object::Ptr> upserts;
+        std::unordered_set<std::string> removed;
+    };
+    std::unordered_map<std::string, PendingDelta> pending;
+    std::shared_ptr<SubmissionRecorder> log = recorder();
+    if (log) log->markFrame();
+
+    // Only what is queued now; producers keep pushing while this runs.
+    const size_t limit = update_queue_.size();
+    size_t applied = 0;
+    UpdateCommand command;
+    while (applied < limit && update_queue_.pop(command)) {
+        ++applied;
+        switch (command.type) {
+            case UpdateCommand::Submit: {
+                PendingDelta& delta = pending[command.layer_id];
+                delta.removed.erase(command.object->id());
+                delta.upserts[command.object->id()] = std::move(command.object);
+                break;
+            }
+            case UpdateCommand::Remove: {
+                PendingDelta& delta = pending[command.layer_id];
+                delta.upserts.erase(command.object_id);
+                delta.removed.insert(command.object_id);
+                break;
+            }
+            case UpdateCommand::ReplaceLayer:
+                // Earlier changes to this layer are replaced anyway.
+                pending.erase(command.layer_id);
+                findOrAddLayer(command.layer_id)->setObjects(command.objects);
+                if (log) log->recordLayer(command.layer_id, command.objects);
+                command.objects.clear();
+                break;
+            case UpdateCommand::UpdatePose: {
+                // An object submitted earlier in this drain takes the pose before it reaches its layer.
+                bool queued = false;
+                for (auto& [layer_id, delta] : pending) {
+                    auto it = delta.upserts.find(command.object_id);
+                    if (it != delta.upserts.end()) {
+                        it->second->setPose(command.position, command.orientation);
+                        queued = true;
+                        break;
+                    }
+                }
+                if (!queued) {
+                    updatePose(command.object_id, command.position, command.orientation);
+                }
+                break;
+            }
+        }
+    }
+    for (auto& [layer_id, delta] : pending) {
+        std::vector<Object::Ptr> upserts;
+        upserts.reserve(delta.upserts.size());
+        for (auto& [obj_id, obj] : delta.upserts) {
+            upserts.push_back(std::move(obj));
+        }
+        std::vector<std::string> removed(delta.removed.begin(), delta.removed.end());
+        findOrAddLayer(layer_id)->applyDelta(upserts, removed);
+        if (log) log->recordDelta(layer_id, std::move(upserts), std::move(removed));
+    }
+    return applied;
+}
+
+const std::pair<std::string, Object::Ptr> ObjectManager::findObject(const std::string& obj_id) {
+    // Find object by the handle the ID is interned as.
+    return findObject(ObjectRegistry::instance().find(obj_id));
+}
+
+const std::pair<std::string, Object::Ptr> ObjectManager::findObject(ObjectHandle handle) {
+    // The index names the layer, whose snapshot is read without locking while it is unchanged.
+    Layer* layer = index_->find(handle);
+    if (layer == nullptr) return std::make_pair("", nullptr);
+    LayerSnapshotPtr snapshot = layer->snapshot();
+    auto it = snapshot->objects.find(handle);
+    if (it == snapshot->objects.end()) return std::make_pair("", nullptr);  // Removed meanwhile
+    return std::make_pair(layer->id(), it->second);
 }
 
 const Layer::Ptr ObjectManager::findOrAddLayer(const std::string layer_id) {
     Layer::Ptr layer = nullptr;
-    std::unique_lock<std::mutex> lock(mtx_);
+    std::unique_lock<std::mutex> lock = traceLock(mtx_, "ObjectManager lock wait");
     auto it = layers_.find(layer_id);
     if (it == layers_.end()) {
-        layer = std::make_shared<Layer>(layer_id);
+        layer = std::make_shared<Layer>(layer_id, index_);
         layers_[layer_id] = layer;
+
+        // Publish the new layer set for lock-free readers.
+        std::atomic_store(&layers_snapshot_, std::shared_ptr<const LayerList>(std::make_shared<LayerList>(layers_)));
+        ++layers_generation_;
     } else {
         layer = it->second;
     }
@@ -75,19 +286,79 @@ const Layer::Ptr ObjectManager::findLayer(const std::string layer_id) {
     return layer;
 }
 
-const LayerList ObjectManager::layers() {
-    LayerList layers;
-    std::unique_lock<std::mutex> lock(mtx_);
-    layers = layers_;
-    return layers;
+const LayerList ObjectManager::layers() { return *layersSnapshot(); }
+
+std::shared_ptr<const LayerList> ObjectManager::layersSnapshot() const { return std::atomic_load(&layers_snapshot_); }
+
+uint64_t ObjectManager::generation() const {
+    // Layer versions only grow, so the sum changes on every mutation.
+    uint64_t generation = layers_generation_.load(std::memory_order_acquire) +
+                          pose_generation_.load(std::memory_order_acquire);
+    auto layers = layersSnapshot();
+    for (const auto& [layer_id, layer] : *layers) {
+        generation += layer->version();
+    }
+    return generation;
+}
+
+std::vector<std::pair<std::string, Object::Ptr>> ObjectManager::queryRegion(const Frustum& region) {
+    OCTO_FLEX_TRACE_ZONE("ObjectManager::queryRegion");
+    std::vector<std::pair<std::string, Object::Ptr>> result;
+    std::vector<Object::Ptr> objects;
+    auto layers = layersSnapshot();
+    for (const auto& [layer_id, layer] : *layers) {
+        objects.clear();
+        layer->bvh()->query(region, objects);
+        for (auto& obj : objects) {
+            result.emplace_back(layer_id, std::move(obj));
+        }
+    }
+    return result;
+}
+
+bool ObjectManager::raycast(const PickRay& ray, PickHit& hit, std::string* layer_id) {
+    OCTO_FLEX_TRACE_ZONE("ObjectManager::raycast");
+    bool found = false;
+    auto layers = layersSnapshot();
+    for (const auto& [id, layer] : *layers) {
+        if (layer->bvh()->raycast(ray, hit)) {
+            found = true;
+            if (layer_id) *layer_id = id;
+        }
+    }
+    return found;
+}
+
+SceneMemoryStats ObjectManager::memoryStats() {
+    SceneMemoryStats stats;
+    auto layers = layersSnapshot();
+    stats.layers.reserve(layers->size());
+    for (auto& [layer_id, layer] : *layers) {
+        stats.layers.push_back(layer->memoryStats());
+    }
+    std::sort(stats.layers.begin(), stats.layers.end(),
+              [](const LayerMemoryStats& a, const LayerMemoryStats& b) { return a.layer_id < b.layer_id; });
+
+    LayerMemoryStats& total = stats.total;
+    for (const auto& layer : stats.layers) {
+        total.objects += layer.objects;
+        total.shapes += layer.shapes;
+        total.vertices += layer.vertices;
+        total.cpu_bytes += layer.cpu_bytes;
+        total.gpu_buffer_bytes += layer.gpu_buffer_bytes;
+        total.texture_bytes += layer.texture_bytes;
+        total.pending_objects += layer.pending_objects;
+        total.pending_bytes += layer.pending_bytes;
+    }
+    return stats;
 }
 
 void ObjectManager::clearOutdatedObjects() {
-    std::unique_lock<std::mutex> lock(mtx_);
     std::vector<Object::Ptr> all_outdated;
 
     // Collect outdated objects from all layers
-    for (auto& [layer_id, layer] : layers_) {
+    auto layers = layersSnapshot();
+    for (auto& [layer_id, layer] : *layers) {
         auto outdated = layer->collectOutdatedObjects();
         all_outdated.insert(all_outdated.end(), outdated.begin(), outdated.end());
     }
@@ -107,4 +378,73 @@ void ObjectManager::clearOutdatedObjects() {
     // Objects will be deleted when all_outdated goes out of scope
 }
 
+bool ObjectManager::startSubmissionLog(const SubmissionLogOptions& options, std::string* error) {
+    std::string ignored;
+    std::lock_guard<std::mutex> lock(log_mtx_);
+    if (recorder_) {
+        (error ? *error : ignored) = "Submission log already active";
+        return false;
+    }
+    auto recorder = std::make_shared<SubmissionRecorder>(this);
+    if (!recorder->start(options, error ? error : &ignored)) return false;
+    std::atomic_store(&recorder_, recorder);
+    logging_.store(true, std::memory_order_release);
+    return true;
+}
+
+bool ObjectManager::stopSubmissionLog(std::string* error) {
+    std::lock_guard<std::mutex> lock(log_mtx_);
+    logging_.store(false, std::memory_order_release);
+    std::shared_ptr<SubmissionRecorder> recorder =
+        std::atomic_exchange(&recorder_, std::shared_ptr<SubmissionRecorder>());
+    if (!recorder) return true;
+
+    // Threads that loaded the recorder before the exchange find it stopped and record nothing.
+    std::string ignored;
+    const bool ok = recorder->stop(error ? error : &ignored);
+    last_log_stats_ = recorder->stats();
+    return ok;
+}
+
+SubmissionLogStats ObjectManager::submissionLogStats() const {
+    if (auto log = recorder()) return log->stats();
+    std::lock_guard<std::mutex> lock(log_mtx_);
+    return last_log_stats_;
+}
+
+std::shared_ptr<SubmissionRecorder> ObjectManager::recorder() const {
+    if (!logging_.load(std::memory_order_acquire)) return nullptr;
+    return std::atomic_load(&recorder_);
+}
+
+bool ObjectManager::openSharedChannel(const std::string& name, const SharedSceneOptions& options, std::string* error) {
+    std::string ignored;
+    std::lock_guard<std::mutex> lock(channels_mtx_);
+    if (channels_.count(name)) {
+        (error ? *error : ignored) = "Shared scene channel " + name + " already open";
+        return false;
+    }
+    auto receiver = std::make_shared<SharedSceneReceiver>(this, name);
+    if (!receiver->open(options, error ? error : &ignored)) return false;
+    channels_[name] = std::move(receiver);
+    return true;
+}
+
+void ObjectManager::closeSharedChannel(const std::string& name) {
+    std::shared_ptr<SharedSceneReceiver> receiver;
+    {
+        std::lock_guard<std::mutex> lock(channels_mtx_);
+        auto it = channels_.find(name);
+        if (it == channels_.end()) return;
+        receiver = std::move(it->second);
+        channels_.erase(it);
+    }
+    receiver->close();
+}
+
+SharedSceneStats ObjectManager::sharedChannelStats(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(channels_mtx_);
+    auto it = channels_.find(name);
+    return it != channels_.end() ? it->second->stats() : SharedSceneStats();
+}
 }  // namespace octo_flex
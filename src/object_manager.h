@@ -18,32 +18,134 @@
 #ifndef OBJECT_MANAGER_H
 #define OBJECT_MANAGER_H
 
+#include <atomic>
+#include <functional>
+#include <map>
 #include <string>
+#include <vector>
+#include "bvh.h"
+#include "colormap.h"
 #include "layer.h"
+#include "shared_scene.h"
+#include "submission_log.h"
+#include "update_queue.h"
+#include "worker_pool.h"
 
 namespace octo_flex {
+class SharedSceneReceiver;
+class SubmissionRecorder;
+
 class ObjectManager {
    public:
     typedef std::shared_ptr<ObjectManager> Ptr;
     ObjectManager(){};
-    virtual ~ObjectManager(){};
+    virtual ~ObjectManager();
     const Layer::Ptr findLayer(const std::string layer_id);
     const Layer::Ptr findOrAddLayer(const std::string layer_id);
 
+    // Layer ID and object, or an empty ID and null. Goes through the object index, so the cost does not grow
+    // with the number of layers and no scene lock is taken while the layer holding the object is unchanged.
     const std::pair<std::string, Object::Ptr> findObject(const std::string& obj_id);
+    const std::pair<std::string, Object::Ptr> findObject(ObjectHandle handle);
     const LayerList layers();
 
+    // Immutable layer set, republished only when a layer is added (one atomic load per call).
+    std::shared_ptr<const LayerList> layersSnapshot() const;
+
+    // Objects of every layer with geometry inside the region, as (layer ID, object) pairs. Goes through the
+    // layers' bounding volume hierarchies, built or refit on first use after a change.
+    std::vector<std::pair<std::string, Object::Ptr>> queryRegion(const Frustum& region);
+
+    // Nearest object of any layer under the ray; true with hit and layer_id set if one is closer than
+    // hit.distance.
+    bool raycast(const PickRay& ray, PickHit& hit, std::string* layer_id = nullptr);
+
+    // Scene generation, changes whenever a layer is added, any layer's contents change or a pose is updated.
+    uint64_t generation() const;
+
     void submit(Object::Ptr obj, const std::string& layer_id = "default");
 
     // Submit layer: replace all objects in the layer atomically
     void submitLayer(const std::vector<Object::Ptr>& objects, const std::string& layer_id = "default");
 
+    // Submit layer delta: upsert and remove objects in one atomic layer update
+    void submitLayerDelta(const std::vector<Object::Ptr>& upserts, const std::vector<std::string>& removed_ids,
+                          const std::string& layer_id = "default");
+
+    // Submit batch: run build(i) for i in [0, count) on the worker pool, finalize the results there too,
+    // then add them all to the layer in one atomic update. build must be thread-safe; null results are skipped.
+    void submitBatch(size_t count, const std::function<Object::Ptr(size_t)>& build,
+                     const std::string& layer_id = "default");
+
+    // Update pose: move a submitted object by its draw-time model matrix without touching its geometry.
+    // Returns false if no layer holds the object.
+    bool updatePose(const std::string& obj_id, const Vec3& position, const Quaternion& orientation);
+
+    // Update scalars: replace the values of a submitted object's scalar attribute (see ObjectBuilder::scalars()).
+    // Only the float array is uploaded at the next frame. Returns false if no layer holds the object, it has
+    // no scalars or count does not match.
+    bool updateScalars(const std::string& obj_id, const float* values, size_t count);
+
+    // Replace the colormap and range of a submitted object's scalar attribute; nothing is uploaded.
+    // Returns false if no layer holds the object or it has no scalars.
+    bool setScalarMapping(const std::string& obj_id, Colormap colormap, double min, double max);
+
+    // Queued updates: never block on the scene locks and may be called from any thread. Objects are
+    // finalized on the calling thread; the render thread applies the queue with drainUpdates().
+    // Each returns false if the queue is full and the command was dropped.
+    bool enqueueSubmit(Object::Ptr obj, const std::string& layer_id = "default");
+    bool enqueueRemove(const std::string& obj_id, const std::string& layer_id = "default");
+    bool enqueueLayer(const std::vector<Object::Ptr>& objects, const std::string& layer_id = "default");
+    bool enqueuePose(const std::string& obj_id, const Vec3& position, const Quaternion& orientation);
+
+    // Apply the commands queued so far, in order; called by the render thread at frame start.
+    // Returns the number of commands applied.
+    size_t drainUpdates();
+
+    bool hasPendingUpdates() const { return update_queue_.size() > 0; }
+    UpdateQueueStats updateQueueStats() const { return update_queue_.stats(); }
+    void setUpdateQueueCapacity(size_t capacity) { update_queue_.setCapacity(capacity); }
+
     // Clear outdated objects (call after rendering)
     void clearOutdatedObjects();
 
+    // Counts and bytes of every layer, sorted by layer id; callable from any thread. The merged
+    // batches the views draw layers with are not included (see OctoFlexView::memoryStats).
+    SceneMemoryStats memoryStats();
+
+    // Submission log: from here on every applied update is written with its time to a log that
+    // SubmissionReplay plays back. Returns false and sets error if one is running or the file fails.
+    bool startSubmissionLog(const SubmissionLogOptions& options, std::string* error = nullptr);
+    bool stopSubmissionLog(std::string* error = nullptr);
+    SubmissionLogStats submissionLogStats() const;
+
+    // Shared scene channel: a named shared memory segment other processes submit through with
+    // SharedSceneSender. Their updates are applied on a background thread as if submitted here.
+    // Returns false and sets error if the name is taken or the segment cannot be created.
+    bool openSharedChannel(const std::string& name, const SharedSceneOptions& options = SharedSceneOptions(),
+                           std::string* error = nullptr);
+    void closeSharedChannel(const std::string& name);
+    SharedSceneStats sharedChannelStats(const std::string& name) const;
+
    private:
+    // Recorder while a submission log runs, null otherwise (one atomic load when not logging).
+    std::shared_ptr<SubmissionRecorder> recorder() const;
+
     LayerList layers_;
+    ObjectIndex::Ptr index_ = std::make_shared<ObjectIndex>();  // Shared with the layers
+    std::shared_ptr<const LayerList> layers_snapshot_ = std::make_shared<const LayerList>();  // atomic access
+    std::atomic<uint64_t> layers_generation_{0};
+    std::atomic<uint64_t> pose_generation_{0};
     std::mutex mtx_;
+    std::unique_ptr<WorkerPool> worker_pool_;  // Created on first batch
+    std::once_flag worker_pool_once_;
+    UpdateQueue update_queue_;
+    std::shared_ptr<SubmissionRecorder> recorder_;  // Accessed with std::atomic_load / std::atomic_store
+    std::atomic<bool> logging_{false};
+    mutable std::mutex log_mtx_;  // Serializes starting and stopping the log
+    SubmissionLogStats last_log_stats_;  // Of the last stopped log, guarded by log_mtx_
+    std::map<std::string, std::shared_ptr<SharedSceneReceiver>> channels_;
+    mutable std::mutex channels_mtx_;
 };
 }  // namespace octo_flex
 
@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "object_registry.h"
+#include <functional>
+
+namespace octo_flex {
+
+ObjectRegistry& ObjectRegistry::instance() {
+    // Leaked: objects released during static destruction still find it.
+    static ObjectRegistry* registry = new ObjectRegistry();
+    return *registry;
+}
+
+ObjectRegistry::Shard& ObjectRegistry::shardOf(const std::string& id) const {
+    return shards_[std::hash<std::string>()(id) % kShards];
+}
+
+ObjectHandle ObjectRegistry::acquire(const std::string& id) {
+    Shard& shard = shardOf(id);
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    auto it = shard.handles.find(id);
+    if (it == shard.handles.end()) {
+        // The shard is encoded in the handle, so release() finds it without the ID.
+        const ObjectHandle handle = shard.next++ * kShards + static_cast<ObjectHandle>(&shard - shards_);
+        it = shard.handles.emplace(id, Entry{handle, 0}).first;
+        shard.ids[handle] = &it->first;
+    }
+    it->second.refs++;
+    return it->second.handle;
+}
+
+void ObjectRegistry::release(ObjectHandle handle) {
+    if (handle == kNoObjectHandle) return;
+    Shard& shard = shards_[handle % kShards];
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    auto id = shard.ids.find(handle);
+    if (id == shard.ids.end()) return;
+    auto it = shard.handles.find(*id->second);
+    if (--it->second.refs == 0) {
+        shard.ids.erase(id);
+        shard.handles.erase(it);
+    }
+}
+
+ObjectHandle ObjectRegistry::find(const std::string& id) const {
+    const Shard& shard = shardOf(id);
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    auto it = shard.handles.find(id);
+    return it != shard.handles.end() ? it->second.handle : kNoObjectHandle;
+}
+
+std::string ObjectRegistry::id(ObjectHandle handle) const {
+    const Shard& shard = shards_[handle % kShards];
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    auto it = shard.ids.find(handle);
+    return it != shard.ids.end() ? *it->second : std::string();
+}
+
+}  // namespace octo_flex
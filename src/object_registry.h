@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_REGISTRY_H
+#define OBJECT_REGISTRY_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace octo_flex {
+
+// Integer stand-in for an object ID on the hot paths: layer membership, selection and picking
+// hash and compare these instead of strings. 0 is never assigned.
+typedef uint64_t ObjectHandle;
+const ObjectHandle kNoObjectHandle = 0;
+
+// Interns object IDs into handles. A handle stays assigned to its ID while anything holds a
+// reference: every frozen object holds one for its ID, and a view holds one per selected ID, so
+// replacing an object keeps its handle. Once the last reference goes the ID is forgotten; handles
+// are never reused. Thread-safe; IDs are spread over shards to keep concurrent freezes apart.
+class ObjectRegistry {
+   public:
+    static ObjectRegistry& instance();
+
+    // Handle of id, assigned on first use; adds a reference.
+    ObjectHandle acquire(const std::string& id);
+    // Drop a reference taken by acquire().
+    void release(ObjectHandle handle);
+
+    // Handle currently assigned to id, or kNoObjectHandle; adds no reference.
+    ObjectHandle find(const std::string& id) const;
+    // ID of an assigned handle, empty otherwise.
+    std::string id(ObjectHandle handle) const;
+
+   private:
+    static const size_t kShards = 16;
+
+    struct Entry {
+        ObjectHandle handle;
+        size_t refs;
+    };
+
+    struct Shard {
+        mutable std::mutex mtx;
+        std::unordered_map<std::string, Entry> handles;
+        std::unordered_map<ObjectHandle, const std::string*> ids;  // Keys of handles
+        uint64_t next = 1;
+    };
+
+    ObjectRegistry() {}
+
+    Shard& shardOf(const std::string& id) const;
+
+    mutable Shard shards_[kShards];
+};
+
+}  // namespace octo_flex
+
+#endif  // OBJECT_REGISTRY_H
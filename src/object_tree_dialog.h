@@ -23,21 +23,16 @@
 #include <QDialog>
 #include <QLabel>
 #include <QPushButton>
-#include <QStandardItemModel>
+#include <QTimer>
 #include <QTreeView>
 #include <QVBoxLayout>
 #include <memory>
 #include <set>
 #include "object_manager.h"
+#include "object_tree_model.h"
 
 namespace octo_flex {
 
-// Dialog mode enum.
-enum class ObjectTreeMode {
-    ALL,        // All selectable items (layers and objects).
-    LAYER_ONLY  // Layers only.
-};
-
 class ObjectTreeDialog : public QDialog {
     Q_OBJECT
 
@@ -58,8 +53,8 @@ class ObjectTreeDialog : public QDialog {
     void setPreselectedItems(const std::set<std::string>& items);
 
    private slots:
-    // Handle item state changes.
-    void onItemChanged(QStandardItem* item);
+    // Sync the tree with scene changes while the dialog is open.
+    void onRefreshTimer();
 
     // OK button click.
     void onOkClicked();
@@ -71,41 +66,17 @@ class ObjectTreeDialog : public QDialog {
     // Initialize UI.
     void initUI();
 
-    // Build object tree.
-    void buildObjectTree();
-
-    // Recursively build tree nodes.
-    QStandardItem* buildTreeNode(const std::string& path, const std::map<std::string, std::vector<std::string>>& tree);
-
-    // Recursively set child check state.
-    void setChildCheckState(QStandardItem* item, Qt::CheckState state);
-
-    // Update parent check state.
-    void updateParentCheckState(QStandardItem* item);
-
-    // Parse object ID to a path.
-    std::vector<std::string> parseObjectId(const std::string& objectId);
-
-    // Collect selected objects.
-    void collectSelectedObjects(QStandardItem* item);
-
-    // Check whether a path is a directory node.
-    bool isDirectory(const std::string& path) const;
-
-    // Update item selection state.
-    void updateItemSelectionState(QStandardItem* item);
+    // Fetch the objects of layers whose last shown row is on screen.
+    void fetchVisibleRows();
 
    private:
     QTreeView* treeView_;
-    QStandardItemModel* model_;
+    ObjectTreeModel* model_;
     QPushButton* okButton_;
     QPushButton* cancelButton_;
+    QTimer* refreshTimer_;
     ObjectManager::Ptr objManager_;
-    std::map<std::string, std::string> itemToObjectId_;  // Item to object ID mapping.
-    std::set<std::string> selectedObjects_;              // Selected object ID set.
-    std::set<std::string> preselectedItems_;             // Preselected item set.
-    std::set<std::string> directoryPaths_;               // Directory path set.
-    ObjectTreeMode mode_ = ObjectTreeMode::ALL;          // Dialog mode.
+    std::set<std::string> preselectedItems_;  // Preselected item set.
 };
 
 }  // namespace octo_flex
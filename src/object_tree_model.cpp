@@ -0,0 +1,539 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "object_tree_model.h"
+#include <algorithm>
+
+namespace octo_flex {
+namespace {
+// Objects exposed per fetchMore; a view asks for the next chunk when it reaches the end of a layer.
+const size_t kFetchChunk = 256;
+
+const QVector<int> kCheckRoles{Qt::CheckStateRole};
+
+// Display name of a layer path: its last non-empty part.
+QString PathName(const std::string& path) {
+    const size_t end = path.find_last_not_of('#');
+    if (end == std::string::npos) {
+        return QString::fromStdString(path);
+    }
+    size_t start = path.find_last_of('#', end);
+    start = start == std::string::npos ? 0 : start + 1;
+    return QString::fromStdString(path.substr(start, end + 1 - start));
+}
+}  // namespace
+
+ObjectTreeModel::ObjectTreeModel(QObject* parent) : QAbstractItemModel(parent) {}
+
+ObjectTreeModel::~ObjectTreeModel() = default;
+
+void ObjectTreeModel::setObjectManager(ObjectManager::Ptr objManager) {
+    beginResetModel();
+    objManager_ = objManager;
+    root_.dirs.clear();
+    dirIndex_.clear();
+    synced_ = false;
+    endResetModel();
+    refresh();
+}
+
+void ObjectTreeModel::setMode(ObjectTreeMode mode) {
+    if (mode == mode_) {
+        return;
+    }
+
+    // Check states mean different things per mode, so the tree is read again.
+    beginResetModel();
+    mode_ = mode;
+    root_.dirs.clear();
+    dirIndex_.clear();
+    synced_ = false;
+    endResetModel();
+    refresh();
+}
+
+void ObjectTreeModel::refresh() {
+    if (!objManager_) {
+        return;
+    }
+
+    // Read the generation first, so a change made while syncing is picked up by the next call.
+    const uint64_t generation = objManager_->generation();
+    if (synced_ && generation == generation_) {
+        return;
+    }
+    generation_ = generation;
+    synced_ = true;
+
+    // Directory children per path; "a#b#c" is shown as c under b under a.
+    auto layersSnapshot = objManager_->layersSnapshot();
+    std::unordered_map<std::string, std::set<std::string>> children;
+    for (const auto& layerPair : *layersSnapshot) {
+        const std::string& layerId = layerPair.first;
+        if (layerId.empty()) {
+            continue;  // The root itself
+        }
+
+        std::string parentPath;
+        for (size_t pos = layerId.find('#', 1); pos != std::string::npos; pos = layerId.find('#', pos + 1)) {
+            if (layerId[pos - 1] == '#') {
+                continue;  // Empty part
+            }
+            std::string prefix = layerId.substr(0, pos);
+            children[parentPath].insert(prefix);
+            parentPath = std::move(prefix);
+        }
+        children[parentPath].insert(layerId);
+    }
+
+    if (root_.dirs.empty()) {
+        addDir(&root_, 0, "");
+    }
+    Node* root = root_.dirs.front().get();
+    if (syncDir(root, children, *layersSnapshot)) {
+        updateParentCheckState(root);
+    }
+}
+
+bool ObjectTreeModel::syncDir(Node* node, const std::unordered_map<std::string, std::set<std::string>>& children,
+                              const LayerList& layers) {
+    static const std::set<std::string> kNoChildren;
+    auto found = children.find(node->path);
+    const std::set<std::string>& wanted = found != children.end() ? found->second : kNoChildren;
+
+    // Both lists are sorted, so removing the stale directories leaves the new ones to insert in order.
+    bool changed = false;
+    for (size_t i = node->dirs.size(); i-- > 0;) {
+        if (wanted.find(node->dirs[i]->path) == wanted.end()) {
+            removeDir(node, i);
+            changed = true;
+        }
+    }
+    size_t pos = 0;
+    for (const std::string& path : wanted) {
+        if (pos < node->dirs.size() && node->dirs[pos]->path == path) {
+            ++pos;
+            continue;
+        }
+        addDir(node, pos++, path);
+        changed = true;
+    }
+
+    for (const auto& dir : node->dirs) {
+        auto layer = layers.find(dir->path);
+        bool dirChanged = syncObjects(dir.get(), layer != layers.end() ? layer->second : nullptr);
+        dirChanged = syncDir(dir.get(), children, layers) || dirChanged;
+        if (dirChanged) {
+            updateParentCheckState(dir.get());
+        }
+    }
+    return changed;
+}
+
+bool ObjectTreeModel::syncObjects(Node* node, const Layer::Ptr& layer) {
+    std::vector<std::string> ids;
+    if (layer) {
+        LayerSnapshotPtr snapshot = layer->snapshot();
+        if (node->layer && snapshot->version == node->version) {
+            return false;
+        }
+        node->version = snapshot->version;
+        ids.reserve(snapshot->objects.size());
+        for (const auto& [handle, obj] : snapshot->objects) {
+            ids.push_back(obj->id());
+        }
+        std::sort(ids.begin(), ids.end());
+    }
+    node->layer = layer != nullptr;
+    if (ids == node->objects) {
+        return false;  // Only poses changed
+    }
+
+    // Merge the sorted lists into positions removed from the old list and inserted from the new one.
+    std::vector<size_t> removed;
+    std::vector<size_t> added;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < node->objects.size() || j < ids.size()) {
+        if (j == ids.size() || (i < node->objects.size() && node->objects[i] < ids[j])) {
+            removed.push_back(i++);
+        } else if (i == node->objects.size() || ids[j] < node->objects[i]) {
+            added.push_back(j++);
+        } else {
+            ++i;
+            ++j;
+        }
+    }
+
+    // Rows exist only for the fetched objects; changes past them only change what fetchMore exposes.
+    const QModelIndex parentIndex = indexOf(node);
+    const size_t offset = node->dirs.size();
+    for (size_t end = removed.size(); end > 0;) {
+        size_t begin = end - 1;
+        while (begin > 0 && removed[begin - 1] + 1 == removed[begin]) {
+            --begin;
+        }
+        const size_t first = removed[begin];
+        const size_t last = removed[end - 1] + 1;
+        const size_t shown = first < node->fetched ? std::min(last, node->fetched) - first : 0;
+        if (shown > 0) {
+            beginRemoveRows(parentIndex, int(offset + first), int(offset + first + shown) - 1);
+        }
+        node->checkedCount -= std::count(node->checked.begin() + first, node->checked.begin() + last, 1);
+        node->objects.erase(node->objects.begin() + first, node->objects.begin() + last);
+        node->checked.erase(node->checked.begin() + first, node->checked.begin() + last);
+        if (shown > 0) {
+            node->fetched -= shown;
+            endRemoveRows();
+        }
+        end = begin;
+    }
+
+    for (size_t begin = 0; begin < added.size();) {
+        size_t end = begin + 1;
+        while (end < added.size() && added[end] == added[end - 1] + 1) {
+            ++end;
+        }
+        const size_t first = added[begin];
+        const size_t count = end - begin;
+
+        // Inserts among the fetched rows are shown, and a fully fetched layer shows up to a chunk of new tail.
+        size_t shown = 0;
+        if (first < node->fetched) {
+            shown = count;
+        } else if (first == node->fetched && node->fetched == node->objects.size()) {
+            shown = std::min(count, kFetchChunk);
+        }
+        if (shown > 0) {
+            beginInsertRows(parentIndex, int(offset + first), int(offset + first + shown) - 1);
+        }
+        node->objects.insert(node->objects.begin() + first, ids.begin() + first, ids.begin() + first + count);
+        node->checked.insert(node->checked.begin() + first, count, 0);
+        if (shown > 0) {
+            node->fetched += shown;
+            endInsertRows();
+        }
+        begin = end;
+    }
+    return true;
+}
+
+ObjectTreeModel::Node* ObjectTreeModel::addDir(Node* parent, size_t pos, const std::string& path) {
+    auto node = std::make_unique<Node>();
+    node->path = path;
+    node->name = path.empty() ? QString("Root") : PathName(path);
+    node->parent = parent;
+    Node* added = node.get();
+
+    beginInsertRows(indexOf(parent), int(pos), int(pos));
+    parent->dirs.insert(parent->dirs.begin() + pos, std::move(node));
+    for (size_t i = pos; i < parent->dirs.size(); ++i) {
+        parent->dirs[i]->row = int(i);
+    }
+    dirIndex_[path] = added;
+    endInsertRows();
+    return added;
+}
+
+void ObjectTreeModel::removeDir(Node* parent, size_t pos) {
+    beginRemoveRows(indexOf(parent), int(pos), int(pos));
+    forgetDirs(parent->dirs[pos].get());
+    parent->dirs.erase(parent->dirs.begin() + pos);
+    for (size_t i = pos; i < parent->dirs.size(); ++i) {
+        parent->dirs[i]->row = int(i);
+    }
+    endRemoveRows();
+}
+
+void ObjectTreeModel::forgetDirs(const Node* node) {
+    dirIndex_.erase(node->path);
+    for (const auto& dir : node->dirs) {
+        forgetDirs(dir.get());
+    }
+}
+
+void ObjectTreeModel::checkItems(const std::set<std::string>& items) {
+    for (const std::string& item : items) {
+        if (item.empty()) {
+            continue;
+        }
+
+        auto dir = dirIndex_.find(item);
+        if (dir != dirIndex_.end()) {
+            setDirCheckState(dir->second, Qt::Checked);
+            continue;
+        }
+
+        if (mode_ != ObjectTreeMode::ALL) {
+            continue;
+        }
+        for (const auto& [path, node] : dirIndex_) {
+            auto it = std::lower_bound(node->objects.begin(), node->objects.end(), item);
+            if (it != node->objects.end() && *it == item) {
+                setObjectCheckState(node, size_t(it - node->objects.begin()), true);
+            }
+        }
+    }
+}
+
+std::set<std::string> ObjectTreeModel::checkedItems() const {
+    std::set<std::string> result;
+    for (const auto& dir : root_.dirs) {
+        collectChecked(dir.get(), result);
+    }
+    return result;
+}
+
+void ObjectTreeModel::collectChecked(const Node* node, std::set<std::string>& result) const {
+    if (mode_ == ObjectTreeMode::LAYER_ONLY) {
+        // In layer-only mode, add the layer ID itself.
+        if (node->check == Qt::Checked && !node->path.empty()) {
+            result.insert(node->path);
+        }
+    } else if (node->check == Qt::Checked) {
+        // A checked directory selects everything under it.
+        collectObjects(node, result);
+        return;
+    } else {
+        for (size_t i = 0; i < node->objects.size(); ++i) {
+            if (node->checked[i]) {
+                result.insert(node->objects[i]);
+            }
+        }
+    }
+
+    for (const auto& dir : node->dirs) {
+        collectChecked(dir.get(), result);
+    }
+}
+
+void ObjectTreeModel::collectObjects(const Node* node, std::set<std::string>& result) const {
+    result.insert(node->objects.begin(), node->objects.end());
+    for (const auto& dir : node->dirs) {
+        collectObjects(dir.get(), result);
+    }
+}
+
+void ObjectTreeModel::setDirCheckState(Node* node, Qt::CheckState state) {
+    setChildCheckState(node, state);
+    const QModelIndex index = indexOf(node);
+    emit dataChanged(index, index, kCheckRoles);
+    emitCheckChanged(node);
+    updateParentCheckState(node->parent);
+}
+
+void ObjectTreeModel::setObjectCheckState(Node* node, size_t pos, bool checked) {
+    if (bool(node->checked[pos]) == checked) {
+        return;
+    }
+    node->checked[pos] = checked;
+    if (checked) {
+        ++node->checkedCount;
+    } else {
+        --node->checkedCount;
+    }
+    if (pos < node->fetched) {
+        const QModelIndex index = createIndex(int(node->dirs.size() + pos), 0, node);
+        emit dataChanged(index, index, kCheckRoles);
+    }
+    updateParentCheckState(node);
+}
+
+void ObjectTreeModel::setChildCheckState(Node* node, Qt::CheckState state) {
+    node->check = state;
+
+    // In layer-only mode, objects keep their state.
+    if (mode_ == ObjectTreeMode::ALL) {
+        const bool checked = state == Qt::Checked;
+        std::fill(node->checked.begin(), node->checked.end(), checked);
+        node->checkedCount = checked ? node->objects.size() : 0;
+    }
+
+    for (const auto& dir : node->dirs) {
+        setChildCheckState(dir.get(), state);
+    }
+}
+
+void ObjectTreeModel::emitCheckChanged(const Node* node) {
+    const size_t rows = node->dirs.size() + (mode_ == ObjectTreeMode::ALL ? node->fetched : 0);
+    if (rows > 0) {
+        const QModelIndex parent = indexOf(node);
+        emit dataChanged(index(0, 0, parent), index(int(rows) - 1, 0, parent), kCheckRoles);
+    }
+    for (const auto& dir : node->dirs) {
+        emitCheckChanged(dir.get());
+    }
+}
+
+void ObjectTreeModel::updateParentCheckState(Node* node) {
+    // An ancestor only depends on its children, so the walk stops at the first state that holds.
+    for (; node && node != &root_; node = node->parent) {
+        const Qt::CheckState state = childCheckState(node);
+        if (state == node->check) {
+            break;
+        }
+        node->check = state;
+        const QModelIndex index = indexOf(node);
+        emit dataChanged(index, index, kCheckRoles);
+    }
+}
+
+Qt::CheckState ObjectTreeModel::childCheckState(const Node* node) const {
+    size_t total = node->dirs.size();
+    size_t checked = 0;
+    size_t partial = 0;
+    for (const auto& dir : node->dirs) {
+        if (dir->check == Qt::Checked) {
+            ++checked;
+        } else if (dir->check == Qt::PartiallyChecked) {
+            ++partial;
+        }
+    }
+
+    // In layer-only mode objects are not counted.
+    if (mode_ == ObjectTreeMode::ALL) {
+        total += node->objects.size();
+        checked += node->checkedCount;
+    }
+
+    if (total == 0) {
+        return node->check;
+    }
+    // In layer-only mode, if both objects and directories exist, mark partially checked.
+    if (mode_ == ObjectTreeMode::LAYER_ONLY && !node->objects.empty()) {
+        return Qt::PartiallyChecked;
+    }
+    if (checked == total) {
+        return Qt::Checked;
+    }
+    if (checked > 0 || partial > 0) {
+        return Qt::PartiallyChecked;
+    }
+    return Qt::Unchecked;
+}
+
+ObjectTreeModel::Node* ObjectTreeModel::nodeAt(const QModelIndex& index) const {
+    if (!index.isValid()) {
+        return const_cast<Node*>(&root_);
+    }
+    Node* parent = static_cast<Node*>(index.internalPointer());
+    return size_t(index.row()) < parent->dirs.size() ? parent->dirs[index.row()].get() : nullptr;
+}
+
+QModelIndex ObjectTreeModel::indexOf(const Node* node) const {
+    if (node == &root_) {
+        return QModelIndex();
+    }
+    return createIndex(node->row, 0, node->parent);
+}
+
+QModelIndex ObjectTreeModel::index(int row, int column, const QModelIndex& parent) const {
+    if (!hasIndex(row, column, parent)) {
+        return QModelIndex();
+    }
+    // Indexes point at the parent directory; the row picks a sub-directory or an object.
+    return createIndex(row, column, nodeAt(parent));
+}
+
+QModelIndex ObjectTreeModel::parent(const QModelIndex& child) const {
+    if (!child.isValid()) {
+        return QModelIndex();
+    }
+    return indexOf(static_cast<Node*>(child.internalPointer()));
+}
+
+int ObjectTreeModel::rowCount(const QModelIndex& parent) const {
+    if (parent.column() > 0) {
+        return 0;
+    }
+    const Node* node = nodeAt(parent);
+    return node ? int(node->dirs.size() + node->fetched) : 0;
+}
+
+int ObjectTreeModel::columnCount(const QModelIndex&) const { return 1; }
+
+bool ObjectTreeModel::hasChildren(const QModelIndex& parent) const {
+    const Node* node = parent.column() > 0 ? nullptr : nodeAt(parent);
+    return node && (!node->dirs.empty() || !node->objects.empty());
+}
+
+QVariant ObjectTreeModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid()) {
+        return QVariant();
+    }
+
+    const Node* node = nodeAt(index);
+    const Node* parent = static_cast<const Node*>(index.internalPointer());
+    const size_t pos = size_t(index.row()) - parent->dirs.size();
+    if (role == Qt::DisplayRole) {
+        return node ? node->name : QString::fromStdString(parent->objects[pos]);
+    }
+    if (role == Qt::CheckStateRole) {
+        if (node) {
+            return node->check;
+        }
+        if (mode_ == ObjectTreeMode::ALL) {
+            return parent->checked[pos] ? Qt::Checked : Qt::Unchecked;
+        }
+    }
+    return QVariant();
+}
+
+bool ObjectTreeModel::setData(const QModelIndex& index, const QVariant& value, int role) {
+    if (role != Qt::CheckStateRole || !(flags(index) & Qt::ItemIsUserCheckable)) {
+        return false;
+    }
+
+    const Qt::CheckState state = static_cast<Qt::CheckState>(value.toInt());
+    if (Node* node = nodeAt(index)) {
+        setDirCheckState(node, state);
+    } else {
+        Node* parent = static_cast<Node*>(index.internalPointer());
+        setObjectCheckState(parent, size_t(index.row()) - parent->dirs.size(), state == Qt::Checked);
+    }
+    return true;
+}
+
+Qt::ItemFlags ObjectTreeModel::flags(const QModelIndex& index) const {
+    if (!index.isValid()) {
+        return Qt::NoItemFlags;
+    }
+    // In layer-only mode, objects are listed but disabled.
+    if (nodeAt(index) || mode_ == ObjectTreeMode::ALL) {
+        return Qt::ItemIsEnabled | Qt::ItemIsUserCheckable;
+    }
+    return Qt::NoItemFlags;
+}
+
+bool ObjectTreeModel::canFetchMore(const QModelIndex& parent) const {
+    const Node* node = parent.column() > 0 ? nullptr : nodeAt(parent);
+    return node && node->fetched < node->objects.size();
+}
+
+void ObjectTreeModel::fetchMore(const QModelIndex& parent) {
+    Node* node = parent.column() > 0 ? nullptr : nodeAt(parent);
+    if (!node || node->fetched >= node->objects.size()) {
+        return;
+    }
+
+    const size_t count = std::min(kFetchChunk, node->objects.size() - node->fetched);
+    const int first = int(node->dirs.size() + node->fetched);
+    beginInsertRows(parent, first, first + int(count) - 1);
+    node->fetched += count;
+    endInsertRows();
+}
+
+}  // namespace octo_flex
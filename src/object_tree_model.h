@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_TREE_MODEL_H
+#define OBJECT_TREE_MODEL_H
+
+#include <QAbstractItemModel>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "object_manager.h"
+
+namespace octo_flex {
+
+// Dialog mode enum.
+enum class ObjectTreeMode {
+    ALL,        // All selectable items (layers and objects).
+    LAYER_ONLY  // Layers only.
+};
+
+// Tree of layers and objects read from the scene snapshot.
+// Layer IDs split at '#' into directories under a "Root" node; a layer's objects follow its sub-directories and
+// are exposed in chunks through fetchMore, so a view only creates the rows it scrolls to. refresh() compares the
+// layers whose version changed and turns the difference into row inserts and removes instead of a model reset.
+class ObjectTreeModel : public QAbstractItemModel {
+    Q_OBJECT
+
+   public:
+    explicit ObjectTreeModel(QObject* parent = nullptr);
+    ~ObjectTreeModel() override;
+
+    // Set the object manager and read its scene.
+    void setObjectManager(ObjectManager::Ptr objManager);
+
+    // Set the mode; in LAYER_ONLY mode only directories are checkable.
+    void setMode(ObjectTreeMode mode);
+    ObjectTreeMode mode() const { return mode_; }
+
+    // Sync with the scene, a no-op while the scene generation is unchanged.
+    void refresh();
+
+    // Check layer paths and object IDs, with their subtrees.
+    void checkItems(const std::set<std::string>& items);
+
+    // Checked object IDs, or checked layer paths in LAYER_ONLY mode.
+    std::set<std::string> checkedItems() const;
+
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& child) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+   private:
+    // Directory node; object rows are entries of their layer's sorted ID list.
+    struct Node {
+        std::string path;  // Layer path, "" for the root
+        QString name;
+        Node* parent = nullptr;
+        int row = 0;               // Row under the parent
+        uint64_t version = 0;      // Layer version the objects were read at
+        bool layer = false;        // A scene layer, not only a path prefix
+        Qt::CheckState check = Qt::Unchecked;
+        std::vector<std::unique_ptr<Node>> dirs;  // Sorted by path, shown before the objects
+        std::vector<std::string> objects;         // Sorted object IDs
+        std::vector<char> checked;                // Check state per object
+        size_t checkedCount = 0;
+        size_t fetched = 0;  // Leading objects exposed as rows
+    };
+
+    // Directory at the index, or nullptr for an object row.
+    Node* nodeAt(const QModelIndex& index) const;
+    QModelIndex indexOf(const Node* node) const;
+
+    Node* addDir(Node* parent, size_t pos, const std::string& path);
+    void removeDir(Node* parent, size_t pos);
+    void forgetDirs(const Node* node);
+
+    // Sync the children of a directory; returns whether its direct children changed.
+    bool syncDir(Node* node, const std::unordered_map<std::string, std::set<std::string>>& children,
+                 const LayerList& layers);
+    bool syncObjects(Node* node, const Layer::Ptr& layer);
+
+    // Check a directory with its subtree, or a single object, and update the ancestors.
+    void setDirCheckState(Node* node, Qt::CheckState state);
+    void setObjectCheckState(Node* node, size_t pos, bool checked);
+
+    // Set a subtree's check state without signals, then report each directory's rows with one dataChanged.
+    void setChildCheckState(Node* node, Qt::CheckState state);
+    void emitCheckChanged(const Node* node);
+
+    // Recompute the check state of a directory from its children, and of its ancestors while it changes.
+    void updateParentCheckState(Node* node);
+    Qt::CheckState childCheckState(const Node* node) const;
+
+    void collectChecked(const Node* node, std::set<std::string>& result) const;
+    void collectObjects(const Node* node, std::set<std::string>& result) const;
+
+    ObjectManager::Ptr objManager_;
+    ObjectTreeMode mode_ = ObjectTreeMode::ALL;
+    Node root_;                                         // Invisible parent of the "Root" node
+    std::unordered_map<std::string, Node*> dirIndex_;  // Directory nodes by path
+    uint64_t generation_ = 0;
+    bool synced_ = false;
+};
+
+}  // namespace octo_flex
+
+#endif  // OBJECT_TREE_MODEL_H
@@ -16,26 +16,188 @@
 
 
 #include "octo_flex_view.h"
-#include <GL/glu.h>  // Add GLU header for gluPickMatrix and gluPerspective
+#include <QCoreApplication>
 #include <QCursor>   // Add QCursor header for getting mouse position
+#include <QFontInfo>
 #include <QMenu>
+#include <QMutexLocker>
+#include <QOpenGLExtraFunctions>
 #include <QOpenGLFunctions>
+#include <QOpenGLPaintDevice>
 #include <QPainter>   // Add QPainter header for drawing text
+#include <QPaintEvent>
+#include <QReadWriteLock>
+#include <QResizeEvent>
 #include <QtDebug>    // Correct to proper Qt header format
 #include <algorithm>  // For sorting
+#include <cstddef>    // For offsetof
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
 #include <limits>  // For std::numeric_limits
 
+#include "dynamic_texture_uploader.h"
+#include "gl_deletion_queue.h"
+#include "texture_cache.h"
+#include "texture_manager.h"
 #include "textured_quad.h"
+#include "trace.h"
+#include "trajectory_uploader.h"
 #include "utils.h"
 
 namespace octo_flex {
 
+namespace {
+
+// Static grid: cells of 10 meters, 50 per side (500 meters at the finest scale).
+const int kGridExtent = 50;
+const float kGridCellSize = 10.0f;
+
+// Axis gizmo: 3 lines, then 3 arrow triangles.
+const GLsizei kAxisLineVertexCount = 6;
+const GLsizei kAxisArrowVertexCount = 9;
+
+// Attribute locations of the instancing shader.
+const GLuint kAttrPosition = 0;
+const GLuint kAttrColor = 1;
+const GLuint kAttrInstancePosition = 2;
+const GLuint kAttrInstanceRotation = 3;
+const GLuint kAttrInstanceScale = 4;
+const GLuint kAttrInstanceColor = 5;
+const GLuint kAttrInstanceIndex = 6;
+
+// Prototype vertices are transformed per instance: scale, rotate (quaternion), translate.
+// Instance colors replace the vertex colors, or tint them with u_tint (references).
+// In pick mode the color carries the 24-bit pick ID of the base (given as its bytes, low first) plus
+// the instance index, added bytewise: a float holds neither the base nor the sum exactly past 2^24.
+const char* kInstanceVertexShader = R"(
+#version 120
+attribute vec3 a_position;
+attribute vec4 a_color;
+attribute vec3 i_position;
+attribute vec4 i_rotation;
+attribute vec3 i_scale;
+attribute vec4 i_color;
+attribute float i_index;
+uniform float u_use_instance_color;
+uniform float u_tint;
+uniform float u_pick;
+uniform vec3 u_pick_base;
+varying vec4 v_color;
+
+vec3 rotateVector(vec4 q, vec3 v) {
+    vec3 t = 2.0 * cross(q.xyz, v);
+    return v + q.w * t + cross(q.xyz, t);
+}
+
+// Divisions are rounded up by half a unit first, so an inexact quotient cannot lose a carry.
+vec4 encodeId(vec3 base, float index) {
+    float high = floor((index + 0.5) / 65536.0);
+    index -= high * 65536.0;
+    float mid = floor((index + 0.5) / 256.0);
+    float low = index - mid * 256.0 + base.x;
+    float carry = floor((low + 0.5) / 256.0);
+    low -= carry * 256.0;
+    mid += base.y + carry;
+    carry = floor((mid + 0.5) / 256.0);
+    mid -= carry * 256.0;
+    high = mod(high + base.z + carry, 256.0);
+    return vec4(low, mid, high, 0.0) / 255.0;
+}
+
+void main() {
+    vec3 world = rotateVector(i_rotation, a_position * i_scale) + i_position;
+    gl_Position = gl_ModelViewProjectionMatrix * vec4(world, 1.0);
+    if (u_pick > 0.5) {
+        v_color = encodeId(u_pick_base, i_index);
+    } else {
+        vec3 color = mix(a_color.rgb, i_color.rgb, u_use_instance_color);
+        v_color = vec4(mix(color, a_color.rgb * i_color.rgb, u_tint), a_color.a);
+    }
+}
+)";
+
+const char* kInstanceFragmentShader = R"(
+#version 120
+varying vec4 v_color;
+void main() {
+    gl_FragColor = v_color;
+}
+)";
+
+// Draw mode of a prototype shape.
+GLenum instancedDrawMode(Shape::ShapeType type) {
+    switch (type) {
+        case Shape::Points:
+            return GL_POINTS;
+        case Shape::Lines:
+        case Shape::Dash:
+            return GL_LINES;
+        case Shape::Loop:
+            return GL_LINE_LOOP;
+        case Shape::Polygon:
+            return GL_POLYGON;
+        default:
+            return GL_POINTS;
+    }
+}
+
+// Backend primitive of a shape. Polygons draw as fans, matching GL_POLYGON for convex outlines,
+// and texture-less quads take the same path.
+RenderBackend::Primitive shapePrimitive(Shape::ShapeType type) {
+    switch (type) {
+        case Shape::Lines:
+        case Shape::Dash:
+            return RenderBackend::Lines;
+        case Shape::Loop:
+            return RenderBackend::LineLoop;
+        case Shape::Polygon:
+        case Shape::TexturedQuad:
+            return RenderBackend::TriangleFan;
+        default:
+            return RenderBackend::Points;
+    }
+}
+
+RenderBackend::Primitive batchPrimitive(LayerBatch::Primitive primitive) {
+    switch (primitive) {
+        case LayerBatch::Points:
+            return RenderBackend::Points;
+        case LayerBatch::Lines:
+            return RenderBackend::Lines;
+        default:
+            return RenderBackend::Triangles;
+    }
+}
+
+// Draw style of a batch group.
+RenderBackend::DrawStyle groupStyle(const LayerBatch::Group& group) {
+    RenderBackend::DrawStyle style;
+    style.size = static_cast<float>(group.width);
+    style.dashed = group.stipple;
+    return style;
+}
+
+// Pick ID as an RGBA8 color, low byte in red.
+glm::vec4 encodePickColor(GLuint id) {
+    return glm::vec4(id & 0xFF, (id >> 8) & 0xFF, (id >> 16) & 0xFF, (id >> 24) & 0xFF) / 255.0f;
+}
+
+bool threadedRenderingFromEnvironment() {
+    const QByteArray value = qgetenv("OCTO_FLEX_RENDER_THREAD").trimmed().toLower();
+    return value == "1" || value == "on" || value == "true";
+}
+
+bool& threadedRenderingStorage() {
+    static bool enabled = threadedRenderingFromEnvironment();
+    return enabled;
+}
+
+}  // namespace
+
 OctoFlexView::OctoFlexView(QWidget* parent)
     : QOpenGLWidget(parent),
-      VBO_(0),
       viewMatrix_(1.0f),
       projectionMatrix_(1.0f),
       refreshTimer_(new QTimer(this)),
@@ -55,8 +217,9 @@ OctoFlexView::OctoFlexView(QWidget* parent)
       showGrid_(true) {  // Show grid by default
     // Connect timer to update slot
     connect(refreshTimer_, &QTimer::timeout, this, [this]() {
-        frameCount_++;
-        update();
+        if (refreshMode_ == RefreshMode::CONTINUOUS || needsRepaint()) {
+            update();
+        }
     });
 
     // Connect FPS timer to update slot
@@ -203,7 +366,7 @@ OctoFlexView::OctoFlexView(QWidget* parent)
     // Initially add some test info items
     setInfoItem("view_id", "View ID: " + viewId_);
     setInfoItem("fps", "FPS: 0.0");
-    setInfoItem("refresh_rate", "Target Refresh Rate: " + std::to_string(refreshRate_) + " FPS");
+    updateRefreshInfo();
 
     // Add grid status info
     if (showGrid_) {
@@ -212,6 +375,16 @@ OctoFlexView::OctoFlexView(QWidget* parent)
 }
 
 OctoFlexView::~OctoFlexView() {
+    // Finish the frame in flight first; the context is back on this thread afterwards.
+    renderThread_.reset();
+
+    for (ObjectHandle handle : selectedHandles_) {
+        ObjectRegistry::instance().release(handle);
+    }
+    if (followedHandle_ != kNoObjectHandle) {
+        ObjectRegistry::instance().release(followedHandle_);
+    }
+
     // Stop the refresh timer
     if (refreshTimer_->isActive()) {
         refreshTimer_->stop();
@@ -253,9 +426,25 @@ OctoFlexView::~OctoFlexView() {
         gridButton_ = nullptr;
     }
 
-    // Clean up OpenGL resources
+    // Clean up OpenGL resources; the context outlives this destructor, so stop its release callback.
+    if (context()) {
+        disconnect(context(), &QOpenGLContext::aboutToBeDestroyed, this, nullptr);
+    }
+    QWriteLocker locker(sceneLock());
     makeCurrent();
-    glDeleteBuffers(1, &VBO_);
+    sceneResources_.reset();  // The last view of the scene releases the shared buffers
+    delete pickFbo_;
+    pickFbo_ = nullptr;
+    delete renderTarget_;
+    renderTarget_ = nullptr;
+    delete instanceProgram_;
+    instanceProgram_ = nullptr;
+    releaseStaticGeometry();
+    textRenderer_.release();
+    frameTimer_.release();
+    frameCapture_.release();
+    compositeTarget_.release();
+    backend_.reset();
     doneCurrent();
 }
 
@@ -268,6 +457,7 @@ bool OctoFlexView::initialize() {
 void OctoFlexView::initializeGL() {
     // Initialize OpenGL functions
     initializeOpenGLFunctions();
+    setTraceThreadName("render");
 
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -275,31 +465,410 @@ void OctoFlexView::initializeGL() {
 
     glEnable(GL_DEPTH_TEST);
     glDepthFunc(GL_LEQUAL);
-    glHint(GL_PERSPECTIVE_CORRECTION_HINT, GL_NICEST);
 
     glClearColor(bk_color_.x, bk_color_.y, bk_color_.z, 1.0);
     glDepthMask(GL_TRUE);
 
-    // Generate VBO
-    glGenBuffers(1, &VBO_);
+    initializeBackend();
+
+    // Instanced drawing for instanced shapes; its GLSL 1.20 program reads the fixed-function matrices.
+    if (backend_->type() == RenderBackendType::FIXED_FUNCTION) {
+        initializeInstancing();
+    }
+
+    // Grid and axes are drawn from static buffers.
+    initializeStaticGeometry();
+
+    frameTimer_.initialize(context());
+    frameCapture_.initialize(context());
+
+    // Labels in the widget font; without the atlas they are painted with QPainter.
+    textRenderer_.initialize(context(), font());
+    labelPixelSize_ = static_cast<float>(QFontInfo(font()).pixelSize());
+
+    // Textures upload on a background context sharing with this one (started by the first view).
+    TextureManager::instance()->initialize(context());
+
+    // A re-parented widget gets a new context; drop the buffers and programs with the old one.
+    // initializeGL runs once per context, so this connects once per context.
+    connect(context(), &QOpenGLContext::aboutToBeDestroyed, this, [this]() {
+        QWriteLocker locker(sceneLock());
+        makeCurrent();
+        delete renderTarget_;
+        renderTarget_ = nullptr;
+        frameTimer_.release();
+        frameCapture_.release();
+        compositeTarget_.release();
+        releaseStaticGeometry();
+        textRenderer_.release();
+        backend_.reset();
+        doneCurrent();
+    });
+
+    // Draw the shared scene resources if this context can see them (called again when the context is recreated).
+    {
+        QWriteLocker locker(sceneLock());
+        if (!sceneResources_->attach(context())) {
+            qWarning() << "OctoFlexView: Context does not share with the other views, using private GPU resources.";
+            sceneResources_ = std::make_shared<SceneResources>();
+            sceneResources_->attach(context());
+        }
+    }
 
     // Update view matrix
     viewMatrix_ = camera_->getViewMatrix();
+
+    if (threadedRendering_ && !renderThread_) {
+        startRenderThread();
+    }
+}
+
+void OctoFlexView::startRenderThread() {
+    renderThread_.reset(new RenderThread(this, [this]() { paintThreadedFrame(); }));
+    // Qt composes on the GUI thread, never while a finished frame is copied into the framebuffer, and
+    // recreates the framebuffer only once no frame paints.
+    connect(
+        this, &QOpenGLWidget::aboutToCompose, renderThread_.get(),
+        [this]() {
+            if (composing_) return;
+            composeMutex_.lock();
+            composing_ = true;
+        },
+        Qt::DirectConnection);
+    connect(
+        this, &QOpenGLWidget::frameSwapped, renderThread_.get(),
+        [this]() {
+            if (!composing_) return;
+            composing_ = false;
+            composeMutex_.unlock();
+        },
+        Qt::DirectConnection);
+    connect(this, &QOpenGLWidget::aboutToResize, renderThread_.get(), [this]() { waitForRenderThread(); },
+            Qt::DirectConnection);
+    renderThread_->start();
+}
+
+void OctoFlexView::setThreadedRendering(bool enabled) {
+    if (threadedRendering_ == enabled) return;
+    threadedRendering_ = enabled;
+    if (!enabled) {
+        renderThread_.reset();
+        if (renderTarget_ && isValid()) {
+            makeCurrent();
+            delete renderTarget_;
+            renderTarget_ = nullptr;
+            doneCurrent();
+        }
+    } else if (isValid()) {
+        startRenderThread();
+    }
+    renderStateChanged_ = true;
+    update();
 }
 
-void OctoFlexView::paintGL() {
+bool OctoFlexView::threadedRendering() const { return threadedRendering_; }
+
+bool OctoFlexView::defaultThreadedRendering() { return threadedRenderingStorage(); }
+
+void OctoFlexView::setDefaultThreadedRendering(bool enabled) { threadedRenderingStorage() = enabled; }
+
+void OctoFlexView::waitForRenderThread() const {
+    if (renderThread_) {
+        renderThread_->waitForFrame();
+    }
+}
+
+void OctoFlexView::beginRenderStateChange() {
+    waitForRenderThread();
+    renderStateChanged_ = true;
+}
+
+bool OctoFlexView::ViewState::operator==(const ViewState& other) const {
+    return view == other.view && projection == other.projection && cameraPosition == other.cameraPosition &&
+           perspective == other.perspective && width == other.width && height == other.height &&
+           pixelRatio == other.pixelRatio && panelVersion == other.panelVersion;
+}
+
+OctoFlexView::ViewState OctoFlexView::captureViewState() {
     // Update coordinate system from attached object (if any)
     updateCoordinateSystem();
 
+    ViewState state;
+    state.view = camera_->getViewMatrix();
+    state.projection = projectionMatrix_;
+    state.cameraPosition = camera_->getPosition();
+    state.perspective = isPerspective_;
+    state.width = width();
+    state.height = height();
+    state.pixelRatio = static_cast<float>(devicePixelRatioF());
+    state.panelVersion = infoPanel_ ? infoPanel_->version() : 0;
+    viewMatrix_ = state.view;
+    paintedViewMatrix_ = state.view;
+    return state;
+}
+
+void OctoFlexView::paintEvent(QPaintEvent* event) {
+    // Painted here by Qt, which makes the context current and calls paintGL(): without a render thread,
+    // for the first frame at a new size (composed right after the resize) and into a recording composite.
+    if (!renderThread_ || resizing_ || composite_) {
+        waitForRenderThread();
+        QOpenGLWidget::paintEvent(event);
+        return;
+    }
+
+    // The render thread asks the widget to compose each frame it finished; only a changed state paints again.
+    const ViewState state = captureViewState();
+    const bool refining = refining_.exchange(false);
+    if (!renderStateChanged_ && !refining && state == publishedState_ && !needsRepaint()) {
+        return;
+    }
+    renderStateChanged_ = false;
+    publishedState_ = state;
+    viewStates_.back() = state;
+    viewStates_.publish();
+    renderThread_->requestFrame();
+}
+
+void OctoFlexView::resizeEvent(QResizeEvent* event) {
+    resizing_ = true;
+    QOpenGLWidget::resizeEvent(event);
+    resizing_ = false;
+}
+
+void OctoFlexView::initializeBackend() {
+    const RenderBackendType type = RenderBackend::defaultType();
+    backend_ = RenderBackend::create(type);
+    if (!backend_->initialize(context()) && type != RenderBackendType::FIXED_FUNCTION) {
+        qWarning() << "OctoFlexView: Cannot use the" << RenderBackend::typeName(type)
+                   << "render backend, falling back to fixed function.";
+        backend_ = RenderBackend::create(RenderBackendType::FIXED_FUNCTION);
+        backend_->initialize(context());
+    }
+    setInfoItem("render_backend", std::string("Backend: ") + RenderBackend::typeName(backend_->type()));
+}
+
+void OctoFlexView::initializeInstancing() {
+    drawArraysInstanced_ =
+        reinterpret_cast<DrawArraysInstancedFn>(context()->getProcAddress("glDrawArraysInstanced"));
+    if (!drawArraysInstanced_) {
+        drawArraysInstanced_ =
+            reinterpret_cast<DrawArraysInstancedFn>(context()->getProcAddress("glDrawArraysInstancedARB"));
+    }
+    drawElementsInstanced_ =
+        reinterpret_cast<DrawElementsInstancedFn>(context()->getProcAddress("glDrawElementsInstanced"));
+    if (!drawElementsInstanced_) {
+        drawElementsInstanced_ =
+            reinterpret_cast<DrawElementsInstancedFn>(context()->getProcAddress("glDrawElementsInstancedARB"));
+    }
+    vertexAttribDivisor_ = reinterpret_cast<VertexAttribDivisorFn>(context()->getProcAddress("glVertexAttribDivisor"));
+    if (!vertexAttribDivisor_) {
+        vertexAttribDivisor_ =
+            reinterpret_cast<VertexAttribDivisorFn>(context()->getProcAddress("glVertexAttribDivisorARB"));
+    }
+    if (!drawArraysInstanced_ || !vertexAttribDivisor_) {
+        qWarning() << "OctoFlexView: Instanced drawing not supported, using per-instance fallback.";
+        return;
+    }
+
+    instanceProgram_ = new QOpenGLShaderProgram();
+    instanceProgram_->addShaderFromSourceCode(QOpenGLShader::Vertex, kInstanceVertexShader);
+    instanceProgram_->addShaderFromSourceCode(QOpenGLShader::Fragment, kInstanceFragmentShader);
+    instanceProgram_->bindAttributeLocation("a_position", kAttrPosition);
+    instanceProgram_->bindAttributeLocation("a_color", kAttrColor);
+    instanceProgram_->bindAttributeLocation("i_position", kAttrInstancePosition);
+    instanceProgram_->bindAttributeLocation("i_rotation", kAttrInstanceRotation);
+    instanceProgram_->bindAttributeLocation("i_scale", kAttrInstanceScale);
+    instanceProgram_->bindAttributeLocation("i_color", kAttrInstanceColor);
+    instanceProgram_->bindAttributeLocation("i_index", kAttrInstanceIndex);
+    if (!instanceProgram_->link()) {
+        qWarning() << "OctoFlexView: Failed to link instancing shader, using per-instance fallback:"
+                   << instanceProgram_->log();
+        delete instanceProgram_;
+        instanceProgram_ = nullptr;
+    }
+}
+
+void OctoFlexView::initializeStaticGeometry() {
+    releaseStaticGeometry();
+
+    // Grid cells on the XY plane around the origin, gray near the center fading to white.
+    std::vector<Shape::GpuVertex> grid;
+    const float half = kGridExtent * kGridCellSize / 2;
+    const float z = -1e-3f;
+    grid.reserve((kGridExtent + 1) * (kGridExtent + 1) * 4);
+    for (int i = 0; i <= kGridExtent; ++i) {
+        const float y = -half + i * kGridCellSize;
+        for (int j = 0; j <= kGridExtent; ++j) {
+            const float x = -half + j * kGridCellSize;
+
+            // Both segments take the color of the cell corner, as the immediate-mode grid did.
+            const float t = std::min(std::sqrt(x * x + y * y) / half, 1.0f);
+            const float gray = 0.5f + t * 0.5f;
+            grid.push_back({x, y, z, gray, gray, gray, 1.0f});
+            grid.push_back({x + kGridCellSize, y, z, gray, gray, gray, 1.0f});
+            grid.push_back({x, y, z, gray, gray, gray, 1.0f});
+            grid.push_back({x, y + kGridCellSize, z, gray, gray, gray, 1.0f});
+        }
+    }
+    gridVertexCount_ = static_cast<GLsizei>(grid.size());
+
+    // Axes: three lines from the origin, then one arrow triangle per axis.
+    const float axisLength = 5.0f;   // Axis length.
+    const float arrowHeight = 0.3f;  // Arrow height (along axis).
+    const float arrowWidth = 0.08f;  // Arrow width (perpendicular to axis).
+    const float base = axisLength - arrowHeight;
+    const Shape::GpuVertex axes[kAxisLineVertexCount + kAxisArrowVertexCount] = {
+        {0, 0, 0, 1, 0, 0, 1}, {axisLength, 0, 0, 1, 0, 0, 1},  // X axis - red.
+        {0, 0, 0, 0, 1, 0, 1}, {0, axisLength, 0, 0, 1, 0, 1},  // Y axis - green.
+        {0, 0, 0, 0, 0, 1, 1}, {0, 0, axisLength, 0, 0, 1, 1},  // Z axis - blue.
+        {axisLength, 0, 0, 1, 0, 0, 1}, {base, arrowWidth, 0, 1, 0, 0, 1}, {base, -arrowWidth, 0, 1, 0, 0, 1},
+        {0, axisLength, 0, 0, 1, 0, 1}, {arrowWidth, base, 0, 0, 1, 0, 1}, {-arrowWidth, base, 0, 0, 1, 0, 1},
+        {0, 0, axisLength, 0, 0, 1, 1}, {arrowWidth, 0, base, 0, 0, 1, 1}, {-arrowWidth, 0, base, 0, 0, 1, 1},
+    };
+
+    glGenBuffers(1, &gridBuffer_);
+    glBindBuffer(GL_ARRAY_BUFFER, gridBuffer_);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(grid.size() * sizeof(Shape::GpuVertex)), grid.data(),
+                 GL_STATIC_DRAW);
+    glGenBuffers(1, &axesBuffer_);
+    glBindBuffer(GL_ARRAY_BUFFER, axesBuffer_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(axes), axes, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void OctoFlexView::releaseStaticGeometry() {
+    if (gridBuffer_ != 0) {
+        glDeleteBuffers(1, &gridBuffer_);
+        gridBuffer_ = 0;
+    }
+    if (axesBuffer_ != 0) {
+        glDeleteBuffers(1, &axesBuffer_);
+        axesBuffer_ = 0;
+    }
+    gridVertexCount_ = 0;
+}
+
+void OctoFlexView::paintGL() { paintFrame(true); }
+
+void OctoFlexView::paintThreadedFrame() {
+    viewStates_.update();
+
+    // Without framebuffer blits the frame paints into the widget's framebuffer, which Qt then cannot
+    // compose meanwhile.
+    if (!QOpenGLFramebufferObject::hasOpenGLFramebufferBlit()) {
+        QMutexLocker locker(&composeMutex_);
+        paintFrame(false);
+        glFlush();
+        return;
+    }
+
+    // Sized by the state the frame paints, at the widget's sample count so the copy is sample for sample.
+    const ViewState& state = viewStates_.front();
+    const QSize size(qRound(state.width * state.pixelRatio), qRound(state.height * state.pixelRatio));
+    if (size.isEmpty()) return;
+    if (!renderTarget_ || renderTarget_->size() != size) {
+        delete renderTarget_;
+        QOpenGLFramebufferObjectFormat targetFormat;
+        targetFormat.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
+        targetFormat.setSamples(format().samples());
+        renderTarget_ = new QOpenGLFramebufferObject(size, targetFormat);
+    }
+    if (!renderTarget_->isValid()) {
+        qWarning() << "OctoFlexView: Failed to create the render thread framebuffer.";
+        delete renderTarget_;
+        renderTarget_ = nullptr;
+        return;
+    }
+    renderTarget_->bind();
+    glViewport(0, 0, size.width(), size.height());
+    paintFrame(false);
+
+    // Only the copy waits for a compose in progress; the widget is composed from another context of
+    // the share group, so the copy is flushed before the lock is released.
+    QMutexLocker locker(&composeMutex_);
+    QOpenGLExtraFunctions* gl = context()->extraFunctions();
+    gl->glBindFramebuffer(GL_READ_FRAMEBUFFER, renderTarget_->handle());
+    gl->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, defaultFramebufferObject());
+    gl->glBlitFramebuffer(0, 0, size.width(), size.height(), 0, 0, size.width(), size.height(), GL_COLOR_BUFFER_BIT,
+                          GL_NEAREST);
+    gl->glBindFramebuffer(GL_FRAMEBUFFER, defaultFramebufferObject());
+    gl->glFlush();
+}
+
+void OctoFlexView::paintFrame(bool guiThread) {
+    frameCount_++;
+    frameTimer_.beginFrame();
+    frameTimer_.beginPass(FrameTimer::Update);
+
+    // The state shared with the other views is updated by one frame at a time, then drawn by all.
+    QWriteLocker sceneWrite(sceneLock());
+
+    // Apply updates queued by producer threads since the last frame.
+    if (obj_mgr_) {
+        obj_mgr_->drainUpdates();
+    }
+
+    // Camera and viewport; the render thread takes what the last paint event published.
+    frameOnGuiThread_ = guiThread;
+    if (guiThread) {
+        frame_ = captureViewState();
+    } else {
+        frame_ = viewStates_.front();
+    }
+
+    // Let the next texture uploads in, evict unused cached textures over the memory budget, and show
+    // the uploads finished since the last frame.
+    TextureManager::instance()->beginFrame();
+    TextureCache::instance()->beginFrame();
+    // GPU resources released elsewhere since the last frame of this share group.
+    GlDeletionQueue::instance()->collect();
+    paintedTextureBatches_ = TextureManager::instance()->completedBatches();
+
+    // New frames of dynamic textures, before anything is drawn with them.
+    paintedDynamicFrames_ = DynamicTextureUploader::instance()->submitted();
+    DynamicTextureUploader::instance()->uploadPending();
+    // Points appended to trajectories, uploaded into their ring buffers.
+    paintedTrajectories_ = TrajectoryUploader::instance()->submitted();
+    TrajectoryUploader::instance()->uploadPending();
+    // Scalar values replaced since the last frame; only their float arrays are uploaded.
+    paintedScalars_ = ScalarUploader::instance()->submitted();
+    ScalarUploader::instance()->uploadPending();
+
+    // Batches of the shown layers, rebuilt or updated before any view draws with them.
+    struct VisibleLayer {
+        LayerBatch::Ptr batch;
+        std::vector<char> visible;
+        bool allVisible;
+    };
+    std::vector<VisibleLayer> visibleLayers;
+    if (obj_mgr_) {
+        auto layers = obj_mgr_->layersSnapshot();
+        for (const auto& [layer_id, layer] : *layers) {
+            if (unvisable_layers_.count(layer_id) > 0) continue;
+            visibleLayers.push_back({updateLayerBatch(layer_id, layer), {}, true});
+        }
+    }
+    // The other contexts of the share group draw with what was uploaded here.
+    glFlush();
+    sceneWrite.unlock();
+    frameTimer_.endPass(FrameTimer::Update);
+    frameTimer_.beginPass(FrameTimer::Opaque);
+    QReadLocker sceneRead(sceneLock());
+
+    // Remember what this frame shows; read the generation first so a concurrent change repaints again.
+    paintedGeneration_ = obj_mgr_ ? obj_mgr_->generation() : 0;
+    hasPainted_ = true;
+
     // Clear previous frame's object info list
     objectInfoToRender_.clear();
+    infoObjects_.clear();
 
     // Clear the color and depth buffer
     glClear(GL_COLOR_BUFFER_BIT);
     glClearColor(bk_color_.x, bk_color_.y, bk_color_.z, 1.0);
 
-    // Use fixed-function pipeline
-    setupFixedFunctionPipeline();
+    // Start the pass with this frame's camera.
+    backend_->beginPass(frame_.projection, frame_.view, glm::vec2(frame_.width, frame_.height) * frame_.pixelRatio);
 
     // If grid is enabled, render XY plane grid
     if (showGrid_) {
@@ -310,55 +879,159 @@ void OctoFlexView::paintGL() {
     renderCoordinateSystem();
 
     // Render all objects in the object manager
-    if (obj_mgr_ == nullptr) return;
+    if (obj_mgr_ == nullptr) {
+        backend_->endPass();
+        frameTimer_.endPass(FrameTimer::Opaque);
+        frameTimer_.endFrame();
+        return;
+    }
 
-    // First render: render all opaque shapes
-    auto layers = obj_mgr_->layers();
-    for (const auto& [layer_id, layer] : layers) {
-        if (unvisable_layers_.count(layer_id) > 0) continue;
-        auto objects = layer->objects();
-        for (const auto& [obj_id, object] : objects) {
-            renderObject(*object, RenderMode::RENDER, 0, false);
+    // Cull objects against the view frustum.
+    const glm::mat4 viewProjection = frame_.projection * frame_.view;
+    const Frustum frustum(viewProjection);
+    size_t culledObjects = 0;
+    size_t totalObjects = 0;
+
+    // Point clouds refine progressively while the camera is still.
+    if (viewProjection == lodViewProjection_) {
+        frameBudget_ = std::min(frameBudget_ * 2, refinedPointBudget_);
+    } else {
+        frameBudget_ = pointBudget_;
+    }
+    lodViewProjection_ = viewProjection;
+    remainingBudget_ = frameBudget_;
+    lodLimited_ = false;
+    lodParams_.frustum = frustum;
+    lodFrustumMatrix_ = viewProjection;
+    lodParams_.eye = glm::vec3(glm::inverse(frame_.view)[3]);
+    lodParams_.pixelScale = frame_.projection[1][1] * frame_.height * 0.5f;
+    lodParams_.perspective = frame_.perspective;
+    lodParams_.refinePixels = 100.0f;  // About sqrt(node capacity): finer nodes add no visible detail
+
+    // Single traversal: cull, render opaque shapes and queue transparent objects.
+    transparentDraws_.clear();
+    nextLodLevels_.clear();
+    for (auto& entry : visibleLayers) {
+        const auto& objects = entry.batch->objects();
+        const auto& infos = entry.batch->objectInfos();
+        entry.visible.resize(objects.size(), 1);
+        for (size_t i = 0; i < objects.size(); ++i) {
+            const Object& object = *objects[i];
+            const BoundingBox bounds = object.bounds();
+            if (!frustum.intersects(bounds)) {
+                entry.visible[i] = 0;
+                entry.allVisible = false;
+                culledObjects++;
+                continue;
+            }
+
+            // Queue info text for selected objects.
+            if (!selectedHandles_.empty() && selectedHandles_.count(object.handle()) > 0) {
+                queueObjectInfo(object);
+            }
+
+            const int level = selectLodLevel(object, bounds);
+            entry.visible[i] = static_cast<char>(1 + level);
+
+            if (sortTransparent_ && infos[i].hasTransparent()) {
+                Vec3 center = bounds.valid ? bounds.center() : Vec3(0, 0, 0);
+                glm::vec4 viewPos = frame_.view * glm::vec4(center.x, center.y, center.z, 1.0f);
+                transparentDraws_.push_back({-viewPos.z, entry.batch.get(), static_cast<int>(i), level});
+            }
+        }
+        totalObjects += objects.size();
+
+        renderLayerBatch(*entry.batch, false, entry.visible, entry.allVisible);
+        for (size_t i = 0; i < objects.size(); ++i) {
+            if (entry.visible[i] && infos[i].unbatchedOpaque) {
+                renderUnbatchedShapes(*objects[i], false, infos[i].posed, entry.visible[i] - 1);
+            }
         }
     }
+    culledObjectCount_ = culledObjects;
+    totalObjectCount_ = totalObjects;
+
+    lodLevels_.swap(nextLodLevels_);
+    frameTimer_.endPass(FrameTimer::Opaque);
 
     // Second render: render all transparent shapes
+    frameTimer_.beginPass(FrameTimer::Transparent);
     glDepthMask(GL_FALSE);
-    for (const auto& [layer_id, layer] : layers) {
-        if (unvisable_layers_.count(layer_id) > 0) continue;
-        auto objects = layer->objects();
-        for (const auto& [obj_id, object] : objects) {
-            renderObject(*object, RenderMode::RENDER, 0, true);
+    if (sortTransparent_) {
+        // Back to front, so overlapping translucent objects blend in order.
+        std::sort(transparentDraws_.begin(), transparentDraws_.end(),
+                  [](const TransparentDraw& a, const TransparentDraw& b) { return a.depth > b.depth; });
+        renderSortedTransparent(transparentDraws_);
+    } else {
+        for (const auto& entry : visibleLayers) {
+            renderLayerBatch(*entry.batch, true, entry.visible, entry.allVisible);
+            const auto& objects = entry.batch->objects();
+            const auto& infos = entry.batch->objectInfos();
+            for (size_t i = 0; i < objects.size(); ++i) {
+                if (entry.visible[i] && infos[i].unbatchedTransparent) {
+                    renderUnbatchedShapes(*objects[i], true, infos[i].posed, entry.visible[i] - 1);
+                }
+            }
         }
     }
     glDepthMask(GL_TRUE);
 
     // Reset OpenGL state before using QPainter, to prevent TexturedQuad from affecting text rendering
-    glDisable(GL_TEXTURE_2D);
+    backend_->endPass();
     glBindTexture(GL_TEXTURE_2D, 0);
     // Key: restore pixel alignment to OpenGL default values, TexturedQuad changes this setting causing text
     // misalignment
     glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
     glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    frameTimer_.endPass(FrameTimer::Transparent);
 
-    // Use QPainter to draw object info text
+    // Draw object info text
+    frameTimer_.beginPass(FrameTimer::ObjectText);
+    projectObjectInfo();
     if (!objectInfoToRender_.empty()) {
         drawObjectInfoText();
     }
+    frameTimer_.endPass(FrameTimer::ObjectText);
 
     // Draw info panel
+    frameTimer_.beginPass(FrameTimer::InfoPanel);
     if (infoPanel_) {
         bool isVisible = infoPanel_->isVisible();
         // std::cout << "OctoFlexView::paintGL - info panel state: " << (isVisible ? "shown" : "hidden")
         //           << std::endl;
 
-        if (isVisible) {
-            QPainter painter(this);
+        if (isVisible && textRenderer_.isValid()) {
+            // Laid out again when the items change; the version is read first so a change racing the
+            // layout is picked up next frame.
+            const uint64_t version = infoPanel_->version();
+            if (version != panelVersion_ || panelBatch_.empty()) {
+                panelVersion_ = version;
+                infoPanel_->layout(textRenderer_, panelBatch_);
+            }
+            textRenderer_.draw(panelBatch_, static_cast<float>(frame_.width), static_cast<float>(frame_.height));
+        } else if (isVisible) {
+            QOpenGLPaintDevice device;  // Outlives the painter
+            QPainter painter;
+            beginOverlayPainter(painter, device);
             // std::cout << "OctoFlexView::paintGL - Creating QPainter to draw info panel" << std::endl;
             infoPanel_->draw(painter);
             // std::cout << "OctoFlexView::paintGL - Info panel drawing completed" << std::endl;
         }
     }
+    frameTimer_.endPass(FrameTimer::InfoPanel);
+
+    // Hand the finished frame, overlays included, to the layout composite being recorded.
+    if (compositeChanged_) {
+        compositeTarget_.release();
+        compositeChanged_ = false;
+    }
+    // Recording views paint on the GUI thread (see paintEvent()).
+    if (guiThread && composite_ && composite_->isValid() &&
+        QOpenGLContext::areSharing(context(), composite_->context())) {
+        const qreal pixelRatio = devicePixelRatioF();
+        const QSize frameSize(qRound(width() * pixelRatio), qRound(height() * pixelRatio));
+        compositeTarget_.draw(*composite_, defaultFramebufferObject(), frameSize, compositeRect_);
+    }
 
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -366,12 +1039,26 @@ void OctoFlexView::paintGL() {
 
     glEnable(GL_DEPTH_TEST);
     glDepthFunc(GL_LEQUAL);
-    glHint(GL_PERSPECTIVE_CORRECTION_HINT, GL_NICEST);
 
     // Clear outdated objects after rendering (deferred deletion)
+    sceneRead.unlock();
+    frameTimer_.beginPass(FrameTimer::Cleanup);
     if (obj_mgr_) {
+        QWriteLocker locker(sceneLock());
         obj_mgr_->clearOutdatedObjects();
     }
+    frameTimer_.endPass(FrameTimer::Cleanup);
+    frameTimer_.endFrame();
+
+    // Continue refining point clouds that were cut short by the budget; the render thread's frames are
+    // composed with an update() anyway, whose paint event then hands over the next frame.
+    if (lodLimited_ && frameBudget_ < refinedPointBudget_) {
+        if (guiThread) {
+            QTimer::singleShot(0, this, [this]() { update(); });
+        } else {
+            refining_ = true;
+        }
+    }
 }
 
 // Get camera.
@@ -397,60 +1084,53 @@ void OctoFlexView::copyCamera(const Camera::Ptr& sourceCamera) {
     }
 }
 
-void OctoFlexView::setupFixedFunctionPipeline() {
-    // Setup projection matrix
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-
-    // Convert glm matrix to OpenGL matrix
-    GLfloat projMatrix[16];
-    const float* projSource = glm::value_ptr(projectionMatrix_);
-    for (int i = 0; i < 16; i++) {
-        projMatrix[i] = projSource[i];
-    }
-    glLoadMatrixf(projMatrix);
-
-    // Setup modelview matrix
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
-
-    // Update view matrix.
-    viewMatrix_ = camera_->getViewMatrix();
-
-    // Convert glm matrix to OpenGL matrix
-    GLfloat viewMatrix[16];
-    const float* viewSource = glm::value_ptr(this->viewMatrix_);
-    for (int i = 0; i < 16; i++) {
-        viewMatrix[i] = viewSource[i];
-    }
-    glLoadMatrixf(viewMatrix);
-
-    /*
-    // Enable two-sided lighting.
-    glLightModeli(GL_LIGHT_MODEL_TWO_SIDE, GL_TRUE);
-    */
-
-    // Enable vertex and color arrays
-    glEnableClientState(GL_VERTEX_ARRAY);
-    glEnableClientState(GL_COLOR_ARRAY);
-}
-
 void OctoFlexView::renderObject(const Object& object, RenderMode mode, GLuint nameID, bool transparent) {
-    // If in selection mode, set the object name ID.
+    // If in selection mode, encode the object name ID as the draw color.
     if (mode == RenderMode::SELECT) {
-        glLoadName(nameID);
+        pickColor_ = encodePickColor(nameID);
     }
 
     // Check if the object is selected (render mode only).
-    bool isSelected = selectedObjects_.count(object.id()) > 0;
+    bool isSelected = selectedHandles_.count(object.handle()) > 0;
 
-    // In opaque render pass, compute and store info text position for selected objects.
+    // In opaque render pass, queue info text for selected objects.
     if (mode == RenderMode::RENDER && isSelected && !transparent) {
-        calculateObjectInfoPosition(object, transparent);
+        queueObjectInfo(object);
     }
 
     // Render all shapes.
-    for (const auto& shape : object.shapes()) {
+    PointCloudShape::LodParams worldLod;
+    const bool posed = pushObjectTransform(object, worldLod);
+    if (mode == RenderMode::RENDER) {
+        beginObjectScalars(object);
+    }
+    const auto& shapes = object.shapes();
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        const Shape::Ptr& shape = shapes[i];
+        // Levels of detail cover the same surface, so the finest one stands for all.
+        if (shape->lodLevel() > 0) continue;
+        setShapeScalars(i);
+        if (shape->type() == Shape::PointCloud) {
+            if (mode == RenderMode::SELECT || (shape->transparency() < 0.99) == transparent) {
+                renderPointCloud(static_cast<const PointCloudShape&>(*shape), mode);
+            }
+            continue;
+        }
+        if (shape->type() == Shape::Trajectory) {
+            if (mode == RenderMode::SELECT || (shape->transparency() < 0.99) == transparent) {
+                renderTrajectory(static_cast<const TrajectoryShape&>(*shape), mode);
+            }
+            continue;
+        }
+
+        // Instanced shapes filter their prototype shapes by pass and are picked per instance.
+        if (shape->type() == Shape::Instanced) {
+            if (mode == RenderMode::RENDER) {
+                renderInstancedShape(static_cast<const InstancedShape&>(*shape), mode, transparent);
+            }
+            continue;
+        }
+
         // Filter by transparency; all shapes respect transparency parameter.
         bool isShapeTransparent = (shape->transparency() < 0.99);
 
@@ -460,147 +1140,535 @@ void OctoFlexView::renderObject(const Object& object, RenderMode mode, GLuint na
             renderShape(*shape, mode);
         }
     }
+    endObjectScalars();
+    if (posed) {
+        popObjectTransform(worldLod);
+    }
 }
 
-// Compute display position for object info text.
-void OctoFlexView::calculateObjectInfoPosition(const Object& object, bool transparent) {
-    // Only compute during opaque render pass.
-    if (transparent) return;
+bool OctoFlexView::pushObjectTransform(const Object& object, PointCloudShape::LodParams& worldLod) {
+    GLfloat matrix[16];
+    if (!object.modelMatrix(matrix)) return false;
 
-    // Get current modelview and projection matrices.
-    GLdouble modelMatrix[16], projMatrix[16];
-    GLint viewport[4];
-    glGetDoublev(GL_MODELVIEW_MATRIX, modelMatrix);
-    glGetDoublev(GL_PROJECTION_MATRIX, projMatrix);
-    glGetIntegerv(GL_VIEWPORT, viewport);
+    const glm::mat4 model = glm::make_mat4(matrix);
+    backend_->pushModel(model);
+
+    // The transform is rigid, so only the frustum and eye need to move into the object's frame.
+    worldLod = lodParams_;
+    lodParams_.frustum = Frustum(lodFrustumMatrix_ * model);
+    lodParams_.eye = glm::vec3(glm::inverse(model) * glm::vec4(worldLod.eye, 1.0f));
+    return true;
+}
+
+void OctoFlexView::popObjectTransform(const PointCloudShape::LodParams& worldLod) {
+    backend_->popModel();
+    lodParams_ = worldLod;
+}
+
+LayerBatch::Ptr OctoFlexView::updateLayerBatch(const std::string& layerId, const Layer::Ptr& layer) {
+    return sceneResources_->layerBatch(layerId, layer);
+}
+
+void OctoFlexView::renderLayerBatch(const LayerBatch& batch, bool transparent, const std::vector<char>& visible,
+                                    bool allVisible) {
+    if (batch.vertexBuffer() == 0) return;
+
+    RenderBackend::VertexSource source;
+    source.buffer = batch.vertexBuffer();
+
+    std::vector<GLint> firsts;
+    std::vector<GLsizei> counts;
+
+    // One draw call per render state group.
+    for (const auto& group : batch.groups()) {
+        if (group.transparent != transparent) continue;
 
-    // Find the highest screen-space point (max Y in OpenGL screen coords).
-    double maxScreenY = -std::numeric_limits<double>::max();
-    double correspondingScreenX = 0;
-    double correspondingScreenZ = 0;
-
-    // Walk all points in the object.
-    for (const auto& shape : object.shapes()) {
-        for (const auto& point : shape->points()) {
-            // Project 3D point to screen space.
-            GLdouble screenX, screenY, screenZ;
-            gluProject(point.x, point.y, point.z, modelMatrix, projMatrix, viewport, &screenX, &screenY, &screenZ);
-
-            // Update highest point (max Y in OpenGL screen coords).
-            if (screenY > maxScreenY) {
-                maxScreenY = screenY;
-                correspondingScreenX = screenX;
-                correspondingScreenZ = screenZ;
+        // Collect visible object ranges, merging adjacent ones.
+        firsts.clear();
+        counts.clear();
+        if (allVisible && !group.leveled && group.dead == 0) {
+            firsts.push_back(group.first);
+            counts.push_back(group.count);
+        } else {
+            for (const auto& range : group.ranges) {
+                if (!visible[range.object]) continue;
+                if (range.level >= 0 && range.level != visible[range.object] - 1) continue;
+                if (!firsts.empty() && firsts.back() + counts.back() == range.first) {
+                    counts.back() += range.count;
+                } else {
+                    firsts.push_back(range.first);
+                    counts.push_back(range.count);
+                }
             }
         }
+        if (firsts.empty()) continue;
+
+        backend_->draw(source, batchPrimitive(group.primitive), firsts.data(), counts.data(),
+                       static_cast<GLsizei>(firsts.size()), groupStyle(group));
+    }
+}
+
+void OctoFlexView::renderUnbatchedShapes(const Object& object, bool transparent, bool posed, int level) {
+    PointCloudShape::LodParams worldLod;
+    const bool pushed = posed && pushObjectTransform(object, worldLod);
+    // Objects with scalars are left out of the batch as a whole (see LayerBatch::build).
+    const bool all = posed || object.scalars();
+    beginObjectScalars(object);
+    const auto& shapes = object.shapes();
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        const Shape::Ptr& shape = shapes[i];
+        if (!all && LayerBatch::isBatchable(*shape)) continue;
+        if (shape->lodLevel() >= 0 && shape->lodLevel() != level) continue;
+        setShapeScalars(i);
+        if (shape->type() == Shape::Instanced) {
+            renderInstancedShape(static_cast<const InstancedShape&>(*shape), RenderMode::RENDER, transparent);
+            continue;
+        }
+        bool isShapeTransparent = (shape->transparency() < 0.99);
+        if (isShapeTransparent != transparent) continue;
+        if (shape->type() == Shape::PointCloud) {
+            renderPointCloud(static_cast<const PointCloudShape&>(*shape), RenderMode::RENDER);
+        } else if (shape->type() == Shape::Trajectory) {
+            renderTrajectory(static_cast<const TrajectoryShape&>(*shape), RenderMode::RENDER);
+        } else {
+            renderShape(*shape, RenderMode::RENDER);
+        }
+    }
+    endObjectScalars();
+    if (pushed) {
+        popObjectTransform(worldLod);
     }
+}
 
-    // Show text only if the point is inside the view (Z in [0, 1]).
-    if (correspondingScreenZ >= 0.0 && correspondingScreenZ <= 1.0) {
-        // Store object info and screen coordinates to draw after paintGL.
-        // Note: Qt Y grows downward while OpenGL Y grows upward, so flip Y.
-        // Offset slightly above the highest point for readability.
-        const int TEXT_OFFSET_Y = 15;  // Upward pixel offset.
-        objectInfoToRender_.push_back({object.info(), object.textColor(), static_cast<int>(correspondingScreenX),
-                                       static_cast<int>(viewport[3] - maxScreenY - TEXT_OFFSET_Y)});
+void OctoFlexView::beginObjectScalars(const Object& object) {
+    objectScalars_ = ObjectScalars();
+    const ScalarField* field = object.scalars().get();
+    if (!field) return;
+    objectScalars_.field = field;
+    objectScalars_.mapping = field->mapping();
+    if (field->isPerObject()) {
+        const Vec3 color = field->objectColor();
+        objectScalars_.color = glm::vec3(color.x, color.y, color.z);
     }
 }
 
-// Render a single shape.
-void OctoFlexView::renderShape(const Shape& shape, RenderMode mode) {
-    const auto& points = shape.points();
+void OctoFlexView::setShapeScalars(size_t shapeIndex) {
+    if (!objectScalars_.field || objectScalars_.field->isPerObject()) return;
+    const int64_t first = objectScalars_.field->shapeOffset(shapeIndex);
+    objectScalars_.offset = first >= 0 ? static_cast<GLintptr>(first * sizeof(float)) : -1;
+}
 
-    if (points.empty()) return;
+void OctoFlexView::applyScalars(const Shape& shape, RenderBackend::DrawStyle& style) const {
+    const ScalarField* field = objectScalars_.field;
+    if (!field) return;
+    const float alpha = static_cast<float>(shape.transparency());
+    if (field->isPerObject()) {
+        style.vertexColors = false;
+        style.color = glm::vec4(objectScalars_.color, alpha);
+        return;
+    }
+    // Shapes without values, or values not uploaded yet, keep their vertex colors.
+    const GLuint colormap = ScalarUploader::instance()->colormapTexture(objectScalars_.mapping.colormap);
+    if (objectScalars_.offset < 0 || field->buffer() == 0 || colormap == 0) return;
+    style.vertexColors = false;
+    style.color = glm::vec4(1.0f, 1.0f, 1.0f, alpha);
+    style.scalarBuffer = field->buffer();
+    style.scalarOffset = objectScalars_.offset;
+    style.colormap = colormap;
+    style.scalarMin = objectScalars_.mapping.min;
+    style.scalarMax = objectScalars_.mapping.max;
+}
+
+void OctoFlexView::renderSortedTransparent(const std::vector<TransparentDraw>& draws) {
+    for (const auto& draw : draws) {
+        const auto& info = draw.batch->objectInfos()[draw.object];
+
+        if (!info.transparent.empty() && draw.batch->vertexBuffer() != 0) {
+            RenderBackend::VertexSource source;
+            source.buffer = draw.batch->vertexBuffer();
+            for (const auto& range : info.transparent) {
+                if (range.level >= 0 && range.level != draw.level) continue;
+                const auto& group = draw.batch->groups()[range.group];
+                backend_->draw(source, batchPrimitive(group.primitive), range.first, range.count, groupStyle(group));
+            }
+        }
+
+        if (info.unbatchedTransparent) {
+            renderUnbatchedShapes(*draw.batch->objects()[draw.object], true, info.posed, draw.level);
+        }
+    }
+}
+
+int OctoFlexView::selectLodLevel(const Object& object, const BoundingBox& bounds) {
+    if (object.lodSizes().empty() || !bounds.valid) return 0;
+
+    // Projected diameter of the bounding sphere; from inside it the object fills the view.
+    const glm::vec3 lo(bounds.min.x, bounds.min.y, bounds.min.z);
+    const glm::vec3 hi(bounds.max.x, bounds.max.y, bounds.max.z);
+    const float diameter = glm::distance(lo, hi);
+    float pixels = diameter * lodParams_.pixelScale;
+    if (lodParams_.perspective) {
+        const float distance = glm::distance((lo + hi) * 0.5f, lodParams_.eye);
+        if (distance <= diameter * 0.5f) return 0;
+        pixels /= distance;
+    }
+
+    const auto last = lodLevels_.find(object.handle());
+    const int current = last == lodLevels_.end() ? -1 : last->second;
+    const int level = object.lodLevelFor(pixels, current, lodHysteresis_);
+    nextLodLevels_[object.handle()] = level;
+    return level;
+}
+
+void OctoFlexView::renderPointCloud(const PointCloudShape& cloud, RenderMode mode) {
+    // Not yet frozen: no octree, draw everything.
+    if (!cloud.hasOctree()) {
+        renderShape(cloud, mode);
+        return;
+    }
+
+    GLuint vertexBuffer = cloud.vertexBuffer();
+    if (vertexBuffer == 0) return;
+
+    lodRanges_.clear();
+    if (cloud.selectLod(lodParams_, remainingBudget_, lodRanges_)) {
+        lodLimited_ = true;
+    }
+    if (lodRanges_.empty()) return;
 
+    lodFirsts_.clear();
+    lodCounts_.clear();
+    for (const auto& range : lodRanges_) {
+        lodFirsts_.push_back(static_cast<GLint>(range.first));
+        lodCounts_.push_back(static_cast<GLsizei>(range.count));
+    }
+
+    RenderBackend::VertexSource source;
+    source.buffer = vertexBuffer;
+    source.layout = RenderBackend::PackedColor;
+    RenderBackend::DrawStyle style;
+    style.size = static_cast<float>(cloud.width());
+    style.vertexColors = (mode == RenderMode::RENDER);
+    style.color = pickColor_;
     if (mode == RenderMode::RENDER) {
-        const auto* textured = dynamic_cast<const TexturedQuad*>(&shape);
-        if (textured && textured->hasTexture() && points.size() >= 4) {
-            const auto& uvs = textured->uvs();
+        applyScalars(cloud, style);
+    }
+    backend_->draw(source, RenderBackend::Points, lodFirsts_.data(), lodCounts_.data(),
+                   static_cast<GLsizei>(lodFirsts_.size()), style);
+}
 
-            glEnable(GL_TEXTURE_2D);
-            glBindTexture(GL_TEXTURE_2D, textured->textureId());
-            glColor4f(1.0f, 1.0f, 1.0f, shape.transparency());
+void OctoFlexView::renderTrajectory(const TrajectoryShape& shape, RenderMode mode) {
+    if (!shape.trajectory()) return;
+    const TrajectoryUploader::Ranges ranges =
+        TrajectoryUploader::instance()->ranges(*shape.trajectory(), shape.isStrip());
+    if (ranges.count == 0) return;
 
-            glBegin(GL_QUADS);
-            for (size_t i = 0; i < 4; ++i) {
-                glTexCoord2f(uvs[i].u, uvs[i].v);
-                glVertex3f(points[i].x, points[i].y, points[i].z);
-            }
-            glEnd();
+    RenderBackend::VertexSource source;
+    source.buffer = ranges.buffer;
+    RenderBackend::DrawStyle style;
+    style.size = static_cast<float>(shape.width());
+    style.vertexColors = (mode == RenderMode::RENDER);
+    style.color = pickColor_;
+    if (mode == RenderMode::RENDER) {
+        applyScalars(shape, style);
+    }
+    if (shape.isTransformed()) {
+        backend_->pushModel(shape.transform());
+    }
+    backend_->draw(source, shape.isStrip() ? RenderBackend::LineStrip : RenderBackend::Points, ranges.firsts,
+                   ranges.counts, ranges.count, style);
+    if (shape.isTransformed()) {
+        backend_->popModel();
+    }
+}
 
-            glBindTexture(GL_TEXTURE_2D, 0);
-            glDisable(GL_TEXTURE_2D);
-            return;
+void OctoFlexView::renderInstancedShape(const InstancedShape& shape, RenderMode mode, bool transparent,
+                                        GLuint pickBase) {
+    if (shape.instanceCount() == 0) return;
+
+    GLuint instanceBuffer = 0;
+    if (instanceProgram_) {
+        instanceBuffer = shape.instanceBuffer();
+    }
+    // A scalar color for the whole object replaces the instance colors the instancing shader reads.
+    if (instanceBuffer == 0 || (mode == RenderMode::RENDER && hasObjectScalarColor())) {
+        renderInstancedShapeFallback(shape, mode, transparent, pickBase);
+        return;
+    }
+
+    const bool picking = (mode == RenderMode::SELECT);
+    instanceProgram_->bind();
+    instanceProgram_->setUniformValue("u_use_instance_color", shape.hasInstanceColors() ? 1.0f : 0.0f);
+    instanceProgram_->setUniformValue("u_tint", shape.isReference() ? 1.0f : 0.0f);
+    instanceProgram_->setUniformValue("u_pick", picking ? 1.0f : 0.0f);
+    instanceProgram_->setUniformValue("u_pick_base", static_cast<GLfloat>(pickBase & 0xFF),
+                                      static_cast<GLfloat>((pickBase >> 8) & 0xFF),
+                                      static_cast<GLfloat>((pickBase >> 16) & 0xFF));
+
+    // Fixed-function arrays would alias the generic attributes.
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glDisableClientState(GL_COLOR_ARRAY);
+
+    // Per-instance attributes advance once per instance.
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    const GLsizei stride = sizeof(InstancedShape::GpuInstance);
+    const GLuint instanceAttrs[] = {kAttrInstancePosition, kAttrInstanceRotation, kAttrInstanceScale,
+                                    kAttrInstanceColor, kAttrInstanceIndex};
+    const GLint instanceSizes[] = {3, 4, 3, 4, 1};
+    const size_t instanceOffsets[] = {
+        offsetof(InstancedShape::GpuInstance, position), offsetof(InstancedShape::GpuInstance, rotation),
+        offsetof(InstancedShape::GpuInstance, scale), offsetof(InstancedShape::GpuInstance, color),
+        offsetof(InstancedShape::GpuInstance, index)};
+    for (size_t i = 0; i < 5; ++i) {
+        glEnableVertexAttribArray(instanceAttrs[i]);
+        glVertexAttribPointer(instanceAttrs[i], instanceSizes[i], GL_FLOAT, GL_FALSE, stride,
+                              reinterpret_cast<const void*>(instanceOffsets[i]));
+        vertexAttribDivisor_(instanceAttrs[i], 1);
+    }
+
+    glEnableVertexAttribArray(kAttrPosition);
+    glEnableVertexAttribArray(kAttrColor);
+    const GLsizei count = static_cast<GLsizei>(shape.instanceCount());
+    for (const auto& proto : shape.prototype()) {
+        // In selection mode, render all shapes regardless of transparency.
+        if (!picking && (proto->transparency() < 0.99) != transparent) continue;
+        GLuint vertexBuffer = proto->vertexBuffer();
+        if (vertexBuffer == 0) continue;
+
+        if (proto->type() == Shape::Points) {
+            glPointSize(proto->width());
+        } else {
+            glLineWidth(proto->width());
+        }
+        const bool stipple = !picking && proto->type() == Shape::Dash;
+        if (stipple) {
+            glEnable(GL_LINE_STIPPLE);
+            glLineStipple(1, 0x00FF);  // Dashed pattern.
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+        glVertexAttribPointer(kAttrPosition, 3, GL_FLOAT, GL_FALSE, sizeof(Shape::GpuVertex),
+                              reinterpret_cast<const void*>(offsetof(Shape::GpuVertex, x)));
+        glVertexAttribPointer(kAttrColor, 4, GL_FLOAT, GL_FALSE, sizeof(Shape::GpuVertex),
+                              reinterpret_cast<const void*>(offsetof(Shape::GpuVertex, r)));
+        const GLuint indexBuffer = proto->indexBuffer();
+        if (indexBuffer != 0 && drawElementsInstanced_) {
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+            drawElementsInstanced_(GL_TRIANGLES, static_cast<GLsizei>(proto->triangles().size()), GL_UNSIGNED_INT,
+                                   nullptr, count);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        } else {
+            drawArraysInstanced_(instancedDrawMode(proto->type()), 0, static_cast<GLsizei>(proto->points().size()),
+                                 count);
+        }
+
+        if (stipple) {
+            glDisable(GL_LINE_STIPPLE);
         }
     }
 
-    // Pick draw mode based on shape type.
-    GLenum glMode;
-    switch (shape.type()) {
-        case Shape::Points:
-            glMode = GL_POINTS;
-            break;
-        case Shape::Lines:
-            glMode = GL_LINES;
-            break;
-        case Shape::Dash:
-            // Dashed lines are treated as solid in selection mode.
-            if (mode == RenderMode::SELECT) {
-                glMode = GL_LINES;
+    // Restore state.
+    for (GLuint attr : instanceAttrs) {
+        vertexAttribDivisor_(attr, 0);
+        glDisableVertexAttribArray(attr);
+    }
+    glDisableVertexAttribArray(kAttrPosition);
+    glDisableVertexAttribArray(kAttrColor);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    instanceProgram_->release();
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    if (!picking) {
+        glEnableClientState(GL_COLOR_ARRAY);
+    }
+    glLineWidth(1.0f);
+    glPointSize(1.0f);
+}
+
+void OctoFlexView::renderInstancedShapeFallback(const InstancedShape& shape, RenderMode mode, bool transparent,
+                                                GLuint pickBase) {
+    const bool picking = (mode == RenderMode::SELECT);
+    const auto& positions = shape.positions();
+    const auto& orientations = shape.orientations();
+    const auto& scales = shape.scales();
+
+    for (size_t i = 0; i < shape.instanceCount(); ++i) {
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(positions[i].x, positions[i].y, positions[i].z));
+        const Quaternion& q = orientations[i];
+        model *= glm::mat4_cast(glm::quat(q.w, q.x, q.y, q.z));
+        model = glm::scale(model, glm::vec3(scales[i].x, scales[i].y, scales[i].z));
+
+        backend_->pushModel(model);
+        if (picking) {
+            pickColor_ = encodePickColor(pickBase + static_cast<GLuint>(i));
+        }
+
+        for (const auto& proto : shape.prototype()) {
+            const bool isShapeTransparent = (proto->transparency() < 0.99);
+            if (!picking && isShapeTransparent != transparent) continue;
+
+            if (!picking && shape.hasInstanceColors() && !hasObjectScalarColor()) {
+                // Instance color replaces the prototype vertex colors (tints them for references).
+                if (proto->vertexBuffer() == 0) continue;
+                RenderBackend::VertexSource source;
+                source.buffer = proto->vertexBuffer();
+                RenderBackend::DrawStyle style;
+                style.size = static_cast<float>(proto->width());
+                style.vertexColors = false;
+                const Vec3 color = shape.instanceColor(i, proto->color());
+                style.color = glm::vec4(color.x, color.y, color.z, proto->transparency());
+                drawShapeVertices(*proto, source, style);
             } else {
-                // Use dashed line mode in render mode.
-                glMode = GL_LINES;
-                glEnable(GL_LINE_STIPPLE);
-                glLineStipple(1, 0x00FF);  // Dashed pattern.
+                renderShape(*proto, mode);
             }
-            break;
-        case Shape::Loop:
-            glMode = GL_LINE_LOOP;
-            break;
-        case Shape::Polygon:
-            glMode = GL_POLYGON;
-            break;
-        case Shape::TexturedQuad:
-            glMode = GL_QUADS;
-            break;
-        default:
-            glMode = GL_POINTS;
+        }
+        backend_->popModel();
     }
+}
 
-    // Set line width for line types.
-    if (shape.type() == Shape::Lines || shape.type() == Shape::Dash || shape.type() == Shape::Loop) {
-        glLineWidth(shape.width());
-    }
+void OctoFlexView::queueObjectInfo(const Object& object) {
+    // Labels are anchored on the bounds, so objects without points get none.
+    if (object.bounds().valid) infoObjects_.push_back(&object);
+}
 
-    // Set point size for point type.
-    if (shape.type() == Shape::Points) {
-        glPointSize(shape.width());
+// Compute display positions for the queued object info texts.
+void OctoFlexView::projectObjectInfo() {
+    const size_t count = infoObjects_.size();
+    if (count == 0) return;
+
+    // Corners of each object's world bounds (posed objects included), as x, y, z and w arrays of 8 per object.
+    const size_t stride = count * 8;
+    infoCorners_.assign(stride * 4, 0.0f);
+    float* xs = infoCorners_.data();
+    float* ys = xs + stride;
+    float* zs = ys + stride;
+    float* ws = zs + stride;
+    for (size_t i = 0; i < count; ++i) {
+        const BoundingBox box = infoObjects_[i]->bounds();
+        for (int corner = 0; corner < 8; ++corner) {
+            xs[i * 8 + corner] = static_cast<float>((corner & 1) ? box.max.x : box.min.x);
+            ys[i * 8 + corner] = static_cast<float>((corner & 2) ? box.max.y : box.min.y);
+            zs[i * 8 + corner] = static_cast<float>((corner & 4) ? box.max.z : box.min.z);
+        }
     }
 
-    // Begin drawing.
-    glBegin(glMode);
-    for (size_t i = 0; i < points.size(); ++i) {
-        const auto& point = points[i];
-        const auto& color = shape.color(i);
-        // Set vertex color.
-        if (mode == RenderMode::RENDER) {
-            glColor4f(color.x, color.y, color.z, shape.transparency());
+    // Project every corner in one branch-free loop the compiler can vectorize; results overwrite
+    // the inputs as normalized device coordinates, w keeps the clip w to reject corners behind the eye.
+    const glm::mat4 m = frame_.projection * frame_.view;
+    for (size_t i = 0; i < stride; ++i) {
+        const float x = xs[i];
+        const float y = ys[i];
+        const float z = zs[i];
+        const float w = m[0][3] * x + m[1][3] * y + m[2][3] * z + m[3][3];
+        const float invW = 1.0f / std::max(w, 1e-6f);
+        xs[i] = (m[0][0] * x + m[1][0] * y + m[2][0] * z + m[3][0]) * invW;
+        ys[i] = (m[0][1] * x + m[1][1] * y + m[2][1] * z + m[3][1]) * invW;
+        zs[i] = (m[0][2] * x + m[1][2] * y + m[2][2] * z + m[3][2]) * invW;
+        ws[i] = w;
+    }
+
+    // Anchor each label above the highest projected corner.
+    // Note: Qt Y grows downward while OpenGL Y grows upward, so flip Y.
+    const int TEXT_OFFSET_Y = 15;  // Upward pixel offset.
+    const float viewW = static_cast<float>(frame_.width);
+    const float viewH = static_cast<float>(frame_.height);
+    for (size_t i = 0; i < count; ++i) {
+        const Object& object = *infoObjects_[i];
+        int best = -1;
+        for (int corner = 0; corner < 8; ++corner) {
+            const size_t k = i * 8 + corner;
+            if (ws[k] <= 1e-6f) continue;
+            if (best < 0 || ys[k] > ys[i * 8 + best]) best = corner;
         }
-        // Set vertex position.
-        glVertex3f(point.x, point.y, point.z);
+        if (best < 0) continue;
+
+        // Show text only if the point is inside the depth range.
+        const size_t k = i * 8 + best;
+        if (zs[k] < -1.0f || zs[k] > 1.0f) continue;
+        const float screenX = (xs[k] * 0.5f + 0.5f) * viewW;
+        const float screenY = (ys[k] * 0.5f + 0.5f) * viewH;
+        objectInfoToRender_.push_back({object.info(), object.textColor(), static_cast<int>(screenX),
+                                       static_cast<int>(viewH - screenY - TEXT_OFFSET_Y)});
     }
-    glEnd();
+}
+
+// Render a single shape.
+void OctoFlexView::renderShape(const Shape& shape, RenderMode mode) {
+    const auto& points = shape.points();
+    const GLsizei vertexCount = static_cast<GLsizei>(shape.vertexCount());
+
+    if (vertexCount == 0) return;
 
-    // Restore state.
     if (mode == RenderMode::RENDER) {
-        if (shape.type() == Shape::Dash) {
-            glDisable(GL_LINE_STIPPLE);
+        const auto* textured = dynamic_cast<const TexturedQuad*>(&shape);
+        if (textured && textured->hasTexture() && points.size() >= 4) {
+            // Nearer quads upload first; a quad is not drawn until its texture is ready.
+            const Vec3 center = (points[0] + points[2]) * 0.5;
+            const float distance = glm::length(glm::vec3(center.x, center.y, center.z) - lodParams_.eye);
+            const GLuint texture = textured->textureId(distance);
+            if (texture == 0) return;
+            const auto& uvs = textured->uvs();
+            const float uvArray[8] = {uvs[0].u, uvs[0].v, uvs[1].u, uvs[1].v, uvs[2].u, uvs[2].v, uvs[3].u, uvs[3].v};
+            backend_->drawTexturedQuad(points.data(), uvArray, texture, static_cast<float>(shape.transparency()));
+            return;
         }
     }
 
-    // Restore default line width and point size.
-    glLineWidth(1.0f);
-    glPointSize(1.0f);
+    // Dashed lines are treated as solid in selection mode; picks draw in the pick ID color.
+    RenderBackend::DrawStyle style;
+    style.size = static_cast<float>(shape.width());
+    style.dashed = (mode == RenderMode::RENDER && shape.type() == Shape::Dash);
+    style.vertexColors = (mode == RenderMode::RENDER);
+    style.color = pickColor_;
+    if (mode == RenderMode::RENDER) {
+        applyScalars(shape, style);
+    }
+
+    // Frozen shapes draw from their retained vertex buffer.
+    GLuint vertexBuffer = shape.vertexBuffer();
+    RenderBackend::VertexSource source;
+    source.buffer = vertexBuffer;
+    if (shape.isPacked()) {
+        // Packed vertices: from the retained buffer, or straight from client memory while editable.
+        source.data = shape.packedVertices().data();
+        source.layout = RenderBackend::PackedColor;
+        drawShapeVertices(shape, source, style);
+    } else if (vertexBuffer != 0) {
+        drawShapeVertices(shape, source, style);
+    } else {
+        renderEditableShape(shape, style);
+    }
+}
+
+void OctoFlexView::drawShapeVertices(const Shape& shape, const RenderBackend::VertexSource& source,
+                                     const RenderBackend::DrawStyle& style) {
+    const auto& triangles = shape.triangles();
+    if (!triangles.empty()) {
+        // Client-memory vertices come with client-memory indices.
+        const GLuint indexBuffer = source.buffer != 0 ? shape.indexBuffer() : 0;
+        backend_->drawIndexed(source, RenderBackend::Triangles, indexBuffer, triangles.data(),
+                              static_cast<GLsizei>(triangles.size()), style);
+        return;
+    }
+    backend_->draw(source, shapePrimitive(shape.type()), 0, static_cast<GLsizei>(shape.vertexCount()), style);
+}
+
+// Render a shape from a temporary vertex array (used while no vertex buffer is available).
+void OctoFlexView::renderEditableShape(const Shape& shape, const RenderBackend::DrawStyle& style) {
+    const auto& points = shape.points();
+    const float alpha = static_cast<float>(shape.transparency());
+    editableVertices_.resize(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        const Vec3& point = points[i];
+        const Vec3& color = shape.color(i);
+        editableVertices_[i] = {static_cast<float>(point.x), static_cast<float>(point.y), static_cast<float>(point.z),
+                                static_cast<float>(color.x), static_cast<float>(color.y), static_cast<float>(color.z),
+                                alpha};
+    }
+
+    RenderBackend::VertexSource source;
+    source.data = editableVertices_.data();
+    drawShapeVertices(shape, source, style);
 }
 
 void OctoFlexView::resizeGL(int width, int height) {
@@ -648,10 +1716,22 @@ void OctoFlexView::setProjectionMatrix(const glm::mat4& projectionMatrix_) {
 }
 
 void OctoFlexView::setObjectManager(ObjectManager::Ptr obj_mgr) {
+    beginRenderStateChange();
     obj_mgr_ = obj_mgr;
+
+    // Layer versions of another manager say nothing about this one.
+    objectListLayers_.clear();
+    if (objectListWidget_) {
+        objectListWidget_->clear();
+    }
     updateObjectList();
 }
 
+void OctoFlexView::setSceneResources(SceneResources::Ptr resources) {
+    beginRenderStateChange();
+    if (resources) sceneResources_ = resources;
+}
+
 void OctoFlexView::setRefreshRate(int fps) {
     if (fps <= 0) {
         // If fps is 0 or negative, stop the timer
@@ -664,12 +1744,54 @@ void OctoFlexView::setRefreshRate(int fps) {
         refreshRate_ = fps;
 
         // Update target FPS info.
-        setInfoItem("refresh_rate", "Target Refresh Rate: " + std::to_string(refreshRate_) + " FPS");
+        updateRefreshInfo();
     }
 }
 
 int OctoFlexView::refreshRate() const { return refreshRate_; }
 
+void OctoFlexView::setRefreshMode(RefreshMode mode) {
+    refreshMode_ = mode;
+    updateRefreshInfo();
+    update();  // Request a repaint
+}
+
+RefreshMode OctoFlexView::refreshMode() const { return refreshMode_; }
+
+bool OctoFlexView::needsRepaint() const {
+    if (!hasPainted_) return true;
+
+    // Scene contents, applied or still queued.
+    if (obj_mgr_ && (obj_mgr_->hasPendingUpdates() || obj_mgr_->generation() != paintedGeneration_)) return true;
+
+    // Camera moved outside of the view's own event handlers (copyCamera, coordinate systems).
+    if (camera_->getViewMatrix() != paintedViewMatrix_) return true;
+
+    // Textures finished uploading, or more are waiting for the next frame's upload budget.
+    const TextureManager* textures = TextureManager::instance();
+    if (textures->completedBatches() != paintedTextureBatches_ || textures->waitingForFrame()) return true;
+
+    // A producer submitted a new frame of a dynamic texture.
+    if (DynamicTextureUploader::instance()->submitted() != paintedDynamicFrames_) return true;
+
+    // A producer appended to or trimmed a trajectory.
+    if (TrajectoryUploader::instance()->submitted() != paintedTrajectories_) return true;
+
+    // A producer replaced scalar values or their colormap and range.
+    if (ScalarUploader::instance()->submitted() != paintedScalars_) return true;
+
+    // Keyboard movement in progress.
+    return keyW_ || keyA_ || keyS_ || keyD_ || keyQ_ || keyE_;
+}
+
+void OctoFlexView::updateRefreshInfo() {
+    if (refreshMode_ == RefreshMode::CONTINUOUS) {
+        setInfoItem("refresh_rate", "Target Refresh Rate: " + std::to_string(refreshRate_) + " FPS");
+    } else {
+        setInfoItem("refresh_rate", "Refresh: On Demand");
+    }
+}
+
 void OctoFlexView::startRefresh() {
     if (!refreshTimer_->isActive() && refreshRate_ > 0) {
         int interval = 1000 / refreshRate_;
@@ -688,50 +1810,87 @@ bool OctoFlexView::isRefreshing() const { return refreshTimer_->isActive(); }
 // Set object list widget.
 void OctoFlexView::setObjectListWidget(QListWidget* list) {
     objectListWidget_ = list;
+    objectListLayers_.clear();
+    if (objectListWidget_) {
+        objectListWidget_->clear();
+    }
     updateObjectList();
 }
 
 // Update object list.
+// Items are kept per layer and only layers whose version changed are compared, so an attached list follows a large
+// scene with inserts and removes instead of being rebuilt.
 void OctoFlexView::updateObjectList() {
     if (!objectListWidget_ || !obj_mgr_) return;
 
-    objectListWidget_->clear();
+    // Read the generation first, so a change made meanwhile is picked up by the next update.
+    objectListGeneration_ = obj_mgr_->generation();
+    auto layers = obj_mgr_->layersSnapshot();
 
-    /*
-    for (const auto& obj : obj_mgr_->objects()) {
-        QListWidgetItem* item = new QListWidgetItem(QString::fromStdString(obj->id()));
-        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
-        item->setCheckState(selectedObjects_.count(obj->id()) > 0 ? Qt::Checked : Qt::Unchecked);
-        objectListWidget_->addItem(item);
-    }
-    */
-    for (auto layer : obj_mgr_->layers()) {
-        for (auto it : layer.second->objects()) {
-            auto obj = it.second;
+    objectListWidget_->setUpdatesEnabled(false);
+    for (auto it = objectListLayers_.begin(); it != objectListLayers_.end();) {
+        if (layers->count(it->first) > 0) {
+            ++it;
+            continue;
+        }
+        for (const auto& [id, item] : it->second.items) {
+            delete item;  // Removes it from the list widget.
+        }
+        it = objectListLayers_.erase(it);
+    }
+
+    for (const auto& [layerId, layer] : *layers) {
+        LayerSnapshotPtr snapshot = layer->snapshot();
+        auto found = objectListLayers_.find(layerId);
+        if (found != objectListLayers_.end() && found->second.version == snapshot->version) continue;
+
+        ObjectListLayer& entry = objectListLayers_[layerId];
+        entry.version = snapshot->version;
+        std::unordered_map<std::string, QListWidgetItem*> items;
+        items.reserve(snapshot->objects.size());
+        for (const auto& [handle, obj] : snapshot->objects) {
+            auto old = entry.items.find(obj->id());
+            if (old != entry.items.end()) {
+                items.insert(*old);
+                entry.items.erase(old);
+                continue;
+            }
             QListWidgetItem* item = new QListWidgetItem(QString::fromStdString(obj->id()));
             item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
             item->setCheckState(selectedObjects_.count(obj->id()) > 0 ? Qt::Checked : Qt::Unchecked);
             objectListWidget_->addItem(item);
+            items.emplace(obj->id(), item);
+        }
+
+        // What is left was removed from the layer.
+        for (const auto& [id, item] : entry.items) {
+            delete item;
         }
+        entry.items.swap(items);
     }
+    objectListWidget_->setUpdatesEnabled(true);
 }
 
 // Select object.
 void OctoFlexView::selectObject(const std::string& objId, bool selected) {
+    beginRenderStateChange();
+    // The drawing code checks handles; the reference keeps the handle while the ID is selected.
     if (selected) {
-        selectedObjects_.insert(objId);
-    } else {
-        selectedObjects_.erase(objId);
+        if (selectedObjects_.insert(objId).second) {
+            selectedHandles_.insert(ObjectRegistry::instance().acquire(objId));
+        }
+    } else if (selectedObjects_.erase(objId) > 0) {
+        const ObjectHandle handle = ObjectRegistry::instance().find(objId);
+        selectedHandles_.erase(handle);
+        ObjectRegistry::instance().release(handle);
     }
 
     // Update selection state in the list widget.
-    if (objectListWidget_) {
-        for (int i = 0; i < objectListWidget_->count(); ++i) {
-            QListWidgetItem* item = objectListWidget_->item(i);
-            if (item->text().toStdString() == objId) {
-                item->setCheckState(selected ? Qt::Checked : Qt::Unchecked);
-                break;
-            }
+    for (const auto& [layerId, entry] : objectListLayers_) {
+        auto found = entry.items.find(objId);
+        if (found != entry.items.end()) {
+            found->second->setCheckState(selected ? Qt::Checked : Qt::Unchecked);
+            break;
         }
     }
 
@@ -741,9 +1900,95 @@ void OctoFlexView::selectObject(const std::string& objId, bool selected) {
 // Get selected object IDs.
 const std::set<std::string>& OctoFlexView::getSelectedObjects() const { return selectedObjects_; }
 
+void OctoFlexView::setTransparencySorting(bool enabled) {
+    beginRenderStateChange();
+    sortTransparent_ = enabled;
+    update();  // Request a repaint
+}
+
+bool OctoFlexView::transparencySorting() const { return sortTransparent_; }
+
+int OctoFlexView::getLastPickedInstance() const { return lastPickedInstance_; }
+
+const std::map<std::string, std::vector<uint32_t>>& OctoFlexView::getLastPickedPoints() const {
+    return pickedPoints_;
+}
+
+void OctoFlexView::setPointBudget(size_t interactive, size_t refined) {
+    beginRenderStateChange();
+    pointBudget_ = std::max<size_t>(interactive, 1);
+    refinedPointBudget_ = std::max(refined, pointBudget_);
+    frameBudget_ = pointBudget_;
+    update();  // Request a repaint
+}
+
+FrameTimingStats OctoFlexView::frameTimingStats() const {
+    return frameTimer_.stats();
+}
+
+void OctoFlexView::setFrameTimingOverlay(bool enabled) {
+    if (frameTimingOverlay_ == enabled) return;
+    frameTimingOverlay_ = enabled;
+    if (enabled) {
+        update();  // Listed from the next statistics refresh
+    } else if (infoPanel_) {
+        for (const char* id : {"timing_frame", "timing_update", "timing_opaque", "timing_transparent", "timing_text",
+                               "timing_panel", "timing_cleanup"}) {
+            infoPanel_->removeInfoItem(id);
+        }
+    }
+}
+
+bool OctoFlexView::frameTimingOverlay() const { return frameTimingOverlay_; }
+
+SceneMemoryStats OctoFlexView::memoryStats() const {
+    if (!obj_mgr_) return SceneMemoryStats();
+    SceneMemoryStats stats = obj_mgr_->memoryStats();
+    // Batches of the scene are rebuilt by whichever view paints.
+    QReadLocker locker(sceneLock());
+    for (auto& layer : stats.layers) {
+        const size_t batch = sceneResources_ ? sceneResources_->batchBytes(layer.layer_id) : 0;
+        layer.gpu_buffer_bytes += batch;
+        stats.total.gpu_buffer_bytes += batch;
+    }
+    return stats;
+}
+
+void OctoFlexView::setMemoryOverlay(bool enabled) {
+    if (memoryOverlay_ == enabled) return;
+    memoryOverlay_ = enabled;
+    if (enabled) {
+        update();  // Listed from the next statistics refresh
+    } else if (infoPanel_) {
+        for (const auto& id : memoryItems_) {
+            infoPanel_->removeInfoItem(id);
+        }
+        memoryItems_.clear();
+    }
+}
+
+bool OctoFlexView::memoryOverlay() const { return memoryOverlay_; }
+
+void OctoFlexView::setCpuPicking(bool enabled) { cpuPicking_ = enabled; }
+
+bool OctoFlexView::cpuPicking() const { return cpuPicking_; }
+
+void OctoFlexView::setLodHysteresis(float fraction) {
+    beginRenderStateChange();
+    lodHysteresis_ = std::max(0.0f, fraction);
+    update();
+}
+
+float OctoFlexView::lodHysteresis() const { return lodHysteresis_; }
+
 // Clear all selections.
 void OctoFlexView::clearSelection() {
+    beginRenderStateChange();
     selectedObjects_.clear();
+    for (ObjectHandle handle : selectedHandles_) {
+        ObjectRegistry::instance().release(handle);
+    }
+    selectedHandles_.clear();
 
     // Update selection state in the list widget.
     if (objectListWidget_) {
@@ -899,8 +2144,8 @@ void OctoFlexView::mouseReleaseEvent(QMouseEvent* event) {
 
             // If it's a click (not a drag).
             if (isClick_) {
-                // Point selection using GL_SELECT.
-                handleSelectionWithGLSelect(event->pos(), 5, 5, SelectionMode::POINT);
+                // Point selection around the click position.
+                handleSelection(QPoint(event->pos().x() - 2, event->pos().y() - 2), 5, 5, SelectionMode::POINT);
             } else {
                 // Ensure selection rectangle is valid.
                 if (selectionRect.width() < 1 || selectionRect.height() < 1) {
@@ -912,9 +2157,9 @@ void OctoFlexView::mouseReleaseEvent(QMouseEvent* event) {
                 std::cout << "Selection rectangle: (" << selectionRect.x() << ", " << selectionRect.y() << ", "
                           << selectionRect.width() << ", " << selectionRect.height() << ")" << std::endl;
 
-                // Box selection using GL_SELECT.
+                // Box selection.
                 // Note: pass top-left coordinates and width/height.
-                handleSelectionWithGLSelect(QPoint(selectionRect.x(), selectionRect.y()), selectionRect.width(),
+                handleSelection(QPoint(selectionRect.x(), selectionRect.y()), selectionRect.width(),
                                             selectionRect.height(), SelectionMode::RECT);
             }
         } else if (isPanning_) {
@@ -1081,218 +2326,314 @@ void OctoFlexView::setCameraView(const std::string& viewDirection) {
     update();  // Request repaint.
 }
 
-// Common GL_SELECT selection handler.
-void OctoFlexView::handleSelectionWithGLSelect(const QPoint& point, int width, int height, SelectionMode mode) {
-    if (!obj_mgr_) return;
-
-    // Ensure OpenGL context is current.
-    makeCurrent();
-
-    // Clear name-to-object mapping.
-    nameToObjectId_.clear();
-
-    // Set selection buffer.
-    setupSelectBuffer(selectBuffer_, SELECT_BUFFER_SIZE_);
+// Common selection handler.
+void OctoFlexView::pickRegion(const QPoint& point, int width, int height, SelectionMode mode) {
+    handleSelection(point, width, height, mode);
+}
 
-    GLint viewport[4];
-    glGetIntegerv(GL_VIEWPORT, viewport);
+void OctoFlexView::handleSelection(const QPoint& point, int width, int height, SelectionMode mode) {
+    if (!obj_mgr_) return;
+    OCTO_FLEX_TRACE_ZONE("handleSelection");
+    beginRenderStateChange();
 
-    // Enter selection mode and set pick region.
-    enterSelectMode(point.x(), point.y(), width, height);
+    std::vector<std::pair<ObjectHandle, int>> hits;
+    if (cpuPicking_) {
+        hits = pickObjectsCpu(point.x(), point.y(), width, height, mode);
+    } else {
+        // Ensure OpenGL context is current.
+        QWriteLocker locker(sceneLock());
+        makeCurrent();
 
-    // Render all objects, assigning unique name IDs.
-    GLuint nameID = 1;
-    auto layers = obj_mgr_->layers();
-    for (const auto& [layer_id, layer] : layers) {
-        if (unvisable_layers_.count(layer_id) > 0) continue;
-        if (unselectable_layers_.count(layer_id) > 0) continue;
-        auto objects = layer->objects();
-        for (const auto& [id, obj] : objects) {
-            // Record name ID to object ID mapping.
-            nameToObjectId_[nameID] = id;
+        std::vector<GLuint> selectedNames = pickObjectIds(point.x(), point.y(), width, height, mode);
 
-            // Render object in selection mode.
-            renderObject(*obj, RenderMode::SELECT, nameID, false);
+        // Release OpenGL context.
+        doneCurrent();
+        locker.unlock();
 
-            // Increment name ID.
-            nameID++;
+        for (GLuint name : selectedNames) {
+            // Find the range owning this ID.
+            auto it = std::upper_bound(pickRanges_.begin(), pickRanges_.end(), name,
+                                       [](GLuint id, const PickRange& range) { return id < range.first; });
+            if (name == 0 || it == pickRanges_.begin()) continue;
+            const PickRange& range = *(it - 1);
+            if (name >= range.first + range.count) continue;
+            hits.emplace_back(range.object, range.instanced ? static_cast<int>(name - range.first) : -1);
         }
     }
 
-    // Process hit results.
-    GLint hits = glRenderMode(GL_RENDER);
-    std::vector<GLuint> selectedNames = processHits(hits, mode);
-
-    // Release OpenGL context.
-    doneCurrent();
-
-    // If there are hits, process selection.
-    if (!selectedNames.empty()) {
-        // Track processed object IDs to avoid duplicates.
-        std::set<std::string> processedObjIds;
-
-        for (GLuint name : selectedNames) {
-            if (nameToObjectId_.find(name) != nameToObjectId_.end()) {
-                std::string objId = nameToObjectId_[name];
-
-                // Skip if already processed.
-                if (processedObjIds.count(objId) > 0) {
-                    continue;
+    // Rectangle mode: query point cloud octrees for every point inside the region.
+    pickedPoints_.clear();
+    if (mode == SelectionMode::RECT) {
+        auto layers = obj_mgr_->layersSnapshot();
+        for (const auto& [layer_id, layer] : *layers) {
+            if (unvisable_layers_.count(layer_id) > 0) continue;
+            if (unselectable_layers_.count(layer_id) > 0) continue;
+            LayerSnapshotPtr snapshot = layer->snapshot();
+            for (const auto& [handle, obj] : snapshot->objects) {
+                if (!lastPickFrustum_.intersects(obj->bounds())) continue;
+
+                // Posed clouds are queried in their own frame.
+                Frustum frustum = lastPickFrustum_;
+                GLfloat matrix[16];
+                if (obj->modelMatrix(matrix)) {
+                    frustum = Frustum(lastPickViewProjection_ * glm::make_mat4(matrix));
                 }
 
-                // Mark as processed.
-                processedObjIds.insert(objId);
-
-                // Handle selection based on mode.
-                if (mode == SelectionMode::POINT) {
-                    // Point mode: toggle selection.
-                    bool isSelected = selectedObjects_.count(objId) > 0;
-                    selectObject(objId, !isSelected);
-                } else {
-                    // Rectangle mode: select object.
-                    selectObject(objId, true);
+                std::vector<uint32_t> indices;
+                uint32_t offset = 0;
+                for (const auto& shape : obj->shapes()) {
+                    if (shape->type() != Shape::PointCloud) continue;
+                    const size_t first = indices.size();
+                    static_cast<const PointCloudShape&>(*shape).queryFrustum(frustum, indices);
+                    for (size_t i = first; i < indices.size(); ++i) indices[i] += offset;
+                    offset += static_cast<uint32_t>(shape->vertexCount());
+                }
+                if (!indices.empty()) {
+                    selectObject(obj->id(), true);
+                    pickedPoints_[obj->id()] = std::move(indices);
                 }
             }
         }
     }
 
+    // If there are hits, process selection.
+    lastPickedInstance_ = -1;
+    for (const auto& [handle, instance] : hits) {
+        const std::string objId = ObjectRegistry::instance().id(handle);
+        if (objId.empty()) continue;  // Removed and released since the pick
+
+        if (instance >= 0 && mode == SelectionMode::POINT) {
+            lastPickedInstance_ = instance;
+            emit instancePicked(objId, lastPickedInstance_);
+        }
+
+        // Handle selection based on mode.
+        if (mode == SelectionMode::POINT) {
+            // Point mode: toggle selection.
+            bool isSelected = selectedHandles_.count(handle) > 0;
+            selectObject(objId, !isSelected);
+        } else {
+            // Rectangle mode: select object.
+            selectObject(objId, true);
+        }
+    }
+
     // Request repaint.
     update();
 }
 
-// Enter selection mode.
-void OctoFlexView::enterSelectMode(int x, int y, int width, int height) {
-    // Get current viewport.
-    GLint viewport[4];
-    glGetIntegerv(GL_VIEWPORT, viewport);
-
-    // Switch to selection mode.
-    glRenderMode(GL_SELECT);
-
-    // Initialize name stack.
-    glInitNames();
-    glPushName(0);
-
-    // Save current matrix.
-    glMatrixMode(GL_PROJECTION);
-    glPushMatrix();
-    glLoadIdentity();
+glm::mat4 OctoFlexView::pickProjection(const QRect& region) const {
+    // Pick matrix: map the region (OpenGL bottom-left origin) onto the full NDC range.
+    const float viewW = static_cast<float>(this->width());
+    const float viewH = static_cast<float>(this->height());
+    const float centerX = region.x() + region.width() / 2.0f;
+    const float centerY = viewH - (region.y() + region.height() / 2.0f);
+    glm::mat4 pickMatrix(1.0f);
+    pickMatrix = glm::translate(pickMatrix, glm::vec3((viewW - 2.0f * centerX) / region.width(),
+                                                      (viewH - 2.0f * centerY) / region.height(), 0.0f));
+    pickMatrix = glm::scale(pickMatrix, glm::vec3(viewW / region.width(), viewH / region.height(), 1.0f));
+    return pickMatrix * projectionMatrix_;
+}
+
+std::vector<std::pair<ObjectHandle, int>> OctoFlexView::pickObjectsCpu(int x, int y, int width, int height,
+                                                                       SelectionMode mode) {
+    OCTO_FLEX_TRACE_ZONE("pickObjectsCpu");
+    std::vector<std::pair<ObjectHandle, int>> hits;
+
+    // Clip pick region to the widget (Qt coordinates, top-left origin).
+    QRect region = QRect(x, y, std::max(1, width), std::max(1, height)).intersected(rect());
+    if (region.isEmpty()) return hits;
+
+    // Kept for the point cloud queries of rectangle mode, as after a GPU pick.
+    lastPickViewProjection_ = pickProjection(region) * camera_->getViewMatrix();
+    lastPickFrustum_ = Frustum(lastPickViewProjection_);
+
+    auto layers = obj_mgr_->layersSnapshot();
+    if (mode == SelectionMode::RECT) {
+        std::vector<Object::Ptr> objects;
+        for (const auto& [layer_id, layer] : *layers) {
+            if (unvisable_layers_.count(layer_id) > 0) continue;
+            if (unselectable_layers_.count(layer_id) > 0) continue;
+            objects.clear();
+            layer->bvh()->query(lastPickFrustum_, objects);
+            for (const auto& obj : objects) {
+                hits.emplace_back(obj->handle(), -1);
+            }
+        }
+        return hits;
+    }
+
+    // Point mode: a cone from the near to the far plane through the region's center, as wide as its corners.
+    const glm::mat4 inverse = glm::inverse(lastPickViewProjection_);
+    auto unproject = [&inverse](float ndcX, float ndcY, float ndcZ) {
+        const glm::vec4 p = inverse * glm::vec4(ndcX, ndcY, ndcZ, 1.0f);
+        return glm::vec3(p) / p.w;
+    };
+    const glm::vec3 nearCenter = unproject(0.0f, 0.0f, -1.0f);
+    const glm::vec3 farCenter = unproject(0.0f, 0.0f, 1.0f);
+    const float depth = glm::length(farCenter - nearCenter);
+    if (!(depth > 0.0f)) return hits;
+    const float nearRadius = glm::length(unproject(1.0f, 1.0f, -1.0f) - nearCenter);
+    const float farRadius = glm::length(unproject(1.0f, 1.0f, 1.0f) - farCenter);
+
+    PickRay ray;
+    ray.origin = nearCenter;
+    ray.direction = (farCenter - nearCenter) / depth;
+    ray.radius = nearRadius;
+    ray.spread = std::max(0.0f, (farRadius - nearRadius) / depth);
+    PickHit hit;
+    hit.distance = depth;
+    for (const auto& [layer_id, layer] : *layers) {
+        if (unvisable_layers_.count(layer_id) > 0) continue;
+        if (unselectable_layers_.count(layer_id) > 0) continue;
+        layer->bvh()->raycast(ray, hit);
+    }
+    if (hit.object) hits.emplace_back(hit.object->handle(), hit.instance);
+    return hits;
+}
 
-    // Create pick matrix.
-    // Note: OpenGL origin is bottom-left; Qt origin is top-left.
-    // Convert y to OpenGL coordinates.
-    int glY = viewport[3] - y;
+// Render object IDs into the pick FBO and read back the pick region.
+std::vector<GLuint> OctoFlexView::pickObjectIds(int x, int y, int width, int height, SelectionMode mode) {
+    OCTO_FLEX_TRACE_ZONE("pickObjectIds");
+    std::vector<GLuint> selectedNames;
 
-    // Ensure pick region is at least 1x1.
-    int pickWidth = std::max(1, width);
-    int pickHeight = std::max(1, height);
+    // Clip pick region to the widget (Qt coordinates, top-left origin).
+    QRect region = QRect(x, y, std::max(1, width), std::max(1, height)).intersected(rect());
+    if (region.isEmpty()) return selectedNames;
+
+    // Only the pick region is rasterized, so the FBO matches its size.
+    const QSize pickSize = region.size();
+    if (!pickFbo_ || pickFbo_->size() != pickSize) {
+        delete pickFbo_;
+        QOpenGLFramebufferObjectFormat format;
+        format.setAttachment(QOpenGLFramebufferObject::Depth);
+        format.setInternalTextureFormat(GL_RGBA8);
+        pickFbo_ = new QOpenGLFramebufferObject(pickSize, format);
+    }
+    if (!pickFbo_->isValid()) {
+        qWarning() << "OctoFlexView::pickObjectIds: Failed to create pick framebuffer.";
+        return selectedNames;
+    }
 
-    // Create pick matrix.
-    // Note: gluPickMatrix expects the center, not the top-left.
-    // Offset x and glY by half width/height.
-    float centerX = x + pickWidth / 2.0f;
-    float centerY = glY - pickHeight / 2.0f;
+    GLint oldViewport[4];
+    glGetIntegerv(GL_VIEWPORT, oldViewport);
 
-    gluPickMatrix(centerX, centerY, pickWidth, pickHeight, viewport);
+    pickFbo_->bind();
+    glViewport(0, 0, pickSize.width(), pickSize.height());
 
-    // Apply the same projection matrix used in render mode.
-    // Use projectionMatrix_ to stay consistent with setupFixedFunctionPipeline.
-    GLfloat projMatrix[16];
-    const float* projSource = glm::value_ptr(projectionMatrix_);
-    for (int i = 0; i < 16; i++) {
-        projMatrix[i] = projSource[i];
+    // IDs must reach the framebuffer unmodified.
+    glDisable(GL_BLEND);
+    glDisable(GL_DITHER);
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_TRUE);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClearDepth(1.0);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    const glm::mat4 projection = pickProjection(region);
+    backend_->beginPass(projection, camera_->getViewMatrix(), glm::vec2(pickSize.width(), pickSize.height()));
+
+    // Render all selectable objects inside the pick frustum, assigning unique name IDs.
+    lastPickViewProjection_ = projection * camera_->getViewMatrix();
+    const Frustum pickFrustum(lastPickViewProjection_);
+    lastPickFrustum_ = pickFrustum;
+
+    // Point clouds are picked at the detail shown on screen, culled to the pick region.
+    const PointCloudShape::LodParams savedLodParams = lodParams_;
+    const size_t savedBudget = remainingBudget_;
+    const bool savedLimited = lodLimited_;
+    const glm::mat4 savedFrustumMatrix = lodFrustumMatrix_;
+    lodParams_.frustum = pickFrustum;
+    lodFrustumMatrix_ = lastPickViewProjection_;
+    remainingBudget_ = frameBudget_;
+    pickRanges_.clear();
+    GLuint nextId = 1;
+    auto layers = obj_mgr_->layersSnapshot();
+    for (const auto& [layer_id, layer] : *layers) {
+        if (unvisable_layers_.count(layer_id) > 0) continue;
+        if (unselectable_layers_.count(layer_id) > 0) continue;
+        LayerSnapshotPtr snapshot = layer->snapshot();
+        for (const auto& [handle, obj] : snapshot->objects) {
+            if (!pickFrustum.intersects(obj->bounds())) continue;
+            pickRanges_.push_back({nextId, 1, obj->handle(), false});
+            renderObject(*obj, RenderMode::SELECT, nextId, false);
+            ++nextId;
+
+            // Each instance of an instanced shape gets its own ID.
+            PointCloudShape::LodParams worldLod;
+            const bool posed = pushObjectTransform(*obj, worldLod);
+            for (const auto& shape : obj->shapes()) {
+                if (shape->type() != Shape::Instanced) continue;
+                const auto& instanced = static_cast<const InstancedShape&>(*shape);
+                const GLuint count = static_cast<GLuint>(instanced.instanceCount());
+                if (count == 0) continue;
+                pickRanges_.push_back({nextId, count, obj->handle(), !instanced.isReference()});
+                renderInstancedShape(instanced, RenderMode::SELECT, false, nextId);
+                nextId += count;
+            }
+            if (posed) {
+                popObjectTransform(worldLod);
+            }
+        }
     }
-    glMultMatrixf(projMatrix);
 
-    // Switch to model-view matrix.
-    glMatrixMode(GL_MODELVIEW);
-    glPushMatrix();
-
-    // Apply the same view matrix used in render mode.
-    // Use viewMatrix_ to stay consistent with setupFixedFunctionPipeline.
-    GLfloat viewMatrix[16];
-    const float* viewSource = glm::value_ptr(viewMatrix_);
-    for (int i = 0; i < 16; i++) {
-        viewMatrix[i] = viewSource[i];
-    }
-    glLoadMatrixf(viewMatrix);
-}
+    backend_->endPass();
 
-// Exit selection mode and process results.
-std::vector<GLuint> OctoFlexView::processHits(GLint hits, SelectionMode mode) {
-    std::vector<GLuint> selectedNames;
+    lodParams_ = savedLodParams;
+    remainingBudget_ = savedBudget;
+    lodLimited_ = savedLimited;
+    lodFrustumMatrix_ = savedFrustumMatrix;
 
-    if (hits <= 0) {
-        // No hits.
-        return selectedNames;
-    }
+    // Read back only the pick region.
+    const int pixelCount = pickSize.width() * pickSize.height();
+    std::vector<unsigned char> ids(pixelCount * 4);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, pickSize.width(), pickSize.height(), GL_RGBA, GL_UNSIGNED_BYTE, ids.data());
 
-    // Process hit records.
-    GLuint* ptr = selectBuffer_;
+    auto decode = [&ids](int i) -> GLuint {
+        return static_cast<GLuint>(ids[i * 4]) | (static_cast<GLuint>(ids[i * 4 + 1]) << 8) |
+               (static_cast<GLuint>(ids[i * 4 + 2]) << 16) | (static_cast<GLuint>(ids[i * 4 + 3]) << 24);
+    };
 
     if (mode == SelectionMode::POINT) {
-        // Point mode: only return the nearest hit (smallest minZ)
+        // Point mode: only return the nearest hit (smallest depth).
+        std::vector<float> depths(pixelCount);
+        glReadPixels(0, 0, pickSize.width(), pickSize.height(), GL_DEPTH_COMPONENT, GL_FLOAT, depths.data());
+
         GLuint nearestName = 0;
-        GLuint smallestMinZ = UINT_MAX;
-
-        for (int i = 0; i < hits; i++) {
-            GLuint numNames = *ptr;
-            ptr++;
-            GLuint minZ = *ptr;
-            ptr++;
-            GLuint maxZ = *ptr;
-            ptr++;
-
-            // Check if this hit is nearer than previous
-            if (minZ < smallestMinZ) {
-                smallestMinZ = minZ;
-                if (numNames > 0) {
-                    nearestName = *(ptr);  // Get first name in this hit
-                }
+        float smallestDepth = std::numeric_limits<float>::max();
+        for (int i = 0; i < pixelCount; ++i) {
+            GLuint name = decode(i);
+            if (name != 0 && depths[i] < smallestDepth) {
+                smallestDepth = depths[i];
+                nearestName = name;
             }
-
-            // Skip names in this record
-            ptr += numNames;
         }
-
-        // Only add the nearest object
         if (nearestName != 0) {
             selectedNames.push_back(nearestName);
         }
     } else {
-        // Rectangle mode: collect all hit names (original behavior)
-        for (int i = 0; i < hits; i++) {
-            GLuint numNames = *ptr;
-            ptr++;
-            GLuint minZ = *ptr;
-            ptr++;
-            GLuint maxZ = *ptr;
-            ptr++;
-
-            // Collect all hit names.
-            for (GLuint j = 0; j < numNames; j++) {
-                GLuint name = *ptr;
-                selectedNames.push_back(name);
-                ptr++;
-            }
+        // Rectangle mode: collect every distinct ID in the region.
+        std::set<GLuint> names;
+        for (int i = 0; i < pixelCount; ++i) {
+            GLuint name = decode(i);
+            if (name != 0) names.insert(name);
         }
+        selectedNames.assign(names.begin(), names.end());
     }
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
 
-    // Restore matrices.
-    glMatrixMode(GL_PROJECTION);
-    glPopMatrix();
-    glMatrixMode(GL_MODELVIEW);
-    glPopMatrix();
+    pickFbo_->release();
 
-    // Switch back to render mode.
-    glRenderMode(GL_RENDER);
+    // Restore render state.
+    glViewport(oldViewport[0], oldViewport[1], oldViewport[2], oldViewport[3]);
+    glClearColor(bk_color_.x, bk_color_.y, bk_color_.z, 1.0);
+    glEnable(GL_BLEND);
+    glEnable(GL_DITHER);
 
     return selectedNames;
 }
 
-// Set selection buffer.
-void OctoFlexView::setupSelectBuffer(GLuint* buffer, GLint size) { glSelectBuffer(size, buffer); }
-
 // Focus in event.
 void OctoFlexView::focusInEvent(QFocusEvent* event) {
     hasFocus_ = true;
@@ -1336,6 +2677,11 @@ void OctoFlexView::focusOutEvent(QFocusEvent* event) {
 
 // Event filter.
 bool OctoFlexView::eventFilter(QObject* obj, QEvent* event) {
+    // Moving to another window replaces the context, which must not be painting meanwhile.
+    if (obj == this && event->type() == QEvent::WindowAboutToChangeInternal) {
+        waitForRenderThread();
+    }
+
     // If keyboard event, ensure widget has focus.
     if (event->type() == QEvent::KeyPress || event->type() == QEvent::KeyRelease) {
         if (!hasFocus_) {
@@ -1555,8 +2901,39 @@ void OctoFlexView::keyReleaseEvent(QKeyEvent* event) {
 
 // Draw object info text.
 void OctoFlexView::drawObjectInfoText() {
+    if (textRenderer_.isValid()) {
+        // One run per label: laid out again only when a label's text or color changed, moved otherwise.
+        bool changed = labelBatch_.empty() || labelLayout_.size() != objectInfoToRender_.size();
+        for (size_t i = 0; !changed && i < labelLayout_.size(); ++i) {
+            changed = labelLayout_[i].text != objectInfoToRender_[i].text ||
+                      labelLayout_[i].color != objectInfoToRender_[i].color;
+        }
+        if (changed) {
+            labelBatch_.clear();
+            const float textHeight = textRenderer_.height(labelPixelSize_);
+            for (const auto& info : objectInfoToRender_) {
+                labelBatch_.beginRun();
+                const float textWidth = textRenderer_.advance(info.text, labelPixelSize_);
+                // Background slightly larger than the text, behind the baseline at the anchor.
+                labelBatch_.addRect(textRenderer_, -2.0f, -textHeight, textWidth + 4.0f, textHeight + 4.0f,
+                                    glm::vec4(1.0f, 1.0f, 1.0f, 100.0f / 255.0f));
+                const glm::vec4 color(info.color.x, info.color.y, info.color.z, 1.0f);
+                labelBatch_.addText(textRenderer_, info.text, 0.0f, 0.0f, labelPixelSize_, color);
+            }
+            labelLayout_ = objectInfoToRender_;
+        }
+        for (size_t i = 0; i < objectInfoToRender_.size(); ++i) {
+            labelBatch_.setAnchor(i, static_cast<float>(objectInfoToRender_[i].x),
+                                  static_cast<float>(objectInfoToRender_[i].y));
+        }
+        textRenderer_.draw(labelBatch_, static_cast<float>(frame_.width), static_cast<float>(frame_.height));
+        return;
+    }
+
     // Create QPainter.
-    QPainter painter(this);
+    QOpenGLPaintDevice device;
+    QPainter painter;
+    beginOverlayPainter(painter, device);
 
     // Set text color and font.
     QFont font = painter.font();
@@ -1582,6 +2959,17 @@ void OctoFlexView::drawObjectInfoText() {
     }
 }
 
+void OctoFlexView::beginOverlayPainter(QPainter& painter, QOpenGLPaintDevice& device) {
+    if (frameOnGuiThread_) {
+        painter.begin(this);
+        return;
+    }
+    // Widgets are painted on the GUI thread only; the render thread paints into the bound framebuffer.
+    device.setSize(QSize(qRound(frame_.width * frame_.pixelRatio), qRound(frame_.height * frame_.pixelRatio)));
+    device.setDevicePixelRatio(frame_.pixelRatio);
+    painter.begin(&device);
+}
+
 // Context menu event.
 void OctoFlexView::contextMenuEvent(QContextMenuEvent* event) {
     // Create context menu.
@@ -1718,11 +3106,11 @@ void OctoFlexView::showObjectTreeDialog(bool layerOnly) {
     }
 
     // Log layers and objects in object manager.
-    const auto& layers = obj_mgr_->layers();
-    std::cout << "Layer count in object manager: " << layers.size() << std::endl;
+    auto layers = obj_mgr_->layersSnapshot();
+    std::cout << "Layer count in object manager: " << layers->size() << std::endl;
 
-    for (const auto& layerPair : layers) {
-        std::cout << "Layer [" << layerPair.first << "] object count: " << layerPair.second->objects().size()
+    for (const auto& layerPair : *layers) {
+        std::cout << "Layer [" << layerPair.first << "] object count: " << layerPair.second->snapshot()->objects.size()
                   << std::endl;
     }
 
@@ -1746,9 +3134,6 @@ void OctoFlexView::showObjectTreeDialog(bool layerOnly) {
 
         // Log selected objects.
         std::cout << "Selected object count: " << selectedObjects.size() << std::endl;
-        for (const auto& objId : selectedObjects) {
-            std::cout << "  - " << objId << std::endl;
-        }
 
         // Clear current selection.
         clearSelection();
@@ -1874,6 +3259,7 @@ void OctoFlexView::showVisibleLayerDialog() {
         }
 
         // Clear hidden layers.
+        beginRenderStateChange();
         unvisable_layers_.clear();
 
         // Add unselected layers to hidden set.
@@ -1954,6 +3340,7 @@ InfoPanel* OctoFlexView::getInfoPanel() const { return infoPanel_; }
 const std::set<std::string>& OctoFlexView::getUnvisableLayers() const { return unvisable_layers_; }
 
 void OctoFlexView::setUnvisableLayers(const std::set<std::string>& layers) {
+    beginRenderStateChange();
     unvisable_layers_ = layers;
     update();  // Refresh view.
 }
@@ -1991,17 +3378,91 @@ void OctoFlexView::ensureFocus() {
 }
 
 void OctoFlexView::updateFpsInfo() {
+    // Statistics below are written by the frames as they paint; none of them waits for a frame.
+
     // Compute current FPS.
-    currentFps_ = frameCount_ / 1.0f;
-    frameCount_ = 0;
+    currentFps_ = frameCount_.exchange(0) / 1.0f;
 
     // Format FPS with one decimal.
     char fpsStr[32];
     snprintf(fpsStr, sizeof(fpsStr), "%.1f", currentFps_);
     std::string fpsText = "FPS: " + std::string(fpsStr);
 
-    // Update FPS info.
-    setInfoItem("fps", fpsText);
+    // Keep an attached object list in step with the scene.
+    if (objectListWidget_ && obj_mgr_ && obj_mgr_->generation() != objectListGeneration_) {
+        updateObjectList();
+    }
+
+    // Statistics are shown with the next frame; repainting for them would keep an idle view busy.
+    if (infoPanel_) {
+        // Update FPS info.
+        infoPanel_->setInfoItem("fps", fpsText, InfoItemType::NORMAL, false);
+
+        // Update culling info.
+        infoPanel_->setInfoItem("culled",
+                                "Culled: " + std::to_string(culledObjectCount_) + " / " +
+                                    std::to_string(totalObjectCount_),
+                                InfoItemType::NORMAL, false);
+
+        // Update queued update path info.
+        if (obj_mgr_) {
+            UpdateQueueStats stats = obj_mgr_->updateQueueStats();
+            infoPanel_->setInfoItem("queue",
+                                    "Queue: " + std::to_string(stats.depth) + " (dropped " +
+                                        std::to_string(stats.dropped) + ")",
+                                    stats.dropped > 0 ? InfoItemType::WARNING : InfoItemType::NORMAL, false);
+        }
+
+        // Update frame timing info: "<pass>: cpu p50/p99  gpu p50/p99" in milliseconds.
+        if (frameTimingOverlay_) {
+            const FrameTimingStats timing = frameTimer_.stats();
+            auto setTiming = [&](const char* id, const char* label, const PassTiming& pass) {
+                char text[128];
+                if (timing.gpu_timing) {
+                    snprintf(text, sizeof(text), "%s: cpu %.2f/%.2f  gpu %.2f/%.2f ms", label, pass.cpu_p50_ms,
+                             pass.cpu_p99_ms, pass.gpu_p50_ms, pass.gpu_p99_ms);
+                } else {
+                    snprintf(text, sizeof(text), "%s: cpu %.2f/%.2f ms", label, pass.cpu_p50_ms, pass.cpu_p99_ms);
+                }
+                infoPanel_->setInfoItem(id, text, InfoItemType::NORMAL, false);
+            };
+            setTiming("timing_frame", "Frame p50/p99", timing.frame);
+            setTiming("timing_update", "  Update", timing.update);
+            setTiming("timing_opaque", "  Opaque", timing.opaque);
+            setTiming("timing_transparent", "  Transparent", timing.transparent);
+            setTiming("timing_text", "  Object text", timing.object_text);
+            setTiming("timing_panel", "  Info panel", timing.info_panel);
+            setTiming("timing_cleanup", "  Cleanup", timing.cleanup);
+        }
+
+        // Update memory info: "<layer>: cpu / gpu / tex MB (pending MB)", then the total.
+        if (memoryOverlay_) {
+            const SceneMemoryStats memory = memoryStats();
+            std::vector<std::string> items;
+            auto setMemory = [&](const std::string& id, const std::string& label, const LayerMemoryStats& layer) {
+                const double mb = 1.0 / (1024.0 * 1024.0);
+                char text[256];
+                snprintf(text, sizeof(text), "%s: cpu %.1f  gpu %.1f  tex %.1f MB", label.c_str(),
+                         layer.cpu_bytes * mb, layer.gpu_buffer_bytes * mb, layer.texture_bytes * mb);
+                std::string info = text;
+                if (layer.pending_objects > 0) {
+                    snprintf(text, sizeof(text), " (pending %.1f MB)", layer.pending_bytes * mb);
+                    info += text;
+                }
+                infoPanel_->setInfoItem(id, info, InfoItemType::NORMAL, false);
+                items.push_back(id);
+            };
+            setMemory("memory_total", "Memory", memory.total);
+            for (const auto& layer : memory.layers) {
+                setMemory("memory_layer_" + layer.layer_id, "  " + layer.layer_id, layer);
+            }
+            // Layers removed since the last refresh.
+            for (const auto& id : memoryItems_) {
+                if (std::find(items.begin(), items.end(), id) == items.end()) infoPanel_->removeInfoItem(id);
+            }
+            memoryItems_.swap(items);
+        }
+    }
 }
 
 // Set view ID.
@@ -2015,6 +3476,24 @@ void OctoFlexView::setViewId(const std::string& id) {
 std::string OctoFlexView::getViewId() const { return viewId_; }
 
 // Capture current frame from OpenGL framebuffer.
+bool OctoFlexView::renderFrame() {
+    // A hidden widget gets no resize events; the one delivered here makes QOpenGLWidget create the
+    // context, offscreen surface and framebuffer at the current size and call resizeGL.
+    if (!isValid() || size() != offscreenSize_) {
+        QResizeEvent event(size(), offscreenSize_);
+        QCoreApplication::sendEvent(this, &event);
+        offscreenSize_ = size();
+        if (!isValid()) {
+            return false;
+        }
+    }
+
+    waitForRenderThread();
+    makeCurrent();
+    paintGL();
+    return true;
+}
+
 QImage OctoFlexView::captureFrame() {
     // Read pixels from the OpenGL framebuffer
     GLint viewport[4];
@@ -2043,6 +3522,43 @@ QImage OctoFlexView::captureFrame() {
     return image;
 }
 
+std::vector<QImage> OctoFlexView::captureFrameAsync(const FramePool::Ptr& pool) {
+    std::vector<QImage> frames;
+    if (!isValid()) return frames;
+
+    waitForRenderThread();
+    makeCurrent();
+    if (frameCapture_.isSupported()) {
+        const qreal pixelRatio = devicePixelRatioF();
+        frameCapture_.capture(defaultFramebufferObject(), qRound(width() * pixelRatio),
+                              qRound(height() * pixelRatio), format().samples(), pool, frames);
+    } else {
+        frames.push_back(captureFrame());
+    }
+    doneCurrent();
+    return frames;
+}
+
+void OctoFlexView::setCompositeCapture(CompositeCapture* composite, const QRect& rect) {
+    beginRenderStateChange();
+    if (composite != composite_) {
+        composite_ = composite;
+        compositeChanged_ = true;
+    }
+    compositeRect_ = rect;
+}
+
+std::vector<QImage> OctoFlexView::finishFrameCaptures() {
+    std::vector<QImage> frames;
+    if (!isValid()) return frames;
+
+    waitForRenderThread();
+    makeCurrent();
+    frameCapture_.finish(frames);
+    doneCurrent();
+    return frames;
+}
+
 void OctoFlexView::expandView() {
     if (!isExpanded_) {
         isExpanded_ = true;
@@ -2101,6 +3617,7 @@ void OctoFlexView::updateButtonStates() {
 }
 
 void OctoFlexView::toggleGrid() {
+    beginRenderStateChange();
     // Toggle grid visibility.
     showGrid_ = !showGrid_;
 
@@ -2122,105 +3639,39 @@ void OctoFlexView::toggleGrid() {
 }
 
 void OctoFlexView::renderGrid() {
-    // Get current camera position.
-    glm::vec3 cameraPos = camera_->getPosition();
-
-    // Grid parameters.
-    const float gridSize = 10.0f;  // Grid cell size (10 meters).
-    const float gridExtent = 50;   // Grid spans 10 cells per side (100 meters).
-
-    // Compute grid origin centered on camera.
-    float startX = cameraPos.x - gridExtent * gridSize / 2;
-    float startY = cameraPos.y - gridExtent * gridSize / 2;
-
-    // Snap origin to grid lines.
-    startX = floor(startX / gridSize) * gridSize;
-    startY = floor(startY / gridSize) * gridSize;
-
-    // Begin drawing grid lines.
-    glBegin(GL_LINES);
+    if (gridBuffer_ == 0) return;
 
-    // Color by distance (near = gray, far = white).
-    float maxDist = gridExtent * gridSize / 2;
-    float z = -1e-3;
-    // Draw grid lines on XY plane.
-    for (int i = 0; i <= gridExtent; ++i) {
-        float y = startY + i * gridSize;
-
-        for (int j = 0; j <= gridExtent; ++j) {
-            float x = startX + j * gridSize;
-
-            // Compute XY-plane distance to camera.
-            float dx = x - cameraPos.x;
-            float dy = y - cameraPos.y;
-            float distFromCamera = sqrt(dx * dx + dy * dy);
-
-            float t = std::min(distFromCamera / maxDist, 1.0f);
-            float gray = 0.5f + t * 0.5f;  // From ~0.39 to 1.0 (white).
-
-            // Set color (opaque).
-            glColor3f(gray, gray, gray);
-
-            glVertex3f(x, y, z);
-            glVertex3f(x + gridSize, y, z);
+    // Get current camera position.
+    const glm::vec3 cameraPos = frame_.cameraPosition;
 
-            glVertex3f(x, y, z);
-            glVertex3f(x, y + gridSize, z);
-        }
+    // Cells grow tenfold whenever the camera rises above the grid radius, so the grid keeps covering the view.
+    float scale = 1.0f;
+    while (std::abs(cameraPos.z) > kGridExtent * kGridCellSize * scale / 2 && scale < 1e6f) {
+        scale *= 10.0f;
     }
 
-    glEnd();
+    // Snap the grid center to a cell corner under the camera.
+    const float cellSize = kGridCellSize * scale;
+    const float centerX = std::floor(cameraPos.x / cellSize) * cellSize;
+    const float centerY = std::floor(cameraPos.y / cellSize) * cellSize;
+
+    glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(centerX, centerY, 0.0f));
+    model = glm::scale(model, glm::vec3(scale, scale, 1.0f));
+    RenderBackend::VertexSource source;
+    source.buffer = gridBuffer_;
+    backend_->pushModel(model);
+    backend_->draw(source, RenderBackend::Lines, 0, gridVertexCount_, RenderBackend::DrawStyle());
+    backend_->popModel();
 }
 
 void OctoFlexView::renderCoordinateSystem() {
-    // Axis parameters.
-    const float axisLength = 5.0f;   // Axis length.
-    const float arrowHeight = 0.3f;  // Arrow height (along axis).
-    const float arrowWidth = 0.08f;  // Arrow width (perpendicular to axis).
+    if (axesBuffer_ == 0) return;
 
-    // Draw axes.
-    glBegin(GL_LINES);
-
-    // X axis - red.
-    glColor3f(1.0f, 0.0f, 0.0f);         // Red.
-    glVertex3f(0.0f, 0.0f, 0.0f);        // Origin.
-    glVertex3f(axisLength, 0.0f, 0.0f);  // +X.
-
-    // Y axis - green.
-    glColor3f(0.0f, 1.0f, 0.0f);         // Green.
-    glVertex3f(0.0f, 0.0f, 0.0f);        // Origin.
-    glVertex3f(0.0f, axisLength, 0.0f);  // +Y.
-
-    // Z axis - blue.
-    glColor3f(0.0f, 0.0f, 1.0f);         // Blue.
-    glVertex3f(0.0f, 0.0f, 0.0f);        // Origin.
-    glVertex3f(0.0f, 0.0f, axisLength);  // +Z.
-
-    glEnd();
-
-    // Draw X-axis arrow.
-    glBegin(GL_TRIANGLES);
-    glColor3f(1.0f, 0.0f, 0.0f);                              // Red.
-    glVertex3f(axisLength, 0.0f, 0.0f);                       // Tip.
-    glVertex3f(axisLength - arrowHeight, arrowWidth, 0.0f);   // Base.
-    glVertex3f(axisLength - arrowHeight, -arrowWidth, 0.0f);  // Base.
-    glEnd();
-
-    // Draw Y-axis arrow.
-    glBegin(GL_TRIANGLES);
-    glColor3f(0.0f, 1.0f, 0.0f);                              // Green.
-    glVertex3f(0.0f, axisLength, 0.0f);                       // Tip.
-    glVertex3f(arrowWidth, axisLength - arrowHeight, 0.0f);   // Base.
-    glVertex3f(-arrowWidth, axisLength - arrowHeight, 0.0f);  // Base.
-    glEnd();
-
-    // Draw Z-axis arrow.
-    glBegin(GL_TRIANGLES);
-    glColor3f(0.0f, 0.0f, 1.0f);                              // Blue.
-    glVertex3f(0.0f, 0.0f, axisLength);                       // Tip.
-    glVertex3f(arrowWidth, 0.0f, axisLength - arrowHeight);   // Base.
-    glVertex3f(-arrowWidth, 0.0f, axisLength - arrowHeight);  // Base.
-    glEnd();
+    RenderBackend::VertexSource source;
+    source.buffer = axesBuffer_;
+    backend_->draw(source, RenderBackend::Lines, 0, kAxisLineVertexCount, RenderBackend::DrawStyle());
+    backend_->draw(source, RenderBackend::Triangles, kAxisLineVertexCount, kAxisArrowVertexCount,
+                   RenderBackend::DrawStyle());
 }
 
 void OctoFlexView::handleCameraMovement(float deltaForward, float deltaRight, float deltaUp) {
@@ -2348,7 +3799,15 @@ void OctoFlexView::updateCoordinateSystem() {
         return;
     }
 
-    auto [layerId, obj] = obj_mgr_->findObject(objectId);
+    if (objectId != followedObjectId_) {
+        if (followedHandle_ != kNoObjectHandle) {
+            ObjectRegistry::instance().release(followedHandle_);
+        }
+        followedHandle_ = ObjectRegistry::instance().acquire(objectId);
+        followedObjectId_ = objectId;
+    }
+
+    auto [layerId, obj] = obj_mgr_->findObject(followedHandle_);
     if (!obj) {
         // Object no longer exists - invalidate or switch to global
         std::cout << "Attached object '" << objectId << "' no longer exists, switching to global coordinate system"
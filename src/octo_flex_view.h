@@ -25,7 +25,11 @@
 #include <QListWidget>
 #include <QMenu>
 #include <QMouseEvent>
+#include <QMutex>
+#include <QOpenGLFramebufferObject>
 #include <QOpenGLFunctions>
+#include <QOpenGLPaintDevice>
+#include <QOpenGLShaderProgram>
 #include <QOpenGLWidget>
 #include <QPushButton>
 #include <QRubberBand>
@@ -34,16 +38,34 @@
 #include <QWheelEvent>
 #include <QWidget>
 #include <glm/glm.hpp>
+#include <atomic>
 #include <map>
+#include <memory>
 #include <set>
 #include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include "camera.h"
 #include "coordinate_system.h"
+#include "composite_capture.h"
+#include "frame_capture.h"
+#include "frame_timer.h"
+#include "frustum.h"
 #include "info_panel.h"
+#include "instanced_shape.h"
+#include "layer_batch.h"
 #include "object.h"
 #include "object_manager.h"
 #include "object_tree_dialog.h"
+#include "point_cloud_shape.h"
+#include "render_backend.h"
+#include "render_thread.h"
+#include "scalar_field.h"
+#include "scene_resources.h"
+#include "text_renderer.h"
+#include "trajectory_shape.h"
+#include "triple_buffer.h"
 
 namespace octo_flex {
 
@@ -53,6 +75,12 @@ enum class RenderMode {
     SELECT   // Selection mode.
 };
 
+// Refresh mode enum.
+enum class RefreshMode {
+    ON_DEMAND,  // Repaint only when the scene, camera or view state changed.
+    CONTINUOUS  // Repaint at the refresh rate.
+};
+
 // Selection mode enum.
 enum class SelectionMode {
     POINT,  // Point selection.
@@ -73,12 +101,32 @@ class OctoFlexView : public QOpenGLWidget, protected QOpenGLFunctions {
     virtual void renderObject(const Object& object, RenderMode mode = RenderMode::RENDER, GLuint nameID = 0,
                               bool transparent = false);
 
+    // Draw transparent objects back to front by view depth (default), or in batch order when disabled.
+    void setTransparencySorting(bool enabled);
+    bool transparencySorting() const;
+
     // Set view and projection matrices
     void setViewMatrix(const glm::mat4& viewMatrix_);
     void setProjectionMatrix(const glm::mat4& projectionMatrix_);
     virtual void setObjectManager(ObjectManager::Ptr obj_mgr);
 
+    // Share GPU resources with other views of the same scene (set before the view is shown).
+    // Falls back to private resources if this view's context does not share with theirs.
+    void setSceneResources(SceneResources::Ptr resources);
+
+    // Paint on a render thread of this view (see RenderThread) instead of the GUI thread, which then
+    // only publishes the camera and viewport of each frame. Input, picking, capture, resizing and
+    // recording a layout composite stay on the GUI thread. New views start with defaultThreadedRendering().
+    void setThreadedRendering(bool enabled);
+    bool threadedRendering() const;
+    // Initially from OCTO_FLEX_RENDER_THREAD ("1" or "on" enables it).
+    static bool defaultThreadedRendering();
+    static void setDefaultThreadedRendering(bool enabled);
+
     // Refresh rate control
+    // In ON_DEMAND mode the refresh rate is how often the view checks for scene changes.
+    void setRefreshMode(RefreshMode mode);
+    RefreshMode refreshMode() const;
     void setRefreshRate(int fps);
     int refreshRate() const;
     void startRefresh();
@@ -88,7 +136,7 @@ class OctoFlexView : public QOpenGLWidget, protected QOpenGLFunctions {
     // Set object list widget.
     void setObjectListWidget(QListWidget* list);
 
-    // Refresh object list.
+    // Refresh object list; runs once per second by itself while the scene generation changes.
     void updateObjectList();
 
     // Select object.
@@ -100,6 +148,42 @@ class OctoFlexView : public QOpenGLWidget, protected QOpenGLFunctions {
     // Clear all selections.
     void clearSelection();
 
+    // Instance index of the last picked instanced shape (-1 if the last pick hit no instance).
+    int getLastPickedInstance() const;
+
+    // Select at widget coordinates as a click (about 5x5 pixels, POINT) or a rubber band (RECT) over
+    // the region would, for automation and benchmarks.
+    void pickRegion(const QPoint& point, int width, int height, SelectionMode mode);
+
+    // Point indices hit by the last rectangle selection, per object. Indices run over the
+    // object's point cloud shapes in shape order.
+    const std::map<std::string, std::vector<uint32_t>>& getLastPickedPoints() const;
+
+    // Point cloud budget per frame while the camera moves, and the budget progressively
+    // refined towards while it is still.
+    void setPointBudget(size_t interactive, size_t refined);
+
+    // Rolling per-pass CPU/GPU times of the painted frames, and whether the info panel lists them.
+    FrameTimingStats frameTimingStats() const;
+    void setFrameTimingOverlay(bool enabled);
+    bool frameTimingOverlay() const;
+
+    // Memory per layer of the object manager, plus the merged batches this view's share group drew
+    // them with, and whether the info panel lists it.
+    SceneMemoryStats memoryStats() const;
+    void setMemoryOverlay(bool enabled);
+    bool memoryOverlay() const;
+
+    // Pick with the layers' bounding volume hierarchies (the default) or with a GPU pick pass, which
+    // only hits what is visible. CPU rubber bands select every object in the band, occluded ones included.
+    void setCpuPicking(bool enabled);
+    bool cpuPicking() const;
+
+    // Fraction an object's projected size must move past a switch size before its level of detail
+    // changes (see Object::lodSizes()); 0, the default, switches exactly at the sizes.
+    void setLodHysteresis(float fraction);
+    float lodHysteresis() const;
+
     // Get camera.
     Camera::Ptr getCamera() const;
 
@@ -147,9 +231,25 @@ class OctoFlexView : public QOpenGLWidget, protected QOpenGLFunctions {
     void setViewId(const std::string& id);
     std::string getViewId() const;
 
+    // Paint one frame now, for a view that is never shown (headless rendering): Qt then renders the
+    // widget into a framebuffer object on an offscreen surface. Creates the context and framebuffer on
+    // first use and after resize(). Leaves the context current. Returns false without a context.
+    bool renderFrame();
+
     // Capture current frame from OpenGL framebuffer (for video recording)
     QImage captureFrame();
 
+    // Start reading back the last painted frame without waiting for it. Returns the frames whose
+    // readback finished, oldest first (usually the captures one or two calls earlier); a null image
+    // marks a failed readback. Frames are fitted to and stored in pool buffers when a pool is given.
+    // Reads synchronously (at view size, unpooled) where pixel-pack buffers or fences are missing.
+    std::vector<QImage> captureFrameAsync(const FramePool::Ptr& pool = nullptr);
+    // Wait for the frames still being read back.
+    std::vector<QImage> finishFrameCaptures();
+
+    // Copy every painted frame into rect (OpenGL coordinates) of a layout composite; null stops.
+    void setCompositeCapture(CompositeCapture* composite, const QRect& rect);
+
     // Update FPS info.
     void updateFpsInfo();
 
@@ -201,11 +301,18 @@ class OctoFlexView : public QOpenGLWidget, protected QOpenGLFunctions {
     void requestExpand();
     void requestCollapse();
 
+    // Emitted when a pick hits one instance of an instanced shape.
+    void instancePicked(const std::string& objectId, int instanceIndex);
+
    protected:
     void initializeGL() override;
     void paintGL() override;
     void resizeGL(int width, int height) override;
 
+    // Paint events hand frames to the render thread if there is one; resizes paint their first frame here.
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+
     // Context menu event handler.
     void contextMenuEvent(QContextMenuEvent* event) override;
 
@@ -230,39 +337,115 @@ class OctoFlexView : public QOpenGLWidget, protected QOpenGLFunctions {
     Camera::Ptr camera_;
 
    private:
-    // Vertex Buffer Objects
-    GLuint VBO_;
-
     // Matrices
     glm::mat4 viewMatrix_;
     glm::mat4 projectionMatrix_;
 
-    // Setup fixed-function pipeline
-    void setupFixedFunctionPipeline();
+    // Create the render backend chosen at startup, falling back to fixed function if the context cannot run it.
+    void initializeBackend();
 
     // Render a single shape.
     void renderShape(const Shape& shape, RenderMode mode = RenderMode::RENDER);
 
-    // Draw object info text.
+    // Render an editable shape (no vertex buffer yet) from a temporary vertex array.
+    void renderEditableShape(const Shape& shape, const RenderBackend::DrawStyle& style);
+
+    // Draw all vertices of a shape from source, by its triangle indices when it was triangulated.
+    void drawShapeVertices(const Shape& shape, const RenderBackend::VertexSource& source,
+                           const RenderBackend::DrawStyle& style);
+
+    // Render an instanced shape, with one instanced draw call per prototype shape when supported.
+    // In SELECT mode instance i is encoded as pick ID pickBase + i.
+    void renderInstancedShape(const InstancedShape& shape, RenderMode mode, bool transparent, GLuint pickBase = 0);
+
+    // Render a point cloud's octree nodes chosen for the current view and point budget.
+    void renderPointCloud(const PointCloudShape& cloud, RenderMode mode);
+
+    // Render the points a trajectory shape has uploaded, from its ring buffer.
+    void renderTrajectory(const TrajectoryShape& shape, RenderMode mode);
+
+    // Per-instance fixed-function fallback used when instanced drawing is unavailable.
+    void renderInstancedShapeFallback(const InstancedShape& shape, RenderMode mode, bool transparent,
+                                      GLuint pickBase);
+
+    // Compile the instancing shader and resolve the instanced draw entry points.
+    void initializeInstancing();
+
+    // Upload the static grid and axis vertex buffers; released before the context goes away.
+    void initializeStaticGeometry();
+    void releaseStaticGeometry();
+
+    // Rebuild a layer's draw batch if its contents changed.
+    LayerBatch::Ptr updateLayerBatch(const std::string& layerId, const Layer::Ptr& layer);
+
+    // Render one pass of a layer's draw batch, skipping objects whose visible flag is 0. Other flags are
+    // 1 + the level of detail drawn, ranges of other levels being skipped.
+    void renderLayerBatch(const LayerBatch& batch, bool transparent, const std::vector<char>& visible,
+                          bool allVisible);
+
+    // Render the shapes of an object that are not part of the layer batch; posed objects draw all shapes.
+    // Shapes of a level of detail other than level are skipped.
+    void renderUnbatchedShapes(const Object& object, bool transparent, bool posed, int level);
+
+    // Map the colors of an object's shapes through its scalar attribute until endObjectScalars() (render mode).
+    // setShapeScalars() selects the values of the shape at shapeIndex before it is drawn.
+    void beginObjectScalars(const Object& object);
+    void setShapeScalars(size_t shapeIndex);
+    void endObjectScalars() { objectScalars_ = ObjectScalars(); }
+
+    // Whether the object being drawn takes one scalar color for all of its shapes.
+    bool hasObjectScalarColor() const { return objectScalars_.field && objectScalars_.field->isPerObject(); }
+
+    // Replace the colors of a draw of shape by the scalar mapping of the object being drawn, if any.
+    void applyScalars(const Shape& shape, RenderBackend::DrawStyle& style) const;
+
+    // Level of detail to draw an object with this frame, 0 for objects without levels.
+    int selectLodLevel(const Object& object, const BoundingBox& bounds);
+
+    // Multiply a posed object's model matrix onto the current transform and move point cloud LOD into its frame.
+    // Returns false (and changes nothing) if the object is not posed; otherwise pair with popObjectTransform.
+    bool pushObjectTransform(const Object& object, PointCloudShape::LodParams& worldLod);
+    void popObjectTransform(const PointCloudShape::LodParams& worldLod);
+
+    // Transparent object queued for the depth-sorted pass.
+    struct TransparentDraw {
+        float depth;  // View-space distance of the bounds center
+        const LayerBatch* batch;
+        int object;  // Index into batch->objects()
+        int level;   // Level of detail drawn
+    };
+
+    // Render queued transparent objects in order, batched ranges first, then unbatched shapes.
+    void renderSortedTransparent(const std::vector<TransparentDraw>& draws);
+
+    // Draw object info text, through the glyph atlas or, where it is unavailable, QPainter.
     void drawObjectInfoText();
 
-    // Calculate object info text positions.
-    void calculateObjectInfoPosition(const Object& object, bool transparent);
+    // Begin painting an overlay over the frame: on the widget, or through device on the render thread.
+    void beginOverlayPainter(QPainter& painter, QOpenGLPaintDevice& device);
+
+    // Queue a selected object for an info text label this frame.
+    void queueObjectInfo(const Object& object);
+
+    // Compute positions of all queued labels on the CPU from the camera matrices, without GL queries.
+    void projectObjectInfo();
 
     // Toggle projection mode.
     void toggleProjection();
 
-    // Common GL_SELECT selection handler.
-    void handleSelectionWithGLSelect(const QPoint& point, int width, int height, SelectionMode mode);
+    // Common selection handler (CPU or ID-buffer picking).
+    void handleSelection(const QPoint& point, int width, int height, SelectionMode mode);
 
-    // Set selection buffer.
-    void setupSelectBuffer(GLuint* buffer, GLint size);
+    // Projection that maps a region of the widget (Qt coordinates) onto the full NDC range.
+    glm::mat4 pickProjection(const QRect& region) const;
 
-    // Enter selection mode.
-    void enterSelectMode(int x, int y, int width, int height);
+    // Render object IDs for the pick region into the pick FBO and return the hit IDs.
+    std::vector<GLuint> pickObjectIds(int x, int y, int width, int height, SelectionMode mode);
 
-    // Exit selection mode and process results.
-    std::vector<GLuint> processHits(GLint hits, SelectionMode mode);
+    // Objects under the pick region from the layers' bounding volume hierarchies, with the instance hit
+    // (-1 if none): the nearest one along a cone through the region, or all inside its frustum.
+    std::vector<std::pair<ObjectHandle, int>> pickObjectsCpu(int x, int y, int width, int height,
+                                                             SelectionMode mode);
 
     // Create context menu.
     void createContextMenu(const QPoint& pos);
@@ -279,16 +462,102 @@ class OctoFlexView : public QOpenGLWidget, protected QOpenGLFunctions {
     // Set camera view (relative to selected object or origin).
     void setCameraView(const std::string& viewDirection);
 
+    // Whether anything shown by the view changed since the last paint (ON_DEMAND mode).
+    bool needsRepaint() const;
+
+    // Camera and viewport a frame is painted with, handed from the GUI thread to the render thread.
+    struct ViewState {
+        glm::mat4 view = glm::mat4(1.0f);
+        glm::mat4 projection = glm::mat4(1.0f);
+        glm::vec3 cameraPosition = glm::vec3(0.0f);
+        bool perspective = true;
+        int width = 0;
+        int height = 0;
+        float pixelRatio = 1.0f;
+        uint64_t panelVersion = 0;  // Of the info panel items
+
+        bool operator==(const ViewState& other) const;
+    };
+
+    // Camera and viewport for the next frame, after following the attached coordinate system (GUI thread).
+    ViewState captureViewState();
+
+    // Paint one frame, holding sceneLock() for the shared state it updates and draws: on the GUI thread
+    // with the view state read now, or on the render thread with the one published last.
+    void paintFrame(bool guiThread);
+
+    // Paint a frame on the render thread into renderTarget_ and copy it into the widget's framebuffer.
+    void paintThreadedFrame();
+
+    // Start the render thread once the context exists.
+    void startRenderThread();
+
+    // Wait for the frame painting on the render thread, before GUI code uses the context or state the
+    // frames read; no other frame starts until the GUI thread returns to its event loop.
+    void waitForRenderThread() const;
+
+    // The same before changing state the frames read; the next paint event then paints a frame.
+    void beginRenderStateChange();
+
+    // Show the refresh mode and rate in the info panel.
+    void updateRefreshInfo();
+
    private:
     QTimer* refreshTimer_;
     int refreshRate_;
+    RefreshMode refreshMode_ = RefreshMode::ON_DEMAND;
+
+    // State the last frame was painted with; the counters are written by the thread painting.
+    std::atomic<bool> hasPainted_{false};
+    std::atomic<uint64_t> paintedGeneration_{0};
+    glm::mat4 paintedViewMatrix_;                     // Camera view read for the last frame (GUI thread)
+    std::atomic<uint64_t> paintedTextureBatches_{0};  // Texture upload batches finished before the last paint
+    std::atomic<uint64_t> paintedDynamicFrames_{0};   // Dynamic texture frames submitted before the last paint
+    std::atomic<uint64_t> paintedTrajectories_{0};    // Trajectory changes made before the last paint
+    std::atomic<uint64_t> paintedScalars_{0};         // Scalar values and mappings replaced before the last paint
+
+    // Threaded rendering.
+    bool threadedRendering_ = defaultThreadedRendering();
+    std::unique_ptr<RenderThread> renderThread_;
+    TripleBuffer<ViewState> viewStates_;  // Published by paint events, taken by the render thread
+    ViewState publishedState_;            // Published last (GUI thread)
+    ViewState frame_;                     // Of the frame painting
+    bool frameOnGuiThread_ = true;        // Whether the frame painting is on the GUI thread
+    bool renderStateChanged_ = false;     // Since the last frame was handed over (GUI thread)
+    bool resizing_ = false;               // Inside resizeEvent(), whose frame paints on the GUI thread
+    std::atomic<bool> refining_{false};   // Point clouds cut short by the budget on the render thread
+    // The render thread paints here and copies finished frames into the widget's framebuffer, holding
+    // composeMutex_; Qt composes the widget holding it too, so it never waits for a frame in flight.
+    QOpenGLFramebufferObject* renderTarget_ = nullptr;
+    QMutex composeMutex_;
+    bool composing_ = false;  // composeMutex_ is held for Qt's compose (GUI thread)
 
     // FPS tracking.
-    int frameCount_;
+    std::atomic<int> frameCount_;
     QTimer* fpsTimer_;
     float currentFps_;
     std::string viewId_;
 
+    // Per-pass frame timing, created with the GL context.
+    FrameTimer frameTimer_;
+    bool frameTimingOverlay_ = false;
+
+    // Info panel items of the memory overlay, one per layer and the total.
+    bool memoryOverlay_ = false;
+    std::vector<std::string> memoryItems_;
+
+    // Asynchronous readback for recording, created with the GL context.
+    FrameCapture frameCapture_;
+
+    // Size of the framebuffer renderFrame() last delivered a resize for.
+    QSize offscreenSize_;
+
+    // Layout composite this view draws its frames into while the container records all views.
+    CompositeCapture* composite_ = nullptr;
+    QRect compositeRect_;
+    bool compositeChanged_ = false;
+    CompositeTarget compositeTarget_;
+
     // Directly use internal matrices.
     glm::mat4 perspectiveMatrix_;
     glm::mat4 orthoMatrix_;
@@ -296,20 +565,99 @@ class OctoFlexView : public QOpenGLWidget, protected QOpenGLFunctions {
 
     // Object selection.
     QListWidget* objectListWidget_ = nullptr;
+    struct ObjectListLayer {
+        uint64_t version = 0;  // Layer version the items were read at
+        std::unordered_map<std::string, QListWidgetItem*> items;
+    };
+    std::map<std::string, ObjectListLayer> objectListLayers_;
+    uint64_t objectListGeneration_ = 0;  // Scene generation the object list was read at
     std::set<std::string> selectedObjects_;
+    std::unordered_set<ObjectHandle> selectedHandles_;  // The same IDs, each holding a registry reference
+
+    // Object the local coordinate system follows, interned once rather than looked up every frame.
+    std::string followedObjectId_;
+    ObjectHandle followedHandle_ = kNoObjectHandle;  // Holds a registry reference
 
     std::set<std::string> unvisable_layers_;
     std::set<std::string> unselectable_layers_;
 
+    // Per-layer draw batches, shared with the other views of the scene.
+    SceneResources::Ptr sceneResources_ = std::make_shared<SceneResources>();
+
+    // Pipeline all geometry is drawn through, created at initializeGL.
+    RenderBackend::Ptr backend_;
+    glm::vec4 pickColor_ = glm::vec4(0.0f);            // Pick ID color of the object being picked
+
+    // Scalar attribute of the object being drawn (see beginObjectScalars()).
+    struct ObjectScalars {
+        const ScalarField* field = nullptr;
+        ScalarField::Mapping mapping;
+        glm::vec3 color = glm::vec3(1.0f);  // Of a per-object field
+        GLintptr offset = -1;               // Bytes to the values of the shape drawn, -1 if it takes none
+    };
+    ObjectScalars objectScalars_;
+    std::vector<Shape::GpuVertex> editableVertices_;  // Reused by renderEditableShape
+
+    // Static grid (unit cells around the origin, placed under the camera per frame) and axis gizmo.
+    GLuint gridBuffer_ = 0;
+    GLsizei gridVertexCount_ = 0;
+    GLuint axesBuffer_ = 0;
+
+    // Depth-sorted transparent pass.
+    bool sortTransparent_ = true;
+    std::vector<TransparentDraw> transparentDraws_;  // Reused between frames
+
+    // Level of detail each leveled object was drawn with last frame, for hysteresis.
+    float lodHysteresis_ = 0.0f;
+    std::unordered_map<ObjectHandle, int> lodLevels_;
+    std::unordered_map<ObjectHandle, int> nextLodLevels_;
+
+    // Instanced drawing, resolved at initializeGL (null when unsupported or with the shader backend).
+    typedef void(QOPENGLF_APIENTRYP DrawArraysInstancedFn)(GLenum, GLint, GLsizei, GLsizei);
+    typedef void(QOPENGLF_APIENTRYP DrawElementsInstancedFn)(GLenum, GLsizei, GLenum, const void*, GLsizei);
+    typedef void(QOPENGLF_APIENTRYP VertexAttribDivisorFn)(GLuint, GLuint);
+    DrawArraysInstancedFn drawArraysInstanced_ = nullptr;
+    DrawElementsInstancedFn drawElementsInstanced_ = nullptr;  // Triangulated prototypes, may be null
+    VertexAttribDivisorFn vertexAttribDivisor_ = nullptr;
+    QOpenGLShaderProgram* instanceProgram_ = nullptr;
+
+    // Point cloud level of detail.
+    PointCloudShape::LodParams lodParams_;
+    glm::mat4 lodViewProjection_ = glm::mat4(0.0f);
+    glm::mat4 lodFrustumMatrix_ = glm::mat4(1.0f);  // Matrix lodParams_.frustum was built from
+    size_t pointBudget_ = 2000000;
+    size_t refinedPointBudget_ = 16000000;
+    size_t frameBudget_ = 2000000;  // Grows towards refinedPointBudget_ while the camera is still
+    size_t remainingBudget_ = 0;
+    bool lodLimited_ = false;  // Some cloud was cut short by the budget this frame
+    std::vector<PointCloudShape::DrawRange> lodRanges_;
+    std::vector<GLint> lodFirsts_;
+    std::vector<GLsizei> lodCounts_;
+
+    // Frustum culling statistics of the last frame.
+    std::atomic<size_t> culledObjectCount_{0};
+    std::atomic<size_t> totalObjectCount_{0};
+
     // Rectangle selection.
     QRubberBand rubberBand_;
     QPoint rubberBandOrigin_;
     bool isClick_ = false;
 
-    // GL_SELECT mode.
-    static const GLsizei SELECT_BUFFER_SIZE_ = 1024;
-    GLuint selectBuffer_[SELECT_BUFFER_SIZE_];
-    std::map<GLuint, std::string> nameToObjectId_;
+    // ID-buffer picking.
+    QOpenGLFramebufferObject* pickFbo_ = nullptr;
+    // Consecutive pick IDs owned by one object; instanced shapes own one ID per instance.
+    struct PickRange {
+        GLuint first;
+        GLuint count;
+        ObjectHandle object;
+        bool instanced;
+    };
+    bool cpuPicking_ = true;
+    std::vector<PickRange> pickRanges_;  // Sorted by first ID.
+    int lastPickedInstance_ = -1;
+    Frustum lastPickFrustum_;
+    glm::mat4 lastPickViewProjection_ = glm::mat4(1.0f);
+    std::map<std::string, std::vector<uint32_t>> pickedPoints_;
 
     Vec3 bk_color_;
 
@@ -343,6 +691,17 @@ class OctoFlexView : public QOpenGLWidget, protected QOpenGLFunctions {
         int y;
     };
     std::vector<ObjectInfoText> objectInfoToRender_;
+    std::vector<const Object*> infoObjects_;  // Labeled objects of this frame, alive through the layer batches
+    std::vector<float> infoCorners_;          // Bounds corners as x, y, z and w arrays of 8 per object
+
+    // Labels and the info panel as glyph atlas quads, created with the GL context. Batches are laid
+    // out again only when their text changes.
+    TextRenderer textRenderer_;
+    TextBatch labelBatch_;
+    std::vector<ObjectInfoText> labelLayout_;  // Labels labelBatch_ was laid out for
+    float labelPixelSize_ = 12.0f;             // Of the widget font, resolved on the GUI thread
+    TextBatch panelBatch_;
+    uint64_t panelVersion_ = 0;                // Info panel version panelBatch_ was laid out at
 
     // Context menu.
     QMenu* contextMenu_ = nullptr;
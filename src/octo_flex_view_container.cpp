@@ -32,6 +32,15 @@
 #include "recording_thread.h"
 
 namespace octo_flex {
+namespace {
+
+// Memory for frames between capture and encoder: about 30 frames at 1080p, 7 at 4K.
+const size_t kRecordingPoolBytes = 256u * 1024 * 1024;
+
+// Offline recordings wait this long for the encoder to free a frame before giving up on it.
+const int kOfflineEncoderWaitMs = 10000;
+
+}  // namespace
 
 OctoFlexViewContainer::OctoFlexViewContainer(QWidget* parent)
     : QWidget(parent), currentView_(nullptr), expandedView_(nullptr), objectManager_(nullptr) {
@@ -50,7 +59,7 @@ OctoFlexViewContainer::OctoFlexViewContainer(QWidget* parent)
 
     // Frame capture timer for recording.
     recordingTimer_ = new QTimer(this);
-    connect(recordingTimer_, &QTimer::timeout, this, &OctoFlexViewContainer::captureRecordingFrame);
+    connect(recordingTimer_, &QTimer::timeout, this, &OctoFlexViewContainer::requestRecordingFrame);
 
     // Status timer for updating elapsed recording time.
     recordingStatusTimer_ = new QTimer(this);
@@ -90,6 +99,57 @@ void OctoFlexViewContainer::setObjectManager(ObjectManager::Ptr obj_mgr) {
     }
 }
 
+void OctoFlexViewContainer::setRefreshMode(RefreshMode mode) {
+    refreshMode_ = mode;
+
+    // Apply refresh mode to all views.
+    for (auto* view : views_) {
+        if (view) {
+            view->setRefreshMode(mode);
+        }
+    }
+}
+
+void OctoFlexViewContainer::setFrameTimingOverlay(bool enabled) {
+    frameTimingOverlay_ = enabled;
+
+    for (auto* view : views_) {
+        if (view) {
+            view->setFrameTimingOverlay(enabled);
+        }
+    }
+}
+
+void OctoFlexViewContainer::setMemoryOverlay(bool enabled) {
+    memoryOverlay_ = enabled;
+
+    for (auto* view : views_) {
+        if (view) {
+            view->setMemoryOverlay(enabled);
+        }
+    }
+}
+
+void OctoFlexViewContainer::setCpuPicking(bool enabled) {
+    cpuPicking_ = enabled;
+
+    for (auto* view : views_) {
+        if (view) {
+            view->setCpuPicking(enabled);
+        }
+    }
+}
+
+void OctoFlexViewContainer::setLodHysteresis(float fraction) {
+    lodHysteresis_ = fraction;
+
+    for (auto* view : views_) {
+        if (view) {
+            view->setLodHysteresis(fraction);
+        }
+    }
+}
+
 bool OctoFlexViewContainer::startRecording(const RecordingOptions& options) {
     if (isRecording_) {
         lastRecordingError_ = "Recording is already running";
@@ -116,19 +176,22 @@ bool OctoFlexViewContainer::startRecording(const RecordingOptions& options) {
         return false;
     }
 
-    // Capture frame directly from OpenGL framebuffer of the current view
-    QImage frame = currentView_->captureFrame();
-    if (frame.isNull() || frame.width() <= 0 || frame.height() <= 0) {
-        lastRecordingError_ = "Failed to capture initial OpenGL framebuffer";
+    if (options.offline && options.capture_all_views) {
+        lastRecordingError_ = "Offline recording captures the current view only";
         return false;
     }
 
-    // Convert to RGB888 format for video recording
-    frame = frame.convertToFormat(QImage::Format_RGB888);
+    if (options.width < 0 || options.height < 0) {
+        lastRecordingError_ = "Recording size must not be negative";
+        return false;
+    }
 
-    recordingOptions_ = options;
-    recordingWidth_ = frame.width();
-    recordingHeight_ = frame.height();
+    // Record at the requested size, else at the device pixel size of the captured area.
+    const bool allViews = options.capture_all_views;
+    const QWidget* captured = allViews ? static_cast<QWidget*>(this) : currentView_;
+    const qreal pixelRatio = captured->devicePixelRatioF();
+    recordingWidth_ = options.width > 0 ? options.width : qRound(captured->width() * pixelRatio);
+    recordingHeight_ = options.height > 0 ? options.height : qRound(captured->height() * pixelRatio);
     // yuv420p (used by default) requires even dimensions.
     if (recordingWidth_ % 2 != 0) {
         recordingWidth_ -= 1;
@@ -138,19 +201,52 @@ bool OctoFlexViewContainer::startRecording(const RecordingOptions& options) {
     }
     if (recordingWidth_ <= 0 || recordingHeight_ <= 0) {
         lastRecordingError_ = "Invalid recording dimensions after normalization";
+        recordingWidth_ = 0;
+        recordingHeight_ = 0;
         return false;
     }
-    if (frame.width() != recordingWidth_ || frame.height() != recordingHeight_) {
-        frame = frame.scaled(recordingWidth_, recordingHeight_, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+    // All views draw into one offscreen frame, in a context sharing objects with theirs.
+    if (allViews) {
+        QOpenGLContext* shareContext = QOpenGLContext::globalShareContext();
+        if (!shareContext) {
+            shareContext = currentView_->context();
+        }
+        composite_ = std::make_unique<CompositeCapture>();
+        std::string error;
+        if (!shareContext || !composite_->create(shareContext, QSize(recordingWidth_, recordingHeight_), &error)) {
+            lastRecordingError_ = shareContext ? error : "Current view has no OpenGL context";
+            composite_.reset();
+            recordingWidth_ = 0;
+            recordingHeight_ = 0;
+            return false;
+        }
     }
+
+    recordingOptions_ = options;
     recordedElapsedMs_ = 0;
     lastRecordingError_.clear();
     recordingQueueWarningShown_ = false;
 
+    // Frames travel as RGBA8888, the readback format, in buffers preallocated for the whole recording.
+    const size_t frameBytes = static_cast<size_t>(recordingWidth_) * recordingHeight_ * 4;
+    const int frameCapacity =
+        static_cast<int>(std::max<size_t>(4, std::min<size_t>(60, kRecordingPoolBytes / frameBytes)));
+    recordingPool_ = FramePool::create(recordingWidth_, recordingHeight_, QImage::Format_RGBA8888, frameCapacity);
+    if (options.offline) {
+        recordingPool_->setAcquireTimeout(kOfflineEncoderWaitMs);
+    }
+    recordingStats_ = RecordingStats();
+    recordingStats_.frame_capacity = frameCapacity;
+
     // Create and start the recording thread.
     recordingThread_ = std::make_unique<RecordingThread>();
-    connect(recordingThread_.get(), &RecordingThread::queueAlmostFull,
-            this, &OctoFlexViewContainer::onRecordingQueueAlmostFull);
+    recordingThread_->setMaxQueueSize(frameCapacity);
+    // Offline recordings keep the queue full on purpose.
+    if (!options.offline) {
+        connect(recordingThread_.get(), &RecordingThread::queueAlmostFull,
+                this, &OctoFlexViewContainer::onRecordingQueueAlmostFull);
+    }
 
     VideoRecorderOptions recorderOptions;
     recorderOptions.outputPath = options.output_path;
@@ -161,32 +257,37 @@ bool OctoFlexViewContainer::startRecording(const RecordingOptions& options) {
     recorderOptions.preset = options.preset;
     recorderOptions.crf = options.crf;
     recorderOptions.overwrite = options.overwrite;
+    recorderOptions.enableAlpha = options.enable_alpha;
+    recorderOptions.inputFormat = QImage::Format_RGBA8888;
+    recorderOptions.encoder = options.encoder;
 
     std::string error;
     if (!recordingThread_->startRecording(recorderOptions, &error)) {
         lastRecordingError_ = error;
         recordingThread_.reset();
+        recordingPool_.reset();
+        composite_.reset();
         return false;
     }
 
-    // Queue the first frame.
-    if (!recordingThread_->queueFrame(frame)) {
-        lastRecordingError_ = "Failed to queue first frame";
-        recordingThread_->stopRecording(&error);
-        recordingThread_.reset();
-        return false;
+    isRecording_ = true;
+    isRecordingPaused_ = false;
+    recordingSegmentTimer_.start();
+
+    // Offline frames are recorded by recordOfflineFrame() only.
+    if (options.offline) {
+        return true;
     }
 
     const int intervalMs = std::max(1, 1000 / options.fps);
     recordingTimer_->start(intervalMs);
     recordingStatusTimer_->start();
-
-    isRecording_ = true;
-    isRecordingPaused_ = false;
-    recordingSegmentTimer_.start();
     updateRecordingStatusLabel();
     recordingStatusLabel_->show();
 
+    // The first frame is captured as soon as the recorded views presented it.
+    requestRecordingFrame();
+
     return true;
 }
 
@@ -209,7 +310,9 @@ bool OctoFlexViewContainer::resumeRecording() {
 
     isRecordingPaused_ = false;
     recordingSegmentTimer_.restart();
-    recordingTimer_->start(recordingTimer_->interval());
+    if (!recordingOptions_.offline) {
+        recordingTimer_->start(recordingTimer_->interval());
+    }
     updateRecordingStatusLabel();
     return true;
 }
@@ -229,6 +332,9 @@ bool OctoFlexViewContainer::stopRecording() {
     if (recordingStatusTimer_) {
         recordingStatusTimer_->stop();
     }
+    finishRecordingCaptures();
+    pendingRecordingViews_.clear();
+    recordingFramePending_ = false;
 
     bool ok = true;
     if (recordingThread_) {
@@ -237,8 +343,13 @@ bool OctoFlexViewContainer::stopRecording() {
         if (!ok && lastRecordingError_.empty()) {
             lastRecordingError_ = error;
         }
+        recordingStats_ = getRecordingStats();  // Kept for reading after the recording
         recordingThread_.reset();
     }
+    if (recordingPool_) {
+        recordingStats_.frames_dropped = recordingPool_->dropped();
+        recordingPool_.reset();
+    }
 
     isRecording_ = false;
     isRecordingPaused_ = false;
@@ -260,6 +371,19 @@ bool OctoFlexViewContainer::isRecordingPaused() const { return isRecordingPaused
 
 std::string OctoFlexViewContainer::getLastRecordingError() const { return lastRecordingError_; }
 
+RecordingStats OctoFlexViewContainer::getRecordingStats() const {
+    RecordingStats stats = recordingStats_;
+    if (recordingThread_) {
+        stats.frames_written = recordingThread_->framesWritten();
+        stats.encoder_stalls = recordingThread_->encoderStalls();
+        stats.encoder = recordingThread_->encoderName();
+    }
+    if (recordingPool_) {
+        stats.frames_dropped = recordingPool_->dropped();
+    }
+    return stats;
+}
+
 OctoFlexView* OctoFlexViewContainer::createInitialView() {
     // If views already exist, skip creation.
     if (!views_.empty()) {
@@ -441,6 +565,15 @@ OctoFlexView* OctoFlexViewContainer::createView() {
         view->setObjectManager(objectManager_);
     }
 
+    view->setRefreshMode(refreshMode_);
+    view->setFrameTimingOverlay(frameTimingOverlay_);
+    view->setMemoryOverlay(memoryOverlay_);
+    view->setCpuPicking(cpuPicking_);
+    view->setLodHysteresis(lodHysteresis_);
+
+    // Upload the scene once and draw it from every view.
+    view->setSceneResources(sceneResources_);
+
     // Initialize view and extend its context menu.
     view->initialize();
     extendViewContextMenu(view);
@@ -454,6 +587,9 @@ OctoFlexView* OctoFlexViewContainer::createView() {
     connect(view, &OctoFlexView::requestExpand, this, &OctoFlexViewContainer::expandCurrentView);
     connect(view, &OctoFlexView::requestCollapse, this, &OctoFlexViewContainer::collapseCurrentView);
 
+    // Recording frames are captured once the views presented them.
+    connect(view, &QOpenGLWidget::frameSwapped, this, [this, view]() { onViewFrameSwapped(view); });
+
     // Add to view list.
     views_.push_back(view);
 
@@ -576,6 +712,8 @@ void OctoFlexViewContainer::removeView(OctoFlexView* view) {
 
     // Remove from view list.
     views_.erase(it);
+    pendingRecordingViews_.erase(view);
+    view->setCompositeCapture(nullptr, QRect());
 
     // Find the view's splitter.
     QSplitter* parentSplitter = findParentSplitter(view);
@@ -765,32 +903,172 @@ void OctoFlexViewContainer::cleanupEmptySplitters(QWidget* widget) {
     }
 }
 
+void OctoFlexViewContainer::requestRecordingFrame() {
+    if (!isRecording_ || isRecordingPaused_ || !currentView_) {
+        return;
+    }
+
+    // A view that did not present the last frame in time (hidden, say) does not hold up recording.
+    if (recordingFramePending_) {
+        captureRecordingFrame();
+        if (!isRecording_) {
+            return;
+        }
+    }
+
+    pendingRecordingViews_.clear();
+    if (composite_) {
+        updateCompositeTargets();
+        for (auto* view : views_) {
+            if (view->isVisible()) {
+                pendingRecordingViews_.insert(view);
+            }
+        }
+    } else {
+        pendingRecordingViews_.insert(currentView_);
+    }
+    recordingFramePending_ = true;
+    for (auto* view : pendingRecordingViews_) {
+        view->update();
+    }
+}
+
+bool OctoFlexViewContainer::recordOfflineFrame() {
+    if (!isRecording_ || !recordingOptions_.offline) {
+        lastRecordingError_ = "No offline recording is running";
+        return false;
+    }
+    if (isRecordingPaused_) {
+        return true;
+    }
+    if (!currentView_ || !currentView_->renderFrame()) {
+        lastRecordingError_ = "Failed to render offline frame";
+        stopRecording();
+        return false;
+    }
+
+    captureRecordingFrame();
+    return isRecording_;
+}
+
+void OctoFlexViewContainer::onViewFrameSwapped(OctoFlexView* view) {
+    if (!recordingFramePending_ || pendingRecordingViews_.erase(view) == 0) {
+        return;
+    }
+    if (pendingRecordingViews_.empty()) {
+        captureRecordingFrame();
+    }
+}
+
 void OctoFlexViewContainer::captureRecordingFrame() {
+    recordingFramePending_ = false;
+    pendingRecordingViews_.clear();
     if (!isRecording_ || !currentView_) {
         return;
     }
 
-    // Capture frame directly from OpenGL framebuffer of the current view
-    QImage frame = currentView_->captureFrame();
+    // The composite holds what every view drew since the last capture; areas no view covers stay black.
+    if (composite_) {
+        std::vector<QImage> frames;
+        composite_->capture(recordingPool_, frames);
+        for (QImage& frame : frames) {
+            if (!queueRecordingFrame(std::move(frame))) {
+                return;
+            }
+        }
+        return;
+    }
+
+    // Frames read back by a previously active view come first.
+    if (captureView_ != currentView_) {
+        finishRecordingCaptures();
+        captureView_ = currentView_;
+    }
+
+    // Start reading back the current view; earlier captures arrive as their readback completes.
+    for (QImage& frame : currentView_->captureFrameAsync(recordingPool_)) {
+        if (!queueRecordingFrame(std::move(frame))) {
+            return;
+        }
+    }
+}
+
+void OctoFlexViewContainer::updateCompositeTargets() {
+    if (!composite_ || width() <= 0 || height() <= 0) {
+        return;
+    }
+
+    // View geometry in container pixels, scaled to the composite and flipped to OpenGL rows.
+    const double sx = static_cast<double>(recordingWidth_) / width();
+    const double sy = static_cast<double>(recordingHeight_) / height();
+    for (auto* view : views_) {
+        if (!view->isVisible()) {
+            view->setCompositeCapture(nullptr, QRect());
+            continue;
+        }
+        const QRect geometry(view->mapTo(this, QPoint(0, 0)), view->size());
+        const int x0 = qRound(geometry.x() * sx);
+        const int x1 = qRound((geometry.x() + geometry.width()) * sx);
+        const int y0 = recordingHeight_ - qRound((geometry.y() + geometry.height()) * sy);
+        const int y1 = recordingHeight_ - qRound(geometry.y() * sy);
+        view->setCompositeCapture(composite_.get(), QRect(x0, y0, x1 - x0, y1 - y0));
+    }
+}
+
+void OctoFlexViewContainer::finishRecordingCaptures() {
+    if (composite_) {
+        std::vector<QImage> frames;
+        composite_->finish(frames);
+        for (auto* view : views_) {
+            view->setCompositeCapture(nullptr, QRect());
+        }
+        composite_.reset();
+        for (QImage& frame : frames) {
+            if (!queueRecordingFrame(std::move(frame))) {
+                return;
+            }
+        }
+    }
+
+    if (!captureView_) {
+        return;
+    }
+    std::vector<QImage> frames = captureView_->finishFrameCaptures();
+    captureView_ = nullptr;
+    for (QImage& frame : frames) {
+        if (!queueRecordingFrame(std::move(frame))) {
+            return;
+        }
+    }
+}
+
+bool OctoFlexViewContainer::queueRecordingFrame(QImage frame) {
+    if (!recordingThread_) {
+        return false;
+    }
+
     if (frame.isNull()) {
         lastRecordingError_ = "Failed to capture OpenGL framebuffer";
+        captureView_ = nullptr;  // Frames still in flight are dropped with the recording
         stopRecording();
-        return;
+        return false;
     }
 
-    // Convert to RGB888 format for video recording
-    frame = frame.convertToFormat(QImage::Format_RGB888);
-
-    // Resize frame if needed
+    // Pooled frames already have the recording size and format; synchronous captures are fitted here.
     if (frame.width() != recordingWidth_ || frame.height() != recordingHeight_) {
         frame = frame.scaled(recordingWidth_, recordingHeight_, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
     }
+    if (frame.format() != QImage::Format_RGBA8888) {
+        frame = frame.convertToFormat(QImage::Format_RGBA8888);
+    }
 
-    // Queue frame for async recording (non-blocking)
-    if (recordingThread_ && !recordingThread_->queueFrame(frame)) {
-        lastRecordingError_ = "Failed to queue frame - recording queue is full";
-        stopRecording();
+    // Queue frame for async recording (non-blocking); a full queue drops the frame. Offline recordings
+    // wait for the encoder instead.
+    const int waitMs = recordingOptions_.offline ? kOfflineEncoderWaitMs : 0;
+    if (!recordingThread_->queueFrame(std::move(frame), waitMs) && recordingPool_) {
+        recordingPool_->countDrop();
     }
+    return true;
 }
 
 void OctoFlexViewContainer::updateRecordingStatusLabel() {
@@ -23,11 +23,13 @@
 #include <QElapsedTimer>
 #include <QLabel>
 #include <QMenu>
+#include <QPointer>
 #include <QSplitter>
 #include <QTimer>
 #include <QWidget>
 #include <map>
 #include <memory>
+#include <set>
 #include <vector>
 #include "recording_options.h"
 #include "octo_flex_view.h"
@@ -55,6 +57,22 @@ class OctoFlexViewContainer : public QWidget {
     // Set the object manager (applies to all views).
     void setObjectManager(ObjectManager::Ptr obj_mgr);
 
+    // Set the refresh mode (applies to all views, including ones created later).
+    void setRefreshMode(RefreshMode mode);
+
+    // List per-pass frame timing in the info panels (applies to all views, including ones created later).
+    void setFrameTimingOverlay(bool enabled);
+
+    // List per-layer memory in the info panels (applies to all views, including ones created later).
+    void setMemoryOverlay(bool enabled);
+
+    // Pick with the layers' bounding volume hierarchies instead of a GPU pick pass (applies to all views,
+    // including ones created later).
+    void setCpuPicking(bool enabled);
+
+    // Hysteresis of the level of detail switches (applies to all views, including ones created later).
+    void setLodHysteresis(float fraction);
+
     // Create the initial view.
     OctoFlexView* createInitialView();
 
@@ -66,6 +84,9 @@ class OctoFlexViewContainer : public QWidget {
     bool isRecording() const;
     bool isRecordingPaused() const;
     std::string getLastRecordingError() const;
+    RecordingStats getRecordingStats() const;
+    // Render the current view once and record the frame; for offline recordings of hidden containers.
+    bool recordOfflineFrame();
 
    public slots:
     // Split the current view vertically (top/bottom).
@@ -116,9 +137,24 @@ class OctoFlexViewContainer : public QWidget {
     // Update the "only view" state.
     void updateViewsOnlyStatus();
 
+    // Repaint the recorded views for the next recording frame; captured once they all swapped.
+    void requestRecordingFrame();
+
+    // Capture the recording frame once the last pending view presented it.
+    void onViewFrameSwapped(OctoFlexView* view);
+
     // Capture one container frame for recording.
     void captureRecordingFrame();
 
+    // Place every view in the layout composite, scaled to the recording size.
+    void updateCompositeTargets();
+
+    // Hand the frames still being read back by the capturing view to the recorder.
+    void finishRecordingCaptures();
+
+    // Convert, scale and queue one captured frame; stops recording on failure.
+    bool queueRecordingFrame(QImage frame);
+
     // Update overlay text for recording status.
     void updateRecordingStatusLabel();
 
@@ -134,6 +170,14 @@ class OctoFlexViewContainer : public QWidget {
     OctoFlexView* expandedView_;        // Currently expanded view.
     ObjectManager::Ptr objectManager_;  // Object manager.
     std::vector<OctoFlexView*> views_;  // List of all views.
+    RefreshMode refreshMode_ = RefreshMode::ON_DEMAND;
+    bool frameTimingOverlay_ = false;
+    bool memoryOverlay_ = false;
+    bool cpuPicking_ = true;
+    float lodHysteresis_ = 0.0f;
+
+    // GPU resources shared by all views.
+    SceneResources::Ptr sceneResources_ = std::make_shared<SceneResources>();
 
     // Saved splitter sizes before expand.
     std::map<QSplitter*, QList<int>> savedSplitterSizes_;
@@ -155,6 +199,12 @@ class OctoFlexViewContainer : public QWidget {
     int recordingHeight_ = 0;
     std::string lastRecordingError_;
     bool recordingQueueWarningShown_ = false;
+    QPointer<OctoFlexView> captureView_;             // View whose frames are being read back
+    FramePool::Ptr recordingPool_;                   // Frame buffers between capture and encoder
+    RecordingStats recordingStats_;                  // Counters of the last recording, once it stopped
+    std::unique_ptr<CompositeCapture> composite_;    // Layout frame when recording all views
+    std::set<OctoFlexView*> pendingRecordingViews_;  // Views yet to present the requested frame
+    bool recordingFramePending_ = false;             // A requested frame waits for its capture
 };
 
 }  // namespace octo_flex
@@ -19,6 +19,7 @@
 #include <QApplication>
 #include <QCoreApplication>
 #include <QMainWindow>
+#include <QSurfaceFormat>
 #include <QVBoxLayout>
 #include <iostream>
 #include <vector>
@@ -28,10 +29,50 @@
 #include "object_manager.h"
 #include "octo_flex_view.h"
 #include "octo_flex_view_container.h"
+#include "render_backend.h"
+#include "scene_snapshot.h"
+#include "texture_cache.h"
+#include "texture_manager.h"
 #include "utils.h"
 
 namespace octo_flex {
 
+namespace {
+
+// Scene queries shared by both viewers.
+std::vector<std::string> queryBoxIn(const ObjectManager::Ptr& manager, const BoundingBox& box) {
+    std::vector<std::string> ids;
+    if (!manager || !box.valid) return ids;
+    for (const auto& [layer_id, obj] : manager->queryRegion(Frustum(box))) {
+        ids.push_back(obj->id());
+    }
+    return ids;
+}
+
+bool raycastIn(const ObjectManager::Ptr& manager, const Vec3& origin, const Vec3& direction, RaycastHit* hit,
+               double radius) {
+    const double length = direction.length();
+    if (!manager || length <= 0.0) return false;
+    const Vec3 unit = direction / length;
+    PickRay ray;
+    ray.origin = glm::vec3(origin.x, origin.y, origin.z);
+    ray.direction = glm::vec3(unit.x, unit.y, unit.z);
+    ray.radius = static_cast<float>(radius);
+    PickHit found;
+    std::string layer_id;
+    if (!manager->raycast(ray, found, &layer_id)) return false;
+    if (hit) {
+        hit->object_id = found.object->id();
+        hit->layer_id = layer_id;
+        hit->distance = found.distance;
+        hit->point = Vec3(found.point.x, found.point.y, found.point.z);
+        hit->instance = found.instance;
+    }
+    return true;
+}
+
+}  // namespace
+
 // ============================================================================
 // EmbeddedViewer::Impl - Private implementation for embedded mode
 // ============================================================================
@@ -84,6 +125,166 @@ EmbeddedViewer& EmbeddedViewer::setLayer(const std::vector<std::shared_ptr<Objec
     return *this;
 }
 
+EmbeddedViewer& EmbeddedViewer::submitLayerDelta(const std::vector<std::shared_ptr<Object>>& upserts,
+                                                 const std::vector<std::string>& removed_ids,
+                                                 const std::string& layer_id) {
+    if (!impl_->obj_manager) {
+        std::cerr << "Error: Object manager not initialized" << std::endl;
+        return *this;
+    }
+
+    impl_->obj_manager->submitLayerDelta(upserts, removed_ids, layer_id);
+    return *this;
+}
+
+EmbeddedViewer& EmbeddedViewer::addBatch(size_t count, const std::function<std::shared_ptr<Object>(size_t)>& build,
+                                         const std::string& layer_id) {
+    if (!impl_->obj_manager) {
+        std::cerr << "Error: Object manager not initialized" << std::endl;
+        return *this;
+    }
+
+    impl_->obj_manager->submitBatch(count, build, layer_id);
+    return *this;
+}
+
+EmbeddedViewer& EmbeddedViewer::updatePose(const std::string& id, const Vec3& position, const Quaternion& orientation) {
+    if (!impl_->obj_manager) {
+        std::cerr << "Error: Object manager not initialized" << std::endl;
+        return *this;
+    }
+
+    if (!impl_->obj_manager->updatePose(id, position, orientation)) {
+        std::cerr << "Warning: Object '" << id << "' not found for pose update" << std::endl;
+    }
+    return *this;
+}
+
+EmbeddedViewer& EmbeddedViewer::updateScalars(const std::string& id, const float* values, size_t count) {
+    if (!impl_->obj_manager) {
+        std::cerr << "Error: Object manager not initialized" << std::endl;
+        return *this;
+    }
+
+    if (!impl_->obj_manager->updateScalars(id, values, count)) {
+        std::cerr << "Warning: Object '" << id << "' not found or without matching scalars for scalar update"
+                  << std::endl;
+    }
+    return *this;
+}
+
+EmbeddedViewer& EmbeddedViewer::setScalarMapping(const std::string& id, Colormap colormap, double min, double max) {
+    if (!impl_->obj_manager) {
+        std::cerr << "Error: Object manager not initialized" << std::endl;
+        return *this;
+    }
+
+    if (!impl_->obj_manager->setScalarMapping(id, colormap, min, max)) {
+        std::cerr << "Warning: Object '" << id << "' not found or without scalars for scalar mapping" << std::endl;
+    }
+    return *this;
+}
+
+bool EmbeddedViewer::enqueue(std::shared_ptr<Object> object, const std::string& layer_id) {
+    if (!impl_->obj_manager) {
+        std::cerr << "Error: Object manager not initialized" << std::endl;
+        return false;
+    }
+    return impl_->obj_manager->enqueueSubmit(object, layer_id);
+}
+
+bool EmbeddedViewer::enqueueRemove(const std::string& id, const std::string& layer_id) {
+    if (!impl_->obj_manager) {
+        std::cerr << "Error: Object manager not initialized" << std::endl;
+        return false;
+    }
+    return impl_->obj_manager->enqueueRemove(id, layer_id);
+}
+
+bool EmbeddedViewer::enqueueLayer(const std::vector<std::shared_ptr<Object>>& objects, const std::string& layer_id) {
+    if (!impl_->obj_manager) {
+        std::cerr << "Error: Object manager not initialized" << std::endl;
+        return false;
+    }
+    return impl_->obj_manager->enqueueLayer(objects, layer_id);
+}
+
+bool EmbeddedViewer::enqueuePose(const std::string& id, const Vec3& position, const Quaternion& orientation) {
+    if (!impl_->obj_manager) {
+        std::cerr << "Error: Object manager not initialized" << std::endl;
+        return false;
+    }
+    return impl_->obj_manager->enqueuePose(id, position, orientation);
+}
+
+UpdateQueueStats EmbeddedViewer::updateQueueStats() const {
+    if (!impl_->obj_manager) return UpdateQueueStats();
+    return impl_->obj_manager->updateQueueStats();
+}
+
+TextureUploadStats EmbeddedViewer::textureUploadStats() const {
+    TextureUploadStats stats = TextureManager::instance()->stats();
+    TextureCache::instance()->fillStats(&stats);
+    return stats;
+}
+
+void EmbeddedViewer::setTextureUploadBudget(size_t bytes) { TextureManager::instance()->setFrameBudget(bytes); }
+
+void EmbeddedViewer::setTextureMemoryBudget(size_t bytes) { TextureCache::instance()->setMemoryBudget(bytes); }
+
+bool EmbeddedViewer::saveScene(const std::string& path, std::string* error) const {
+    std::string message = "Object manager not initialized";
+    if (impl_->obj_manager && saveSceneSnapshot(*impl_->obj_manager, path, &message)) return true;
+    std::cerr << "Error: " << message << std::endl;
+    if (error) *error = message;
+    return false;
+}
+
+bool EmbeddedViewer::loadScene(const std::string& path, std::string* error) {
+    std::string message = "Object manager not initialized";
+    if (impl_->obj_manager && loadSceneSnapshot(*impl_->obj_manager, path, &message)) return true;
+    std::cerr << "Error: " << message << std::endl;
+    if (error) *error = message;
+    return false;
+}
+
+bool EmbeddedViewer::startSubmissionLog(const SubmissionLogOptions& options, std::string* error) {
+    std::string message = "Object manager not initialized";
+    if (impl_->obj_manager && impl_->obj_manager->startSubmissionLog(options, &message)) return true;
+    std::cerr << "Error: " << message << std::endl;
+    if (error) *error = message;
+    return false;
+}
+
+bool EmbeddedViewer::stopSubmissionLog() {
+    std::string message;
+    if (!impl_->obj_manager || impl_->obj_manager->stopSubmissionLog(&message)) return true;
+    std::cerr << "Error: " << message << std::endl;
+    return false;
+}
+
+SubmissionLogStats EmbeddedViewer::submissionLogStats() const {
+    if (!impl_->obj_manager) return SubmissionLogStats();
+    return impl_->obj_manager->submissionLogStats();
+}
+
+bool EmbeddedViewer::openSharedScene(const std::string& name, const SharedSceneOptions& options, std::string* error) {
+    std::string message = "Object manager not initialized";
+    if (impl_->obj_manager && impl_->obj_manager->openSharedChannel(name, options, &message)) return true;
+    std::cerr << "Error: " << message << std::endl;
+    if (error) *error = message;
+    return false;
+}
+
+void EmbeddedViewer::closeSharedScene(const std::string& name) {
+    if (impl_->obj_manager) impl_->obj_manager->closeSharedChannel(name);
+}
+
+SharedSceneStats EmbeddedViewer::sharedSceneStats(const std::string& name) const {
+    if (!impl_->obj_manager) return SharedSceneStats();
+    return impl_->obj_manager->sharedChannelStats(name);
+}
+
 EmbeddedViewer& EmbeddedViewer::addSphere(const std::string& id, const Vec3& color, double radius,
                                           const Vec3& position) {
     auto sphere = generateSphere(id, color, radius, true);
@@ -127,6 +328,58 @@ std::vector<std::string> EmbeddedViewer::exportSelectedObjectIds() const {
     return std::vector<std::string>(selectedIds.begin(), selectedIds.end());
 }
 
+void EmbeddedViewer::setContinuousRefresh(bool enabled) {
+    if (impl_->container) {
+        impl_->container->setRefreshMode(enabled ? RefreshMode::CONTINUOUS : RefreshMode::ON_DEMAND);
+    }
+}
+
+FrameTimingStats EmbeddedViewer::frameTimingStats() const {
+    if (!impl_->container) return FrameTimingStats();
+    OctoFlexView* currentView = impl_->container->getCurrentView();
+    if (!currentView) return FrameTimingStats();
+    return currentView->frameTimingStats();
+}
+
+void EmbeddedViewer::setFrameTimingOverlay(bool enabled) {
+    if (impl_->container) {
+        impl_->container->setFrameTimingOverlay(enabled);
+    }
+}
+
+SceneMemoryStats EmbeddedViewer::memoryStats() const {
+    OctoFlexView* currentView = impl_->container ? impl_->container->getCurrentView() : nullptr;
+    if (currentView) return currentView->memoryStats();
+    if (!impl_->obj_manager) return SceneMemoryStats();
+    return impl_->obj_manager->memoryStats();
+}
+
+void EmbeddedViewer::setMemoryOverlay(bool enabled) {
+    if (impl_->container) {
+        impl_->container->setMemoryOverlay(enabled);
+    }
+}
+
+std::vector<std::string> EmbeddedViewer::queryBox(const BoundingBox& box) const {
+    return queryBoxIn(impl_->obj_manager, box);
+}
+
+bool EmbeddedViewer::raycast(const Vec3& origin, const Vec3& direction, RaycastHit* hit, double radius) const {
+    return raycastIn(impl_->obj_manager, origin, direction, hit, radius);
+}
+
+void EmbeddedViewer::setCpuPicking(bool enabled) {
+    if (impl_->container) {
+        impl_->container->setCpuPicking(enabled);
+    }
+}
+
+void EmbeddedViewer::setLodHysteresis(double fraction) {
+    if (impl_->container) {
+        impl_->container->setLodHysteresis(static_cast<float>(fraction));
+    }
+}
+
 bool EmbeddedViewer::startRecording(const RecordingOptions& options) {
     if (!impl_->container) {
         return false;
@@ -168,6 +421,13 @@ std::string EmbeddedViewer::getLastRecordingError() const {
     return impl_->container->getLastRecordingError();
 }
 
+RecordingStats EmbeddedViewer::getRecordingStats() const {
+    if (!impl_->container) {
+        return RecordingStats();
+    }
+    return impl_->container->getRecordingStats();
+}
+
 // ============================================================================
 // OctoFlexViewer::Impl - Private implementation
 // ============================================================================
@@ -269,6 +529,10 @@ OctoFlexViewer OctoFlexViewer::create(const std::string& title, int width, int h
 
     // Step 1: Create or reuse QApplication
     if (!qApp) {
+        // All GL contexts share one group, so views keep their GPU resources when re-parented by splits.
+        QCoreApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
+        QSurfaceFormat::setDefaultFormat(RenderBackend::surfaceFormat(RenderBackend::defaultType()));
+
         // No existing QApplication, create one
         if (argc && argv) {
             viewer.impl_->app = std::make_unique<QApplication>(*argc, *argv);
@@ -303,6 +567,14 @@ OctoFlexViewer OctoFlexViewer::create(const std::string& title, int width, int h
     return viewer;
 }
 
+void OctoFlexViewer::setRenderBackend(RenderBackendType type) { RenderBackend::setDefaultType(type); }
+
+RenderBackendType OctoFlexViewer::renderBackend() { return RenderBackend::defaultType(); }
+
+void OctoFlexViewer::setThreadedRendering(bool enabled) { OctoFlexView::setDefaultThreadedRendering(enabled); }
+
+bool OctoFlexViewer::threadedRendering() { return OctoFlexView::defaultThreadedRendering(); }
+
 int OctoFlexViewer::run(SetupCallback setup) {
     if (!impl_->window) {
         std::cerr << "Error: OctoFlexViewer not properly initialized" << std::endl;
@@ -355,6 +627,166 @@ OctoFlexViewer& OctoFlexViewer::setLayer(const std::vector<std::shared_ptr<Objec
     return *this;
 }
 
+OctoFlexViewer& OctoFlexViewer::submitLayerDelta(const std::vector<std::shared_ptr<Object>>& upserts,
+                                                 const std::vector<std::string>& removed_ids,
+                                                 const std::string& layer_id) {
+    if (!impl_->obj_manager) {
+        std::cerr << "Error: Object manager not initialized" << std::endl;
+        return *this;
+    }
+
+    impl_->obj_manager->submitLayerDelta(upserts, removed_ids, layer_id);
+    return *this;
+}
+
+OctoFlexViewer& OctoFlexViewer::addBatch(size_t count, const std::function<std::shared_ptr<Object>(size_t)>& build,
+                                         const std::string& layer_id) {
+    if (!impl_->obj_manager) {
+        std::cerr << "Error: Object manager not initialized" << std::endl;
+        return *this;
+    }
+
+    impl_->obj_manager->submitBatch(count, build, layer_id);
+    return *this;
+}
+
+OctoFlexViewer& OctoFlexViewer::updatePose(const std::string& id, const Vec3& position, const Quaternion& orientation) {
+    if (!impl_->obj_manager) {
+        std::cerr << "Error: Object manager not initialized" << std::endl;
+        return *this;
+    }
+
+    if (!impl_->obj_manager->updatePose(id, position, orientation)) {
+        std::cerr << "Warning: Object '" << id << "' not found for pose update" << std::endl;
+    }
+    return *this;
+}
+
+OctoFlexViewer& OctoFlexViewer::updateScalars(const std::string& id, const float* values, size_t count) {
+    if (!impl_->obj_manager) {
+        std::cerr << "Error: Object manager not initialized" << std::endl;
+        return *this;
+    }
+
+    if (!impl_->obj_manager->updateScalars(id, values, count)) {
+        std::cerr << "Warning: Object '" << id << "' not found or without matching scalars for scalar update"
+                  << std::endl;
+    }
+    return *this;
+}
+
+OctoFlexViewer& OctoFlexViewer::setScalarMapping(const std::string& id, Colormap colormap, double min, double max) {
+    if (!impl_->obj_manager) {
+        std::cerr << "Error: Object manager not initialized" << std::endl;
+        return *this;
+    }
+
+    if (!impl_->obj_manager->setScalarMapping(id, colormap, min, max)) {
+        std::cerr << "Warning: Object '" << id << "' not found or without scalars for scalar mapping" << std::endl;
+    }
+    return *this;
+}
+
+bool OctoFlexViewer::enqueue(std::shared_ptr<Object> object, const std::string& layer_id) {
+    if (!impl_->obj_manager) {
+        std::cerr << "Error: Object manager not initialized" << std::endl;
+        return false;
+    }
+    return impl_->obj_manager->enqueueSubmit(object, layer_id);
+}
+
+bool OctoFlexViewer::enqueueRemove(const std::string& id, const std::string& layer_id) {
+    if (!impl_->obj_manager) {
+        std::cerr << "Error: Object manager not initialized" << std::endl;
+        return false;
+    }
+    return impl_->obj_manager->enqueueRemove(id, layer_id);
+}
+
+bool OctoFlexViewer::enqueueLayer(const std::vector<std::shared_ptr<Object>>& objects, const std::string& layer_id) {
+    if (!impl_->obj_manager) {
+        std::cerr << "Error: Object manager not initialized" << std::endl;
+        return false;
+    }
+    return impl_->obj_manager->enqueueLayer(objects, layer_id);
+}
+
+bool OctoFlexViewer::enqueuePose(const std::string& id, const Vec3& position, const Quaternion& orientation) {
+    if (!impl_->obj_manager) {
+        std::cerr << "Error: Object manager not initialized" << std::endl;
+        return false;
+    }
+    return impl_->obj_manager->enqueuePose(id, position, orientation);
+}
+
+UpdateQueueStats OctoFlexViewer::updateQueueStats() const {
+    if (!impl_->obj_manager) return UpdateQueueStats();
+    return impl_->obj_manager->updateQueueStats();
+}
+
+TextureUploadStats OctoFlexViewer::textureUploadStats() const {
+    TextureUploadStats stats = TextureManager::instance()->stats();
+    TextureCache::instance()->fillStats(&stats);
+    return stats;
+}
+
+void OctoFlexViewer::setTextureUploadBudget(size_t bytes) { TextureManager::instance()->setFrameBudget(bytes); }
+
+void OctoFlexViewer::setTextureMemoryBudget(size_t bytes) { TextureCache::instance()->setMemoryBudget(bytes); }
+
+bool OctoFlexViewer::saveScene(const std::string& path, std::string* error) const {
+    std::string message = "Object manager not initialized";
+    if (impl_->obj_manager && saveSceneSnapshot(*impl_->obj_manager, path, &message)) return true;
+    std::cerr << "Error: " << message << std::endl;
+    if (error) *error = message;
+    return false;
+}
+
+bool OctoFlexViewer::loadScene(const std::string& path, std::string* error) {
+    std::string message = "Object manager not initialized";
+    if (impl_->obj_manager && loadSceneSnapshot(*impl_->obj_manager, path, &message)) return true;
+    std::cerr << "Error: " << message << std::endl;
+    if (error) *error = message;
+    return false;
+}
+
+bool OctoFlexViewer::startSubmissionLog(const SubmissionLogOptions& options, std::string* error) {
+    std::string message = "Object manager not initialized";
+    if (impl_->obj_manager && impl_->obj_manager->startSubmissionLog(options, &message)) return true;
+    std::cerr << "Error: " << message << std::endl;
+    if (error) *error = message;
+    return false;
+}
+
+bool OctoFlexViewer::stopSubmissionLog() {
+    std::string message;
+    if (!impl_->obj_manager || impl_->obj_manager->stopSubmissionLog(&message)) return true;
+    std::cerr << "Error: " << message << std::endl;
+    return false;
+}
+
+SubmissionLogStats OctoFlexViewer::submissionLogStats() const {
+    if (!impl_->obj_manager) return SubmissionLogStats();
+    return impl_->obj_manager->submissionLogStats();
+}
+
+bool OctoFlexViewer::openSharedScene(const std::string& name, const SharedSceneOptions& options, std::string* error) {
+    std::string message = "Object manager not initialized";
+    if (impl_->obj_manager && impl_->obj_manager->openSharedChannel(name, options, &message)) return true;
+    std::cerr << "Error: " << message << std::endl;
+    if (error) *error = message;
+    return false;
+}
+
+void OctoFlexViewer::closeSharedScene(const std::string& name) {
+    if (impl_->obj_manager) impl_->obj_manager->closeSharedChannel(name);
+}
+
+SharedSceneStats OctoFlexViewer::sharedSceneStats(const std::string& name) const {
+    if (!impl_->obj_manager) return SharedSceneStats();
+    return impl_->obj_manager->sharedChannelStats(name);
+}
+
 OctoFlexViewer& OctoFlexViewer::addSphere(const std::string& id, const Vec3& color, double radius,
                                           const Vec3& position) {
     auto sphere = generateSphere(id, color, radius, true);
@@ -419,6 +851,58 @@ std::vector<std::string> OctoFlexViewer::exportSelectedObjectIds() const {
     return std::vector<std::string>(selectedIds.begin(), selectedIds.end());
 }
 
+void OctoFlexViewer::setContinuousRefresh(bool enabled) {
+    if (impl_->container) {
+        impl_->container->setRefreshMode(enabled ? RefreshMode::CONTINUOUS : RefreshMode::ON_DEMAND);
+    }
+}
+
+FrameTimingStats OctoFlexViewer::frameTimingStats() const {
+    if (!impl_->container) return FrameTimingStats();
+    OctoFlexView* currentView = impl_->container->getCurrentView();
+    if (!currentView) return FrameTimingStats();
+    return currentView->frameTimingStats();
+}
+
+void OctoFlexViewer::setFrameTimingOverlay(bool enabled) {
+    if (impl_->container) {
+        impl_->container->setFrameTimingOverlay(enabled);
+    }
+}
+
+SceneMemoryStats OctoFlexViewer::memoryStats() const {
+    OctoFlexView* currentView = impl_->container ? impl_->container->getCurrentView() : nullptr;
+    if (currentView) return currentView->memoryStats();
+    if (!impl_->obj_manager) return SceneMemoryStats();
+    return impl_->obj_manager->memoryStats();
+}
+
+void OctoFlexViewer::setMemoryOverlay(bool enabled) {
+    if (impl_->container) {
+        impl_->container->setMemoryOverlay(enabled);
+    }
+}
+
+std::vector<std::string> OctoFlexViewer::queryBox(const BoundingBox& box) const {
+    return queryBoxIn(impl_->obj_manager, box);
+}
+
+bool OctoFlexViewer::raycast(const Vec3& origin, const Vec3& direction, RaycastHit* hit, double radius) const {
+    return raycastIn(impl_->obj_manager, origin, direction, hit, radius);
+}
+
+void OctoFlexViewer::setCpuPicking(bool enabled) {
+    if (impl_->container) {
+        impl_->container->setCpuPicking(enabled);
+    }
+}
+
+void OctoFlexViewer::setLodHysteresis(double fraction) {
+    if (impl_->container) {
+        impl_->container->setLodHysteresis(static_cast<float>(fraction));
+    }
+}
+
 bool OctoFlexViewer::startRecording(const RecordingOptions& options) {
     if (!impl_->container) {
         return false;
@@ -465,4 +949,11 @@ std::string OctoFlexViewer::getLastRecordingError() const {
     return impl_->container->getLastRecordingError();
 }
 
+RecordingStats OctoFlexViewer::getRecordingStats() const {
+    if (!impl_->container) {
+        return RecordingStats();
+    }
+    return impl_->container->getRecordingStats();
+}
+
 }  // namespace octo_flex
@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "pipe_encoder.h"
+
+#include <cstdlib>
+#include <sstream>
+
+namespace octo_flex {
+
+PipeEncoder::~PipeEncoder() {
+    std::string ignored;
+    stop(&ignored);
+}
+
+std::string PipeEncoder::name() const {
+    return "ffmpeg:" + (codec_.empty() ? VideoEncoder::codecName(kind_, options_.codec) : codec_);
+}
+
+std::string PipeEncoder::codecArguments(const VideoRecorderOptions& options) const {
+    std::ostringstream args;
+    args << " -c:v " << codec_;
+    switch (kind_) {
+        case EncoderKind::NVENC:
+            args << " -preset " << VideoEncoder::nvencPreset(options.preset) << " -rc vbr -cq " << options.crf
+                 << " -b:v 0 -pix_fmt yuv420p";
+            break;
+        case EncoderKind::VAAPI:
+            // Frames are uploaded to VA surfaces by the hwupload filter.
+            args << " -vf format=nv12,hwupload -qp " << options.crf;
+            break;
+        case EncoderKind::V4L2_M2M:
+            args << " -b:v " << VideoEncoder::constantBitrate(options) << " -pix_fmt yuv420p";
+            break;
+        case EncoderKind::SOFTWARE:
+        default:
+            args << " -preset " << options.preset << " -crf " << options.crf << " -pix_fmt "
+                 << (options.enableAlpha ? "yuva420p" : "yuv420p");
+            break;
+    }
+    return args.str();
+}
+
+bool PipeEncoder::start(const VideoRecorderOptions& options, std::string* error) {
+    options_ = options;
+    codec_ = VideoEncoder::codecName(kind_, options.codec);
+    const std::string device =
+        kind_ == EncoderKind::VAAPI ? std::string(" -vaapi_device ") + VideoEncoder::kVaapiDevice : "";
+
+    // Hardware: a one-frame test encode tells whether ffmpeg has the encoder and the device exists.
+    if (kind_ != EncoderKind::SOFTWARE) {
+        std::ostringstream probe;
+        probe << "ffmpeg -hide_banner -loglevel quiet" << device
+              << " -f lavfi -i color=c=black:s=256x256:r=" << options.fps << " -frames:v 1"
+              << codecArguments(options) << " -f null - > /dev/null 2>&1";
+        if (std::system(probe.str().c_str()) != 0) {
+            if (error) *error = "Encoder not available";
+            return false;
+        }
+    }
+
+    // Build ffmpeg command line
+    std::ostringstream cmd;
+    cmd << "ffmpeg"
+        << " -hide_banner -loglevel error"
+        << (options.overwrite ? " -y" : " -n")
+        << device
+        << " -f rawvideo"
+        << " -pix_fmt " << (options.inputFormat == QImage::Format_RGBA8888 ? "rgba" : "rgb24")
+        << " -s " << options.width << "x" << options.height
+        << " -r " << options.fps
+        << " -i -"
+        << " -an"
+        << codecArguments(options)
+        << " -movflags frag_keyframe+empty_moov"
+        << " " << options.outputPath;
+
+    pipe_ = popen(cmd.str().c_str(), "w");
+    if (!pipe_) {
+        if (error) *error = "Failed to start ffmpeg process via popen";
+        return false;
+    }
+    return true;
+}
+
+bool PipeEncoder::writeFrame(const QImage& frame, std::string* error) {
+    if (!pipe_) {
+        if (error) *error = "Encoder is not running";
+        return false;
+    }
+
+    const int rowBytes = options_.width * (options_.inputFormat == QImage::Format_RGBA8888 ? 4 : 3);
+
+    // Tightly packed rows go out in one write.
+    if (frame.bytesPerLine() == rowBytes) {
+        const size_t frameBytes = static_cast<size_t>(rowBytes) * options_.height;
+        if (fwrite(frame.constBits(), 1, frameBytes, pipe_) != frameBytes) {
+            if (error) *error = "Failed writing frame data to ffmpeg pipe";
+            return false;
+        }
+        return true;
+    }
+
+    for (int y = 0; y < options_.height; ++y) {
+        const unsigned char* src = frame.constScanLine(y);
+        size_t written = fwrite(src, 1, rowBytes, pipe_);
+        if (static_cast<int>(written) != rowBytes) {
+            if (error) *error = "Failed writing frame data to ffmpeg pipe";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PipeEncoder::stop(std::string* error) {
+    if (!pipe_) {
+        return true;
+    }
+
+    int status = pclose(pipe_);
+    pipe_ = nullptr;
+
+    if (status != 0) {
+        if (error) *error = "ffmpeg exited with status " + std::to_string(status);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace octo_flex
@@ -0,0 +1,52 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef PIPE_ENCODER_H
+#define PIPE_ENCODER_H
+
+#include <cstdio>
+#include <string>
+#include "video_encoder.h"
+#include "video_recorder.h"
+
+namespace octo_flex {
+
+// Encodes by piping raw frames into an ffmpeg process. Hardware kinds are probed with a one-frame
+// test encode first, since the process only fails once frames arrive.
+class PipeEncoder : public VideoEncoder {
+   public:
+    explicit PipeEncoder(EncoderKind kind) : kind_(kind) {}
+    ~PipeEncoder() override;
+
+    bool start(const VideoRecorderOptions& options, std::string* error) override;
+    bool writeFrame(const QImage& frame, std::string* error) override;
+    bool stop(std::string* error) override;
+    std::string name() const override;
+
+   private:
+    // "-c:v ..." and rate control arguments of the codec.
+    std::string codecArguments(const VideoRecorderOptions& options) const;
+
+    EncoderKind kind_;
+    std::string codec_;
+    FILE* pipe_ = nullptr;
+    VideoRecorderOptions options_;
+};
+
+}  // namespace octo_flex
+
+#endif /* PIPE_ENCODER_H */
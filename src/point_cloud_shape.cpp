@@ -0,0 +1,273 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "point_cloud_shape.h"
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <utility>
+
+namespace octo_flex {
+namespace {
+const int kMaxDepth = 20;  // Stops refinement of coincident points
+
+float coordinate(const PackedVertex& v, int axis) { return axis == 0 ? v.x : (axis == 1 ? v.y : v.z); }
+
+BoundingBox cubeBounds(const glm::vec3& min, float size) {
+    BoundingBox box;
+    box.expand(Vec3(min.x, min.y, min.z));
+    box.expand(Vec3(min.x + size, min.y + size, min.z + size));
+    return box;
+}
+
+// Builds one node over order[begin, end) and its children; returns the node index.
+int32_t buildNode(const std::vector<PackedVertex>& vertices, std::vector<uint32_t>& order,
+                  std::vector<PointCloudShape::Node>& nodes, uint32_t begin, uint32_t end, const glm::vec3& min,
+                  float size, int depth) {
+    const int32_t index = static_cast<int32_t>(nodes.size());
+    PointCloudShape::Node node;
+    node.bounds = cubeBounds(min, size);
+    node.first = begin;
+    node.count = end - begin;
+    node.subtreeCount = end - begin;
+    std::fill(std::begin(node.children), std::end(node.children), -1);
+    nodes.push_back(node);
+
+    const uint32_t count = end - begin;
+    if (count <= PointCloudShape::kNodeCapacity || depth >= kMaxDepth) {
+        return index;
+    }
+
+    // Strided sample spread over the node, moved to the front of the range.
+    const uint32_t own = PointCloudShape::kNodeCapacity;
+    for (uint32_t k = 0; k < own; ++k) {
+        const uint32_t pick = begin + static_cast<uint32_t>(static_cast<uint64_t>(k) * count / own);
+        std::swap(order[begin + k], order[pick]);
+    }
+    nodes[index].count = own;
+
+    // Partition the remainder into octants, splitting by x, then y, then z.
+    const float half = size * 0.5f;
+    const glm::vec3 center = min + glm::vec3(half);
+    auto split = [&](uint32_t b, uint32_t e, int axis) {
+        auto it = std::partition(order.begin() + b, order.begin() + e,
+                                 [&](uint32_t i) { return coordinate(vertices[i], axis) < center[axis]; });
+        return static_cast<uint32_t>(it - order.begin());
+    };
+
+    uint32_t splits[9];
+    splits[0] = begin + own;
+    splits[8] = end;
+    splits[4] = split(splits[0], splits[8], 0);
+    splits[2] = split(splits[0], splits[4], 1);
+    splits[6] = split(splits[4], splits[8], 1);
+    splits[1] = split(splits[0], splits[2], 2);
+    splits[3] = split(splits[2], splits[4], 2);
+    splits[5] = split(splits[4], splits[6], 2);
+    splits[7] = split(splits[6], splits[8], 2);
+
+    // Ranges are ordered x-major, so range r covers octant (x = r & 4, y = r & 2, z = r & 1).
+    for (int r = 0; r < 8; ++r) {
+        if (splits[r] == splits[r + 1]) continue;
+        glm::vec3 childMin(min.x + ((r & 4) ? half : 0.0f), min.y + ((r & 2) ? half : 0.0f),
+                           min.z + ((r & 1) ? half : 0.0f));
+        int32_t child = buildNode(vertices, order, nodes, splits[r], splits[r + 1], childMin, half, depth + 1);
+        nodes[index].children[r] = child;
+    }
+    return index;
+}
+}  // namespace
+
+PointCloudShape::PointCloudShape(double point_size) : Shape(Shape::PointCloud, point_size, 1.0) {}
+
+void PointCloudShape::setInEditable() {
+    if (!isEditable()) return;
+
+    // Points given as Vec3 are packed first.
+    if (!isPacked() && !points().empty()) {
+        auto toByte = [](double v) {
+            return static_cast<uint8_t>(std::lround(std::min(std::max(v, 0.0), 1.0) * 255.0));
+        };
+        const auto& source = points();
+        std::vector<PackedVertex> packed(source.size());
+        for (size_t i = 0; i < source.size(); ++i) {
+            const Vec3& c = color(i);
+            packed[i] = {static_cast<float>(source[i].x), static_cast<float>(source[i].y),
+                         static_cast<float>(source[i].z), toByte(c.x), toByte(c.y), toByte(c.z),
+                         toByte(transparency())};
+        }
+        setPackedVertices(std::move(packed));
+    }
+
+    buildOctree();
+    Shape::setInEditable();
+}
+
+bool PointCloudShape::restoreOctree(std::vector<Node>&& nodes) {
+    if (!isEditable() || !isPacked() || nodes.empty()) return false;
+
+    // Children follow their parent, as built, so traversals cannot loop.
+    const size_t vertex_count = packedVertices().size();
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const Node& node = nodes[i];
+        if (static_cast<size_t>(node.first) + node.subtreeCount > vertex_count || node.count > node.subtreeCount) {
+            return false;
+        }
+        for (int32_t child : node.children) {
+            if (child != -1 && (child <= static_cast<int32_t>(i) || static_cast<size_t>(child) >= nodes.size())) {
+                return false;
+            }
+        }
+    }
+    nodes_ = std::move(nodes);
+    Shape::setInEditable();
+    return true;
+}
+
+void PointCloudShape::buildOctree() {
+    nodes_.clear();
+    const auto& vertices = packedVertices();
+    if (vertices.empty()) return;
+    if (vertices.size() >= std::numeric_limits<uint32_t>::max()) {
+        qWarning() << "PointCloudShape: too many points for an octree, drawing without level of detail.";
+        return;
+    }
+
+    // Cubic root cell around the bounds.
+    BoundingBox box = bounds();
+    const float size = static_cast<float>(
+        std::max({box.max.x - box.min.x, box.max.y - box.min.y, box.max.z - box.min.z, 1e-6}));
+    const glm::vec3 min(box.min.x, box.min.y, box.min.z);
+
+    std::vector<uint32_t> order(vertices.size());
+    std::iota(order.begin(), order.end(), 0u);
+    buildNode(vertices, order, nodes_, 0, static_cast<uint32_t>(order.size()), min, size, 0);
+
+    // Store vertices in node order so every subtree is one contiguous range.
+    std::vector<PackedVertex> reordered(vertices.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        reordered[i] = vertices[order[i]];
+    }
+    setPackedVertices(std::move(reordered));
+}
+
+bool PointCloudShape::hasOctree() const { return !nodes_.empty(); }
+
+const std::vector<PointCloudShape::Node>& PointCloudShape::nodes() const { return nodes_; }
+
+size_t PointCloudShape::cpuBytes() const { return Shape::cpuBytes() + nodes_.capacity() * sizeof(Node); }
+
+bool PointCloudShape::selectLod(const LodParams& params, size_t& budget, std::vector<DrawRange>& ranges) const {
+    if (nodes_.empty() || !params.frustum.intersects(nodes_[0].bounds)) return false;
+
+    // Projected radius in pixels.
+    auto projectedSize = [&params](const Node& node) {
+        const Vec3 c = node.bounds.center();
+        const glm::vec3 center(c.x, c.y, c.z);
+        const float radius = 0.5f * static_cast<float>((node.bounds.max - node.bounds.min).length());
+        if (!params.perspective) return radius * params.pixelScale;
+        const float distance = std::max(glm::length(center - params.eye) - radius, 1e-3f);
+        return radius * params.pixelScale / distance;
+    };
+
+    const size_t firstRange = ranges.size();
+    bool limited = false;
+    std::priority_queue<std::pair<float, int32_t>> queue;
+    queue.push({projectedSize(nodes_[0]), 0});
+    while (!queue.empty()) {
+        const auto [pixels, index] = queue.top();
+        queue.pop();
+        const Node& node = nodes_[index];
+        if (node.count > budget) {
+            limited = true;
+            break;
+        }
+        budget -= node.count;
+        ranges.push_back({node.first, node.count});
+
+        if (pixels < params.refinePixels) continue;
+        for (int32_t child : node.children) {
+            if (child < 0 || !params.frustum.intersects(nodes_[child].bounds)) continue;
+            queue.push({projectedSize(nodes_[child]), child});
+        }
+    }
+
+    // Merge ranges that became adjacent in buffer order.
+    std::sort(ranges.begin() + firstRange, ranges.end(),
+              [](const DrawRange& a, const DrawRange& b) { return a.first < b.first; });
+    size_t last = firstRange;
+    for (size_t i = firstRange + 1; i < ranges.size(); ++i) {
+        if (ranges[last].first + ranges[last].count == ranges[i].first) {
+            ranges[last].count += ranges[i].count;
+        } else {
+            ranges[++last] = ranges[i];
+        }
+    }
+    if (ranges.size() > firstRange) {
+        ranges.resize(last + 1);
+    }
+    return limited;
+}
+
+void PointCloudShape::queryFrustum(const Frustum& frustum, std::vector<uint32_t>& indices) const {
+    const auto& vertices = packedVertices();
+    if (nodes_.empty()) {
+        for (uint32_t i = 0; i < vertices.size(); ++i) {
+            if (frustum.contains(vertices[i].x, vertices[i].y, vertices[i].z)) indices.push_back(i);
+        }
+        return;
+    }
+
+    std::vector<int32_t> stack = {0};
+    while (!stack.empty()) {
+        const Node& node = nodes_[stack.back()];
+        stack.pop_back();
+        if (!frustum.intersects(node.bounds)) continue;
+
+        // Whole subtree inside: take its contiguous range without testing points.
+        if (frustum.contains(node.bounds)) {
+            for (uint32_t i = node.first; i < node.first + node.subtreeCount; ++i) indices.push_back(i);
+            continue;
+        }
+
+        for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+            if (frustum.contains(vertices[i].x, vertices[i].y, vertices[i].z)) indices.push_back(i);
+        }
+        for (int32_t child : node.children) {
+            if (child >= 0) stack.push_back(child);
+        }
+    }
+}
+
+Shape::Ptr PointCloudShape::clone() {
+    auto new_shape = std::make_shared<PointCloudShape>(width());
+    new_shape->setTransparency(transparency());
+    if (colors().empty()) {
+        new_shape->setPointsWithColor(points(), color());
+    } else {
+        new_shape->setPointsWithColor(points(), colors());
+    }
+    if (isPacked()) {
+        new_shape->setPackedVertices(std::vector<PackedVertex>(packedVertices()));
+    }
+    return new_shape;
+}
+
+}  // namespace octo_flex
@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef POINT_CLOUD_SHAPE_H
+#define POINT_CLOUD_SHAPE_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include "def.h"
+#include "frustum.h"
+#include "shape.h"
+
+namespace octo_flex {
+
+// Large point set stored as packed vertices and organized into an octree when frozen.
+// Every node owns a spatially spread sample of its subtree, and a subtree's points are
+// contiguous in the vertex buffer, so any cut of the tree draws as a few vertex ranges.
+class PointCloudShape : public Shape {
+   public:
+    typedef std::shared_ptr<PointCloudShape> Ptr;
+
+    struct Node {
+        BoundingBox bounds;
+        uint32_t first;         // First vertex owned by this node
+        uint32_t count;         // Vertices owned by this node
+        uint32_t subtreeCount;  // Vertices of this node and all descendants, starting at first
+        int32_t children[8];    // Node indices, -1 if absent
+    };
+
+    // Vertex range selected for drawing.
+    struct DrawRange {
+        uint32_t first;
+        uint32_t count;
+    };
+
+    // View parameters for level-of-detail selection.
+    struct LodParams {
+        Frustum frustum;
+        glm::vec3 eye;
+        float pixelScale;  // Pixels per world unit at distance 1 (perspective) or per unit (ortho)
+        bool perspective;
+        float refinePixels;  // Nodes projected larger than this are refined
+    };
+
+    // Points owned by one node.
+    static const uint32_t kNodeCapacity = 8192;
+
+   public:
+    explicit PointCloudShape(double point_size = 1.0);
+
+    // Freezes the shape and builds the octree (reorders the packed vertices).
+    void setInEditable() override;
+
+    // Freezes the shape with an octree built earlier for the current vertex order, e.g. by a saved
+    // scene, instead of building it again. False, leaving the shape editable, if the nodes do not fit.
+    bool restoreOctree(std::vector<Node>&& nodes);
+
+    bool hasOctree() const;
+    const std::vector<Node>& nodes() const;
+
+    // Packed vertices and the octree.
+    size_t cpuBytes() const override;
+
+    // Pick nodes largest-on-screen first until the point budget is spent; appends merged
+    // ranges and decrements budget. Returns true if the budget cut the selection short.
+    bool selectLod(const LodParams& params, size_t& budget, std::vector<DrawRange>& ranges) const;
+
+    // Indices (into packedVertices()) of all points inside the frustum.
+    void queryFrustum(const Frustum& frustum, std::vector<uint32_t>& indices) const;
+
+    Shape::Ptr clone() override;
+
+   private:
+    void buildOctree();
+
+    std::vector<Node> nodes_;
+};
+
+}  // namespace octo_flex
+
+#endif /* POINT_CLOUD_SHAPE_H */
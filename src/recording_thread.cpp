@@ -15,8 +15,11 @@
 // limitations under the License.
 
 #include "recording_thread.h"
+#include "trace.h"
 
+#include <QElapsedTimer>
 #include <QMutexLocker>
+#include <algorithm>
 
 namespace octo_flex {
 
@@ -40,6 +43,12 @@ bool RecordingThread::startRecording(const VideoRecorderOptions& options, std::s
     shouldStop_ = false;
     recordingActive_ = true;
     lastError_.clear();
+    framesWritten_ = 0;
+    encoderStalls_ = 0;
+    {
+        QMutexLocker locker(&queueMutex_);
+        encoderName_.clear();
+    }
     clearQueue();
 
     // Start the worker thread - ffmpeg will be started in run()
@@ -61,13 +70,21 @@ bool RecordingThread::startRecording(const VideoRecorderOptions& options, std::s
     return true;
 }
 
-bool RecordingThread::queueFrame(const QImage& frame) {
+bool RecordingThread::queueFrame(QImage frame, int waitMs) {
     if (!recordingActive_ || shouldStop_) {
         return false;
     }
 
     QMutexLocker locker(&queueMutex_);
 
+    // Wait for room if asked to, rather than dropping the frame
+    QElapsedTimer waited;
+    waited.start();
+    while (static_cast<int>(frameQueue_.size()) >= maxQueueSize_ && recordingActive_ && !shouldStop_ &&
+           waited.elapsed() < waitMs) {
+        spaceCondition_.wait(&queueMutex_, static_cast<unsigned long>(waitMs - waited.elapsed()));
+    }
+
     // Check queue capacity
     if (static_cast<int>(frameQueue_.size()) >= maxQueueSize_) {
         // Queue is full, emit warning signal
@@ -76,8 +93,8 @@ bool RecordingThread::queueFrame(const QImage& frame) {
         return false;
     }
 
-    // Copy frame and add to queue
-    frameQueue_.push(frame.copy());
+    // Hand the frame over to the worker thread
+    frameQueue_.push(std::move(frame));
 
     // Check if queue is getting full (>= 80%)
     int currentSize = static_cast<int>(frameQueue_.size());
@@ -126,29 +143,40 @@ bool RecordingThread::stopRecording(std::string* error) {
     return lastError_.empty();
 }
 
+std::string RecordingThread::encoderName() const {
+    QMutexLocker locker(&queueMutex_);
+    return encoderName_;
+}
+
 bool RecordingThread::isRecording() const {
     return recordingActive_;
 }
 
 void RecordingThread::run() {
-    // Create and start ffmpeg in this worker thread
+    setTraceThreadName("recording");
+    // Create and start the encoder in this worker thread (probing hardware encoders can take a moment)
     recorder_ = std::make_unique<VideoRecorder>();
     
     std::string startError;
     if (!recorder_->start(options_, &startError)) {
-        lastError_ = "Failed to start ffmpeg: " + startError;
+        lastError_ = "Failed to start video encoder: " + startError;
         recordingActive_ = false;
         emit recordingStopped(false, lastError_);
         return;
     }
+    {
+        QMutexLocker locker(&queueMutex_);
+        encoderName_ = recorder_->encoderName();
+    }
     
     // Process frames
     processFrames();
 }
 
 void RecordingThread::processFrames() {
-    int frameCount = 0;
-    
+    const qint64 frameIntervalNs = 1000000000LL / std::max(1, options_.fps);
+    QElapsedTimer writeTimer;
+
     while (!shouldStop_ || !frameQueue_.empty()) {
         QImage frame;
 
@@ -167,18 +195,23 @@ void RecordingThread::processFrames() {
                 continue;
             }
 
-            frame = frameQueue_.front();
+            frame = std::move(frameQueue_.front());
             frameQueue_.pop();
+            spaceCondition_.wakeAll();
         }
 
         // Write frame to recorder
         if (!frame.isNull() && recorder_) {
             std::string error;
+            writeTimer.start();
             if (!recorder_->writeFrame(frame, &error)) {
                 lastError_ = "Failed to write frame: " + error;
                 break;
             }
-            frameCount++;
+            if (writeTimer.nsecsElapsed() > frameIntervalNs) {
+                encoderStalls_++;
+            }
+            framesWritten_++;
         }
     }
     
@@ -203,6 +236,7 @@ void RecordingThread::clearQueue() {
     while (!frameQueue_.empty()) {
         frameQueue_.pop();
     }
+    spaceCondition_.wakeAll();
 }
 
 }  // namespace octo_flex
@@ -23,6 +23,7 @@
 #include <QThread>
 #include <queue>
 #include <atomic>
+#include <cstdint>
 #include <string>
 #include "video_recorder.h"
 
@@ -38,9 +39,21 @@ class RecordingThread : public QThread {
     // Start recording with the given options.
     bool startRecording(const VideoRecorderOptions& options, std::string* error = nullptr);
 
-    // Queue a frame for recording (non-blocking).
+    // Queue a frame for recording. The frame is taken over, not copied: the caller must not write
+    // to it afterwards (pooled frames return to their pool once written). A full queue waits up to
+    // waitMs (default: not at all) for the worker to make room.
     // Returns false if the queue is full or recording is not active.
-    bool queueFrame(const QImage& frame);
+    bool queueFrame(QImage frame, int waitMs = 0);
+
+    // Queue capacity (default 60); set before startRecording.
+    void setMaxQueueSize(int size) { maxQueueSize_ = size; }
+
+    // Frames written, and writes that took longer than one frame interval.
+    uint64_t framesWritten() const { return framesWritten_; }
+    uint64_t encoderStalls() const { return encoderStalls_; }
+
+    // Encoder the worker thread started (empty until it did).
+    std::string encoderName() const;
 
     // Stop recording and wait for the thread to finish.
     // Returns true if all queued frames were written successfully.
@@ -69,12 +82,16 @@ class RecordingThread : public QThread {
     std::queue<QImage> frameQueue_;
     mutable QMutex queueMutex_;
     QWaitCondition queueCondition_;
+    QWaitCondition spaceCondition_;  // Signaled when the worker took a frame off the queue
 
     std::atomic<bool> recordingActive_{false};
     std::atomic<bool> shouldStop_{false};
     std::atomic<int> maxQueueSize_{60};
+    std::atomic<uint64_t> framesWritten_{0};
+    std::atomic<uint64_t> encoderStalls_{0};
 
     std::string lastError_;
+    std::string encoderName_;  // Guarded by queueMutex_
 };
 
 }  // namespace octo_flex
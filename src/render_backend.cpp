@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "render_backend.h"
+#include <QByteArray>
+#include <QtDebug>
+#include "fixed_function_backend.h"
+#include "scalar_field.h"
+#include "shader_backend.h"
+
+namespace octo_flex {
+namespace {
+
+RenderBackendType typeFromEnvironment() {
+    const QByteArray name = qgetenv("OCTO_FLEX_RENDER_BACKEND").trimmed().toLower();
+    if (name.isEmpty() || name == "fixed") return RenderBackendType::FIXED_FUNCTION;
+    if (name == "shader") return RenderBackendType::SHADER;
+    qWarning() << "RenderBackend: Unknown OCTO_FLEX_RENDER_BACKEND" << name << "(use fixed or shader).";
+    return RenderBackendType::FIXED_FUNCTION;
+}
+
+RenderBackendType& defaultTypeStorage() {
+    static RenderBackendType type = typeFromEnvironment();
+    return type;
+}
+
+}  // namespace
+
+glm::vec2 RenderBackend::DrawStyle::scalarTexCoordMap() const {
+    const float texels = static_cast<float>(ScalarUploader::kColormapSize);
+    const float range = scalarMax - scalarMin;
+    const float scale = range != 0.0f ? (texels - 1.0f) / (texels * range) : 0.0f;
+    return glm::vec2(scale, 0.5f / texels - scalarMin * scale);
+}
+
+RenderBackend::Ptr RenderBackend::create(RenderBackendType type) {
+    if (type == RenderBackendType::SHADER) {
+        return Ptr(new ShaderBackend());
+    }
+    return Ptr(new FixedFunctionBackend());
+}
+
+RenderBackendType RenderBackend::defaultType() { return defaultTypeStorage(); }
+
+void RenderBackend::setDefaultType(RenderBackendType type) { defaultTypeStorage() = type; }
+
+QSurfaceFormat RenderBackend::surfaceFormat(RenderBackendType type) {
+    QSurfaceFormat format = QSurfaceFormat::defaultFormat();
+    // OpenGL ES contexts pick their version themselves; the shader backend needs ES 3.2 there.
+    if (type == RenderBackendType::SHADER && QOpenGLContext::openGLModuleType() == QOpenGLContext::LibGL) {
+        format.setVersion(3, 3);
+        format.setProfile(QSurfaceFormat::CoreProfile);
+    }
+    return format;
+}
+
+const char* RenderBackend::typeName(RenderBackendType type) {
+    return type == RenderBackendType::SHADER ? "shader" : "fixed function";
+}
+
+}  // namespace octo_flex
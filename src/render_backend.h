@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RENDER_BACKEND_H
+#define RENDER_BACKEND_H
+
+#include <GL/glew.h>
+#include <QOpenGLContext>
+#include <QSurfaceFormat>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include "def.h"
+#include "render_backend_type.h"
+
+namespace octo_flex {
+
+// Draws the geometry of a view through one OpenGL pipeline. The view decides what is drawn and in
+// which order; the backend owns how matrices, vertex layouts and line styles reach the GPU.
+// All methods are called from the thread painting the view (see RenderThread) with its context current.
+class RenderBackend {
+   public:
+    typedef std::unique_ptr<RenderBackend> Ptr;
+
+    enum Primitive { Points = 0, Lines, LineLoop, Triangles, TriangleFan, LineStrip };
+
+    // Vertex layouts stored by shapes and batches: Shape::GpuVertex or PackedVertex.
+    enum Layout { FloatColor = 0, PackedColor };
+
+    // Vertices of a draw: a vertex buffer, or client memory while buffer is 0.
+    struct VertexSource {
+        GLuint buffer = 0;
+        const void* data = nullptr;
+        Layout layout = FloatColor;
+    };
+
+    // State of one draw.
+    struct DrawStyle {
+        float size = 1.0f;                  // Point size or line width in pixels
+        bool dashed = false;                // Lines only, 8 pixels on and 8 off
+        bool vertexColors = true;           // Otherwise every vertex takes color
+        glm::vec4 color = glm::vec4(1.0f);  // Also carries pick IDs
+
+        // Colors mapped from one float per vertex instead, while scalarBuffer is set: read from
+        // scalarBuffer at scalarOffset bytes, looked up in the colormap texture (a
+        // ScalarUploader::kColormapSize x 1 row) over [scalarMin, scalarMax], and modulated by color.
+        GLuint scalarBuffer = 0;
+        GLintptr scalarOffset = 0;
+        GLuint colormap = 0;
+        float scalarMin = 0.0f;
+        float scalarMax = 1.0f;
+
+        // Scale and offset taking a scalar to its colormap texture coordinate, so scalarMin and
+        // scalarMax land on the centers of the first and last texels.
+        glm::vec2 scalarTexCoordMap() const;
+    };
+
+    virtual ~RenderBackend() {}
+
+    // Create a backend of the given type; call initialize() before drawing.
+    static Ptr create(RenderBackendType type);
+
+    // Backend new views start with. Defaults to OCTO_FLEX_RENDER_BACKEND ("fixed" or "shader"),
+    // else fixed function.
+    static RenderBackendType defaultType();
+    static void setDefaultType(RenderBackendType type);
+
+    // Surface format the default type needs (a core profile for shaders on desktop OpenGL).
+    // Apply as the default format before QApplication is created so shared contexts agree.
+    static QSurfaceFormat surfaceFormat(RenderBackendType type);
+
+    static const char* typeName(RenderBackendType type);
+
+    virtual RenderBackendType type() const = 0;
+
+    // Create GPU objects for context; false if the context cannot run this backend.
+    virtual bool initialize(QOpenGLContext* context) = 0;
+    virtual void release() = 0;
+
+    // Start drawing with the given matrices; the model stack is reset to identity.
+    // viewport is the render target size in pixels, for line widths.
+    virtual void beginPass(const glm::mat4& projection, const glm::mat4& view, const glm::vec2& viewport) = 0;
+    virtual void endPass() = 0;
+
+    // Multiply a model matrix onto the current transform; pair with popModel.
+    virtual void pushModel(const glm::mat4& model) = 0;
+    virtual void popModel() = 0;
+
+    // Draw vertex ranges of one source with one style, in a single call when supported.
+    virtual void draw(const VertexSource& source, Primitive primitive, const GLint* firsts, const GLsizei* counts,
+                      GLsizei rangeCount, const DrawStyle& style) = 0;
+
+    // Draw one range starting at first.
+    void draw(const VertexSource& source, Primitive primitive, GLint first, GLsizei count, const DrawStyle& style) {
+        draw(source, primitive, &first, &count, 1, style);
+    }
+
+    // Draw vertices of source by index (GL_UNSIGNED_INT), reading indices from indexBuffer, or from
+    // client memory while indexBuffer is 0.
+    virtual void drawIndexed(const VertexSource& source, Primitive primitive, GLuint indexBuffer,
+                             const uint32_t* indices, GLsizei count, const DrawStyle& style) = 0;
+
+    // Draw a textured quad; corners and uvs hold 4 entries in fan order, uvs as (u, v) pairs.
+    virtual void drawTexturedQuad(const Vec3* corners, const float* uvs, GLuint texture, float alpha) = 0;
+};
+
+}  // namespace octo_flex
+
+#endif /* RENDER_BACKEND_H */
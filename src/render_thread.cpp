@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "render_thread.h"
+#include <QMutexLocker>
+#include <QOpenGLContext>
+#include "trace.h"
+
+namespace octo_flex {
+
+QReadWriteLock* sceneLock() {
+    static QReadWriteLock lock;
+    return &lock;
+}
+
+RenderThread::RenderThread(QOpenGLWidget* view, std::function<void()> paint)
+    : view_(view), paint_(std::move(paint)), guiThread_(view->thread()) {}
+
+RenderThread::~RenderThread() { stop(); }
+
+void RenderThread::requestFrame() {
+    QMutexLocker locker(&mutex_);
+    requested_ = true;
+    condition_.wakeAll();
+}
+
+void RenderThread::waitForFrame() {
+    QMutexLocker locker(&mutex_);
+    while (handoff_ == Handoff::Granted) {
+        condition_.wait(&mutex_);
+    }
+}
+
+void RenderThread::stop() {
+    {
+        QMutexLocker locker(&mutex_);
+        exiting_ = true;
+        condition_.wakeAll();
+    }
+    wait();
+}
+
+void RenderThread::grant() {
+    QMutexLocker locker(&mutex_);
+    if (handoff_ != Handoff::Requested) return;
+
+    QOpenGLContext* context = view_->context();
+    if (exiting_ || !context || !view_->isValid()) {
+        handoff_ = Handoff::Declined;
+    } else {
+        // A context current on the GUI thread (after a resize or renderFrame(), say) cannot move.
+        if (QOpenGLContext::currentContext() == context) {
+            view_->doneCurrent();
+        }
+        context->moveToThread(this);
+        handoff_ = Handoff::Granted;
+    }
+    condition_.wakeAll();
+}
+
+void RenderThread::run() {
+    setTraceThreadName("render thread");
+    QMutexLocker locker(&mutex_);
+    while (true) {
+        while (!requested_ && !exiting_) {
+            condition_.wait(&mutex_);
+        }
+        if (exiting_) break;
+        requested_ = false;
+
+        // Queued on this object, which lives on the GUI thread: dropped if the thread is deleted first.
+        handoff_ = Handoff::Requested;
+        QMetaObject::invokeMethod(this, [this]() { grant(); }, Qt::QueuedConnection);
+        while (handoff_ == Handoff::Requested && !exiting_) {
+            condition_.wait(&mutex_);
+        }
+        if (handoff_ != Handoff::Granted) {
+            handoff_ = Handoff::Idle;
+            continue;
+        }
+        locker.unlock();
+
+        view_->makeCurrent();
+        paint_();
+        view_->doneCurrent();
+        view_->context()->moveToThread(guiThread_);
+
+        locker.relock();
+        handoff_ = Handoff::Idle;
+        condition_.wakeAll();
+        QMetaObject::invokeMethod(view_, "update", Qt::QueuedConnection);
+    }
+    handoff_ = Handoff::Idle;
+}
+
+}  // namespace octo_flex
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RENDER_THREAD_H
+#define RENDER_THREAD_H
+
+#include <QMutex>
+#include <QOpenGLWidget>
+#include <QReadWriteLock>
+#include <QThread>
+#include <QWaitCondition>
+#include <functional>
+
+namespace octo_flex {
+
+// Guards the GL state the views of a process share while they paint on their own threads. A frame
+// holds it for writing while it drains the scene updates, runs the shared uploaders, builds the layer
+// batches and collects deferred deletions, and again to clear outdated objects; it draws holding it
+// for reading, so views draw at the same time. GUI code that builds, reads or releases that state
+// takes it too. Never wait for a render thread while holding it.
+QReadWriteLock* sceneLock();
+
+// Paints one view off the GUI thread (see OctoFlexView::setThreadedRendering()).
+// The view's context stays on the GUI thread between frames, so Qt composes and resizes the widget
+// and the view picks, captures and releases resources there as before. For each frame the render
+// thread asks for the context, the GUI thread hands it over between two of its events, and the
+// render thread paints, moves the context back and asks the widget to compose the new frame.
+// GUI code that uses the context or state the frame reads calls waitForFrame() first; no new frame
+// starts before the GUI thread returns to its event loop. Composing does not wait: the view paints
+// into a framebuffer of its own and copies each finished frame into the widget's.
+class RenderThread : public QThread {
+    Q_OBJECT
+
+   public:
+    // paint runs on this thread with the view's context current.
+    RenderThread(QOpenGLWidget* view, std::function<void()> paint);
+    ~RenderThread() override;
+
+    // Ask for a frame; requests made while one is pending or painting add up to one more frame.
+    void requestFrame();
+
+    // Block until no frame is painting (GUI thread).
+    void waitForFrame();
+
+    // Finish the frame in flight and join the thread (GUI thread); the context stays on the GUI thread.
+    void stop();
+
+   protected:
+    void run() override;
+
+   private:
+    enum class Handoff {
+        Idle,       // The context is on the GUI thread
+        Requested,  // grant() is queued on the GUI thread
+        Granted,    // The context is on this thread, a frame is painting
+        Declined    // The view has no context to paint with
+    };
+
+    // Move the context to this thread for one frame (GUI thread, queued by run()).
+    void grant();
+
+    QOpenGLWidget* view_;
+    std::function<void()> paint_;
+    QThread* guiThread_;
+
+    QMutex mutex_;
+    QWaitCondition condition_;
+    bool requested_ = false;          // Guarded by mutex_
+    bool exiting_ = false;            // Guarded by mutex_
+    Handoff handoff_ = Handoff::Idle;  // Guarded by mutex_
+};
+
+}  // namespace octo_flex
+
+#endif  // RENDER_THREAD_H
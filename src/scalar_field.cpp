@@ -0,0 +1,187 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "scalar_field.h"
+
+#include <QDebug>
+#include <QOpenGLFunctions>
+#include <algorithm>
+#include <cmath>
+
+#include "shape.h"
+
+namespace octo_flex {
+namespace {
+
+double clamp01(double value) { return std::min(std::max(value, 0.0), 1.0); }
+
+// Horner evaluation of one channel of a polynomial fit.
+double polynomial(const double* c, int degree, double t) {
+    double value = c[degree];
+    for (int i = degree - 1; i >= 0; --i) value = value * t + c[i];
+    return value;
+}
+
+// Polynomial fit of matplotlib's viridis, coefficients from the constant term up.
+const double kViridis[3][7] = {
+    {0.2777273272234177, 0.1050930431085774, -0.3308618287255563, -4.634230498983486, 6.228269936347081,
+     4.776384997670288, -5.435455855934631},
+    {0.005407344544966578, 1.404613529898575, 0.214847559468213, -5.799100973351585, 14.17993336680509,
+     -13.74514537774601, 4.645852612178535},
+    {0.3340998053353061, 1.384590162594685, 0.09509516302823659, -19.33244095627987, 56.69055260068105,
+     -65.35303263337234, 26.3124352495832},
+};
+
+// Polynomial fit of Google's Turbo, coefficients from the constant term up.
+const double kTurbo[3][6] = {
+    {0.13572138, 4.61539260, -42.66032258, 132.13108234, -152.94239396, 59.28637943},
+    {0.09140261, 2.19418839, 4.84296658, -14.18503333, 4.27729857, 2.82956604},
+    {0.10667330, 12.64194608, -60.58204836, 110.36276771, -89.90310912, 27.34824973},
+};
+
+}  // namespace
+
+Vec3 colormapColor(Colormap colormap, double t) {
+    t = clamp01(std::isnan(t) ? 0.0 : t);
+    switch (colormap) {
+        case Colormap::Viridis:
+            return Vec3(clamp01(polynomial(kViridis[0], 6, t)), clamp01(polynomial(kViridis[1], 6, t)),
+                        clamp01(polynomial(kViridis[2], 6, t)));
+        case Colormap::Turbo:
+            return Vec3(clamp01(polynomial(kTurbo[0], 5, t)), clamp01(polynomial(kTurbo[1], 5, t)),
+                        clamp01(polynomial(kTurbo[2], 5, t)));
+        case Colormap::Jet:
+            return Vec3(clamp01(1.5 - std::abs(4.0 * t - 3.0)), clamp01(1.5 - std::abs(4.0 * t - 2.0)),
+                        clamp01(1.5 - std::abs(4.0 * t - 1.0)));
+        default:
+            return Vec3(t, t, t);
+    }
+}
+
+ScalarField::ScalarField(std::vector<float>&& values, std::vector<int64_t>&& shapeOffsets, const Mapping& mapping)
+    : count_(values.size()), shape_offsets_(std::move(shapeOffsets)), values_(std::move(values)), mapping_(mapping) {
+    ScalarUploader::instance()->add(this);
+}
+
+ScalarField::~ScalarField() { ScalarUploader::instance()->remove(this); }
+
+bool ScalarField::mapsVertices(const Shape& shape) {
+    switch (shape.type()) {
+        case Shape::Points:
+        case Shape::Lines:
+        case Shape::Dash:
+        case Shape::Loop:
+        case Shape::Polygon:
+            return true;
+        default:
+            return false;
+    }
+}
+
+int64_t ScalarField::shapeOffset(size_t shapeIndex) const {
+    return shapeIndex < shape_offsets_.size() ? shape_offsets_[shapeIndex] : -1;
+}
+
+bool ScalarField::update(const float* values, size_t count) {
+    if (count != count_ || (count > 0 && !values)) {
+        qWarning() << "ScalarField::update:" << count << "values for a field of" << count_;
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::copy(values, values + count, values_.begin());
+        ++version_;
+    }
+    ScalarUploader::instance()->changed();
+    return true;
+}
+
+void ScalarField::setMapping(const Mapping& mapping) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        mapping_ = mapping;
+    }
+    ScalarUploader::instance()->changed();
+}
+
+ScalarField::Mapping ScalarField::mapping() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return mapping_;
+}
+
+Vec3 ScalarField::objectColor() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (values_.empty()) return Vec3(0, 0, 0);
+    const double range = mapping_.max - mapping_.min;
+    const double t = range != 0.0 ? (values_[0] - mapping_.min) / range : 0.0;
+    return colormapColor(mapping_.colormap, t);
+}
+
+void ScalarUploader::release(ScalarField* field, uint32_t group) {
+    GlDeletionQueue::instance()->deleteBuffers(group, {field->buffer_});
+}
+
+void ScalarUploader::createColormaps(QOpenGLFunctions* gl) {
+    // Linear filtering between texels that sit on evenly spaced values, shared by all views.
+    std::vector<unsigned char> texels(kColormapSize * 4);
+    gl->glGenTextures(4, colormaps_);
+    for (int map = 0; map < 4; ++map) {
+        for (int i = 0; i < kColormapSize; ++i) {
+            const Vec3 color = colormapColor(static_cast<Colormap>(map), i / double(kColormapSize - 1));
+            texels[i * 4] = static_cast<unsigned char>(std::lround(color.x * 255.0));
+            texels[i * 4 + 1] = static_cast<unsigned char>(std::lround(color.y * 255.0));
+            texels[i * 4 + 2] = static_cast<unsigned char>(std::lround(color.z * 255.0));
+            texels[i * 4 + 3] = 255;
+        }
+        gl->glBindTexture(GL_TEXTURE_2D, colormaps_[map]);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        gl->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, kColormapSize, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+    }
+    gl->glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void ScalarUploader::uploadPending() {
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    if (!context) return;
+    QOpenGLFunctions* gl = context->functions();
+
+    uploadEach([this, gl](ScalarField* field) {
+        // Created with the first field, under the registry lock like the field buffers.
+        if (colormaps_[0] == 0) createColormaps(gl);
+        if (field->isPerObject()) return;
+        std::lock_guard<std::mutex> valuesLock(field->mutex_);
+        if (field->version_ == field->uploaded_version_) return;
+
+        // Only the float array: allocated once, then replaced in place.
+        const GLsizeiptr bytes = static_cast<GLsizeiptr>(field->count_ * sizeof(float));
+        if (field->buffer_ == 0) {
+            gl->glGenBuffers(1, &field->buffer_);
+            gl->glBindBuffer(GL_ARRAY_BUFFER, field->buffer_);
+            gl->glBufferData(GL_ARRAY_BUFFER, bytes, field->values_.data(), GL_DYNAMIC_DRAW);
+            field->gpu_bytes_.store(static_cast<size_t>(bytes), std::memory_order_relaxed);
+        } else {
+            gl->glBindBuffer(GL_ARRAY_BUFFER, field->buffer_);
+            gl->glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, field->values_.data());
+        }
+        field->uploaded_version_ = field->version_;
+        gl->glBindBuffer(GL_ARRAY_BUFFER, 0);
+    });
+}
+
+}  // namespace octo_flex
@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SCALAR_FIELD_H
+#define SCALAR_FIELD_H
+
+#include <QOpenGLContext>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "colormap.h"
+#include "def.h"
+#include "upload_registry.h"
+
+class QOpenGLFunctions;
+
+namespace octo_flex {
+
+class Shape;
+
+// Float attribute of an object, mapped to colors at draw time through a colormap over a value range
+// (see ObjectBuilder::scalars()). It holds one value for the whole object, or one per vertex of the
+// object's plain shapes (points, lines, dashed lines, loops and polygons) in the order they were
+// added. The values and the mapping may be replaced from any thread; the views upload only the float
+// array into one vertex buffer, allocated once, and the colormap lookup runs on the GPU.
+class ScalarField {
+   public:
+    typedef std::shared_ptr<ScalarField> Ptr;
+
+    struct Mapping {
+        Colormap colormap = Colormap::Viridis;
+        float min = 0.0f;  // Mapped to the start of the colormap
+        float max = 1.0f;  // Mapped to its end
+    };
+
+    // shapeOffsets holds the index of the first value of each shape of the object, -1 for shapes that
+    // take none; empty for a single value.
+    ScalarField(std::vector<float>&& values, std::vector<int64_t>&& shapeOffsets, const Mapping& mapping);
+    ~ScalarField();
+    ScalarField(const ScalarField&) = delete;
+    ScalarField& operator=(const ScalarField&) = delete;
+
+    // Whether a shape takes one value per vertex.
+    static bool mapsVertices(const Shape& shape);
+
+    size_t count() const { return count_; }
+    bool isPerObject() const { return count_ == 1; }
+
+    // Index of the first value of the object's shape at shapeIndex, -1 if it takes none.
+    int64_t shapeOffset(size_t shapeIndex) const;
+
+    // Replace all values (thread-safe); false if count differs from count().
+    bool update(const float* values, size_t count);
+
+    // Replace the colormap and range (thread-safe); nothing is uploaded.
+    void setMapping(const Mapping& mapping);
+    Mapping mapping() const;
+
+    // Color of the value of a per-object field through the mapping.
+    Vec3 objectColor() const;
+
+    // Vertex buffer of the values uploaded last; painting views, 0 before the first upload and per object.
+    GLuint buffer() const { return buffer_; }
+
+    // Bytes of the vertex buffer. Safe to call from any thread.
+    size_t gpuBytes() const { return gpu_bytes_.load(std::memory_order_relaxed); }
+
+   private:
+    friend class ScalarUploader;
+
+    const size_t count_;
+    const std::vector<int64_t> shape_offsets_;
+
+    mutable std::mutex mutex_;
+    std::vector<float> values_;  // Guarded by mutex_
+    uint64_t version_ = 1;       // Guarded by mutex_, bumped by update()
+    Mapping mapping_;            // Guarded by mutex_
+
+    // Painting views only.
+    GLuint buffer_ = 0;
+    uint64_t uploaded_version_ = 0;
+    std::atomic<size_t> gpu_bytes_{0};
+};
+
+// GL side of the scalar fields, uploaded by the views as they paint: one vertex buffer per
+// per-vertex field and one shared texture per colormap.
+class ScalarUploader : public UploadRegistry<ScalarUploader, ScalarField> {
+   public:
+    // Texels of a colormap texture (kColormapSize x 1, RGBA8).
+    static const int kColormapSize = 256;
+
+    // Upload the values replaced since the last call, creating the colormap textures on first use;
+    // called by the views at the start of paintGL, with their context current.
+    void uploadPending();
+
+    // Texture of a colormap; 0 before the first uploadPending().
+    GLuint colormapTexture(Colormap colormap) const { return colormaps_[static_cast<int>(colormap)]; }
+
+   private:
+    friend class ScalarField;
+    friend class UploadRegistry<ScalarUploader, ScalarField>;
+
+    ScalarUploader() {}
+
+    void release(ScalarField* field, uint32_t group);
+    void createColormaps(QOpenGLFunctions* gl);
+
+    GLuint colormaps_[4] = {0, 0, 0, 0};  // By Colormap
+};
+
+}  // namespace octo_flex
+
+#endif  // SCALAR_FIELD_H
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "scene_resources.h"
+
+namespace octo_flex {
+
+SceneResources::~SceneResources() { releaseResources(); }
+
+bool SceneResources::attach(QOpenGLContext* context) {
+    if (!context) return false;
+
+    if (attached_ && share_group_.isNull()) {
+        // Every context of the old group is gone and its buffers with it.
+        for (auto& [layer_id, batch] : layer_batches_) {
+            batch->discardResources();
+        }
+        layer_batches_.clear();
+        attached_ = false;
+    }
+
+    if (!attached_) {
+        share_group_ = context->shareGroup();
+        attached_ = true;
+        return true;
+    }
+    return context->shareGroup() == share_group_.data();
+}
+
+LayerBatch::Ptr SceneResources::layerBatch(const std::string& layer_id, const Layer::Ptr& layer) {
+    LayerBatch::Ptr& batch = layer_batches_[layer_id];
+    if (!batch) {
+        batch = std::make_shared<LayerBatch>();
+    }
+
+    // Update only when the layer contents changed since the last build.
+    // The snapshot carries its own version, so a concurrent change triggers another update next frame.
+    if (!batch->isBuilt() || batch->version() != layer->version()) {
+        LayerSnapshotPtr snapshot = layer->snapshot();
+        batch->build(snapshot->objects, snapshot->version);
+    }
+    return batch;
+}
+
+size_t SceneResources::batchBytes(const std::string& layer_id) const {
+    auto it = layer_batches_.find(layer_id);
+    return it != layer_batches_.end() && it->second ? it->second->gpuBytes() : 0;
+}
+
+void SceneResources::releaseResources() {
+    for (auto& [layer_id, batch] : layer_batches_) {
+        batch->releaseResources();
+    }
+    layer_batches_.clear();
+}
+
+}  // namespace octo_flex
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef SCENE_RESOURCES_H
+#define SCENE_RESOURCES_H
+
+#include <QOpenGLContext>
+#include <QPointer>
+#include <map>
+#include <memory>
+#include <string>
+#include "layer.h"
+#include "layer_batch.h"
+
+namespace octo_flex {
+
+// GPU resources of one scene shared by every view whose context is in the same share group.
+// Shapes keep their own vertex buffers and textures; this holds the per-layer merged batches.
+// Changed holding sceneLock() for writing; frames draw its batches holding it for reading.
+class SceneResources {
+   public:
+    typedef std::shared_ptr<SceneResources> Ptr;
+
+    SceneResources() {}
+    ~SceneResources();
+
+    // Whether a view rendering with context can draw these resources. The first context binds the
+    // share group; a context outside it must use resources of its own.
+    bool attach(QOpenGLContext* context);
+
+    // Merged batch of a layer, rebuilt only when the layer version changed since any view built it.
+    LayerBatch::Ptr layerBatch(const std::string& layer_id, const Layer::Ptr& layer);
+
+    // Vertex buffer bytes of a layer's merged batch as last built (0 before its first draw).
+    size_t batchBytes(const std::string& layer_id) const;
+
+    // Release all GPU buffers (called with a context of the share group current).
+    void releaseResources();
+
+   private:
+    std::map<std::string, LayerBatch::Ptr> layer_batches_;
+    QPointer<QOpenGLContextGroup> share_group_;
+    bool attached_ = false;
+};
+
+}  // namespace octo_flex
+
+#endif /* SCENE_RESOURCES_H */
@@ -0,0 +1,748 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "scene_snapshot.h"
+
+#include <QFile>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "instanced_shape.h"
+#include "point_cloud_shape.h"
+#include "textured_quad.h"
+#include "worker_pool.h"
+
+namespace octo_flex {
+namespace {
+
+const char kMagic[8] = {'O', 'F', 'V', 'S', 'C', 'E', 'N', 'E'};
+const uint32_t kByteOrder = 0x01020304;
+const uint16_t kMajorVersion = 1;  // Readers refuse other major versions
+const uint16_t kMinorVersion = 2;  // Minor versions only append fields to the records
+const size_t kAlignment = 16;      // Of every array other than strings
+
+// Array in the file: byte offset from the start and element count (bytes for strings).
+struct Span {
+    uint64_t offset;
+    uint64_t count;
+};
+
+struct Header {
+    char magic[8];
+    uint32_t byte_order;  // kByteOrder as stored by the writing machine
+    uint16_t major_version;
+    uint16_t minor_version;
+    uint32_t header_size;
+    uint32_t layer_record_size;  // Record strides; newer minor versions have longer records
+    uint32_t object_record_size;
+    uint32_t shape_record_size;
+    uint32_t reserved[2];
+    uint64_t layer_count;
+    uint64_t object_count;
+    uint64_t shape_count;
+    uint64_t layers_offset;
+    uint64_t objects_offset;
+    uint64_t shapes_offset;
+};
+
+struct LayerRecord {
+    Span id;
+    uint64_t first_object;
+    uint64_t object_count;
+};
+
+enum ObjectFlags : uint32_t { kObjectPosed = 1 };
+
+struct ObjectRecord {
+    Span id;
+    Span info;
+    double text_color[3];
+    double position[3];  // Pose the shapes are built at
+    double orientation[4];
+    double pose_position[3];  // Draw-time pose, with kObjectPosed
+    double pose_orientation[4];
+    uint64_t first_shape;
+    uint32_t shape_count;
+    uint32_t flags;
+    // Minor version 1
+    Span lod_sizes;  // float, Object::lodSizes()
+};
+
+enum ShapeFlags : uint32_t { kShapePacked = 1, kShapeMipmaps = 2, kShapeReference = 4 };  // Reference: minor 2
+
+struct ShapeRecord {
+    uint32_t type;  // Shape::ShapeType
+    uint32_t flags;
+    double width;
+    double transparency;
+    double color[3];
+    Span points;     // Vec3
+    Span colors;     // Vec3
+    Span packed;     // PackedVertex
+    Span holes;      // uint64_t
+    Span triangles;  // uint32_t
+    Span baked;      // Shape::GpuVertex, one per point
+    Span nodes;      // NodeRecord, point clouds only
+    // Textured quads
+    Span texture_path;
+    double quad_size[2];
+    float uvs[8];
+    // Instanced shapes; their prototype shapes are records of their own, shared by shapes sharing a mesh
+    uint64_t first_prototype;
+    uint64_t prototype_count;
+    Span positions;        // Vec3
+    Span orientations;     // Quaternion
+    Span scales;           // Vec3
+    Span instance_colors;  // Vec3
+    // Minor version 1
+    uint32_t lod_level;  // Shape::lodLevel() + 1, so 0 (older files) draws at every level
+    uint32_t reserved;
+};
+
+struct NodeRecord {
+    double min[3];
+    double max[3];
+    uint32_t valid;
+    uint32_t first;
+    uint32_t count;
+    uint32_t subtree_count;
+    int32_t children[8];
+};
+
+// Arrays are written and mapped as they are laid out in memory.
+static_assert(sizeof(Vec3) == 24 && std::is_trivially_copyable<Vec3>::value, "Vec3 must be three doubles");
+static_assert(sizeof(Quaternion) == 32 && std::is_trivially_copyable<Quaternion>::value,
+              "Quaternion must be four doubles");
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex must be packed");
+static_assert(sizeof(Shape::GpuVertex) == 28, "GpuVertex must be packed");
+static_assert(sizeof(Header) == 88 && sizeof(LayerRecord) == 32 && sizeof(ObjectRecord) == 200 &&
+                  sizeof(ShapeRecord) == 312 && sizeof(NodeRecord) == 96,
+              "records must not have padding");
+
+// Shortest records a reader accepts, those of minor version 0.
+const size_t kMinObjectRecordSize = offsetof(ObjectRecord, lod_sizes);
+const size_t kMinShapeRecordSize = offsetof(ShapeRecord, lod_level);
+
+// Sequential writer of aligned arrays.
+class Writer {
+   public:
+    explicit Writer(QIODevice* device) : device_(device) {}
+
+    bool ok() const { return ok_; }
+    uint64_t position() const { return position_; }
+
+    Span write(const void* data, size_t count, size_t size, size_t alignment = kAlignment) {
+        Span span = {0, count};
+        if (count == 0) return span;
+        pad(alignment);
+        span.offset = position_;
+        put(data, count * size);
+        return span;
+    }
+
+    template <typename T>
+    Span write(const std::vector<T>& values) {
+        return write(values.data(), values.size(), sizeof(T));
+    }
+
+    Span write(const std::string& text) { return write(text.data(), text.size(), 1, 1); }
+
+    void pad(size_t alignment) {
+        static const char kZeros[kAlignment] = {};
+        put(kZeros, static_cast<size_t>((alignment - position_ % alignment) % alignment));
+    }
+
+    void put(const void* data, size_t bytes) {
+        if (!ok_ || bytes == 0) return;
+        ok_ = device_->write(static_cast<const char*>(data), static_cast<qint64>(bytes)) == static_cast<qint64>(bytes);
+        position_ += bytes;
+    }
+
+   private:
+    QIODevice* device_;
+    uint64_t position_ = 0;
+    bool ok_ = true;
+};
+
+void copyVec3(const Vec3& v, double out[3]) {
+    out[0] = v.x;
+    out[1] = v.y;
+    out[2] = v.z;
+}
+
+void copyQuaternion(const Quaternion& q, double out[4]) {
+    out[0] = q.x;
+    out[1] = q.y;
+    out[2] = q.z;
+    out[3] = q.w;
+}
+
+// First prototype record written for each instanced mesh.
+typedef std::unordered_map<const void*, uint64_t> MeshRecords;
+
+// Fill shapes[slot]; prototypes of instanced shapes are appended after the slots reserved so far,
+// once per mesh.
+void writeShape(Writer& out, std::vector<ShapeRecord>& shapes, MeshRecords& meshes, const Shape& shape,
+                size_t slot) {
+    ShapeRecord record = {};
+    record.type = static_cast<uint32_t>(shape.type());
+    record.width = shape.width();
+    record.transparency = shape.transparency();
+    copyVec3(shape.color(), record.color);
+    record.points = out.write(shape.points());
+    record.colors = out.write(shape.colors());
+    if (shape.isPacked()) {
+        record.flags |= kShapePacked;
+        record.packed = out.write(shape.packedVertices());
+    }
+    record.holes = out.write(std::vector<uint64_t>(shape.holes().begin(), shape.holes().end()));
+    record.triangles = out.write(shape.triangles());
+    record.lod_level = static_cast<uint32_t>(shape.lodLevel() + 1);
+
+    if (auto quad = dynamic_cast<const TexturedQuad*>(&shape)) {
+        record.texture_path = out.write(quad->texturePath());
+        if (quad->textureMipmaps()) record.flags |= kShapeMipmaps;
+        record.quad_size[0] = quad->quadWidth();
+        record.quad_size[1] = quad->quadHeight();
+        for (size_t i = 0; i < 4; ++i) {
+            record.uvs[i * 2] = quad->uvs()[i].u;
+            record.uvs[i * 2 + 1] = quad->uvs()[i].v;
+        }
+    } else if (auto instanced = dynamic_cast<const InstancedShape*>(&shape)) {
+        const auto& prototype = instanced->prototype();
+        if (instanced->isReference()) record.flags |= kShapeReference;
+        record.prototype_count = prototype.size();
+        auto written = meshes.find(instanced->mesh().get());
+        if (written != meshes.end()) {
+            record.first_prototype = written->second;
+        } else {
+            record.first_prototype = shapes.size();
+            meshes.emplace(instanced->mesh().get(), record.first_prototype);
+            shapes.resize(shapes.size() + prototype.size());
+            for (size_t i = 0; i < prototype.size(); ++i) {
+                writeShape(out, shapes, meshes, *prototype[i], static_cast<size_t>(record.first_prototype) + i);
+            }
+        }
+        record.positions = out.write(instanced->positions());
+        record.orientations = out.write(instanced->orientations());
+        record.scales = out.write(instanced->scales());
+        record.instance_colors = out.write(instanced->instanceColors());
+    } else {
+        if (auto cloud = dynamic_cast<const PointCloudShape*>(&shape)) {
+            std::vector<NodeRecord> nodes(cloud->nodes().size());
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                const PointCloudShape::Node& node = cloud->nodes()[i];
+                copyVec3(node.bounds.min, nodes[i].min);
+                copyVec3(node.bounds.max, nodes[i].max);
+                nodes[i].valid = node.bounds.valid ? 1 : 0;
+                nodes[i].first = node.first;
+                nodes[i].count = node.count;
+                nodes[i].subtree_count = node.subtreeCount;
+                std::copy(node.children, node.children + 8, nodes[i].children);
+            }
+            record.nodes = out.write(nodes);
+        }
+        if (!shape.isPacked() && !shape.points().empty()) {
+            std::vector<Shape::GpuVertex> baked;
+            shape.bakeVertices(baked);
+            record.baked = out.write(baked);
+        }
+    }
+    shapes[slot] = record;
+}
+
+// Read-only mapping of a snapshot file, kept while shapes still have to upload from it.
+struct MappedFile {
+    QFile file;
+    const uchar* data = nullptr;
+    uint64_t size = 0;
+};
+
+class SnapshotReader {
+   public:
+    bool open(std::shared_ptr<const void> storage, const uchar* data, uint64_t size, std::string* error);
+
+    uint64_t objectCount() const { return header_.object_count; }
+    uint64_t layerCount() const { return header_.layer_count; }
+
+    bool layer(uint64_t index, std::string* id, uint64_t* first_object, uint64_t* object_count) const;
+
+    // Frozen object, posed as saved; null if its records are out of range.
+    Object::Ptr buildObject(uint64_t index) const;
+
+   private:
+    Shape::Ptr buildShape(uint64_t index, int depth) const;
+    InstancedShape::Mesh buildMesh(uint64_t first, uint64_t count) const;
+    void attachBakedVertices(const ShapeRecord& record, Shape& shape) const;
+
+    // The nth record of a table; fields appended by newer minor versions are skipped by the stride,
+    // fields missing from older ones are zero.
+    template <typename R>
+    void record(uint64_t table, uint32_t stride, uint64_t index, R* out) const {
+        *out = R{};
+        std::memcpy(out, data_ + table + index * stride, std::min<size_t>(stride, sizeof(R)));
+    }
+
+    // Typed view of an array; false if it lies outside the file or is misaligned for T.
+    template <typename T>
+    bool view(const Span& span, const T** data) const {
+        *data = nullptr;
+        if (span.count == 0) return true;
+        if (span.offset % alignof(T) != 0 || span.offset > size_ || span.count > (size_ - span.offset) / sizeof(T)) {
+            return false;
+        }
+        *data = reinterpret_cast<const T*>(data_ + span.offset);
+        return true;
+    }
+
+    template <typename T>
+    bool copy(const Span& span, std::vector<T>* values) const {
+        const T* data = nullptr;
+        if (!view(span, &data)) return false;
+        values->resize(static_cast<size_t>(span.count));
+        if (data) std::memcpy(values->data(), data, values->size() * sizeof(T));
+        return true;
+    }
+
+    bool string(const Span& span, std::string* text) const {
+        const char* data = nullptr;
+        if (!view(span, &data)) return false;
+        text->assign(data ? data : "", static_cast<size_t>(span.count));
+        return true;
+    }
+
+    bool fits(uint64_t offset, uint64_t count, uint32_t stride) const {
+        return offset <= size_ && offset % 8 == 0 && count <= (size_ - offset) / stride;
+    }
+
+    std::shared_ptr<const void> storage_;  // Keeps data_ valid
+    const uchar* data_ = nullptr;
+    uint64_t size_ = 0;
+    Header header_ = {};
+
+    // Meshes of references by first prototype record, built once and shared; objects build in parallel.
+    mutable std::mutex meshes_mutex_;
+    mutable std::unordered_map<uint64_t, InstancedShape::Mesh> meshes_;
+};
+
+bool SnapshotReader::open(std::shared_ptr<const void> storage, const uchar* data, uint64_t size,
+                          std::string* error) {
+    if (size < sizeof(Header) || std::memcmp(data, kMagic, sizeof(kMagic)) != 0) {
+        *error = "not a scene snapshot";
+        return false;
+    }
+    storage_ = std::move(storage);
+    data_ = data;
+    size_ = size;
+
+    std::memcpy(&header_, data_, sizeof(Header));
+    if (header_.byte_order != kByteOrder) {
+        *error = "written on a machine of the other byte order";
+        return false;
+    }
+    if (header_.major_version != kMajorVersion) {
+        *error = "unsupported snapshot version " + std::to_string(header_.major_version) + "." +
+                 std::to_string(header_.minor_version);
+        return false;
+    }
+    if (header_.header_size < sizeof(Header) || header_.layer_record_size < sizeof(LayerRecord) ||
+        header_.object_record_size < kMinObjectRecordSize || header_.shape_record_size < kMinShapeRecordSize ||
+        !fits(header_.layers_offset, header_.layer_count, header_.layer_record_size) ||
+        !fits(header_.objects_offset, header_.object_count, header_.object_record_size) ||
+        !fits(header_.shapes_offset, header_.shape_count, header_.shape_record_size)) {
+        *error = "truncated or damaged snapshot";
+        return false;
+    }
+    return true;
+}
+
+bool SnapshotReader::layer(uint64_t index, std::string* id, uint64_t* first_object, uint64_t* object_count) const {
+    LayerRecord r;
+    record(header_.layers_offset, header_.layer_record_size, index, &r);
+    if (r.object_count > header_.object_count || r.first_object > header_.object_count - r.object_count) {
+        return false;
+    }
+    *first_object = r.first_object;
+    *object_count = r.object_count;
+    return string(r.id, id);
+}
+
+Object::Ptr SnapshotReader::buildObject(uint64_t index) const {
+    ObjectRecord r;
+    record(header_.objects_offset, header_.object_record_size, index, &r);
+    std::string id, info;
+    if (!string(r.id, &id) || !string(r.info, &info) || r.shape_count > header_.shape_count ||
+        r.first_shape > header_.shape_count - r.shape_count) {
+        return nullptr;
+    }
+
+    std::vector<float> lod_sizes;
+    if (!copy(r.lod_sizes, &lod_sizes)) return nullptr;
+
+    auto object = std::make_shared<Object>(id);
+    object->setInfo(info, Vec3(r.text_color[0], r.text_color[1], r.text_color[2]));
+    object->setLodSizes(lod_sizes);
+    for (uint32_t i = 0; i < r.shape_count; ++i) {
+        Shape::Ptr shape = buildShape(r.first_shape + i, 0);
+        if (!shape) return nullptr;
+        object->addShape(std::move(shape));
+    }
+    object->setBuiltPose(Vec3(r.position[0], r.position[1], r.position[2]),
+                         Quaternion(r.orientation[0], r.orientation[1], r.orientation[2], r.orientation[3]));
+    object->setInEditable();
+    if (r.flags & kObjectPosed) {
+        object->setPose(Vec3(r.pose_position[0], r.pose_position[1], r.pose_position[2]),
+                        Quaternion(r.pose_orientation[0], r.pose_orientation[1], r.pose_orientation[2],
+                                   r.pose_orientation[3]));
+    }
+    return object;
+}
+
+Shape::Ptr SnapshotReader::buildShape(uint64_t index, int depth) const {
+    ShapeRecord r;
+    record(header_.shapes_offset, header_.shape_record_size, index, &r);
+    if (r.type > Shape::PointCloud) return nullptr;
+    const auto type = static_cast<Shape::ShapeType>(r.type);
+    const Vec3 color(r.color[0], r.color[1], r.color[2]);
+
+    if (type == Shape::TexturedQuad) {
+        auto quad = std::make_shared<TexturedQuad>(r.quad_size[0], r.quad_size[1]);
+        std::array<TexturedQuad::UV, 4> uvs;
+        for (size_t i = 0; i < 4; ++i) {
+            uvs[i] = {r.uvs[i * 2], r.uvs[i * 2 + 1]};
+        }
+        quad->setUVs(uvs);
+        quad->setTransparency(r.transparency);
+        quad->setLodLevel(static_cast<int>(r.lod_level) - 1);
+        std::string path;
+        if (!string(r.texture_path, &path)) return nullptr;
+        // A texture file that went missing leaves the quad untextured; the quad reports it.
+        if (!path.empty()) quad->loadTextureFromFile(path, (r.flags & kShapeMipmaps) != 0);
+        quad->setInEditable();
+        return quad;
+    }
+
+    if (type == Shape::Instanced) {
+        // Prototypes are plain shapes, which also rules out cycles.
+        if (depth > 0 || r.prototype_count > header_.shape_count ||
+            r.first_prototype > header_.shape_count - r.prototype_count) {
+            return nullptr;
+        }
+        std::vector<Vec3> positions, scales, colors;
+        std::vector<Quaternion> orientations;
+        if (!copy(r.positions, &positions) || !copy(r.orientations, &orientations) || !copy(r.scales, &scales) ||
+            !copy(r.instance_colors, &colors)) {
+            return nullptr;
+        }
+        if (r.flags & kShapeReference) {
+            if (positions.size() != 1 || orientations.size() != 1 || scales.size() != 1 || colors.size() != 1) {
+                return nullptr;
+            }
+            InstancedShape::Mesh mesh = buildMesh(r.first_prototype, r.prototype_count);
+            if (!mesh) return nullptr;
+            auto reference = InstancedShape::reference(mesh, positions[0], orientations[0], scales[0], colors[0]);
+            reference->setLodLevel(static_cast<int>(r.lod_level) - 1);
+            reference->setInEditable();
+            return reference;
+        }
+        std::vector<Shape::Ptr> prototype;
+        for (uint64_t i = 0; i < r.prototype_count; ++i) {
+            Shape::Ptr shape = buildShape(r.first_prototype + i, depth + 1);
+            if (!shape) return nullptr;
+            prototype.push_back(std::move(shape));
+        }
+        auto instanced = std::make_shared<InstancedShape>(prototype, positions, orientations, scales, colors);
+        instanced->setLodLevel(static_cast<int>(r.lod_level) - 1);
+        instanced->setInEditable();
+        // The instanced shape holds clones of the prototypes, which upload from the mapping as well.
+        for (uint64_t i = 0; i < r.prototype_count; ++i) {
+            ShapeRecord prototype_record;
+            record(header_.shapes_offset, header_.shape_record_size, r.first_prototype + i, &prototype_record);
+            attachBakedVertices(prototype_record, *instanced->prototype()[static_cast<size_t>(i)]);
+        }
+        return instanced;
+    }
+
+    Shape::Ptr shape;
+    if (type == Shape::PointCloud) {
+        shape = std::make_shared<PointCloudShape>(r.width);
+        shape->setTransparency(r.transparency);
+    } else {
+        shape = std::make_shared<Shape>(type, r.width, r.transparency);
+    }
+
+    std::vector<Vec3> points, colors;
+    std::vector<uint64_t> holes;
+    std::vector<uint32_t> triangles;
+    if (!copy(r.points, &points) || !copy(r.colors, &colors) || !copy(r.holes, &holes) ||
+        !copy(r.triangles, &triangles)) {
+        return nullptr;
+    }
+    // The single color stays the fallback for points beyond the per-point colors.
+    shape->setPointsWithColor(std::vector<Vec3>(), color);
+    if (!colors.empty()) {
+        shape->setPointsWithColor(points, colors);
+    } else if (!points.empty()) {
+        shape->setPointsWithColor(points, color);
+    }
+    if (r.flags & kShapePacked) {
+        std::vector<PackedVertex> packed;
+        if (!copy(r.packed, &packed)) return nullptr;
+        shape->setPackedVertices(std::move(packed));
+    }
+    shape->setHoles(std::vector<size_t>(holes.begin(), holes.end()));
+
+    const size_t vertex_count = shape->vertexCount();
+    for (uint32_t vertex : triangles) {
+        if (vertex >= vertex_count) return nullptr;
+    }
+    shape->setTriangles(std::move(triangles));
+    shape->setLodLevel(static_cast<int>(r.lod_level) - 1);
+
+    if (r.nodes.count > 0) {
+        auto cloud = std::dynamic_pointer_cast<PointCloudShape>(shape);
+        std::vector<NodeRecord> records;
+        if (!cloud || !copy(r.nodes, &records)) return nullptr;
+        std::vector<PointCloudShape::Node> nodes(records.size());
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            const NodeRecord& node = records[i];
+            nodes[i].bounds.min = Vec3(node.min[0], node.min[1], node.min[2]);
+            nodes[i].bounds.max = Vec3(node.max[0], node.max[1], node.max[2]);
+            nodes[i].bounds.valid = node.valid != 0;
+            nodes[i].first = node.first;
+            nodes[i].count = node.count;
+            nodes[i].subtreeCount = node.subtree_count;
+            std::copy(node.children, node.children + 8, nodes[i].children);
+        }
+        if (!cloud->restoreOctree(std::move(nodes))) return nullptr;
+    }
+
+    shape->setInEditable();
+    attachBakedVertices(r, *shape);
+    return shape;
+}
+
+InstancedShape::Mesh SnapshotReader::buildMesh(uint64_t first, uint64_t count) const {
+    std::lock_guard<std::mutex> lock(meshes_mutex_);
+    auto it = meshes_.find(first);
+    if (it != meshes_.end()) return it->second->size() == count ? it->second : nullptr;
+
+    auto mesh = std::make_shared<std::vector<Shape::Ptr>>();
+    for (uint64_t i = 0; i < count; ++i) {
+        Shape::Ptr shape = buildShape(first + i, 1);
+        if (!shape) return nullptr;
+        mesh->push_back(std::move(shape));
+    }
+    meshes_.emplace(first, mesh);
+    return mesh;
+}
+
+void SnapshotReader::attachBakedVertices(const ShapeRecord& record, Shape& shape) const {
+    // Without storage data is only valid during the call; the shapes bake their vertices again.
+    const Shape::GpuVertex* baked = nullptr;
+    if (storage_ && view(record.baked, &baked) && baked && record.baked.count == shape.points().size()) {
+        shape.setBakedVertices(storage_, baked);
+    }
+}
+
+}  // namespace
+
+bool writeSnapshot(QIODevice* device, const std::vector<SnapshotLayer>& layers) {
+    // Data first, then the record tables pointing into it, then the header is rewritten in front.
+    Header header = {};
+    Writer out(device);
+    out.put(&header, sizeof(header));
+
+    std::vector<LayerRecord> layer_records;
+    std::vector<ObjectRecord> object_records;
+    std::vector<ShapeRecord> shape_records;
+    std::vector<const Shape*> shapes;
+    MeshRecords meshes;
+    for (const SnapshotLayer& layer : layers) {
+        LayerRecord layer_record = {};
+        layer_record.id = out.write(layer.id);
+        layer_record.first_object = object_records.size();
+
+        for (const auto& object : layer.objects) {
+            if (!object) continue;
+            ObjectRecord record = {};
+            record.id = out.write(object->id());
+            record.info = out.write(object->info());
+            copyVec3(object->textColor(), record.text_color);
+            copyVec3(object->builtPosition(), record.position);
+            copyQuaternion(object->builtOrientation(), record.orientation);
+            record.lod_sizes = out.write(object->lodSizes());
+            if (object->isPosed()) {
+                record.flags |= kObjectPosed;
+                copyVec3(object->position(), record.pose_position);
+                copyQuaternion(object->orientation(), record.pose_orientation);
+            }
+
+            // Trajectories are live state of their producer and are not saved.
+            shapes.clear();
+            for (const auto& shape : object->shapes()) {
+                if (shape && shape->type() != Shape::Trajectory) shapes.push_back(shape.get());
+            }
+            record.first_shape = shape_records.size();
+            record.shape_count = static_cast<uint32_t>(shapes.size());
+            shape_records.resize(shape_records.size() + shapes.size());
+            for (size_t i = 0; i < shapes.size(); ++i) {
+                writeShape(out, shape_records, meshes, *shapes[i], static_cast<size_t>(record.first_shape) + i);
+            }
+            object_records.push_back(record);
+        }
+        layer_record.object_count = object_records.size() - layer_record.first_object;
+        layer_records.push_back(layer_record);
+    }
+
+    out.pad(kAlignment);
+    header.layers_offset = out.position();
+    out.put(layer_records.data(), layer_records.size() * sizeof(LayerRecord));
+    header.objects_offset = out.position();
+    out.put(object_records.data(), object_records.size() * sizeof(ObjectRecord));
+    header.shapes_offset = out.position();
+    out.put(shape_records.data(), shape_records.size() * sizeof(ShapeRecord));
+    const uint64_t end = out.position();
+
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.byte_order = kByteOrder;
+    header.major_version = kMajorVersion;
+    header.minor_version = kMinorVersion;
+    header.header_size = sizeof(Header);
+    header.layer_record_size = sizeof(LayerRecord);
+    header.object_record_size = sizeof(ObjectRecord);
+    header.shape_record_size = sizeof(ShapeRecord);
+    header.layer_count = layer_records.size();
+    header.object_count = object_records.size();
+    header.shape_count = shape_records.size();
+
+    return out.ok() && device->seek(0) &&
+           device->write(reinterpret_cast<const char*>(&header), sizeof(header)) ==
+               static_cast<qint64>(sizeof(header)) &&
+           device->seek(static_cast<qint64>(end));
+}
+
+bool readSnapshot(std::shared_ptr<const void> storage, const uchar* data, size_t size,
+                  std::vector<SnapshotLayer>* layers, std::string* error, WorkerPool* pool) {
+    SnapshotReader reader;
+    if (!reader.open(std::move(storage), data, size, error)) return false;
+
+    struct LayerRange {
+        uint64_t first;
+        uint64_t count;
+    };
+    std::vector<SnapshotLayer> result(static_cast<size_t>(reader.layerCount()));
+    std::vector<LayerRange> ranges(result.size());
+    for (size_t i = 0; i < result.size(); ++i) {
+        if (!reader.layer(i, &result[i].id, &ranges[i].first, &ranges[i].count)) {
+            *error = "bad layer record " + std::to_string(i);
+            return false;
+        }
+    }
+
+    // Every object is built and frozen before any is handed out.
+    std::vector<Object::Ptr> objects(static_cast<size_t>(reader.objectCount()));
+    std::atomic<size_t> bad_object{objects.size()};
+    auto build = [&](size_t i) {
+        if (bad_object.load(std::memory_order_relaxed) != objects.size()) return;
+        objects[i] = reader.buildObject(i);
+        if (!objects[i]) bad_object.store(i, std::memory_order_relaxed);
+    };
+    if (pool) {
+        pool->parallelFor(objects.size(), build);
+    } else {
+        for (size_t i = 0; i < objects.size(); ++i) build(i);
+    }
+    if (bad_object.load() != objects.size()) {
+        *error = "bad data in object record " + std::to_string(bad_object.load());
+        return false;
+    }
+
+    for (size_t i = 0; i < result.size(); ++i) {
+        const auto begin = objects.begin() + static_cast<std::ptrdiff_t>(ranges[i].first);
+        result[i].objects.assign(begin, begin + static_cast<std::ptrdiff_t>(ranges[i].count));
+    }
+    *layers = std::move(result);
+    return true;
+}
+
+bool saveSceneSnapshot(ObjectManager& manager, const std::string& path, std::string* error) {
+    // Sorted by id, so equal scenes give equal files.
+    std::vector<SnapshotLayer> layers;
+    for (const auto& entry : *manager.layersSnapshot()) {
+        SnapshotLayer layer;
+        layer.id = entry.first;
+        for (const auto& object : entry.second->snapshot()->objects) {
+            if (object.second) layer.objects.push_back(object.second);
+        }
+        std::sort(layer.objects.begin(), layer.objects.end(),
+                  [](const Object::Ptr& a, const Object::Ptr& b) { return a->id() < b->id(); });
+        layers.push_back(std::move(layer));
+    }
+    std::sort(layers.begin(), layers.end(),
+              [](const SnapshotLayer& a, const SnapshotLayer& b) { return a.id < b.id; });
+
+    QSaveFile file(QString::fromStdString(path));
+    if (!file.open(QIODevice::WriteOnly)) {
+        *error = "cannot open " + path + " for writing";
+        return false;
+    }
+    if (!writeSnapshot(&file, layers) || !file.commit()) {
+        *error = "failed to write " + path;
+        return false;
+    }
+    return true;
+}
+
+bool loadSceneSnapshot(ObjectManager& manager, const std::string& path, std::string* error) {
+    auto mapped = std::make_shared<MappedFile>();
+    mapped->file.setFileName(QString::fromStdString(path));
+    if (!mapped->file.open(QIODevice::ReadOnly)) {
+        *error = "cannot open " + path;
+        return false;
+    }
+    const qint64 size = mapped->file.size();
+    mapped->data = size > 0 ? mapped->file.map(0, size) : nullptr;
+    if (!mapped->data) {
+        *error = size > 0 ? "cannot map " + path : path + ": not a scene snapshot";
+        return false;
+    }
+    mapped->size = static_cast<uint64_t>(size);
+
+    std::vector<SnapshotLayer> layers;
+    WorkerPool pool;
+    const uchar* data = mapped->data;
+    if (!readSnapshot(std::move(mapped), data, static_cast<size_t>(size), &layers, error, &pool)) {
+        *error = path + ": " + *error;
+        return false;
+    }
+    for (const SnapshotLayer& layer : layers) {
+        manager.submitLayer(layer.objects, layer.id);
+    }
+    return true;
+}
+
+}  // namespace octo_flex
@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SCENE_SNAPSHOT_H
+#define SCENE_SNAPSHOT_H
+
+#include <QIODevice>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "object_manager.h"
+
+namespace octo_flex {
+
+class WorkerPool;
+
+// Versioned binary snapshot of a scene: every layer with its objects, shapes, poses, packed vertex
+// data, polygon triangulations, point cloud octrees, instances and the files textures were loaded
+// from. Arrays are stored raw and aligned, so a snapshot is loaded through a memory mapping: vertex
+// data is uploaded to GPU buffers straight from the mapped pages and nothing is triangulated, baked
+// or sorted again. Files are little-endian and use IEEE doubles; they are portable between machines
+// of that kind (x86-64, ARM64), and readers accept newer minor versions by record size.
+// Textures given as images and dynamic textures are not part of a snapshot; their quads are saved
+// without a texture. Both return false and set error on failure.
+bool saveSceneSnapshot(ObjectManager& manager, const std::string& path, std::string* error);
+
+// Layers in the file replace the manager's layers of the same name as a whole; other layers are
+// kept. Nothing is submitted unless the whole file is valid.
+bool loadSceneSnapshot(ObjectManager& manager, const std::string& path, std::string* error);
+
+// Objects of one layer, as written to and read from a snapshot.
+struct SnapshotLayer {
+    std::string id;
+    std::vector<Object::Ptr> objects;
+};
+
+// Write frozen objects in the snapshot format to a seekable device, starting at its position 0; the
+// snapshot files and scene updates both use it. Null objects and shapes are skipped.
+bool writeSnapshot(QIODevice* device, const std::vector<SnapshotLayer>& layers);
+
+// Decode a snapshot of size bytes at data, which must be 16-byte aligned. The objects come back frozen
+// and posed as saved; shapes upload their vertices from data, which storage keeps valid. With null
+// storage everything is copied before returning. Objects are built on pool when given. Nothing is
+// returned unless the whole snapshot is valid.
+bool readSnapshot(std::shared_ptr<const void> storage, const uchar* data, size_t size,
+                  std::vector<SnapshotLayer>* layers, std::string* error, WorkerPool* pool = nullptr);
+
+}  // namespace octo_flex
+
+#endif  // SCENE_SNAPSHOT_H
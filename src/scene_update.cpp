@@ -0,0 +1,126 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "scene_update.h"
+
+#include <cstring>
+#include <unordered_set>
+
+namespace octo_flex {
+
+bool writeSceneUpdate(QIODevice* device, const SceneUpdate& update, uint64_t* blob_size) {
+    *blob_size = 0;
+    if (update.kind == kUpdateKeyframe) {
+        if (!writeSnapshot(device, update.layers)) return false;
+    } else if (update.kind == kUpdateUpsert || update.kind == kUpdateReplaceLayer || update.kind == kUpdateDelta) {
+        if (!writeSnapshot(device, {SnapshotLayer{update.id, update.objects}})) return false;
+    }
+    *blob_size = static_cast<uint64_t>(device->pos());
+
+    auto put = [device](const void* data, size_t size) {
+        return device->write(static_cast<const char*>(data), static_cast<qint64>(size)) == static_cast<qint64>(size);
+    };
+    if (update.kind == kUpdateDelta) {
+        for (const std::string& id : update.removed_ids) {
+            const uint32_t length = static_cast<uint32_t>(id.size());
+            if (!put(&length, sizeof(length)) || !put(id.data(), id.size())) return false;
+        }
+    } else if (update.kind == kUpdatePose) {
+        const ScenePoseRecord record = {
+            {update.position.x, update.position.y, update.position.z},
+            {update.orientation.x, update.orientation.y, update.orientation.z, update.orientation.w}};
+        if (!put(&record, sizeof(record)) || !put(update.id.data(), update.id.size())) return false;
+    }
+    return true;
+}
+
+bool applySceneUpdate(ObjectManager& manager, uint32_t kind, const uchar* payload, uint64_t payload_size,
+                      uint64_t blob_size, std::shared_ptr<const void> storage, WorkerPool* pool, std::string* error) {
+    if (blob_size > payload_size) {
+        *error = "bad update size";
+        return false;
+    }
+
+    std::vector<SnapshotLayer> layers;
+    if (kind == kUpdateKeyframe || kind == kUpdateUpsert || kind == kUpdateReplaceLayer || kind == kUpdateDelta) {
+        if (!readSnapshot(std::move(storage), payload, static_cast<size_t>(blob_size), &layers, error, pool)) {
+            return false;
+        }
+        if (kind != kUpdateKeyframe && layers.size() != 1) {
+            *error = "expected one layer";
+            return false;
+        }
+    }
+
+    switch (kind) {
+        case kUpdateKeyframe: {
+            std::unordered_set<std::string> kept;
+            for (const SnapshotLayer& layer : layers) {
+                manager.submitLayer(layer.objects, layer.id);
+                kept.insert(layer.id);
+            }
+            // Layers the keyframe does not hold did not exist yet.
+            for (const auto& layer : *manager.layersSnapshot()) {
+                if (!kept.count(layer.first) && !layer.second->snapshot()->objects.empty()) {
+                    manager.submitLayer({}, layer.first);
+                }
+            }
+            return true;
+        }
+        case kUpdateUpsert:
+            manager.submitLayerDelta(layers[0].objects, {}, layers[0].id);
+            return true;
+        case kUpdateReplaceLayer:
+            manager.submitLayer(layers[0].objects, layers[0].id);
+            return true;
+        case kUpdateDelta: {
+            std::vector<std::string> removed;
+            uint64_t offset = blob_size;
+            while (payload_size - offset >= sizeof(uint32_t)) {
+                uint32_t length;
+                std::memcpy(&length, payload + offset, sizeof(length));
+                offset += sizeof(length);
+                if (length > payload_size - offset) {
+                    *error = "bad removed id";
+                    return false;
+                }
+                removed.emplace_back(reinterpret_cast<const char*>(payload + offset), length);
+                offset += length;
+            }
+            manager.submitLayerDelta(layers[0].objects, removed, layers[0].id);
+            return true;
+        }
+        case kUpdatePose: {
+            ScenePoseRecord record;
+            if (payload_size < sizeof(record)) {
+                *error = "bad pose";
+                return false;
+            }
+            std::memcpy(&record, payload, sizeof(record));
+            const std::string id(reinterpret_cast<const char*>(payload + sizeof(record)),
+                                 static_cast<size_t>(payload_size - sizeof(record)));
+            // An object that is gone has no pose to update; that is not damage.
+            manager.updatePose(id, Vec3(record.position[0], record.position[1], record.position[2]),
+                               Quaternion(record.orientation[0], record.orientation[1], record.orientation[2],
+                                          record.orientation[3]));
+            return true;
+        }
+        default:
+            return true;
+    }
+}
+
+}  // namespace octo_flex
@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SCENE_UPDATE_H
+#define SCENE_UPDATE_H
+
+#include <QIODevice>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "object_manager.h"
+#include "scene_snapshot.h"
+
+namespace octo_flex {
+
+class WorkerPool;
+
+// Scene updates as stored by submission logs and carried by shared scene channels. Updates with
+// objects start with a snapshot of blob_size bytes (see scene_snapshot.h); deltas follow it with the
+// removed ids, a uint32_t length and the bytes each; poses are a ScenePoseRecord and the object id.
+enum SceneUpdateKind : uint32_t {
+    kUpdateKeyframe = 1,  // Every layer of the scene
+    kUpdateUpsert,        // Objects added to or replacing objects of the one layer in the snapshot
+    kUpdateReplaceLayer,  // All objects of the one layer in the snapshot
+    kUpdateDelta,         // Upserts as kUpdateUpsert, then the removed ids
+    kUpdatePose,          // New pose of one object
+    kUpdateFrame,         // A view started a frame after the updates before; no payload
+};
+
+struct ScenePoseRecord {
+    double position[3];
+    double orientation[4];
+};
+static_assert(sizeof(ScenePoseRecord) == 56, "pose records must not have padding");
+
+struct SceneUpdate {
+    uint32_t kind = 0;
+    std::string id;  // Layer, or object for poses
+    std::vector<Object::Ptr> objects;
+    std::vector<std::string> removed_ids;
+    std::vector<SnapshotLayer> layers;  // Keyframes
+    Vec3 position;
+    Quaternion orientation;
+};
+
+// Encode an update to a seekable device from its position 0; blob_size receives the snapshot part.
+bool writeSceneUpdate(QIODevice* device, const SceneUpdate& update, uint64_t* blob_size);
+
+// Apply an encoded update to a manager as it was submitted. Keyframes replace every layer and empty
+// the layers they do not hold. storage keeps the payload valid for shapes uploading from it; null
+// copies everything before returning. Objects are built on pool when given. Frames and unknown kinds
+// change nothing. Returns false and sets error if the payload is damaged.
+bool applySceneUpdate(ObjectManager& manager, uint32_t kind, const uchar* payload, uint64_t payload_size,
+                      uint64_t blob_size, std::shared_ptr<const void> storage, WorkerPool* pool, std::string* error);
+
+}  // namespace octo_flex
+
+#endif  // SCENE_UPDATE_H
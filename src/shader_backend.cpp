@@ -0,0 +1,443 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "shader_backend.h"
+#include <QtDebug>
+#include <algorithm>
+#include <cstddef>
+#include <glm/gtc/type_ptr.hpp>
+#include "shape.h"
+
+namespace octo_flex {
+namespace {
+
+// Attribute locations shared by all programs.
+const GLuint kAttrPosition = 0;
+const GLuint kAttrColor = 1;
+const GLuint kAttrTexCoord = 2;
+const GLuint kAttrScalar = 3;
+
+// Prepended to every stage: GLSL 1.50 on desktop core profiles, GLSL ES 3.20 on OpenGL ES.
+const char* kDesktopHeader = "#version 150\n";
+const char* kEsHeader = "#version 320 es\nprecision highp float;\n";
+
+// Vertex colors, or one uniform color (pick IDs, instance colors) when u_use_color is 1. With
+// u_use_scalar at 1 the color is looked up in the colormap at the vertex's scalar instead, mapped to
+// a texture coordinate by u_scalar_map (scale, offset), and modulated by u_color.
+const char* kVertexShader = R"(
+in vec3 a_position;
+in vec4 a_color;
+in float a_scalar;
+uniform mat4 u_model_view_projection;
+uniform vec4 u_color;
+uniform float u_use_color;
+uniform float u_use_scalar;
+uniform vec2 u_scalar_map;
+uniform sampler2D u_colormap;
+uniform float u_point_size;
+out vec4 v_color;
+void main() {
+    gl_Position = u_model_view_projection * vec4(a_position, 1.0);
+    gl_PointSize = u_point_size;
+    v_color = mix(a_color, u_color, u_use_color);
+    if (u_use_scalar > 0.5) {
+        vec2 uv = vec2(a_scalar * u_scalar_map.x + u_scalar_map.y, 0.5);
+        v_color = textureLod(u_colormap, uv, 0.0) * u_color;
+    }
+}
+)";
+
+const char* kFragmentShader = R"(
+in vec4 v_color;
+out vec4 o_color;
+void main() {
+    o_color = v_color;
+}
+)";
+
+// Each segment becomes a quad u_line_width pixels wide. g_dash carries the pixel distance from the
+// segment start premultiplied by w, with w itself, so the fragment stage recovers a distance that is
+// linear in screen space (noperspective is not available on OpenGL ES).
+const char* kLineGeometryShader = R"(
+layout(lines) in;
+layout(triangle_strip, max_vertices = 4) out;
+in vec4 v_color[];
+uniform vec2 u_viewport;
+uniform float u_line_width;
+out vec4 g_color;
+out vec2 g_dash;
+void main() {
+    vec4 p0 = gl_in[0].gl_Position;
+    vec4 p1 = gl_in[1].gl_Position;
+    vec4 c0 = v_color[0];
+    vec4 c1 = v_color[1];
+
+    // Clip to the near plane so both ends project in front of the eye.
+    float d0 = p0.z + p0.w;
+    float d1 = p1.z + p1.w;
+    if (d0 < 0.0 && d1 < 0.0) return;
+    if (d0 < 0.0) {
+        float t = d0 / (d0 - d1);
+        p0 = mix(p0, p1, t);
+        c0 = mix(c0, c1, t);
+    } else if (d1 < 0.0) {
+        float t = d1 / (d1 - d0);
+        p1 = mix(p1, p0, t);
+        c1 = mix(c1, c0, t);
+    }
+
+    vec2 halfViewport = 0.5 * u_viewport;
+    vec2 s0 = p0.xy / p0.w * halfViewport;
+    vec2 s1 = p1.xy / p1.w * halfViewport;
+    float len = length(s1 - s0);
+    vec2 dir = len > 1e-6 ? (s1 - s0) / len : vec2(1.0, 0.0);
+    vec2 offset = vec2(-dir.y, dir.x) * (0.5 * u_line_width) / halfViewport;
+
+    g_color = c0;
+    g_dash = vec2(0.0, p0.w);
+    gl_Position = vec4(p0.xy + offset * p0.w, p0.zw);
+    EmitVertex();
+    gl_Position = vec4(p0.xy - offset * p0.w, p0.zw);
+    EmitVertex();
+    g_color = c1;
+    g_dash = vec2(len * p1.w, p1.w);
+    gl_Position = vec4(p1.xy + offset * p1.w, p1.zw);
+    EmitVertex();
+    gl_Position = vec4(p1.xy - offset * p1.w, p1.zw);
+    EmitVertex();
+    EndPrimitive();
+}
+)";
+
+// Dashes match glLineStipple(1, 0x00FF): 8 pixels on, 8 off, restarting at every segment.
+const char* kLineFragmentShader = R"(
+in vec4 g_color;
+in vec2 g_dash;
+uniform float u_dashed;
+out vec4 o_color;
+void main() {
+    if (u_dashed > 0.5 && mod(g_dash.x / g_dash.y, 16.0) >= 8.0) discard;
+    o_color = g_color;
+}
+)";
+
+const char* kTextureVertexShader = R"(
+in vec3 a_position;
+in vec2 a_uv;
+uniform mat4 u_model_view_projection;
+out vec2 v_uv;
+void main() {
+    gl_Position = u_model_view_projection * vec4(a_position, 1.0);
+    v_uv = a_uv;
+}
+)";
+
+// Texture modulated by the quad's transparency, as GL_MODULATE with glColor4f(1, 1, 1, alpha).
+const char* kTextureFragmentShader = R"(
+in vec2 v_uv;
+uniform sampler2D u_texture;
+uniform float u_alpha;
+out vec4 o_color;
+void main() {
+    o_color = texture(u_texture, v_uv) * vec4(1.0, 1.0, 1.0, u_alpha);
+}
+)";
+
+GLenum glPrimitive(RenderBackend::Primitive primitive) {
+    switch (primitive) {
+        case RenderBackend::Points:
+            return GL_POINTS;
+        case RenderBackend::Lines:
+            return GL_LINES;
+        case RenderBackend::LineLoop:
+            return GL_LINE_LOOP;
+        case RenderBackend::LineStrip:
+            return GL_LINE_STRIP;
+        case RenderBackend::TriangleFan:
+            return GL_TRIANGLE_FAN;
+        default:
+            return GL_TRIANGLES;
+    }
+}
+
+}  // namespace
+
+ShaderBackend::~ShaderBackend() { release(); }
+
+bool ShaderBackend::initialize(QOpenGLContext* context) {
+    release();
+    if (!context) return false;
+
+    const QSurfaceFormat format = context->format();
+    gles_ = context->isOpenGLES();
+    if (format.version() < qMakePair(3, 2) || !QOpenGLShader::hasOpenGLShaders(QOpenGLShader::Geometry, context)) {
+        qWarning() << "ShaderBackend: Needs OpenGL 3.2 or OpenGL ES 3.2 with geometry shaders, context is"
+                   << format.majorVersion() << "." << format.minorVersion();
+        return false;
+    }
+
+    context_ = context;
+    initializeOpenGLFunctions();
+
+    program_ = buildProgram(kVertexShader, nullptr, kFragmentShader, uniforms_);
+    line_program_ = buildProgram(kVertexShader, kLineGeometryShader, kLineFragmentShader, line_uniforms_);
+    texture_program_ = buildProgram(kTextureVertexShader, nullptr, kTextureFragmentShader, texture_uniforms_);
+    if (!program_ || !line_program_ || !texture_program_) {
+        release();
+        return false;
+    }
+
+    // Core profiles draw nothing without a vertex array object.
+    glGenVertexArrays(1, &vao_);
+    glGenBuffers(1, &stream_buffer_);
+    glGenBuffers(1, &stream_index_buffer_);
+    glBindVertexArray(vao_);
+    glEnableVertexAttribArray(kAttrPosition);
+    glEnableVertexAttribArray(kAttrColor);
+    glBindVertexArray(0);
+
+    if (!gles_) {
+        multi_draw_arrays_ = reinterpret_cast<MultiDrawArraysFn>(context->getProcAddress("glMultiDrawArrays"));
+    }
+    return true;
+}
+
+std::unique_ptr<QOpenGLShaderProgram> ShaderBackend::buildProgram(const char* vertex, const char* geometry,
+                                                                  const char* fragment, Uniforms& uniforms) {
+    const QByteArray header = gles_ ? kEsHeader : kDesktopHeader;
+    std::unique_ptr<QOpenGLShaderProgram> program(new QOpenGLShaderProgram());
+    bool compiled = program->addShaderFromSourceCode(QOpenGLShader::Vertex, header + vertex) &&
+                    program->addShaderFromSourceCode(QOpenGLShader::Fragment, header + fragment);
+    if (compiled && geometry) {
+        compiled = program->addShaderFromSourceCode(QOpenGLShader::Geometry, header + geometry);
+    }
+    program->bindAttributeLocation("a_position", kAttrPosition);
+    program->bindAttributeLocation("a_color", kAttrColor);
+    program->bindAttributeLocation("a_uv", kAttrTexCoord);
+    program->bindAttributeLocation("a_scalar", kAttrScalar);
+    if (!compiled || !program->link()) {
+        qWarning() << "ShaderBackend: Failed to build shader program:" << program->log();
+        return nullptr;
+    }
+
+    uniforms.modelViewProjection = program->uniformLocation("u_model_view_projection");
+    uniforms.color = program->uniformLocation("u_color");
+    uniforms.useColor = program->uniformLocation("u_use_color");
+    uniforms.pointSize = program->uniformLocation("u_point_size");
+    uniforms.viewport = program->uniformLocation("u_viewport");
+    uniforms.lineWidth = program->uniformLocation("u_line_width");
+    uniforms.dashed = program->uniformLocation("u_dashed");
+    uniforms.texture = program->uniformLocation("u_texture");
+    uniforms.alpha = program->uniformLocation("u_alpha");
+    uniforms.useScalar = program->uniformLocation("u_use_scalar");
+    uniforms.scalarMap = program->uniformLocation("u_scalar_map");
+    uniforms.colormap = program->uniformLocation("u_colormap");
+    return program;
+}
+
+void ShaderBackend::release() {
+    // Vertex arrays are not shared; the objects of a context that is not current go with it.
+    if (context_ && QOpenGLContext::currentContext() == context_) {
+        if (vao_ != 0) glDeleteVertexArrays(1, &vao_);
+        if (stream_buffer_ != 0) glDeleteBuffers(1, &stream_buffer_);
+        if (stream_index_buffer_ != 0) glDeleteBuffers(1, &stream_index_buffer_);
+    }
+    vao_ = 0;
+    stream_buffer_ = 0;
+    stream_index_buffer_ = 0;
+    program_.reset();
+    line_program_.reset();
+    texture_program_.reset();
+    multi_draw_arrays_ = nullptr;
+    context_ = nullptr;
+}
+
+void ShaderBackend::beginPass(const glm::mat4& projection, const glm::mat4& view, const glm::vec2& viewport) {
+    projection_ = projection;
+    model_view_stack_.assign(1, view);
+    viewport_ = glm::max(viewport, glm::vec2(1.0f));
+
+    // Point sizes come from the vertex shader (always so on OpenGL ES).
+    if (!gles_) {
+        glEnable(GL_PROGRAM_POINT_SIZE);
+    }
+    glBindVertexArray(vao_);
+}
+
+void ShaderBackend::endPass() {
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glUseProgram(0);
+}
+
+void ShaderBackend::pushModel(const glm::mat4& model) {
+    model_view_stack_.push_back(model_view_stack_.back() * model);
+}
+
+void ShaderBackend::popModel() {
+    if (model_view_stack_.size() > 1) {
+        model_view_stack_.pop_back();
+    }
+}
+
+glm::mat4 ShaderBackend::modelViewProjection() const { return projection_ * model_view_stack_.back(); }
+
+void ShaderBackend::bindSource(const VertexSource& source, GLint end) {
+    const GLsizei stride = source.layout == PackedColor ? sizeof(PackedVertex) : sizeof(Shape::GpuVertex);
+    if (source.buffer != 0) {
+        glBindBuffer(GL_ARRAY_BUFFER, source.buffer);
+    } else {
+        glBindBuffer(GL_ARRAY_BUFFER, stream_buffer_);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(end) * stride, source.data, GL_STREAM_DRAW);
+    }
+
+    if (source.layout == PackedColor) {
+        glVertexAttribPointer(kAttrPosition, 3, GL_FLOAT, GL_FALSE, stride,
+                              reinterpret_cast<const void*>(offsetof(PackedVertex, x)));
+        glVertexAttribPointer(kAttrColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+                              reinterpret_cast<const void*>(offsetof(PackedVertex, r)));
+    } else {
+        glVertexAttribPointer(kAttrPosition, 3, GL_FLOAT, GL_FALSE, stride,
+                              reinterpret_cast<const void*>(offsetof(Shape::GpuVertex, x)));
+        glVertexAttribPointer(kAttrColor, 4, GL_FLOAT, GL_FALSE, stride,
+                              reinterpret_cast<const void*>(offsetof(Shape::GpuVertex, r)));
+    }
+}
+
+bool ShaderBackend::beginDraw(const VertexSource& source, Primitive primitive, GLint end, const DrawStyle& style) {
+    if (!program_) return false;
+
+    const bool lines = primitive == Lines || primitive == LineLoop || primitive == LineStrip;
+    QOpenGLShaderProgram& program = lines ? *line_program_ : *program_;
+    const Uniforms& uniforms = lines ? line_uniforms_ : uniforms_;
+    program.bind();
+    bindSource(source, end);
+
+    glUniformMatrix4fv(uniforms.modelViewProjection, 1, GL_FALSE, glm::value_ptr(modelViewProjection()));
+    glUniform4f(uniforms.color, style.color.r, style.color.g, style.color.b, style.color.a);
+    glUniform1f(uniforms.useColor, style.vertexColors ? 0.0f : 1.0f);
+    glUniform1f(uniforms.pointSize, style.size);
+    if (lines) {
+        glUniform2f(uniforms.viewport, viewport_.x, viewport_.y);
+        glUniform1f(uniforms.lineWidth, std::max(style.size, 1.0f));
+        glUniform1f(uniforms.dashed, style.dashed ? 1.0f : 0.0f);
+    }
+
+    // Scalars stream from their own buffer; the array is enabled for this draw only (see endDraw).
+    const bool scalars = style.scalarBuffer != 0 && style.colormap != 0;
+    glUniform1f(uniforms.useScalar, scalars ? 1.0f : 0.0f);
+    if (scalars) {
+        const glm::vec2 map = style.scalarTexCoordMap();
+        glUniform2f(uniforms.scalarMap, map.x, map.y);
+        glUniform1i(uniforms.colormap, 0);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, style.colormap);
+        glBindBuffer(GL_ARRAY_BUFFER, style.scalarBuffer);
+        glEnableVertexAttribArray(kAttrScalar);
+        glVertexAttribPointer(kAttrScalar, 1, GL_FLOAT, GL_FALSE, sizeof(float),
+                              reinterpret_cast<const void*>(style.scalarOffset));
+    }
+    return true;
+}
+
+void ShaderBackend::endDraw(const DrawStyle& style) {
+    if (style.scalarBuffer == 0 || style.colormap == 0) return;
+    glDisableVertexAttribArray(kAttrScalar);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void ShaderBackend::draw(const VertexSource& source, Primitive primitive, const GLint* firsts,
+                         const GLsizei* counts, GLsizei rangeCount, const DrawStyle& style) {
+    if (rangeCount <= 0) return;
+
+    // Client memory is streamed only up to the end of the last range.
+    GLint end = 0;
+    if (source.buffer == 0) {
+        for (GLsizei i = 0; i < rangeCount; ++i) {
+            end = std::max(end, firsts[i] + counts[i]);
+        }
+    }
+    if (!beginDraw(source, primitive, end, style)) return;
+
+    const GLenum mode = glPrimitive(primitive);
+    if (rangeCount == 1) {
+        glDrawArrays(mode, firsts[0], counts[0]);
+    } else if (multi_draw_arrays_) {
+        multi_draw_arrays_(mode, firsts, counts, rangeCount);
+    } else {
+        for (GLsizei i = 0; i < rangeCount; ++i) {
+            glDrawArrays(mode, firsts[i], counts[i]);
+        }
+    }
+    endDraw(style);
+}
+
+void ShaderBackend::drawIndexed(const VertexSource& source, Primitive primitive, GLuint indexBuffer,
+                                const uint32_t* indices, GLsizei count, const DrawStyle& style) {
+    if (count <= 0) return;
+
+    // Client-memory vertices are streamed up to the highest index (client indices always come with them).
+    GLint end = 0;
+    if (source.buffer == 0 && indices) {
+        end = static_cast<GLint>(*std::max_element(indices, indices + count)) + 1;
+    }
+    if (!beginDraw(source, primitive, end, style)) return;
+
+    // The element binding belongs to the vertex array object, which stays bound for the pass.
+    if (indexBuffer != 0) {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    } else {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, stream_index_buffer_);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(count) * sizeof(uint32_t), indices,
+                     GL_STREAM_DRAW);
+    }
+    glDrawElements(glPrimitive(primitive), count, GL_UNSIGNED_INT, nullptr);
+    endDraw(style);
+}
+
+void ShaderBackend::drawTexturedQuad(const Vec3* corners, const float* uvs, GLuint texture, float alpha) {
+    if (!texture_program_) return;
+
+    // Position and texture coordinate per corner, streamed like client-memory sources.
+    float vertices[4 * 5];
+    for (int i = 0; i < 4; ++i) {
+        vertices[i * 5] = static_cast<float>(corners[i].x);
+        vertices[i * 5 + 1] = static_cast<float>(corners[i].y);
+        vertices[i * 5 + 2] = static_cast<float>(corners[i].z);
+        vertices[i * 5 + 3] = uvs[i * 2];
+        vertices[i * 5 + 4] = uvs[i * 2 + 1];
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, stream_buffer_);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STREAM_DRAW);
+    const GLsizei stride = 5 * sizeof(float);
+    glVertexAttribPointer(kAttrPosition, 3, GL_FLOAT, GL_FALSE, stride, nullptr);
+    glEnableVertexAttribArray(kAttrTexCoord);
+    glVertexAttribPointer(kAttrTexCoord, 2, GL_FLOAT, GL_FALSE, stride,
+                          reinterpret_cast<const void*>(3 * sizeof(float)));
+
+    texture_program_->bind();
+    glUniformMatrix4fv(texture_uniforms_.modelViewProjection, 1, GL_FALSE, glm::value_ptr(modelViewProjection()));
+    glUniform1i(texture_uniforms_.texture, 0);
+    glUniform1f(texture_uniforms_.alpha, alpha);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisableVertexAttribArray(kAttrTexCoord);
+}
+
+}  // namespace octo_flex
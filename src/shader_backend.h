@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef SHADER_BACKEND_H
+#define SHADER_BACKEND_H
+
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLShaderProgram>
+#include <memory>
+#include <vector>
+#include "render_backend.h"
+
+namespace octo_flex {
+
+// GLSL pipeline for OpenGL 3.2+ core profiles and OpenGL ES 3.2. Matrices are uniforms, lines are
+// expanded into screen-space quads by a geometry shader (any width) and dashes are cut in the
+// fragment shader. Client-memory sources are streamed through one reused buffer.
+class ShaderBackend : public RenderBackend, protected QOpenGLExtraFunctions {
+   public:
+    ShaderBackend() {}
+    ~ShaderBackend() override;
+
+    RenderBackendType type() const override { return RenderBackendType::SHADER; }
+
+    bool initialize(QOpenGLContext* context) override;
+    void release() override;
+
+    void beginPass(const glm::mat4& projection, const glm::mat4& view, const glm::vec2& viewport) override;
+    void endPass() override;
+
+    void pushModel(const glm::mat4& model) override;
+    void popModel() override;
+
+    void draw(const VertexSource& source, Primitive primitive, const GLint* firsts, const GLsizei* counts,
+              GLsizei rangeCount, const DrawStyle& style) override;
+    using RenderBackend::draw;
+
+    void drawIndexed(const VertexSource& source, Primitive primitive, GLuint indexBuffer, const uint32_t* indices,
+                     GLsizei count, const DrawStyle& style) override;
+
+    void drawTexturedQuad(const Vec3* corners, const float* uvs, GLuint texture, float alpha) override;
+
+   private:
+    // Uniform locations of a program, -1 where the program has none.
+    struct Uniforms {
+        int modelViewProjection = -1;
+        int color = -1;
+        int useColor = -1;
+        int pointSize = -1;
+        int viewport = -1;
+        int lineWidth = -1;
+        int dashed = -1;
+        int texture = -1;
+        int alpha = -1;
+        int useScalar = -1;
+        int scalarMap = -1;
+        int colormap = -1;
+    };
+
+    // Compile and link one program; null (with a warning) on failure.
+    std::unique_ptr<QOpenGLShaderProgram> buildProgram(const char* vertex, const char* geometry,
+                                                       const char* fragment, Uniforms& uniforms);
+
+    // Bind source's buffer (streaming client memory up to vertex end) and set the vertex attributes
+    // for its layout.
+    void bindSource(const VertexSource& source, GLint end);
+
+    // Bind the program for primitive with source and style; false if the backend is not initialized.
+    bool beginDraw(const VertexSource& source, Primitive primitive, GLint end, const DrawStyle& style);
+    // Undo the per-draw state of style (the scalar array) after a draw.
+    void endDraw(const DrawStyle& style);
+
+    glm::mat4 modelViewProjection() const;
+
+    QOpenGLContext* context_ = nullptr;
+    bool gles_ = false;
+    std::unique_ptr<QOpenGLShaderProgram> program_;       // Points and triangles
+    std::unique_ptr<QOpenGLShaderProgram> line_program_;  // Lines, with the geometry shader
+    std::unique_ptr<QOpenGLShaderProgram> texture_program_;
+    Uniforms uniforms_;
+    Uniforms line_uniforms_;
+    Uniforms texture_uniforms_;
+    GLuint vao_ = 0;
+    GLuint stream_buffer_ = 0;
+    GLuint stream_index_buffer_ = 0;
+
+    glm::mat4 projection_ = glm::mat4(1.0f);
+    std::vector<glm::mat4> model_view_stack_;  // View times the pushed models, never empty during a pass
+    glm::vec2 viewport_ = glm::vec2(1.0f);
+
+    // glMultiDrawArrays, resolved at initialize (null on OpenGL ES).
+    typedef void(QOPENGLF_APIENTRYP MultiDrawArraysFn)(GLenum, const GLint*, const GLsizei*, GLsizei);
+    MultiDrawArraysFn multi_draw_arrays_ = nullptr;
+};
+
+}  // namespace octo_flex
+
+#endif /* SHADER_BACKEND_H */
@@ -16,7 +16,13 @@
 
 
 #include "shape.h"
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <algorithm>
 #include <cmath>
+#include <mutex>
+#include "gl_deletion_queue.h"
+#include "triangulation.h"
 #include "utils.h"
 
 namespace octo_flex {
@@ -27,21 +33,227 @@ Shape::Shape(ShapeType type, double width, double transparency) : editable_(true
     transparency_ = transparency;
 }
 
+Shape::~Shape() { releaseVertexBuffer(); }
+
 void Shape::setPointsWithColor(const std::vector<Vec3>& points, const Vec3& color) {
     if (!editable_) return;
     points_ = points;
     color_ = color;
     colors_.clear();
+    packed_.clear();
+    triangles_.reset();
 }
 
 void Shape::setPointsWithColor(const std::vector<Vec3>& points, const std::vector<Vec3>& colors) {
     if (!editable_) return;
     points_.assign(points.begin(), points.end());
     colors_.assign(colors.begin(), colors.end());
+    packed_.clear();
+    triangles_.reset();
+}
+
+void Shape::setPackedVertices(std::vector<PackedVertex>&& vertices) {
+    if (!editable_) return;
+    packed_ = std::move(vertices);
+    points_.clear();
+    colors_.clear();
+    triangles_.reset();
+}
+
+void Shape::setPackedPoints(const float* xyz, size_t count, const uint8_t* rgba) {
+    if (!editable_ || (xyz == nullptr && count > 0)) return;
+
+    auto toByte = [](double v) { return static_cast<uint8_t>(std::lround(std::min(std::max(v, 0.0), 1.0) * 255.0)); };
+    const uint8_t r = toByte(color_.x), g = toByte(color_.y), b = toByte(color_.z), a = toByte(transparency_);
+
+    std::vector<PackedVertex> vertices(count);
+    for (size_t i = 0; i < count; ++i) {
+        PackedVertex& v = vertices[i];
+        v.x = xyz[i * 3];
+        v.y = xyz[i * 3 + 1];
+        v.z = xyz[i * 3 + 2];
+        if (rgba) {
+            v.r = rgba[i * 4];
+            v.g = rgba[i * 4 + 1];
+            v.b = rgba[i * 4 + 2];
+            v.a = rgba[i * 4 + 3];
+        } else {
+            v.r = r;
+            v.g = g;
+            v.b = b;
+            v.a = a;
+        }
+    }
+    setPackedVertices(std::move(vertices));
+}
+
+const std::vector<PackedVertex>& Shape::packedVertices() const { return packed_; }
+bool Shape::isPacked() const { return !packed_.empty(); }
+size_t Shape::vertexCount() const { return packed_.empty() ? points_.size() : packed_.size(); }
+
+size_t Shape::cpuBytes() const {
+    size_t bytes = (points_.capacity() + colors_.capacity()) * sizeof(Vec3) +
+                   packed_.capacity() * sizeof(PackedVertex) + holes_.capacity() * sizeof(size_t);
+    if (triangles_) bytes += triangles_->capacity() * sizeof(uint32_t);
+    return bytes;
+}
+
+size_t Shape::gpuBytes() const { return gpu_bytes_.load(std::memory_order_relaxed); }
+
+void Shape::setHoles(const std::vector<size_t>& hole_starts) {
+    if (!editable_) return;
+    holes_ = hole_starts;
+    triangles_.reset();
+}
+
+const std::vector<size_t>& Shape::holes() const { return holes_; }
+
+const std::vector<uint32_t>& Shape::triangles() const {
+    static const std::vector<uint32_t> kNone;
+    return triangles_ ? *triangles_ : kNone;
+}
+
+void Shape::setTriangles(std::vector<uint32_t>&& triangles) {
+    if (!editable_) return;
+    if (triangles.empty()) {
+        triangles_.reset();
+    } else {
+        triangles_ = std::make_shared<const std::vector<uint32_t>>(std::move(triangles));
+    }
+}
+
+BoundingBox Shape::bounds() const {
+    BoundingBox box;
+    for (const auto& point : points_) {
+        box.expand(point);
+    }
+    for (const auto& v : packed_) {
+        box.expand(Vec3(v.x, v.y, v.z));
+    }
+    return box;
 }
 
 bool Shape::isEditable() const { return editable_; }
-void Shape::setInEditable() { editable_ = false; }
+void Shape::setInEditable() {
+    // Triangulate once here rather than per frame; moves, rotations and scales keep the result valid.
+    if (editable_ && type_ == Polygon && !triangles_ && points_.size() >= 3) {
+        std::vector<uint32_t> triangles = triangulatePolygon(points_, holes_);
+        if (!triangles.empty()) {
+            triangles_ = std::make_shared<const std::vector<uint32_t>>(std::move(triangles));
+        }
+    }
+    editable_ = false;
+}
+
+unsigned int Shape::vertexBuffer() const {
+    ensureVertexBufferUploaded();
+    return vertex_buffer_id_;
+}
+
+void Shape::bakeVertices(std::vector<GpuVertex>& vertices) const {
+    vertices.resize(points_.size());
+    const float alpha = static_cast<float>(transparency_);
+    for (size_t i = 0; i < points_.size(); ++i) {
+        const Vec3& point = points_[i];
+        const Vec3& c = color(i);
+        vertices[i] = {static_cast<float>(point.x), static_cast<float>(point.y), static_cast<float>(point.z),
+                       static_cast<float>(c.x),     static_cast<float>(c.y),     static_cast<float>(c.z),
+                       alpha};
+    }
+}
+
+void Shape::setBakedVertices(std::shared_ptr<const void> storage, const GpuVertex* vertices) {
+    // Frozen shapes only: their points can no longer change under the baked copy.
+    if (editable_ || !packed_.empty() || !vertices || vertex_buffer_id_ != 0) return;
+    baked_storage_ = std::move(storage);
+    baked_ = vertices;
+}
+
+bool Shape::hasVertexBuffer() const { return vertex_buffer_id_ != 0; }
+
+unsigned int Shape::indexBuffer() const {
+    ensureVertexBufferUploaded();
+    return index_buffer_id_;
+}
+
+void Shape::ensureVertexBufferUploaded() const {
+    // Only frozen shapes are uploaded; editable shapes may still change.
+    if (vertex_buffer_id_.load(std::memory_order_acquire) != 0 || editable_ || vertexCount() == 0) {
+        return;
+    }
+
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    if (!context) {
+        // No context yet, will upload later during rendering
+        return;
+    }
+
+    // Views draw at the same time; the first one to get here uploads. The buffers are flushed before
+    // the name is published, as the others draw with them in other contexts of the share group.
+    static std::mutex mutex;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (vertex_buffer_id_.load(std::memory_order_relaxed) != 0) {
+        return;
+    }
+
+    QOpenGLFunctions* gl = context->functions();
+    gl_group_ = GlDeletionQueue::instance()->currentGroup();
+    GLuint buffer = 0;
+    if (!packed_.empty()) {
+        // Packed vertices are uploaded straight from their storage.
+        gl->glGenBuffers(1, &buffer);
+        gl->glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        gl->glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(packed_.size() * sizeof(PackedVertex)),
+                         packed_.data(), GL_STATIC_DRAW);
+        gl->glBindBuffer(GL_ARRAY_BUFFER, 0);
+        gl->glFlush();
+        gpu_bytes_.store(packed_.size() * sizeof(PackedVertex), std::memory_order_relaxed);
+        vertex_buffer_id_.store(buffer, std::memory_order_release);
+        return;
+    }
+
+    // Bake per-vertex color and shape transparency into one interleaved array, unless given baked.
+    std::vector<GpuVertex> vertices;
+    const GpuVertex* data = baked_;
+    if (!data) {
+        bakeVertices(vertices);
+        data = vertices.data();
+    }
+
+    gl->glGenBuffers(1, &buffer);
+    gl->glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    gl->glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(points_.size() * sizeof(GpuVertex)), data,
+                     GL_STATIC_DRAW);
+    gl->glBindBuffer(GL_ARRAY_BUFFER, 0);
+    baked_ = nullptr;
+    baked_storage_.reset();
+    size_t uploaded = points_.size() * sizeof(GpuVertex);
+
+    if (triangles_) {
+        gl->glGenBuffers(1, &index_buffer_id_);
+        gl->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer_id_);
+        gl->glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(triangles_->size() * sizeof(uint32_t)),
+                         triangles_->data(), GL_STATIC_DRAW);
+        gl->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        uploaded += triangles_->size() * sizeof(uint32_t);
+    }
+    gl->glFlush();
+    gpu_bytes_.store(uploaded, std::memory_order_relaxed);
+    vertex_buffer_id_.store(buffer, std::memory_order_release);
+}
+
+void Shape::releaseResources() { releaseVertexBuffer(); }
+
+void Shape::releaseVertexBuffer() {
+    if (vertex_buffer_id_ == 0) {
+        return;
+    }
+
+    GlDeletionQueue::instance()->deleteBuffers(gl_group_, {vertex_buffer_id_.load(), index_buffer_id_});
+    vertex_buffer_id_ = 0;
+    index_buffer_id_ = 0;
+    gpu_bytes_.store(0, std::memory_order_relaxed);
+}
 
 const Vec3& Shape::color(size_t i) const {
     if (i + 1 > colors_.size()) {
@@ -59,6 +271,7 @@ Shape::ShapeType Shape::type() const { return type_; }
 void Shape::setType(ShapeType type) {
     if (!editable_) return;
     type_ = type;
+    triangles_.reset();
 }
 
 double Shape::width() const { return width_; }
@@ -73,10 +286,20 @@ void Shape::setTransparency(double transparency) {
     transparency_ = transparency;
 }
 
+int Shape::lodLevel() const { return lod_level_; }
+void Shape::setLodLevel(int level) {
+    if (!editable_) return;
+    lod_level_ = level < 0 ? -1 : level;
+}
+
 Shape::Ptr Shape::clone() {
     auto new_shape = std::make_shared<Shape>(type_, width_, transparency_);
     new_shape->setPointsWithColor(points_, colors_);
     new_shape->color_ = color_;
+    new_shape->packed_ = packed_;
+    new_shape->holes_ = holes_;
+    new_shape->triangles_ = triangles_;
+    new_shape->lod_level_ = lod_level_;
     return new_shape;
 }
 
@@ -85,6 +308,11 @@ void Shape::move(const Vec3& vec) {
     for (auto& point : points_) {
         point = point + vec;
     }
+    for (auto& v : packed_) {
+        v.x += static_cast<float>(vec.x);
+        v.y += static_cast<float>(vec.y);
+        v.z += static_cast<float>(vec.z);
+    }
 }
 void Shape::rotate(const Quaternion& quad) {
     if (!editable_) return;
@@ -92,6 +320,12 @@ void Shape::rotate(const Quaternion& quad) {
     for (auto& point : points_) {
         point = quaternionRotateVector(quad, point);
     }
+    for (auto& v : packed_) {
+        Vec3 p = quaternionRotateVector(quad, Vec3(v.x, v.y, v.z));
+        v.x = static_cast<float>(p.x);
+        v.y = static_cast<float>(p.y);
+        v.z = static_cast<float>(p.z);
+    }
 }
 
 void Shape::scale(double sx, double sy, double sz) {
@@ -102,6 +336,11 @@ void Shape::scale(double sx, double sy, double sz) {
         point.y *= sy;
         point.z *= sz;
     }
+    for (auto& v : packed_) {
+        v.x *= static_cast<float>(sx);
+        v.y *= static_cast<float>(sy);
+        v.z *= static_cast<float>(sz);
+    }
 }
 
 void Shape::scale(const Vec3& scale_factors) { scale(scale_factors.x, scale_factors.y, scale_factors.z); }
@@ -18,6 +18,8 @@
 #ifndef SHAPE_H
 #define SHAPE_H
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -26,14 +28,20 @@
 namespace octo_flex {
 class Shape {
    public:
-    enum ShapeType { Points = 0, Lines, Dash, Loop, Polygon, TexturedQuad };
+    enum ShapeType { Points = 0, Lines, Dash, Loop, Polygon, TexturedQuad, Instanced, PointCloud, Trajectory };
     typedef std::shared_ptr<Shape> Ptr;
 
+    // Interleaved vertex layout of the retained GPU buffer.
+    struct GpuVertex {
+        float x, y, z;
+        float r, g, b, a;
+    };
+
    public:
     Shape();
     virtual Ptr clone();
     Shape(ShapeType type, double width, double transparency);
-    virtual ~Shape(){};
+    virtual ~Shape();
 
     void setPointsWithColor(const std::vector<Vec3>& points, const Vec3& color);
     void setPointsWithColor(const std::vector<Vec3>& points, const std::vector<Vec3>& colors);
@@ -42,6 +50,32 @@ class Shape {
     const Vec3& color() const;
     const Vec3& color(size_t i) const;
 
+    // Packed storage for large point sets; points() and colors() stay empty for packed shapes.
+    // Takes ownership of the buffer without copying.
+    void setPackedVertices(std::vector<PackedVertex>&& vertices);
+    // Packs count xyz triples and optional RGBA8 quadruples in one pass; without rgba the
+    // shape color and transparency are used.
+    void setPackedPoints(const float* xyz, size_t count, const uint8_t* rgba = nullptr);
+    const std::vector<PackedVertex>& packedVertices() const;
+    bool isPacked() const;
+
+    // Number of vertices in either storage.
+    size_t vertexCount() const;
+
+    // Polygon holes: points() holds the outer ring, then one ring per hole starting at these indices.
+    void setHoles(const std::vector<size_t>& hole_starts);
+    const std::vector<size_t>& holes() const;
+
+    // Triangles of a polygon (three point indices each), computed once by setInEditable() for concave
+    // outlines and holes, and shared with clones. Empty for other shapes, degenerate outlines and
+    // polygons that were never frozen.
+    const std::vector<uint32_t>& triangles() const;
+    // Restore triangles computed earlier for the current points, so freezing does not triangulate again.
+    void setTriangles(std::vector<uint32_t>&& triangles);
+
+    // Bounds of the shape's vertices in either storage; trajectories report the points held right now.
+    virtual BoundingBox bounds() const;
+
     void setType(ShapeType type);
     ShapeType type() const;
 
@@ -51,27 +85,71 @@ class Shape {
     void setTransparency(double transparency);
     double transparency() const;
 
-    void move(const Vec3& vec);
-    void rotate(const Quaternion& quad);
-    void scale(double sx, double sy, double sz);
+    // Level of detail the shape belongs to, 0 being the finest; -1 (the default) draws at every level.
+    void setLodLevel(int level);
+    int lodLevel() const;
+
+    virtual void move(const Vec3& vec);
+    virtual void rotate(const Quaternion& quad);
+    virtual void scale(double sx, double sy, double sz);
     void scale(const Vec3& scale_factors);
 
     bool isEditable() const;
-    void setInEditable();
+    virtual void setInEditable();
+
+    // Retained GPU vertex buffer name, uploaded lazily once the shape is frozen.
+    // Returns 0 while the shape is still editable or no context is current.
+    unsigned int vertexBuffer() const;
+    bool hasVertexBuffer() const;
+
+    // Retained GPU index buffer of triangles(), uploaded together with the vertex buffer (0 without one).
+    unsigned int indexBuffer() const;
+
+    // Bytes of the vertex data kept in memory, spare capacity included. Triangles shared with
+    // clones are counted by each.
+    virtual size_t cpuBytes() const;
+    // Bytes of the retained GPU buffers uploaded so far; 0 until the shape is first drawn on its own.
+    // Safe to call from any thread.
+    virtual size_t gpuBytes() const;
+
+    // Points with their colors and the shape transparency in GpuVertex layout, as uploaded for
+    // shapes that are not packed.
+    void bakeVertices(std::vector<GpuVertex>& vertices) const;
+
+    // Vertices of a frozen shape already in GpuVertex layout (one per point), for example in a mapped
+    // scene snapshot. The vertex buffer is uploaded straight from them instead of baking points() and
+    // colors(); storage keeps them valid until then and is released after the upload.
+    void setBakedVertices(std::shared_ptr<const void> storage, const GpuVertex* vertices);
 
     // Resource cleanup (called on main thread before deletion)
-    virtual void releaseResources() {}
+    virtual void releaseResources();
 
    private:
+    void ensureVertexBufferUploaded() const;  // const because it's lazy initialization
+    void releaseVertexBuffer();
+
     bool editable_;
+    mutable std::atomic<unsigned int> vertex_buffer_id_{0};  // GL buffer name, set once the lazy upload is done
+    mutable unsigned int index_buffer_id_ = 0;  // Uploaded with the vertex buffer when triangulated
+    mutable std::atomic<size_t> gpu_bytes_{0};   // Size of both buffers while uploaded
+    mutable uint32_t gl_group_ = 0;              // Share group the buffers were created in
 
     ShapeType type_;
     double width_;
     double transparency_;
+    int lod_level_ = -1;
     std::vector<Vec3> points_;
 
     std::vector<Vec3> colors_;
     Vec3 color_;
+
+    std::vector<PackedVertex> packed_;
+
+    std::vector<size_t> holes_;
+    std::shared_ptr<const std::vector<uint32_t>> triangles_;  // Immutable once built
+
+    mutable std::shared_ptr<const void> baked_storage_;  // Keeps baked_ valid until uploaded
+    mutable const GpuVertex* baked_ = nullptr;
 };
 }  // namespace octo_flex
 
@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SHARED_SCENE_FORMAT_H
+#define SHARED_SCENE_FORMAT_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace octo_flex {
+
+// Layout of a shared scene segment: a SharedSceneHeader, slot_count SharedSceneSlots and an arena of
+// arena_size bytes, each at a multiple of 16 from the start. The receiver creates the segment; one
+// sender fills it. Counters only grow: a slot or arena byte n lives at n modulo the count or size.
+//
+// The sender encodes an update (see scene_update.h) at arena_head, skipping to the arena start when
+// it does not fit before the end, then fills slot slot_head and publishes arena_head and slot_head, in
+// that order, with release stores, then releases the "<name>.signal" semaphore once. The receiver
+// applies slots up to slot_head and returns each slot's arena range by storing arena_tail, then
+// slot_tail. Everything the sender writes is checked before it is used.
+
+const char kSharedMagic[8] = {'O', 'F', 'V', 'S', 'H', 'M', '\0', '\0'};
+const uint32_t kSharedByteOrder = 0x01020304;
+const uint16_t kSharedMajorVersion = 1;  // Senders refuse other major versions
+const uint16_t kSharedMinorVersion = 0;
+const uint64_t kSharedAlignment = 16;
+
+struct SharedSceneHeader {
+    char magic[8];
+    uint32_t byte_order;
+    uint16_t major_version;
+    uint16_t minor_version;
+    uint32_t header_size;
+    uint32_t slot_size;
+    uint32_t slot_count;
+    uint32_t reserved0;
+    uint64_t slots_offset;
+    uint64_t arena_offset;
+    uint64_t arena_size;
+    std::atomic<uint64_t> slot_head;   // Sender: slots filled
+    std::atomic<uint64_t> slot_tail;   // Receiver: slots applied
+    std::atomic<uint64_t> arena_head;  // Sender: arena bytes used
+    std::atomic<uint64_t> arena_tail;  // Receiver: arena bytes returned
+    std::atomic<uint32_t> receiver_open;
+    uint32_t reserved1;
+};
+
+struct SharedSceneSlot {
+    uint32_t kind;  // SceneUpdateKind
+    uint32_t reserved;
+    uint64_t arena_start;  // Counter value of the payload's first byte
+    uint64_t arena_end;    // Arena counter after the update, skipped bytes included
+    uint64_t payload_size;
+    uint64_t blob_size;  // Snapshot at the start of the payload
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+              "shared scene counters are shared between processes");
+static_assert(sizeof(SharedSceneHeader) == 96 && sizeof(SharedSceneSlot) == 40,
+              "shared scene records must not have padding");
+
+inline uint64_t sharedAlign(uint64_t value) {
+    return (value + kSharedAlignment - 1) / kSharedAlignment * kSharedAlignment;
+}
+
+}  // namespace octo_flex
+
+#endif  // SHARED_SCENE_FORMAT_H
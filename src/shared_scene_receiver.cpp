@@ -0,0 +1,186 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "shared_scene_receiver.h"
+
+#include <QDebug>
+#include <cstring>
+#include <limits>
+#include <new>
+
+#include "object_manager.h"
+#include "scene_update.h"
+#include "trace.h"
+#include "worker_pool.h"
+
+namespace octo_flex {
+
+namespace {
+
+// Updates this large are decoded on the worker pool; smaller ones are not worth waking it for.
+const uint64_t kParallelDecodeBytes = 1 << 20;
+
+}  // namespace
+
+SharedSceneReceiver::SharedSceneReceiver(ObjectManager* manager, const std::string& name)
+    : QThread(nullptr), manager_(manager), name_(name) {}
+
+SharedSceneReceiver::~SharedSceneReceiver() {
+    close();
+}
+
+bool SharedSceneReceiver::open(const SharedSceneOptions& options, std::string* error) {
+    if (options.slot_count == 0 || options.arena_bytes < kSharedAlignment) {
+        *error = "shared scene channel needs slots and an arena";
+        return false;
+    }
+    slotCount_ = options.slot_count;
+    arenaSize_ = options.arena_bytes / kSharedAlignment * kSharedAlignment;
+    const uint64_t slots_offset = sharedAlign(sizeof(SharedSceneHeader));
+    const uint64_t arena_offset = sharedAlign(slots_offset + uint64_t{slotCount_} * sizeof(SharedSceneSlot));
+    const uint64_t size = arena_offset + arenaSize_;
+    if (size > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+        *error = "shared scene channel larger than 2 GB";
+        return false;
+    }
+
+    memory_.setKey(QString::fromStdString(name_));
+    if (!memory_.create(static_cast<int>(size))) {
+        // A segment left by a viewer that crashed is gone once nobody is attached to it.
+        if (memory_.error() == QSharedMemory::AlreadyExists && memory_.attach()) memory_.detach();
+        if (!memory_.create(static_cast<int>(size))) {
+            *error = "cannot create shared scene channel " + name_ + ": " + memory_.errorString().toStdString();
+            return false;
+        }
+    }
+
+    uchar* data = static_cast<uchar*>(memory_.data());
+    std::memset(data, 0, static_cast<size_t>(arena_offset));
+    header_ = new (data) SharedSceneHeader();
+    std::memcpy(header_->magic, kSharedMagic, sizeof(kSharedMagic));
+    header_->byte_order = kSharedByteOrder;
+    header_->major_version = kSharedMajorVersion;
+    header_->minor_version = kSharedMinorVersion;
+    header_->header_size = sizeof(SharedSceneHeader);
+    header_->slot_size = sizeof(SharedSceneSlot);
+    header_->slot_count = slotCount_;
+    header_->slots_offset = slots_offset;
+    header_->arena_offset = arena_offset;
+    header_->arena_size = arenaSize_;
+    header_->slot_head = 0;
+    header_->slot_tail = 0;
+    header_->arena_head = 0;
+    header_->arena_tail = 0;
+    slots_ = reinterpret_cast<const SharedSceneSlot*>(data + slots_offset);
+    arena_ = data + arena_offset;
+
+    signal_ = std::make_unique<QSystemSemaphore>(QString::fromStdString(name_ + ".signal"), 0,
+                                                 QSystemSemaphore::Create);
+    if (signal_->error() != QSystemSemaphore::NoError) {
+        *error = "cannot create the signal of " + name_ + ": " + signal_->errorString().toStdString();
+        signal_.reset();
+        header_ = nullptr;
+        memory_.detach();
+        return false;
+    }
+
+    updatesApplied_ = 0;
+    updatesRejected_ = 0;
+    bytesReceived_ = 0;
+    shouldStop_ = false;
+    open_ = true;
+    header_->receiver_open.store(1, std::memory_order_release);
+    start();
+    return true;
+}
+
+void SharedSceneReceiver::close() {
+    if (!open_.exchange(false)) return;
+    header_->receiver_open.store(0, std::memory_order_release);
+    shouldStop_ = true;
+    signal_->release();
+    wait();
+    signal_.reset();
+    header_ = nullptr;
+    memory_.detach();
+}
+
+SharedSceneStats SharedSceneReceiver::stats() const {
+    SharedSceneStats stats;
+    stats.updates_applied = updatesApplied_;
+    stats.updates_rejected = updatesRejected_;
+    stats.bytes_received = bytesReceived_;
+    stats.open = open_;
+    return stats;
+}
+
+void SharedSceneReceiver::run() {
+    setTraceThreadName("shared scene " + name_);
+    while (!shouldStop_) {
+        signal_->acquire();  // Released once per published update, and by close()
+        if (!shouldStop_) drain();
+    }
+}
+
+void SharedSceneReceiver::drain() {
+    uint64_t tail = header_->slot_tail.load(std::memory_order_relaxed);
+    const uint64_t head = header_->slot_head.load(std::memory_order_acquire);
+    if (head - tail > slotCount_) {
+        qWarning() << "Shared scene channel" << QString::fromStdString(name_) << "has bad slot counters";
+        ++updatesRejected_;
+        return;
+    }
+
+    for (; tail != head && !shouldStop_; ++tail) {
+        SharedSceneSlot slot;
+        std::memcpy(&slot, &slots_[tail % slotCount_], sizeof(slot));
+        std::string error;
+        if (apply(slot, &error)) {
+            ++updatesApplied_;
+            bytesReceived_ += slot.payload_size;
+        } else {
+            ++updatesRejected_;
+            qWarning() << "Shared scene channel" << QString::fromStdString(name_) << "rejected an update:"
+                       << QString::fromStdString(error);
+        }
+        // Returned only if it lies between what was returned and what was published.
+        const uint64_t arena_tail = header_->arena_tail.load(std::memory_order_relaxed);
+        if (slot.arena_end - arena_tail <= header_->arena_head.load(std::memory_order_acquire) - arena_tail) {
+            header_->arena_tail.store(slot.arena_end, std::memory_order_release);
+        }
+        header_->slot_tail.store(tail + 1, std::memory_order_release);
+    }
+}
+
+bool SharedSceneReceiver::apply(const SharedSceneSlot& slot, std::string* error) {
+    OCTO_FLEX_TRACE_ZONE("SharedSceneReceiver::apply");
+    const uint64_t offset = slot.arena_start % arenaSize_;
+    if (slot.arena_end < slot.arena_start || slot.payload_size > slot.arena_end - slot.arena_start ||
+        slot.payload_size > arenaSize_ - offset || offset % kSharedAlignment != 0) {
+        *error = "bad arena range";
+        return false;
+    }
+    WorkerPool* workers = nullptr;
+    if (slot.blob_size >= kParallelDecodeBytes) {
+        if (!pool_) pool_ = std::make_unique<WorkerPool>();
+        workers = pool_.get();
+    }
+    // Decoded without storage: the arena bytes are handed back once the update is applied.
+    return applySceneUpdate(*manager_, slot.kind, arena_ + offset, slot.payload_size, slot.blob_size, nullptr,
+                            workers, error);
+}
+
+}  // namespace octo_flex
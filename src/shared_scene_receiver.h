@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SHARED_SCENE_RECEIVER_H
+#define SHARED_SCENE_RECEIVER_H
+
+#include <QSharedMemory>
+#include <QSystemSemaphore>
+#include <QThread>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "shared_scene.h"
+#include "shared_scene_format.h"
+
+namespace octo_flex {
+
+class ObjectManager;
+class WorkerPool;
+
+// Viewer side of a shared scene channel. Creates the segment, then applies the updates a sender
+// publishes on a background thread: each is decoded in place from the arena and submitted to the
+// manager, after which its arena bytes and slot are handed back. Sizes and offsets are kept from
+// creation; only the sender's counters and slots are read back, and those are checked.
+class SharedSceneReceiver : public QThread {
+   public:
+    SharedSceneReceiver(ObjectManager* manager, const std::string& name);
+    ~SharedSceneReceiver() override;
+
+    bool open(const SharedSceneOptions& options, std::string* error);
+
+    // Tell senders the channel is closed, stop the thread and detach.
+    void close();
+
+    SharedSceneStats stats() const;
+
+   protected:
+    void run() override;
+
+   private:
+    void drain();
+    bool apply(const SharedSceneSlot& slot, std::string* error);
+
+    ObjectManager* manager_;
+    std::string name_;
+    QSharedMemory memory_;
+    std::unique_ptr<QSystemSemaphore> signal_;
+    SharedSceneHeader* header_ = nullptr;
+    const SharedSceneSlot* slots_ = nullptr;
+    const uchar* arena_ = nullptr;
+    uint32_t slotCount_ = 0;
+    uint64_t arenaSize_ = 0;
+    std::unique_ptr<WorkerPool> pool_;  // Decodes large updates, created for the first one
+
+    std::atomic<bool> shouldStop_{false};
+    std::atomic<bool> open_{false};
+    std::atomic<uint64_t> updatesApplied_{0};
+    std::atomic<uint64_t> updatesRejected_{0};
+    std::atomic<uint64_t> bytesReceived_{0};
+};
+
+}  // namespace octo_flex
+
+#endif  // SHARED_SCENE_RECEIVER_H
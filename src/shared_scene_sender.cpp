@@ -0,0 +1,263 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "shared_scene.h"
+
+#include <QElapsedTimer>
+#include <QIODevice>
+#include <QSharedMemory>
+#include <QSystemSemaphore>
+#include <QThread>
+#include <algorithm>
+#include <cstring>
+
+#include "object.h"
+#include "scene_update.h"
+#include "shared_scene_format.h"
+
+namespace octo_flex {
+
+namespace {
+
+// Random-access device over a fixed block of memory. Writes past the end are counted but dropped, so
+// a failed pass still tells how large the update is.
+class MemoryDevice : public QIODevice {
+   public:
+    MemoryDevice(uchar* data, uint64_t capacity) : data_(data), capacity_(capacity) {}
+
+    bool isSequential() const override { return false; }
+    qint64 size() const override { return static_cast<qint64>(end_); }
+    bool overflowed() const { return end_ > capacity_; }
+
+   protected:
+    qint64 readData(char*, qint64) override { return -1; }
+
+    qint64 writeData(const char* data, qint64 length) override {
+        const uint64_t at = static_cast<uint64_t>(pos());
+        const uint64_t bytes = static_cast<uint64_t>(length);
+        if (at < capacity_) {
+            std::memcpy(data_ + at, data, static_cast<size_t>(std::min(bytes, capacity_ - at)));
+        }
+        end_ = std::max(end_, at + bytes);
+        return length;
+    }
+
+   private:
+    uchar* data_;
+    uint64_t capacity_;
+    uint64_t end_ = 0;
+};
+
+}  // namespace
+
+struct SharedSceneSender::Impl {
+    QSharedMemory memory;
+    std::unique_ptr<QSystemSemaphore> signal;
+    SharedSceneHeader* header = nullptr;
+    SharedSceneSlot* slots = nullptr;
+    uchar* arena = nullptr;
+    uint32_t slot_count = 0;  // Copied when attaching, checked once
+    uint64_t arena_size = 0;
+    std::string last_error;
+
+    bool attach(const std::string& name);
+    bool send(const SceneUpdate& update, int timeout_ms);
+    // Wait until the receiver left room for an update of size bytes at start, or for a free slot.
+    bool waitFor(uint64_t start, uint64_t size, uint64_t slot, const QElapsedTimer& timer, int timeout_ms);
+};
+
+bool SharedSceneSender::Impl::attach(const std::string& name) {
+    memory.setKey(QString::fromStdString(name));
+    if (!memory.attach()) {
+        last_error = "no shared scene channel " + name + ": " + memory.errorString().toStdString();
+        return false;
+    }
+
+    const uint64_t size = static_cast<uint64_t>(memory.size());
+    header = static_cast<SharedSceneHeader*>(memory.data());
+    if (size < sizeof(SharedSceneHeader) || std::memcmp(header->magic, kSharedMagic, sizeof(kSharedMagic)) != 0 ||
+        header->byte_order != kSharedByteOrder) {
+        last_error = name + " is not a shared scene channel";
+        return false;
+    }
+    if (header->major_version != kSharedMajorVersion) {
+        last_error = name + " has unsupported version " + std::to_string(header->major_version);
+        return false;
+    }
+    slot_count = header->slot_count;
+    arena_size = header->arena_size;
+    const uint64_t slots_offset = header->slots_offset;
+    const uint64_t arena_offset = header->arena_offset;
+    if (header->slot_size < sizeof(SharedSceneSlot) || header->slot_size % kSharedAlignment != 0 ||
+        slot_count == 0 || slots_offset % kSharedAlignment != 0 || arena_offset % kSharedAlignment != 0 ||
+        arena_size % kSharedAlignment != 0 || slots_offset < header->header_size || slots_offset > arena_offset ||
+        static_cast<uint64_t>(header->slot_size) * slot_count > arena_offset - slots_offset || arena_offset > size ||
+        arena_size == 0 || arena_size > size - arena_offset) {
+        last_error = name + " has a damaged header";
+        return false;
+    }
+    if (header->slot_size != sizeof(SharedSceneSlot)) {
+        last_error = name + " has unsupported slots";
+        return false;
+    }
+    if (!header->receiver_open.load(std::memory_order_acquire)) {
+        last_error = "shared scene channel " + name + " is closed";
+        return false;
+    }
+    slots = reinterpret_cast<SharedSceneSlot*>(static_cast<uchar*>(memory.data()) + slots_offset);
+    arena = static_cast<uchar*>(memory.data()) + arena_offset;
+
+    signal = std::make_unique<QSystemSemaphore>(QString::fromStdString(name + ".signal"), 0, QSystemSemaphore::Open);
+    if (signal->error() != QSystemSemaphore::NoError) {
+        last_error = "cannot open the signal of " + name + ": " + signal->errorString().toStdString();
+        return false;
+    }
+    return true;
+}
+
+bool SharedSceneSender::Impl::waitFor(uint64_t start, uint64_t size, uint64_t slot, const QElapsedTimer& timer,
+                                      int timeout_ms) {
+    while (true) {
+        if (!header->receiver_open.load(std::memory_order_acquire)) {
+            last_error = "shared scene channel closed";
+            return false;
+        }
+        const uint64_t arena_tail = header->arena_tail.load(std::memory_order_acquire);
+        const uint64_t slot_tail = header->slot_tail.load(std::memory_order_acquire);
+        if (start + size - arena_tail <= arena_size && slot - slot_tail < slot_count) return true;
+        if (timeout_ms >= 0 && timer.elapsed() >= timeout_ms) {
+            last_error = "shared scene channel full";
+            return false;
+        }
+        QThread::msleep(1);
+    }
+}
+
+bool SharedSceneSender::Impl::send(const SceneUpdate& update, int timeout_ms) {
+    if (!header || !header->receiver_open.load(std::memory_order_acquire)) {
+        last_error = "shared scene channel closed";
+        return false;
+    }
+    QElapsedTimer timer;
+    timer.start();
+
+    const uint64_t slot = header->slot_head.load(std::memory_order_relaxed);
+    const uint64_t head = header->arena_head.load(std::memory_order_relaxed);
+    const uint64_t to_end = arena_size - head % arena_size;
+    uint64_t start = head;
+    uint64_t blob_size = 0;
+
+    // Encode into the room there is now; an update that does not fit is encoded again once there is.
+    const uint64_t room = std::min(to_end, arena_size - (head - header->arena_tail.load(std::memory_order_acquire)));
+    MemoryDevice first(arena + head % arena_size, room);
+    if (!first.open(QIODevice::WriteOnly) || !writeSceneUpdate(&first, update, &blob_size)) {
+        last_error = "cannot encode the update";
+        return false;
+    }
+    uint64_t payload_size = static_cast<uint64_t>(first.size());
+    if (first.overflowed()) {
+        if (sharedAlign(payload_size) > arena_size) {
+            last_error = "update of " + std::to_string(payload_size) + " bytes is larger than the arena";
+            return false;
+        }
+        if (sharedAlign(payload_size) > to_end) start = head + to_end;  // Skip to the arena start
+        if (!waitFor(start, sharedAlign(payload_size), slot, timer, timeout_ms)) return false;
+        MemoryDevice second(arena + start % arena_size, payload_size);
+        if (!second.open(QIODevice::WriteOnly) || !writeSceneUpdate(&second, update, &blob_size) ||
+            second.overflowed()) {
+            last_error = "cannot encode the update";
+            return false;
+        }
+        payload_size = static_cast<uint64_t>(second.size());
+    } else if (!waitFor(start, 0, slot, timer, timeout_ms)) {
+        return false;
+    }
+
+    SharedSceneSlot& entry = slots[slot % slot_count];
+    entry.kind = update.kind;
+    entry.reserved = 0;
+    entry.arena_start = start;
+    entry.arena_end = start + sharedAlign(payload_size);
+    entry.payload_size = payload_size;
+    entry.blob_size = blob_size;
+    header->arena_head.store(entry.arena_end, std::memory_order_release);
+    header->slot_head.store(slot + 1, std::memory_order_release);
+    signal->release();
+    return true;
+}
+
+SharedSceneSender::SharedSceneSender() : impl_(std::make_unique<Impl>()) {}
+
+SharedSceneSender::~SharedSceneSender() = default;
+
+std::shared_ptr<SharedSceneSender> SharedSceneSender::attach(const std::string& name, std::string* error) {
+    std::shared_ptr<SharedSceneSender> sender(new SharedSceneSender());
+    if (!sender->impl_->attach(name)) {
+        if (error) *error = sender->impl_->last_error;
+        return nullptr;
+    }
+    return sender;
+}
+
+bool SharedSceneSender::submit(const std::shared_ptr<Object>& object, const std::string& layer_id, int timeout_ms) {
+    if (!object) {
+        impl_->last_error = "null object";
+        return false;
+    }
+    return submitLayerDelta({object}, {}, layer_id, timeout_ms);
+}
+
+bool SharedSceneSender::submitLayer(const std::vector<std::shared_ptr<Object>>& objects, const std::string& layer_id,
+                                    int timeout_ms) {
+    SceneUpdate update;
+    update.kind = kUpdateReplaceLayer;
+    update.id = layer_id;
+    for (const auto& object : objects) {
+        if (!object) continue;
+        object->setInEditable();
+        update.objects.push_back(object);
+    }
+    return impl_->send(update, timeout_ms);
+}
+
+bool SharedSceneSender::submitLayerDelta(const std::vector<std::shared_ptr<Object>>& upserts,
+                                         const std::vector<std::string>& removed_ids, const std::string& layer_id,
+                                         int timeout_ms) {
+    SceneUpdate update;
+    update.kind = removed_ids.empty() ? kUpdateUpsert : kUpdateDelta;
+    update.id = layer_id;
+    update.removed_ids = removed_ids;
+    for (const auto& object : upserts) {
+        if (!object) continue;
+        object->setInEditable();
+        update.objects.push_back(object);
+    }
+    return impl_->send(update, timeout_ms);
+}
+
+bool SharedSceneSender::updatePose(const std::string& obj_id, const Vec3& position, const Quaternion& orientation,
+                                   int timeout_ms) {
+    SceneUpdate update;
+    update.kind = kUpdatePose;
+    update.id = obj_id;
+    update.position = position;
+    update.orientation = orientation;
+    return impl_->send(update, timeout_ms);
+}
+
+std::string SharedSceneSender::getLastError() const { return impl_->last_error; }
+
+}  // namespace octo_flex
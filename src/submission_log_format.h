@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SUBMISSION_LOG_FORMAT_H
+#define SUBMISSION_LOG_FORMAT_H
+
+#include <cstdint>
+
+namespace octo_flex {
+
+// Layout of submission log files: a LogFileHeader, then entries in submission order, each a
+// LogEntryHeader followed by payload_size bytes and zero padding to a multiple of 16. Entry kinds and
+// payloads are scene updates (see scene_update.h); their snapshots are 16-byte aligned in the file and
+// decoded in place. A log cut short ends at its last complete entry.
+
+const char kLogMagic[8] = {'O', 'F', 'V', 'S', 'L', 'O', 'G', '\0'};
+const uint32_t kLogByteOrder = 0x01020304;
+const uint16_t kLogMajorVersion = 1;  // Readers refuse other major versions
+const uint16_t kLogMinorVersion = 0;  // Minor versions only lengthen the headers, by multiples of 16
+const uint64_t kLogAlignment = 16;
+
+enum LogEntryFlags : uint32_t {
+    kLogResync = 1,  // Keyframe following dropped entries, applied during playback too
+};
+
+struct LogFileHeader {
+    char magic[8];
+    uint32_t byte_order;
+    uint16_t major_version;
+    uint16_t minor_version;
+    uint32_t header_size;
+    uint32_t entry_header_size;
+    int64_t start_time_ms;  // Wall clock at the start of the recording, milliseconds since the epoch
+    uint64_t reserved[2];
+};
+
+struct LogEntryHeader {
+    uint32_t kind;  // SceneUpdateKind
+    uint32_t flags;
+    int64_t time_ns;  // Since the start of the recording, monotonic
+    uint64_t payload_size;
+    uint64_t blob_size;  // Snapshot at the start of the payload
+};
+
+static_assert(sizeof(LogFileHeader) == 48 && sizeof(LogEntryHeader) == 32,
+              "log records must not have padding");
+
+}  // namespace octo_flex
+
+#endif  // SUBMISSION_LOG_FORMAT_H
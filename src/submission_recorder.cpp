@@ -0,0 +1,292 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "submission_recorder.h"
+
+#include <QBuffer>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <algorithm>
+#include <cstring>
+
+#include "object_manager.h"
+#include "submission_log_format.h"
+#include "trace.h"
+
+namespace octo_flex {
+
+SubmissionRecorder::SubmissionRecorder(ObjectManager* manager) : QThread(nullptr), manager_(manager) {}
+
+SubmissionRecorder::~SubmissionRecorder() {
+    std::string ignored;
+    stop(&ignored);
+}
+
+bool SubmissionRecorder::start(const SubmissionLogOptions& options, std::string* error) {
+    if (active_ || isRunning()) {
+        *error = "Submission log already active";
+        return false;
+    }
+
+    file_.setFileName(QString::fromStdString(options.output_path));
+    if (!options.overwrite && file_.exists()) {
+        *error = options.output_path + " already exists";
+        return false;
+    }
+    if (!file_.open(QIODevice::WriteOnly)) {
+        *error = "cannot open " + options.output_path + " for writing";
+        return false;
+    }
+
+    options_ = options;
+    start_ = std::chrono::steady_clock::now();
+    lastError_.clear();
+    shouldStop_ = false;
+    dirty_ = false;
+    entriesWritten_ = 0;
+    keyframesWritten_ = 0;
+    entriesDropped_ = 0;
+    bytesWritten_ = 0;
+
+    LogFileHeader header = {};
+    std::memcpy(header.magic, kLogMagic, sizeof(kLogMagic));
+    header.byte_order = kLogByteOrder;
+    header.major_version = kLogMajorVersion;
+    header.minor_version = kLogMinorVersion;
+    header.header_size = sizeof(LogFileHeader);
+    header.entry_header_size = sizeof(LogEntryHeader);
+    header.start_time_ms = QDateTime::currentMSecsSinceEpoch();
+    buffer_.clear();
+    buffer_.append(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // The log starts from the scene as it is now.
+    {
+        QMutexLocker locker(&queueMutex_);
+        queue_.clear();
+        queue_.push_back(captureKeyframe(0));
+        lastKeyframe_ns_ = 0;
+        resync_ = false;
+        active_ = true;
+    }
+    QThread::start();
+    return true;
+}
+
+bool SubmissionRecorder::stop(std::string* error) {
+    {
+        QMutexLocker locker(&queueMutex_);
+        active_ = false;
+        shouldStop_ = true;
+    }
+    queueCondition_.wakeOne();
+    wait();
+
+    if (!lastError_.empty()) {
+        *error = lastError_;
+        return false;
+    }
+    return true;
+}
+
+SubmissionLogStats SubmissionRecorder::stats() const {
+    SubmissionLogStats stats;
+    stats.entries_written = entriesWritten_;
+    stats.keyframes_written = keyframesWritten_;
+    stats.entries_dropped = entriesDropped_;
+    stats.bytes_written = bytesWritten_;
+    stats.active = active_;
+    return stats;
+}
+
+void SubmissionRecorder::recordUpsert(const std::string& layer_id, std::vector<Object::Ptr> objects) {
+    Entry entry;
+    entry.update.kind = kUpdateUpsert;
+    entry.update.id = layer_id;
+    entry.update.objects = std::move(objects);
+    push(std::move(entry));
+}
+
+void SubmissionRecorder::recordLayer(const std::string& layer_id, std::vector<Object::Ptr> objects) {
+    Entry entry;
+    entry.update.kind = kUpdateReplaceLayer;
+    entry.update.id = layer_id;
+    entry.update.objects = std::move(objects);
+    push(std::move(entry));
+}
+
+void SubmissionRecorder::recordDelta(const std::string& layer_id, std::vector<Object::Ptr> upserts,
+                                     std::vector<std::string> removed_ids) {
+    Entry entry;
+    entry.update.kind = kUpdateDelta;
+    entry.update.id = layer_id;
+    entry.update.objects = std::move(upserts);
+    entry.update.removed_ids = std::move(removed_ids);
+    push(std::move(entry));
+}
+
+void SubmissionRecorder::recordPose(const std::string& obj_id, const Vec3& position, const Quaternion& orientation) {
+    Entry entry;
+    entry.update.kind = kUpdatePose;
+    entry.update.id = obj_id;
+    entry.update.position = position;
+    entry.update.orientation = orientation;
+    push(std::move(entry));
+}
+
+void SubmissionRecorder::markFrame() {
+    if (!active_ || !dirty_.exchange(false)) return;
+    Entry entry;
+    entry.update.kind = kUpdateFrame;
+    push(std::move(entry));
+}
+
+void SubmissionRecorder::push(Entry entry) {
+    if (!active_) return;
+    const bool update = entry.update.kind != kUpdateFrame;
+    bool keyframe_due = false;
+    uint32_t keyframe_flags = 0;
+    {
+        QMutexLocker locker(&queueMutex_);
+        if (!active_) return;
+        if (static_cast<int>(queue_.size()) >= options_.max_queue) {
+            // A keyframe after the next entry that fits brings back what was lost.
+            if (update) {
+                ++entriesDropped_;
+                resync_ = true;
+            }
+            return;
+        }
+        // Stamped under the lock, so times grow in queue order.
+        entry.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_)
+                            .count();
+        const int64_t time_ns = entry.time_ns;
+        queue_.push_back(std::move(entry));
+
+        const int64_t interval_ns = static_cast<int64_t>(options_.keyframe_interval * 1e9);
+        if (update && (resync_ || (interval_ns > 0 && time_ns - lastKeyframe_ns_ >= interval_ns))) {
+            keyframe_due = true;
+            keyframe_flags = resync_ ? kLogResync : 0;
+            resync_ = false;
+            lastKeyframe_ns_ = time_ns;
+        }
+    }
+    if (update) dirty_ = true;
+
+    if (keyframe_due) {
+        // Captured without the lock: taking the layer snapshots may publish them. Keyframes may exceed
+        // max_queue, since they make up for what it dropped.
+        Entry keyframe = captureKeyframe(keyframe_flags);
+        QMutexLocker locker(&queueMutex_);
+        if (active_) {
+            keyframe.time_ns =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_)
+                    .count();
+            queue_.push_back(std::move(keyframe));
+        }
+    }
+    queueCondition_.wakeOne();
+}
+
+SubmissionRecorder::Entry SubmissionRecorder::captureKeyframe(uint32_t flags) const {
+    Entry entry;
+    entry.update.kind = kUpdateKeyframe;
+    entry.flags = flags;
+    for (const auto& layer : *manager_->layersSnapshot()) {
+        entry.snapshots.emplace_back(layer.first, layer.second->snapshot());
+    }
+    return entry;
+}
+
+void SubmissionRecorder::run() {
+    setTraceThreadName("submission log");
+    QElapsedTimer sinceWrite;
+    sinceWrite.start();
+    std::deque<Entry> batch;
+    bool stopping = false;
+    while (!stopping) {
+        {
+            QMutexLocker locker(&queueMutex_);
+            if (queue_.empty() && !shouldStop_) {
+                queueCondition_.wait(&queueMutex_, static_cast<unsigned long>(std::max(options_.flush_interval_ms, 1)));
+            }
+            batch.swap(queue_);
+            stopping = shouldStop_;
+        }
+
+        for (Entry& entry : batch) {
+            encode(entry);
+        }
+        batch.clear();  // Lets go of the objects
+
+        const bool due = static_cast<size_t>(buffer_.size()) >= options_.flush_bytes ||
+                         sinceWrite.elapsed() >= options_.flush_interval_ms;
+        if (!buffer_.isEmpty() && (stopping || due)) {
+            if (!writeBuffer()) break;
+            sinceWrite.restart();
+        }
+    }
+    file_.close();
+}
+
+void SubmissionRecorder::encode(Entry& entry) {
+    OCTO_FLEX_TRACE_ZONE("SubmissionRecorder::encode");
+    // Objects are frozen, so reading them here while the views draw them is safe.
+    for (const auto& layer : entry.snapshots) {
+        SnapshotLayer snapshot;
+        snapshot.id = layer.first;
+        for (const auto& object : layer.second->objects) {
+            snapshot.objects.push_back(object.second);
+        }
+        entry.update.layers.push_back(std::move(snapshot));
+    }
+    QByteArray payload;
+    QBuffer device(&payload);
+    uint64_t blob_size = 0;
+    if (!device.open(QIODevice::WriteOnly) || !writeSceneUpdate(&device, entry.update, &blob_size)) {
+        ++entriesDropped_;
+        return;
+    }
+
+    LogEntryHeader header = {};
+    header.kind = entry.update.kind;
+    header.flags = entry.flags;
+    header.time_ns = entry.time_ns;
+    header.blob_size = blob_size;
+    header.payload_size = static_cast<uint64_t>(payload.size());
+    buffer_.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    buffer_.append(payload);
+    static const char kZeros[kLogAlignment] = {};
+    buffer_.append(kZeros, static_cast<int>((kLogAlignment - header.payload_size % kLogAlignment) % kLogAlignment));
+
+    ++entriesWritten_;
+    if (entry.update.kind == kUpdateKeyframe) ++keyframesWritten_;
+}
+
+bool SubmissionRecorder::writeBuffer() {
+    OCTO_FLEX_TRACE_ZONE("SubmissionRecorder::writeBuffer");
+    const qint64 written = file_.write(buffer_);
+    if (written != buffer_.size() || !file_.flush()) {
+        lastError_ = "failed to write " + options_.output_path;
+        active_ = false;
+        return false;
+    }
+    bytesWritten_ += static_cast<uint64_t>(written);
+    buffer_.clear();
+    return true;
+}
+
+}  // namespace octo_flex
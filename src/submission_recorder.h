@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SUBMISSION_RECORDER_H
+#define SUBMISSION_RECORDER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "layer.h"
+#include "scene_update.h"
+#include "submission_log.h"
+
+namespace octo_flex {
+
+class ObjectManager;
+
+// Background writer of a submission log. The submitting threads only queue references to the frozen
+// objects they submitted; the I/O thread encodes them in the snapshot format and writes in batches.
+// Entries are stamped when queued, so the log keeps the order they were applied in; keyframes are
+// taken from the manager right after the entry that made them due. Replaying an entry twice leaves
+// the scene as replaying it once, so updates that race with a keyframe are harmless.
+class SubmissionRecorder : public QThread {
+   public:
+    explicit SubmissionRecorder(ObjectManager* manager);
+    ~SubmissionRecorder() override;
+
+    // Create the log, write its first keyframe and start the I/O thread.
+    bool start(const SubmissionLogOptions& options, std::string* error);
+
+    // Write everything queued so far and close the log; later records are ignored.
+    bool stop(std::string* error);
+
+    bool isActive() const { return active_; }
+    SubmissionLogStats stats() const;
+
+    // Called by the manager after it applied the update. Never block on the I/O thread.
+    void recordUpsert(const std::string& layer_id, std::vector<Object::Ptr> objects);
+    void recordLayer(const std::string& layer_id, std::vector<Object::Ptr> objects);
+    void recordDelta(const std::string& layer_id, std::vector<Object::Ptr> upserts,
+                     std::vector<std::string> removed_ids);
+    void recordPose(const std::string& obj_id, const Vec3& position, const Quaternion& orientation);
+
+    // Called at frame start; marks the end of a frame if anything was recorded since the last mark.
+    void markFrame();
+
+   protected:
+    void run() override;
+
+   private:
+    struct Entry {
+        uint32_t flags = 0;
+        int64_t time_ns = 0;
+        SceneUpdate update;  // Without the layers of keyframes, which are taken from snapshots when encoded
+        std::vector<std::pair<std::string, LayerSnapshotPtr>> snapshots;  // Keyframes
+    };
+
+    void push(Entry entry);
+    Entry captureKeyframe(uint32_t flags) const;
+    void encode(Entry& entry);
+    bool writeBuffer();
+
+    ObjectManager* manager_;
+    SubmissionLogOptions options_;
+    std::chrono::steady_clock::time_point start_;
+    QFile file_;        // Written by the I/O thread once started
+    QByteArray buffer_;  // Encoded entries not written yet, I/O thread only
+
+    std::deque<Entry> queue_;
+    mutable QMutex queueMutex_;
+    QWaitCondition queueCondition_;
+    int64_t lastKeyframe_ns_ = 0;  // Guarded by queueMutex_
+    bool resync_ = false;          // Entries were dropped; guarded by queueMutex_
+
+    std::atomic<bool> active_{false};
+    std::atomic<bool> shouldStop_{false};
+    std::atomic<bool> dirty_{false};  // Recorded since the last frame mark
+    std::atomic<uint64_t> entriesWritten_{0};
+    std::atomic<uint64_t> keyframesWritten_{0};
+    std::atomic<uint64_t> entriesDropped_{0};
+    std::atomic<uint64_t> bytesWritten_{0};
+    std::string lastError_;  // Set by the I/O thread, read after it finished
+};
+
+}  // namespace octo_flex
+
+#endif  // SUBMISSION_RECORDER_H
@@ -0,0 +1,277 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "submission_log.h"
+
+#include <QFile>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "object_manager.h"
+#include "scene_update.h"
+#include "submission_log_format.h"
+#include "worker_pool.h"
+
+namespace octo_flex {
+
+namespace {
+
+// Read-only mapping of a log, kept while the replay or shapes uploading from it need it.
+struct MappedLog {
+    QFile file;
+    const uchar* data = nullptr;
+    uint64_t size = 0;
+};
+
+struct LogEntry {
+    uint32_t kind;
+    uint32_t flags;
+    int64_t time_ns;
+    uint64_t payload;  // File offset
+    uint64_t payload_size;
+    uint64_t blob_size;
+};
+
+int64_t toNanoseconds(double seconds) { return static_cast<int64_t>(std::llround(seconds * 1e9)); }
+
+}  // namespace
+
+struct SubmissionReplay::Impl {
+    std::shared_ptr<MappedLog> log;
+    std::shared_ptr<ObjectManager> target;
+    std::vector<LogEntry> entries;
+    std::vector<size_t> keyframes;  // Indices into entries, by time
+    size_t frames = 0;
+
+    size_t next = 0;  // Entry to apply next
+    int64_t position_ns = 0;
+    double speed = 1.0;
+    bool playing = false;
+    std::chrono::steady_clock::time_point last_update;
+
+    std::unique_ptr<WorkerPool> pool;  // Decodes keyframes, created for the first one
+    std::string last_error;
+
+    int64_t duration() const { return entries.back().time_ns; }
+
+    // Apply entries[next] and move past it; false if it was skipped or failed.
+    bool applyNext(bool force_keyframe = false);
+    size_t applyThrough(int64_t time_ns);
+
+    bool apply(const LogEntry& entry);
+    void fail(const LogEntry& entry, const std::string& message);
+};
+
+bool SubmissionReplay::Impl::applyNext(bool force_keyframe) {
+    const size_t index = next++;
+    const LogEntry& entry = entries[index];
+    position_ns = std::max(position_ns, entry.time_ns);
+
+    // Keyframes repeat what the updates before them built, except the first one and those that
+    // make up for dropped updates.
+    if (entry.kind == kUpdateKeyframe && !force_keyframe && index != 0 && !(entry.flags & kLogResync)) {
+        return false;
+    }
+    return apply(entry);
+}
+
+size_t SubmissionReplay::Impl::applyThrough(int64_t time_ns) {
+    size_t applied = 0;
+    while (next < entries.size() && entries[next].time_ns <= time_ns) {
+        if (applyNext()) ++applied;
+    }
+    return applied;
+}
+
+void SubmissionReplay::Impl::fail(const LogEntry& entry, const std::string& message) {
+    last_error = "entry at " + std::to_string(static_cast<double>(entry.time_ns) * 1e-9) + " s: " + message;
+}
+
+bool SubmissionReplay::Impl::apply(const LogEntry& entry) {
+    // Frame marks, and kinds of newer minor versions, change nothing.
+    if (entry.kind < kUpdateKeyframe || entry.kind > kUpdatePose) return false;
+    WorkerPool* workers = nullptr;
+    if (entry.kind == kUpdateKeyframe) {
+        if (!pool) pool = std::make_unique<WorkerPool>();
+        workers = pool.get();
+    }
+    std::string error;
+    if (!applySceneUpdate(*target, entry.kind, log->data + entry.payload, entry.payload_size, entry.blob_size, log,
+                          workers, &error)) {
+        fail(entry, error);
+        return false;
+    }
+    return true;
+}
+
+SubmissionReplay::SubmissionReplay() : impl_(std::make_unique<Impl>()) {}
+
+SubmissionReplay::~SubmissionReplay() = default;
+
+std::shared_ptr<SubmissionReplay> SubmissionReplay::open(const std::string& path,
+                                                         std::shared_ptr<ObjectManager> target, std::string* error) {
+    std::string ignored;
+    std::string& message = error ? *error : ignored;
+    if (!target) {
+        message = "No object manager to replay into";
+        return nullptr;
+    }
+
+    auto log = std::make_shared<MappedLog>();
+    log->file.setFileName(QString::fromStdString(path));
+    if (!log->file.open(QIODevice::ReadOnly)) {
+        message = "cannot open " + path;
+        return nullptr;
+    }
+    const qint64 size = log->file.size();
+    if (size < static_cast<qint64>(sizeof(LogFileHeader))) {
+        message = path + " is not a submission log";
+        return nullptr;
+    }
+    log->data = log->file.map(0, size);
+    if (!log->data) {
+        message = "cannot map " + path;
+        return nullptr;
+    }
+    log->size = static_cast<uint64_t>(size);
+
+    LogFileHeader header;
+    std::memcpy(&header, log->data, sizeof(header));
+    if (std::memcmp(header.magic, kLogMagic, sizeof(kLogMagic)) != 0) {
+        message = path + " is not a submission log";
+        return nullptr;
+    }
+    if (header.byte_order != kLogByteOrder) {
+        message = path + " was written on a machine of the other byte order";
+        return nullptr;
+    }
+    if (header.major_version != kLogMajorVersion) {
+        message = path + ": unsupported log version " + std::to_string(header.major_version) + "." +
+                  std::to_string(header.minor_version);
+        return nullptr;
+    }
+    if (header.header_size < sizeof(LogFileHeader) || header.header_size % kLogAlignment != 0 ||
+        header.entry_header_size < sizeof(LogEntryHeader) || header.entry_header_size % kLogAlignment != 0 ||
+        header.header_size > log->size) {
+        message = path + ": damaged log header";
+        return nullptr;
+    }
+
+    std::shared_ptr<SubmissionReplay> replay(new SubmissionReplay());
+    Impl& impl = *replay->impl_;
+
+    // Index the entries; a log cut short by a crash ends at its last complete entry.
+    uint64_t offset = header.header_size;
+    int64_t last_time = 0;
+    while (log->size - offset >= header.entry_header_size) {
+        LogEntryHeader entry;
+        std::memcpy(&entry, log->data + offset, sizeof(entry));
+        const uint64_t payload = offset + header.entry_header_size;
+        if (entry.payload_size > log->size - payload || entry.blob_size > entry.payload_size) break;
+
+        last_time = std::max(last_time, entry.time_ns);
+        if (entry.kind == kUpdateKeyframe) impl.keyframes.push_back(impl.entries.size());
+        if (entry.kind == kUpdateFrame) ++impl.frames;
+        impl.entries.push_back({entry.kind, entry.flags, last_time, payload, entry.payload_size, entry.blob_size});
+
+        const uint64_t padded = (entry.payload_size + kLogAlignment - 1) / kLogAlignment * kLogAlignment;
+        if (padded > log->size - payload) break;
+        offset = payload + padded;
+    }
+    if (impl.entries.empty() || impl.entries[0].kind != kUpdateKeyframe) {
+        message = path + " has no keyframe";
+        return nullptr;
+    }
+
+    impl.log = std::move(log);
+    impl.target = std::move(target);
+    return replay;
+}
+
+double SubmissionReplay::duration() const { return static_cast<double>(impl_->duration()) * 1e-9; }
+
+double SubmissionReplay::position() const { return static_cast<double>(impl_->position_ns) * 1e-9; }
+
+size_t SubmissionReplay::frameCount() const { return impl_->frames; }
+
+bool SubmissionReplay::atEnd() const { return impl_->next >= impl_->entries.size(); }
+
+size_t SubmissionReplay::advance(double seconds) {
+    const int64_t target = impl_->position_ns + std::max<int64_t>(toNanoseconds(seconds), 0);
+    const size_t applied = impl_->applyThrough(target);
+    impl_->position_ns = std::min(target, impl_->duration());
+    return applied;
+}
+
+size_t SubmissionReplay::stepFrame() {
+    size_t applied = 0;
+    while (!atEnd()) {
+        const bool frame = impl_->entries[impl_->next].kind == kUpdateFrame;
+        if (impl_->applyNext()) ++applied;
+        if (frame) break;
+    }
+    return applied;
+}
+
+bool SubmissionReplay::seek(double seconds) {
+    const int64_t target = std::min(std::max<int64_t>(toNanoseconds(seconds), 0), impl_->duration());
+    impl_->last_error.clear();
+
+    // Last keyframe at or before the target; the log starts with one.
+    const auto& entries = impl_->entries;
+    auto it = std::upper_bound(impl_->keyframes.begin(), impl_->keyframes.end(), target,
+                               [&](int64_t time, size_t index) { return time < entries[index].time_ns; });
+    const size_t keyframe = *(it - 1);
+
+    // Forwards past that keyframe, the updates since the current position are enough.
+    if (target < impl_->position_ns || keyframe >= impl_->next) {
+        impl_->next = keyframe;
+        impl_->position_ns = entries[keyframe].time_ns;
+        impl_->applyNext(true);
+    }
+    impl_->applyThrough(target);
+    impl_->position_ns = target;
+    return impl_->last_error.empty();
+}
+
+void SubmissionReplay::play(double speed) {
+    impl_->speed = std::max(speed, 0.0);
+    impl_->playing = true;
+    impl_->last_update = std::chrono::steady_clock::now();
+}
+
+void SubmissionReplay::pause() { impl_->playing = false; }
+
+bool SubmissionReplay::isPlaying() const { return impl_->playing; }
+
+double SubmissionReplay::speed() const { return impl_->speed; }
+
+size_t SubmissionReplay::update() {
+    if (!impl_->playing) return 0;
+    const auto now = std::chrono::steady_clock::now();
+    const double elapsed = std::chrono::duration<double>(now - impl_->last_update).count();
+    impl_->last_update = now;
+    const size_t applied = advance(elapsed * impl_->speed);
+    if (atEnd()) impl_->playing = false;
+    return applied;
+}
+
+std::string SubmissionReplay::getLastError() const { return impl_->last_error; }
+
+}  // namespace octo_flex
@@ -0,0 +1,444 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "text_renderer.h"
+#include <QImage>
+#include <QPainter>
+#include <QString>
+#include <QVector>
+#include <QtDebug>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include "gl_deletion_queue.h"
+
+namespace octo_flex {
+namespace {
+
+const GLuint kAttrPosition = 0;
+const GLuint kAttrColor = 1;
+const GLuint kAttrTexCoord = 2;
+const GLuint kAttrAnchor = 3;
+
+// Prepended per stage: GLSL 1.20 on older compatibility contexts, GLSL 1.50 or GLSL ES 3.00 otherwise.
+const char* kLegacyVertexHeader = "#version 120\n#define ATTRIBUTE attribute\n#define VARYING varying\n";
+const char* kLegacyFragmentHeader =
+    "#version 120\n#define VARYING varying\n#define TEXTURE texture2D\n#define FRAG_COLOR gl_FragColor\n";
+const char* kDesktopHeader = "#version 150\n";
+const char* kEsHeader = "#version 300 es\nprecision highp float;\n";
+const char* kVertexDefines = "#define ATTRIBUTE in\n#define VARYING out\n";
+const char* kFragmentDefines =
+    "#define VARYING in\n#define TEXTURE texture\nout vec4 o_color;\n#define FRAG_COLOR o_color\n";
+
+// Positions are logical pixels with Y down; the atlas is addressed in texels.
+const char* kVertexShader = R"(
+ATTRIBUTE vec2 a_position;
+ATTRIBUTE vec4 a_color;
+ATTRIBUTE vec2 a_uv;
+ATTRIBUTE vec2 a_anchor;
+uniform vec2 u_viewport;
+uniform vec2 u_atlas_size;
+VARYING vec2 v_uv;
+VARYING vec4 v_color;
+void main() {
+    vec2 p = (a_anchor + a_position) / u_viewport * 2.0 - 1.0;
+    gl_Position = vec4(p.x, -p.y, 0.0, 1.0);
+    v_uv = a_uv / u_atlas_size;
+    v_color = a_color;
+}
+)";
+
+// The field is 0.5 on the glyph outline; antialias over one screen pixel whatever the text size.
+const char* kFragmentShader = R"(
+VARYING vec2 v_uv;
+VARYING vec4 v_color;
+uniform sampler2D u_atlas;
+void main() {
+    float field = TEXTURE(u_atlas, v_uv).r;
+    float width = max(fwidth(field), 1e-3);
+    FRAG_COLOR = vec4(v_color.rgb, v_color.a * smoothstep(0.5 - width, 0.5 + width, field));
+}
+)";
+
+uint8_t toByte(float value) { return static_cast<uint8_t>(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f); }
+
+}  // namespace
+
+TextBatch::~TextBatch() {
+    GlDeletionQueue::instance()->deleteBuffers(glGroup_, {vertexBuffer_, anchorBuffer_});
+    if (owner_) {
+        owner_->batches_.erase(std::remove(owner_->batches_.begin(), owner_->batches_.end(), this),
+                               owner_->batches_.end());
+    }
+}
+
+void TextBatch::clear() {
+    vertices_.clear();
+    runFirst_.clear();
+    anchors_.clear();
+    layoutChanged_ = true;
+}
+
+size_t TextBatch::beginRun() {
+    runFirst_.push_back(vertices_.size());
+    return runFirst_.size() - 1;
+}
+
+void TextBatch::setAnchor(size_t run, float x, float y) {
+    if (run >= runFirst_.size()) return;
+    const size_t end = run + 1 < runFirst_.size() ? runFirst_[run + 1] : vertices_.size();
+    const glm::vec2 anchor(x, y);
+    for (size_t i = runFirst_[run]; i < end; ++i) {
+        if (anchors_[i] == anchor) continue;
+        anchors_[i] = anchor;
+        anchorsChanged_ = true;
+    }
+}
+
+void TextBatch::addRect(const TextRenderer& renderer, float x, float y, float width, float height,
+                        const glm::vec4& color) {
+    addQuad(x, y, x + width, y + height, renderer.solidU_, renderer.solidV_, renderer.solidU_, renderer.solidV_,
+            color);
+}
+
+float TextBatch::addText(TextRenderer& renderer, const std::string& text, float x, float y, float pixelSize,
+                         const glm::vec4& color) {
+    const float scale = pixelSize / TextRenderer::kBaseSize;
+    float pen = x;
+    for (uint codePoint : QString::fromStdString(text).toUcs4()) {
+        const TextRenderer::Glyph& glyph = renderer.glyph(codePoint);
+        if (glyph.valid) {
+            addQuad(pen + glyph.x0 * scale, y + glyph.y0 * scale, pen + glyph.x1 * scale, y + glyph.y1 * scale,
+                    glyph.u, glyph.v, glyph.u + (glyph.x1 - glyph.x0), glyph.v + (glyph.y1 - glyph.y0), color);
+        }
+        pen += glyph.advance * scale;
+    }
+    return pen - x;
+}
+
+void TextBatch::addQuad(float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1,
+                        const glm::vec4& color) {
+    if (runFirst_.empty()) beginRun();
+    const uint8_t r = toByte(color.r), g = toByte(color.g), b = toByte(color.b), a = toByte(color.a);
+    const Vertex corners[4] = {
+        {x0, y0, u0, v0, {r, g, b, a}},
+        {x1, y0, u1, v0, {r, g, b, a}},
+        {x1, y1, u1, v1, {r, g, b, a}},
+        {x0, y1, u0, v1, {r, g, b, a}},
+    };
+    for (int corner : {0, 1, 2, 0, 2, 3}) vertices_.push_back(corners[corner]);
+    anchors_.resize(vertices_.size(), glm::vec2(0.0f));
+    layoutChanged_ = true;
+}
+
+TextRenderer::TextRenderer() {}
+
+TextRenderer::~TextRenderer() {
+    for (TextBatch* batch : batches_) batch->owner_ = nullptr;
+}
+
+bool TextRenderer::initialize(QOpenGLContext* context, const QFont& font) {
+    release();
+    initializeOpenGLFunctions();
+
+    const QSurfaceFormat format = context->format();
+    const bool es = context->isOpenGLES();
+    if (es && format.version() < qMakePair(3, 0)) {
+        qWarning() << "TextRenderer: Needs OpenGL ES 3.0, drawing text with QPainter.";
+        return false;
+    }
+    legacy_ = !es && format.version() < qMakePair(3, 2);
+
+    const QByteArray header = es ? kEsHeader : kDesktopHeader;
+    const QByteArray vertexHeader = legacy_ ? QByteArray(kLegacyVertexHeader) : header + kVertexDefines;
+    const QByteArray fragmentHeader = legacy_ ? QByteArray(kLegacyFragmentHeader) : header + kFragmentDefines;
+    std::unique_ptr<QOpenGLShaderProgram> program(new QOpenGLShaderProgram());
+    const bool compiled =
+        program->addShaderFromSourceCode(QOpenGLShader::Vertex, vertexHeader + kVertexShader) &&
+        program->addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentHeader + kFragmentShader);
+    program->bindAttributeLocation("a_position", kAttrPosition);
+    program->bindAttributeLocation("a_color", kAttrColor);
+    program->bindAttributeLocation("a_uv", kAttrTexCoord);
+    program->bindAttributeLocation("a_anchor", kAttrAnchor);
+    if (!compiled || !program->link()) {
+        qWarning() << "TextRenderer: Drawing text with QPainter, shader failed:" << program->log();
+        return false;
+    }
+    viewportLocation_ = program->uniformLocation("u_viewport");
+    atlasSizeLocation_ = program->uniformLocation("u_atlas_size");
+    atlasLocation_ = program->uniformLocation("u_atlas");
+    program_ = std::move(program);
+
+    // Core profiles need a vertex array object; attributes are set up without one where it is missing.
+    vao_.create();
+
+    font_ = font;
+    font_.setPixelSize(kBaseSize);
+    metrics_.reset(new QFontMetricsF(font_));
+
+    // Rectangles sample the middle of a solid block, which is inside everywhere.
+    atlasWidth_ = 1024;
+    atlasHeight_ = 256;
+    atlasPixels_.assign(static_cast<size_t>(atlasWidth_) * atlasHeight_, 0);
+    int x = 0;
+    int y = 0;
+    allocate(4, 4, x, y);
+    for (int row = 0; row < 4; ++row) {
+        std::fill_n(&atlasPixels_[static_cast<size_t>(y + row) * atlasWidth_ + x], 4, uint8_t(255));
+    }
+    solidU_ = x + 2.0f;
+    solidV_ = y + 2.0f;
+
+    glGenTextures(1, &atlas_);
+    glBindTexture(GL_TEXTURE_2D, atlas_);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    atlasResized_ = true;
+    return true;
+}
+
+void TextRenderer::release() {
+    // Batches lay out again against the new atlas.
+    for (TextBatch* batch : batches_) {
+        releaseBatch(*batch);
+        batch->clear();
+        batch->owner_ = nullptr;
+    }
+    batches_.clear();
+    if (atlas_ != 0) glDeleteTextures(1, &atlas_);
+    atlas_ = 0;
+    vao_.destroy();
+    program_.reset();
+    glyphs_.clear();
+    metrics_.reset();
+    atlasPixels_.clear();
+    shelfX_ = 0;
+    shelfY_ = 0;
+    shelfHeight_ = 0;
+    dirtyTop_ = 0;
+    dirtyBottom_ = 0;
+    atlasFullWarned_ = false;
+}
+
+void TextRenderer::releaseBatch(TextBatch& batch) {
+    GlDeletionQueue::instance()->deleteBuffers(batch.glGroup_, {batch.vertexBuffer_, batch.anchorBuffer_});
+    batch.vertexBuffer_ = 0;
+    batch.anchorBuffer_ = 0;
+    batch.uploadedVertices_ = 0;
+}
+
+float TextRenderer::advance(const std::string& text, float pixelSize) {
+    if (!metrics_) return 0.0f;
+    float width = 0.0f;
+    for (uint codePoint : QString::fromStdString(text).toUcs4()) width += glyph(codePoint).advance;
+    return width * pixelSize / kBaseSize;
+}
+
+const TextRenderer::Glyph& TextRenderer::glyph(uint32_t codePoint) {
+    auto found = glyphs_.find(codePoint);
+    if (found != glyphs_.end()) return found->second;
+    Glyph& glyph = glyphs_[codePoint];
+    if (!metrics_) return glyph;
+
+    const uint ucs4 = codePoint;
+    const QString text = QString::fromUcs4(&ucs4, 1);
+    glyph.advance = static_cast<float>(metrics_->horizontalAdvance(text));
+    const QRectF bounds = metrics_->boundingRect(text);
+    if (bounds.isEmpty()) return glyph;  // Spaces only advance
+
+    // The cell leaves room for the field around the outline; the pen sits at -x0, -y0 in it.
+    const int left = static_cast<int>(std::floor(bounds.left())) - kSpread;
+    const int top = static_cast<int>(std::floor(bounds.top())) - kSpread;
+    const int width = static_cast<int>(std::ceil(bounds.right())) + kSpread - left;
+    const int height = static_cast<int>(std::ceil(bounds.bottom())) + kSpread - top;
+    int x = 0;
+    int y = 0;
+    if (!allocate(width, height, x, y)) {
+        if (!atlasFullWarned_) {
+            qWarning() << "TextRenderer: Glyph atlas is full, further glyphs are not drawn.";
+            atlasFullWarned_ = true;
+        }
+        return glyph;
+    }
+
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    {
+        QPainter painter(&image);
+        painter.setFont(font_);
+        painter.setPen(Qt::white);
+        painter.drawText(QPointF(-left, -top), text);
+    }
+
+    // Signed distance to the nearest pixel across the outline, within the spread: 0.5 on the outline,
+    // rising to 1 inside and falling to 0 outside.
+    std::vector<uint8_t> inside(static_cast<size_t>(width) * height);
+    for (int row = 0; row < height; ++row) {
+        const QRgb* line = reinterpret_cast<const QRgb*>(image.constScanLine(row));
+        for (int column = 0; column < width; ++column) {
+            inside[static_cast<size_t>(row) * width + column] = qAlpha(line[column]) > 127;
+        }
+    }
+    for (int row = 0; row < height; ++row) {
+        for (int column = 0; column < width; ++column) {
+            const uint8_t self = inside[static_cast<size_t>(row) * width + column];
+            int nearest = kSpread * kSpread;
+            for (int dy = -kSpread; dy <= kSpread; ++dy) {
+                const int sy = row + dy;
+                if (sy < 0 || sy >= height) {
+                    if (self) nearest = std::min(nearest, dy * dy);  // Outside the cell is outside the glyph
+                    continue;
+                }
+                for (int dx = -kSpread; dx <= kSpread; ++dx) {
+                    const int sx = column + dx;
+                    const bool other = sx < 0 || sx >= width ? self != 0
+                                                             : inside[static_cast<size_t>(sy) * width + sx] != self;
+                    if (other) nearest = std::min(nearest, dx * dx + dy * dy);
+                }
+            }
+            const float distance = std::sqrt(static_cast<float>(nearest)) - 0.5f;
+            const float value = 0.5f + (self ? distance : -distance) / (2.0f * kSpread);
+            atlasPixels_[static_cast<size_t>(y + row) * atlasWidth_ + x + column] = toByte(value);
+        }
+    }
+    dirtyTop_ = dirtyTop_ < dirtyBottom_ ? std::min(dirtyTop_, y) : y;
+    dirtyBottom_ = std::max(dirtyBottom_, y + height);
+
+    glyph.valid = true;
+    glyph.x0 = static_cast<float>(left);
+    glyph.y0 = static_cast<float>(top);
+    glyph.x1 = static_cast<float>(left + width);
+    glyph.y1 = static_cast<float>(top + height);
+    glyph.u = static_cast<float>(x);
+    glyph.v = static_cast<float>(y);
+    return glyph;
+}
+
+bool TextRenderer::allocate(int width, int height, int& x, int& y) {
+    if (width > atlasWidth_) return false;
+    if (shelfX_ + width > atlasWidth_) {
+        shelfY_ += shelfHeight_;
+        shelfX_ = 0;
+        shelfHeight_ = 0;
+    }
+    // Rows are appended, so texel coordinates of placed glyphs stay valid.
+    while (shelfY_ + height > atlasHeight_) {
+        if (atlasHeight_ * 2 > kMaxAtlasSize) return false;
+        atlasHeight_ *= 2;
+        atlasPixels_.resize(static_cast<size_t>(atlasWidth_) * atlasHeight_, 0);
+        atlasResized_ = true;
+    }
+    x = shelfX_;
+    y = shelfY_;
+    shelfX_ += width + 1;  // A texel of gap keeps filtering from bleeding into neighbors
+    shelfHeight_ = std::max(shelfHeight_, height + 1);
+    return true;
+}
+
+void TextRenderer::uploadAtlas() {
+    const GLint internalFormat = legacy_ ? GL_LUMINANCE : GL_R8;
+    const GLenum format = legacy_ ? GL_LUMINANCE : GL_RED;
+    glBindTexture(GL_TEXTURE_2D, atlas_);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    if (atlasResized_) {
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, atlasWidth_, atlasHeight_, 0, format, GL_UNSIGNED_BYTE,
+                     atlasPixels_.data());
+        atlasResized_ = false;
+    } else if (dirtyTop_ < dirtyBottom_) {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, dirtyTop_, atlasWidth_, dirtyBottom_ - dirtyTop_, format,
+                        GL_UNSIGNED_BYTE, &atlasPixels_[static_cast<size_t>(dirtyTop_) * atlasWidth_]);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    dirtyTop_ = 0;
+    dirtyBottom_ = 0;
+}
+
+void TextRenderer::draw(TextBatch& batch, float width, float height) {
+    if (!program_ || batch.vertices_.empty() || width <= 0.0f || height <= 0.0f) return;
+    if (batch.owner_ != this) {
+        batch.owner_ = this;
+        batches_.push_back(&batch);
+    }
+    if (atlasResized_ || dirtyTop_ < dirtyBottom_) uploadAtlas();
+
+    // The layout uploads when the text changed, the anchors when the runs moved.
+    const size_t count = batch.vertices_.size();
+    if (batch.vertexBuffer_ == 0) {
+        glGenBuffers(1, &batch.vertexBuffer_);
+        glGenBuffers(1, &batch.anchorBuffer_);
+        batch.glGroup_ = GlDeletionQueue::instance()->currentGroup();
+    }
+    if (batch.layoutChanged_) {
+        glBindBuffer(GL_ARRAY_BUFFER, batch.vertexBuffer_);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(count * sizeof(TextBatch::Vertex)),
+                     batch.vertices_.data(), GL_STATIC_DRAW);
+        batch.layoutChanged_ = false;
+        batch.anchorsChanged_ = true;
+    }
+    if (batch.anchorsChanged_) {
+        glBindBuffer(GL_ARRAY_BUFFER, batch.anchorBuffer_);
+        const GLsizeiptr bytes = static_cast<GLsizeiptr>(count * sizeof(glm::vec2));
+        if (batch.uploadedVertices_ != count) {
+            glBufferData(GL_ARRAY_BUFFER, bytes, batch.anchors_.data(), GL_DYNAMIC_DRAW);
+            batch.uploadedVertices_ = count;
+        } else {
+            glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, batch.anchors_.data());
+        }
+        batch.anchorsChanged_ = false;
+    }
+
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    program_->bind();
+    program_->setUniformValue(viewportLocation_, width, height);
+    program_->setUniformValue(atlasSizeLocation_, static_cast<float>(atlasWidth_), static_cast<float>(atlasHeight_));
+    program_->setUniformValue(atlasLocation_, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, atlas_);
+
+    vao_.bind();
+    const GLsizei stride = sizeof(TextBatch::Vertex);
+    glBindBuffer(GL_ARRAY_BUFFER, batch.vertexBuffer_);
+    glEnableVertexAttribArray(kAttrPosition);
+    glVertexAttribPointer(kAttrPosition, 2, GL_FLOAT, GL_FALSE, stride,
+                          reinterpret_cast<const void*>(offsetof(TextBatch::Vertex, x)));
+    glEnableVertexAttribArray(kAttrTexCoord);
+    glVertexAttribPointer(kAttrTexCoord, 2, GL_FLOAT, GL_FALSE, stride,
+                          reinterpret_cast<const void*>(offsetof(TextBatch::Vertex, u)));
+    glEnableVertexAttribArray(kAttrColor);
+    glVertexAttribPointer(kAttrColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+                          reinterpret_cast<const void*>(offsetof(TextBatch::Vertex, color)));
+    glBindBuffer(GL_ARRAY_BUFFER, batch.anchorBuffer_);
+    glEnableVertexAttribArray(kAttrAnchor);
+    glVertexAttribPointer(kAttrAnchor, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), nullptr);
+
+    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(count));
+
+    glDisableVertexAttribArray(kAttrPosition);
+    glDisableVertexAttribArray(kAttrTexCoord);
+    glDisableVertexAttribArray(kAttrColor);
+    glDisableVertexAttribArray(kAttrAnchor);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    vao_.release();
+    glBindTexture(GL_TEXTURE_2D, 0);
+    program_->release();
+}
+
+}  // namespace octo_flex
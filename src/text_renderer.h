@@ -0,0 +1,158 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TEXT_RENDERER_H
+#define TEXT_RENDERER_H
+
+#include <QFont>
+#include <QFontMetricsF>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLVertexArrayObject>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace octo_flex {
+
+class TextRenderer;
+
+// Screen-space text as glyph and rectangle quads, in logical pixels with Y down (as QPainter).
+// The quads are grouped in runs that each move with one anchor: the layout is built once and
+// rebuilt only when the text changes, while setAnchor() moves the runs every frame.
+class TextBatch {
+   public:
+    TextBatch() {}
+    ~TextBatch();
+    TextBatch(const TextBatch&) = delete;
+    TextBatch& operator=(const TextBatch&) = delete;
+
+    // Drop the layout (and the runs).
+    void clear();
+    bool empty() const { return vertices_.empty(); }
+
+    // Start the next run; the quads added until the next call move with its anchor.
+    size_t beginRun();
+    size_t runCount() const { return runFirst_.size(); }
+    void setAnchor(size_t run, float x, float y);
+
+    // Filled rectangle relative to the run anchor.
+    void addRect(const TextRenderer& renderer, float x, float y, float width, float height, const glm::vec4& color);
+    // UTF-8 text with its baseline starting at x, y relative to the run anchor. Returns the advance.
+    float addText(TextRenderer& renderer, const std::string& text, float x, float y, float pixelSize,
+                  const glm::vec4& color);
+
+   private:
+    friend class TextRenderer;
+
+    struct Vertex {
+        float x, y;          // Offset from the run anchor
+        float u, v;          // Atlas texels
+        uint8_t color[4];
+    };
+
+    void addQuad(float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1,
+                 const glm::vec4& color);
+
+    std::vector<Vertex> vertices_;
+    std::vector<size_t> runFirst_;      // First vertex of each run
+    std::vector<glm::vec2> anchors_;    // One per vertex, rewritten by setAnchor()
+    bool layoutChanged_ = true;         // Vertices not uploaded yet
+    bool anchorsChanged_ = true;
+    GLuint vertexBuffer_ = 0;
+    GLuint anchorBuffer_ = 0;
+    size_t uploadedVertices_ = 0;       // Capacity of the buffers
+    uint32_t glGroup_ = 0;              // Share group the buffers were created in
+    TextRenderer* owner_ = nullptr;     // Renderer owning the buffers
+};
+
+// Draws text batches from a signed distance field glyph atlas, one draw call per batch, without
+// QPainter's state save and restore. Glyphs are rasterized once at a base size and scale to any
+// pixel size; the atlas grows as glyphs are added. Used with the view's context current.
+class TextRenderer : protected QOpenGLExtraFunctions {
+   public:
+    TextRenderer();
+    ~TextRenderer();
+
+    // Build the program and the atlas for font (its family and style); false if the context cannot.
+    bool initialize(QOpenGLContext* context, const QFont& font);
+    // Delete the atlas, the program and the buffers of batches drawn; the context must be current.
+    void release();
+    bool isValid() const { return program_ != nullptr; }
+
+    // Metrics of the font at pixelSize, matching those QPainter lays the text out with.
+    float advance(const std::string& text, float pixelSize);
+    float height(float pixelSize) const { return static_cast<float>(metrics_->height()) * pixelSize / kBaseSize; }
+
+    // Draw batch over a viewport of width x height logical pixels; blends and leaves the depth test off.
+    void draw(TextBatch& batch, float width, float height);
+
+   private:
+    friend class TextBatch;
+
+    struct Glyph {
+        bool valid = false;    // Whether it made it into the atlas
+        float advance = 0.0f;  // At the base size
+        float x0 = 0.0f, y0 = 0.0f, x1 = 0.0f, y1 = 0.0f;  // Quad relative to the pen, at the base size
+        float u = 0.0f, v = 0.0f;                          // Atlas texel of the quad's top left corner
+    };
+
+    static const int kBaseSize = 32;     // Pixel size glyphs are rasterized at
+    static const int kSpread = 6;        // Distance range of the field, in base pixels
+    static const int kMaxAtlasSize = 4096;
+
+    // Rasterize code point into the atlas on first use.
+    const Glyph& glyph(uint32_t codePoint);
+    // Place a width x height cell on the atlas shelves, growing it; false when it is full.
+    bool allocate(int width, int height, int& x, int& y);
+    void uploadAtlas();
+    void releaseBatch(TextBatch& batch);
+
+    bool legacy_ = false;  // GLSL 1.20 and luminance textures (compatibility contexts before 3.2)
+    std::unique_ptr<QOpenGLShaderProgram> program_;
+    QOpenGLVertexArrayObject vao_;
+    int viewportLocation_ = -1;
+    int atlasSizeLocation_ = -1;
+    int atlasLocation_ = -1;
+
+    QFont font_;
+    std::unique_ptr<QFontMetricsF> metrics_;
+    std::unordered_map<uint32_t, Glyph> glyphs_;
+
+    GLuint atlas_ = 0;
+    int atlasWidth_ = 1024;
+    int atlasHeight_ = 256;
+    std::vector<uint8_t> atlasPixels_;  // CPU copy, the texture is reallocated when the atlas grows
+    int dirtyTop_ = 0;     // Rows changed since the last upload
+    int dirtyBottom_ = 0;
+    bool atlasResized_ = false;
+    bool atlasFullWarned_ = false;
+    int shelfX_ = 0;
+    int shelfY_ = 0;
+    int shelfHeight_ = 0;
+    float solidU_ = 0.0f;  // Texel inside the solid block rectangles sample
+    float solidV_ = 0.0f;
+
+    std::vector<TextBatch*> batches_;  // Batches holding buffers of this renderer
+};
+
+}  // namespace octo_flex
+
+#endif /* TEXT_RENDERER_H */
@@ -0,0 +1,335 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "texture_cache.h"
+#include "builtin_textures.h"
+#include "gl_deletion_queue.h"
+#include "ktx2_loader.h"
+#include "texture_format.h"
+#include "texture_manager.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QFileInfo>
+#include <QImage>
+#include <QOpenGLContext>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace octo_flex {
+namespace {
+
+const size_t kDefaultMemoryBudget = 512 * 1024 * 1024;
+const char* const kBuiltinLogo = "builtin:logo";
+
+// FNV-1a over 64-bit words: cheap enough to hash a 2k tile on every request, and collisions are
+// further ruled out by the size and format being part of the key.
+uint64_t hashBytes(const std::vector<unsigned char>& data, uint64_t hash = 14695981039346656037ull) {
+    const size_t words = data.size() / sizeof(uint64_t);
+    for (size_t i = 0; i < words; ++i) {
+        uint64_t word;
+        std::memcpy(&word, data.data() + i * sizeof(uint64_t), sizeof(word));
+        hash = (hash ^ word) * 1099511628211ull;
+    }
+    for (size_t i = words * sizeof(uint64_t); i < data.size(); ++i) {
+        hash = (hash ^ data[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+}  // namespace
+
+SharedTexture::SharedTexture(std::string key, std::shared_ptr<const TextureImage> image)
+    : key_(std::move(key)),
+      width_(image->width),
+      height_(image->height),
+      gpuBytes_(image->gpuSize()),
+      dataBytes_(image->dataSize()),
+      image_(std::move(image)) {
+    TextureCache::instance()->cpuBytes_ += dataBytes_;
+}
+
+SharedTexture::~SharedTexture() { release(); }
+
+GLuint SharedTexture::textureId(float priority) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lastUsedFrame_ = TextureCache::instance()->frame();
+    if (texture_ != 0 || !image_) {
+        return texture_;
+    }
+    if (!upload_ && !isTextureFormatSupported(image_->format)) {
+        // Nothing to draw it with; drop the data rather than retry every frame.
+        qWarning() << "SharedTexture: the OpenGL context does not support the compressed format of"
+                   << QString::fromStdString(key_);
+        unsupported_ = true;
+        image_.reset();
+        TextureCache::instance()->cpuBytes_ -= dataBytes_;
+        return 0;
+    }
+
+    // Upload on the background thread when it runs; adopt the texture once it is ready.
+    TextureManager* manager = TextureManager::instance();
+    if (manager->isAvailable()) {
+        if (!upload_) {
+            upload_ = manager->queueUpload(image_, priority);
+        } else if (upload_->texture() != 0) {
+            adopt(upload_->texture());
+            upload_.reset();
+        } else {
+            upload_->setPriority(priority);
+        }
+        return texture_;
+    }
+
+    // No upload thread (any more): upload here, in the drawing context.
+    if (upload_) {
+        const GLuint uploaded = upload_->cancel();
+        upload_.reset();
+        if (uploaded != 0) {
+            adopt(uploaded);
+            return texture_;
+        }
+    }
+    uploadNow();
+    return texture_;
+}
+
+void SharedTexture::adopt(GLuint texture) {
+    TextureCache* cache = TextureCache::instance();
+    texture_ = texture;
+    // Uploads run in this context or one sharing with it.
+    group_ = GlDeletionQueue::instance()->currentGroup();
+    cache->residentBytes_ += bytes();
+
+    // The upload is confirmed: the pixels now live on the GPU only.
+    if (image_) {
+        image_.reset();
+        cache->cpuBytes_ -= dataBytes_;
+    }
+}
+
+void SharedTexture::uploadNow() {
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    if (!context) {
+        // No context yet, will upload later during rendering
+        return;
+    }
+    QOpenGLFunctions* gl = context->functions();
+
+    GLuint texture = 0;
+    gl->glGenTextures(1, &texture);
+    gl->glBindTexture(GL_TEXTURE_2D, texture);
+
+    // Save current pixel storage alignment
+    GLint oldAlignment;
+    gl->glGetIntegerv(GL_UNPACK_ALIGNMENT, &oldAlignment);
+    gl->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    // glTexImage2D has copied the pixels when it returns, so the copy in memory can go.
+    specifyTexture(gl, *image_, false, 0);
+
+    // Restore pixel storage alignment
+    gl->glPixelStorei(GL_UNPACK_ALIGNMENT, oldAlignment);
+    gl->glBindTexture(GL_TEXTURE_2D, 0);
+    // Other views draw it in other contexts of the share group.
+    gl->glFlush();
+
+    adopt(texture);
+}
+
+void SharedTexture::release() {
+    TextureCache* cache = TextureCache::instance();
+
+    // A texture the upload thread finished meanwhile is ours to delete.
+    if (upload_) {
+        const GLuint uploaded = upload_->cancel();
+        upload_.reset();
+        if (uploaded != 0 && texture_ == 0) {
+            adopt(uploaded);
+        }
+    }
+    if (image_) {
+        image_.reset();
+        cache->cpuBytes_ -= dataBytes_;
+    }
+    if (texture_ == 0) {
+        return;
+    }
+
+    GlDeletionQueue::instance()->deleteTextures(group_, {texture_});
+    texture_ = 0;
+    cache->residentBytes_ -= bytes();
+}
+
+TextureCache::TextureCache() : budget_(kDefaultMemoryBudget) {}
+
+TextureCache* TextureCache::instance() {
+    static TextureCache cache;
+    return &cache;
+}
+
+std::shared_ptr<SharedTexture> TextureCache::acquireFile(const std::string& path, bool mipmaps) {
+    // Built-in textures share their process-wide image; nothing to read or copy.
+    if (path == kBuiltinLogo) {
+        std::shared_ptr<const TextureImage> logo = getSharedBuiltinLogo();
+        if (!logo->isValid()) return nullptr;
+        return insert(path, std::move(logo));
+    }
+
+    // The modification time is part of the key, so an edited file is decoded again.
+    const QFileInfo info(QString::fromStdString(path));
+    if (!info.exists()) {
+        return nullptr;
+    }
+    const bool ktx2 = isKtx2Path(path);
+    const std::string key = "file:" + info.canonicalFilePath().toStdString() + "@" +
+                            std::to_string(info.lastModified().toMSecsSinceEpoch()) +
+                            (mipmaps && !ktx2 ? ":mip" : "");
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            ++hits_;
+            return it->second;
+        }
+    }
+
+    // Decode outside the lock; a concurrent request for the same file keeps the first entry.
+    auto image = std::make_shared<TextureImage>();
+    if (ktx2) {
+        std::string error;
+        if (!loadKtx2(info.filePath().toStdString(), image.get(), &error)) {
+            qWarning() << "TextureCache:" << QString::fromStdString(error);
+            return nullptr;
+        }
+        return insert(key, std::move(image));
+    }
+
+    QImage source(info.filePath());
+    if (source.isNull()) {
+        return nullptr;
+    }
+
+    // Convert to RGBA format and mirror vertically (OpenGL texture coordinate convention)
+    QImage formatted = source.convertToFormat(QImage::Format_RGBA8888).mirrored();
+    image->width = formatted.width();
+    image->height = formatted.height();
+    image->generate_mipmaps = mipmaps;
+    const size_t byte_count = static_cast<size_t>(image->width) * image->height * 4;
+    image->pixels.assign(formatted.bits(), formatted.bits() + byte_count);
+    return insert(key, std::move(image));
+}
+
+std::shared_ptr<SharedTexture> TextureCache::acquireImage(const TextureImage& image) {
+    if (!image.isValid()) {
+        return nullptr;
+    }
+    uint64_t hash = hashBytes(image.pixels);
+    for (const auto& level : image.mip_levels) {
+        hash = hashBytes(level, hash);
+    }
+    char key[80];
+    std::snprintf(key, sizeof(key), "image:%d:%dx%d:%zu%s:%016llx", static_cast<int>(image.format), image.width,
+                  image.height, image.mip_levels.size(), image.generate_mipmaps ? "+mip" : "",
+                  static_cast<unsigned long long>(hash));
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            ++hits_;
+            return it->second;
+        }
+    }
+    return insert(key, std::make_shared<const TextureImage>(image));
+}
+
+std::shared_ptr<SharedTexture> TextureCache::insert(const std::string& key,
+                                                    std::shared_ptr<const TextureImage> image) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+        ++hits_;
+        return it->second;
+    }
+    ++misses_;
+    auto entry = std::make_shared<SharedTexture>(key, std::move(image));
+    entries_.emplace(key, entry);
+    return entry;
+}
+
+void TextureCache::beginFrame() {
+    ++frame_;
+    evict();
+}
+
+void TextureCache::setMemoryBudget(size_t bytes) { budget_ = bytes; }
+
+void TextureCache::evict() {
+    // Destroyed after the lock is dropped, here, with the drawing context current.
+    std::vector<std::shared_ptr<SharedTexture>> victims;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // Only the cache refers to an entry with a use count of one, and only the cache (under the
+        // lock) hands out new references, so the count cannot grow behind our back. Unused entries
+        // not on the GPU hold memory for nothing and go at once.
+        std::vector<std::shared_ptr<SharedTexture>> unused;
+        for (auto it = entries_.begin(); it != entries_.end();) {
+            if (it->second.use_count() != 1) {
+                ++it;
+            } else if (it->second->texture_ == 0) {
+                victims.push_back(std::move(it->second));
+                it = entries_.erase(it);
+            } else {
+                unused.push_back(it->second);
+                ++it;
+            }
+        }
+
+        const size_t budget = budget_;
+        if (budget != 0 && residentBytes_ > budget) {
+            std::sort(unused.begin(), unused.end(),
+                      [](const std::shared_ptr<SharedTexture>& a, const std::shared_ptr<SharedTexture>& b) {
+                          return a->lastUsedFrame_ < b->lastUsedFrame_;
+                      });
+            size_t resident = residentBytes_;
+            for (auto& entry : unused) {
+                if (resident <= budget) break;
+                resident -= entry->bytes();
+                entries_.erase(entry->key());
+                victims.push_back(std::move(entry));
+                ++evicted_;
+            }
+        }
+    }
+}
+
+void TextureCache::fillStats(TextureUploadStats* stats) const {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats->cached_textures = entries_.size();
+    }
+    stats->resident_bytes = residentBytes_;
+    stats->cpu_copy_bytes = cpuBytes_;
+    stats->memory_budget_bytes = budget_;
+    stats->cache_hits = hits_;
+    stats->cache_misses = misses_;
+    stats->evicted = evicted_;
+}
+
+}  // namespace octo_flex
@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+
+#include <QOpenGLFunctions>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "texture_image.h"
+#include "texture_upload_stats.h"
+
+namespace octo_flex {
+
+class TextureUpload;
+
+// One texture shared by every quad showing the same file or pixels. The RGBA copy in memory is
+// kept only until the upload is confirmed (its fence signaled, or the synchronous upload issued);
+// afterwards the texture lives on the GPU alone. Drawn by the views as they paint, at the same time.
+class SharedTexture {
+   public:
+    SharedTexture(std::string key, std::shared_ptr<const TextureImage> image);
+    ~SharedTexture();
+
+    // Texture to draw with; 0 while the background upload is pending. priority orders pending
+    // uploads (lower first). Needs the drawing context current; thread-safe.
+    GLuint textureId(float priority);
+
+    const std::string& key() const { return key_; }
+    int width() const { return width_; }
+    int height() const { return height_; }
+    size_t bytes() const { return gpuBytes_; }  // Texture memory, mip levels included
+    bool hasCpuCopy() const { return image_ != nullptr; }
+
+   private:
+    friend class TextureCache;
+
+    void adopt(GLuint texture);
+    void uploadNow();
+    // Delete the texture and give up a pending upload; the drawing context must be current.
+    void release();
+
+    const std::string key_;
+    const int width_;
+    const int height_;
+    const size_t gpuBytes_;
+    const size_t dataBytes_;
+    std::shared_ptr<const TextureImage> image_;  // Until the upload is confirmed
+    std::shared_ptr<TextureUpload> upload_;
+    GLuint texture_ = 0;
+    uint32_t group_ = 0;  // Share group of the texture
+    bool unsupported_ = false;  // The context cannot sample the format
+    uint64_t lastUsedFrame_ = 0;
+    std::mutex mutex_;  // Held by textureId()
+};
+
+// Content-addressed cache of the textures of textured quads: files are keyed by their canonical
+// path and modification time and decoded once, other images by a hash of their data. Quads hold
+// references to the entries; entries no quad refers to stay resident for reuse until the texture
+// memory exceeds the budget, then the least recently drawn are deleted at the start of a frame.
+class TextureCache {
+   public:
+    static TextureCache* instance();
+
+    // Entry for an image file, decoded on the first request; null if the file cannot be read.
+    // KTX2 files keep their format and mip levels; others are decoded to RGBA8, with a generated
+    // mip chain if asked. "builtin:logo" names the embedded logo. Thread-safe.
+    std::shared_ptr<SharedTexture> acquireFile(const std::string& path, bool mipmaps = false);
+
+    // Entry for an image's pixels (any format, with its mip levels); copied on the first request
+    // only. Thread-safe.
+    std::shared_ptr<SharedTexture> acquireImage(const TextureImage& image);
+
+    // Advance the frame clock and evict unused textures over the budget; called by the views from
+    // paintGL, with their context current.
+    void beginFrame();
+
+    // Texture memory kept resident (default 512 MB); 0 removes the limit. Textures still drawn by
+    // a quad are never evicted, so the budget can be exceeded by what the scene shows.
+    void setMemoryBudget(size_t bytes);
+    size_t memoryBudget() const { return budget_; }
+
+    uint64_t frame() const { return frame_; }
+
+    // Add the cache counters to the upload stats.
+    void fillStats(TextureUploadStats* stats) const;
+
+   private:
+    friend class SharedTexture;
+
+    TextureCache();
+
+    std::shared_ptr<SharedTexture> insert(const std::string& key, std::shared_ptr<const TextureImage> image);
+    void evict();
+
+    mutable std::mutex mutex_;
+    std::atomic<size_t> budget_;
+    std::atomic<uint64_t> frame_{0};
+
+    // Updated by the entries as their textures and pixel copies come and go.
+    std::atomic<size_t> residentBytes_{0};
+    std::atomic<size_t> cpuBytes_{0};
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> evicted_{0};
+
+    // Declared last: the entries update the counters above when they are destroyed.
+    std::unordered_map<std::string, std::shared_ptr<SharedTexture>> entries_;  // Guarded by mutex_
+};
+
+}  // namespace octo_flex
+
+#endif  // TEXTURE_CACHE_H
@@ -0,0 +1,135 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "texture_format.h"
+
+#include <QOpenGLContext>
+#include <QSurfaceFormat>
+#include <algorithm>
+
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#endif
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#endif
+#ifndef GL_COMPRESSED_RGBA8_ETC2_EAC
+#define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#endif
+#ifndef GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+#define GL_COMPRESSED_RGBA_ASTC_4x4_KHR 0x93B0
+#endif
+#ifndef GL_COMPRESSED_RGBA_ASTC_8x8_KHR
+#define GL_COMPRESSED_RGBA_ASTC_8x8_KHR 0x93B7
+#endif
+#ifndef GL_TEXTURE_MAX_LEVEL
+#define GL_TEXTURE_MAX_LEVEL 0x813D
+#endif
+
+namespace octo_flex {
+namespace {
+
+GLenum internalFormat(TextureImage::Format format) {
+    switch (format) {
+        case TextureImage::Format::BC1:
+            return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+        case TextureImage::Format::BC3:
+            return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case TextureImage::Format::BC7:
+            return GL_COMPRESSED_RGBA_BPTC_UNORM;
+        case TextureImage::Format::ETC2_RGB8:
+            return GL_COMPRESSED_RGB8_ETC2;
+        case TextureImage::Format::ETC2_RGBA8:
+            return GL_COMPRESSED_RGBA8_ETC2_EAC;
+        case TextureImage::Format::ASTC_4x4:
+            return GL_COMPRESSED_RGBA_ASTC_4x4_KHR;
+        case TextureImage::Format::ASTC_8x8:
+            return GL_COMPRESSED_RGBA_ASTC_8x8_KHR;
+        case TextureImage::Format::RGBA8:
+            break;
+    }
+    return GL_RGBA;
+}
+
+}  // namespace
+
+bool isTextureFormatSupported(TextureImage::Format format) {
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    if (!context) return false;
+
+    const QSurfaceFormat surface = context->format();
+    const bool es = context->isOpenGLES();
+    const auto version = qMakePair(surface.majorVersion(), surface.minorVersion());
+    switch (format) {
+        case TextureImage::Format::RGBA8:
+            return true;
+        case TextureImage::Format::BC1:
+        case TextureImage::Format::BC3:
+            return context->hasExtension(QByteArrayLiteral("GL_EXT_texture_compression_s3tc"));
+        case TextureImage::Format::BC7:
+            return (!es && version >= qMakePair(4, 2)) ||
+                   context->hasExtension(QByteArrayLiteral("GL_ARB_texture_compression_bptc")) ||
+                   context->hasExtension(QByteArrayLiteral("GL_EXT_texture_compression_bptc"));
+        case TextureImage::Format::ETC2_RGB8:
+        case TextureImage::Format::ETC2_RGBA8:
+            return (es && version >= qMakePair(3, 0)) || (!es && version >= qMakePair(4, 3)) ||
+                   context->hasExtension(QByteArrayLiteral("GL_ARB_ES3_compatibility"));
+        case TextureImage::Format::ASTC_4x4:
+        case TextureImage::Format::ASTC_8x8:
+            return context->hasExtension(QByteArrayLiteral("GL_KHR_texture_compression_astc_ldr"));
+    }
+    return false;
+}
+
+void specifyTexture(QOpenGLFunctions* gl, const TextureImage& image, bool staged, size_t offset) {
+    const GLenum format = internalFormat(image.format);
+    const int levels = 1 + static_cast<int>(image.mip_levels.size());
+    for (int level = 0; level < levels; ++level) {
+        const std::vector<unsigned char>& data = level == 0 ? image.pixels : image.mip_levels[level - 1];
+        const GLsizei width = std::max(1, image.width >> level);
+        const GLsizei height = std::max(1, image.height >> level);
+        const void* source = staged ? reinterpret_cast<const void*>(offset) : data.data();
+        if (image.isCompressed()) {
+            gl->glCompressedTexImage2D(GL_TEXTURE_2D, level, format, width, height, 0,
+                                       static_cast<GLsizei>(data.size()), source);
+        } else {
+            gl->glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, source);
+        }
+        offset += data.size();
+    }
+
+    // Compressed formats cannot be mipmapped on the GPU; they bring their levels along.
+    const bool generate = image.generate_mipmaps && !image.isCompressed() && levels == 1;
+    if (generate) {
+        gl->glGenerateMipmap(GL_TEXTURE_2D);
+    } else if (levels > 1) {
+        // A partial chain is complete only up to its last level.
+        gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    }
+    const bool mipmapped = generate || levels > 1;
+    gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    gl->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+}  // namespace octo_flex
@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TEXTURE_FORMAT_H
+#define TEXTURE_FORMAT_H
+
+
+#include <QOpenGLFunctions>
+#include <cstddef>
+
+#include "texture_image.h"
+
+namespace octo_flex {
+
+// OpenGL side of the TextureImage formats, shared by the upload thread and the uploads in the
+// drawing context.
+
+// Whether the current context can sample textures of the format.
+bool isTextureFormatSupported(TextureImage::Format format);
+
+// Specify every level of the image on the bound GL_TEXTURE_2D, from the bound pixel unpack buffer
+// (levels back to back from offset) when staged, else from client memory; then generate the mip
+// chain if asked and set the filters to match.
+void specifyTexture(QOpenGLFunctions* gl, const TextureImage& image, bool staged, size_t offset);
+
+}  // namespace octo_flex
+
+#endif  // TEXTURE_FORMAT_H
@@ -16,39 +16,70 @@
 
 
 #include "texture_manager.h"
+#include "texture_format.h"
+#include "trace.h"
+
+#include <QCoreApplication>
 #include <QDebug>
 #include <QMutexLocker>
 #include <QOffscreenSurface>
 #include <QOpenGLContext>
+#include <algorithm>
+#include <cstring>
+
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
 
 namespace octo_flex {
+namespace {
+
+// Staging memory for one batch; larger textures are uploaded from client memory on their own.
+const GLsizeiptr kStagingBytes = 64 * 1024 * 1024;
+const size_t kDefaultFrameBudget = 64 * 1024 * 1024;
+const size_t kLatencyWindow = 240;
+const size_t kClientMemory = static_cast<size_t>(-1);
+
+}  // namespace
+
+TextureUpload::TextureUpload(std::shared_ptr<const TextureImage> image, float priority)
+    : image_(std::move(image)), priority_(priority) {
+    queued_.start();
+}
+
+bool TextureUpload::isCancelled() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cancelled_;
+}
+
+GLuint TextureUpload::cancel() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cancelled_ = true;
+    return texture_.exchange(0);
+}
+
+bool TextureUpload::complete(GLuint texture) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (cancelled_) return false;
+    texture_ = texture;
+    return true;
+}
 
 TextureManager* TextureManager::instance_ = nullptr;
 
 TextureManager::TextureManager(QObject* parent)
     : QThread(parent),
+      frameBudget_(kDefaultFrameBudget),
       shouldQuit_(false),
       initialized_(false),
       mainContext_(nullptr),
       sharedContext_(nullptr),
       offscreenSurface_(nullptr) {}
 
-TextureManager::~TextureManager() {
-    if (isRunning()) {
-        cleanup();
-    }
-
-    // Clean up OpenGL resources
-    if (sharedContext_) {
-        delete sharedContext_;
-        sharedContext_ = nullptr;
-    }
-    if (offscreenSurface_) {
-        offscreenSurface_->destroy();
-        delete offscreenSurface_;
-        offscreenSurface_ = nullptr;
-    }
-}
+TextureManager::~TextureManager() { cleanup(); }
 
 TextureManager* TextureManager::instance() {
     if (!instance_) {
@@ -57,65 +88,71 @@ TextureManager* TextureManager::instance() {
     return instance_;
 }
 
-void TextureManager::initialize(QOpenGLContext* mainContext) {
-    if (!mainContext) {
-        qWarning() << "TextureManager::initialize: mainContext is null!";
-        return;
+void TextureManager::cleanupAtExit() {
+    if (instance_) {
+        instance_->cleanup();
     }
+}
 
+void TextureManager::initialize(QOpenGLContext* mainContext) {
     if (initialized_) {
-        qWarning() << "TextureManager::initialize: Already initialized!";
         return;
     }
 
-    qDebug() << "TextureManager::initialize: Saving main context information...";
+    // With Qt::AA_ShareOpenGLContexts every view shares the global context's group.
+    if (!mainContext) {
+        mainContext = QOpenGLContext::globalShareContext();
+    }
+    if (!mainContext) {
+        qWarning() << "TextureManager::initialize: mainContext is null!";
+        return;
+    }
 
-    // Save the main context and its format (don't create shared context here!)
+    // Save the main context and its format; the shared context is created in the upload thread.
     mainContext_ = mainContext;
     contextFormat_ = mainContext->format();
 
-    // Start the background thread (shared context will be created there)
-    if (!isRunning()) {
-        start();
-    }
-
-    initialized_ = true;
-    qDebug() << "TextureManager::initialize: Background thread started";
-}
-
-void TextureManager::createSharedContextInThread() {
-    // This function MUST be called in the background thread
-
-    qDebug() << "TextureManager: Creating shared OpenGL context in background thread...";
-
-    // Create offscreen surface for the background thread
+    // Offscreen surfaces must be created in the GUI thread.
     offscreenSurface_ = new QOffscreenSurface();
     offscreenSurface_->setFormat(contextFormat_);
     offscreenSurface_->create();
-
     if (!offscreenSurface_->isValid()) {
-        qWarning() << "TextureManager: Failed to create offscreen surface!";
+        qWarning() << "TextureManager: Failed to create offscreen surface, textures upload where drawn.";
         delete offscreenSurface_;
         offscreenSurface_ = nullptr;
         return;
     }
 
-    // Create shared OpenGL context IN THIS THREAD
+    // Stop the thread before the application (and its platform) goes away.
+    static bool postRoutineAdded = false;
+    if (!postRoutineAdded) {
+        qAddPostRoutine(&TextureManager::cleanupAtExit);
+        postRoutineAdded = true;
+    }
+
+    shouldQuit_ = false;
+    failed_ = false;
+    {
+        QMutexLocker locker(&mutex_);
+        frameBytesLeft_ = static_cast<long long>(frameBudget_);
+    }
+    initialized_ = true;
+    start();
+}
+
+void TextureManager::createSharedContextInThread() {
+    // This function MUST be called in the background thread
     sharedContext_ = new QOpenGLContext();
     sharedContext_->setFormat(contextFormat_);
-    sharedContext_->setShareContext(mainContext_);  // Share resources with main context
+    // Share resources with the global context when there is one, so uploads reach every view, not just one.
+    QOpenGLContext* shareContext = QOpenGLContext::globalShareContext();
+    sharedContext_->setShareContext(shareContext ? shareContext : mainContext_);
 
     if (!sharedContext_->create()) {
         qWarning() << "TextureManager: Failed to create shared OpenGL context!";
         delete sharedContext_;
         sharedContext_ = nullptr;
-        offscreenSurface_->destroy();
-        delete offscreenSurface_;
-        offscreenSurface_ = nullptr;
-        return;
     }
-
-    qDebug() << "TextureManager: Shared OpenGL context created successfully in background thread";
 }
 
 void TextureManager::cleanup() {
@@ -130,111 +167,296 @@ void TextureManager::cleanup() {
         wait();
     }
 
-    // Clear the queue
-    QMutexLocker locker(&mutex_);
-    uploadQueue_.clear();
+    // Clear the queue; quads still waiting upload where they are drawn from now on.
+    {
+        QMutexLocker locker(&mutex_);
+        pending_.clear();
+        pendingBytes_ = 0;
+    }
+
+    if (offscreenSurface_) {
+        offscreenSurface_->destroy();
+        delete offscreenSurface_;
+        offscreenSurface_ = nullptr;
+    }
+    initialized_ = false;
 }
 
-void TextureManager::queueTextureForUpload(const std::shared_ptr<Shape>& shape) {
-    auto texturedQuad = std::dynamic_pointer_cast<TexturedQuad>(shape);
-    if (!texturedQuad || !texturedQuad->hasImageData()) {
-        return;  // Nothing to upload
+std::shared_ptr<TextureUpload> TextureManager::queueUpload(std::shared_ptr<const TextureImage> image,
+                                                           float priority) {
+    if (!image || !image->isValid()) {
+        return nullptr;  // Nothing to upload
     }
 
+    auto upload = std::make_shared<TextureUpload>(std::move(image), priority);
     QMutexLocker locker(&mutex_);
-    uploadQueue_.enqueue(texturedQuad);
+    pending_.push_back(upload);
+    pendingBytes_ += upload->bytes();
     condition_.wakeAll();
+    return upload;
 }
 
-bool TextureManager::isTextureReady(GLuint textureId) const {
-    QMutexLocker locker(const_cast<QMutex*>(&mutex_));
-    return readyTextures_.contains(textureId);
+void TextureManager::beginFrame() {
+    QMutexLocker locker(&mutex_);
+    if (pending_.empty() && frameBytesLeft_ > 0) {
+        return;
+    }
+    frameBytesLeft_ = static_cast<long long>(frameBudget_);
+    condition_.wakeAll();
 }
 
-void TextureManager::cancelTextureUpload(const std::shared_ptr<Shape>& shape) {
-    auto texturedQuad = std::dynamic_pointer_cast<TexturedQuad>(shape);
-    if (!texturedQuad) return;
+void TextureManager::setFrameBudget(size_t bytes) {
+    frameBudget_ = bytes;
+    beginFrame();
+}
 
+bool TextureManager::waitingForFrame() const {
     QMutexLocker locker(&mutex_);
-    // Remove from queue if it's there
-    auto it = uploadQueue_.begin();
-    while (it != uploadQueue_.end()) {
-        auto quad = it->lock();
-        if (quad && quad.get() == texturedQuad.get()) {
-            it = uploadQueue_.erase(it);
-        } else {
-            ++it;
-        }
-    }
+    return !pending_.empty() && frameBudget_ > 0 && frameBytesLeft_ <= 0;
 }
 
 int TextureManager::getQueueSize() const {
-    QMutexLocker locker(const_cast<QMutex*>(&mutex_));
-    return uploadQueue_.size();
+    QMutexLocker locker(&mutex_);
+    return static_cast<int>(pending_.size());
 }
 
-void TextureManager::run() {
-    qDebug() << "TextureManager::run: Background thread started";
+TextureUploadStats TextureManager::stats() const {
+    TextureUploadStats stats;
+    stats.frame_budget_bytes = frameBudget_;
+    stats.batches = batches_;
+
+    std::vector<float> sorted;
+    {
+        QMutexLocker locker(&mutex_);
+        stats.pending = pending_.size();
+        stats.pending_bytes = pendingBytes_;
+        stats.uploaded = uploaded_;
+        stats.uploaded_bytes = uploadedBytes_;
+        stats.persistent_staging = persistentStaging_;
+        sorted = latencies_;
+    }
+    if (!sorted.empty()) {
+        std::sort(sorted.begin(), sorted.end());
+        stats.latency_p50_ms = sorted[(sorted.size() - 1) / 2];
+        stats.latency_p99_ms = sorted[(sorted.size() - 1) * 99 / 100];
+    }
+    return stats;
+}
 
+void TextureManager::run() {
+    setTraceThreadName("texture upload");
     // Create the shared OpenGL context IN THIS THREAD
     createSharedContextInThread();
-
-    // Check if context creation succeeded
-    if (!sharedContext_ || !offscreenSurface_) {
-        qWarning() << "TextureManager::run: Failed to create shared context, thread exiting!";
+    if (!sharedContext_ || !sharedContext_->makeCurrent(offscreenSurface_)) {
+        qWarning() << "TextureManager::run: No shared context, textures upload where drawn.";
+        delete sharedContext_;
+        sharedContext_ = nullptr;
+        failed_ = true;
         return;
     }
 
-    // Make the shared OpenGL context current in this thread
-    if (!sharedContext_->makeCurrent(offscreenSurface_)) {
-        qWarning() << "TextureManager::run: Failed to make shared context current!";
+    // Pixel unpack buffers and mapped buffer ranges are core in OpenGL 3.0 and ES 3.0, fences in 3.2 and ES 3.0.
+    const bool supported = sharedContext_->isOpenGLES()
+                               ? sharedContext_->format().majorVersion() >= 3
+                               : sharedContext_->format().version() >= qMakePair(3, 2) ||
+                                     sharedContext_->hasExtension("GL_ARB_sync");
+    if (!supported) {
+        qWarning() << "TextureManager::run: No fences or pixel buffers, textures upload where drawn.";
+        sharedContext_->doneCurrent();
+        delete sharedContext_;
+        sharedContext_ = nullptr;
+        failed_ = true;
         return;
     }
 
-    qDebug() << "TextureManager::run: OpenGL context is current, ready to upload textures";
+    initializeOpenGLFunctions();
+    createStaging();
 
     while (!shouldQuit_) {
-        std::shared_ptr<TexturedQuad> texturedQuad;
+        std::vector<std::shared_ptr<TextureUpload>> batch = takeBatch();
+        if (!batch.empty()) {
+            uploadBatch(batch);
+        }
+    }
 
-        {
-            QMutexLocker locker(&mutex_);
+    // Release the context before thread exits
+    releaseStaging();
+    sharedContext_->doneCurrent();
+    delete sharedContext_;
+    sharedContext_ = nullptr;
+}
 
-            // Wait for work or timeout
-            if (uploadQueue_.isEmpty() && !shouldQuit_) {
-                condition_.wait(&mutex_, 100);  // Wait for 100ms
-                continue;
-            }
+void TextureManager::createStaging() {
+    glGenBuffers(1, &staging_);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging_);
 
-            if (shouldQuit_) {
-                break;
-            }
+    // Persistent mapping (OpenGL 4.4, GL_ARB_buffer_storage or GL_EXT_buffer_storage): map once, write each batch.
+    auto bufferStorage = reinterpret_cast<BufferStorageFn>(sharedContext_->getProcAddress("glBufferStorage"));
+    if (!bufferStorage) {
+        bufferStorage = reinterpret_cast<BufferStorageFn>(sharedContext_->getProcAddress("glBufferStorageEXT"));
+    }
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    if (bufferStorage) {
+        bufferStorage(GL_PIXEL_UNPACK_BUFFER, kStagingBytes, nullptr, flags);
+        stagingMapped_ = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, kStagingBytes, flags);
+    }
+    if (!stagingMapped_) {
+        // Immutable storage cannot be reallocated; start over with a buffer mapped per batch.
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glDeleteBuffers(1, &staging_);
+        glGenBuffers(1, &staging_);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging_);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, kStagingBytes, nullptr, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    QMutexLocker locker(&mutex_);
+    persistentStaging_ = stagingMapped_ != nullptr;
+}
 
-            if (!uploadQueue_.isEmpty()) {
-                auto shape = uploadQueue_.dequeue().lock();
-                if (shape) {
-                    texturedQuad = std::dynamic_pointer_cast<TexturedQuad>(shape);
-                }
+void TextureManager::releaseStaging() {
+    if (staging_ == 0) return;
+    if (stagingMapped_) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging_);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        stagingMapped_ = nullptr;
+    }
+    glDeleteBuffers(1, &staging_);
+    staging_ = 0;
+}
+
+std::vector<std::shared_ptr<TextureUpload>> TextureManager::takeBatch() {
+    std::vector<std::shared_ptr<TextureUpload>> batch;
+    QMutexLocker locker(&mutex_);
+
+    // Wait for work and for budget left in this frame.
+    for (;;) {
+        if (shouldQuit_) return batch;
+        for (auto it = pending_.begin(); it != pending_.end();) {
+            if ((*it)->isCancelled()) {
+                pendingBytes_ -= (*it)->bytes();
+                it = pending_.erase(it);
+            } else {
+                ++it;
             }
         }
+        if (!pending_.empty() && (frameBudget_ == 0 || frameBytesLeft_ > 0)) break;
+        condition_.wait(&mutex_);
+    }
+
+    // Nearest first; a texture larger than the staging buffer goes alone.
+    std::stable_sort(pending_.begin(), pending_.end(),
+                     [](const std::shared_ptr<TextureUpload>& a, const std::shared_ptr<TextureUpload>& b) {
+                         return a->priority() < b->priority();
+                     });
+    size_t staged = 0;
+    auto it = pending_.begin();
+    while (it != pending_.end() && (frameBudget_ == 0 || frameBytesLeft_ > 0)) {
+        const size_t bytes = (*it)->bytes();
+        if (!batch.empty() && staged + bytes > static_cast<size_t>(kStagingBytes)) break;
+        batch.push_back(*it);
+        staged += bytes;
+        frameBytesLeft_ -= static_cast<long long>(bytes);
+        pendingBytes_ -= bytes;
+        ++it;
+    }
+    pending_.erase(pending_.begin(), it);
+    return batch;
+}
 
-        // Process the texture upload outside the mutex lock
-        if (texturedQuad && texturedQuad->hasImageData()) {
-            // Upload the texture using the shared context
-            GLuint textureId = texturedQuad->ensureTextureUploaded();
-
-            if (textureId != 0) {
-                // Mark as ready
-                QMutexLocker locker(&mutex_);
-                readyTextures_.insert(textureId);
-                qDebug() << "TextureManager: Uploaded texture ID" << textureId
-                         << "- Queue size:" << uploadQueue_.size();
+void TextureManager::uploadBatch(const std::vector<std::shared_ptr<TextureUpload>>& batch) {
+    OCTO_FLEX_TRACE_ZONE("TextureManager::uploadBatch");
+    // Stage the pixels of every texture that fits; the rest is read from client memory.
+    size_t staged = 0;
+    for (const auto& upload : batch) {
+        if (staged + upload->bytes() > static_cast<size_t>(kStagingBytes)) break;
+        staged += upload->bytes();
+    }
+    unsigned char* mapped = static_cast<unsigned char*>(stagingMapped_);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, staging_);
+    if (!mapped && staged > 0) {
+        const GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT;
+        mapped = static_cast<unsigned char*>(
+            glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(staged), access));
+    }
+    std::vector<size_t> offsets;  // Offset in the staging buffer, or kClientMemory
+    size_t offset = 0;
+    for (const auto& upload : batch) {
+        if (mapped && offset + upload->bytes() <= staged) {
+            // Mip levels follow level 0 back to back.
+            const TextureImage& image = *upload->image_;
+            offsets.push_back(offset);
+            std::memcpy(mapped + offset, image.pixels.data(), image.pixels.size());
+            offset += image.pixels.size();
+            for (const auto& level : image.mip_levels) {
+                std::memcpy(mapped + offset, level.data(), level.size());
+                offset += level.size();
             }
+        } else {
+            offsets.push_back(kClientMemory);
         }
     }
+    if (mapped && !stagingMapped_) {
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    }
 
-    // Release the context before thread exits
-    sharedContext_->doneCurrent();
-    qDebug() << "TextureManager::run: Background upload thread stopped";
+    // Create the textures; RGBA rows are always 4-byte aligned, compressed data ignores the alignment.
+    GLint oldAlignment;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &oldAlignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    std::vector<GLuint> textures(batch.size(), 0);
+    glGenTextures(static_cast<GLsizei>(textures.size()), textures.data());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        const TextureImage& image = *batch[i]->image_;
+        const bool fromStaging = offsets[i] != kClientMemory;
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, fromStaging ? staging_ : 0);
+        glBindTexture(GL_TEXTURE_2D, textures[i]);
+        specifyTexture(this, image, fromStaging, fromStaging ? offsets[i] : 0);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, oldAlignment);
+
+    // Publish the batch once the GPU finished it; until then views keep drawing without it.
+    GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    GLenum status = GL_TIMEOUT_EXPIRED;
+    while (fence && status == GL_TIMEOUT_EXPIRED) {
+        status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000);  // 100 ms
+    }
+    if (fence) {
+        glDeleteSync(fence);
+    } else {
+        glFinish();
+    }
+
+    size_t count = 0;
+    size_t bytes = 0;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (!batch[i]->complete(textures[i])) {
+            glDeleteTextures(1, &textures[i]);  // Released while uploading
+            continue;
+        }
+        count++;
+        bytes += batch[i]->bytes();
+        addLatency(static_cast<float>(batch[i]->queued_.nsecsElapsed() / 1e6));
+    }
+    {
+        QMutexLocker locker(&mutex_);
+        uploaded_ += count;
+        uploadedBytes_ += bytes;
+    }
+    batches_++;
+}
+
+void TextureManager::addLatency(float ms) {
+    QMutexLocker locker(&mutex_);
+    if (latencies_.size() < kLatencyWindow) {
+        latencies_.push_back(ms);
+    } else {
+        latencies_[nextLatency_] = ms;
+    }
+    nextLatency_ = (nextLatency_ + 1) % kLatencyWindow;
 }
 
 }  // namespace octo_flex
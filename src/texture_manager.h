@@ -14,20 +14,22 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-
 #ifndef TEXTURE_MANAGER_H
 #define TEXTURE_MANAGER_H
 
 
+#include <QElapsedTimer>
 #include <QMutex>
-#include <QQueue>
-#include <QSet>
+#include <QOpenGLExtraFunctions>
 #include <QThread>
 #include <QWaitCondition>
 #include <atomic>
 #include <memory>
+#include <mutex>
+#include <vector>
 
-#include "textured_quad.h"
+#include "texture_image.h"
+#include "texture_upload_stats.h"
 
 #include <QSurfaceFormat>
 
@@ -36,28 +38,80 @@ class QOffscreenSurface;
 
 namespace octo_flex {
 
-class TextureManager : public QThread {
+// One texture waiting for, or done with, its background upload. Shared by the quad that draws it
+// and the upload thread: the quad adopts the texture once it is ready and cancels the upload when
+// it is released first.
+class TextureUpload {
+   public:
+    explicit TextureUpload(std::shared_ptr<const TextureImage> image, float priority);
+
+    // Texture ID once the upload completed on the GPU, else 0.
+    GLuint texture() const { return texture_; }
+
+    // Pending uploads with a lower priority go first; views set it to the quad's camera distance.
+    void setPriority(float priority) { priority_ = priority; }
+    float priority() const { return priority_; }
+
+    size_t bytes() const { return image_->dataSize(); }
+    bool isCancelled() const;
+
+    // Give up the upload. Returns the texture if it was already uploaded; the caller then owns it.
+    GLuint cancel();
+
+   private:
+    friend class TextureManager;
+
+    // Publish the uploaded texture; false if cancelled meanwhile (the texture is to be deleted).
+    bool complete(GLuint texture);
+
+    std::shared_ptr<const TextureImage> image_;
+    std::atomic<float> priority_;
+    std::atomic<GLuint> texture_{0};
+    mutable std::mutex mutex_;
+    bool cancelled_ = false;
+    QElapsedTimer queued_;
+};
+
+// Uploads textures on a background thread, in a context sharing objects with the views. Pending
+// uploads are taken nearest first, in batches bounded by a per-frame byte budget: the pixels of a
+// batch are staged in one pixel unpack buffer (persistently mapped where the context allows), the
+// textures created from it, and the batch published once its fence signaled, so views never draw
+// a texture still being written.
+class TextureManager : public QThread, protected QOpenGLExtraFunctions {
     Q_OBJECT
 
    public:
     static TextureManager* instance();
 
-    // Initialize with the main OpenGL context to create a shared context
+    // Initialize with the main OpenGL context to create a shared context (null: the global share context).
+    // Called by every view; only the first call starts the upload thread.
     void initialize(QOpenGLContext* mainContext);
     void cleanup();
 
-    // Add texture for upload (thread-safe, can be called from any thread)
-    void queueTextureForUpload(const std::shared_ptr<Shape>& shape);
+    // True while the upload thread runs or starts; otherwise textures upload where they are drawn.
+    bool isAvailable() const { return initialized_ && !failed_; }
+
+    // Queue an image for upload (thread-safe, can be called from any thread).
+    std::shared_ptr<TextureUpload> queueUpload(std::shared_ptr<const TextureImage> image, float priority);
+
+    // Start the upload budget of a new painted frame; called by the views.
+    void beginFrame();
 
-    // Check if texture is ready
-    bool isTextureReady(GLuint textureId) const;
+    // Pixel bytes uploaded at most per painted frame (default 64 MB); 0 removes the limit.
+    void setFrameBudget(size_t bytes);
+    size_t frameBudget() const { return frameBudget_; }
 
-    // Cancel upload for a texture
-    void cancelTextureUpload(const std::shared_ptr<Shape>& shape);
+    // Number of batches published so far; views repaint when it changed to show the new textures.
+    uint64_t completedBatches() const { return batches_; }
+
+    // Uploads are pending but the budget of the current frame is spent.
+    bool waitingForFrame() const;
 
     // Get upload queue size (for monitoring)
     int getQueueSize() const;
 
+    TextureUploadStats stats() const;
+
    protected:
     void run() override;
 
@@ -65,24 +119,48 @@ class TextureManager : public QThread {
     TextureManager(QObject* parent = nullptr);
     ~TextureManager();
 
+    static void cleanupAtExit();
+
     void createSharedContextInThread();
+    void createStaging();
+    void releaseStaging();
+    // Take the nearest pending uploads that fit the staging buffer and the frame budget.
+    std::vector<std::shared_ptr<TextureUpload>> takeBatch();
+    void uploadBatch(const std::vector<std::shared_ptr<TextureUpload>>& batch);
+    void addLatency(float ms);
 
     static TextureManager* instance_;
 
-    QMutex mutex_;
+    mutable QMutex mutex_;
     QWaitCondition condition_;
-    QQueue<std::weak_ptr<Shape>> uploadQueue_;
-    QSet<GLuint> readyTextures_;
+    std::vector<std::shared_ptr<TextureUpload>> pending_;  // Guarded by mutex_
+    size_t pendingBytes_ = 0;                              // Guarded by mutex_
+    long long frameBytesLeft_ = 0;                         // Guarded by mutex_; negative once overspent
+    std::atomic<size_t> frameBudget_;
     std::atomic<bool> shouldQuit_;
     std::atomic<bool> initialized_;
+    std::atomic<bool> failed_{false};
 
     // Main context info (used to create shared context in background thread)
     QOpenGLContext* mainContext_;
     QSurfaceFormat contextFormat_;
 
-    // OpenGL context for background thread (created in the thread itself)
+    // OpenGL context for background thread (created in the thread itself, on a surface from the GUI thread)
     QOpenGLContext* sharedContext_;
     QOffscreenSurface* offscreenSurface_;
+
+    // Staging buffer for the pixels of one batch; upload thread only.
+    typedef void(QOPENGLF_APIENTRYP BufferStorageFn)(GLenum, GLsizeiptr, const void*, GLbitfield);
+    GLuint staging_ = 0;
+    void* stagingMapped_ = nullptr;  // Persistent mapping, if any
+    bool persistentStaging_ = false;
+
+    // Counters and the rolling window of upload latencies (guarded by mutex_).
+    std::atomic<uint64_t> batches_{0};
+    uint64_t uploaded_ = 0;
+    uint64_t uploadedBytes_ = 0;
+    std::vector<float> latencies_;
+    size_t nextLatency_ = 0;
 };
 
 }  // namespace octo_flex
@@ -16,21 +16,17 @@
 
 
 #include "textured_quad.h"
+#include "dynamic_texture_uploader.h"
+#include "texture_cache.h"
 
 #include <QDebug>
-#include <QOpenGLContext>
 
 #include <vector>
 
 namespace octo_flex {
 
 TexturedQuad::TexturedQuad(double width, double height)
-    : Shape(Shape::TexturedQuad, 1.0, 1.0),
-      width_(width),
-      height_(height),
-      texture_id_(0),
-      texture_width_(0),
-      texture_height_(0) {
+    : Shape(Shape::TexturedQuad, 1.0, 1.0), width_(width), height_(height) {
     // UV coordinates are mirrored horizontally to correct left-right reversal
     // when viewing from top view. Top view uses camera up vector (0, -1, 0)
     // which inverts the Y-axis on screen, causing the default UV mapping
@@ -39,7 +35,8 @@ TexturedQuad::TexturedQuad(double width, double height)
     updateQuadPoints();
 }
 
-TexturedQuad::~TexturedQuad() { safeDeleteTexture(); }
+// The texture belongs to the cache, which deletes it once no quad uses it.
+TexturedQuad::~TexturedQuad() = default;
 
 void TexturedQuad::updateQuadPoints() {
     const float half_w = static_cast<float>(width_ * 0.5);
@@ -67,14 +64,12 @@ void TexturedQuad::setUVs(const std::array<UV, 4>& uvs) {
 
 const std::array<TexturedQuad::UV, 4>& TexturedQuad::uvs() const { return uvs_; }
 
-GLuint TexturedQuad::textureId() const {
-    ensureTextureUploaded();
-    return texture_id_;
+GLuint TexturedQuad::textureId(float priority) const {
+    if (dynamic_) return DynamicTextureUploader::instance()->textureId(*dynamic_);
+    return texture_ ? texture_->textureId(priority) : 0;
 }
 
-bool TexturedQuad::hasTexture() const { return texture_id_ != 0 || image_data_.isValid(); }
-
-// Note: Image::isValid() is now defined inline in texture_image.h
+bool TexturedQuad::hasTexture() const { return texture_ != nullptr || dynamic_ != nullptr; }
 
 bool TexturedQuad::loadTextureFromImage(const Image& image) {
     if (!isEditable()) {
@@ -86,16 +81,44 @@ bool TexturedQuad::loadTextureFromImage(const Image& image) {
         return false;
     }
 
-    // Save image data for lazy GPU upload
-    image_data_ = image;
-    texture_width_ = image.width;
-    texture_height_ = image.height;
+    texture_ = TextureCache::instance()->acquireImage(image);
+    dynamic_.reset();
+    texture_path_.clear();
+    texture_mipmaps_ = false;
+    return texture_ != nullptr;
+}
 
-    // If we have OpenGL context, upload immediately
-    if (QOpenGLContext::currentContext()) {
-        ensureTextureUploaded();
+bool TexturedQuad::loadTextureFromFile(const std::string& path, bool mipmaps) {
+    if (!isEditable()) {
+        qWarning() << "TexturedQuad::loadTextureFromFile: Shape not editable.";
+        return false;
     }
 
+    std::shared_ptr<SharedTexture> texture = TextureCache::instance()->acquireFile(path, mipmaps);
+    if (!texture) {
+        qWarning() << "TexturedQuad::loadTextureFromFile: Failed to load" << QString::fromStdString(path);
+        return false;
+    }
+    texture_ = std::move(texture);
+    dynamic_.reset();
+    texture_path_ = path;
+    texture_mipmaps_ = mipmaps;
+    return true;
+}
+
+bool TexturedQuad::setDynamicTexture(std::shared_ptr<DynamicTexture> texture) {
+    if (!isEditable()) {
+        qWarning() << "TexturedQuad::setDynamicTexture: Shape not editable.";
+        return false;
+    }
+    if (!texture) {
+        qWarning() << "TexturedQuad::setDynamicTexture: No texture.";
+        return false;
+    }
+    dynamic_ = std::move(texture);
+    texture_.reset();
+    texture_path_.clear();
+    texture_mipmaps_ = false;
     return true;
 }
 
@@ -104,122 +127,33 @@ Shape::Ptr TexturedQuad::clone() {
     new_shape->setUVs(uvs_);
     new_shape->setTransparency(transparency());
 
-    // Copy image data (no OpenGL context required)
-    // Each clone will create its own texture lazily when rendered
-    new_shape->image_data_ = image_data_;
-    new_shape->texture_width_ = texture_width_;
-    new_shape->texture_height_ = texture_height_;
-    // texture_id_ stays 0, will be created lazily via ensureTextureUploaded()
-
+    // Clones draw the same texture (no OpenGL context required)
+    new_shape->texture_ = texture_;
+    new_shape->dynamic_ = dynamic_;
+    new_shape->texture_path_ = texture_path_;
+    new_shape->texture_mipmaps_ = texture_mipmaps_;
     return new_shape;
 }
 
-int TexturedQuad::textureWidth() const { return texture_width_; }
-
-int TexturedQuad::textureHeight() const { return texture_height_; }
-
-bool TexturedQuad::cloneTexture(GLuint source_texture_id, int width, int height, GLuint& dest_texture_id) {
-    // Check if OpenGL context is valid
-    if (!QOpenGLContext::currentContext()) {
-        qWarning() << "TexturedQuad::cloneTexture: No valid OpenGL context";
-        return false;
-    }
-
-    // Allocate buffer to read texture data
-    std::vector<unsigned char> pixels(width * height * 4);
-
-    // Read texture data from source
-    glBindTexture(GL_TEXTURE_2D, source_texture_id);
-    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
-
-    // Create new texture
-    glGenTextures(1, &dest_texture_id);
-    glBindTexture(GL_TEXTURE_2D, dest_texture_id);
-
-    // Save current pixel storage alignment.
-    GLint oldAlignment;
-    glGetIntegerv(GL_UNPACK_ALIGNMENT, &oldAlignment);
-
-    // Set texture parameters
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-    // Upload texture data
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
-
-    // Restore pixel storage alignment.
-    glPixelStorei(GL_UNPACK_ALIGNMENT, oldAlignment);
-
-    glBindTexture(GL_TEXTURE_2D, 0);
-
-    return true;
+int TexturedQuad::textureWidth() const {
+    if (dynamic_) return dynamic_->width();
+    return texture_ ? texture_->width() : 0;
 }
 
-void TexturedQuad::ensureTextureUploaded() const {
-    // If texture already uploaded, nothing to do
-    if (texture_id_ != 0) {
-        return;
-    }
-
-    // Check if we have image data to upload
-    if (!image_data_.isValid()) {
-        return;
-    }
-
-    // Check if OpenGL context is valid
-    if (!QOpenGLContext::currentContext()) {
-        // No context yet, will upload later during rendering
-        return;
-    }
-
-    // Generate texture ID
-    glGenTextures(1, &texture_id_);
-
-    // Upload texture data
-    glBindTexture(GL_TEXTURE_2D, texture_id_);
-
-    // Save current pixel storage alignment
-    GLint oldAlignment;
-    glGetIntegerv(GL_UNPACK_ALIGNMENT, &oldAlignment);
-
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image_data_.width, image_data_.height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
-                 image_data_.pixels.data());
-
-    // Restore pixel storage alignment
-    glPixelStorei(GL_UNPACK_ALIGNMENT, oldAlignment);
-
-    glBindTexture(GL_TEXTURE_2D, 0);
+int TexturedQuad::textureHeight() const {
+    if (dynamic_) return dynamic_->height();
+    return texture_ ? texture_->height() : 0;
 }
 
-void TexturedQuad::releaseResources() {
-    if (texture_id_ == 0) {
-        return;
-    }
-
-    // This method should be called on the main thread with OpenGL context
-    if (QOpenGLContext::currentContext()) {
-        glDeleteTextures(1, &texture_id_);
-        texture_id_ = 0;
-        texture_width_ = 0;
-        texture_height_ = 0;
-    } else {
-        qWarning() << "TexturedQuad::releaseResources: No OpenGL context, texture" << texture_id_
-                   << "may leak. This method should be called on the rendering thread.";
-    }
+size_t TexturedQuad::textureBytes() const {
+    // Dynamic textures are drawn from one RGBA texture.
+    if (dynamic_) return static_cast<size_t>(dynamic_->width()) * dynamic_->height() * 4;
+    return texture_ ? texture_->bytes() : 0;
 }
 
-void TexturedQuad::safeDeleteTexture() {
-    // Delegate to releaseResources
-    releaseResources();
+const void* TexturedQuad::textureKey() const {
+    if (dynamic_) return dynamic_.get();
+    return texture_.get();
 }
 
 }  // namespace octo_flex
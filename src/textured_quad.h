@@ -20,6 +20,7 @@
 
 
 #include <array>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -31,6 +32,9 @@
 
 namespace octo_flex {
 
+class DynamicTexture;
+class SharedTexture;
+
 class TexturedQuad : public Shape {
    public:
     struct UV {
@@ -47,33 +51,49 @@ class TexturedQuad : public Shape {
     TexturedQuad(double width, double height);
     ~TexturedQuad() override;
 
+    // Both share the texture with every quad showing the same file or pixels. mipmaps generates
+    // the mip chain of decoded files; KTX2 files bring their own levels.
     bool loadTextureFromImage(const Image& image);
+    bool loadTextureFromFile(const std::string& path, bool mipmaps = false);
+
+    // Draw the newest frame of a dynamic texture instead; shared with its producer.
+    bool setDynamicTexture(std::shared_ptr<DynamicTexture> texture);
     void setSize(double width, double height);
+    double quadWidth() const { return width_; }
+    double quadHeight() const { return height_; }
 
     void setUVs(const std::array<UV, 4>& uvs);
     const std::array<UV, 4>& uvs() const;
 
-    GLuint textureId() const;
+    // Texture to draw with; 0 while the background upload is pending. priority orders pending
+    // uploads (lower first), for example by camera distance.
+    GLuint textureId(float priority = 0.0f) const;
     bool hasTexture() const;
     int textureWidth() const;
     int textureHeight() const;
 
+    // Texture memory of the texture drawn, and a key shared by every quad drawing the same one
+    // (null without a texture).
+    size_t textureBytes() const;
+    const void* textureKey() const;
+
+    // File the texture was loaded from and whether it was asked for mipmaps; empty for textures
+    // given as images or dynamic textures.
+    const std::string& texturePath() const { return texture_path_; }
+    bool textureMipmaps() const { return texture_mipmaps_; }
+
     Shape::Ptr clone() override;
-    void releaseResources() override;
 
    private:
     void updateQuadPoints();
-    bool cloneTexture(GLuint source_texture_id, int width, int height, GLuint& dest_texture_id);
-    void safeDeleteTexture();
-    void ensureTextureUploaded() const;  // const because it's lazy initialization
 
     double width_;
     double height_;
-    mutable GLuint texture_id_;  // mutable for lazy GPU upload
-    int texture_width_;
-    int texture_height_;
     std::array<UV, 4> uvs_;
-    Image image_data_;  // Store image data for lazy GPU upload
+    std::shared_ptr<SharedTexture> texture_;  // Cache entry, shared by clones
+    std::shared_ptr<DynamicTexture> dynamic_;  // Or a texture replaced in place
+    std::string texture_path_;
+    bool texture_mipmaps_ = false;
 };
 
 }  // namespace octo_flex
@@ -0,0 +1,251 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "trace.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace octo_flex {
+
+#ifdef OCTO_FLEX_TRACING
+
+namespace {
+
+constexpr uint64_t kTraceBufferEvents = 32768;
+
+struct TraceEvent {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<int64_t> start_ns{0};
+    std::atomic<int64_t> end_ns{0};
+};
+
+// Ring of one thread's zones. Only the owner writes; dumps read concurrently and drop the slots
+// the owner overwrote meanwhile.
+struct TraceBuffer {
+    explicit TraceBuffer(int tid) : events(kTraceBufferEvents), tid(tid) {}
+
+    std::vector<TraceEvent> events;
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> cleared{0};
+    int tid;
+    std::mutex name_mtx;
+    std::string name;
+};
+
+struct TraceRegistry {
+    std::mutex mtx;
+    std::vector<std::shared_ptr<TraceBuffer>> buffers;
+};
+
+// Leaked so threads that finish during static destruction can still record.
+TraceRegistry& registry() {
+    static TraceRegistry* instance = new TraceRegistry;
+    return *instance;
+}
+
+const std::chrono::steady_clock::time_point traceEpoch = std::chrono::steady_clock::now();
+
+TraceBuffer& threadBuffer() {
+    thread_local std::shared_ptr<TraceBuffer> buffer;
+    if (!buffer) {
+        TraceRegistry& reg = registry();
+        std::unique_lock<std::mutex> lock(reg.mtx);
+        buffer = std::make_shared<TraceBuffer>(static_cast<int>(reg.buffers.size()) + 1);
+        reg.buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+void appendEscaped(std::string& out, const std::string& text) {
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out += ' ';
+        } else {
+            out += c;
+        }
+    }
+}
+
+// Microseconds with nanosecond precision, as the trace format expects.
+void appendMicros(std::string& out, int64_t ns) {
+    out += std::to_string(ns / 1000);
+    out += '.';
+    std::string frac = std::to_string(ns % 1000);
+    out.append(3 - frac.size(), '0');
+    out += frac;
+}
+
+}  // namespace
+
+std::atomic<bool> traceRecording{false};
+
+int64_t traceNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - traceEpoch)
+        .count();
+}
+
+void traceRecord(const char* name, int64_t start_ns, int64_t end_ns) {
+    TraceBuffer& buffer = threadBuffer();
+    uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    TraceEvent& event = buffer.events[head % kTraceBufferEvents];
+    event.name.store(name, std::memory_order_relaxed);
+    event.start_ns.store(start_ns, std::memory_order_relaxed);
+    event.end_ns.store(end_ns, std::memory_order_relaxed);
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void setTracingEnabled(bool enabled) {
+    traceRecording.store(enabled, std::memory_order_relaxed);
+}
+
+bool isTracingEnabled() {
+    return traceRecording.load(std::memory_order_relaxed);
+}
+
+bool isTracingAvailable() {
+    return true;
+}
+
+void setTraceThreadName(const std::string& name) {
+    TraceBuffer& buffer = threadBuffer();
+    std::unique_lock<std::mutex> lock(buffer.name_mtx);
+    buffer.name = name;
+}
+
+std::string chromeTraceJson() {
+    std::vector<std::shared_ptr<TraceBuffer>> buffers;
+    {
+        TraceRegistry& reg = registry();
+        std::unique_lock<std::mutex> lock(reg.mtx);
+        buffers = reg.buffers;
+    }
+
+    const std::string pid = std::to_string(QCoreApplication::applicationPid());
+    std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    struct Copied {
+        const char* name;
+        int64_t start_ns;
+        int64_t end_ns;
+    };
+    std::vector<Copied> copied;
+    for (const auto& buffer : buffers) {
+        std::string name;
+        {
+            std::unique_lock<std::mutex> lock(buffer->name_mtx);
+            name = buffer->name;
+        }
+        const std::string tid = std::to_string(buffer->tid);
+        if (!name.empty()) {
+            out += first ? "" : ",";
+            first = false;
+            out += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" + pid + ",\"tid\":" + tid +
+                   ",\"args\":{\"name\":\"";
+            appendEscaped(out, name);
+            out += "\"}}";
+        }
+
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        uint64_t begin = std::max(buffer->cleared.load(std::memory_order_relaxed),
+                                  head > kTraceBufferEvents ? head - kTraceBufferEvents : 0);
+        copied.clear();
+        for (uint64_t i = begin; i < head; ++i) {
+            const TraceEvent& event = buffer->events[i % kTraceBufferEvents];
+            copied.push_back({event.name.load(std::memory_order_relaxed),
+                              event.start_ns.load(std::memory_order_relaxed),
+                              event.end_ns.load(std::memory_order_relaxed)});
+        }
+        // Slots the owner reused, or may be reusing, while they were copied hold a mix of two zones; drop them.
+        uint64_t reused = buffer->head.load(std::memory_order_acquire) + 1;
+        size_t skip =
+            reused > begin + kTraceBufferEvents ? static_cast<size_t>(reused - begin - kTraceBufferEvents) : 0;
+
+        for (size_t i = std::min(skip, copied.size()); i < copied.size(); ++i) {
+            const Copied& event = copied[i];
+            if (!event.name) continue;
+            out += first ? "" : ",";
+            first = false;
+            out += "{\"ph\":\"X\",\"name\":\"";
+            appendEscaped(out, event.name);
+            out += "\",\"pid\":" + pid + ",\"tid\":" + tid + ",\"ts\":";
+            appendMicros(out, event.start_ns);
+            out += ",\"dur\":";
+            appendMicros(out, std::max<int64_t>(event.end_ns - event.start_ns, 0));
+            out += "}";
+        }
+    }
+    out += "]}";
+    return out;
+}
+
+bool writeChromeTrace(const std::string& path, std::string* error) {
+    QFile file(QString::fromStdString(path));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (error) *error = "Cannot open " + path + ": " + file.errorString().toStdString();
+        return false;
+    }
+    const std::string json = chromeTraceJson();
+    if (file.write(json.data(), static_cast<qint64>(json.size())) != static_cast<qint64>(json.size())) {
+        if (error) *error = "Cannot write " + path + ": " + file.errorString().toStdString();
+        return false;
+    }
+    return true;
+}
+
+void clearTrace() {
+    TraceRegistry& reg = registry();
+    std::unique_lock<std::mutex> lock(reg.mtx);
+    for (const auto& buffer : reg.buffers) {
+        buffer->cleared.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+#else
+
+void setTracingEnabled(bool) {}
+
+bool isTracingEnabled() {
+    return false;
+}
+
+bool isTracingAvailable() {
+    return false;
+}
+
+void setTraceThreadName(const std::string&) {}
+
+std::string chromeTraceJson() {
+    return "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[]}";
+}
+
+bool writeChromeTrace(const std::string&, std::string* error) {
+    if (error) *error = "octo_flex_view was built without tracing (OCTO_FLEX_WITH_TRACING=OFF)";
+    return false;
+}
+
+void clearTrace() {}
+
+#endif
+
+}  // namespace octo_flex
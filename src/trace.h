@@ -0,0 +1,86 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include "tracing.h"
+
+namespace octo_flex {
+
+// Trace zones, recorded while setTracingEnabled(true) and compiled in with OCTO_FLEX_TRACING.
+// OCTO_FLEX_TRACE_ZONE("name") times the rest of the enclosing scope; names must be string
+// literals, only the pointer is kept.
+
+#ifdef OCTO_FLEX_TRACING
+
+extern std::atomic<bool> traceRecording;
+
+// Nanoseconds on the steady clock since the library loaded.
+int64_t traceNow();
+
+// Append a finished zone to the calling thread's buffer.
+void traceRecord(const char* name, int64_t start_ns, int64_t end_ns);
+
+class TraceZone {
+   public:
+    explicit TraceZone(const char* name)
+        : name_(traceRecording.load(std::memory_order_relaxed) ? name : nullptr), start_ns_(name_ ? traceNow() : 0) {}
+    ~TraceZone() {
+        if (name_) traceRecord(name_, start_ns_, traceNow());
+    }
+
+    TraceZone(const TraceZone&) = delete;
+    TraceZone& operator=(const TraceZone&) = delete;
+
+   private:
+    const char* name_;
+    int64_t start_ns_;
+};
+
+#define OCTO_FLEX_TRACE_JOIN2(a, b) a##b
+#define OCTO_FLEX_TRACE_JOIN(a, b) OCTO_FLEX_TRACE_JOIN2(a, b)
+#define OCTO_FLEX_TRACE_ZONE(name) ::octo_flex::TraceZone OCTO_FLEX_TRACE_JOIN(trace_zone_, __LINE__)(name)
+
+// Lock mutex, recording a zone named name only if it had to wait for another thread.
+template <typename Mutex>
+std::unique_lock<Mutex> traceLock(Mutex& mutex, const char* name) {
+    std::unique_lock<Mutex> lock(mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        TraceZone zone(name);
+        lock.lock();
+    }
+    return lock;
+}
+
+#else
+
+#define OCTO_FLEX_TRACE_ZONE(name) static_cast<void>(0)
+
+template <typename Mutex>
+std::unique_lock<Mutex> traceLock(Mutex& mutex, const char*) {
+    return std::unique_lock<Mutex>(mutex);
+}
+
+#endif
+
+}  // namespace octo_flex
+
+#endif  // TRACE_H
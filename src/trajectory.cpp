@@ -0,0 +1,286 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "trajectory.h"
+#include "trajectory_uploader.h"
+
+#include <QDebug>
+#include <QOpenGLFunctions>
+#include <algorithm>
+
+#include "shape.h"
+
+namespace octo_flex {
+namespace {
+
+// Slots per bounds block: dropping points recomputes the blocks they were in, at most this many slots each.
+const size_t kBlockSize = 256;
+
+}  // namespace
+
+struct Trajectory::Impl {
+    Impl(size_t capacity, double transparency)
+        : capacity(capacity),
+          transparency(transparency),
+          ring(capacity),
+          blocks((capacity + kBlockSize - 1) / kBlockSize) {}
+
+    const size_t capacity;
+    const double transparency;
+    std::atomic<uint64_t> appended{0};
+
+    // Points get consecutive sequence numbers; sequence s lives in slot s % capacity.
+    mutable std::mutex mutex;
+    std::vector<Shape::GpuVertex> ring;  // Guarded by mutex
+    uint64_t first = 0;                  // Oldest point held, guarded by mutex
+    uint64_t end = 0;                    // Next point appended, guarded by mutex
+    std::vector<BoundingBox> blocks;     // Bounds of the points held per block of slots, guarded by mutex
+    BoundingBox bounds;                  // Of all blocks, guarded by mutex
+
+    // Painting views only.
+    GLuint buffer = 0;
+    uint64_t uploadedEnd = 0;  // Points before it are in the buffer
+    uint64_t drawFirst = 0;    // Points in the buffer as of the last upload
+    uint64_t drawEnd = 0;
+    std::atomic<size_t> gpuBytes{0};
+
+    // Held point in slot, if any.
+    bool slotHeld(size_t slot) const {
+        const uint64_t sequence = first + (slot + capacity - first % capacity) % capacity;
+        return sequence < end;
+    }
+
+    void recomputeBlock(size_t block) {
+        BoundingBox box;
+        const size_t last = std::min((block + 1) * kBlockSize, capacity);
+        for (size_t slot = block * kBlockSize; slot < last; ++slot) {
+            if (!slotHeld(slot)) continue;
+            const Shape::GpuVertex& v = ring[slot];
+            box.expand(Vec3(v.x, v.y, v.z));
+        }
+        blocks[block] = box;
+    }
+
+    // Drop the points before sequence to; only the blocks they were in are recomputed.
+    void dropFront(uint64_t to) {
+        const uint64_t from = first;
+        first = to;
+        if (to == from) return;
+        if (to - from + kBlockSize >= capacity) {
+            for (size_t block = 0; block < blocks.size(); ++block) recomputeBlock(block);
+        } else {
+            size_t block = static_cast<size_t>(from % capacity) / kBlockSize;
+            const size_t last = static_cast<size_t>((to - 1) % capacity) / kBlockSize;
+            while (true) {
+                recomputeBlock(block);
+                if (block == last) break;
+                block = (block + 1) % blocks.size();
+            }
+        }
+    }
+
+    // Append under mutex; colors holds one color per point, or a single color for all of them.
+    void append(const std::vector<Vec3>& points, const Vec3* colors, bool perPoint) {
+        const float alpha = static_cast<float>(transparency);
+        const size_t skip = points.size() > capacity ? points.size() - capacity : 0;  // Dropped right away
+        for (size_t i = skip; i < points.size(); ++i) {
+            const size_t slot = static_cast<size_t>(end % capacity);
+            const Vec3& p = points[i];
+            const Vec3& c = perPoint ? colors[i] : colors[0];
+            ring[slot] = {static_cast<float>(p.x), static_cast<float>(p.y), static_cast<float>(p.z),
+                          static_cast<float>(c.x), static_cast<float>(c.y), static_cast<float>(c.z), alpha};
+            // Overwritten points are dropped below, which recomputes their blocks.
+            blocks[slot / kBlockSize].expand(p);
+            ++end;
+        }
+        appended += points.size();
+        if (end - first > capacity) dropFront(end - capacity);
+        updateBounds();
+    }
+
+    void updateBounds() {
+        bounds = BoundingBox();
+        for (const auto& block : blocks) {
+            if (block.valid) bounds.expand(block);
+        }
+    }
+};
+
+std::shared_ptr<Trajectory> Trajectory::create(size_t capacity, double transparency) {
+    // The ring is drawn with GLint vertex offsets.
+    if (capacity == 0 || capacity >= static_cast<size_t>(1u << 30)) {
+        qWarning() << "Trajectory::create: Invalid capacity" << capacity;
+        return nullptr;
+    }
+    return std::shared_ptr<Trajectory>(new Trajectory(capacity, transparency));
+}
+
+Trajectory::Trajectory(size_t capacity, double transparency) : impl_(new Impl(capacity, transparency)) {
+    TrajectoryUploader::instance()->add(impl_.get());
+}
+
+Trajectory::~Trajectory() { TrajectoryUploader::instance()->remove(impl_.get()); }
+
+size_t Trajectory::capacity() const { return impl_->capacity; }
+
+double Trajectory::transparency() const { return impl_->transparency; }
+
+bool Trajectory::append(const std::vector<Vec3>& points, const std::vector<Vec3>& colors) {
+    if (colors.size() != points.size()) {
+        qWarning() << "Trajectory::append:" << points.size() << "points but" << colors.size() << "colors";
+        return false;
+    }
+    if (points.empty()) return true;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        impl_->append(points, colors.data(), true);
+    }
+    TrajectoryUploader::instance()->changed();
+    return true;
+}
+
+void Trajectory::append(const std::vector<Vec3>& points, const Vec3& color) {
+    if (points.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        impl_->append(points, &color, false);
+    }
+    TrajectoryUploader::instance()->changed();
+}
+
+void Trajectory::trimFront(size_t count) {
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        const uint64_t held = impl_->end - impl_->first;
+        if (count == 0 || held == 0) return;
+        impl_->dropFront(impl_->first + std::min<uint64_t>(count, held));
+        impl_->updateBounds();
+    }
+    TrajectoryUploader::instance()->changed();
+}
+
+void Trajectory::clear() {
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex);
+        if (impl_->first == impl_->end) return;
+        impl_->first = impl_->end;
+        std::fill(impl_->blocks.begin(), impl_->blocks.end(), BoundingBox());
+        impl_->bounds = BoundingBox();
+    }
+    TrajectoryUploader::instance()->changed();
+}
+
+size_t Trajectory::size() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return static_cast<size_t>(impl_->end - impl_->first);
+}
+
+uint64_t Trajectory::appendedCount() const { return impl_->appended; }
+
+BoundingBox Trajectory::bounds() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->bounds;
+}
+
+void Trajectory::copyPoints(std::vector<Vec3>& points, std::vector<Vec3>* colors) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    points.clear();
+    if (colors) colors->clear();
+    for (uint64_t sequence = impl_->first; sequence < impl_->end; ++sequence) {
+        const Shape::GpuVertex& v = impl_->ring[static_cast<size_t>(sequence % impl_->capacity)];
+        points.emplace_back(v.x, v.y, v.z);
+        if (colors) colors->emplace_back(v.r, v.g, v.b);
+    }
+}
+
+void TrajectoryUploader::release(Trajectory::Impl* trajectory, uint32_t group) {
+    GlDeletionQueue::instance()->deleteBuffers(group, {trajectory->buffer});
+}
+
+void TrajectoryUploader::uploadPending() {
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    if (!context) return;
+    QOpenGLFunctions* gl = context->functions();
+
+    const GLsizeiptr vertexBytes = sizeof(Shape::GpuVertex);
+    uploadEach([gl, vertexBytes](Trajectory::Impl* trajectory) {
+        std::lock_guard<std::mutex> ringLock(trajectory->mutex);
+        if (trajectory->first == trajectory->drawFirst && trajectory->end == trajectory->drawEnd) return;
+        trajectory->drawFirst = trajectory->first;
+        trajectory->drawEnd = trajectory->end;
+        if (trajectory->first == trajectory->end) return;
+
+        const size_t capacity = trajectory->capacity;
+        if (trajectory->buffer == 0) {
+            // Allocated once for the whole ring and its mirror slot.
+            gl->glGenBuffers(1, &trajectory->buffer);
+            gl->glBindBuffer(GL_ARRAY_BUFFER, trajectory->buffer);
+            gl->glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(capacity + 1) * vertexBytes, nullptr,
+                             GL_DYNAMIC_DRAW);
+            trajectory->gpuBytes.store((capacity + 1) * sizeof(Shape::GpuVertex), std::memory_order_relaxed);
+        } else {
+            gl->glBindBuffer(GL_ARRAY_BUFFER, trajectory->buffer);
+        }
+
+        // Only the points appended since the last upload; ones already dropped again are skipped.
+        const uint64_t from = std::max(trajectory->uploadedEnd, trajectory->first);
+        const size_t count = static_cast<size_t>(trajectory->end - from);
+        const size_t start = static_cast<size_t>(from % capacity);
+        const size_t head = std::min(count, capacity - start);
+        const Shape::GpuVertex* ring = trajectory->ring.data();
+        if (head > 0) {
+            gl->glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(start) * vertexBytes,
+                                static_cast<GLsizeiptr>(head) * vertexBytes, ring + start);
+        }
+        if (count > head) {
+            gl->glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(count - head) * vertexBytes, ring);
+        }
+        if (count > 0 && (start == 0 || count > head)) {
+            gl->glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(capacity) * vertexBytes, vertexBytes, ring);
+        }
+        gl->glBindBuffer(GL_ARRAY_BUFFER, 0);
+        trajectory->uploadedEnd = trajectory->end;
+    });
+}
+
+TrajectoryUploader::Ranges TrajectoryUploader::ranges(const Trajectory& trajectory, bool strip) const {
+    const Trajectory::Impl& t = *trajectory.impl_;
+    Ranges ranges;
+    if (t.buffer == 0 || t.drawEnd == t.drawFirst) return ranges;
+    ranges.buffer = t.buffer;
+
+    const size_t count = static_cast<size_t>(t.drawEnd - t.drawFirst);
+    const size_t start = static_cast<size_t>(t.drawFirst % t.capacity);
+    ranges.firsts[0] = static_cast<GLint>(start);
+    if (start + count <= t.capacity) {
+        ranges.counts[0] = static_cast<GLsizei>(count);
+        ranges.count = 1;
+        return ranges;
+    }
+    // Wrapped: a strip runs on into the mirror of slot 0 and restarts there.
+    const size_t tail = t.capacity - start;
+    ranges.counts[0] = static_cast<GLsizei>(strip ? tail + 1 : tail);
+    ranges.firsts[1] = 0;
+    ranges.counts[1] = static_cast<GLsizei>(count - tail);
+    ranges.count = 2;
+    return ranges;
+}
+
+size_t TrajectoryUploader::gpuBytes(const Trajectory& trajectory) const {
+    return trajectory.impl_->gpuBytes.load(std::memory_order_relaxed);
+}
+
+}  // namespace octo_flex
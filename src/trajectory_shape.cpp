@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "trajectory_shape.h"
+
+#include "trajectory_uploader.h"
+#include "utils.h"
+
+namespace octo_flex {
+
+TrajectoryShape::TrajectoryShape(std::shared_ptr<octo_flex::Trajectory> trajectory, bool strip, double width)
+    : Shape(Shape::Trajectory, width, trajectory ? trajectory->transparency() : 1.0),
+      trajectory_(std::move(trajectory)),
+      strip_(strip) {}
+
+BoundingBox TrajectoryShape::bounds() const {
+    if (!trajectory_) return BoundingBox();
+    const BoundingBox local = trajectory_->bounds();
+    if (!transformed_ || !local.valid) return local;
+
+    // The transformed corners bound the transformed points.
+    BoundingBox box;
+    for (int corner = 0; corner < 8; ++corner) {
+        const glm::vec4 p = transform_ * glm::vec4((corner & 1) ? local.max.x : local.min.x,
+                                                   (corner & 2) ? local.max.y : local.min.y,
+                                                   (corner & 4) ? local.max.z : local.min.z, 1.0f);
+        box.expand(Vec3(p.x, p.y, p.z));
+    }
+    return box;
+}
+
+size_t TrajectoryShape::cpuBytes() const {
+    return trajectory_ ? trajectory_->capacity() * sizeof(GpuVertex) : 0;
+}
+
+size_t TrajectoryShape::gpuBytes() const {
+    return trajectory_ ? TrajectoryUploader::instance()->gpuBytes(*trajectory_) : 0;
+}
+
+void TrajectoryShape::move(const Vec3& vec) {
+    glm::mat4 matrix(1.0f);
+    matrix[3] = glm::vec4(vec.x, vec.y, vec.z, 1.0f);
+    applyTransform(matrix);
+}
+
+void TrajectoryShape::rotate(const Quaternion& quad) {
+    // Columns are the rotated axes, matching Shape::rotate on each point.
+    glm::mat4 matrix(1.0f);
+    const Vec3 axes[3] = {Vec3(1, 0, 0), Vec3(0, 1, 0), Vec3(0, 0, 1)};
+    for (int i = 0; i < 3; ++i) {
+        const Vec3 axis = quaternionRotateVector(quad, axes[i]);
+        matrix[i] = glm::vec4(axis.x, axis.y, axis.z, 0.0f);
+    }
+    applyTransform(matrix);
+}
+
+void TrajectoryShape::scale(double sx, double sy, double sz) {
+    glm::mat4 matrix(1.0f);
+    matrix[0][0] = static_cast<float>(sx);
+    matrix[1][1] = static_cast<float>(sy);
+    matrix[2][2] = static_cast<float>(sz);
+    applyTransform(matrix);
+}
+
+void TrajectoryShape::applyTransform(const glm::mat4& matrix) {
+    if (!isEditable()) return;
+    transform_ = matrix * transform_;
+    transformed_ = true;
+}
+
+Shape::Ptr TrajectoryShape::clone() {
+    auto new_shape = std::make_shared<TrajectoryShape>(trajectory_, strip_, width());
+    new_shape->setLodLevel(lodLevel());
+    new_shape->transform_ = transform_;
+    new_shape->transformed_ = transformed_;
+    return new_shape;
+}
+
+}  // namespace octo_flex
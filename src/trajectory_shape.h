@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TRAJECTORY_SHAPE_H
+#define TRAJECTORY_SHAPE_H
+
+#include <memory>
+
+#include <glm/glm.hpp>
+#include "def.h"
+#include "shape.h"
+#include "trajectory.h"
+
+namespace octo_flex {
+
+// Shape drawing the points of a trajectory as one line strip or as points. It holds no vertices of
+// its own: points(), vertexBuffer() and the batches stay empty, and the views draw from the
+// trajectory's ring buffer (see TrajectoryUploader). The trajectory is shared with its producer and
+// with clones, so the points keep changing after the shape is frozen.
+class TrajectoryShape : public Shape {
+   public:
+    typedef std::shared_ptr<TrajectoryShape> Ptr;
+
+    // width is the line width, or the point size when not drawn as a strip.
+    TrajectoryShape(std::shared_ptr<octo_flex::Trajectory> trajectory, bool strip, double width);
+
+    const std::shared_ptr<octo_flex::Trajectory>& trajectory() const { return trajectory_; }
+    bool isStrip() const { return strip_; }
+
+    // Shape transforms apply to the points as they come, through this matrix; identity until moved.
+    const glm::mat4& transform() const { return transform_; }
+    bool isTransformed() const { return transformed_; }
+
+    // Bounds of the points held now, transformed.
+    BoundingBox bounds() const override;
+
+    // The ring, shared with the producer and counted by each shape showing it.
+    size_t cpuBytes() const override;
+    size_t gpuBytes() const override;
+
+    void move(const Vec3& vec) override;
+    void rotate(const Quaternion& quad) override;
+    void scale(double sx, double sy, double sz) override;
+
+    Shape::Ptr clone() override;
+
+   private:
+    void applyTransform(const glm::mat4& matrix);
+
+    std::shared_ptr<octo_flex::Trajectory> trajectory_;
+    bool strip_;
+    glm::mat4 transform_ = glm::mat4(1.0f);
+    bool transformed_ = false;
+};
+
+}  // namespace octo_flex
+
+#endif  // TRAJECTORY_SHAPE_H
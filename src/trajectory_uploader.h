@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TRAJECTORY_UPLOADER_H
+#define TRAJECTORY_UPLOADER_H
+
+#include <QOpenGLContext>
+
+#include "trajectory.h"
+#include "upload_registry.h"
+
+namespace octo_flex {
+
+// GL side of the trajectories, uploaded by the views as they paint. Each trajectory keeps one
+// vertex buffer of capacity + 1 vertices, allocated once: slots are written in ring order as points
+// are appended, and slot capacity mirrors slot 0 so a line strip running over the end of the ring
+// continues into its start. Trimming only moves the first slot drawn.
+class TrajectoryUploader : public UploadRegistry<TrajectoryUploader, Trajectory::Impl> {
+   public:
+    // Vertex ranges of the uploaded points, oldest first: one, or two once the ring wrapped.
+    struct Ranges {
+        GLuint buffer = 0;
+        GLint firsts[2] = {0, 0};
+        GLsizei counts[2] = {0, 0};
+        GLsizei count = 0;  // Ranges used; 0 if nothing is uploaded
+    };
+
+    // Upload the points appended to every trajectory since the last call; called by the views at the
+    // start of paintGL, with their context current.
+    void uploadPending();
+
+    // Ranges to draw the points uploaded so far as a line strip, or as points (without the mirror slot).
+    Ranges ranges(const Trajectory& trajectory, bool strip) const;
+
+    // Bytes of the trajectory's vertex buffer, 0 before the first upload. Safe to call from any thread.
+    size_t gpuBytes(const Trajectory& trajectory) const;
+
+   private:
+    friend class Trajectory;
+    friend class UploadRegistry<TrajectoryUploader, Trajectory::Impl>;
+
+    TrajectoryUploader() {}
+
+    void release(Trajectory::Impl* trajectory, uint32_t group);
+};
+
+}  // namespace octo_flex
+
+#endif  // TRAJECTORY_UPLOADER_H
@@ -0,0 +1,457 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// EarClipper is adapted from earcut (https://github.com/mapbox/earcut):
+//
+// ISC License
+//
+// Copyright (c) 2016, Mapbox
+//
+// Permission to use, copy, modify, and/or distribute this software for any purpose
+// with or without fee is hereby granted, provided that the above copyright notice
+// and this permission notice appear in all copies.
+//
+// THE SOFTWARE IS PROVIDED "AS IS" AND ISC DISCLAIMS ALL WARRANTIES WITH REGARD TO
+// THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+// IN NO EVENT SHALL ISC BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR
+// CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA
+// OR PROFITS, WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION,
+// ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+
+#include "triangulation.h"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+
+namespace octo_flex {
+namespace {
+
+// Ear clipping over doubly linked rings, with holes bridged into the outer ring first (earcut's
+// algorithm, see the notice above).
+// Rings are normalized so that a convex vertex has negative area(prev, vertex, next).
+class EarClipper {
+   public:
+    EarClipper(const std::vector<double>& xs, const std::vector<double>& ys, std::vector<uint32_t>& triangles)
+        : xs_(xs), ys_(ys), triangles_(triangles) {}
+
+    void run(size_t outer_end, const std::vector<size_t>& hole_starts) {
+        Node* outer = linkedList(0, outer_end, true);
+        if (!outer || outer->next == outer->prev) return;
+        if (!hole_starts.empty()) {
+            outer = eliminateHoles(hole_starts, outer);
+        }
+        earcutLinked(outer, 0);
+    }
+
+   private:
+    struct Node {
+        uint32_t i;
+        double x;
+        double y;
+        Node* prev;
+        Node* next;
+        bool steiner;
+    };
+
+    Node* insertNode(size_t i, Node* last) {
+        nodes_.push_back({static_cast<uint32_t>(i), xs_[i], ys_[i], nullptr, nullptr, false});
+        Node* p = &nodes_.back();
+        if (!last) {
+            p->prev = p;
+            p->next = p;
+        } else {
+            p->next = last->next;
+            p->prev = last;
+            last->next->prev = p;
+            last->next = p;
+        }
+        return p;
+    }
+
+    static void removeNode(Node* p) {
+        p->next->prev = p->prev;
+        p->prev->next = p->next;
+    }
+
+    static double area(const Node* p, const Node* q, const Node* r) {
+        return (q->y - p->y) * (r->x - q->x) - (q->x - p->x) * (r->y - q->y);
+    }
+
+    static bool equals(const Node* a, const Node* b) { return a->x == b->x && a->y == b->y; }
+
+    static bool pointInTriangle(double ax, double ay, double bx, double by, double cx, double cy, double px,
+                                double py) {
+        return (cx - px) * (ay - py) >= (ax - px) * (cy - py) && (ax - px) * (by - py) >= (bx - px) * (ay - py) &&
+               (bx - px) * (cy - py) >= (cx - px) * (by - py);
+    }
+
+    double signedArea(size_t start, size_t end) const {
+        double sum = 0;
+        for (size_t i = start, j = end - 1; i < end; j = i++) {
+            sum += (xs_[j] - xs_[i]) * (ys_[i] + ys_[j]);
+        }
+        return sum;
+    }
+
+    // Ring of vertices [start, end) in the requested winding, without a repeated closing vertex.
+    Node* linkedList(size_t start, size_t end, bool clockwise) {
+        if (end <= start) return nullptr;
+        Node* last = nullptr;
+        if (clockwise == (signedArea(start, end) > 0)) {
+            for (size_t i = start; i < end; ++i) last = insertNode(i, last);
+        } else {
+            for (size_t i = end; i-- > start;) last = insertNode(i, last);
+        }
+        if (last && equals(last, last->next)) {
+            removeNode(last);
+            last = last->next;
+        }
+        return last;
+    }
+
+    // Drop duplicate and collinear vertices.
+    static Node* filterPoints(Node* start, Node* end = nullptr) {
+        if (!start) return start;
+        if (!end) end = start;
+
+        Node* p = start;
+        bool again;
+        do {
+            again = false;
+            if (!p->steiner && (equals(p, p->next) || area(p->prev, p, p->next) == 0)) {
+                removeNode(p);
+                p = end = p->prev;
+                if (p == p->next) break;
+                again = true;
+            } else {
+                p = p->next;
+            }
+        } while (again || p != end);
+        return end;
+    }
+
+    void emit(const Node* a, const Node* b, const Node* c) {
+        triangles_.push_back(a->i);
+        triangles_.push_back(b->i);
+        triangles_.push_back(c->i);
+    }
+
+    // Clip ears; when none is left, retry on a filtered ring, then fix self-touching spots, then split.
+    void earcutLinked(Node* ear, int pass) {
+        if (!ear) return;
+
+        Node* stop = ear;
+        while (ear->prev != ear->next) {
+            Node* prev = ear->prev;
+            Node* next = ear->next;
+            if (isEar(ear)) {
+                emit(prev, ear, next);
+                removeNode(ear);
+                ear = next->next;
+                stop = next->next;
+                continue;
+            }
+
+            ear = next;
+            if (ear == stop) {
+                if (pass == 0) {
+                    earcutLinked(filterPoints(ear), 1);
+                } else if (pass == 1) {
+                    earcutLinked(cureLocalIntersections(filterPoints(ear)), 2);
+                } else {
+                    splitEarcut(ear);
+                }
+                break;
+            }
+        }
+    }
+
+    static bool isEar(const Node* ear) {
+        const Node* a = ear->prev;
+        const Node* b = ear;
+        const Node* c = ear->next;
+        if (area(a, b, c) >= 0) return false;  // Reflex
+
+        // No other vertex may lie inside the ear.
+        for (const Node* p = c->next; p != a; p = p->next) {
+            if (pointInTriangle(a->x, a->y, b->x, b->y, c->x, c->y, p->x, p->y) && area(p->prev, p, p->next) >= 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Cut off small self-intersections: a-p-p.next-b where a-p and p.next-b cross.
+    Node* cureLocalIntersections(Node* start) {
+        Node* p = start;
+        do {
+            Node* a = p->prev;
+            Node* b = p->next->next;
+            if (!equals(a, b) && intersects(a, p, p->next, b) && locallyInside(a, b) && locallyInside(b, a)) {
+                emit(a, p, b);
+                removeNode(p);
+                removeNode(p->next);
+                p = start = b;
+            }
+            p = p->next;
+        } while (p != start);
+        return filterPoints(p);
+    }
+
+    // Split the ring along a valid diagonal and triangulate both halves.
+    void splitEarcut(Node* start) {
+        Node* a = start;
+        do {
+            Node* b = a->next->next;
+            while (b != a->prev) {
+                if (a->i != b->i && isValidDiagonal(a, b)) {
+                    Node* c = splitPolygon(a, b);
+                    a = filterPoints(a, a->next);
+                    c = filterPoints(c, c->next);
+                    earcutLinked(a, 0);
+                    earcutLinked(c, 0);
+                    return;
+                }
+                b = b->next;
+            }
+            a = a->next;
+        } while (a != start);
+    }
+
+    // Bridge every hole into the outer ring, leftmost hole first.
+    Node* eliminateHoles(const std::vector<size_t>& hole_starts, Node* outer) {
+        std::vector<Node*> queue;
+        for (size_t h = 0; h < hole_starts.size(); ++h) {
+            const size_t start = hole_starts[h];
+            const size_t end = h + 1 < hole_starts.size() ? hole_starts[h + 1] : xs_.size();
+            Node* list = linkedList(start, end, false);
+            if (!list) continue;
+            if (list == list->next) list->steiner = true;
+            queue.push_back(getLeftmost(list));
+        }
+        std::sort(queue.begin(), queue.end(), [](const Node* a, const Node* b) { return a->x < b->x; });
+
+        for (Node* hole : queue) {
+            outer = eliminateHole(hole, outer);
+        }
+        return outer;
+    }
+
+    Node* eliminateHole(Node* hole, Node* outer) {
+        Node* bridge = findHoleBridge(hole, outer);
+        if (!bridge) return outer;
+
+        Node* bridge_reverse = splitPolygon(bridge, hole);
+        filterPoints(bridge_reverse, bridge_reverse->next);
+        return filterPoints(bridge, bridge->next);
+    }
+
+    // Outer vertex visible from the hole's leftmost vertex, found by casting a ray to the left.
+    static Node* findHoleBridge(const Node* hole, Node* outer) {
+        Node* p = outer;
+        const double hx = hole->x;
+        const double hy = hole->y;
+        double qx = -std::numeric_limits<double>::infinity();
+        Node* m = nullptr;
+
+        // Nearest segment crossed by the ray, taking its endpoint with the smaller x.
+        do {
+            if (hy <= p->y && hy >= p->next->y && p->next->y != p->y) {
+                const double x = p->x + (hy - p->y) * (p->next->x - p->x) / (p->next->y - p->y);
+                if (x <= hx && x > qx) {
+                    qx = x;
+                    m = p->x < p->next->x ? p : p->next;
+                    if (x == hx) return m;  // The hole touches the outer ring
+                }
+            }
+            p = p->next;
+        } while (p != outer);
+        if (!m) return nullptr;
+
+        // A reflex vertex inside the triangle hole-crossing-m may block m; take the one at the smallest angle.
+        const Node* stop = m;
+        const double mx = m->x;
+        const double my = m->y;
+        double tan_min = std::numeric_limits<double>::infinity();
+        p = m;
+        do {
+            if (hx >= p->x && p->x >= mx && hx != p->x &&
+                pointInTriangle(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, p->x, p->y)) {
+                const double slope = std::abs(hy - p->y) / (hx - p->x);
+                const bool better =
+                    slope < tan_min ||
+                    (slope == tan_min && (p->x > m->x || (p->x == m->x && sectorContainsSector(m, p))));
+                if (locallyInside(p, hole) && better) {
+                    m = p;
+                    tan_min = slope;
+                }
+            }
+            p = p->next;
+        } while (p != stop);
+        return m;
+    }
+
+    static bool sectorContainsSector(const Node* m, const Node* p) {
+        return area(m->prev, m, p->prev) < 0 && area(p->next, m, m->next) < 0;
+    }
+
+    static Node* getLeftmost(Node* start) {
+        Node* p = start;
+        Node* leftmost = start;
+        do {
+            if (p->x < leftmost->x || (p->x == leftmost->x && p->y < leftmost->y)) leftmost = p;
+            p = p->next;
+        } while (p != start);
+        return leftmost;
+    }
+
+    static bool isValidDiagonal(const Node* a, const Node* b) {
+        return a->next->i != b->i && a->prev->i != b->i && !intersectsPolygon(a, b) &&
+               ((locallyInside(a, b) && locallyInside(b, a) && middleInside(a, b) &&
+                 (area(a->prev, a, b->prev) != 0 || area(a, b->prev, b) != 0)) ||
+                (equals(a, b) && area(a->prev, a, a->next) > 0 && area(b->prev, b, b->next) > 0));
+    }
+
+    static int sign(double v) { return (v > 0) - (v < 0); }
+
+    static bool onSegment(const Node* p, const Node* q, const Node* r) {
+        return q->x <= std::max(p->x, r->x) && q->x >= std::min(p->x, r->x) && q->y <= std::max(p->y, r->y) &&
+               q->y >= std::min(p->y, r->y);
+    }
+
+    static bool intersects(const Node* p1, const Node* q1, const Node* p2, const Node* q2) {
+        const int o1 = sign(area(p1, q1, p2));
+        const int o2 = sign(area(p1, q1, q2));
+        const int o3 = sign(area(p2, q2, p1));
+        const int o4 = sign(area(p2, q2, q1));
+        if (o1 != o2 && o3 != o4) return true;
+        if (o1 == 0 && onSegment(p1, p2, q1)) return true;
+        if (o2 == 0 && onSegment(p1, q2, q1)) return true;
+        if (o3 == 0 && onSegment(p2, p1, q2)) return true;
+        if (o4 == 0 && onSegment(p2, q1, q2)) return true;
+        return false;
+    }
+
+    static bool intersectsPolygon(const Node* a, const Node* b) {
+        const Node* p = a;
+        do {
+            if (p->i != a->i && p->next->i != a->i && p->i != b->i && p->next->i != b->i &&
+                intersects(p, p->next, a, b)) {
+                return true;
+            }
+            p = p->next;
+        } while (p != a);
+        return false;
+    }
+
+    static bool locallyInside(const Node* a, const Node* b) {
+        return area(a->prev, a, a->next) < 0 ? area(a, b, a->next) >= 0 && area(a, a->prev, b) >= 0
+                                             : area(a, b, a->prev) < 0 || area(a, a->next, b) < 0;
+    }
+
+    static bool middleInside(const Node* a, const Node* b) {
+        const Node* p = a;
+        bool inside = false;
+        const double px = (a->x + b->x) / 2;
+        const double py = (a->y + b->y) / 2;
+        do {
+            if (((p->y > py) != (p->next->y > py)) && p->next->y != p->y &&
+                (px < (p->next->x - p->x) * (py - p->y) / (p->next->y - p->y) + p->x)) {
+                inside = !inside;
+            }
+            p = p->next;
+        } while (p != a);
+        return inside;
+    }
+
+    // Link a and b with a diagonal; returns the copy of b that starts the second ring.
+    Node* splitPolygon(Node* a, Node* b) {
+        nodes_.push_back(*a);
+        Node* a2 = &nodes_.back();
+        nodes_.push_back(*b);
+        Node* b2 = &nodes_.back();
+        Node* an = a->next;
+        Node* bp = b->prev;
+
+        a->next = b;
+        b->prev = a;
+        a2->next = an;
+        an->prev = a2;
+        b2->next = a2;
+        a2->prev = b2;
+        bp->next = b2;
+        b2->prev = bp;
+        return b2;
+    }
+
+    const std::vector<double>& xs_;
+    const std::vector<double>& ys_;
+    std::vector<uint32_t>& triangles_;
+    std::deque<Node> nodes_;  // Stable addresses while rings are relinked
+};
+
+}  // namespace
+
+std::vector<uint32_t> triangulatePolygon(const std::vector<Vec3>& points, const std::vector<size_t>& hole_starts) {
+    std::vector<uint32_t> triangles;
+    const size_t outer_end = hole_starts.empty() ? points.size() : std::min(hole_starts.front(), points.size());
+    if (outer_end < 3) return triangles;
+
+    // Plane of the outer ring (Newell's method); drop the axis its normal is closest to.
+    double nx = 0, ny = 0, nz = 0;
+    for (size_t i = 0, j = outer_end - 1; i < outer_end; j = i++) {
+        const Vec3& a = points[j];
+        const Vec3& b = points[i];
+        nx += (a.y - b.y) * (a.z + b.z);
+        ny += (a.z - b.z) * (a.x + b.x);
+        nz += (a.x - b.x) * (a.y + b.y);
+    }
+    const double ax = std::abs(nx), ay = std::abs(ny), az = std::abs(nz);
+    if (ax == 0 && ay == 0 && az == 0) return triangles;
+
+    // Holes must be ordered and inside the point list.
+    std::vector<size_t> holes;
+    for (size_t start : hole_starts) {
+        if (start >= points.size() || (!holes.empty() && start <= holes.back())) {
+            return triangles;
+        }
+        holes.push_back(start);
+    }
+
+    std::vector<double> xs(points.size());
+    std::vector<double> ys(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        const Vec3& p = points[i];
+        if (az >= ax && az >= ay) {
+            xs[i] = p.x;
+            ys[i] = p.y;
+        } else if (ax >= ay) {
+            xs[i] = p.y;
+            ys[i] = p.z;
+        } else {
+            xs[i] = p.z;
+            ys[i] = p.x;
+        }
+    }
+
+    triangles.reserve((points.size() + 2 * holes.size()) * 3);
+    EarClipper(xs, ys, triangles).run(outer_end, holes);
+    return triangles;
+}
+
+}  // namespace octo_flex
@@ -0,0 +1,36 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TRIANGULATION_H
+#define TRIANGULATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "def.h"
+
+namespace octo_flex {
+
+// Triangulate a planar polygon: the outer ring, then each hole ring, with hole_starts holding the
+// index of the first vertex of every hole. Rings may be concave and wind either way; the polygon is
+// projected onto the plane of its outer ring. Returns vertex indices, three per triangle, and
+// nothing for degenerate input.
+std::vector<uint32_t> triangulatePolygon(const std::vector<Vec3>& points, const std::vector<size_t>& hole_starts);
+
+}  // namespace octo_flex
+
+#endif /* TRIANGULATION_H */
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+
+namespace octo_flex {
+
+// Hands the latest value from one writer thread to one reader thread without locks or waiting.
+// The writer fills back() and publishes it; the reader takes the newest published value, skipping
+// any it missed. Each side owns one slot, the third is exchanged through an atomic index.
+template <typename T>
+class TripleBuffer {
+   public:
+    // Writer: slot to fill, then publish() it.
+    T& back() { return slots_[back_]; }
+    void publish() { back_ = middle_.exchange(back_ | kFresh, std::memory_order_acq_rel) & kIndex; }
+
+    // Reader: take the value published last, if it is newer than front(); false if nothing changed.
+    bool update() {
+        if ((middle_.load(std::memory_order_relaxed) & kFresh) == 0) return false;
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndex;
+        return true;
+    }
+    const T& front() const { return slots_[front_]; }
+
+   private:
+    static const int kIndex = 3;  // Slot index bits of middle_
+    static const int kFresh = 4;  // Set while middle_ holds a value the reader has not taken
+
+    T slots_[3] = {};
+    int back_ = 0;                 // Writer only
+    std::atomic<int> middle_{1};
+    int front_ = 2;                // Reader only
+};
+
+}  // namespace octo_flex
+
+#endif  // TRIPLE_BUFFER_H
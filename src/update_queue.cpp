@@ -0,0 +1,100 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "update_queue.h"
+
+namespace octo_flex {
+
+UpdateQueue::UpdateQueue(size_t capacity) : head_(&stub_), tail_(&stub_), capacity_(capacity) {}
+
+UpdateQueue::~UpdateQueue() {
+    UpdateCommand command;
+    while (pop(command)) {
+    }
+}
+
+bool UpdateQueue::push(UpdateCommand command) {
+    // Reserve a slot first so the depth never exceeds the capacity.
+    if (depth_.fetch_add(1, std::memory_order_acq_rel) >= capacity_.load(std::memory_order_relaxed)) {
+        depth_.fetch_sub(1, std::memory_order_acq_rel);
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Node* node = new Node();
+    node->command = std::move(command);
+    link(node);
+    pushed_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void UpdateQueue::link(Node* node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+}
+
+bool UpdateQueue::pop(UpdateCommand& command) {
+    Node* tail = tail_;
+    Node* next = tail->next.load(std::memory_order_acquire);
+
+    // Skip the stub node.
+    if (tail == &stub_) {
+        if (next == nullptr) return false;
+        tail_ = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next != nullptr) {
+        tail_ = next;
+        take(tail, command);
+        return true;
+    }
+
+    // A producer swapped head_ but has not linked its node yet; it shows up on a later pop.
+    if (tail != head_.load(std::memory_order_acquire)) return false;
+
+    // tail is the last node: put the stub behind it so tail can be handed out.
+    link(&stub_);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next != nullptr) {
+        tail_ = next;
+        take(tail, command);
+        return true;
+    }
+    return false;
+}
+
+void UpdateQueue::take(Node* node, UpdateCommand& command) {
+    command = std::move(node->command);
+    delete node;
+    depth_.fetch_sub(1, std::memory_order_acq_rel);
+    popped_.fetch_add(1, std::memory_order_relaxed);
+}
+
+UpdateQueueStats UpdateQueue::stats() const {
+    UpdateQueueStats stats;
+    stats.depth = depth_.load(std::memory_order_acquire);
+    stats.capacity = capacity_.load(std::memory_order_relaxed);
+    stats.pushed = pushed_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.applied = popped_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+}  // namespace octo_flex
@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef UPDATE_QUEUE_H
+#define UPDATE_QUEUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "def.h"
+#include "object.h"
+#include "update_queue_stats.h"
+
+namespace octo_flex {
+
+// Scene change posted by a producer thread, applied by the render thread at frame start.
+struct UpdateCommand {
+    enum Type { Submit = 0, Remove, ReplaceLayer, UpdatePose };
+
+    Type type = Submit;
+    std::string layer_id;
+    std::string object_id;             // Remove, UpdatePose
+    Object::Ptr object;                // Submit
+    std::vector<Object::Ptr> objects;  // ReplaceLayer
+    Vec3 position;                     // UpdatePose
+    Quaternion orientation;            // UpdatePose
+};
+
+// Bounded lock-free multi-producer single-consumer queue (intrusive linked list with a stub node).
+// push never blocks and may be called from any thread; pop must only be called from one thread.
+class UpdateQueue {
+   public:
+    explicit UpdateQueue(size_t capacity = 65536);
+    ~UpdateQueue();
+
+    UpdateQueue(const UpdateQueue&) = delete;
+    UpdateQueue& operator=(const UpdateQueue&) = delete;
+
+    // Returns false and counts a drop if the queue already holds capacity commands.
+    bool push(UpdateCommand command);
+
+    // Take the oldest command; false if empty or the newest push is still being linked.
+    bool pop(UpdateCommand& command);
+
+    size_t size() const { return depth_.load(std::memory_order_acquire); }
+    void setCapacity(size_t capacity) { capacity_.store(capacity, std::memory_order_relaxed); }
+    UpdateQueueStats stats() const;
+
+   private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        UpdateCommand command;
+    };
+
+    void link(Node* node);
+    void take(Node* node, UpdateCommand& command);
+
+    std::atomic<Node*> head_;  // Last pushed node, swapped by producers
+    Node* tail_;               // Next node to pop, consumer only
+    Node stub_;
+    std::atomic<size_t> depth_{0};
+    std::atomic<size_t> capacity_;
+    std::atomic<uint64_t> pushed_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> popped_{0};
+};
+
+}  // namespace octo_flex
+
+#endif /* UPDATE_QUEUE_H */
@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef UPLOAD_REGISTRY_H
+#define UPLOAD_REGISTRY_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "gl_deletion_queue.h"
+
+namespace octo_flex {
+
+// Registry behind the uploaders of GPU-backed handles (dynamic textures, trajectories, scalar
+// fields): handles register for their lifetime and are filled from any thread, and whichever view
+// paints next uploads them, on its render thread or the GUI thread, with its context current.
+// Uploader derives from UploadRegistry<Uploader, Handle> and implements
+//     void release(Handle* handle, uint32_t group);
+// handing the handle's GL names to GlDeletionQueue for the share group that created them.
+template <typename Uploader, typename Handle>
+class UploadRegistry {
+   public:
+    static Uploader* instance() {
+        static Uploader uploader;
+        return &uploader;
+    }
+
+    // Changes across all handles; views repaint when it changed.
+    uint64_t submitted() const { return submitted_; }
+
+   protected:
+    UploadRegistry() {}
+
+    void add(Handle* handle) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        handles_.push_back(handle);
+    }
+
+    // Called when a handle is destroyed, from any thread.
+    void remove(Handle* handle) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        handles_.erase(std::remove(handles_.begin(), handles_.end(), handle), handles_.end());
+        static_cast<Uploader*>(this)->release(handle, group_);
+    }
+
+    void changed() { ++submitted_; }
+
+    // Run upload(handle) on every handle, recording the current context's share group as the one
+    // their names are created in; nothing without a current context.
+    template <typename Upload>
+    void uploadEach(Upload upload) {
+        const uint32_t group = GlDeletionQueue::instance()->currentGroup();
+        if (group == 0) return;
+        std::lock_guard<std::mutex> lock(mutex_);
+        group_ = group;
+        for (Handle* handle : handles_) upload(handle);
+    }
+
+   private:
+    std::mutex mutex_;  // Held while uploading, so handles are not destroyed meanwhile
+    std::vector<Handle*> handles_;
+    uint32_t group_ = 0;
+    std::atomic<uint64_t> submitted_{0};
+};
+
+}  // namespace octo_flex
+
+#endif  // UPLOAD_REGISTRY_H
@@ -17,6 +17,9 @@
 
 #include "utils.h"
 #include <cmath>
+#include <map>
+#include <mutex>
+#include <tuple>
 #include "def.h"
 
 namespace octo_flex {
@@ -745,6 +748,49 @@ Vec3 quaternionRotateVector(const Quaternion& q, const Vec3& v) {
     return Vec3(rotatedQuaternion.x, rotatedQuaternion.y, rotatedQuaternion.z);
 }
 
+std::shared_ptr<const std::vector<Shape::Ptr>> unitMesh(UnitMesh type, int segments, bool simple_wire,
+                                                        bool transparent) {
+    typedef std::tuple<UnitMesh, int, bool, bool> Key;
+    static std::mutex mutex;
+    static std::map<Key, std::shared_ptr<const std::vector<Shape::Ptr>>> cache;
+
+    const bool curved = type == UnitMesh::Sphere || type == UnitMesh::Cylinder || type == UnitMesh::Cone;
+    if (!curved) segments = 0;
+    const Key key(type, segments, simple_wire, transparent);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = cache.find(key);
+    if (it != cache.end()) return it->second;
+
+    const Vec3 white(1.0, 1.0, 1.0);
+    Object::Ptr unit;
+    switch (type) {
+        case UnitMesh::Box:
+            unit = generateCubic("unit", white, 1.0, 1.0, 1.0, transparent);
+            break;
+        case UnitMesh::Sphere:
+            unit = generateSphere("unit", white, 1.0, transparent, simple_wire, segments);
+            break;
+        case UnitMesh::Cylinder:
+            unit = generateCylinder("unit", white, 1.0, 1.0, transparent, simple_wire, segments);
+            break;
+        case UnitMesh::Cone:
+            unit = generateCone("unit", white, 1.0, 1.0, transparent, simple_wire, segments);
+            break;
+        case UnitMesh::Pyramid:
+            unit = generatePyramid("unit", white, 1.0, 1.0, 1.0, transparent);
+            break;
+        case UnitMesh::Quad:
+            unit = generateQuad("unit", white, 1.0, 1.0, transparent);
+            break;
+    }
+    for (const auto& shape : unit->shapes()) {
+        shape->setInEditable();
+    }
+    auto mesh = std::make_shared<const std::vector<Shape::Ptr>>(unit->shapes());
+    cache.emplace(key, mesh);
+    return mesh;
+}
+
 Object::Ptr generateCapsule(const std::string& id, const Vec3& color, double radius, double height, bool transparent,
                             int segments) {
     float transparency = 1;
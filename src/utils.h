@@ -82,6 +82,15 @@ Object::Ptr generateHemisphere(const std::string& id, const Vec3& color, double
 Object::Ptr generateCapsule(const std::string& id, const Vec3& color, double radius, double height,
                             bool transparent = true, int segments = 10);
 
+// Unit primitives the builder places with a scale (see InstancedShape::reference()).
+enum class UnitMesh { Box, Sphere, Cylinder, Cone, Pyramid, Quad };
+// Frozen white shapes of a unit primitive, generated once per (type, segments, simple_wire, transparent)
+// and shared. Laid out like the generators above with every size 1: the box, pyramid and quad span 1 along
+// their axes, the sphere, cylinder and cone have radius 1, the cylinder and cone height 1. Segments only
+// apply to the curved primitives.
+std::shared_ptr<const std::vector<Shape::Ptr>> unitMesh(UnitMesh type, int segments = 10, bool simple_wire = false,
+                                                        bool transparent = true);
+
 Quaternion rotateX(double rad);
 Quaternion rotateY(double rad);
 Quaternion rotateZ(double rad);
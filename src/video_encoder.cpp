@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "video_encoder.h"
+#include "pipe_encoder.h"
+#include "video_recorder.h"
+#ifdef OCTO_FLEX_HAVE_LIBAV
+#include "libav_encoder.h"
+#endif
+
+namespace octo_flex {
+
+const char* const VideoEncoder::kVaapiDevice = "/dev/dri/renderD128";
+
+const char* VideoEncoder::nvencPreset(const std::string& preset) {
+    if (preset == "ultrafast" || preset == "superfast") return "p1";
+    if (preset == "veryfast" || preset == "faster") return "p2";
+    if (preset == "fast") return "p3";
+    if (preset == "slow") return "p5";
+    if (preset == "slower" || preset == "veryslow") return "p6";
+    return "p4";
+}
+
+int64_t VideoEncoder::constantBitrate(const VideoRecorderOptions& options) {
+    return static_cast<int64_t>(options.width) * options.height * options.fps / 10;
+}
+
+std::vector<EncoderKind> VideoEncoder::candidates(const std::string& encoder, const std::string& codec,
+                                                  bool alpha) {
+    // Hardware encoders drop the alpha plane; alpha recordings always use software.
+    std::vector<EncoderKind> kinds;
+    if (!alpha) {
+        if (encoder == "auto") {
+            kinds = {EncoderKind::NVENC, EncoderKind::VAAPI, EncoderKind::V4L2_M2M};
+        } else if (encoder == "nvenc") {
+            kinds = {EncoderKind::NVENC};
+        } else if (encoder == "vaapi") {
+            kinds = {EncoderKind::VAAPI};
+        } else if (encoder == "v4l2m2m") {
+            kinds = {EncoderKind::V4L2_M2M};
+        }
+    }
+
+    std::vector<EncoderKind> usable;
+    for (EncoderKind kind : kinds) {
+        if (!codecName(kind, codec).empty()) usable.push_back(kind);
+    }
+    usable.push_back(EncoderKind::SOFTWARE);
+    return usable;
+}
+
+std::string VideoEncoder::codecName(EncoderKind kind, const std::string& codec) {
+    if (kind == EncoderKind::SOFTWARE) return codec;
+
+    // Hardware encoders exist for H.264 and H.265.
+    std::string family;
+    if (codec == "libx264" || codec == "h264") {
+        family = "h264";
+    } else if (codec == "libx265" || codec == "hevc" || codec == "h265") {
+        family = "hevc";
+    } else {
+        return std::string();
+    }
+    switch (kind) {
+        case EncoderKind::NVENC:
+            return family + "_nvenc";
+        case EncoderKind::VAAPI:
+            return family + "_vaapi";
+        case EncoderKind::V4L2_M2M:
+            return family + "_v4l2m2m";
+        case EncoderKind::SOFTWARE:
+        default:
+            return codec;
+    }
+}
+
+std::unique_ptr<VideoEncoder> VideoEncoder::open(const VideoRecorderOptions& options, std::string* error) {
+    std::string errors;
+    auto attempt = [&](std::unique_ptr<VideoEncoder> encoder) -> std::unique_ptr<VideoEncoder> {
+        std::string message;
+        if (encoder->start(options, &message)) return encoder;
+        errors += (errors.empty() ? "" : "; ") + encoder->name() + ": " + message;
+        return nullptr;
+    };
+
+    // In-process first (no pipe, no process), then the ffmpeg command line tool.
+    for (EncoderKind kind : candidates(options.encoder, options.codec, options.enableAlpha)) {
+#ifdef OCTO_FLEX_HAVE_LIBAV
+        if (auto encoder = attempt(std::make_unique<LibavEncoder>(kind))) return encoder;
+#endif
+        if (auto encoder = attempt(std::make_unique<PipeEncoder>(kind))) return encoder;
+    }
+
+    if (error) *error = errors.empty() ? "No video encoder available" : errors;
+    return nullptr;
+}
+
+}  // namespace octo_flex
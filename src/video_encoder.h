@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef VIDEO_ENCODER_H
+#define VIDEO_ENCODER_H
+
+#include <QImage>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace octo_flex {
+
+struct VideoRecorderOptions;
+
+// Encoder hardware a backend drives.
+enum class EncoderKind {
+    SOFTWARE,  // options.codec as given (libx264 by default)
+    NVENC,     // NVIDIA NVENC
+    VAAPI,     // VA-API (Intel, AMD)
+    V4L2_M2M   // V4L2 memory-to-memory codecs (Jetson, Raspberry Pi and other SoCs)
+};
+
+// One way of turning frames into a video file. Frames passed to writeFrame have the recorder's
+// size and input format.
+class VideoEncoder {
+   public:
+    virtual ~VideoEncoder() {}
+
+    virtual bool start(const VideoRecorderOptions& options, std::string* error) = 0;
+    virtual bool writeFrame(const QImage& frame, std::string* error) = 0;
+    virtual bool stop(std::string* error) = 0;
+
+    // Backend and codec, for example "libav:h264_nvenc".
+    virtual std::string name() const = 0;
+
+    // Start the first encoder of options.encoder's candidates that works on this machine; errors of
+    // the candidates that failed are joined into error when none does.
+    static std::unique_ptr<VideoEncoder> open(const VideoRecorderOptions& options, std::string* error);
+
+    // Encoders tried for an options.encoder value ("auto": hardware first, then software).
+    static std::vector<EncoderKind> candidates(const std::string& encoder, const std::string& codec,
+                                               bool alpha);
+
+    // Codec name for a kind, e.g. "h264_vaapi" for VAAPI with codec "libx264"; empty if the kind
+    // has no encoder for the codec.
+    static std::string codecName(EncoderKind kind, const std::string& codec);
+
+    // VA-API render node used for encoding.
+    static const char* const kVaapiDevice;
+    // NVENC preset p1 (fastest) to p7 (best) for an x264 preset name.
+    static const char* nvencPreset(const std::string& preset);
+    // Bitrate for encoders that only do constant bitrate (V4L2 M2M): about 0.1 bit per pixel.
+    static int64_t constantBitrate(const VideoRecorderOptions& options);
+};
+
+}  // namespace octo_flex
+
+#endif /* VIDEO_ENCODER_H */
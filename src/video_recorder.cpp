@@ -15,9 +15,7 @@
 // limitations under the License.
 
 #include "video_recorder.h"
-
-#include <cstring>
-#include <sstream>
+#include "trace.h"
 
 namespace octo_flex {
 
@@ -37,29 +35,17 @@ bool VideoRecorder::start(const VideoRecorderOptions& options, std::string* erro
         return false;
     }
 
+    if (options.inputFormat != QImage::Format_RGB888 && options.inputFormat != QImage::Format_RGBA8888) {
+        setError("Unsupported recorder input format", error);
+        return false;
+    }
+
     options_ = options;
 
-    // Build ffmpeg command line
-    std::ostringstream cmd;
-    cmd << "ffmpeg"
-        << " -hide_banner -loglevel error"
-        << (options.overwrite ? " -y" : " -n")
-        << " -f rawvideo"
-        << " -pix_fmt " << (options.enableAlpha ? "rgba" : "rgb24")
-        << " -s " << options.width << "x" << options.height
-        << " -r " << options.fps
-        << " -i -"
-        << " -an"
-        << " -c:v " << options.codec
-        << " -preset " << options.preset
-        << " -crf " << options.crf
-        << " -pix_fmt " << (options.enableAlpha ? "yuva420p" : "yuv420p")
-	<< " -movflags frag_keyframe+empty_moov"
-        << " " << options.outputPath;
-
-    pipe_ = popen(cmd.str().c_str(), "w");
-    if (!pipe_) {
-        setError("Failed to start ffmpeg process via popen", error);
+    std::string openError;
+    encoder_ = VideoEncoder::open(options_, &openError);
+    if (!encoder_) {
+        setError("No usable video encoder (" + openError + ")", error);
         return false;
     }
 
@@ -68,59 +54,39 @@ bool VideoRecorder::start(const VideoRecorderOptions& options, std::string* erro
 }
 
 bool VideoRecorder::writeFrame(const QImage& frame, std::string* error) {
-    if (!started_ || !pipe_) {
+    OCTO_FLEX_TRACE_ZONE("VideoRecorder::writeFrame");
+    if (!started_ || !encoder_) {
         setError("Recorder is not running", error);
         return false;
     }
 
+    // Frames normally arrive in the input format and size; anything else is converted here.
     QImage processed = frame;
-    if (options_.enableAlpha) {
-        if (processed.format() != QImage::Format_RGBA8888) {
-            processed = processed.convertToFormat(QImage::Format_RGBA8888);
-        }
-    } else {
-        if (processed.format() != QImage::Format_RGB888) {
-            processed = processed.convertToFormat(QImage::Format_RGB888);
-        }
+    if (processed.format() != options_.inputFormat) {
+        processed = processed.convertToFormat(options_.inputFormat);
     }
 
     if (processed.width() != options_.width || processed.height() != options_.height) {
         processed = processed.scaled(options_.width, options_.height, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
     }
 
-    const int rowBytes = options_.width * (options_.enableAlpha ? 4 : 3);
-
-    for (int y = 0; y < options_.height; ++y) {
-        const unsigned char* src = processed.constScanLine(y);
-        size_t written = fwrite(src, 1, rowBytes, pipe_);
-        if (static_cast<int>(written) != rowBytes) {
-            setError("Failed writing frame data to ffmpeg pipe", error);
-            return false;
-        }
-    }
-
-    return true;
+    return encoder_->writeFrame(processed, error);
 }
 
 bool VideoRecorder::stop(std::string* error) {
-    if (!pipe_) {
-        started_ = false;
-        return true;
-    }
-
-    int status = pclose(pipe_);
-    pipe_ = nullptr;
     started_ = false;
-
-    if (status != 0) {
-        setError("ffmpeg exited with status " + std::to_string(status), error);
-        return false;
+    if (!encoder_) {
+        return true;
     }
 
-    return true;
+    const bool ok = encoder_->stop(error);
+    encoder_.reset();
+    return ok;
 }
 
-bool VideoRecorder::isRunning() const { return started_ && pipe_ != nullptr; }
+bool VideoRecorder::isRunning() const { return started_ && encoder_ != nullptr; }
+
+std::string VideoRecorder::encoderName() const { return encoder_ ? encoder_->name() : std::string(); }
 
 void VideoRecorder::setError(const std::string& message, std::string* error) {
     if (error) {
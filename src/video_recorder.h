@@ -18,8 +18,9 @@
 #define VIDEO_RECORDER_H
 
 #include <QImage>
-#include <cstdio>
+#include <memory>
 #include <string>
+#include "video_encoder.h"
 
 namespace octo_flex {
 
@@ -32,7 +33,9 @@ struct VideoRecorderOptions {
     std::string preset = "veryfast";
     int crf = 23;
     bool overwrite = true;
-    bool enableAlpha = false;  // If true, uses rgba format to preserve transparency
+    bool enableAlpha = false;  // If true, encodes with an alpha channel (yuva420p)
+    QImage::Format inputFormat = QImage::Format_RGB888;  // Format of the frames passed in (RGB888 or RGBA8888)
+    std::string encoder = "software";  // "auto", "software", "nvenc", "vaapi" or "v4l2m2m" (see VideoEncoder)
 };
 
 class VideoRecorder {
@@ -46,11 +49,14 @@ class VideoRecorder {
 
     bool isRunning() const;
 
+    // Name of the encoder that started, for example "libav:h264_nvenc"; empty when not running.
+    std::string encoderName() const;
+
    private:
     void setError(const std::string& message, std::string* error);
 
    private:
-    FILE* pipe_ = nullptr;
+    std::unique_ptr<VideoEncoder> encoder_;
     VideoRecorderOptions options_;
     bool started_ = false;
 };
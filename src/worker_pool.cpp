@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "worker_pool.h"
+#include <algorithm>
+#include "trace.h"
+
+namespace octo_flex {
+
+WorkerPool::WorkerPool(size_t thread_count) {
+    if (thread_count == 0) {
+        unsigned int hardware = std::thread::hardware_concurrency();
+        thread_count = hardware > 1 ? hardware - 1 : 0;
+    }
+    threads_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        threads_.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        stopping_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void WorkerPool::parallelFor(size_t count, const std::function<void(size_t)>& fn) {
+    if (count == 0) return;
+    if (threads_.empty() || count == 1) {
+        for (size_t i = 0; i < count; ++i) fn(i);
+        return;
+    }
+
+    std::unique_lock<std::mutex> submit_lock(submit_mtx_);
+
+    // Several chunks per thread so uneven objects still balance out.
+    const size_t grain = std::max<size_t>(1, count / ((threads_.size() + 1) * 8));
+    {
+        std::unique_lock<std::mutex> lock(mtx_);
+        job_ = &fn;
+        job_count_ = count;
+        job_grain_ = grain;
+        next_index_.store(0, std::memory_order_relaxed);
+        ++job_generation_;
+    }
+    work_cv_.notify_all();
+
+    runChunks(fn, count, grain);
+
+    std::unique_lock<std::mutex> lock(mtx_);
+    done_cv_.wait(lock, [this] { return active_workers_ == 0; });
+    job_ = nullptr;  // Late wakers see no job
+}
+
+void WorkerPool::workerLoop() {
+    setTraceThreadName("worker");
+    uint64_t seen_generation = 0;
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (true) {
+        work_cv_.wait(lock, [&] { return stopping_ || job_generation_ != seen_generation; });
+        if (stopping_) return;
+        seen_generation = job_generation_;
+        if (job_ == nullptr) continue;
+
+        const auto* job = job_;
+        const size_t count = job_count_;
+        const size_t grain = job_grain_;
+        ++active_workers_;
+        lock.unlock();
+        runChunks(*job, count, grain);
+        lock.lock();
+        if (--active_workers_ == 0) {
+            done_cv_.notify_all();
+        }
+    }
+}
+
+void WorkerPool::runChunks(const std::function<void(size_t)>& fn, size_t count, size_t grain) {
+    while (true) {
+        const size_t begin = next_index_.fetch_add(grain, std::memory_order_relaxed);
+        if (begin >= count) return;
+        const size_t end = std::min(count, begin + grain);
+        for (size_t i = begin; i < end; ++i) fn(i);
+    }
+}
+
+}  // namespace octo_flex
@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: Apache-2.0
+//
+// Copyright (c) 2026 Qi Wang
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace octo_flex {
+
+// Fixed set of worker threads running index-parallel loops; the calling thread works too.
+class WorkerPool {
+   public:
+    // thread_count 0 uses one worker per hardware thread besides the caller.
+    explicit WorkerPool(size_t thread_count = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    size_t threadCount() const { return threads_.size(); }
+
+    // Run fn(i) for every i in [0, count) and return once all calls finished.
+    // Calls from several threads are serialized; fn must not call parallelFor itself.
+    void parallelFor(size_t count, const std::function<void(size_t)>& fn);
+
+   private:
+    void workerLoop();
+    void runChunks(const std::function<void(size_t)>& fn, size_t count, size_t grain);
+
+    std::vector<std::thread> threads_;
+    std::mutex submit_mtx_;  // One loop at a time
+    std::mutex mtx_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    const std::function<void(size_t)>* job_ = nullptr;
+    size_t job_count_ = 0;
+    size_t job_grain_ = 1;
+    uint64_t job_generation_ = 0;
+    size_t active_workers_ = 0;
+    bool stopping_ = false;
+    std::atomic<size_t> next_index_{0};
+};
+
+}  // namespace octo_flex
+
+#endif /* WORKER_POOL_H */